@@ -23,4 +23,72 @@ public:
 	void Process(void *dst, const void *const *src, uint32 w, sint32 phase);
 };
 
+///////////////////////////////////////////////////////////////////////////
+//
+// resampler stages (SSE2 intrinsics, AMD64)
+//
+///////////////////////////////////////////////////////////////////////////
+
+class VDResamplerSeparableTableRowStage8SSE2 : public VDResamplerRowStageSeparableTable8, public IVDResamplerSeparableRowStage2 {
+public:
+	VDResamplerSeparableTableRowStage8SSE2(const IVDResamplerFilter& filter);
+
+	IVDResamplerSeparableRowStage2 *AsRowStage2() { return this; } 
+
+	void Init(const VDResamplerAxis& axis, uint32 srcw);
+	void Process(void *dst, const void *src, uint32 w);
+	void Process(void *dst, const void *src, uint32 w, uint32 u, uint32 dudx);
+
+protected:
+	void RedoRowFilters(const VDResamplerAxis& axis, uint32 w, uint32 srcw);
+
+	int		mAlignedKernelWidth;
+	uint32	mLastSrcWidth;
+	uint32	mLastDstWidth;
+	sint32	mLastU;
+	sint32	mLastDUDX;
+	bool	mbVectorLoadsSafe;
+
+	vdfastvector<sint32> mRowOffsets;
+	vdfastvector<sint16, vdaligned_alloc<sint16> > mRowKernels;
+};
+
+class VDResamplerSeparableTableColStage8SSE2 : public VDResamplerColStageSeparableTable8 {
+public:
+	VDResamplerSeparableTableColStage8SSE2(const IVDResamplerFilter& filter);
+
+	void Process(void *dst, const void *const *src, uint32 w, sint32 phase);
+
+protected:
+	vdblock<sint32, vdaligned_alloc<sint32> > mCoeffPairs;
+};
+
+class VDResamplerSeparableTableRowStage32FSSE2 : public VDResamplerRowStageSeparableTable32F {
+public:
+	VDResamplerSeparableTableRowStage32FSSE2(const IVDResamplerFilter& filter);
+
+	void Process(void *dst, const void *src, uint32 w, uint32 u, uint32 dudx);
+};
+
+class VDResamplerSeparableTableRowStage32Fx4SSE2 : public VDResamplerRowStageSeparableTable32Fx4 {
+public:
+	VDResamplerSeparableTableRowStage32Fx4SSE2(const IVDResamplerFilter& filter);
+
+	void Process(void *dst, const void *src, uint32 w, uint32 u, uint32 dudx);
+};
+
+class VDResamplerSeparableTableColStage32FSSE2 : public VDResamplerColStageSeparableTable32F {
+public:
+	VDResamplerSeparableTableColStage32FSSE2(const IVDResamplerFilter& filter);
+
+	void Process(void *dst, const void *const *src, uint32 w, sint32 phase);
+};
+
+class VDResamplerSeparableTableColStage32Fx4SSE2 : public VDResamplerColStageSeparableTable32Fx4 {
+public:
+	VDResamplerSeparableTableColStage32Fx4SSE2(const IVDResamplerFilter& filter);
+
+	void Process(void *dst, const void *const *src, uint32 w, sint32 phase);
+};
+
 #endif
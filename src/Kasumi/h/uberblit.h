@@ -30,6 +30,11 @@ enum VDPixmapFormatToken {
 	kVDPixType_V210			= 0x00000013,		// v210 (4:2:2 10 bit)
 	kVDPixType_8_B8R8		= 0x00000014,		// NV12
 	kVDPixType_B8R8			= 0x00000015,
+	kVDPixType_16_LE		= 0x00000016,
+	kVDPixType_16x4_LE		= 0x00000017,		// XRGB64
+	kVDPixType_16_16_16_LE	= 0x00000018,
+	kVDPixType_16_B16R16_LE	= 0x00000019,		// P016
+	kVDPixType_B16R16_LE	= 0x0000001A,
 	kVDPixType_Mask			= 0x0000003F,
 
 	kVDPixSamp_444			= 0x00000040,
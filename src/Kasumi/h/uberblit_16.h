@@ -0,0 +1,167 @@
+#ifndef f_VD2_KASUMI_UBERBLIT_16_H
+#define f_VD2_KASUMI_UBERBLIT_16_H
+
+#include <vd2/system/cpuaccel.h>
+#include "uberblit_base.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	16-bit integer channels
+//
+//	Planar YCbCr channels use the same scale as 8-bit video, with 8-bit
+//	level n at n << 8; MSB-aligned 10-bit data (P010) shares this scale.
+//	Packed RGB channels are full range, with white at 0xFFFF.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class VDPixmapGen_16_To_32F : public VDPixmapGenWindowBasedOneSourceSimple {
+public:
+	void Start();
+
+	uint32 GetType(uint32 output) const;
+
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGen_32F_To_16 : public VDPixmapGenWindowBasedOneSourceSimple {
+public:
+	void Start();
+
+	uint32 GetType(uint32 output) const;
+
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGen_8_To_16 : public VDPixmapGenWindowBasedOneSourceSimple {
+public:
+	void Start();
+
+	uint32 GetType(uint32 output) const;
+
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGen_16_To_8 : public VDPixmapGenWindowBasedOneSourceSimple {
+public:
+	void Start();
+
+	uint32 GetType(uint32 output) const;
+
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGen_16_To_10 : public VDPixmapGenWindowBasedOneSourceSimple {
+public:
+	void Start();
+
+	uint32 GetType(uint32 output) const;
+
+protected:
+	void Compute(void *dst0, sint32 y);
+
+	uint32 mCount;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	64-bit RGB
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class VDPixmapGen_X16R16G16B16_To_X32B32G32R32F : public VDPixmapGenWindowBasedOneSourceSimple {
+public:
+	void Start();
+
+	uint32 GetType(uint32 output) const;
+
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGen_X32B32G32R32F_To_X16R16G16B16 : public VDPixmapGenWindowBasedOneSourceSimple {
+public:
+	void Start();
+
+	uint32 GetType(uint32 output) const;
+
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGen_X8R8G8B8_To_X16R16G16B16 : public VDPixmapGenWindowBasedOneSourceSimple {
+public:
+	void Start();
+
+	uint32 GetType(uint32 output) const;
+
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGen_X16R16G16B16_To_X8R8G8B8 : public VDPixmapGenWindowBasedOneSourceSimple {
+public:
+	void Start();
+
+	uint32 GetType(uint32 output) const;
+
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	16-bit swizzlers
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class VDPixmapGen_16In32 : public VDPixmapGenWindowBasedOneSource {
+public:
+	void Init(IVDPixmapGen *gen, int srcIndex, int offset, uint32 w, uint32 h) {
+		InitSource(gen, srcIndex);
+		mOffset = offset;
+		SetOutputSize(w, h);
+		gen->AddWindowRequest(0, 0);
+	}
+
+	void Start() {
+		StartWindow(mWidth * 2);
+	}
+
+	uint32 GetType(uint32 index) const {
+		return (mpSrc->GetType(mSrcIndex) & ~kVDPixType_Mask) | kVDPixType_16_LE;
+	}
+
+protected:
+	void Compute(void *dst0, sint32 y) {
+		const uint16 *srcp = (const uint16 *)mpSrc->GetRow(y, mSrcIndex) + mOffset;
+		uint16 *dst = (uint16 *)dst0;
+		sint32 w = mWidth;
+		for(sint32 x=0; x<w; ++x) {
+			*dst++ = *srcp;
+			srcp += 2;
+		}
+	}
+
+	int mOffset;
+};
+
+class VDPixmapGen_B16x2_To_B16R16 : public VDPixmapGenWindowBased {
+public:
+	void Init(IVDPixmapGen *srcCb, uint32 srcindexCb, IVDPixmapGen *srcCr, uint32 srcindexCr);
+	void Start();
+	uint32 GetType(uint32 output) const;
+
+protected:
+	void Compute(void *dst0, sint32 y);
+
+	IVDPixmapGen *mpSrcCb;
+	uint32 mSrcIndexCb;
+	IVDPixmapGen *mpSrcCr;
+	uint32 mSrcIndexCr;
+};
+
+#endif
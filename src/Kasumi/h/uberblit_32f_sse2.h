@@ -0,0 +1,69 @@
+#ifndef f_VD2_KASUMI_UBERBLIT_32F_SSE2_H
+#define f_VD2_KASUMI_UBERBLIT_32F_SSE2_H
+
+#include "uberblit_rgb.h"
+#include "uberblit_ycbcr.h"
+#include "uberblit_ycbcr_generic.h"
+#include "uberblit_v210.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//	SSE2 versions of the 32F generators. These produce the same results as
+//	the generic versions, and are selected when the blitter is compiled.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+class VDPixmapGen_8_To_32F_SSE2 : public VDPixmapGen_8_To_32F {
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGen_32F_To_8_SSE2 : public VDPixmapGen_32F_To_8 {
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGen_X8R8G8B8_To_X32B32G32R32F_SSE2 : public VDPixmapGen_X8R8G8B8_To_X32B32G32R32F {
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGen_X32B32G32R32F_To_X8R8G8B8_SSE2 : public VDPixmapGen_X32B32G32R32F_To_X8R8G8B8 {
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGenYCbCr601ToRGB32F_SSE2 : public VDPixmapGenYCbCr601ToRGB32F {
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGenYCbCr709ToRGB32F_SSE2 : public VDPixmapGenYCbCr709ToRGB32F {
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGenRGB32FToYCbCrGeneric_SSE2 : public VDPixmapGenRGB32FToYCbCrGeneric {
+public:
+	VDPixmapGenRGB32FToYCbCrGeneric_SSE2(const VDPixmapGenYCbCrBasis& basis, uint32 colorSpace)
+		: VDPixmapGenRGB32FToYCbCrGeneric(basis, colorSpace) {}
+
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+class VDPixmapGenYCbCrToYCbCrGeneric_32F_SSE2 : public VDPixmapGenYCbCrToYCbCrGeneric_32F {
+public:
+	VDPixmapGenYCbCrToYCbCrGeneric_32F_SSE2(const VDPixmapGenYCbCrBasis& dstBasis, bool dstLimitedRange, const VDPixmapGenYCbCrBasis& srcBasis, bool srcLimitedRange, uint32 colorSpace)
+		: VDPixmapGenYCbCrToYCbCrGeneric_32F(dstBasis, dstLimitedRange, srcBasis, srcLimitedRange, colorSpace) {}
+
+protected:
+	void Compute(void *dst0, sint32 ypos);
+};
+
+class VDPixmapGen_V210_To_32F_SSE2 : public VDPixmapGen_V210_To_32F {
+protected:
+	void Compute(void *dst0, sint32 y);
+};
+
+#endif	// f_VD2_KASUMI_UBERBLIT_32F_SSE2_H
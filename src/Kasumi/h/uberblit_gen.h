@@ -73,6 +73,7 @@ public:
 	void extract_8in16(int offset, uint32 w, uint32 h);
 	void extract_8in32(int offset, uint32 w, uint32 h);
 	void swap_8in16(uint32 w, uint32 h, uint32 bpr);
+	void extract_16in32(int offset, uint32 w, uint32 h);
 
 	void conv_Pal1_to_8888(int srcIndex);
 	void conv_Pal2_to_8888(int srcIndex);
@@ -88,6 +89,10 @@ public:
 	void conv_8_to_32F();
 	void conv_16F_to_32F();
 	void conv_V210_to_32F();
+	void conv_8_to_16();
+	void conv_16_to_32F();
+	void conv_8888_to_16x4();
+	void conv_16x4_to_X32F();
 
 	void conv_8888_to_555();
 	void conv_8888_to_565();
@@ -96,6 +101,11 @@ public:
 	void conv_X32F_to_8888();
 	void conv_32F_to_16F();
 	void conv_32F_to_V210();
+	void conv_16_to_8();
+	void conv_32F_to_16();
+	void conv_16x4_to_8888();
+	void conv_X32F_to_16x4();
+	void round_16_to_10();
 
 	void convd_8888_to_555();
 	void convd_8888_to_565();
@@ -106,6 +116,7 @@ public:
 	void interleave_G8B8_G8R8();
 	void interleave_X8R8G8B8();
 	void interleave_B8R8();
+	void interleave_B16R16();
 
 	void merge_fields(uint32 w, uint32 h, uint32 bpr);
 	void split_fields(uint32 bpr);
@@ -1,5 +1,198 @@
 #include <stdafx.h>
+#include <vd2/system/cpuaccel.h>
 #include <vd2/Kasumi/blitter.h>
+#include <vd2/Kasumi/pixmap.h>
+
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	template<class T>
+	void VDPixmapBlitterCacheMakeKey(sint32& w, sint32& h, sint32& format, const T& px) {
+		w = px.w;
+		h = px.h;
+		format = px.format;
+	}
+
+	VDPixmapBlitterCache g_VDPixmapBlitterCache;
+}
+
+VDPixmapBlitterCache& VDPixmapGetBlitterCache() {
+	return g_VDPixmapBlitterCache;
+}
+
+VDPixmapBlitterCache::VDPixmapBlitterCache(uint32 maxIdleBlitters)
+	: mMaxIdleBlitters(maxIdleBlitters)
+	, mIdleBlitters(0)
+	, mUseCounter(0)
+	, mHits(0)
+	, mMisses(0)
+	, mEvictions(0)
+{
+}
+
+VDPixmapBlitterCache::~VDPixmapBlitterCache() {
+	Flush();
+}
+
+IVDPixmapBlitter *VDPixmapBlitterCache::Acquire(const VDPixmap& dst, const VDPixmap& src) {
+	Entry key;
+	VDPixmapBlitterCacheMakeKey(key.mDstW, key.mDstH, key.mDstFormat, dst);
+	VDPixmapBlitterCacheMakeKey(key.mSrcW, key.mSrcH, key.mSrcFormat, src);
+	key.mCPUExtensions = CPUGetEnabledExtensions();
+
+	IVDPixmapBlitter *blitter = Lookup(key);
+
+	if (!blitter) {
+		// Compiling the blitter is the expensive part, so don't hold the
+		// lock across it; racing callers just end up with separate copies.
+		blitter = VDPixmapCreateBlitter(dst, src);
+
+		if (blitter)
+			Add(key, blitter);
+	}
+
+	return blitter;
+}
+
+IVDPixmapBlitter *VDPixmapBlitterCache::Acquire(const VDPixmapLayout& dst, const VDPixmapLayout& src) {
+	Entry key;
+	VDPixmapBlitterCacheMakeKey(key.mDstW, key.mDstH, key.mDstFormat, dst);
+	VDPixmapBlitterCacheMakeKey(key.mSrcW, key.mSrcH, key.mSrcFormat, src);
+	key.mCPUExtensions = CPUGetEnabledExtensions();
+
+	IVDPixmapBlitter *blitter = Lookup(key);
+
+	if (!blitter) {
+		blitter = VDPixmapCreateBlitter(dst, src);
+
+		if (blitter)
+			Add(key, blitter);
+	}
+
+	return blitter;
+}
+
+void VDPixmapBlitterCache::Release(IVDPixmapBlitter *blitter) {
+	if (!blitter)
+		return;
+
+	vdsynchronized(mMutex) {
+		for(vdfastvector<Entry>::iterator it(mEntries.begin()), itEnd(mEntries.end()); it != itEnd; ++it) {
+			Entry& e = *it;
+
+			if (e.mpBlitter == blitter) {
+				VDASSERT(e.mbActive);
+				e.mbActive = false;
+				e.mLastUse = ++mUseCounter;
+				++mIdleBlitters;
+
+				Trim();
+				return;
+			}
+		}
+	}
+
+	VDASSERT(!"Blitter released to a cache that does not own it.");
+}
+
+void VDPixmapBlitterCache::Flush() {
+	vdfastvector<IVDPixmapBlitter *> blitters;
+
+	vdsynchronized(mMutex) {
+		vdfastvector<Entry>::iterator itDst(mEntries.begin());
+
+		for(vdfastvector<Entry>::iterator it(mEntries.begin()), itEnd(mEntries.end()); it != itEnd; ++it) {
+			const Entry& e = *it;
+
+			if (e.mbActive)
+				*itDst++ = e;
+			else
+				blitters.push_back(e.mpBlitter);
+		}
+
+		mEntries.erase(itDst, mEntries.end());
+		mIdleBlitters = 0;
+	}
+
+	while(!blitters.empty()) {
+		delete blitters.back();
+		blitters.pop_back();
+	}
+}
+
+void VDPixmapBlitterCache::GetStats(VDPixmapBlitterCacheStats& stats) {
+	vdsynchronized(mMutex) {
+		stats.mHits				= mHits;
+		stats.mMisses			= mMisses;
+		stats.mEvictions		= mEvictions;
+		stats.mIdleBlitters		= mIdleBlitters;
+		stats.mActiveBlitters	= (uint32)mEntries.size() - mIdleBlitters;
+	}
+}
+
+void VDPixmapBlitterCache::ResetStats() {
+	vdsynchronized(mMutex) {
+		mHits = 0;
+		mMisses = 0;
+		mEvictions = 0;
+	}
+}
+
+IVDPixmapBlitter *VDPixmapBlitterCache::Lookup(const Entry& key) {
+	vdsynchronized(mMutex) {
+		for(vdfastvector<Entry>::iterator it(mEntries.begin()), itEnd(mEntries.end()); it != itEnd; ++it) {
+			Entry& e = *it;
+
+			if (!e.mbActive && e.Matches(key)) {
+				e.mbActive = true;
+				--mIdleBlitters;
+				++mHits;
+				return e.mpBlitter;
+			}
+		}
+
+		++mMisses;
+	}
+
+	return NULL;
+}
+
+void VDPixmapBlitterCache::Add(const Entry& key, IVDPixmapBlitter *blitter) {
+	Entry e(key);
+	e.mpBlitter = blitter;
+	e.mbActive = true;
+	e.mLastUse = 0;
+
+	vdsynchronized(mMutex) {
+		mEntries.push_back(e);
+	}
+}
+
+void VDPixmapBlitterCache::Trim() {
+	// called with the lock held
+	while(mIdleBlitters > mMaxIdleBlitters) {
+		vdfastvector<Entry>::iterator itOldest(mEntries.end());
+
+		for(vdfastvector<Entry>::iterator it(mEntries.begin()), itEnd(mEntries.end()); it != itEnd; ++it) {
+			const Entry& e = *it;
+
+			if (!e.mbActive && (itOldest == itEnd || (sint32)(e.mLastUse - itOldest->mLastUse) < 0))
+				itOldest = it;
+		}
+
+		VDASSERT(itOldest != mEntries.end());
+
+		IVDPixmapBlitter *blitter = itOldest->mpBlitter;
+		*itOldest = mEntries.back();
+		mEntries.pop_back();
+		--mIdleBlitters;
+		++mEvictions;
+
+		delete blitter;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////
 
 VDPixmapCachedBlitter::VDPixmapCachedBlitter()
 	: mSrcWidth(0)
@@ -27,9 +220,9 @@ void VDPixmapCachedBlitter::Blit(const VDPixmap& dst, const VDPixmap& src) {
 		src.h != mSrcHeight ||
 		src.format != mSrcFormat)
 	{
-		if (mpCachedBlitter)
-			delete mpCachedBlitter;
-		mpCachedBlitter = VDPixmapCreateBlitter(dst, src);
+		Invalidate();
+
+		mpCachedBlitter = VDPixmapGetBlitterCache().Acquire(dst, src);
 		if (!mpCachedBlitter)
 			return;
 
@@ -46,7 +239,7 @@ void VDPixmapCachedBlitter::Blit(const VDPixmap& dst, const VDPixmap& src) {
 
 void VDPixmapCachedBlitter::Invalidate() {
 	if (mpCachedBlitter) {
-		delete mpCachedBlitter;
+		VDPixmapGetBlitterCache().Release(mpCachedBlitter);
 		mpCachedBlitter = NULL;
 	}
 }
@@ -104,6 +104,7 @@ extern void VDPixmapBlt_YUVPlanar_decode_reference(const VDPixmap& dst, const VD
 extern void VDPixmapBlt_YUVPlanar_encode_reference(const VDPixmap& dst, const VDPixmap& src, vdpixsize w, vdpixsize h);
 extern void VDPixmapBlt_YUVPlanar_convert_reference(const VDPixmap& dst, const VDPixmap& src, vdpixsize w, vdpixsize h);
 extern void VDPixmapBlt_UberblitAdapter(const VDPixmap& dst, const VDPixmap& src, vdpixsize w, vdpixsize h);
+extern void VDPixmapInitBlittersFused(VDPixmapBlitterTable& table);
 
 using namespace nsVDPixmap;
 
@@ -168,7 +169,13 @@ void VDPixmapInitBlittersReference(VDPixmapBlitterTable& table) {
 		kPixFormat_YUV420ib_Planar,
 		kPixFormat_YUV420ib_Planar_FR,
 		kPixFormat_YUV420ib_Planar_709,
-		kPixFormat_YUV420ib_Planar_709_FR;
+		kPixFormat_YUV420ib_Planar_709_FR,
+		kPixFormat_XRGB64,
+		kPixFormat_YUV444_Planar16,
+		kPixFormat_YUV422_Planar16,
+		kPixFormat_YUV420_Planar16,
+		kPixFormat_YUV420_P010,
+		kPixFormat_YUV420_P016;
 
 	uberblitDstFormats =
 		kPixFormat_XRGB1555,
@@ -222,7 +229,13 @@ void VDPixmapInitBlittersReference(VDPixmapBlitterTable& table) {
 		kPixFormat_YUV420ib_Planar,
 		kPixFormat_YUV420ib_Planar_FR,
 		kPixFormat_YUV420ib_Planar_709,
-		kPixFormat_YUV420ib_Planar_709_FR;
+		kPixFormat_YUV420ib_Planar_709_FR,
+		kPixFormat_XRGB64,
+		kPixFormat_YUV444_Planar16,
+		kPixFormat_YUV422_Planar16,
+		kPixFormat_YUV420_Planar16,
+		kPixFormat_YUV420_P010,
+		kPixFormat_YUV420_P016;
 
 	table.AddBlitter(uberblitSrcFormats, uberblitDstFormats, VDPixmapBlt_UberblitAdapter);
 
@@ -327,6 +340,11 @@ void VDPixmapInitBlittersReference(VDPixmapBlitterTable& table) {
 	dstFormats = kPixFormat_YUV444_Planar, kPixFormat_YUV422_Planar, kPixFormat_YUV420_Planar, kPixFormat_YUV411_Planar, kPixFormat_YUV410_Planar, kPixFormat_Y8, kPixFormat_YUV422_Planar_Centered, kPixFormat_YUV420_Planar_Centered;
 
 	table.AddBlitter(srcFormats, dstFormats, VDPixmapBlt_YUVPlanar_convert_reference);
+
+	//////////////////////////////////////////////////////////
+
+	// single-pass kernels for the common YCbCr <-> XRGB8888 pairs
+	VDPixmapInitBlittersFused(table);
 }
 
 tpVDPixBltTable VDGetPixBltTableReferenceInternal() {
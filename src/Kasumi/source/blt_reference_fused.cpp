@@ -0,0 +1,329 @@
+//	VirtualDub - Video processing and capture application
+//	Graphics support library
+//	Copyright (C) 1998-2009 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+#include <stdafx.h>
+#include <vd2/system/vdtypes.h>
+#include <vd2/Kasumi/pixmap.h>
+#include <vd2/Kasumi/pixmaputils.h>
+#include "blt_setup.h"
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Fused YCbCr <-> XRGB8888 blitters
+//
+//	These do the color space conversion and chroma resampling for the most
+//	common pairs in a single pass, without the intermediate rows that the
+//	uberblit pipeline needs. The chroma filters are the ones uberblit uses:
+//
+//	- 4:2:2 and 4:2:0 chroma is cosited horizontally; decoding interpolates
+//	  the odd pixels linearly and encoding applies a [1 2 1]/4 filter.
+//	- 4:2:0 chroma is centered vertically (MPEG-2); decoding interpolates
+//	  3/4 + 1/4 from the two nearest chroma rows and encoding applies a
+//	  [1 3 3 1]/8 filter.
+//
+//	Since the matrix is linear, the encoders filter RGB and convert once per
+//	chroma sample instead of converting every pixel.
+//
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	// 16.16 fixed point, limited range.
+	struct VDFusedMatrix601 {
+		enum {
+			kY		= 76309,
+			kCrR	= 104597,
+			kCbG	= -25675,
+			kCrG	= -53279,
+			kCbB	= 132201,
+
+			kRY		= 16829,
+			kGY		= 33039,
+			kBY		= 6416,
+			kRCb	= -9714,
+			kGCb	= -19071,
+			kBCb	= 28784,
+			kRCr	= 28784,
+			kGCr	= -24103,
+			kBCr	= -4681
+		};
+	};
+
+	struct VDFusedMatrix709 {
+		enum {
+			kY		= 76309,
+			kCrR	= 117489,
+			kCbG	= -13975,
+			kCrG	= -34925,
+			kCbB	= 138438,
+
+			kRY		= 11966,
+			kGY		= 40254,
+			kBY		= 4064,
+			kRCb	= -6596,
+			kGCb	= -22189,
+			kBCb	= 28784,
+			kRCr	= 28784,
+			kGCr	= -26145,
+			kBCr	= -2639
+		};
+	};
+
+	inline uint32 VDFusedClamp8(sint32 v) {
+		return (uint32)v >= 256 ? (uint32)(~v >> 31) & 0xff : (uint32)v;
+	}
+
+	// Chroma values are centered and scaled by 8.
+	template<class T_Matrix>
+	inline uint32 VDFusedYCbCrToXRGB8888(sint32 y, sint32 cb8, sint32 cr8) {
+		const sint32 yv = (y - 16) * T_Matrix::kY + 0x8000;
+		const sint32 r = (yv + ((cr8 * T_Matrix::kCrR) >> 3)) >> 16;
+		const sint32 g = (yv + ((cb8 * T_Matrix::kCbG + cr8 * T_Matrix::kCrG) >> 3)) >> 16;
+		const sint32 b = (yv + ((cb8 * T_Matrix::kCbB) >> 3)) >> 16;
+
+		return 0xFF000000 + (VDFusedClamp8(r) << 16) + (VDFusedClamp8(g) << 8) + VDFusedClamp8(b);
+	}
+
+	template<class T_Matrix>
+	inline uint8 VDFusedXRGB8888ToY(uint32 px) {
+		const sint32 r = (px >> 16) & 0xff;
+		const sint32 g = (px >>  8) & 0xff;
+		const sint32 b = px & 0xff;
+
+		return (uint8)((T_Matrix::kRY*r + T_Matrix::kGY*g + T_Matrix::kBY*b + 1048576 + 32768) >> 16);
+	}
+
+	// Converts a filtered RGB sum to Cb/Cr. The red and blue sums are packed
+	// into the high and low halves of rb; the green sum is in bits 8 and up
+	// of g. The total filter weight is 1 << T_WeightBits.
+	template<class T_Matrix, int T_WeightBits>
+	inline void VDFusedRGBSumToCbCr(uint8& cb, uint8& cr, uint32 rb, uint32 g) {
+		const sint32 r = rb >> 16;
+		const sint32 gs = g >> 8;
+		const sint32 b = rb & 0xffff;
+		const sint32 bias = (8388608 + 32768) << T_WeightBits;
+
+		cb = (uint8)((T_Matrix::kRCb*r + T_Matrix::kGCb*gs + T_Matrix::kBCb*b + bias) >> (16 + T_WeightBits));
+		cr = (uint8)((T_Matrix::kRCr*r + T_Matrix::kGCr*gs + T_Matrix::kBCr*b + bias) >> (16 + T_WeightBits));
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// YCbCr -> XRGB8888
+
+	// Converts one row. T_YStep and T_CStep are the byte steps between luma
+	// and chroma samples. For 4:2:0, the chroma rows cb/cr get a weight of 3
+	// and cb2/cr2 a weight of 1; for 4:2:2, cb2/cr2 are ignored.
+	template<class T_Matrix, int T_YStep, int T_CStep, bool T_420>
+	void VDFusedYCbCrRowToXRGB8888(uint32 *dst, const uint8 *srcY, const uint8 *srcCb, const uint8 *srcCr, const uint8 *srcCb2, const uint8 *srcCr2, sint32 w) {
+		const sint32 pairs = (w - 1) >> 1;
+
+		// chroma values scaled by 4
+		sint32 cb1 = T_420 ? 3*srcCb[0] + srcCb2[0] : srcCb[0] * 4;
+		sint32 cr1 = T_420 ? 3*srcCr[0] + srcCr2[0] : srcCr[0] * 4;
+
+		for(sint32 i=0; i<pairs; ++i) {
+			const sint32 cb0 = cb1;
+			const sint32 cr0 = cr1;
+
+			srcCb += T_CStep;
+			srcCr += T_CStep;
+
+			if (T_420) {
+				srcCb2 += T_CStep;
+				srcCr2 += T_CStep;
+				cb1 = 3*srcCb[0] + srcCb2[0];
+				cr1 = 3*srcCr[0] + srcCr2[0];
+			} else {
+				cb1 = srcCb[0] * 4;
+				cr1 = srcCr[0] * 4;
+			}
+
+			dst[0] = VDFusedYCbCrToXRGB8888<T_Matrix>(srcY[0], cb0*2 - 1024, cr0*2 - 1024);
+			dst[1] = VDFusedYCbCrToXRGB8888<T_Matrix>(srcY[T_YStep], cb0 + cb1 - 1024, cr0 + cr1 - 1024);
+			dst += 2;
+			srcY += T_YStep*2;
+		}
+
+		// last pixel or pair; the chroma sample is replicated past the right edge
+		dst[0] = VDFusedYCbCrToXRGB8888<T_Matrix>(srcY[0], cb1*2 - 1024, cr1*2 - 1024);
+		if (!(w & 1))
+			dst[1] = VDFusedYCbCrToXRGB8888<T_Matrix>(srcY[T_YStep], cb1*2 - 1024, cr1*2 - 1024);
+	}
+
+	template<class T_Matrix, int T_YOffset, int T_CbOffset, int T_CrOffset>
+	void VDPixmapBlt_422Packed_to_XRGB8888_fused(const VDPixmap& dst, const VDPixmap& src, vdpixsize w, vdpixsize h) {
+		const uint8 *srcRow = (const uint8 *)src.data;
+		uint32 *dstRow = (uint32 *)dst.data;
+
+		do {
+			VDFusedYCbCrRowToXRGB8888<T_Matrix, 2, 4, false>(dstRow, srcRow + T_YOffset, srcRow + T_CbOffset, srcRow + T_CrOffset, NULL, NULL, w);
+
+			vdptrstep(srcRow, src.pitch);
+			vdptrstep(dstRow, dst.pitch);
+		} while(--h);
+	}
+
+	// T_CStep is 1 for three-plane formats and 2 for NV12, where Cb and Cr
+	// are interleaved in the second plane.
+	template<class T_Matrix, int T_CStep>
+	void VDPixmapBlt_420_to_XRGB8888_fused(const VDPixmap& dst, const VDPixmap& src, vdpixsize w, vdpixsize h) {
+		const uint8 *srcY = (const uint8 *)src.data;
+		const uint8 *srcCb = (const uint8 *)src.data2;
+		const uint8 *srcCr = T_CStep == 2 ? srcCb + 1 : (const uint8 *)src.data3;
+		const ptrdiff_t pitchCb = src.pitch2;
+		const ptrdiff_t pitchCr = T_CStep == 2 ? src.pitch2 : src.pitch3;
+		const sint32 chromaLast = (h - 1) >> 1;
+		uint32 *dstRow = (uint32 *)dst.data;
+
+		for(sint32 y=0; y<h; ++y) {
+			const sint32 c0 = y >> 1;
+			sint32 c1 = (y & 1) ? c0 + 1 : c0 - 1;
+
+			if (c1 < 0)
+				c1 = 0;
+			else if (c1 > chromaLast)
+				c1 = chromaLast;
+
+			VDFusedYCbCrRowToXRGB8888<T_Matrix, 1, T_CStep, true>(dstRow, srcY,
+				srcCb + pitchCb * c0,
+				srcCr + pitchCr * c0,
+				srcCb + pitchCb * c1,
+				srcCr + pitchCr * c1,
+				w);
+
+			vdptrstep(srcY, src.pitch);
+			vdptrstep(dstRow, dst.pitch);
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// XRGB8888 -> YCbCr
+
+	template<class T_Matrix, int T_YOffset, int T_CbOffset, int T_CrOffset>
+	void VDPixmapBlt_XRGB8888_to_422Packed_fused(const VDPixmap& dst, const VDPixmap& src, vdpixsize w, vdpixsize h) {
+		const uint32 *srcRow = (const uint32 *)src.data;
+		uint8 *dstRow = (uint8 *)dst.data;
+		const sint32 pairs = (w + 1) >> 1;
+
+		do {
+			const uint32 *s = srcRow;
+			uint8 *d = dstRow;
+
+			uint32 pl = s[0];
+
+			for(sint32 i=0; i<pairs; ++i) {
+				const uint32 pc = s[0];
+				const uint32 pr = (i*2 + 1 < w) ? s[1] : pc;
+
+				const uint32 rb = (pl & 0xff00ff) + 2*(pc & 0xff00ff) + (pr & 0xff00ff);
+				const uint32 g  = (pl & 0xff00) + 2*(pc & 0xff00) + (pr & 0xff00);
+
+				VDFusedRGBSumToCbCr<T_Matrix, 2>(d[T_CbOffset], d[T_CrOffset], rb, g);
+				d[T_YOffset] = VDFusedXRGB8888ToY<T_Matrix>(pc);
+				d[T_YOffset + 2] = VDFusedXRGB8888ToY<T_Matrix>(pr);
+
+				pl = pr;
+				s += 2;
+				d += 4;
+			}
+
+			vdptrstep(srcRow, src.pitch);
+			vdptrstep(dstRow, dst.pitch);
+		} while(--h);
+	}
+
+	template<class T_Matrix, int T_CStep>
+	void VDPixmapBlt_XRGB8888_to_420_fused(const VDPixmap& dst, const VDPixmap& src, vdpixsize w, vdpixsize h) {
+		// luma
+		const uint32 *srcRow = (const uint32 *)src.data;
+		uint8 *dstY = (uint8 *)dst.data;
+
+		for(sint32 y=0; y<h; ++y) {
+			for(sint32 x=0; x<w; ++x)
+				dstY[x] = VDFusedXRGB8888ToY<T_Matrix>(srcRow[x]);
+
+			vdptrstep(srcRow, src.pitch);
+			vdptrstep(dstY, dst.pitch);
+		}
+
+		// chroma
+		uint8 *dstCb = (uint8 *)dst.data2;
+		uint8 *dstCr = T_CStep == 2 ? dstCb + 1 : (uint8 *)dst.data3;
+		const ptrdiff_t pitchCr = T_CStep == 2 ? dst.pitch2 : dst.pitch3;
+		const sint32 cw = (w + 1) >> 1;
+		const sint32 ch = (h + 1) >> 1;
+
+		for(sint32 cy=0; cy<ch; ++cy) {
+			const sint32 y1 = cy*2;
+			const sint32 y0 = y1 > 0 ? y1 - 1 : 0;
+			const sint32 y2 = y1 + 1 < h ? y1 + 1 : h - 1;
+			const sint32 y3 = y1 + 2 < h ? y1 + 2 : h - 1;
+
+			const uint32 *src0 = (const uint32 *)vdptroffset(src.data, src.pitch * y0);
+			const uint32 *src1 = (const uint32 *)vdptroffset(src.data, src.pitch * y1);
+			const uint32 *src2 = (const uint32 *)vdptroffset(src.data, src.pitch * y2);
+			const uint32 *src3 = (const uint32 *)vdptroffset(src.data, src.pitch * y3);
+
+			uint8 *cb = dstCb;
+			uint8 *cr = dstCr;
+
+			// vertical [1 3 3 1] sums for the column to the left
+			uint32 rbl = (src0[0] & 0xff00ff) + 3*((src1[0] & 0xff00ff) + (src2[0] & 0xff00ff)) + (src3[0] & 0xff00ff);
+			uint32 gl  = (src0[0] & 0xff00) + 3*((src1[0] & 0xff00) + (src2[0] & 0xff00)) + (src3[0] & 0xff00);
+
+			for(sint32 i=0; i<cw; ++i) {
+				const sint32 x = i*2;
+				const sint32 xr = x + 1 < w ? x + 1 : x;
+
+				const uint32 rbc = (src0[x] & 0xff00ff) + 3*((src1[x] & 0xff00ff) + (src2[x] & 0xff00ff)) + (src3[x] & 0xff00ff);
+				const uint32 gc  = (src0[x] & 0xff00) + 3*((src1[x] & 0xff00) + (src2[x] & 0xff00)) + (src3[x] & 0xff00);
+				const uint32 rbr = (src0[xr] & 0xff00ff) + 3*((src1[xr] & 0xff00ff) + (src2[xr] & 0xff00ff)) + (src3[xr] & 0xff00ff);
+				const uint32 gr  = (src0[xr] & 0xff00) + 3*((src1[xr] & 0xff00) + (src2[xr] & 0xff00)) + (src3[xr] & 0xff00);
+
+				VDFusedRGBSumToCbCr<T_Matrix, 5>(*cb, *cr, rbl + 2*rbc + rbr, gl + 2*gc + gr);
+
+				rbl = rbr;
+				gl = gr;
+				cb += T_CStep;
+				cr += T_CStep;
+			}
+
+			vdptrstep(dstCb, dst.pitch2);
+			vdptrstep(dstCr, pitchCr);
+		}
+	}
+}
+
+void VDPixmapInitBlittersFused(VDPixmapBlitterTable& table) {
+	using namespace nsVDPixmap;
+
+	table.AddBlitter(kPixFormat_YUV422_UYVY,		kPixFormat_XRGB8888,	VDPixmapBlt_422Packed_to_XRGB8888_fused<VDFusedMatrix601, 1, 0, 2>);
+	table.AddBlitter(kPixFormat_YUV422_YUYV,		kPixFormat_XRGB8888,	VDPixmapBlt_422Packed_to_XRGB8888_fused<VDFusedMatrix601, 0, 1, 3>);
+	table.AddBlitter(kPixFormat_YUV422_UYVY_709,	kPixFormat_XRGB8888,	VDPixmapBlt_422Packed_to_XRGB8888_fused<VDFusedMatrix709, 1, 0, 2>);
+	table.AddBlitter(kPixFormat_YUV422_YUYV_709,	kPixFormat_XRGB8888,	VDPixmapBlt_422Packed_to_XRGB8888_fused<VDFusedMatrix709, 0, 1, 3>);
+	table.AddBlitter(kPixFormat_YUV420_Planar,		kPixFormat_XRGB8888,	VDPixmapBlt_420_to_XRGB8888_fused<VDFusedMatrix601, 1>);
+	table.AddBlitter(kPixFormat_YUV420_Planar_709,	kPixFormat_XRGB8888,	VDPixmapBlt_420_to_XRGB8888_fused<VDFusedMatrix709, 1>);
+	table.AddBlitter(kPixFormat_YUV420_NV12,		kPixFormat_XRGB8888,	VDPixmapBlt_420_to_XRGB8888_fused<VDFusedMatrix601, 2>);
+
+	table.AddBlitter(kPixFormat_XRGB8888,	kPixFormat_YUV422_UYVY,			VDPixmapBlt_XRGB8888_to_422Packed_fused<VDFusedMatrix601, 1, 0, 2>);
+	table.AddBlitter(kPixFormat_XRGB8888,	kPixFormat_YUV422_YUYV,			VDPixmapBlt_XRGB8888_to_422Packed_fused<VDFusedMatrix601, 0, 1, 3>);
+	table.AddBlitter(kPixFormat_XRGB8888,	kPixFormat_YUV422_UYVY_709,		VDPixmapBlt_XRGB8888_to_422Packed_fused<VDFusedMatrix709, 1, 0, 2>);
+	table.AddBlitter(kPixFormat_XRGB8888,	kPixFormat_YUV422_YUYV_709,		VDPixmapBlt_XRGB8888_to_422Packed_fused<VDFusedMatrix709, 0, 1, 3>);
+	table.AddBlitter(kPixFormat_XRGB8888,	kPixFormat_YUV420_Planar,		VDPixmapBlt_XRGB8888_to_420_fused<VDFusedMatrix601, 1>);
+	table.AddBlitter(kPixFormat_XRGB8888,	kPixFormat_YUV420_Planar_709,	VDPixmapBlt_XRGB8888_to_420_fused<VDFusedMatrix709, 1>);
+	table.AddBlitter(kPixFormat_XRGB8888,	kPixFormat_YUV420_NV12,			VDPixmapBlt_XRGB8888_to_420_fused<VDFusedMatrix601, 2>);
+}
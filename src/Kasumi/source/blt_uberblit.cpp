@@ -17,12 +17,20 @@
 //	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 
 #include <stdafx.h>
-#include <vd2/system/vdalloc.h>
 #include <vd2/Kasumi/pixmap.h>
+#include <vd2/Kasumi/blitter.h>
 #include "uberblit.h"
 
 void VDPixmapBlt_UberblitAdapter(const VDPixmap& dst, const VDPixmap& src, vdpixsize w, vdpixsize h) {
-	vdautoptr<IVDPixmapBlitter> blitter(VDPixmapCreateBlitter(dst, src));
+	VDPixmapBlitterCache& cache = VDPixmapGetBlitterCache();
+	IVDPixmapBlitter *blitter = cache.Acquire(dst, src);
+
+	// The adapter is only registered for format pairs that uberblit can
+	// convert, but don't crash if the blitter can't be built anyway.
+	if (!blitter) {
+		VDASSERT(!"Unable to create uberblit blitter for format pair.");
+		return;
+	}
 
 	if (w > src.w)
 		w = src.w;
@@ -35,4 +43,5 @@ void VDPixmapBlt_UberblitAdapter(const VDPixmap& dst, const VDPixmap& src, vdpix
 
 	vdrect32 r(0, 0, w, h);
 	blitter->Blit(dst, &r, src);
+	cache.Release(blitter);
 }
@@ -102,6 +102,17 @@ uint32 VDPixmapSample(const VDPixmap& px, sint32 x, sint32 y) {
 	case nsVDPixmap::kPixFormat_XRGB8888:
 		return ((const uint32 *)((const uint8 *)px.data + px.pitch*y))[x];
 
+	case nsVDPixmap::kPixFormat_XRGB64:
+		{
+			const uint16 *src = (const uint16 *)((const uint8 *)px.data + px.pitch*y) + 4*x;
+			uint32 b = ((uint32)src[0]*255 + 32895) >> 16;
+			uint32 g = ((uint32)src[1]*255 + 32895) >> 16;
+			uint32 r = ((uint32)src[2]*255 + 32895) >> 16;
+
+			return (r << 16) + (g << 8) + b;
+		}
+		break;
+
 	case nsVDPixmap::kPixFormat_Y8:
 		{
 			uint8 luma = ((const uint8 *)px.data + px.pitch*y)[x];
@@ -191,18 +202,18 @@ uint8 VDPixmapInterpolateSample8(const void *data, ptrdiff_t pitch, uint32 w, ui
 	x_256 &= ~(x_256 >> 31);
 	y_256 &= ~(y_256 >> 31);
 
-	uint32 w_256 = (w - 1) << 8;
-	uint32 h_256 = (h - 1) << 8;
-	x_256 ^= (x_256 ^ w_256) & ((x_256 - w_256) >> 31);
-	y_256 ^= (y_256 ^ h_256) & ((y_256 - h_256) >> 31);
+	sint32 w_256 = (w - 1) << 8;
+	sint32 h_256 = (h - 1) << 8;
+	x_256 += (w_256 - x_256) & ((w_256 - x_256) >> 31);
+	y_256 += (h_256 - y_256) & ((h_256 - y_256) >> 31);
 
 	const uint8 *row0 = (const uint8 *)data + pitch * (y_256 >> 8);
 	const uint8 *row1 = row0;
 
-	if ((uint32)y_256 < h_256)
+	if (y_256 < h_256)
 		row1 += pitch;
 
-	ptrdiff_t xstep = (uint32)x_256 < w_256 ? 1 : 0;
+	ptrdiff_t xstep = x_256 < w_256 ? 1 : 0;
 	sint32 xoffset = x_256 & 255;
 	sint32 yoffset = y_256 & 255;
 	sint32 p00 = row0[0];
@@ -259,18 +270,18 @@ uint32 VDPixmapInterpolateSample8x2To24(const void *data, ptrdiff_t pitch, uint3
 	x_256 &= ~(x_256 >> 31);
 	y_256 &= ~(y_256 >> 31);
 
-	uint32 w_256 = (w - 1) << 8;
-	uint32 h_256 = (h - 1) << 8;
-	x_256 ^= (x_256 ^ w_256) & ((x_256 - w_256) >> 31);
-	y_256 ^= (y_256 ^ h_256) & ((y_256 - h_256) >> 31);
+	sint32 w_256 = (w - 1) << 8;
+	sint32 h_256 = (h - 1) << 8;
+	x_256 += (w_256 - x_256) & ((w_256 - x_256) >> 31);
+	y_256 += (h_256 - y_256) & ((h_256 - y_256) >> 31);
 
 	const uint8 *row0 = (const uint8 *)data + pitch * (y_256 >> 8) + (x_256 >> 8)*2;
 	const uint8 *row1 = row0;
 
-	if ((uint32)y_256 < h_256)
+	if (y_256 < h_256)
 		row1 += pitch;
 
-	ptrdiff_t xstep = (uint32)x_256 < w_256 ? 2 : 0;
+	ptrdiff_t xstep = x_256 < w_256 ? 2 : 0;
 	sint32 xoffset = x_256 & 255;
 	sint32 yoffset = y_256 & 255;
 	sint32 p00 = row0[0];
@@ -293,18 +304,18 @@ uint32 VDPixmapInterpolateSample8x4To24(const void *data, ptrdiff_t pitch, uint3
 	x_256 &= ~(x_256 >> 31);
 	y_256 &= ~(y_256 >> 31);
 
-	uint32 w_256 = (w - 1) << 8;
-	uint32 h_256 = (h - 1) << 8;
-	x_256 ^= (x_256 ^ w_256) & ((x_256 - w_256) >> 31);
-	y_256 ^= (y_256 ^ h_256) & ((y_256 - h_256) >> 31);
+	sint32 w_256 = (w - 1) << 8;
+	sint32 h_256 = (h - 1) << 8;
+	x_256 += (w_256 - x_256) & ((w_256 - x_256) >> 31);
+	y_256 += (h_256 - y_256) & ((h_256 - y_256) >> 31);
 
 	const uint8 *row0 = (const uint8 *)data + pitch * (y_256 >> 8) + (x_256 >> 8)*4;
 	const uint8 *row1 = row0;
 
-	if ((uint32)y_256 < h_256)
+	if (y_256 < h_256)
 		row1 += pitch;
 
-	ptrdiff_t xstep = (uint32)x_256 < w_256 ? 4 : 0;
+	ptrdiff_t xstep = x_256 < w_256 ? 4 : 0;
 	sint32 xoffset = x_256 & 255;
 	sint32 yoffset = y_256 & 255;
 	sint32 p00 = row0[0];
@@ -327,18 +338,18 @@ float VDPixmapInterpolateSample16F(const void *data, ptrdiff_t pitch, uint32 w,
 	x_256 &= ~(x_256 >> 31);
 	y_256 &= ~(y_256 >> 31);
 
-	uint32 w_256 = (w - 1) << 8;
-	uint32 h_256 = (h - 1) << 8;
-	x_256 ^= (x_256 ^ w_256) & ((x_256 - w_256) >> 31);
-	y_256 ^= (y_256 ^ h_256) & ((y_256 - h_256) >> 31);
+	sint32 w_256 = (w - 1) << 8;
+	sint32 h_256 = (h - 1) << 8;
+	x_256 += (w_256 - x_256) & ((w_256 - x_256) >> 31);
+	y_256 += (h_256 - y_256) & ((h_256 - y_256) >> 31);
 
 	const uint16 *row0 = (const uint16 *)((const uint8 *)data + pitch * (y_256 >> 8) + (x_256 >> 8)*2);
 	const uint16 *row1 = row0;
 
-	if ((uint32)y_256 < h_256)
+	if (y_256 < h_256)
 		row1 = (const uint16 *)((const char *)row1 + pitch);
 
-	ptrdiff_t xstep = (uint32)x_256 < w_256 ? 1 : 0;
+	ptrdiff_t xstep = x_256 < w_256 ? 1 : 0;
 	float xoffset = (float)(x_256 & 255) * (1.0f / 255.0f);
 	float yoffset = (float)(y_256 & 255) * (1.0f / 255.0f);
 
@@ -503,6 +514,50 @@ namespace {
 		return ConvFn(y, cb, cr);
 	}
 
+	// Returns a bilinearly interpolated 16-bit sample in the same fixed point
+	// scale as VDPixmapInterpolateSample8To24(). The step is in 16-bit words,
+	// so that interleaved chroma can be sampled.
+	sint32 InterpolateSample16To24(const void *data, ptrdiff_t pitch, uint32 w, uint32 h, sint32 x_256, sint32 y_256, int step) {
+		// bias coordinates to integer
+		x_256 -= 128;
+		y_256 -= 128;
+
+		// clamp coordinates
+		x_256 &= ~(x_256 >> 31);
+		y_256 &= ~(y_256 >> 31);
+
+		sint32 w_256 = (w - 1) << 8;
+		sint32 h_256 = (h - 1) << 8;
+		x_256 += (w_256 - x_256) & ((w_256 - x_256) >> 31);
+		y_256 += (h_256 - y_256) & ((h_256 - y_256) >> 31);
+
+		const uint16 *row0 = (const uint16 *)((const uint8 *)data + pitch * (y_256 >> 8)) + (x_256 >> 8)*step;
+		const uint16 *row1 = row0;
+
+		if (y_256 < h_256)
+			row1 = (const uint16 *)((const uint8 *)row1 + pitch);
+
+		ptrdiff_t xstep = x_256 < w_256 ? step : 0;
+		sint32 xoffset = x_256 & 255;
+		sint32 yoffset = y_256 & 255;
+		sint32 p00 = row0[0];
+		sint32 p10 = row0[xstep];
+		sint32 p01 = row1[0];
+		sint32 p11 = row1[xstep];
+		sint32 p0 = (p00 << 4) + (((p10 - p00)*xoffset) >> 4);
+		sint32 p1 = (p01 << 4) + (((p11 - p01)*xoffset) >> 4);
+
+		return (p0 << 4) + (((p1 - p0)*yoffset) >> 4);
+	}
+
+	uint32 InterpPlanarYCC161616(const VDPixmap& px, sint32 x1, sint32 y1, sint32 x23, sint32 y23, uint32 w23, uint32 h23) {
+		sint32 y  = InterpolateSample16To24(px.data, px.pitch, px.w, px.h, x1, y1, 1);
+		sint32 cb = InterpolateSample16To24(px.data2, px.pitch2, w23, h23, x23, y23, 1);
+		sint32 cr = InterpolateSample16To24(px.data3, px.pitch3, w23, h23, x23, y23, 1);
+
+		return ConvertYCC72ToRGB24(y, cb, cr);
+	}
+
 	uint32 SampleV210_Y(const void *src, ptrdiff_t srcpitch, sint32 x, sint32 y, uint32 w, uint32 h) {
 		if (x < 0)
 			x = 0;
@@ -577,6 +632,7 @@ uint32 VDPixmapInterpolateSampleRGB24(const VDPixmap& px, sint32 x_256, sint32 y
 		case nsVDPixmap::kPixFormat_RGB888:
 		case nsVDPixmap::kPixFormat_XRGB1555:
 		case nsVDPixmap::kPixFormat_XRGB8888:
+		case nsVDPixmap::kPixFormat_XRGB64:
 			{
 				x_256 -= 128;
 				y_256 -= 128;
@@ -766,6 +822,23 @@ uint32 VDPixmapInterpolateSampleRGB24(const VDPixmap& px, sint32 x_256, sint32 y
 		case nsVDPixmap::kPixFormat_YUV420i_Planar_709_FR:
 			return InterpPlanarYCC888_420i<ConvertYCC72ToRGB24_709_FR>(px, x_256, y_256);
 
+		case nsVDPixmap::kPixFormat_YUV444_Planar16:
+			return InterpPlanarYCC161616(px, x_256, y_256, x_256, y_256, px.w, px.h);
+
+		case nsVDPixmap::kPixFormat_YUV422_Planar16:
+			return InterpPlanarYCC161616(px, x_256, y_256, (x_256 >> 1) + 64, y_256, (px.w + 1) >> 1, px.h);
+
+		case nsVDPixmap::kPixFormat_YUV420_Planar16:
+			return InterpPlanarYCC161616(px, x_256, y_256, (x_256 >> 1) + 64, y_256 >> 1, (px.w + 1) >> 1, (px.h + 1) >> 1);
+
+		case nsVDPixmap::kPixFormat_YUV420_P010:
+		case nsVDPixmap::kPixFormat_YUV420_P016:
+			return ConvertYCC72ToRGB24(
+					InterpolateSample16To24(px.data, px.pitch, px.w, px.h, x_256, y_256, 1),
+					InterpolateSample16To24((const uint16 *)px.data2 + 0, px.pitch2, (px.w + 1) >> 1, (px.h + 1) >> 1, (x_256 >> 1) + 64, y_256 >> 1, 2),
+					InterpolateSample16To24((const uint16 *)px.data2 + 1, px.pitch2, (px.w + 1) >> 1, (px.h + 1) >> 1, (x_256 >> 1) + 64, y_256 >> 1, 2)
+				);
+
 		case nsVDPixmap::kPixFormat_YUV422_Planar_16F:
 			{
 				float y  = VDPixmapInterpolateSample16F(px.data, px.pitch, px.w, px.h, x_256, y_256);
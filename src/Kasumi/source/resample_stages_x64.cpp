@@ -1,3 +1,5 @@
+#include <emmintrin.h>
+#include <vd2/Kasumi/resample_kernels.h>
 #include "resample_stages_x64.h"
 
 extern "C" long vdasm_resize_table_col_SSE2(uint32 *out, const uint32 *const*in_table, const int *filter, int filter_width, uint32 w);
@@ -24,3 +26,379 @@ void VDResamplerSeparableTableColStageSSE2::Process(void *dst, const void *const
 
 	vdasm_resize_table_col_SSE2((uint32*)dst, (const uint32 *const *)src, (const int *)mFilterBank.data() + filtSize*((phase >> 8) & 0xff), filtSize, w);
 }
+
+///////////////////////////////////////////////////////////////////////////
+//
+// SSE2 intrinsic stages
+//
+// These match the reference stages bit for bit: the 8-bit stages use the
+// same 14-bit fixed point kernels with exact 32-bit sums, and the float
+// stages perform the same multiplies and adds in the same order per pixel,
+// only across several pixels at once.
+//
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	// Sums the four lanes of each of four accumulators: the result holds
+	// the total of a in lane 0 through d in lane 3.
+	inline __m128i VDResamplerHAdd4x4_SSE2(__m128i a, __m128i b, __m128i c, __m128i d) {
+		__m128i ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b), _mm_unpackhi_epi32(a, b));
+		__m128i cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d), _mm_unpackhi_epi32(c, d));
+
+		return _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd));
+	}
+
+	inline __m128i VDResamplerDot8_SSE2(const uint8 *src, const sint16 *kernel, int kwidth) {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i acc = zero;
+
+		for(int i=0; i<kwidth; i += 8) {
+			__m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + i)), zero);
+
+			acc = _mm_add_epi32(acc, _mm_madd_epi16(px, *(const __m128i *)(kernel + i)));
+		}
+
+		return acc;
+	}
+
+	inline uint8 VDResamplerClip8(sint32 v) {
+		v >>= 14;
+
+		if ((uint32)v >= 0x00000100)
+			v = ~v >> 31;
+
+		return (uint8)v;
+	}
+}
+
+VDResamplerSeparableTableRowStage8SSE2::VDResamplerSeparableTableRowStage8SSE2(const IVDResamplerFilter& filter)
+	: VDResamplerRowStageSeparableTable8(filter)
+	, mLastSrcWidth(0)
+	, mLastDstWidth(0)
+	, mLastU(0)
+	, mLastDUDX(0)
+	, mbVectorLoadsSafe(false)
+{
+	mAlignedKernelWidth = (GetWindowSize() + 7) & ~7;
+}
+
+void VDResamplerSeparableTableRowStage8SSE2::Init(const VDResamplerAxis& axis, uint32 srcw) {
+	uint32 w = axis.dx_preclip + axis.dx_active + axis.dx_postclip + axis.dx_dualclip;
+
+	if (mLastSrcWidth != srcw || mLastDstWidth != w || mLastU != axis.u || mLastDUDX != axis.dudx) {
+		mLastSrcWidth	= srcw;
+		mLastDstWidth	= w;
+		mLastU			= axis.u;
+		mLastDUDX		= axis.dudx;
+
+		RedoRowFilters(axis, w, srcw);
+	}
+}
+
+void VDResamplerSeparableTableRowStage8SSE2::RedoRowFilters(const VDResamplerAxis& axis, uint32 w, uint32 srcw) {
+	const int kstride = (int)mFilterBank.size() >> 8;
+	const int ksize = mAlignedKernelWidth;
+
+	// Each output pixel gets a window of ksize source pixels that lies
+	// entirely within the row, with taps that fall off either end of the
+	// row folded into the edge pixels.
+	sint32 maxStart = (sint32)srcw - ksize;
+	if (maxStart < 0)
+		maxStart = 0;
+
+	mbVectorLoadsSafe = (sint32)srcw >= ksize;
+
+	mRowOffsets.resize(w);
+	mRowKernels.clear();
+	mRowKernels.resize(w * ksize, 0);
+
+	sint32 u = axis.u;
+	for(uint32 i=0; i<w; ++i) {
+		const sint32 uoffset = u >> 16;
+		sint32 start = uoffset;
+
+		if (start < 0)
+			start = 0;
+
+		if (start > maxStart)
+			start = maxStart;
+
+		mRowOffsets[i] = start;
+
+		const sint32 *src = &mFilterBank[kstride * ((u >> 8) & 255)];
+		sint16 *dst = &mRowKernels[ksize * i];
+
+		for(int j=0; j<kstride; ++j) {
+			sint32 pos = uoffset + j;
+
+			if (pos < 0)
+				pos = 0;
+
+			if (pos >= (sint32)srcw)
+				pos = srcw - 1;
+
+			VDASSERT((uint32)(pos - start) < (uint32)ksize);
+			dst[pos - start] += (sint16)src[j];
+		}
+
+		u += axis.dudx;
+	}
+}
+
+void VDResamplerSeparableTableRowStage8SSE2::Process(void *dst0, const void *src0, uint32 w) {
+	uint8 *dst = (uint8 *)dst0;
+	const uint8 *src = (const uint8 *)src0;
+	const sint32 *offsets = mRowOffsets.data();
+	const sint16 *kernels = mRowKernels.data();
+	const int ksize = mAlignedKernelWidth;
+
+	VDASSERT(w <= mLastDstWidth);
+
+	if (!mbVectorLoadsSafe) {
+		// The source row is narrower than one kernel window, so eight byte
+		// loads could run off the end of it; the kernel taps past the end
+		// of the row are all zero.
+		const int n = (int)mLastSrcWidth;
+
+		for(uint32 i=0; i<w; ++i) {
+			sint32 b = 0x2000;
+
+			for(int j=0; j<n; ++j)
+				b += (sint32)src[j] * kernels[j];
+
+			kernels += ksize;
+			*dst++ = VDResamplerClip8(b);
+		}
+
+		return;
+	}
+
+	const __m128i round = _mm_set1_epi32(0x2000);
+
+	for(; w >= 4; w -= 4) {
+		__m128i a = VDResamplerDot8_SSE2(src + offsets[0], kernels, ksize);
+		__m128i b = VDResamplerDot8_SSE2(src + offsets[1], kernels + ksize, ksize);
+		__m128i c = VDResamplerDot8_SSE2(src + offsets[2], kernels + ksize*2, ksize);
+		__m128i d = VDResamplerDot8_SSE2(src + offsets[3], kernels + ksize*3, ksize);
+
+		__m128i sum = _mm_srai_epi32(_mm_add_epi32(VDResamplerHAdd4x4_SSE2(a, b, c, d), round), 14);
+		__m128i px = _mm_packs_epi32(sum, sum);
+
+		*(int *)dst = _mm_cvtsi128_si32(_mm_packus_epi16(px, px));
+
+		offsets += 4;
+		kernels += ksize*4;
+		dst += 4;
+	}
+
+	while(w--) {
+		__m128i a = VDResamplerDot8_SSE2(src + *offsets++, kernels, ksize);
+
+		a = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)));
+		a = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+
+		*dst++ = VDResamplerClip8(_mm_cvtsi128_si32(a) + 0x2000);
+		kernels += ksize;
+	}
+}
+
+void VDResamplerSeparableTableRowStage8SSE2::Process(void *dst, const void *src, uint32 w, uint32 u, uint32 dudx) {
+	VDResamplerRowStageSeparableTable8::Process(dst, src, w, u, dudx);
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+VDResamplerSeparableTableColStage8SSE2::VDResamplerSeparableTableColStage8SSE2(const IVDResamplerFilter& filter)
+	: VDResamplerColStageSeparableTable8(filter)
+{
+	mCoeffPairs.resize(((GetWindowSize() + 1) >> 1) * 4);
+}
+
+void VDResamplerSeparableTableColStage8SSE2::Process(void *dst0, const void *const *src0, uint32 w, sint32 phase) {
+	uint8 *dst = (uint8 *)dst0;
+	const uint8 *const *src = (const uint8 *const *)src0;
+	const unsigned ksize = (unsigned)mFilterBank.size() >> 8;
+	const sint32 *filter = &mFilterBank[((phase>>8)&0xff) * ksize];
+	const unsigned kpairs = (ksize + 1) >> 1;
+
+	// interleave adjacent taps for pmaddwd; an odd last tap pairs with zero
+	for(unsigned j=0; j<kpairs; ++j) {
+		const sint32 c0 = filter[j*2];
+		const sint32 c1 = j*2+1 < ksize ? filter[j*2+1] : 0;
+
+		_mm_store_si128((__m128i *)&mCoeffPairs[j*4], _mm_set1_epi32((int)(((uint32)c0 & 0xffff) + ((uint32)c1 << 16))));
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi32(0x2000);
+	const __m128i *coeffs = (const __m128i *)mCoeffPairs.data();
+	const uint32 w16 = w & ~15;
+
+	for(uint32 i=0; i<w16; i += 16) {
+		__m128i acc0 = round;
+		__m128i acc1 = round;
+		__m128i acc2 = round;
+		__m128i acc3 = round;
+
+		for(unsigned j=0; j<kpairs; ++j) {
+			const uint8 *r0 = src[j*2];
+			const uint8 *r1 = j*2+1 < ksize ? src[j*2+1] : r0;
+			const __m128i c = coeffs[j];
+
+			__m128i a = _mm_loadu_si128((const __m128i *)(r0 + i));
+			__m128i b = _mm_loadu_si128((const __m128i *)(r1 + i));
+			__m128i alo = _mm_unpacklo_epi8(a, zero);
+			__m128i ahi = _mm_unpackhi_epi8(a, zero);
+			__m128i blo = _mm_unpacklo_epi8(b, zero);
+			__m128i bhi = _mm_unpackhi_epi8(b, zero);
+
+			acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi16(alo, blo), c));
+			acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi16(alo, blo), c));
+			acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(_mm_unpacklo_epi16(ahi, bhi), c));
+			acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(_mm_unpackhi_epi16(ahi, bhi), c));
+		}
+
+		__m128i lo = _mm_packs_epi32(_mm_srai_epi32(acc0, 14), _mm_srai_epi32(acc1, 14));
+		__m128i hi = _mm_packs_epi32(_mm_srai_epi32(acc2, 14), _mm_srai_epi32(acc3, 14));
+
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+	}
+
+	for(uint32 i=w16; i<w; ++i) {
+		sint32 b = 0x2000;
+
+		for(unsigned j=0; j<ksize; ++j)
+			b += (sint32)src[j][i] * filter[j];
+
+		dst[i] = VDResamplerClip8(b);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+VDResamplerSeparableTableRowStage32FSSE2::VDResamplerSeparableTableRowStage32FSSE2(const IVDResamplerFilter& filter)
+	: VDResamplerRowStageSeparableTable32F(filter)
+{
+}
+
+void VDResamplerSeparableTableRowStage32FSSE2::Process(void *dst0, const void *src0, uint32 w, uint32 u, uint32 dudx) {
+	float *dst = (float *)dst0;
+	const float *src = (const float *)src0;
+	const unsigned ksize = (int)mFilterBank.size() >> 8;
+	const float *filterBase = mFilterBank.data();
+
+	// four output pixels at a time, one per lane
+	for(; w >= 4; w -= 4) {
+		const float *s0 = src + (u>>16);
+		const float *f0 = filterBase + ksize*((u>>8)&0xff);
+		u += dudx;
+		const float *s1 = src + (u>>16);
+		const float *f1 = filterBase + ksize*((u>>8)&0xff);
+		u += dudx;
+		const float *s2 = src + (u>>16);
+		const float *f2 = filterBase + ksize*((u>>8)&0xff);
+		u += dudx;
+		const float *s3 = src + (u>>16);
+		const float *f3 = filterBase + ksize*((u>>8)&0xff);
+		u += dudx;
+
+		__m128 acc = _mm_setzero_ps();
+		for(unsigned i=0; i<ksize; ++i)
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set_ps(f3[i], f2[i], f1[i], f0[i]), _mm_set_ps(s3[i], s2[i], s1[i], s0[i])));
+
+		_mm_storeu_ps(dst, acc);
+		dst += 4;
+	}
+
+	while(w--) {
+		const float *src2 = src + (u>>16);
+		const float *filter = filterBase + ksize*((u>>8)&0xff);
+		u += dudx;
+
+		__m128 acc = _mm_setzero_ps();
+		for(unsigned i=0; i<ksize; ++i)
+			acc = _mm_add_ss(acc, _mm_mul_ss(_mm_load_ss(filter + i), _mm_load_ss(src2 + i)));
+
+		_mm_store_ss(dst++, acc);
+	}
+}
+
+VDResamplerSeparableTableRowStage32Fx4SSE2::VDResamplerSeparableTableRowStage32Fx4SSE2(const IVDResamplerFilter& filter)
+	: VDResamplerRowStageSeparableTable32Fx4(filter)
+{
+}
+
+void VDResamplerSeparableTableRowStage32Fx4SSE2::Process(void *dst0, const void *src0, uint32 w, uint32 u, uint32 dudx) {
+	float *dst = (float *)dst0;
+	const float *src = (const float *)src0;
+	const unsigned ksize = (int)mFilterBank.size() >> 8;
+	const float *filterBase = mFilterBank.data();
+
+	do {
+		const float *src2 = src + (u>>16)*4;
+		const float *filter = filterBase + ksize*((u>>8)&0xff);
+		u += dudx;
+
+		__m128 acc = _mm_setzero_ps();
+		for(unsigned i=0; i<ksize; ++i) {
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(filter[i]), _mm_loadu_ps(src2)));
+			src2 += 4;
+		}
+
+		_mm_storeu_ps(dst, acc);
+		dst += 4;
+	} while(--w);
+}
+
+VDResamplerSeparableTableColStage32FSSE2::VDResamplerSeparableTableColStage32FSSE2(const IVDResamplerFilter& filter)
+	: VDResamplerColStageSeparableTable32F(filter)
+{
+}
+
+void VDResamplerSeparableTableColStage32FSSE2::Process(void *dst0, const void *const *src0, uint32 w, sint32 phase) {
+	float *dst = (float *)dst0;
+	const float *const *src = (const float *const *)src0;
+	const unsigned ksize = (unsigned)mFilterBank.size() >> 8;
+	const float *filter = &mFilterBank[((phase>>8)&0xff) * ksize];
+	const uint32 w4 = w & ~3;
+
+	for(uint32 i=0; i<w4; i += 4) {
+		__m128 acc = _mm_setzero_ps();
+
+		for(unsigned j=0; j<ksize; ++j)
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(src[j] + i), _mm_set1_ps(filter[j])));
+
+		_mm_storeu_ps(dst + i, acc);
+	}
+
+	for(uint32 i=w4; i<w; ++i) {
+		__m128 acc = _mm_setzero_ps();
+
+		for(unsigned j=0; j<ksize; ++j)
+			acc = _mm_add_ss(acc, _mm_mul_ss(_mm_load_ss(src[j] + i), _mm_load_ss(filter + j)));
+
+		_mm_store_ss(dst + i, acc);
+	}
+}
+
+VDResamplerSeparableTableColStage32Fx4SSE2::VDResamplerSeparableTableColStage32Fx4SSE2(const IVDResamplerFilter& filter)
+	: VDResamplerColStageSeparableTable32Fx4(filter)
+{
+}
+
+void VDResamplerSeparableTableColStage32Fx4SSE2::Process(void *dst0, const void *const *src0, uint32 w, sint32 phase) {
+	float *dst = (float *)dst0;
+	const float *const *src = (const float *const *)src0;
+	const unsigned ksize = (unsigned)mFilterBank.size() >> 8;
+	const float *filter = &mFilterBank[((phase>>8)&0xff) * ksize];
+
+	for(uint32 i=0; i<w; ++i) {
+		__m128 acc = _mm_setzero_ps();
+
+		for(unsigned j=0; j<ksize; ++j)
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(src[j] + i*4), _mm_set1_ps(filter[j])));
+
+		_mm_storeu_ps(dst, acc);
+		dst += 4;
+	}
+}
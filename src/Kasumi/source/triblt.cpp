@@ -19,6 +19,7 @@
 #include <stdafx.h>
 #include <math.h>
 #include <vector>
+#include <vd2/system/bandtask.h>
 #include <vd2/system/math.h>
 #include <vd2/system/cpuaccel.h>
 #include <vd2/system/vdalloc.h>
@@ -29,6 +30,10 @@
 #include <vd2/Kasumi/tables.h>
 #include <vd2/Kasumi/triblt.h>
 
+#if defined(VD_CPU_AMD64)
+	#include <emmintrin.h>
+#endif
+
 namespace {
 	uint32 lerp_RGB888(sint32 a, sint32 b, sint32 x) {
 		sint32 a_rb	= a & 0xff00ff;
@@ -275,6 +280,187 @@ namespace {
 	extern "C" void vdasm_triblt_span_point(const VDTriBltInfo *pInfo);
 #endif
 
+#if defined(VD_CPU_AMD64)
+	// SSE2 versions of the span functions. These give the same results as
+	// the C versions above.
+
+	// Bilinearly filters two pairs of adjacent texels, held in the low
+	// halves of top and bot. The result is returned as 16-bit channels in
+	// the low half.
+	inline __m128i bilerp_RGB888_SSE2(__m128i top, __m128i bot, sint32 x, sint32 y) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i round = _mm_set1_epi16(128);
+		const __m128i xf = _mm_unpacklo_epi64(_mm_set1_epi16((short)(256 - x)), _mm_set1_epi16((short)x));
+		const __m128i yf = _mm_unpacklo_epi64(_mm_set1_epi16((short)(256 - y)), _mm_set1_epi16((short)y));
+
+		// a*(256-x) + b*x is at most 65280, so the sums can't overflow
+		__m128i t = _mm_mullo_epi16(_mm_unpacklo_epi8(top, zero), xf);
+		__m128i b = _mm_mullo_epi16(_mm_unpacklo_epi8(bot, zero), xf);
+
+		t = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(t, _mm_srli_si128(t, 8)), round), 8);
+		b = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(b, _mm_srli_si128(b, 8)), round), 8);
+
+		// the vertical pass truncates, like bilerp_RGB888()
+		__m128i v = _mm_mullo_epi16(_mm_unpacklo_epi64(t, b), yf);
+
+		return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_si128(v, 8)), 8);
+	}
+
+	inline __m128i bilerp_RGB888_SSE2(const uint32 *src1, const uint32 *src2, sint32 x, sint32 y) {
+		return bilerp_RGB888_SSE2(_mm_loadl_epi64((const __m128i *)src1), _mm_loadl_epi64((const __m128i *)src2), x, y);
+	}
+
+	// Blends two pixels held as 16-bit channels in the low halves of a and b.
+	inline uint32 lerp_RGB888_SSE2(__m128i a, __m128i b, sint32 x) {
+		const __m128i xf = _mm_unpacklo_epi64(_mm_set1_epi16((short)(256 - x)), _mm_set1_epi16((short)x));
+		__m128i v = _mm_mullo_epi16(_mm_unpacklo_epi64(a, b), xf);
+
+		v = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(v, _mm_srli_si128(v, 8)), _mm_set1_epi16(128)), 8);
+
+		return _mm_cvtsi128_si32(_mm_packus_epi16(v, v)) & 0xffffff;
+	}
+
+	inline __m128i bicubic_RGB888_row_SSE2(const uint32 *src, __m128i ch01, __m128i ch23) {
+		const __m128i zero = _mm_setzero_si128();
+
+		// interleave the channels of texels 0/1 and 2/3 for pmaddwd
+		__m128i px = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)src), _MM_SHUFFLE(3,1,2,0));
+		px = _mm_unpacklo_epi8(px, _mm_srli_si128(px, 8));
+
+		__m128i sum = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi8(px, zero), ch01), _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), ch23));
+
+		return _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(128)), 8);
+	}
+
+	// Returns the filtered pixel as 16-bit channels in the low half.
+	inline __m128i bicubic_RGB888_SSE2(const uint32 *src0, const uint32 *src1, const uint32 *src2, const uint32 *src3, sint32 x, sint32 y) {
+		const sint32 *htab = kVDCubicInterpTableFX14_075[x];
+		const sint32 *vtab = kVDCubicInterpTableFX14_075[y];
+
+		const __m128i ch01 = _mm_set1_epi32((htab[0] & 0xffff) + (htab[1] << 16));
+		const __m128i ch23 = _mm_set1_epi32((htab[2] & 0xffff) + (htab[3] << 16));
+		const __m128i cv01 = _mm_set1_epi32((vtab[0] & 0xffff) + (vtab[1] << 16));
+		const __m128i cv23 = _mm_set1_epi32((vtab[2] & 0xffff) + (vtab[3] << 16));
+
+		// the horizontal results fit in 16 bits, so they can be packed for the
+		// vertical pass
+		__m128i r01 = _mm_packs_epi32(bicubic_RGB888_row_SSE2(src0, ch01, ch23), bicubic_RGB888_row_SSE2(src1, ch01, ch23));
+		__m128i r23 = _mm_packs_epi32(bicubic_RGB888_row_SSE2(src2, ch01, ch23), bicubic_RGB888_row_SSE2(src3, ch01, ch23));
+
+		r01 = _mm_unpacklo_epi16(r01, _mm_srli_si128(r01, 8));
+		r23 = _mm_unpacklo_epi16(r23, _mm_srli_si128(r23, 8));
+
+		__m128i sum = _mm_add_epi32(_mm_madd_epi16(r01, cv01), _mm_madd_epi16(r23, cv23));
+		sum = _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(1 << 19)), 20);
+
+		// clamp to 0-255
+		sum = _mm_packs_epi32(sum, sum);
+		return _mm_unpacklo_epi8(_mm_packus_epi16(sum, sum), _mm_setzero_si128());
+	}
+
+	void vd_triblt_span_bilinear_sse2(const VDTriBltInfo *pInfo) {
+		sint32 w = -pInfo->width;
+		uint32 *dst = pInfo->dst + pInfo->width;
+		const uint32 *src = pInfo->src;
+		const uint32 *texture = pInfo->mips[0].mip;
+		const ptrdiff_t texpitch = pInfo->mips[0].pitch;
+
+		do {
+			const sint32 u = src[0];
+			const sint32 v = src[1];
+			src += 2;
+			const uint32 *src1 = vdptroffset(texture, texpitch * (v>>8)) + (u>>8);
+			const uint32 *src2 = vdptroffset(src1, texpitch);
+
+			const __m128i p = bilerp_RGB888_SSE2(src1, src2, u&255, v&255);
+
+			dst[w] = _mm_cvtsi128_si32(_mm_packus_epi16(p, p)) & 0xffffff;
+		} while(++w);
+	}
+
+	void vd_triblt_span_trilinear_sse2(const VDTriBltInfo *pInfo) {
+		sint32 w = -pInfo->width;
+		uint32 *dst = pInfo->dst + pInfo->width;
+		const uint32 *src = pInfo->src;
+
+		do {
+			sint32 u = src[0];
+			sint32 v = src[1];
+			const sint32 lambda = src[2];
+			src += 3;
+
+			const sint32 lod = lambda >> 8;
+
+			const uint32 *texture1 = pInfo->mips[lod].mip;
+			const ptrdiff_t texpitch1 = pInfo->mips[lod].pitch;
+			const uint32 *texture2 = pInfo->mips[lod+1].mip;
+			const ptrdiff_t texpitch2 = pInfo->mips[lod+1].pitch;
+
+			u >>= lod;
+			v >>= lod;
+
+			u += 128;
+			v += 128;
+
+			const uint32 *src1 = vdptroffset(texture1, texpitch1 * (v>>8)) + (u>>8);
+			const uint32 *src2 = vdptroffset(src1, texpitch1);
+			const __m128i p1 = bilerp_RGB888_SSE2(src1, src2, u&255, v&255);
+
+			u += 128;
+			v += 128;
+
+			const uint32 *src3 = vdptroffset(texture2, texpitch2 * (v>>9)) + (u>>9);
+			const uint32 *src4 = vdptroffset(src3, texpitch2);
+			const __m128i p2 = bilerp_RGB888_SSE2(src3, src4, (u>>1)&255, (v>>1)&255);
+
+			dst[w] = lerp_RGB888_SSE2(p1, p2, lambda & 255);
+		} while(++w);
+	}
+
+	void vd_triblt_span_bicubic_mip_linear_sse2(const VDTriBltInfo *pInfo) {
+		sint32 w = -pInfo->width;
+		uint32 *dst = pInfo->dst + pInfo->width;
+		const uint32 *src = pInfo->src;
+
+		do {
+			sint32 u = src[0];
+			sint32 v = src[1];
+			const sint32 lambda = src[2];
+			src += 3;
+
+			const sint32 lod = lambda >> 8;
+
+			const uint32 *texture1 = pInfo->mips[lod].mip;
+			const ptrdiff_t texpitch1 = pInfo->mips[lod].pitch;
+			const uint32 *texture2 = pInfo->mips[lod+1].mip;
+			const ptrdiff_t texpitch2 = pInfo->mips[lod+1].pitch;
+
+			u >>= lod;
+			v >>= lod;
+
+			u += 128;
+			v += 128;
+
+			const uint32 *src1 = vdptroffset(texture1, texpitch1 * (v>>8)) + (u>>8);
+			const uint32 *src2 = vdptroffset(src1, texpitch1);
+			const uint32 *src3 = vdptroffset(src2, texpitch1);
+			const uint32 *src4 = vdptroffset(src3, texpitch1);
+			const __m128i p1 = bicubic_RGB888_SSE2(src1, src2, src3, src4, u&255, v&255);
+
+			u += 128;
+			v += 128;
+
+			const uint32 *src5 = vdptroffset(texture2, texpitch2 * (v>>9)) + (u>>9);
+			const uint32 *src6 = vdptroffset(src5, texpitch2);
+			const uint32 *src7 = vdptroffset(src6, texpitch2);
+			const uint32 *src8 = vdptroffset(src7, texpitch2);
+			const __m128i p2 = bicubic_RGB888_SSE2(src5, src6, src7, src8, (u>>1)&255, (v>>1)&255);
+
+			dst[w] = lerp_RGB888_SSE2(p1, p2, lambda & 255);
+		} while(++w);
+	}
+#endif
+
 	struct VDTriBltTransformedVertex {
 		float x, y, z;
 		union {
@@ -523,7 +709,20 @@ namespace {
 		setup.pr = pr;
 	}
 
-	void RenderTri(VDPixmap& dst, const VDPixmap *const *pSources, int nMipmaps,
+	struct VDTriBltRasterTri {
+		VDTriBltSpanFunction drawSpan;
+		bool	lambda;
+
+		int		y, y1, y2;
+		double	xl, xr, ul, vl, rhwl;
+		double	xl2, xr2, ul2, vl2, rhwl2;
+		double	dxl1, dxr1, dul1, dvl1, drhwl1;
+		double	dxl2, dxr2, dul2, dvl2, drhwl2;
+		double	dudx, dvdx, drhwdx;
+		float	rhobase;
+	};
+
+	bool SetupRenderTri(VDTriBltRasterTri& tri, VDPixmap& dst,
 							const VDTriBltTransformedVertex *vx0,
 							const VDTriBltTransformedVertex *vx1,
 							const VDTriBltTransformedVertex *vx2,
@@ -543,7 +742,7 @@ namespace {
 		const float A = x20*y10 - x10*y20;
 
 		if (A <= 0.f)
-			return;
+			return false;
 
 		float invA = 0.f;
 		if (A >= 1e-5f)
@@ -664,11 +863,9 @@ namespace {
 			xr2 = xr + dxr1 * (y1 - y);
 		}
 
-		// rasterize
-		const ptrdiff_t dstpitch = dst.pitch;
-		uint32 *dstp = (uint32 *)((char *)dst.data + dstpitch * y);
+		if (y >= y2)
+			return false;
 
-		VDTriBltInfo texinfo;
 		VDTriBltSpanFunction drawSpan;
 		uint32 cpuflags = CPUGetEnabledExtensions();
 
@@ -684,6 +881,10 @@ namespace {
 				drawSpan = vdasm_triblt_span_bicubic_mip_linear_mmx;
 				triBlt16 = true;
 			} else
+#elif defined(VD_CPU_AMD64)
+			if (cpuflags & CPUF_SUPPORTS_SSE2)
+				drawSpan = vd_triblt_span_bicubic_mip_linear_sse2;
+			else
 #endif
 				drawSpan = vd_triblt_span_bicubic_mip_linear;
 			break;
@@ -693,6 +894,10 @@ namespace {
 				drawSpan = vdasm_triblt_span_trilinear_mmx;
 				triBlt16 = true;
 			} else
+#elif defined(VD_CPU_AMD64)
+			if (cpuflags & CPUF_SUPPORTS_SSE2)
+				drawSpan = vd_triblt_span_trilinear_sse2;
+			else
 #endif
 				drawSpan = vd_triblt_span_trilinear;
 			break;
@@ -702,15 +907,20 @@ namespace {
 				drawSpan = vdasm_triblt_span_bilinear_mmx;
 				triBlt16 = true;
 			} else
+#elif defined(VD_CPU_AMD64)
+			if (cpuflags & CPUF_SUPPORTS_SSE2)
+				drawSpan = vd_triblt_span_bilinear_sse2;
+			else
 #endif
 				drawSpan = vd_triblt_span_bilinear;
 			break;
 		case kTriBltFilterPoint:
+		default:
 			drawSpan = vd_triblt_span_point;
 			break;
 		}
 
-		float rhobase = sqrtf(std::max<float>(dudx*dudx + dvdx*dvdx, dudy*dudy + dvdy*dvdy) * (1.0f / 65536.0f)) * powf(2.0f, mipMapLODBias);
+		tri.rhobase = sqrtf(std::max<float>(dudx*dudx + dvdx*dvdx, dudy*dudy + dvdy*dvdy) * (1.0f / 65536.0f)) * powf(2.0f, mipMapLODBias);
 
 		if (triBlt16) {
 			ul *= 256.0f;
@@ -723,27 +933,87 @@ namespace {
 			dvl2 *= 256.0f;
 			dudx *= 256.0f;
 			dvdx *= 256.0f;
-			dudy *= 256.0f;
-			dvdy *= 256.0f;
 		}
 
-		int minx1 = (int)floor(std::min<float>(std::min<float>(pl->x, pr->x), pt->x) + 0.5);
-		int maxx2 = (int)floor(std::max<float>(std::max<float>(pl->x, pr->x), pt->x) + 0.5);
+		tri.drawSpan	= drawSpan;
+		tri.lambda		= filterMode >= kTriBltFilterTrilinear;
+		tri.y		= y;
+		tri.y1		= y1;
+		tri.y2		= y2;
+		tri.xl		= xl;
+		tri.xr		= xr;
+		tri.ul		= ul;
+		tri.vl		= vl;
+		tri.rhwl	= rhwl;
+		tri.xl2		= xl2;
+		tri.xr2		= xr2;
+		tri.ul2		= ul2;
+		tri.vl2		= vl2;
+		tri.rhwl2	= rhwl2;
+		tri.dxl1	= dxl1;
+		tri.dxr1	= dxr1;
+		tri.dul1	= dul1;
+		tri.dvl1	= dvl1;
+		tri.drhwl1	= drhwl1;
+		tri.dxl2	= dxl2;
+		tri.dxr2	= dxr2;
+		tri.dul2	= dul2;
+		tri.dvl2	= dvl2;
+		tri.drhwl2	= drhwl2;
+		tri.dudx	= dudx;
+		tri.dvdx	= dvdx;
+		tri.drhwdx	= drhwdx;
+		return true;
+	}
 
-		uint32 *const spanptr = new uint32[3 * (maxx2 - minx1)];
+	// Rasterizes the scanlines of a triangle that lie within [ystart, yend).
+	// The edges are evaluated directly at each scanline rather than stepped,
+	// so the result does not depend on how the triangle is split into bands.
+	// The span buffer must hold 3*dst.w entries.
+	void RenderTriRows(const VDTriBltRasterTri& tri, VDPixmap& dst, const VDPixmap *const *pSources, int nMipmaps, int ystart, int yend, uint32 *spanptr) {
+		int y = std::max<int>(tri.y, ystart);
+		int ylimit = std::min<int>(tri.y2, yend);
 
-		while(y < y2) {
-			if (y == y1) {
-				xl = xl2;
-				xr = xr2;
-				ul = ul2;
-				vl = vl2;
-				rhwl = rhwl2;
-				dxl1 = dxl2;
-				dxr1 = dxr2;
-				dul1 = dul2;
-				dvl1 = dvl2;
-				drhwl1 = drhwl2;
+		if (y >= ylimit)
+			return;
+
+		const ptrdiff_t dstpitch = dst.pitch;
+		uint32 *dstp = (uint32 *)((char *)dst.data + dstpitch * y);
+
+		VDTriBltInfo texinfo;
+
+		for(int i=0; i<nMipmaps; ++i) {
+			texinfo.mips[i].mip		= (const uint32 *)pSources[i]->data;
+			texinfo.mips[i].pitch	= pSources[i]->pitch;
+			texinfo.mips[i].uvmul	= (pSources[i]->pitch << 16) + 4;
+		}
+
+		texinfo.src = spanptr;
+
+		const double dudx = tri.dudx;
+		const double dvdx = tri.dvdx;
+		const double drhwdx = tri.drhwdx;
+		const float rhobase = tri.rhobase;
+
+		for(; y < ylimit; ++y) {
+			double xl, xr, ul, vl, rhwl;
+
+			if (y < tri.y1) {
+				const int dy = y - tri.y;
+
+				xl		= tri.xl + tri.dxl1 * dy;
+				xr		= tri.xr + tri.dxr1 * dy;
+				ul		= tri.ul + tri.dul1 * dy;
+				vl		= tri.vl + tri.dvl1 * dy;
+				rhwl	= tri.rhwl + tri.drhwl1 * dy;
+			} else {
+				const int dy = y - tri.y1;
+
+				xl		= tri.xl2 + tri.dxl2 * dy;
+				xr		= tri.xr2 + tri.dxr2 * dy;
+				ul		= tri.ul2 + tri.dul2 * dy;
+				vl		= tri.vl2 + tri.dvl2 * dy;
+				rhwl	= tri.rhwl2 + tri.drhwl2 * dy;
 			}
 
 			int x1, x2;
@@ -754,6 +1024,12 @@ namespace {
 
 			x1		= (int)floor(xl + 0.5);
 			x2		= (int)floor(xr + 0.5);
+
+			if (x1 < 0)
+				x1 = 0;
+			if (x2 > dst.w)
+				x2 = dst.w;
+
 			xf		= (x1+0.5) - xl;
 			
 			u		= ul + xf * dudx;
@@ -766,7 +1042,7 @@ namespace {
 			float w = 1.0f / (float)rhw;
 
 			if (x < x2) {
-				if (filterMode >= kTriBltFilterTrilinear) {
+				if (tri.lambda) {
 					do {
 						int utexel = VDRoundToIntFastFullRange(u * w);
 						int vtexel = VDRoundToIntFastFullRange(v * w);
@@ -805,31 +1081,120 @@ namespace {
 						w *= (2.0f - w*(float)rhw);
 					} while(++x < x2);
 				}
-			}
 
-			for(int i=0; i<nMipmaps; ++i) {
-				texinfo.mips[i].mip		= (const uint32 *)pSources[i]->data;
-				texinfo.mips[i].pitch	= pSources[i]->pitch;
-				texinfo.mips[i].uvmul	= (pSources[i]->pitch << 16) + 4;
-			}
-			texinfo.dst = dstp+x1;
-			texinfo.src = spanptr;
-			texinfo.width = x2-x1;
+				texinfo.dst = dstp+x1;
+				texinfo.width = x2-x1;
 
-			if (texinfo.width>0)
-				drawSpan(&texinfo);
+				tri.drawSpan(&texinfo);
+			}
 
 			dstp = vdptroffset(dstp, dstpitch);
-			xl += dxl1;
-			xr += dxr1;
-			ul += dul1;
-			vl += dvl1;
-			rhwl += drhwl1;
+		}
+	}
 
-			++y;
+	void RenderTri(VDPixmap& dst, const VDPixmap *const *pSources, int nMipmaps,
+							const VDTriBltTransformedVertex *vx0,
+							const VDTriBltTransformedVertex *vx1,
+							const VDTriBltTransformedVertex *vx2,
+							VDTriBltFilterMode filterMode,
+							float mipMapLODBias)
+	{
+		VDTriBltRasterTri tri;
+
+		if (SetupRenderTri(tri, dst, vx0, vx1, vx2, filterMode, mipMapLODBias)) {
+			vdautoarrayptr<uint32> spanbuf(new uint32[3 * dst.w]);
+
+			RenderTriRows(tri, dst, pSources, nMipmaps, 0, dst.h, spanbuf.get());
 		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	//
+	//	Tiled rendering
+	//
+	//	The destination is split into bands of scanlines, each of which is
+	//	rendered with all triangles in submission order. Tiles are dealt out
+	//	to the bands of a band task in a fixed interleave, so no two threads
+	//	ever touch the same pixels and the output is the same regardless of
+	//	band count.
+	//
+	///////////////////////////////////////////////////////////////////////////
+
+	class VDTriBltTileRenderer : public VDBandTask {
+	public:
+		enum {
+			kTileRows = 16,
+			kMaxBands = 8,
+			kMinPixelsPerBand = 65536
+		};
+
+		VDTriBltTileRenderer(VDPixmap& dst, const VDPixmap *const *pSources, int nMipmaps, const VDTriBltRasterTri *tris, uint32 triCount);
+
+		void Render();
+		void RenderTiles(int firstTile, int tileStep, uint32 *spanbuf);
 
-		delete[] spanptr;
+	protected:
+		void RunBand(uint32 band, uint32 bandCount);
+
+		VDPixmap& mDst;
+		const VDPixmap *const *mpSources;
+		const int mMipmapCount;
+		const VDTriBltRasterTri *const mpTris;
+		const uint32 mTriCount;
+		const int mTileCount;
+		uint32 *mpSpanBuffers;
+	};
+
+	VDTriBltTileRenderer::VDTriBltTileRenderer(VDPixmap& dst, const VDPixmap *const *pSources, int nMipmaps, const VDTriBltRasterTri *tris, uint32 triCount)
+		: mDst(dst)
+		, mpSources(pSources)
+		, mMipmapCount(nMipmaps)
+		, mpTris(tris)
+		, mTriCount(triCount)
+		, mTileCount((dst.h + kTileRows - 1) / kTileRows)
+		, mpSpanBuffers(NULL)
+	{
+	}
+
+	void VDTriBltTileRenderer::Render() {
+		// Estimate the amount of work from the covered scanlines; this is
+		// only used to decide how many bands are worth running.
+		uint64 pixels = 0;
+		for(uint32 i=0; i<mTriCount; ++i) {
+			const VDTriBltRasterTri& tri = mpTris[i];
+
+			pixels += (uint64)(tri.y2 - tri.y) * (uint32)mDst.w;
+		}
+
+		const uint32 bandCount = VDGetBandCount(pixels, kMinPixelsPerBand, kMaxBands, mTileCount);
+
+		// Allocate the span buffers for all bands up front, so the bands
+		// themselves don't allocate.
+		vdfastvector<uint32> spanbufs(3 * mDst.w * bandCount);
+		mpSpanBuffers = spanbufs.data();
+
+		VDRunBandTask(*this, bandCount);
+
+		mpSpanBuffers = NULL;
+	}
+
+	void VDTriBltTileRenderer::RunBand(uint32 band, uint32 bandCount) {
+		RenderTiles(band, bandCount, mpSpanBuffers + 3 * mDst.w * band);
+	}
+
+	void VDTriBltTileRenderer::RenderTiles(int firstTile, int tileStep, uint32 *spanbuf) {
+
+		for(int tile = firstTile; tile < mTileCount; tile += tileStep) {
+			const int ystart = tile * kTileRows;
+			const int yend = std::min<int>(ystart + kTileRows, mDst.h);
+
+			for(uint32 i=0; i<mTriCount; ++i) {
+				const VDTriBltRasterTri& tri = mpTris[i];
+
+				if (tri.y < yend && tri.y2 > ystart)
+					RenderTriRows(tri, mDst, mpSources, mMipmapCount, ystart, yend, spanbuf);
+			}
+		}
 	}
 
 	void FillTri(VDPixmap& dst, uint32 c,
@@ -1630,6 +1995,8 @@ bool VDPixmapTriBlt(VDPixmap& dst, const VDPixmap *const *pSources, int nMipmaps
 	const VDTriBltTransformedVertex *xsrc = xverts.data();
 
 	VDTriClipWorkspace clipws;
+	vdfastvector<VDTriBltRasterTri> tris;
+	VDTriBltRasterTri tri;
 
 	while(nIndices >= 3) {
 		const int idx0 = pIndices[0];
@@ -1651,18 +2018,25 @@ bool VDPixmapTriBlt(VDPixmap& dst, const VDPixmap *const *pSources, int nMipmaps
 
 					// fan out triangles
 					while(src[1]) {
-						RenderTri(dst, pSources, nMipmaps, src0, src[0], src[1], filterMode, mipMapLODBias);
+						if (SetupRenderTri(tri, dst, src0, src[0], src[1], filterMode, mipMapLODBias))
+							tris.push_back(tri);
 						++src;
 					}
 				}
-			} else
-				RenderTri(dst, pSources, nMipmaps, xv0, xv1, xv2, filterMode, mipMapLODBias);
+			} else if (SetupRenderTri(tri, dst, xv0, xv1, xv2, filterMode, mipMapLODBias))
+				tris.push_back(tri);
 		}
 
 		pIndices += 3;
 		nIndices -= 3;
 	}
 
+	if (!tris.empty()) {
+		VDTriBltTileRenderer renderer(dst, pSources, nMipmaps, tris.data(), (uint32)tris.size());
+
+		renderer.Render();
+	}
+
 	return true;
 }
 
@@ -82,6 +82,12 @@ uint32 VDPixmapGetFormatTokenFromFormat(int format) {
 	case kPixFormat_YUV420ib_Planar_FR:		return kVDPixType_8_8_8 | kVDPixSamp_420_MPEG2INT2 | kVDPixSpace_YCC_601_FR;
 	case kPixFormat_YUV420ib_Planar_709:	return kVDPixType_8_8_8 | kVDPixSamp_420_MPEG2INT2 | kVDPixSpace_YCC_709;
 	case kPixFormat_YUV420ib_Planar_709_FR:	return kVDPixType_8_8_8 | kVDPixSamp_420_MPEG2INT2 | kVDPixSpace_YCC_709_FR;
+	case kPixFormat_XRGB64:					return kVDPixType_16x4_LE | kVDPixSamp_444 | kVDPixSpace_BGR;
+	case kPixFormat_YUV444_Planar16:		return kVDPixType_16_16_16_LE | kVDPixSamp_444 | kVDPixSpace_YCC_601;
+	case kPixFormat_YUV422_Planar16:		return kVDPixType_16_16_16_LE | kVDPixSamp_422 | kVDPixSpace_YCC_601;
+	case kPixFormat_YUV420_Planar16:		return kVDPixType_16_16_16_LE | kVDPixSamp_420_MPEG2 | kVDPixSpace_YCC_601;
+	case kPixFormat_YUV420_P010:			return kVDPixType_16_B16R16_LE | kVDPixSamp_420_MPEG2 | kVDPixSpace_YCC_601;
+	case kPixFormat_YUV420_P016:			return kVDPixType_16_B16R16_LE | kVDPixSamp_420_MPEG2 | kVDPixSpace_YCC_601;
 	default:
 		VDASSERT(false);
 		return 0;
@@ -130,6 +136,10 @@ namespace {
 			case kVDPixType_V210:
 			case kVDPixType_8_B8R8:
 			case kVDPixType_B8R8:
+			case kVDPixType_16_LE:
+			case kVDPixType_16x4_LE:
+			case kVDPixType_16_B16R16_LE:
+			case kVDPixType_B16R16_LE:
 			default:
 				return 0;
 
@@ -137,6 +147,7 @@ namespace {
 				return w;
 
 			case kVDPixType_16F_16F_16F_LE:
+			case kVDPixType_16_16_16_LE:
 				return w*2;
 
 			case kVDPixType_32F_32F_32F_LE:
@@ -163,6 +174,21 @@ namespace {
 			srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_32F_32F_32F_LE;
 		}
 
+		// likewise for 16-bit integer
+		if ((srcToken & kVDPixType_Mask) == kVDPixType_16_16_16_LE) {
+			// 0 1 2
+			gen.conv_16_to_32F();
+			gen.swap(1);
+			// 1 0 2
+			gen.conv_16_to_32F();
+			gen.swap(2);
+			// 2 0 1
+			gen.conv_16_to_32F();
+			gen.swap(2);
+			gen.swap(1);
+			srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_32F_32F_32F_LE;
+		}
+
 		// look up sampling info
 		const VDPixmapSamplingInfo& srcInfo = VDPixmapGetSamplingInfo(srcToken);
 		const VDPixmapSamplingInfo& dstInfo = VDPixmapGetSamplingInfo(dstSamplingToken);
@@ -419,6 +445,10 @@ namespace {
 							gen.conv_X32F_to_8888();
 							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_8888;
 							break;
+						case kVDPixType_16x4_LE:
+							gen.conv_16x4_to_8888();
+							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_8888;
+							break;
 						case kVDPixType_8_8_8:
 							if ((srcToken & kVDPixSamp_Mask) != kVDPixSamp_444)
 								srcToken = BlitterConvertSampling(gen, srcToken, kVDPixSamp_444, w, h);
@@ -449,6 +479,11 @@ namespace {
 							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_8;
 							break;
 
+						case kVDPixType_16_LE:
+							gen.conv_16_to_8();
+							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_8;
+							break;
+
 						default:
 							targetType = kVDPixType_8_8_8;
 							goto type_reconvert;
@@ -494,6 +529,22 @@ namespace {
 							gen.swap(1);
 							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_8_8_8;
 							break;
+						case kVDPixType_16_16_16_LE:
+							// 0 1 2
+							gen.conv_16_to_8();
+							gen.swap(1);
+							// 1 0 2
+							gen.conv_16_to_8();
+							gen.swap(2);
+							// 2 0 1
+							gen.conv_16_to_8();
+							gen.swap(2);
+							gen.swap(1);
+							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_8_8_8;
+							break;
+						case kVDPixType_16_B16R16_LE:
+							targetType = kVDPixType_16_16_16_LE;
+							goto type_reconvert;
 						case kVDPixType_8_B8R8:
 							{
 								const VDPixmapSamplingInfo& sampInfo = VDPixmapGetSamplingInfo(srcToken);
@@ -604,6 +655,24 @@ namespace {
 							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_32F_32F_32F_LE;
 							break;
 
+						case kVDPixType_16_16_16_LE:
+							// 0 1 2
+							gen.conv_16_to_32F();
+							gen.swap(1);
+							// 1 0 2
+							gen.conv_16_to_32F();
+							gen.swap(2);
+							// 2 0 1
+							gen.conv_16_to_32F();
+							gen.swap(2);
+							gen.swap(1);
+							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_32F_32F_32F_LE;
+							break;
+
+						case kVDPixType_16_B16R16_LE:
+							targetType = kVDPixType_16_16_16_LE;
+							goto type_reconvert;
+
 						case kVDPixType_B8G8_R8G8:
 						case kVDPixType_G8B8_G8R8:
 						case kVDPixType_8_B8R8:
@@ -631,6 +700,8 @@ namespace {
 							break;
 
 						case kVDPixType_16F_16F_16F_LE:
+						case kVDPixType_16_16_16_LE:
+						case kVDPixType_16_B16R16_LE:
 							targetType = kVDPixType_32F_32F_32F_LE;
 							goto type_reconvert;
 
@@ -662,6 +733,10 @@ namespace {
 							gen.conv_16F_to_32F();
 							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_32F_LE;
 							break;
+						case kVDPixType_16_LE:
+							gen.conv_16_to_32F();
+							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_32F_LE;
+							break;
 						default:
 							VDASSERT(false);
 					}
@@ -676,8 +751,94 @@ namespace {
 							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_8_B8R8;
 							break;
 						default:
-							VDASSERT(false);
+							targetType = kVDPixType_8_8_8;
+							goto type_reconvert;
+					}
+					break;
+
+				case kVDPixType_16_16_16_LE:
+					switch(srcType) {
+						case kVDPixType_8_8_8:
+							// 0 1 2
+							gen.conv_8_to_16();
+							gen.swap(1);
+							// 1 0 2
+							gen.conv_8_to_16();
+							gen.swap(2);
+							// 2 0 1
+							gen.conv_8_to_16();
+							gen.swap(2);
+							gen.swap(1);
+							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_16_16_16_LE;
+							break;
+
+						case kVDPixType_32F_32F_32F_LE:
+							// 0 1 2
+							gen.conv_32F_to_16();
+							gen.swap(1);
+							// 1 0 2
+							gen.conv_32F_to_16();
+							gen.swap(2);
+							// 2 0 1
+							gen.conv_32F_to_16();
+							gen.swap(2);
+							gen.swap(1);
+							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_16_16_16_LE;
+							break;
+
+						case kVDPixType_16_B16R16_LE:
+							{
+								const VDPixmapSamplingInfo& sampInfo = VDPixmapGetSamplingInfo(srcToken);
+								int cw = -(-w >> sampInfo.mPlane1Cr.mXBits);
+								int ch = -(-h >> sampInfo.mPlane1Cr.mYBits);
+
+								gen.dup();
+								gen.extract_16in32(1, cw, ch);
+								gen.swap(2);
+								gen.swap(1);
+								gen.extract_16in32(0, cw, ch);
+								srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_16_16_16_LE;
+							}
+							break;
+
+						case kVDPixType_16F_16F_16F_LE:
+						case kVDPixType_V210:
+							targetType = kVDPixType_32F_32F_32F_LE;
+							goto type_reconvert;
+
+						default:
+							targetType = kVDPixType_8_8_8;
+							goto type_reconvert;
+					}
+					break;
+
+				case kVDPixType_16_B16R16_LE:
+					switch(srcType) {
+						case kVDPixType_16_16_16_LE:
+							gen.swap(1);
+							gen.swap(2);
+							gen.interleave_B16R16();
+							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_16_B16R16_LE;
 							break;
+						default:
+							targetType = kVDPixType_16_16_16_LE;
+							goto type_reconvert;
+					}
+					break;
+
+				case kVDPixType_16x4_LE:
+					switch(srcType) {
+						case kVDPixType_8888:
+							gen.conv_8888_to_16x4();
+							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_16x4_LE;
+							break;
+						case kVDPixType_32Fx4_LE:
+							gen.conv_X32F_to_16x4();
+							srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_16x4_LE;
+							break;
+						default:
+							targetType = kVDPixType_8888;
+							goto type_reconvert;
 					}
 					break;
 
@@ -748,6 +909,10 @@ IVDPixmapBlitter *VDPixmapCreateBlitter(const VDPixmapLayout& dst, const VDPixma
 		gen.ldsrc(0, 0, 0, 0, w, h, srcToken, w*16);
 		break;
 
+	case kVDPixType_16x4_LE:
+		gen.ldsrc(0, 0, 0, 0, w, h, srcToken, w*8);
+		break;
+
 	case kVDPixType_B8G8_R8G8:
 	case kVDPixType_G8B8_G8R8:
 		gen.ldsrc(0, 0, 0, 0, w, h, srcToken, ((w + 1) & ~1)*2);
@@ -807,6 +972,24 @@ IVDPixmapBlitter *VDPixmapCreateBlitter(const VDPixmapLayout& dst, const VDPixma
 		}
 		break;
 
+	case kVDPixType_16_16_16_LE:
+		{
+			uint32 ytoken = (srcToken & ~kVDPixType_Mask) | kVDPixType_16_LE;
+			uint32 cbtoken = (srcToken & ~kVDPixType_Mask) | kVDPixType_16_LE;
+			uint32 crtoken = (srcToken & ~kVDPixType_Mask) | kVDPixType_16_LE;
+
+			const VDPixmapSamplingInfo& sampInfo = VDPixmapGetSamplingInfo(srcToken);
+
+			int cxbits = sampInfo.mPlane1Cb.mXBits;
+			int cybits = sampInfo.mPlane1Cb.mYBits;
+			int w2 = -(-w >> cxbits);
+			int h2 = -(-h >> cybits);
+			gen.ldsrc(0, 2, 0, 0, w2, h2, cbtoken, w2 * 2);
+			gen.ldsrc(0, 0, 0, 0, w, h, ytoken, w*2);
+			gen.ldsrc(0, 1, 0, 0, w2, h2, crtoken, w2 * 2);
+		}
+		break;
+
 	case kVDPixType_V210:
 		gen.ldsrc(0, 0, 0, 0, w, h, srcToken, ((w + 5) / 6) * 4);
 		break;
@@ -827,6 +1010,22 @@ IVDPixmapBlitter *VDPixmapCreateBlitter(const VDPixmapLayout& dst, const VDPixma
 		}
 		break;
 
+	case kVDPixType_16_B16R16_LE:
+		{
+			uint32 ytoken = (srcToken & ~kVDPixType_Mask) | kVDPixType_16_LE;
+			uint32 ctoken = (srcToken & ~kVDPixType_Mask) | kVDPixType_B16R16_LE;
+
+			const VDPixmapSamplingInfo& sampInfo = VDPixmapGetSamplingInfo(srcToken);
+
+			int cxbits = sampInfo.mPlane1Cb.mXBits;
+			int cybits = sampInfo.mPlane1Cb.mYBits;
+			int w2 = -(-w >> cxbits);
+			int h2 = -(-h >> cybits);
+			gen.ldsrc(0, 0, 0, 0, w, h, ytoken, w*2);
+			gen.ldsrc(0, 1, 0, 0, w2, h2, ctoken, w2*4);
+		}
+		break;
+
 	default:
 		VDASSERT(false);
 	}
@@ -870,6 +1069,28 @@ IVDPixmapBlitter *VDPixmapCreateBlitter(const VDPixmapLayout& dst, const VDPixma
 			gen.conv_V210_to_32F();
 			srcToken = (srcToken & ~kVDPixType_Mask) | kVDPixType_32F_32F_32F_LE;
 			break;
+
+		case kVDPixType_16_16_16_LE:
+		case kVDPixType_16_B16R16_LE:
+			// only keep the extra precision if the destination can hold it
+			switch(dstToken & kVDPixType_Mask) {
+				case kVDPixType_16x4_LE:
+				case kVDPixType_32Fx4_LE:
+				case kVDPixType_32F_LE:
+				case kVDPixType_16_LE:
+				case kVDPixType_16F_16F_16F_LE:
+				case kVDPixType_32F_32F_32F_LE:
+				case kVDPixType_16_16_16_LE:
+				case kVDPixType_16_B16R16_LE:
+				case kVDPixType_V210:
+					srcToken = BlitterConvertType(gen, srcToken, kVDPixType_32F_32F_32F_LE, w, h);
+					break;
+
+				default:
+					srcToken = BlitterConvertType(gen, srcToken, kVDPixType_8_8_8, w, h);
+					break;
+			}
+			break;
 		}
 
 		// if the source is subsampled, converge on 4:4:4 subsampling, but only if we actually need
@@ -1153,6 +1374,15 @@ space_reconvert:
 				case kVDPixSpace_YCC_601:
 					switch(srcSpace) {
 					case kVDPixSpace_BGR:
+						if ((srcToken & kVDPixType_Mask) == kVDPixType_16x4_LE) {
+							// stay in float to keep the extra precision
+							gen.conv_16x4_to_X32F();
+							gen.rgb32f_to_ycbcr_generic(g_VDPixmapGenYCbCrBasis_601, kVDPixSpace_YCC_601_FR);
+							gen.ycbcr_to_ycbcr_generic(g_VDPixmapGenYCbCrBasis_601, true, g_VDPixmapGenYCbCrBasis_601, false, kVDPixSpace_YCC_601);
+							srcToken = (srcToken & ~(kVDPixType_Mask | kVDPixSpace_Mask)) | kVDPixSpace_YCC_601 | kVDPixType_32F_32F_32F_LE;
+							break;
+						}
+
 						srcToken = BlitterConvertType(gen, srcToken, kVDPixType_8888, w, h);
 						gen.rgb32_to_ycbcr601();
 						srcToken = (srcToken & ~(kVDPixType_Mask | kVDPixSpace_Mask)) | kVDPixSpace_YCC_601 | kVDPixType_8_8_8;
@@ -1230,6 +1460,15 @@ space_reconvert:
 				case kVDPixSpace_YCC_709:
 					switch(srcSpace) {
 					case kVDPixSpace_BGR:
+						if ((srcToken & kVDPixType_Mask) == kVDPixType_16x4_LE) {
+							// stay in float to keep the extra precision
+							gen.conv_16x4_to_X32F();
+							gen.rgb32f_to_ycbcr_generic(g_VDPixmapGenYCbCrBasis_709, kVDPixSpace_YCC_709_FR);
+							gen.ycbcr_to_ycbcr_generic(g_VDPixmapGenYCbCrBasis_709, true, g_VDPixmapGenYCbCrBasis_709, false, kVDPixSpace_YCC_709);
+							srcToken = (srcToken & ~(kVDPixType_Mask | kVDPixSpace_Mask)) | kVDPixSpace_YCC_709 | kVDPixType_32F_32F_32F_LE;
+							break;
+						}
+
 						srcToken = BlitterConvertType(gen, srcToken, kVDPixType_8888, w, h);
 						gen.rgb32_to_ycbcr709();
 						srcToken = (srcToken & ~(kVDPixType_Mask | kVDPixSpace_Mask)) | kVDPixSpace_YCC_709 | kVDPixType_8_8_8;
@@ -1313,6 +1552,13 @@ space_reconvert:
 
 						switch(srcSpace) {
 						case kVDPixSpace_BGR:
+							if ((srcToken & kVDPixType_Mask) == kVDPixType_16x4_LE) {
+								gen.conv_16x4_to_X32F();
+								gen.rgb32f_to_ycbcr_generic(dstBasis, targetSpace);
+								srcToken = (srcToken & ~(kVDPixType_Mask | kVDPixSpace_Mask)) | targetSpace | kVDPixType_32F_32F_32F_LE;
+								break;
+							}
+
 							srcToken = BlitterConvertType(gen, srcToken, kVDPixType_8888, w, h);
 							gen.rgb32_to_ycbcr_generic(dstBasis, false, targetSpace);
 							srcToken = (srcToken & ~(kVDPixType_Mask | kVDPixSpace_Mask)) | targetSpace | kVDPixType_8_8_8;
@@ -1390,6 +1636,9 @@ space_reconvert:
 				case kVDPixType_16F_16F_16F_LE:
 					intermediateTypeToken = kVDPixType_32F_32F_32F_LE;
 					break;
+				case kVDPixType_16_B16R16_LE:
+					intermediateTypeToken = kVDPixType_16_16_16_LE;
+					break;
 				case kVDPixType_8_B8R8:
 					intermediateTypeToken = kVDPixType_8_8_8;
 					break;
@@ -1403,6 +1652,7 @@ space_reconvert:
 	switch(srcToken & kVDPixType_Mask) {
 		case kVDPixType_8_8_8:
 		case kVDPixType_16F_16F_16F_LE:
+		case kVDPixType_16_16_16_LE:
 		case kVDPixType_32F_32F_32F_LE:
 			if ((srcToken ^ dstToken) & kVDPixSamp_Mask)
 				srcToken = BlitterConvertSampling(gen, srcToken, dstToken, w, h);
@@ -1412,5 +1662,13 @@ space_reconvert:
 	// check if we need a type change (possible with 16F)
 	srcToken = BlitterConvertType(gen, srcToken, dstToken, w, h);
 
+	// P010 only keeps the top 10 bits of each sample
+	if (dst.format == nsVDPixmap::kPixFormat_YUV420_P010) {
+		gen.round_16_to_10();
+		gen.swap(1);
+		gen.round_16_to_10();
+		gen.swap(1);
+	}
+
 	return gen.create();
 }
@@ -0,0 +1,455 @@
+//	VirtualDub - Video processing and capture application
+//	Graphics support library
+//	Copyright (C) 1998-2009 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+#include <stdafx.h>
+#include "uberblit_16.h"
+
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	#include <emmintrin.h>
+	#define VD_KASUMI_16_SSE2 1
+#endif
+
+namespace {
+	// Rounds and saturates a scaled float to 0-65535. NaNs go to zero.
+	inline uint16 ClampedRoundToUint16(float v) {
+		v += 0.5f;
+
+		if (!(v >= 0.0f))
+			return 0;
+
+		if (v >= 65535.0f)
+			return 0xFFFF;
+
+		return (uint16)(sint32)v;
+	}
+
+#ifdef VD_KASUMI_16_SSE2
+	// Same as above for eight values; the max/min ordering matches the
+	// scalar NaN handling.
+	inline __m128i ClampedRoundToUint16_SSE2(__m128 v0, __m128 v1) {
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 limit = _mm_set1_ps(65535.0f);
+		const __m128i bias32 = _mm_set1_epi32(0x8000);
+		const __m128i bias16 = _mm_set1_epi16(-0x8000);
+
+		v0 = _mm_min_ps(_mm_max_ps(_mm_add_ps(v0, half), zero), limit);
+		v1 = _mm_min_ps(_mm_max_ps(_mm_add_ps(v1, half), zero), limit);
+
+		__m128i i0 = _mm_sub_epi32(_mm_cvttps_epi32(v0), bias32);
+		__m128i i1 = _mm_sub_epi32(_mm_cvttps_epi32(v1), bias32);
+
+		return _mm_xor_si128(_mm_packs_epi32(i0, i1), bias16);
+	}
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_16_To_32F::Start() {
+	StartWindow(mWidth * sizeof(float));
+}
+
+uint32 VDPixmapGen_16_To_32F::GetType(uint32 output) const {
+	return (mpSrc->GetType(mSrcIndex) & ~kVDPixType_Mask) | kVDPixType_32F_LE;
+}
+
+void VDPixmapGen_16_To_32F::Compute(void *dst0, sint32 y) {
+	float *dst = (float *)dst0;
+	const uint16 *src = (const uint16 *)mpSrc->GetRow(y, mSrcIndex);
+	uint32 w = mWidth;
+
+#ifdef VD_KASUMI_16_SSE2
+	if (SSE2_enabled) {
+		const __m128 scale = _mm_set1_ps(1.0f / 65280.0f);
+		const __m128i zero = _mm_setzero_si128();
+
+		for(; w >= 8; w -= 8) {
+			__m128i v = _mm_loadu_si128((const __m128i *)src);
+
+			_mm_storeu_ps(dst,     _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), scale));
+			_mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), scale));
+			src += 8;
+			dst += 8;
+		}
+	}
+#endif
+
+	VDCPUCleanupExtensions();
+
+	for(uint32 i=0; i<w; ++i)
+		dst[i] = (float)src[i] * (1.0f / 65280.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_32F_To_16::Start() {
+	StartWindow(mWidth * sizeof(uint16));
+}
+
+uint32 VDPixmapGen_32F_To_16::GetType(uint32 output) const {
+	return (mpSrc->GetType(mSrcIndex) & ~kVDPixType_Mask) | kVDPixType_16_LE;
+}
+
+void VDPixmapGen_32F_To_16::Compute(void *dst0, sint32 y) {
+	uint16 *dst = (uint16 *)dst0;
+	const float *src = (const float *)mpSrc->GetRow(y, mSrcIndex);
+	uint32 w = mWidth;
+
+#ifdef VD_KASUMI_16_SSE2
+	if (SSE2_enabled) {
+		const __m128 scale = _mm_set1_ps(65280.0f);
+
+		for(; w >= 8; w -= 8) {
+			__m128 v0 = _mm_mul_ps(_mm_loadu_ps(src), scale);
+			__m128 v1 = _mm_mul_ps(_mm_loadu_ps(src + 4), scale);
+
+			_mm_storeu_si128((__m128i *)dst, ClampedRoundToUint16_SSE2(v0, v1));
+			src += 8;
+			dst += 8;
+		}
+	}
+#endif
+
+	VDCPUCleanupExtensions();
+
+	for(uint32 i=0; i<w; ++i)
+		dst[i] = ClampedRoundToUint16(src[i] * 65280.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_8_To_16::Start() {
+	StartWindow(mWidth * sizeof(uint16));
+}
+
+uint32 VDPixmapGen_8_To_16::GetType(uint32 output) const {
+	return (mpSrc->GetType(mSrcIndex) & ~kVDPixType_Mask) | kVDPixType_16_LE;
+}
+
+void VDPixmapGen_8_To_16::Compute(void *dst0, sint32 y) {
+	uint16 *dst = (uint16 *)dst0;
+	const uint8 *src = (const uint8 *)mpSrc->GetRow(y, mSrcIndex);
+	uint32 w = mWidth;
+
+#ifdef VD_KASUMI_16_SSE2
+	if (SSE2_enabled) {
+		const __m128i zero = _mm_setzero_si128();
+
+		for(; w >= 16; w -= 16) {
+			__m128i v = _mm_loadu_si128((const __m128i *)src);
+
+			_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(zero, v));
+			_mm_storeu_si128((__m128i *)(dst + 8), _mm_unpackhi_epi8(zero, v));
+			src += 16;
+			dst += 16;
+		}
+	}
+#endif
+
+	for(uint32 i=0; i<w; ++i)
+		dst[i] = (uint16)(src[i] << 8);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_16_To_8::Start() {
+	StartWindow(mWidth);
+}
+
+uint32 VDPixmapGen_16_To_8::GetType(uint32 output) const {
+	return (mpSrc->GetType(mSrcIndex) & ~kVDPixType_Mask) | kVDPixType_8;
+}
+
+void VDPixmapGen_16_To_8::Compute(void *dst0, sint32 y) {
+	uint8 *dst = (uint8 *)dst0;
+	const uint16 *src = (const uint16 *)mpSrc->GetRow(y, mSrcIndex);
+	uint32 w = mWidth;
+
+#ifdef VD_KASUMI_16_SSE2
+	if (SSE2_enabled) {
+		const __m128i round = _mm_set1_epi16(0x80);
+
+		for(; w >= 16; w -= 16) {
+			__m128i v0 = _mm_srli_epi16(_mm_adds_epu16(_mm_loadu_si128((const __m128i *)src), round), 8);
+			__m128i v1 = _mm_srli_epi16(_mm_adds_epu16(_mm_loadu_si128((const __m128i *)(src + 8)), round), 8);
+
+			_mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(v0, v1));
+			src += 16;
+			dst += 16;
+		}
+	}
+#endif
+
+	for(uint32 i=0; i<w; ++i) {
+		uint32 v = ((uint32)src[i] + 0x80) >> 8;
+
+		dst[i] = v > 255 ? 255 : (uint8)v;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_16_To_10::Start() {
+	mCount = mWidth;
+	if ((mpSrc->GetType(mSrcIndex) & kVDPixType_Mask) == kVDPixType_B16R16_LE)
+		mCount += mWidth;
+
+	StartWindow(mCount * sizeof(uint16));
+}
+
+uint32 VDPixmapGen_16_To_10::GetType(uint32 output) const {
+	return mpSrc->GetType(mSrcIndex);
+}
+
+void VDPixmapGen_16_To_10::Compute(void *dst0, sint32 y) {
+	uint16 *dst = (uint16 *)dst0;
+	const uint16 *src = (const uint16 *)mpSrc->GetRow(y, mSrcIndex);
+	uint32 n = mCount;
+
+#ifdef VD_KASUMI_16_SSE2
+	if (SSE2_enabled) {
+		const __m128i round = _mm_set1_epi16(0x20);
+		const __m128i mask = _mm_set1_epi16((short)0xFFC0);
+
+		for(; n >= 8; n -= 8) {
+			__m128i v = _mm_adds_epu16(_mm_loadu_si128((const __m128i *)src), round);
+
+			_mm_storeu_si128((__m128i *)dst, _mm_and_si128(v, mask));
+			src += 8;
+			dst += 8;
+		}
+	}
+#endif
+
+	for(uint32 i=0; i<n; ++i) {
+		uint32 v = (uint32)src[i] + 0x20;
+
+		dst[i] = v > 0xFFFF ? 0xFFC0 : (uint16)(v & 0xFFC0);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_X16R16G16B16_To_X32B32G32R32F::Start() {
+	StartWindow(mWidth * 16);
+}
+
+uint32 VDPixmapGen_X16R16G16B16_To_X32B32G32R32F::GetType(uint32 output) const {
+	return (mpSrc->GetType(mSrcIndex) & ~kVDPixType_Mask) | kVDPixType_32Fx4_LE;
+}
+
+void VDPixmapGen_X16R16G16B16_To_X32B32G32R32F::Compute(void *dst0, sint32 y) {
+	float *dst = (float *)dst0;
+	const uint16 *src = (const uint16 *)mpSrc->GetRow(y, mSrcIndex);
+	uint32 w = mWidth;
+
+#ifdef VD_KASUMI_16_SSE2
+	if (SSE2_enabled) {
+		const __m128 scale = _mm_set_ps(0.0f, 1.0f / 65535.0f, 1.0f / 65535.0f, 1.0f / 65535.0f);
+		const __m128 one = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+		const __m128i zero = _mm_setzero_si128();
+
+		for(; w >= 2; w -= 2) {
+			__m128i v = _mm_loadu_si128((const __m128i *)src);
+			__m128 p0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero));
+			__m128 p1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero));
+
+			p0 = _mm_shuffle_ps(p0, p0, _MM_SHUFFLE(3, 0, 1, 2));
+			p1 = _mm_shuffle_ps(p1, p1, _MM_SHUFFLE(3, 0, 1, 2));
+
+			_mm_storeu_ps(dst,     _mm_add_ps(_mm_mul_ps(p0, scale), one));
+			_mm_storeu_ps(dst + 4, _mm_add_ps(_mm_mul_ps(p1, scale), one));
+			src += 8;
+			dst += 8;
+		}
+	}
+#endif
+
+	VDCPUCleanupExtensions();
+
+	for(uint32 i=0; i<w; ++i) {
+		dst[0] = (float)src[2] * (1.0f / 65535.0f);
+		dst[1] = (float)src[1] * (1.0f / 65535.0f);
+		dst[2] = (float)src[0] * (1.0f / 65535.0f);
+		dst[3] = 1.0f;
+		dst += 4;
+		src += 4;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_X32B32G32R32F_To_X16R16G16B16::Start() {
+	StartWindow(mWidth * 8);
+}
+
+uint32 VDPixmapGen_X32B32G32R32F_To_X16R16G16B16::GetType(uint32 output) const {
+	return (mpSrc->GetType(mSrcIndex) & ~kVDPixType_Mask) | kVDPixType_16x4_LE;
+}
+
+void VDPixmapGen_X32B32G32R32F_To_X16R16G16B16::Compute(void *dst0, sint32 y) {
+	uint16 *dst = (uint16 *)dst0;
+	const float *src = (const float *)mpSrc->GetRow(y, mSrcIndex);
+	uint32 w = mWidth;
+
+#ifdef VD_KASUMI_16_SSE2
+	if (SSE2_enabled) {
+		const __m128 scale = _mm_set_ps(0.0f, 65535.0f, 65535.0f, 65535.0f);
+
+		for(; w >= 2; w -= 2) {
+			__m128 p0 = _mm_mul_ps(_mm_loadu_ps(src), scale);
+			__m128 p1 = _mm_mul_ps(_mm_loadu_ps(src + 4), scale);
+
+			p0 = _mm_shuffle_ps(p0, p0, _MM_SHUFFLE(3, 0, 1, 2));
+			p1 = _mm_shuffle_ps(p1, p1, _MM_SHUFFLE(3, 0, 1, 2));
+
+			_mm_storeu_si128((__m128i *)dst, ClampedRoundToUint16_SSE2(p0, p1));
+			src += 8;
+			dst += 8;
+		}
+	}
+#endif
+
+	VDCPUCleanupExtensions();
+
+	for(uint32 i=0; i<w; ++i) {
+		dst[0] = ClampedRoundToUint16(src[2] * 65535.0f);
+		dst[1] = ClampedRoundToUint16(src[1] * 65535.0f);
+		dst[2] = ClampedRoundToUint16(src[0] * 65535.0f);
+		dst[3] = 0;
+		dst += 4;
+		src += 4;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_X8R8G8B8_To_X16R16G16B16::Start() {
+	StartWindow(mWidth * 8);
+}
+
+uint32 VDPixmapGen_X8R8G8B8_To_X16R16G16B16::GetType(uint32 output) const {
+	return (mpSrc->GetType(mSrcIndex) & ~kVDPixType_Mask) | kVDPixType_16x4_LE;
+}
+
+void VDPixmapGen_X8R8G8B8_To_X16R16G16B16::Compute(void *dst0, sint32 y) {
+	uint16 *dst = (uint16 *)dst0;
+	const uint8 *src = (const uint8 *)mpSrc->GetRow(y, mSrcIndex);
+	uint32 n = mWidth * 4;
+
+#ifdef VD_KASUMI_16_SSE2
+	if (SSE2_enabled) {
+		for(; n >= 16; n -= 16) {
+			__m128i v = _mm_loadu_si128((const __m128i *)src);
+
+			// interleaving a byte with itself is a multiply by 257
+			_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi8(v, v));
+			_mm_storeu_si128((__m128i *)(dst + 8), _mm_unpackhi_epi8(v, v));
+			src += 16;
+			dst += 16;
+		}
+	}
+#endif
+
+	for(uint32 i=0; i<n; ++i)
+		dst[i] = (uint16)(src[i] * 257);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_X16R16G16B16_To_X8R8G8B8::Start() {
+	StartWindow(mWidth * 4);
+}
+
+uint32 VDPixmapGen_X16R16G16B16_To_X8R8G8B8::GetType(uint32 output) const {
+	return (mpSrc->GetType(mSrcIndex) & ~kVDPixType_Mask) | kVDPixType_8888;
+}
+
+void VDPixmapGen_X16R16G16B16_To_X8R8G8B8::Compute(void *dst0, sint32 y) {
+	uint8 *dst = (uint8 *)dst0;
+	const uint16 *src = (const uint16 *)mpSrc->GetRow(y, mSrcIndex);
+	uint32 n = mWidth * 4;
+
+	// round(v / 257) == (t - (t >> 8)) >> 8 with t = min(v + 128, 65535)
+
+#ifdef VD_KASUMI_16_SSE2
+	if (SSE2_enabled) {
+		const __m128i round = _mm_set1_epi16(0x80);
+
+		for(; n >= 16; n -= 16) {
+			__m128i t0 = _mm_adds_epu16(_mm_loadu_si128((const __m128i *)src), round);
+			__m128i t1 = _mm_adds_epu16(_mm_loadu_si128((const __m128i *)(src + 8)), round);
+
+			t0 = _mm_srli_epi16(_mm_sub_epi16(t0, _mm_srli_epi16(t0, 8)), 8);
+			t1 = _mm_srli_epi16(_mm_sub_epi16(t1, _mm_srli_epi16(t1, 8)), 8);
+
+			_mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(t0, t1));
+			src += 16;
+			dst += 16;
+		}
+	}
+#endif
+
+	for(uint32 i=0; i<n; ++i) {
+		uint32 t = (uint32)src[i] + 0x80;
+
+		if (t > 0xFFFF)
+			t = 0xFFFF;
+
+		dst[i] = (uint8)((t - (t >> 8)) >> 8);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_B16x2_To_B16R16::Init(IVDPixmapGen *srcCb, uint32 srcindexCb, IVDPixmapGen *srcCr, uint32 srcindexCr) {
+	mpSrcCb = srcCb;
+	mSrcIndexCb = srcindexCb;
+	mpSrcCr = srcCr;
+	mSrcIndexCr = srcindexCr;
+	mWidth = srcCb->GetWidth(srcindexCb);
+	mHeight = srcCb->GetHeight(srcindexCb);
+
+	srcCb->AddWindowRequest(0, 0);
+	srcCr->AddWindowRequest(0, 0);
+}
+
+void VDPixmapGen_B16x2_To_B16R16::Start() {
+	mpSrcCb->Start();
+	mpSrcCr->Start();
+
+	StartWindow(mWidth * 4);
+}
+
+uint32 VDPixmapGen_B16x2_To_B16R16::GetType(uint32 output) const {
+	return (mpSrcCb->GetType(mSrcIndexCb) & ~kVDPixType_Mask) | kVDPixType_B16R16_LE;
+}
+
+void VDPixmapGen_B16x2_To_B16R16::Compute(void *dst0, sint32 y) {
+	uint16 *VDRESTRICT dst = (uint16 *)dst0;
+	const uint16 *VDRESTRICT srcCb = (const uint16 *)mpSrcCb->GetRow(y, mSrcIndexCb);
+	const uint16 *VDRESTRICT srcCr = (const uint16 *)mpSrcCr->GetRow(y, mSrcIndexCr);
+
+	sint32 w = mWidth;
+	for(sint32 x=0; x<w; ++x) {
+		dst[0] = srcCb[x];
+		dst[1] = srcCr[x];
+		dst += 2;
+	}
+}
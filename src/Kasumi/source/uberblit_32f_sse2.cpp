@@ -0,0 +1,395 @@
+//	VirtualDub - Video processing and capture application
+//	Graphics support library
+//	Copyright (C) 1998-2009 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+#include <stdafx.h>
+#include <emmintrin.h>
+#include <vd2/system/cpuaccel.h>
+#include <vd2/system/math.h>
+#include "uberblit_32f_sse2.h"
+
+namespace {
+	// Scales by 255 and rounds to nearest-even with saturation, the same as
+	// VDClampedRoundFixedToUint8Fast(). The max/min ordering sends NaNs to
+	// 255, also as the scalar routine does.
+	inline __m128i ScaleRoundToInt8_SSE2(__m128 v) {
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 k255 = _mm_set1_ps(255.0f);
+
+		return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(zero, _mm_mul_ps(v, k255)), k255));
+	}
+
+	void YCbCrToRGB32F_SSE2(float *dst, const float *srcY, const float *srcCb, const float *srcCr, sint32 w, float coRCr, float coGCr, float coGCb, float coBCb) {
+		const __m128 k16 = _mm_set1_ps(16.0f / 255.0f);
+		const __m128 k128 = _mm_set1_ps(128.0f / 255.0f);
+		const __m128 kY = _mm_set1_ps(1.164f);
+		const __m128 kRCr = _mm_set1_ps(coRCr);
+		const __m128 kGCr = _mm_set1_ps(coGCr);
+		const __m128 kGCb = _mm_set1_ps(coGCb);
+		const __m128 kBCb = _mm_set1_ps(coBCb);
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		sint32 i = 0;
+		for(; i + 4 <= w; i += 4) {
+			__m128 y  = _mm_loadu_ps(srcY + i);
+			__m128 cb = _mm_sub_ps(_mm_loadu_ps(srcCb + i), k128);
+			__m128 cr = _mm_sub_ps(_mm_loadu_ps(srcCr + i), k128);
+
+			__m128 yf = _mm_mul_ps(kY, _mm_sub_ps(y, k16));
+
+			__m128 r = _mm_add_ps(yf, _mm_mul_ps(kRCr, cr));
+			__m128 g = _mm_sub_ps(_mm_sub_ps(yf, _mm_mul_ps(kGCr, cr)), _mm_mul_ps(kGCb, cb));
+			__m128 b = _mm_add_ps(yf, _mm_mul_ps(kBCb, cb));
+			__m128 a = one;
+
+			_MM_TRANSPOSE4_PS(r, g, b, a);
+
+			_mm_storeu_ps(dst +  0, r);
+			_mm_storeu_ps(dst +  4, g);
+			_mm_storeu_ps(dst +  8, b);
+			_mm_storeu_ps(dst + 12, a);
+			dst += 16;
+		}
+
+		for(; i < w; ++i) {
+			float y = srcY[i];
+			float cb = srcCb[i] - (128.0f / 255.0f);
+			float cr = srcCr[i] - (128.0f / 255.0f);
+
+			float yf = 1.164f * (y - 16.0f / 255.0f);
+
+			dst[0] = yf + coRCr * cr;
+			dst[1] = yf - coGCr * cr - coGCb * cb;
+			dst[2] = yf + coBCb * cb;
+			dst[3] = 1.0f;
+			dst += 4;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_8_To_32F_SSE2::Compute(void *dst0, sint32 y) {
+	float *dst = (float *)dst0;
+	const uint8 *src = (const uint8 *)mpSrc->GetRow(y, mSrcIndex);
+
+	VDCPUCleanupExtensions();
+
+	sint32 w = mWidth;
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+	for(; w >= 16; w -= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)src);
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+
+		_mm_storeu_ps(dst +  0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+		_mm_storeu_ps(dst +  4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+		_mm_storeu_ps(dst +  8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+		_mm_storeu_ps(dst + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+		src += 16;
+		dst += 16;
+	}
+
+	for(; w > 0; --w)
+		*dst++ = (float)*src++ * (1.0f / 255.0f);
+}
+
+void VDPixmapGen_32F_To_8_SSE2::Compute(void *dst0, sint32 y) {
+	uint8 *dst = (uint8 *)dst0;
+	const float *src = (const float *)mpSrc->GetRow(y, mSrcIndex);
+
+	VDCPUCleanupExtensions();
+
+	sint32 w = mWidth;
+
+	for(; w >= 16; w -= 16) {
+		__m128i i0 = ScaleRoundToInt8_SSE2(_mm_loadu_ps(src +  0));
+		__m128i i1 = ScaleRoundToInt8_SSE2(_mm_loadu_ps(src +  4));
+		__m128i i2 = ScaleRoundToInt8_SSE2(_mm_loadu_ps(src +  8));
+		__m128i i3 = ScaleRoundToInt8_SSE2(_mm_loadu_ps(src + 12));
+
+		_mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(_mm_packs_epi32(i0, i1), _mm_packs_epi32(i2, i3)));
+		src += 16;
+		dst += 16;
+	}
+
+	for(; w > 0; --w)
+		*dst++ = VDClampedRoundFixedToUint8Fast(*src++);
+}
+
+void VDPixmapGen_X8R8G8B8_To_X32B32G32R32F_SSE2::Compute(void *dst0, sint32 y) {
+	float *dst = (float *)dst0;
+	const uint8 *src = (const uint8 *)mpSrc->GetRow(y, mSrcIndex);
+
+	VDCPUCleanupExtensions();
+
+	sint32 w = mWidth;
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set_ps(0.0f, 1.0f / 255.0f, 1.0f / 255.0f, 1.0f / 255.0f);
+	const __m128 alpha = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+
+	for(; w >= 4; w -= 4) {
+		__m128i v = _mm_loadu_si128((const __m128i *)src);
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+
+		// B G R X -> R G B X
+		__m128i p0 = _mm_shuffle_epi32(_mm_unpacklo_epi16(lo, zero), _MM_SHUFFLE(3, 0, 1, 2));
+		__m128i p1 = _mm_shuffle_epi32(_mm_unpackhi_epi16(lo, zero), _MM_SHUFFLE(3, 0, 1, 2));
+		__m128i p2 = _mm_shuffle_epi32(_mm_unpacklo_epi16(hi, zero), _MM_SHUFFLE(3, 0, 1, 2));
+		__m128i p3 = _mm_shuffle_epi32(_mm_unpackhi_epi16(hi, zero), _MM_SHUFFLE(3, 0, 1, 2));
+
+		_mm_storeu_ps(dst +  0, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(p0), scale), alpha));
+		_mm_storeu_ps(dst +  4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(p1), scale), alpha));
+		_mm_storeu_ps(dst +  8, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(p2), scale), alpha));
+		_mm_storeu_ps(dst + 12, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(p3), scale), alpha));
+		src += 16;
+		dst += 16;
+	}
+
+	for(; w > 0; --w) {
+		dst[0] = (float)src[2] * (1.0f / 255.0f);
+		dst[1] = (float)src[1] * (1.0f / 255.0f);
+		dst[2] = (float)src[0] * (1.0f / 255.0f);
+		dst[3] = 1.0f;
+		dst += 4;
+		src += 4;
+	}
+}
+
+void VDPixmapGen_X32B32G32R32F_To_X8R8G8B8_SSE2::Compute(void *dst0, sint32 y) {
+	uint32 *dst = (uint32 *)dst0;
+	const float *src = (const float *)mpSrc->GetRow(y, mSrcIndex);
+
+	VDCPUCleanupExtensions();
+
+	sint32 w = mWidth;
+
+	const __m128i rgbmask = _mm_set1_epi32(0x00FFFFFF);
+
+	for(; w >= 4; w -= 4) {
+		// R G B A -> B G R A
+		__m128i p0 = _mm_shuffle_epi32(ScaleRoundToInt8_SSE2(_mm_loadu_ps(src +  0)), _MM_SHUFFLE(3, 0, 1, 2));
+		__m128i p1 = _mm_shuffle_epi32(ScaleRoundToInt8_SSE2(_mm_loadu_ps(src +  4)), _MM_SHUFFLE(3, 0, 1, 2));
+		__m128i p2 = _mm_shuffle_epi32(ScaleRoundToInt8_SSE2(_mm_loadu_ps(src +  8)), _MM_SHUFFLE(3, 0, 1, 2));
+		__m128i p3 = _mm_shuffle_epi32(ScaleRoundToInt8_SSE2(_mm_loadu_ps(src + 12)), _MM_SHUFFLE(3, 0, 1, 2));
+
+		__m128i v = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+
+		_mm_storeu_si128((__m128i *)dst, _mm_and_si128(v, rgbmask));
+		src += 16;
+		dst += 4;
+	}
+
+	for(; w > 0; --w) {
+		uint32 ir = VDClampedRoundFixedToUint8Fast(src[0]) << 16;
+		uint32 ig = VDClampedRoundFixedToUint8Fast(src[1]) << 8;
+		uint32 ib = VDClampedRoundFixedToUint8Fast(src[2]);
+		src += 4;
+
+		*dst++ = ir + ig + ib;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGenYCbCr601ToRGB32F_SSE2::Compute(void *dst0, sint32 y) {
+	const float *srcY = (const float *)mpSrcY->GetRow(y, mSrcIndexY);
+	const float *srcCb = (const float *)mpSrcCb->GetRow(y, mSrcIndexCb);
+	const float *srcCr = (const float *)mpSrcCr->GetRow(y, mSrcIndexCr);
+
+	VDCPUCleanupExtensions();
+
+	YCbCrToRGB32F_SSE2((float *)dst0, srcY, srcCb, srcCr, mWidth, 1.596f, 0.813f, 0.391f, 2.018f);
+}
+
+void VDPixmapGenYCbCr709ToRGB32F_SSE2::Compute(void *dst0, sint32 y) {
+	const float *srcY = (const float *)mpSrcY->GetRow(y, mSrcIndexY);
+	const float *srcCb = (const float *)mpSrcCb->GetRow(y, mSrcIndexCb);
+	const float *srcCr = (const float *)mpSrcCr->GetRow(y, mSrcIndexCr);
+
+	VDCPUCleanupExtensions();
+
+	YCbCrToRGB32F_SSE2((float *)dst0, srcY, srcCb, srcCr, mWidth, 1.793f, 0.533f, 0.213f, 2.112f);
+}
+
+void VDPixmapGenRGB32FToYCbCrGeneric_SSE2::Compute(void *dst0, sint32 y) {
+	float *dstCr = (float *)dst0;
+	float *dstY  = vdptroffset(dstCr, mWindowPitch);
+	float *dstCb = vdptroffset(dstY, mWindowPitch);
+
+	const float *srcRGB = (const float *)mpSrc->GetRow(y, mSrcIndex);
+
+	VDCPUCleanupExtensions();
+
+	const __m128 coYR = _mm_set1_ps(mCoYR);
+	const __m128 coYG = _mm_set1_ps(mCoYG);
+	const __m128 coYB = _mm_set1_ps(mCoYB);
+	const __m128 coCb = _mm_set1_ps(mCoCb);
+	const __m128 coCr = _mm_set1_ps(mCoCr);
+	const __m128 k128 = _mm_set1_ps(128.0f / 255.0f);
+
+	sint32 w = mWidth;
+	for(; w >= 4; w -= 4) {
+		__m128 r = _mm_loadu_ps(srcRGB +  0);
+		__m128 g = _mm_loadu_ps(srcRGB +  4);
+		__m128 b = _mm_loadu_ps(srcRGB +  8);
+		__m128 a = _mm_loadu_ps(srcRGB + 12);
+		srcRGB += 16;
+
+		_MM_TRANSPOSE4_PS(r, g, b, a);
+
+		__m128 yv = _mm_add_ps(_mm_add_ps(_mm_mul_ps(coYR, r), _mm_mul_ps(coYG, g)), _mm_mul_ps(coYB, b));
+
+		_mm_storeu_ps(dstY, yv);
+		_mm_storeu_ps(dstCb, _mm_add_ps(_mm_mul_ps(coCb, _mm_sub_ps(b, yv)), k128));
+		_mm_storeu_ps(dstCr, _mm_add_ps(_mm_mul_ps(coCr, _mm_sub_ps(r, yv)), k128));
+		dstY += 4;
+		dstCb += 4;
+		dstCr += 4;
+	}
+
+	for(; w > 0; --w) {
+		float r = srcRGB[0];
+		float g = srcRGB[1];
+		float b = srcRGB[2];
+		srcRGB += 4;
+
+		float yf = mCoYR * r + mCoYG * g + mCoYB * b;
+
+		*dstY++  = yf;
+		*dstCb++ = mCoCb * (b - yf) + (128.0f / 255.0f);
+		*dstCr++ = mCoCr * (r - yf) + (128.0f / 255.0f);
+	}
+}
+
+void VDPixmapGenYCbCrToYCbCrGeneric_32F_SSE2::Compute(void *dst0, sint32 ypos) {
+	float *dstCr = (float *)dst0;
+	float *dstY  = vdptroffset(dstCr, mWindowPitch);
+	float *dstCb = vdptroffset(dstY, mWindowPitch);
+
+	const float *srcY  = (const float *)mpSrcY ->GetRow(ypos, mSrcIndexY );
+	const float *srcCb = (const float *)mpSrcCb->GetRow(ypos, mSrcIndexCb);
+	const float *srcCr = (const float *)mpSrcCr->GetRow(ypos, mSrcIndexCr);
+
+	VDCPUCleanupExtensions();
+
+	const __m128 coYY   = _mm_set1_ps(mCoYY);
+	const __m128 coYCb  = _mm_set1_ps(mCoYCb);
+	const __m128 coYCr  = _mm_set1_ps(mCoYCr);
+	const __m128 coYA   = _mm_set1_ps(mCoYA);
+	const __m128 coCbCb = _mm_set1_ps(mCoCbCb);
+	const __m128 coCbCr = _mm_set1_ps(mCoCbCr);
+	const __m128 coCbA  = _mm_set1_ps(mCoCbA);
+	const __m128 coCrCb = _mm_set1_ps(mCoCrCb);
+	const __m128 coCrCr = _mm_set1_ps(mCoCrCr);
+	const __m128 coCrA  = _mm_set1_ps(mCoCrA);
+
+	const sint32 w = mWidth;
+	sint32 i = 0;
+	for(; i + 4 <= w; i += 4) {
+		__m128 y  = _mm_loadu_ps(srcY  + i);
+		__m128 cb = _mm_loadu_ps(srcCb + i);
+		__m128 cr = _mm_loadu_ps(srcCr + i);
+
+		_mm_storeu_ps(dstY  + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(y, coYY), _mm_mul_ps(cb, coYCb)), _mm_mul_ps(cr, coYCr)), coYA));
+		_mm_storeu_ps(dstCb + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(cb, coCbCb), _mm_mul_ps(cr, coCbCr)), coCbA));
+		_mm_storeu_ps(dstCr + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(cb, coCrCb), _mm_mul_ps(cr, coCrCr)), coCrA));
+	}
+
+	for(; i < w; ++i) {
+		float y  = srcY [i];
+		float cb = srcCb[i];
+		float cr = srcCr[i];
+
+		dstY [i] = y*mCoYY + cb*mCoYCb  + cr*mCoYCr  + mCoYA;
+		dstCb[i] =           cb*mCoCbCb + cr*mCoCbCr + mCoCbA;
+		dstCr[i] =           cb*mCoCrCb + cr*mCoCrCr + mCoCrA;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void VDPixmapGen_V210_To_32F_SSE2::Compute(void *dst0, sint32 y) {
+	float *dstR = (float *)dst0;
+	float *dstG = (float *)((char *)dstR + mWindowPitch);
+	float *dstB = (float *)((char *)dstG + mWindowPitch);
+	const uint32 *src = (const uint32 *)mpSrc->GetRow(y, mSrcIndex);
+
+	VDCPUCleanupExtensions();
+
+	uint32 w = (mWidth + 5) / 6;
+
+	const __m128i mask = _mm_set1_epi32(0x3ff);
+	const __m128 k1023 = _mm_set1_ps(1023.0f);
+
+	// dword 0: XX Cr0 Y0 Cb0
+	// dword 1: XX Y2 Cb1 Y1
+	// dword 2: XX Cb2 Y3 Cr1
+	// dword 3: XX Y5 Cr2 Y4
+	//
+	// Each group decodes as three vectors of one field from all four
+	// dwords, which are then scattered to the planes.
+
+	for(uint32 i=0; i<w; ++i) {
+		__m128i v = _mm_loadu_si128((const __m128i *)src);
+		src += 4;
+
+		__m128 f0 = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(v, mask)), k1023);
+		__m128 f1 = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 10), mask)), k1023);
+		__m128 f2 = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 20), mask)), k1023);
+
+		// f0: Cb0 Y1 Cr1 Y4
+		// f1: Y0 Cb1 Y3 Cr2
+		// f2: Cr0 Y2 Cb2 Y5
+		__m128 yA = _mm_shuffle_ps(f1, f0, _MM_SHUFFLE(3, 1, 2, 0));	// Y0 Y3 Y1 Y4
+		__m128 yB = _mm_shuffle_ps(f2, f2, _MM_SHUFFLE(3, 3, 3, 1));	// Y2 Y5 ...
+
+		__m128 y012 = _mm_shuffle_ps(yA, yB, _MM_SHUFFLE(0, 0, 2, 0));	// Y0 Y1 Y2 -
+		__m128 y345 = _mm_shuffle_ps(yA, yB, _MM_SHUFFLE(1, 1, 3, 1));	// Y3 Y4 Y5 -
+
+		__m128 cb = _mm_shuffle_ps(_mm_unpacklo_ps(f0, f1), f2, _MM_SHUFFLE(2, 2, 3, 0));	// Cb0 Cb1 Cb2 -
+		__m128 cr = _mm_shuffle_ps(_mm_unpackhi_ps(f0, f1), f2, _MM_SHUFFLE(0, 0, 3, 0));	// Cr1 Cr2 Cr0 -
+
+		float tmp[16];
+		_mm_storeu_ps(tmp +  0, y012);
+		_mm_storeu_ps(tmp +  4, y345);
+		_mm_storeu_ps(tmp +  8, cb);
+		_mm_storeu_ps(tmp + 12, cr);
+
+		dstG[0] = tmp[0];
+		dstG[1] = tmp[1];
+		dstG[2] = tmp[2];
+		dstG[3] = tmp[4];
+		dstG[4] = tmp[5];
+		dstG[5] = tmp[6];
+		dstB[0] = tmp[8];
+		dstB[1] = tmp[9];
+		dstB[2] = tmp[10];
+		dstR[0] = tmp[14];
+		dstR[1] = tmp[12];
+		dstR[2] = tmp[13];
+
+		dstR += 3;
+		dstG += 6;
+		dstB += 3;
+	}
+}
@@ -31,6 +31,7 @@
 #include "uberblit_swizzle.h"
 #include "uberblit_pal.h"
 #include "uberblit_16f.h"
+#include "uberblit_16.h"
 #include "uberblit_v210.h"
 #include "uberblit_interlace.h"
 
@@ -41,6 +42,10 @@
 	#include "uberblit_resample_special_x86.h"
 #endif
 
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	#include "uberblit_32f_sse2.h"
+#endif
+
 void VDPixmapGenerate(void *dst, ptrdiff_t pitch, sint32 bpr, sint32 height, IVDPixmapGen *gen, int genIndex) {
 	for(sint32 y=0; y<height; ++y) {
 		memcpy(dst, gen->GetRow(y, genIndex), bpr);
@@ -657,6 +662,17 @@ void VDPixmapUberBlitterGenerator::swap_8in16(uint32 w, uint32 h, uint32 bpr) {
 	args[0] = StackEntry(src, 0);
 }
 
+void VDPixmapUberBlitterGenerator::extract_16in32(int offset, uint32 w, uint32 h) {
+	StackEntry *args = &mStack.back();
+	VDPixmapGen_16In32 *src = new VDPixmapGen_16In32;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex, offset, w, h);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	args[0] = StackEntry(src, 0);
+}
+
 void VDPixmapUberBlitterGenerator::conv_Pal1_to_8888(int srcIndex) {
 	StackEntry *args = &mStack.back();
 	VDPixmapGen_Pal1_To_X8R8G8B8 *src = new VDPixmapGen_Pal1_To_X8R8G8B8;
@@ -1015,7 +1031,11 @@ void VDPixmapUberBlitterGenerator::conv_888_to_8888() {
 
 void VDPixmapUberBlitterGenerator::conv_8_to_32F() {
 	StackEntry *args = &mStack.back();
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	VDPixmapGen_8_To_32F *src = SSE2_enabled ? new VDPixmapGen_8_To_32F_SSE2 : new VDPixmapGen_8_To_32F;
+#else
 	VDPixmapGen_8_To_32F *src = new VDPixmapGen_8_To_32F;
+#endif
 
 	src->Init(args[0].mpSrc, args[0].mSrcIndex);
 
@@ -1037,7 +1057,11 @@ void VDPixmapUberBlitterGenerator::conv_16F_to_32F() {
 
 void VDPixmapUberBlitterGenerator::conv_V210_to_32F() {
 	StackEntry *args = &mStack.back();
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	VDPixmapGen_V210_To_32F *src = SSE2_enabled ? new VDPixmapGen_V210_To_32F_SSE2 : new VDPixmapGen_V210_To_32F;
+#else
 	VDPixmapGen_V210_To_32F *src = new VDPixmapGen_V210_To_32F;
+#endif
 
 	src->Init(args[0].mpSrc, args[0].mSrcIndex);
 
@@ -1048,9 +1072,57 @@ void VDPixmapUberBlitterGenerator::conv_V210_to_32F() {
 	mStack.push_back(StackEntry(src, 2));
 }
 
+void VDPixmapUberBlitterGenerator::conv_8_to_16() {
+	StackEntry *args = &mStack.back();
+	VDPixmapGen_8_To_16 *src = new VDPixmapGen_8_To_16;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	args[0] = StackEntry(src, 0);
+}
+
+void VDPixmapUberBlitterGenerator::conv_16_to_32F() {
+	StackEntry *args = &mStack.back();
+	VDPixmapGen_16_To_32F *src = new VDPixmapGen_16_To_32F;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	args[0] = StackEntry(src, 0);
+}
+
+void VDPixmapUberBlitterGenerator::conv_8888_to_16x4() {
+	StackEntry *args = &mStack.back();
+	VDPixmapGen_X8R8G8B8_To_X16R16G16B16 *src = new VDPixmapGen_X8R8G8B8_To_X16R16G16B16;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	args[0] = StackEntry(src, 0);
+}
+
+void VDPixmapUberBlitterGenerator::conv_16x4_to_X32F() {
+	StackEntry *args = &mStack.back();
+	VDPixmapGen_X16R16G16B16_To_X32B32G32R32F *src = new VDPixmapGen_X16R16G16B16_To_X32B32G32R32F;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	args[0] = StackEntry(src, 0);
+}
+
 void VDPixmapUberBlitterGenerator::conv_8888_to_X32F() {
 	StackEntry *args = &mStack.back();
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	VDPixmapGen_X8R8G8B8_To_X32B32G32R32F *src = SSE2_enabled ? new VDPixmapGen_X8R8G8B8_To_X32B32G32R32F_SSE2 : new VDPixmapGen_X8R8G8B8_To_X32B32G32R32F;
+#else
 	VDPixmapGen_X8R8G8B8_To_X32B32G32R32F *src = new VDPixmapGen_X8R8G8B8_To_X32B32G32R32F;
+#endif
 
 	src->Init(args[0].mpSrc, args[0].mSrcIndex);
 
@@ -1136,7 +1208,11 @@ void VDPixmapUberBlitterGenerator::conv_8888_to_888() {
 
 void VDPixmapUberBlitterGenerator::conv_32F_to_8() {
 	StackEntry *args = &mStack.back();
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	VDPixmapGen_32F_To_8 *src = SSE2_enabled ? new VDPixmapGen_32F_To_8_SSE2 : new VDPixmapGen_32F_To_8;
+#else
 	VDPixmapGen_32F_To_8 *src = new VDPixmapGen_32F_To_8;
+#endif
 
 	src->Init(args[0].mpSrc, args[0].mSrcIndex);
 
@@ -1147,7 +1223,11 @@ void VDPixmapUberBlitterGenerator::conv_32F_to_8() {
 
 void VDPixmapUberBlitterGenerator::conv_X32F_to_8888() {
 	StackEntry *args = &mStack.back();
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	VDPixmapGen_X32B32G32R32F_To_X8R8G8B8 *src = SSE2_enabled ? new VDPixmapGen_X32B32G32R32F_To_X8R8G8B8_SSE2 : new VDPixmapGen_X32B32G32R32F_To_X8R8G8B8;
+#else
 	VDPixmapGen_X32B32G32R32F_To_X8R8G8B8 *src = new VDPixmapGen_X32B32G32R32F_To_X8R8G8B8;
+#endif
 
 	src->Init(args[0].mpSrc, args[0].mSrcIndex);
 
@@ -1182,6 +1262,61 @@ void VDPixmapUberBlitterGenerator::conv_32F_to_V210() {
 	mStack.pop_back();
 }
 
+void VDPixmapUberBlitterGenerator::conv_16_to_8() {
+	StackEntry *args = &mStack.back();
+	VDPixmapGen_16_To_8 *src = new VDPixmapGen_16_To_8;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	args[0] = StackEntry(src, 0);
+}
+
+void VDPixmapUberBlitterGenerator::conv_32F_to_16() {
+	StackEntry *args = &mStack.back();
+	VDPixmapGen_32F_To_16 *src = new VDPixmapGen_32F_To_16;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	args[0] = StackEntry(src, 0);
+}
+
+void VDPixmapUberBlitterGenerator::conv_16x4_to_8888() {
+	StackEntry *args = &mStack.back();
+	VDPixmapGen_X16R16G16B16_To_X8R8G8B8 *src = new VDPixmapGen_X16R16G16B16_To_X8R8G8B8;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	args[0] = StackEntry(src, 0);
+}
+
+void VDPixmapUberBlitterGenerator::conv_X32F_to_16x4() {
+	StackEntry *args = &mStack.back();
+	VDPixmapGen_X32B32G32R32F_To_X16R16G16B16 *src = new VDPixmapGen_X32B32G32R32F_To_X16R16G16B16;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	args[0] = StackEntry(src, 0);
+}
+
+void VDPixmapUberBlitterGenerator::round_16_to_10() {
+	StackEntry *args = &mStack.back();
+	VDPixmapGen_16_To_10 *src = new VDPixmapGen_16_To_10;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	args[0] = StackEntry(src, 0);
+}
+
 void VDPixmapUberBlitterGenerator::convd_8888_to_555() {
 	StackEntry *args = &mStack.back();
 	VDPixmapGen_X8R8G8B8_To_X1R5G5B5_Dithered *src = new VDPixmapGen_X8R8G8B8_To_X1R5G5B5_Dithered;
@@ -1305,6 +1440,19 @@ void VDPixmapUberBlitterGenerator::interleave_B8R8() {
 	mStack.pop_back();
 }
 
+void VDPixmapUberBlitterGenerator::interleave_B16R16() {
+	StackEntry *args = &mStack.back() - 1;
+	VDPixmapGen_B16x2_To_B16R16 *src = new VDPixmapGen_B16x2_To_B16R16;
+
+	src->Init(args[0].mpSrc, args[0].mSrcIndex, args[1].mpSrc, args[1].mSrcIndex);
+
+	mGenerators.push_back(src);
+	MarkDependency(src, args[0].mpSrc);
+	MarkDependency(src, args[1].mpSrc);
+	args[0] = StackEntry(src, 0);
+	mStack.pop_back();
+}
+
 void VDPixmapUberBlitterGenerator::merge_fields(uint32 w, uint32 h, uint32 bpr) {
 	StackEntry *args = &mStack.back() - 1;
 
@@ -1402,7 +1550,11 @@ void VDPixmapUberBlitterGenerator::rgb32_to_ycbcr709() {
 void VDPixmapUberBlitterGenerator::ycbcr601_to_rgb32_32f() {
 	StackEntry *args = &mStack.back() - 2;
 
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	VDPixmapGenYCbCr601ToRGB32F *src = SSE2_enabled ? new VDPixmapGenYCbCr601ToRGB32F_SSE2 : new VDPixmapGenYCbCr601ToRGB32F;
+#else
 	VDPixmapGenYCbCr601ToRGB32F *src = new VDPixmapGenYCbCr601ToRGB32F;
+#endif
 
 	src->Init(args[0].mpSrc, args[0].mSrcIndex, args[1].mpSrc, args[1].mSrcIndex, args[2].mpSrc, args[2].mSrcIndex);
 
@@ -1418,7 +1570,11 @@ void VDPixmapUberBlitterGenerator::ycbcr601_to_rgb32_32f() {
 void VDPixmapUberBlitterGenerator::ycbcr709_to_rgb32_32f() {
 	StackEntry *args = &mStack.back() - 2;
 
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	VDPixmapGenYCbCr709ToRGB32F *src = SSE2_enabled ? new VDPixmapGenYCbCr709ToRGB32F_SSE2 : new VDPixmapGenYCbCr709ToRGB32F;
+#else
 	VDPixmapGenYCbCr709ToRGB32F *src = new VDPixmapGenYCbCr709ToRGB32F;
+#endif
 
 	src->Init(args[0].mpSrc, args[0].mSrcIndex, args[1].mpSrc, args[1].mSrcIndex, args[2].mpSrc, args[2].mSrcIndex);
 
@@ -1555,7 +1711,11 @@ void VDPixmapUberBlitterGenerator::rgb32_to_ycbcr_generic(const VDPixmapGenYCbCr
 void VDPixmapUberBlitterGenerator::rgb32f_to_ycbcr_generic(const VDPixmapGenYCbCrBasis& basis, uint32 colorSpace) {
 	StackEntry *args = &mStack.back();
 
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	VDPixmapGenRGB32FToYCbCrGeneric *src = SSE2_enabled ? new VDPixmapGenRGB32FToYCbCrGeneric_SSE2(basis, colorSpace) : new VDPixmapGenRGB32FToYCbCrGeneric(basis, colorSpace);
+#else
 	VDPixmapGenRGB32FToYCbCrGeneric *src = new VDPixmapGenRGB32FToYCbCrGeneric(basis, colorSpace);
+#endif
 	src->Init(args[0].mpSrc, args[0].mSrcIndex);
 
 	mGenerators.push_back(src);
@@ -1570,7 +1730,13 @@ void VDPixmapUberBlitterGenerator::ycbcr_to_ycbcr_generic(const VDPixmapGenYCbCr
 
 	IVDPixmapGen *src;
 	if ((args[0].mpSrc->GetType(args[0].mSrcIndex) & kVDPixType_Mask) == kVDPixType_32F_LE) {
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+		VDPixmapGenYCbCrToYCbCrGeneric_32F *src2 = SSE2_enabled
+			? new VDPixmapGenYCbCrToYCbCrGeneric_32F_SSE2(basisDst, dstLimitedRange, basisSrc, srcLimitedRange, colorSpace)
+			: new VDPixmapGenYCbCrToYCbCrGeneric_32F(basisDst, dstLimitedRange, basisSrc, srcLimitedRange, colorSpace);
+#else
 		VDPixmapGenYCbCrToYCbCrGeneric_32F *src2 = new VDPixmapGenYCbCrToYCbCrGeneric_32F(basisDst, dstLimitedRange, basisSrc, srcLimitedRange, colorSpace);
+#endif
 
 		src2->Init(args[0].mpSrc, args[0].mSrcIndex, args[1].mpSrc, args[1].mSrcIndex, args[2].mpSrc, args[2].mSrcIndex);
 		src = src2;
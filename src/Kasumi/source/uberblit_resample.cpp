@@ -28,7 +28,11 @@
 #include <vd2/Kasumi/resample.h>
 
 #include <vd2/Kasumi/resample_kernels.h>
-#include "resample_stages_x86.h"
+#if defined _M_AMD64
+	#include "resample_stages_x64.h"
+#else
+	#include "resample_stages_x86.h"
+#endif
 #include "uberblit_resample.h"
 
 namespace {
@@ -193,9 +197,18 @@ void VDPixmapGenResampleRow::Init(IVDPixmapGen *src, uint32 srcIndex, uint32 wid
 			{ kVDPixType_8888,		false,	nsVDPixmap::kFilterLanczos3,	CPUF_SUPPORTS_MMX,	RowFactoryLanczos3<VDResamplerSeparableTableRowStageMMX> },
 #elif defined _M_AMD64
 			// AMD64
+			{ kVDPixType_8,			false,	nsVDPixmap::kFilterLinear,		CPUF_SUPPORTS_SSE2,	RowFactoryLinear<VDResamplerSeparableTableRowStage8SSE2> },
 			{ kVDPixType_8888,		false,	nsVDPixmap::kFilterLinear,		CPUF_SUPPORTS_SSE2,	RowFactoryLinear<VDResamplerSeparableTableRowStageSSE2> },
+			{ kVDPixType_32F_LE,	false,	nsVDPixmap::kFilterLinear,		CPUF_SUPPORTS_SSE2,	RowFactoryLinear<VDResamplerSeparableTableRowStage32FSSE2> },
+			{ kVDPixType_32Fx4_LE,	false,	nsVDPixmap::kFilterLinear,		CPUF_SUPPORTS_SSE2,	RowFactoryLinear<VDResamplerSeparableTableRowStage32Fx4SSE2> },
+			{ kVDPixType_8,			false,	nsVDPixmap::kFilterCubic,		CPUF_SUPPORTS_SSE2,	RowFactoryCubic<VDResamplerSeparableTableRowStage8SSE2> },
 			{ kVDPixType_8888,		false,	nsVDPixmap::kFilterCubic,		CPUF_SUPPORTS_SSE2,	RowFactoryCubic<VDResamplerSeparableTableRowStageSSE2> },
+			{ kVDPixType_32F_LE,	false,	nsVDPixmap::kFilterCubic,		CPUF_SUPPORTS_SSE2,	RowFactoryCubic<VDResamplerSeparableTableRowStage32FSSE2> },
+			{ kVDPixType_32Fx4_LE,	false,	nsVDPixmap::kFilterCubic,		CPUF_SUPPORTS_SSE2,	RowFactoryCubic<VDResamplerSeparableTableRowStage32Fx4SSE2> },
+			{ kVDPixType_8,			false,	nsVDPixmap::kFilterLanczos3,	CPUF_SUPPORTS_SSE2,	RowFactoryLanczos3<VDResamplerSeparableTableRowStage8SSE2> },
 			{ kVDPixType_8888,		false,	nsVDPixmap::kFilterLanczos3,	CPUF_SUPPORTS_SSE2,	RowFactoryLanczos3<VDResamplerSeparableTableRowStageSSE2> },
+			{ kVDPixType_32F_LE,	false,	nsVDPixmap::kFilterLanczos3,	CPUF_SUPPORTS_SSE2,	RowFactoryLanczos3<VDResamplerSeparableTableRowStage32FSSE2> },
+			{ kVDPixType_32Fx4_LE,	false,	nsVDPixmap::kFilterLanczos3,	CPUF_SUPPORTS_SSE2,	RowFactoryLanczos3<VDResamplerSeparableTableRowStage32Fx4SSE2> },
 #endif
 			// Generic
 			{ kVDPixType_8,			false,	nsVDPixmap::kFilterPoint,		0,					RowFactory<VDResamplerRowStageSeparablePoint8> },
@@ -309,7 +322,8 @@ void VDPixmapGenResampleRow::Compute8(void *dst0, sint32 y) {
 		dst += count;
 	} else if (uint32 count = mAxis.dx_dualclip) {
 		VDMemset8(p, src[0], mRowFiltW);
-		memcpy(p + mRowFiltW, src+1, (mSrcWidth-2));
+		if (mSrcWidth > 2)
+			memcpy(p + mRowFiltW, src+1, (mSrcWidth-2));
 		VDMemset8(p + mRowFiltW + (mSrcWidth-2), src[mSrcWidth-1], mRowFiltW);
 
 		mpRowStage->Process(dst, p, count, u + ((mRowFiltW-1)<<16), dudx);
@@ -368,7 +382,8 @@ void VDPixmapGenResampleRow::Compute32(void *dst0, sint32 y) {
 	// process dual-clip region
 	if (uint32 count = mAxis.dx_dualclip) {
 		VDMemset32(p, src[0], mRowFiltW);
-		memcpy(p + mRowFiltW, src+1, (mSrcWidth-2)*sizeof(uint32));
+		if (mSrcWidth > 2)
+			memcpy(p + mRowFiltW, src+1, (mSrcWidth-2)*sizeof(uint32));
 		VDMemset32(p + mRowFiltW + (mSrcWidth-2), src[mSrcWidth-1], mRowFiltW);
 
 		mpRowStage->Process(dst, p, count, u + ((mRowFiltW-1)<<16), dudx);
@@ -429,7 +444,8 @@ void VDPixmapGenResampleRow::Compute128(void *dst0, sint32 y) {
 	// process dual-clip region
 	if (uint32 count = mAxis.dx_dualclip) {
 		VDMemset128(p, src, mRowFiltW);
-		memcpy(p + 4*mRowFiltW, src+1, (mSrcWidth-2)*sizeof(uint32)*4);
+		if (mSrcWidth > 2)
+			memcpy(p + 4*mRowFiltW, src+4, (mSrcWidth-2)*sizeof(uint32)*4);
 		VDMemset128(p + 4*(mRowFiltW + (mSrcWidth-2)), src + 4*(mSrcWidth-1), mRowFiltW);
 
 		mpRowStage->Process(dst, p, count, u + ((mRowFiltW-1)<<16), dudx);
@@ -441,7 +457,7 @@ void VDPixmapGenResampleRow::Compute128(void *dst0, sint32 y) {
 		// process pre-clip region
 		if (uint32 count = mAxis.dx_preclip) {
 			VDMemset128(p, src, mRowFiltW);
-			memcpy(p + 4*mRowFiltW, src+1, (mRowFiltW-1)*sizeof(uint32)*4);
+			memcpy(p + 4*mRowFiltW, src+4, (mRowFiltW-1)*sizeof(uint32)*4);
 
 			mpRowStage->Process(dst, p, count, u + ((mRowFiltW-1)<<16), dudx);
 			u += dudx*count;
@@ -529,9 +545,18 @@ void VDPixmapGenResampleCol::Init(IVDPixmapGen *src, uint32 srcIndex, uint32 hei
 		{ kVDPixType_8888,		false,	nsVDPixmap::kFilterLanczos3,	CPUF_SUPPORTS_MMX,	ColFactoryLanczos3<VDResamplerSeparableTableColStageMMX> },
 #elif defined _M_AMD64
 		// AMD64
+		{ kVDPixType_8,			false,	nsVDPixmap::kFilterLinear,		CPUF_SUPPORTS_SSE2,	ColFactoryLinear<VDResamplerSeparableTableColStage8SSE2> },
 		{ kVDPixType_8888,		false,	nsVDPixmap::kFilterLinear,		CPUF_SUPPORTS_SSE2,	ColFactoryLinear<VDResamplerSeparableTableColStageSSE2> },
+		{ kVDPixType_32F_LE,	false,	nsVDPixmap::kFilterLinear,		CPUF_SUPPORTS_SSE2,	ColFactoryLinear<VDResamplerSeparableTableColStage32FSSE2> },
+		{ kVDPixType_32Fx4_LE,	false,	nsVDPixmap::kFilterLinear,		CPUF_SUPPORTS_SSE2,	ColFactoryLinear<VDResamplerSeparableTableColStage32Fx4SSE2> },
+		{ kVDPixType_8,			false,	nsVDPixmap::kFilterCubic,		CPUF_SUPPORTS_SSE2,	ColFactoryCubic<VDResamplerSeparableTableColStage8SSE2> },
 		{ kVDPixType_8888,		false,	nsVDPixmap::kFilterCubic,		CPUF_SUPPORTS_SSE2,	ColFactoryCubic<VDResamplerSeparableTableColStageSSE2> },
+		{ kVDPixType_32F_LE,	false,	nsVDPixmap::kFilterCubic,		CPUF_SUPPORTS_SSE2,	ColFactoryCubic<VDResamplerSeparableTableColStage32FSSE2> },
+		{ kVDPixType_32Fx4_LE,	false,	nsVDPixmap::kFilterCubic,		CPUF_SUPPORTS_SSE2,	ColFactoryCubic<VDResamplerSeparableTableColStage32Fx4SSE2> },
+		{ kVDPixType_8,			false,	nsVDPixmap::kFilterLanczos3,	CPUF_SUPPORTS_SSE2,	ColFactoryLanczos3<VDResamplerSeparableTableColStage8SSE2> },
 		{ kVDPixType_8888,		false,	nsVDPixmap::kFilterLanczos3,	CPUF_SUPPORTS_SSE2,	ColFactoryLanczos3<VDResamplerSeparableTableColStageSSE2> },
+		{ kVDPixType_32F_LE,	false,	nsVDPixmap::kFilterLanczos3,	CPUF_SUPPORTS_SSE2,	ColFactoryLanczos3<VDResamplerSeparableTableColStage32FSSE2> },
+		{ kVDPixType_32Fx4_LE,	false,	nsVDPixmap::kFilterLanczos3,	CPUF_SUPPORTS_SSE2,	ColFactoryLanczos3<VDResamplerSeparableTableColStage32Fx4SSE2> },
 #endif
 		// Generic
 		{ kVDPixType_8,			true,	nsVDPixmap::kFilterLinear,		0,					ColFactory<VDResamplerColStageSeparableLinear8> },
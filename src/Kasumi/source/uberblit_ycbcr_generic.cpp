@@ -284,8 +284,8 @@ uint32 VDPixmapGenRGB32FToYCbCrGeneric::GetType(uint32 output) const {
 
 void VDPixmapGenRGB32FToYCbCrGeneric::Compute(void *dst0, sint32 y) {
 	float *dstCr = (float *)dst0;
-	float *dstY  = dstCr + mWindowPitch;
-	float *dstCb = dstY + mWindowPitch;
+	float *dstY  = vdptroffset(dstCr, mWindowPitch);
+	float *dstCb = vdptroffset(dstY, mWindowPitch);
 
 	const float *srcRGB = (const float *)mpSrc->GetRow(y, mSrcIndex);
 
@@ -299,9 +299,9 @@ void VDPixmapGenRGB32FToYCbCrGeneric::Compute(void *dst0, sint32 y) {
 
 	const sint32 w = mWidth;
 	for(sint32 i=0; i<w; ++i) {
-		float r = srcRGB[2];
+		float r = srcRGB[0];
 		float g = srcRGB[1];
-		float b = srcRGB[0];
+		float b = srcRGB[2];
 		srcRGB += 4;
 
 		float y = coYR * r + coYG * g + coYB * b;
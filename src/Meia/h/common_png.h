@@ -20,29 +20,10 @@
 #define f_VD2_MEIA_COMMON_PNG_H
 
 #include <vd2/system/vdtypes.h>
+#include <vd2/system/zip.h>
 
 namespace nsVDPNG {
 	extern const uint8 kPNGSignature[8];
 };
 
-/// Computes the Adler-32 checksum of a block of memory.
-class VDAdler32Checker {
-public:
-	VDAdler32Checker() : mS1(1), mS2(0) {}
-
-	void Process(const void *src, sint32 len);
-
-	uint32 Adler32() const { return mS1 + (mS2 << 16); }
-
-	static uint32 Adler32(const void *src, sint32 len) {
-		VDAdler32Checker checker;
-		checker.Process(src, len);
-		return checker.Adler32();
-	}
-
-protected:
-	uint32	mS1;
-	uint32	mS2;
-};
-
 #endif
@@ -0,0 +1,1949 @@
+//	VirtualDub - Video processing and capture application
+//	Video decoding/encoding library
+//	Copyright (C) 1998-2004 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vd2/system/bandtask.h>
+#include <vd2/system/binary.h>
+#include <vd2/system/cpuaccel.h>
+#include <vd2/system/vdalloc.h>
+#include <vd2/system/vdstl.h>
+#include <vd2/Meia/encode_jpeg.h>
+
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+	#include <emmintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	const int zigzag[64] = {		// zigzag scan order
+		 0,  1,  8, 16,  9,  2,  3, 10,
+		17, 24, 32, 25, 18, 11,  4,  5,
+		12, 19, 26, 33, 40, 48, 41, 34,
+		27, 20, 13,  6,  7, 14, 21, 28,
+		35, 42, 49, 56, 57, 50, 43, 36,
+		29, 22, 15, 23, 30, 37, 44, 51,
+		58, 59, 52, 45, 38, 31, 39, 46,
+		53, 60, 61, 54, 47, 55, 62, 63,
+	};
+
+	struct JPEGHuffmanHistoSorter {
+		JPEGHuffmanHistoSorter(const int *pHisto) : mHisto(pHisto) {}
+
+		bool operator()(int f1, int f2) const {
+			return mHisto[f1] > mHisto[f2];
+		}
+
+		const int *const mHisto;
+	};
+};
+
+class VDJPEGHuffmanTable {
+public:
+	VDJPEGHuffmanTable();
+
+	void Init();
+
+	inline void Tally(unsigned char c) {
+		++mHistogram[c];
+	}
+
+	void Add(const VDJPEGHuffmanTable& src);
+
+	void BuildCode();
+
+	const unsigned char *GetDHTSegment() { return mDHT; }
+	int GetDHTSegmentLen() const { return mDHTLength; }
+
+private:
+	int mHistogram[257];			// one extra code point required to avoid FFFF
+	unsigned char mDHT[256 + 16];
+	int mDHTLength;
+};
+
+VDJPEGHuffmanTable::VDJPEGHuffmanTable() {
+}
+
+void VDJPEGHuffmanTable::Init() {
+	std::fill(mHistogram, mHistogram+256, 0);
+}
+
+void VDJPEGHuffmanTable::Add(const VDJPEGHuffmanTable& src) {
+	for(int i=0; i<256; ++i)
+		mHistogram[i] += src.mHistogram[i];
+}
+
+void VDJPEGHuffmanTable::BuildCode() {
+	int i;
+	int nonzero_codes = 0;
+
+	for(i=0; i<256; ++i) {
+		mDHT[i+16] = (uint8)i;
+		if (mHistogram[i])
+			++nonzero_codes;
+	}
+
+	// Codes are stored in the second half of the DHT segment in decreasing
+	// order of frequency.
+
+	std::sort(&mDHT[16], &mDHT[16+256], JPEGHuffmanHistoSorter(mHistogram));
+	mDHTLength = 16 + nonzero_codes;
+
+	// Sort histogram in increasing order.
+
+	mHistogram[256] = 1;					// extra code point to prevent FFFF from being used
+	std::sort(mHistogram, mHistogram+257);
+
+	++nonzero_codes;
+
+	int *A = mHistogram+257 - nonzero_codes;
+
+	// Begin merging process (from "In-place calculation of minimum redundancy codes" by A. Moffat and J. Katajainen)
+	//
+	// There are three merging possibilities:
+	//
+	// 1) Leaf node with leaf node.
+	// 2) Leaf node with internal node.
+	// 3) Internal node with internal node.
+
+	int leaf = 2;					// Next, smallest unattached leaf node.
+	int internal = 0;				// Next, smallest unattached internal node.
+
+	// Merging always creates one internal node and eliminates one node from
+	// the total, so we will always be doing N-1 merges.
+
+	A[0] += A[1];		// First merge is always two leaf nodes.
+	for(int next=1; next<nonzero_codes-1; ++next) {		// 'next' is the value that receives the next unattached internal node.
+		int a, b;
+
+		// Pick first node.
+		if (leaf < nonzero_codes && A[leaf] <= A[internal]) {
+			A[next] = a=A[leaf++];			// begin new internal node with P of smallest leaf node
+		} else {
+			A[next] = a=A[internal];		// begin new internal node with P of smallest internal node
+			A[internal++] = next;					// hook smallest internal node as child of new node
+		}
+
+		// Pick second node.
+		if (internal >= next || (leaf < nonzero_codes && A[leaf] <= A[internal])) {
+			A[next] += b=A[leaf++];			// complete new internal node with P of smallest leaf node
+		} else {
+			A[next] += b=A[internal];		// complete new internal node with P of smallest internal node
+			A[internal++] = next;					// hook smallest internal node as child of new node
+		}
+	}
+
+	// At this point, we have a binary tree composed entirely of pointers to
+	// parents, partially sorted such that children are always before their
+	// parents in the array.  Traverse the array backwards, replacing each
+	// node with its depth in the tree.
+
+	A[nonzero_codes-2] = 0;		// root has height 0 (0 bits)
+	for(i = nonzero_codes-3; i>=0; --i)
+		A[i] = A[A[i]]+1;		// child height is 1+height(parent).
+
+	// Compute canonical tree bit depths for first part of DHT segment.
+	// For each internal node at depth N, add two counts at depth N+1
+	// and subtract one count at depth N.  Essentially, we are splitting
+	// as we go.  We traverse backwards to ensure that no counts will drop
+	// below zero at any time.
+
+	std::fill(mDHT, mDHT+16, 0);
+
+	int overallocation = 0;
+
+	mDHT[0] = 2;		// 2 codes at depth 1 (1 bit)
+	for(i = nonzero_codes-3; i>=0; --i) {
+		int depth = A[i];
+
+		// The optimal Huffman tree for N nodes can have a depth of N-1,
+		// but we have to constrain ourselves at depth 16.  We simply
+		// pile up counts at depth 16.  This causes us to overallocate the
+		// codespace, but we will compensate for that later.
+
+		if (depth >= 16) {
+			++mDHT[15];
+		} else {
+			--mDHT[depth-1];
+			++mDHT[depth];
+			++mDHT[depth];
+		}
+	}
+
+	// Remove the extra code point.
+	bool bExtraCodePointFound = false;
+
+	for(i=15; i>=0; --i) {
+		if (mDHT[i]) {
+			if (!bExtraCodePointFound) {
+				bExtraCodePointFound = true;
+				--mDHT[i];
+			}
+
+			overallocation += mDHT[i] * (0x8000 >> i);
+		}
+	}
+	overallocation -= 0xFFFF;			// we can't allocate FFFF, so 64K-1 codes
+
+	// We may have overallocated the codespace if we were forced to shorten
+	// some codewords.
+
+	if (overallocation > 0) {
+		// Codespace is overallocated.  Begin lengthening codes from bit depth
+		// 15 down until we are under the limit.
+
+		i = 14;
+		while(overallocation > 0) {
+			if (mDHT[i]) {
+				--mDHT[i];
+				++mDHT[i+1];
+				overallocation -= 0x4000 >> i;
+				if (i < 14)
+					++i;
+			} else
+				--i;
+		}
+
+		// We may be undercommitted at this point.  Raise codes from bit depth
+		// 1 up until we are at the desired limit.
+
+		int underallocation = -overallocation;
+
+		i = 1;
+		while(underallocation > 0) {
+			if (mDHT[i] && (0x8000>>i) <= underallocation) {
+				underallocation -= (0x8000>>i);
+				--mDHT[i];
+				--i;
+				++mDHT[i];
+			} else {
+				++i;
+			}
+		}
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Color conversion
+//
+//	From JFIF spec:
+//
+//	RGB to YCbCr Conversion
+//	-----------------------
+//	YCbCr (256 levels) can be computed directly from 8-bit RGB as follows:
+//
+//	Y   =     0.299  R + 0.587  G + 0.114  B
+//	Cb  =   - 0.1687 R - 0.3313 G + 0.5    B + 128
+//	Cr  =     0.5    R - 0.4187 G - 0.0813 B + 128
+//
+//	The coefficients are scaled by 2^15 and rounded such that the Y weights
+//	sum to exactly 1.0 and the Cb/Cr weights to exactly 0, so no result ever
+//	needs to be clamped. RGB15 and RGB24 rows are expanded to 32-bit pixels
+//	first, so that there is only one converter per instruction set.
+//
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	enum {
+		kYR		= 9798,
+		kYG		= 19235,
+		kYB		= 3735,
+		kCbR	= -5529,
+		kCbG	= -10855,
+		kCbB	= 16384,
+		kCrR	= 16384,
+		kCrG	= -13720,
+		kCrB	= -2664,
+		kYBias	= 16384,
+		kCBias	= (128 << 15) + 16383
+	};
+
+	void JPEGExpandRowRGB15(uint8 *dst, const uint8 *src, int w) {
+		for(int x=0; x<w; ++x) {
+			const uint32 c = src[0] + ((uint32)src[1] << 8);
+			src += 2;
+
+			dst[0] = (uint8)(((c & 0x001f) * 33) >> 2);
+			dst[1] = (uint8)((((c >> 5) & 0x1f) * 33) >> 2);
+			dst[2] = (uint8)((((c >> 10) & 0x1f) * 33) >> 2);
+			dst[3] = 0;
+			dst += 4;
+		}
+	}
+
+	void JPEGExpandRowRGB24(uint8 *dst, const uint8 *src, int w) {
+		for(int x=0; x<w; ++x) {
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+			dst[3] = 0;
+			dst += 4;
+			src += 3;
+		}
+	}
+
+	void JPEGConvertRowToYCbCr(uint8 *dstY, uint8 *dstCb, uint8 *dstCr, const uint8 *src, int w) {
+		for(int x=0; x<w; ++x) {
+			const int b = src[0];
+			const int g = src[1];
+			const int r = src[2];
+			src += 4;
+
+			dstY[x]		= (uint8)((kYR*r + kYG*g + kYB*b + kYBias) >> 15);
+			dstCb[x]	= (uint8)((kCbR*r + kCbG*g + kCbB*b + kCBias) >> 15);
+			dstCr[x]	= (uint8)((kCrR*r + kCrG*g + kCrB*b + kCBias) >> 15);
+		}
+	}
+
+	// The downsamplers may be run in place, with dst == src.
+	void JPEGDownsampleRow422(uint8 *dst, const uint8 *src, int qw) {
+		for(int x=0; x<qw; ++x)
+			dst[x] = (uint8)((src[2*x] + src[2*x+1] + 1) >> 1);
+	}
+
+	void JPEGDownsampleRow420(uint8 *dst, const uint8 *src1, const uint8 *src2, int qw) {
+		for(int x=0; x<qw; ++x)
+			dst[x] = (uint8)((src1[2*x] + src1[2*x+1] + src2[2*x] + src2[2*x+1] + 2) >> 2);
+	}
+}
+
+// This algorithm does an 8-point forward DCT in 29 adds, 13 multiplies.
+// For an 8x8 2D-IDCT, that's 464a208m.  LLM is 29a12m, I think.
+// Feig-Winograd is a LOT faster at 464a56m and has the advantage of doing
+// only one layer of multiplies, but it's considerably more complex to
+// implement.
+
+namespace {
+	const int c1 = 2009;		// cos(1*pi/16) << 11
+	const int c3 = 1703;		// cos(3*pi/16) << 11
+	const int c5 = 1138;		// cos(5*pi/16) << 11
+	const int c7 = 400;		// cos(7*pi/16) << 11
+	const int c2r2 = 2676;	// cos(2*pi/16)*sqrt(2) << 11
+	const int c6r2 = 1108;	// cos(6*pi/16)*sqrt(2) << 11
+	const int r2 = 2896;		// sqrt(2) << 11
+
+	template<int stride, int postshift, class T>
+	struct fdct_llm {
+		enum { round = 1<<(10 + postshift), shift = 11 + postshift, postround = (1<<postshift)>>1 };
+
+		static void go(int *dst, const T *x) { 
+			int s0 = x[0*stride];
+			int s1 = x[1*stride];
+			int s2 = x[2*stride];
+			int s3 = x[3*stride];
+			int s4 = x[4*stride];
+			int s5 = x[5*stride];
+			int s6 = x[6*stride];
+			int s7 = x[7*stride];
+			int t0, t1, t2, t3, t4, t5, t6, t7;
+			int tmp;
+
+			t0 = s0+s7;
+			t1 = s1+s6;
+			t2 = s2+s5;
+			t3 = s3+s4;
+			t4 = s3-s4;
+			t5 = s2-s5;
+			t6 = s1-s6;
+			t7 = s0-s7;
+
+			s0 = t0+t3;
+			s1 = t1+t2;
+			s2 = t1-t2;
+			s3 = t0-t3;
+
+			t0 = s0+s1;
+			t1 = s0-s1;
+			tmp = c6r2*(s3+s2);
+			t2 = tmp + s3*(c2r2-c6r2);
+			t3 = tmp - s2*(c2r2+c6r2);
+			dst[0*stride] = (t0 + postround) >> postshift;
+			dst[2*stride] = (t2 + round) >> shift;
+			dst[4*stride] = (t1 + postround) >> postshift;
+			dst[6*stride] = (t3 + round) >> shift;
+
+			tmp = c3*(t7+t4);
+			s4 = tmp + t7*(c5-c3);
+			s7 = tmp - t4*(c5+c3);
+
+			tmp = c1*(t6+t5);
+			s5 = tmp + t6*(c7-c1);
+			s6 = tmp - t5*(c7+c1);
+
+			t4 = s4+s6;
+			t5 =((s7-s5 + 1024) >> 11) * r2;
+			t6 =((s4-s6 + 1024) >> 11) * r2;
+			t7 = s7+s5;
+			dst[1*stride] = (t7 + t4 + round) >> shift;
+			dst[3*stride] = (t5 + round) >> shift;
+			dst[5*stride] = (t6 + round) >> shift;
+			dst[7*stride] = (t7 - t4 + round) >> shift;
+		}
+	};
+
+	void JPEGFDCT(int dct_coeff[64], const uint8 *src, ptrdiff_t srcpitch) {
+		int i;
+
+		for(i=0; i<8; ++i) {
+			fdct_llm<1, 0, unsigned char>::go(dct_coeff + i*8, src);
+			src += srcpitch;
+		}
+
+		for(i=0; i<8; ++i)
+			fdct_llm<8, 3, int>::go(dct_coeff + i, dct_coeff + i);
+	}
+}
+
+namespace {
+#ifndef _M_IX86
+	void __stdcall QuantizeCoefficients(int dst[64], const int coeffs[64], const unsigned iquant[64]) {
+		for(int i=0; i<64; ++i)
+			dst[i] = (int)(((sint64)coeffs[i] * iquant[i] + 0x80000000) >> 32);
+	}
+#else
+	void __declspec(naked) __stdcall QuantizeCoefficients(int dst[64], const int coeffs[64], const unsigned iquant[64]) {
+		__asm {
+			push	ebp
+			push	edi
+			push	ebx
+			mov		ebp, [esp+16]
+			mov		edi, [esp+20]
+			mov		ebx, [esp+24]
+		}
+#define ITER(i)								\
+			__asm	mov		eax, [edi+i*4]			\
+			__asm	cdq								\
+			__asm	mov		ecx, [ebx+i*4]			\
+			__asm	and		ecx, edx				\
+			__asm	mul		dword ptr [ebx+i*4]		\
+			__asm	sub		edx, ecx				\
+			__asm	add		eax, 80000000h			\
+			__asm	adc		edx, 0					\
+			__asm	mov		[ebp+i*4], edx
+
+	ITER(0) ITER(1) ITER(2) ITER(3) ITER(4) ITER(5) ITER(6) ITER(7)
+	ITER(8) ITER(9) ITER(10) ITER(11) ITER(12) ITER(13) ITER(14) ITER(15)
+	ITER(16) ITER(17) ITER(18) ITER(19) ITER(20) ITER(21) ITER(22) ITER(23)
+	ITER(24) ITER(25) ITER(26) ITER(27) ITER(28) ITER(29) ITER(30) ITER(31)
+	ITER(32) ITER(33) ITER(34) ITER(35) ITER(36) ITER(37) ITER(38) ITER(39)
+	ITER(40) ITER(41) ITER(42) ITER(43) ITER(44) ITER(45) ITER(46) ITER(47)
+	ITER(48) ITER(49) ITER(50) ITER(51) ITER(52) ITER(53) ITER(54) ITER(55)
+	ITER(56) ITER(57) ITER(58) ITER(59) ITER(60) ITER(61) ITER(62) ITER(63)
+
+#undef ITER
+		__asm {
+			pop		ebx
+			pop		edi
+			pop		ebp
+			ret		12
+		}
+	}
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	SSE2 versions of the color conversion, downsampling, DCT and
+//	quantization routines. These give bit-identical results to the
+//	versions above.
+//
+///////////////////////////////////////////////////////////////////////////
+
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+namespace {
+	// Returns a constant with lo in the even words and hi in the odd words,
+	// for use with PMADDWD.
+	inline __m128i JPEGWordPair_SSE2(int lo, int hi) {
+		return _mm_set1_epi32((int)(((uint32)hi << 16) + (uint16)lo));
+	}
+
+	// Computes one component for eight pixels, given the blue/red and
+	// green/alpha words of each pixel.
+	inline __m128i JPEGConvertPixels_SSE2(__m128i br0, __m128i ga0, __m128i br1, __m128i ga1, __m128i kBR, __m128i kG, __m128i bias) {
+		const __m128i v0 = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(br0, kBR), _mm_madd_epi16(ga0, kG)), bias), 15);
+		const __m128i v1 = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(br1, kBR), _mm_madd_epi16(ga1, kG)), bias), 15);
+		const __m128i v = _mm_packs_epi32(v0, v1);
+
+		return _mm_packus_epi16(v, v);
+	}
+
+	void JPEGConvertRowToYCbCr_SSE2(uint8 *dstY, uint8 *dstCb, uint8 *dstCr, const uint8 *src, int w) {
+		const __m128i mask = _mm_set1_epi16(0x00FF);
+		const __m128i kYBR = JPEGWordPair_SSE2(kYB, kYR);
+		const __m128i kYG0 = JPEGWordPair_SSE2(kYG, 0);
+		const __m128i kCbBR = JPEGWordPair_SSE2(kCbB, kCbR);
+		const __m128i kCbG0 = JPEGWordPair_SSE2(kCbG, 0);
+		const __m128i kCrBR = JPEGWordPair_SSE2(kCrB, kCrR);
+		const __m128i kCrG0 = JPEGWordPair_SSE2(kCrG, 0);
+		const __m128i ybias = _mm_set1_epi32(kYBias);
+		const __m128i cbias = _mm_set1_epi32(kCBias);
+
+		int x = 0;
+		for(; x+8 <= w; x += 8) {
+			const __m128i p0 = _mm_loadu_si128((const __m128i *)(src + x*4));
+			const __m128i p1 = _mm_loadu_si128((const __m128i *)(src + x*4 + 16));
+			const __m128i br0 = _mm_and_si128(p0, mask);
+			const __m128i ga0 = _mm_srli_epi16(p0, 8);
+			const __m128i br1 = _mm_and_si128(p1, mask);
+			const __m128i ga1 = _mm_srli_epi16(p1, 8);
+
+			_mm_storel_epi64((__m128i *)(dstY + x), JPEGConvertPixels_SSE2(br0, ga0, br1, ga1, kYBR, kYG0, ybias));
+			_mm_storel_epi64((__m128i *)(dstCb + x), JPEGConvertPixels_SSE2(br0, ga0, br1, ga1, kCbBR, kCbG0, cbias));
+			_mm_storel_epi64((__m128i *)(dstCr + x), JPEGConvertPixels_SSE2(br0, ga0, br1, ga1, kCrBR, kCrG0, cbias));
+		}
+
+		JPEGConvertRowToYCbCr(dstY + x, dstCb + x, dstCr + x, src + x*4, w - x);
+	}
+
+	void JPEGDownsampleRow422_SSE2(uint8 *dst, const uint8 *src, int qw) {
+		const __m128i mask = _mm_set1_epi16(0x00FF);
+
+		int x = 0;
+		for(; x+16 <= qw; x += 16) {
+			const __m128i a = _mm_loadu_si128((const __m128i *)(src + 2*x));
+			const __m128i b = _mm_loadu_si128((const __m128i *)(src + 2*x + 16));
+			const __m128i even = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+			const __m128i odd = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+
+			_mm_storeu_si128((__m128i *)(dst + x), _mm_avg_epu8(even, odd));
+		}
+
+		JPEGDownsampleRow422(dst + x, src + 2*x, qw - x);
+	}
+
+	void JPEGDownsampleRow420_SSE2(uint8 *dst, const uint8 *src1, const uint8 *src2, int qw) {
+		const __m128i mask = _mm_set1_epi16(0x00FF);
+		const __m128i round = _mm_set1_epi16(2);
+
+		int x = 0;
+		for(; x+16 <= qw; x += 16) {
+			const __m128i a0 = _mm_loadu_si128((const __m128i *)(src1 + 2*x));
+			const __m128i a1 = _mm_loadu_si128((const __m128i *)(src1 + 2*x + 16));
+			const __m128i b0 = _mm_loadu_si128((const __m128i *)(src2 + 2*x));
+			const __m128i b1 = _mm_loadu_si128((const __m128i *)(src2 + 2*x + 16));
+			const __m128i sum0 = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a0, mask), _mm_srli_epi16(a0, 8)), _mm_add_epi16(_mm_and_si128(b0, mask), _mm_srli_epi16(b0, 8)));
+			const __m128i sum1 = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a1, mask), _mm_srli_epi16(a1, 8)), _mm_add_epi16(_mm_and_si128(b1, mask), _mm_srli_epi16(b1, 8)));
+
+			_mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(sum0, round), 2), _mm_srli_epi16(_mm_add_epi16(sum1, round), 2)));
+		}
+
+		JPEGDownsampleRow420(dst + x, src1 + 2*x, src2 + 2*x, qw - x);
+	}
+
+	void JPEGTranspose8x8_SSE2(__m128i *v) {
+		const __m128i a0 = _mm_unpacklo_epi16(v[0], v[1]);
+		const __m128i a1 = _mm_unpackhi_epi16(v[0], v[1]);
+		const __m128i a2 = _mm_unpacklo_epi16(v[2], v[3]);
+		const __m128i a3 = _mm_unpackhi_epi16(v[2], v[3]);
+		const __m128i a4 = _mm_unpacklo_epi16(v[4], v[5]);
+		const __m128i a5 = _mm_unpackhi_epi16(v[4], v[5]);
+		const __m128i a6 = _mm_unpacklo_epi16(v[6], v[7]);
+		const __m128i a7 = _mm_unpackhi_epi16(v[6], v[7]);
+		const __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+		const __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+		const __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+		const __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+		const __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+		const __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+		const __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+		const __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+		v[0] = _mm_unpacklo_epi64(b0, b4);
+		v[1] = _mm_unpackhi_epi64(b0, b4);
+		v[2] = _mm_unpacklo_epi64(b1, b5);
+		v[3] = _mm_unpackhi_epi64(b1, b5);
+		v[4] = _mm_unpacklo_epi64(b2, b6);
+		v[5] = _mm_unpackhi_epi64(b2, b6);
+		v[6] = _mm_unpacklo_epi64(b3, b7);
+		v[7] = _mm_unpackhi_epi64(b3, b7);
+	}
+
+	// Same algorithm as fdct_llm, on eight rows or columns at once. The
+	// butterflies fit in 16 bits; each rotation is a pair of products that
+	// PMADDWD computes exactly in 32 bits, so the rounding matches the scalar
+	// version.
+	template<int postshift>
+	struct fdct_llm_sse2 {
+		enum { round = 1<<(10 + postshift), shift = 11 + postshift, postround = (1<<postshift)>>1 };
+
+		static __m128i descale(__m128i lo, __m128i hi, __m128i rnd) {
+			return _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(lo, rnd), shift), _mm_srai_epi32(_mm_add_epi32(hi, rnd), shift));
+		}
+
+		static __m128i rotate_r2(__m128i d, __m128i kr2) {
+			const __m128i r1024 = _mm_set1_epi32(1024);
+
+			// the descaled difference fits in 16 bits, so PMADDWD against
+			// (r2, 0) is a 32-bit multiply
+			return _mm_madd_epi16(_mm_srai_epi32(_mm_add_epi32(d, r1024), 11), kr2);
+		}
+
+		static void go(__m128i *v) {
+			const __m128i rnd = _mm_set1_epi32(round);
+			const __m128i kr2 = _mm_set1_epi32(r2);
+
+			const __m128i t0 = _mm_add_epi16(v[0], v[7]);
+			const __m128i t1 = _mm_add_epi16(v[1], v[6]);
+			const __m128i t2 = _mm_add_epi16(v[2], v[5]);
+			const __m128i t3 = _mm_add_epi16(v[3], v[4]);
+			const __m128i t4 = _mm_sub_epi16(v[3], v[4]);
+			const __m128i t5 = _mm_sub_epi16(v[2], v[5]);
+			const __m128i t6 = _mm_sub_epi16(v[1], v[6]);
+			const __m128i t7 = _mm_sub_epi16(v[0], v[7]);
+
+			const __m128i s0 = _mm_add_epi16(t0, t3);
+			const __m128i s1 = _mm_add_epi16(t1, t2);
+			const __m128i s2 = _mm_sub_epi16(t1, t2);
+			const __m128i s3 = _mm_sub_epi16(t0, t3);
+
+			__m128i d0 = _mm_add_epi16(s0, s1);
+			__m128i d4 = _mm_sub_epi16(s0, s1);
+
+			if (postshift) {
+				const __m128i prnd = _mm_set1_epi16(postround);
+
+				d0 = _mm_srai_epi16(_mm_add_epi16(d0, prnd), postshift);
+				d4 = _mm_srai_epi16(_mm_add_epi16(d4, prnd), postshift);
+			}
+
+			// t2 = c6r2*s2 + c2r2*s3, t3 = c6r2*s3 - c2r2*s2
+			const __m128i s23lo = _mm_unpacklo_epi16(s2, s3);
+			const __m128i s23hi = _mm_unpackhi_epi16(s2, s3);
+			const __m128i k2 = JPEGWordPair_SSE2(c6r2, c2r2);
+			const __m128i k6 = JPEGWordPair_SSE2(-c2r2, c6r2);
+
+			v[0] = d0;
+			v[2] = descale(_mm_madd_epi16(s23lo, k2), _mm_madd_epi16(s23hi, k2), rnd);
+			v[4] = d4;
+			v[6] = descale(_mm_madd_epi16(s23lo, k6), _mm_madd_epi16(s23hi, k6), rnd);
+
+			// s4 = c3*t4 + c5*t7, s7 = c3*t7 - c5*t4
+			// s5 = c1*t5 + c7*t6, s6 = c1*t6 - c7*t5
+			const __m128i t47lo = _mm_unpacklo_epi16(t4, t7);
+			const __m128i t47hi = _mm_unpackhi_epi16(t4, t7);
+			const __m128i t56lo = _mm_unpacklo_epi16(t5, t6);
+			const __m128i t56hi = _mm_unpackhi_epi16(t5, t6);
+			const __m128i k4 = JPEGWordPair_SSE2(c3, c5);
+			const __m128i k7 = JPEGWordPair_SSE2(-c5, c3);
+			const __m128i k5 = JPEGWordPair_SSE2(c1, c7);
+			const __m128i k6b = JPEGWordPair_SSE2(-c7, c1);
+
+			const __m128i s4lo = _mm_madd_epi16(t47lo, k4);
+			const __m128i s4hi = _mm_madd_epi16(t47hi, k4);
+			const __m128i s7lo = _mm_madd_epi16(t47lo, k7);
+			const __m128i s7hi = _mm_madd_epi16(t47hi, k7);
+			const __m128i s5lo = _mm_madd_epi16(t56lo, k5);
+			const __m128i s5hi = _mm_madd_epi16(t56hi, k5);
+			const __m128i s6lo = _mm_madd_epi16(t56lo, k6b);
+			const __m128i s6hi = _mm_madd_epi16(t56hi, k6b);
+
+			const __m128i u4lo = _mm_add_epi32(s4lo, s6lo);
+			const __m128i u4hi = _mm_add_epi32(s4hi, s6hi);
+			const __m128i u7lo = _mm_add_epi32(s7lo, s5lo);
+			const __m128i u7hi = _mm_add_epi32(s7hi, s5hi);
+
+			v[1] = descale(_mm_add_epi32(u7lo, u4lo), _mm_add_epi32(u7hi, u4hi), rnd);
+			v[3] = descale(rotate_r2(_mm_sub_epi32(s7lo, s5lo), kr2), rotate_r2(_mm_sub_epi32(s7hi, s5hi), kr2), rnd);
+			v[5] = descale(rotate_r2(_mm_sub_epi32(s4lo, s6lo), kr2), rotate_r2(_mm_sub_epi32(s4hi, s6hi), kr2), rnd);
+			v[7] = descale(_mm_sub_epi32(u7lo, u4lo), _mm_sub_epi32(u7hi, u4hi), rnd);
+		}
+	};
+
+	void JPEGFDCT_SSE2(int dct_coeff[64], const uint8 *src, ptrdiff_t srcpitch) {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i v[8];
+
+		for(int i=0; i<8; ++i)
+			v[i] = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + srcpitch*i)), zero);
+
+		// rows, then columns
+		JPEGTranspose8x8_SSE2(v);
+		fdct_llm_sse2<0>::go(v);
+		JPEGTranspose8x8_SSE2(v);
+		fdct_llm_sse2<3>::go(v);
+
+		for(int i=0; i<8; ++i) {
+			const __m128i sign = _mm_srai_epi16(v[i], 15);
+
+			_mm_storeu_si128((__m128i *)(dct_coeff + i*8), _mm_unpacklo_epi16(v[i], sign));
+			_mm_storeu_si128((__m128i *)(dct_coeff + i*8 + 4), _mm_unpackhi_epi16(v[i], sign));
+		}
+	}
+
+	// Computes floor((c*iq + 2^31) / 2^32) like the scalar version, using
+	// 16-bit products of the magnitude |c| < 2^15 with both halves of iq;
+	// for negative c, this is -((|c|*iq + 2^31 - 1) >> 32). With iq = H:L,
+	// the sum is |c|*H + ((|c|*L + 2^31 - neg) >> 16) >> 16, and the inner
+	// term fits in 16 bits as mulhi(|c|,L) + 0x8000 - borrow, where a borrow
+	// only occurs when mullo(|c|,L) is zero.
+	void __stdcall QuantizeCoefficients_SSE2(int dst[64], const int coeffs[64], const unsigned iquant[64]) {
+		const __m128i bias = _mm_set1_epi16((short)0x8000);
+		const __m128i zero = _mm_setzero_si128();
+		for(int i=0; i<64; i += 8) {
+			const __m128i iq0 = _mm_loadu_si128((const __m128i *)(iquant + i));
+			const __m128i iq1 = _mm_loadu_si128((const __m128i *)(iquant + i + 4));
+			const __m128i iqlo = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(iq0, 16), 16), _mm_srai_epi32(_mm_slli_epi32(iq1, 16), 16));
+			const __m128i iqhi = _mm_packs_epi32(_mm_srai_epi32(iq0, 16), _mm_srai_epi32(iq1, 16));
+
+			const __m128i c = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)(coeffs + i)), _mm_loadu_si128((const __m128i *)(coeffs + i + 4)));
+			const __m128i sign = _mm_srai_epi16(c, 15);
+			const __m128i mag = _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+
+			const __m128i borrow = _mm_and_si128(_mm_cmpeq_epi16(_mm_mullo_epi16(mag, iqlo), zero), sign);
+			const __m128i mid = _mm_add_epi16(_mm_add_epi16(_mm_mulhi_epu16(mag, iqlo), bias), borrow);
+			const __m128i lo = _mm_mullo_epi16(mag, iqhi);
+			const __m128i sum = _mm_add_epi16(lo, mid);
+			const __m128i carry = _mm_cmpgt_epi16(_mm_xor_si128(lo, bias), _mm_xor_si128(sum, bias));
+			const __m128i q = _mm_sub_epi16(_mm_mulhi_epu16(mag, iqhi), carry);
+
+			const __m128i r = _mm_sub_epi16(_mm_xor_si128(q, sign), sign);
+
+			const __m128i rsign = _mm_srai_epi16(r, 15);
+
+			_mm_storeu_si128((__m128i *)(dst + i), _mm_unpacklo_epi16(r, rsign));
+			_mm_storeu_si128((__m128i *)(dst + i + 4), _mm_unpackhi_epi16(r, rsign));
+		}
+	}
+}
+#endif
+
+namespace {
+	struct JPEGEncodeFunctions {
+		void (*mpConvertRow)(uint8 *dstY, uint8 *dstCb, uint8 *dstCr, const uint8 *src, int w);
+		void (*mpDownsampleRow422)(uint8 *dst, const uint8 *src, int qw);
+		void (*mpDownsampleRow420)(uint8 *dst, const uint8 *src1, const uint8 *src2, int qw);
+		void (*mpFDCT)(int dct_coeff[64], const uint8 *src, ptrdiff_t srcpitch);
+		void (__stdcall *mpQuantize)(int dst[64], const int coeffs[64], const unsigned iquant[64]);
+	};
+
+	const JPEGEncodeFunctions& JPEGGetEncodeFunctions() {
+		static const JPEGEncodeFunctions kScalar = {
+			JPEGConvertRowToYCbCr,
+			JPEGDownsampleRow422,
+			JPEGDownsampleRow420,
+			JPEGFDCT,
+			QuantizeCoefficients
+		};
+
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+		static const JPEGEncodeFunctions kSSE2 = {
+			JPEGConvertRowToYCbCr_SSE2,
+			JPEGDownsampleRow422_SSE2,
+			JPEGDownsampleRow420_SSE2,
+			JPEGFDCT_SSE2,
+			QuantizeCoefficients_SSE2
+		};
+
+		if (SSE2_enabled)
+			return kSSE2;
+#endif
+
+		return kScalar;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Entropy-coded segment writer
+//
+//	Bits are gathered in a 64-bit heap and written out 32 bits at a time;
+//	only words that contain an FF byte take the slow path to be stuffed.
+//	Huffman codes are at most 16 bits and values at most 11 bits, so each
+//	code is written together with its value.
+//
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	class VDJPEGBitWriter {
+	public:
+		VDJPEGBitWriter() : mBitHeap(0), mBitCount(0), mpDst(NULL), mpDstLimit(NULL) {}
+
+		void Init();
+
+		void Reserve(uint32 bytes) {
+			if ((uint32)(mpDstLimit - mpDst) < bytes)
+				Grow(bytes);
+		}
+
+		void Put(uint32 bits, int n) {
+			mBitHeap = (mBitHeap << n) + bits;
+			mBitCount += n;
+
+			if (mBitCount >= 32)
+				Flush32();
+		}
+
+		void PutMarker(uint8 marker) {
+			mpDst[0] = 0xFF;
+			mpDst[1] = marker;
+			mpDst += 2;
+		}
+
+		void Pad();
+
+		const uint8 *GetData() const { return mOutput.data(); }
+		uint32 GetSize() const { return (uint32)(mpDst - mOutput.data()); }
+
+	protected:
+		void Flush32();
+		void Grow(uint32 bytes);
+
+		uint64	mBitHeap;
+		int		mBitCount;
+		uint8	*mpDst;
+		uint8	*mpDstLimit;
+
+		vdfastvector<uint8>	mOutput;
+	};
+
+	void VDJPEGBitWriter::Init() {
+		mBitHeap = 0;
+		mBitCount = 0;
+		mpDst = mOutput.data();
+		mpDstLimit = mpDst + mOutput.size();
+	}
+
+	void VDJPEGBitWriter::Pad() {
+		const int pad = -mBitCount & 7;
+
+		if (pad)
+			Put((1 << pad) - 1, pad);
+
+		while(mBitCount >= 8) {
+			mBitCount -= 8;
+
+			const uint8 c = (uint8)(mBitHeap >> mBitCount);
+			*mpDst++ = c;
+			if (c == 0xFF)
+				*mpDst++ = 0;
+		}
+	}
+
+	void VDJPEGBitWriter::Flush32() {
+		mBitCount -= 32;
+
+		const uint32 v = (uint32)(mBitHeap >> mBitCount);
+
+		// (x - 0x01010101) & ~x & 0x80808080 is nonzero if any byte of x is
+		// zero; here x = ~v, to look for FF bytes.
+		if (!((~v - 0x01010101) & v & 0x80808080)) {
+			VDWriteUnalignedBEU32(mpDst, v);
+			mpDst += 4;
+		} else {
+			for(int shift=24; shift>=0; shift -= 8) {
+				const uint8 c = (uint8)(v >> shift);
+
+				*mpDst++ = c;
+				if (c == 0xFF)
+					*mpDst++ = 0;
+			}
+		}
+	}
+
+	void VDJPEGBitWriter::Grow(uint32 bytes) {
+		const size_t pos = mpDst - mOutput.data();
+		size_t newSize = mOutput.size() * 2;
+
+		if (newSize < pos + bytes)
+			newSize = pos + bytes;
+
+		mOutput.resize(newSize);
+		mpDst = mOutput.data() + pos;
+		mpDstLimit = mOutput.data() + newSize;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Band encoder
+//
+//	Encodes a band of MCU rows into its own entropy-coded segment. In
+//	parallel mode, every MCU row is a restart interval: it begins with
+//	fresh DC predictors and, except for the first one, a restart marker,
+//	so the bands can be encoded as a band task and simply joined.
+//	The marker numbers depend only on the MCU row, so the output does not
+//	depend on the number of bands.
+//
+//	When Huffman tables are optimized, the bands are run twice: once to
+//	quantize the blocks and gather statistics, and once to write the
+//	quantized blocks with the tables built from the combined statistics.
+//
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	struct JPEGFrameInfo {
+		const uint8	*mpSrc;
+		ptrdiff_t	mSrcPitch;
+		int			mFormat;
+		int			mWidth;
+		int			mHeight;
+		int			mChromaMode;
+		int			mMCUWidth;
+		int			mMCUHeight;
+		int			mMCUBlocks;
+		int			mMCUCountX;
+		bool		mbRestartRows;
+
+		const int		(*mpQuant)[64];
+		const uint32	(*mpInvQuant)[64];
+		const unsigned	(*mpDCEncode)[16][2];
+		const unsigned	(*mpACEncode)[256][2];
+		const JPEGEncodeFunctions *mpFunctions;
+	};
+
+	class VDJPEGBandEncoder {
+	public:
+		enum {
+			kMaxBands = 8,
+			kMinBandPixels = 65536,
+			kMaxBlockBytes = 448		// 27 bits for DC and each AC coefficient, doubled for byte stuffing
+		};
+
+		enum Pass {
+			kPassEncode,		// encode with the stock Huffman tables
+			kPassTally,			// quantize and gather Huffman statistics
+			kPassEmit			// encode tallied blocks with optimized Huffman tables
+		};
+
+		VDJPEGBandEncoder() : mpFrame(NULL), mMCURow1(0), mMCURow2(0), mPass(kPassEncode), mStripWidth(0) {}
+
+		void Init(const JPEGFrameInfo& frame, int mcuRow1, int mcuRow2, bool tally);
+		void SetPass(Pass pass) { mPass = pass; }
+
+		void Run();
+
+		const VDJPEGHuffmanTable& GetDCTable(int i) const { return mDCHuffman[i]; }
+		const VDJPEGHuffmanTable& GetACTable(int i) const { return mACHuffman[i]; }
+		const uint8 *GetOutput() const { return mWriter.GetData(); }
+		uint32 GetOutputSize() const { return mWriter.GetSize(); }
+
+	protected:
+		enum {
+			RST0	= 0xD0		// restart marker 0
+		};
+
+		struct ComponentInfo {
+			int				dc;				// Current DC value
+			const int		*pQuant;		// quantization matrix
+			const uint32	*pInvQuant;		// inverse quantization matrix
+			const unsigned (*pDCEncode)[2];	// DC delta encoding table
+			const unsigned (*pACEncode)[2];	// AC coefficient encoding table
+			VDJPEGHuffmanTable	*pDCTable;
+			VDJPEGHuffmanTable	*pACTable;
+		};
+
+		void ConvertMCURow(int mcuRow);
+		void BeginMCURow(int mcuRow);
+		void EndMCURow(int mcuRow);
+
+		void QuantizeBlock(int dst[64], ComponentInfo& comp, int *coeffs);
+		void EncodeBlock(ComponentInfo& comp, int *coeffs);
+		void TallyBlock(uint32 *&pHeap, ComponentInfo& comp, int *coeffs);
+		void EmitBlock(const uint32 *&pHeap, const ComponentInfo& comp);
+
+		void PutValue(int run, int coeff, const unsigned (*enctab)[2]);
+		static uint32 TallyValue(int run, int coeff, VDJPEGHuffmanTable& hufftab);
+		static int SizeValue(int coeff);
+
+		const JPEGFrameInfo *mpFrame;
+		int		mMCURow1;
+		int		mMCURow2;
+		Pass	mPass;
+
+		ComponentInfo	mComponents[3];
+		ComponentInfo	*mpBlockComponents[6];
+		VDJPEGHuffmanTable	mDCHuffman[2];
+		VDJPEGHuffmanTable	mACHuffman[2];
+
+		int				mStripWidth;
+		vdblock<uint8>	mStripBuffer;
+		uint8			*mpYBuffer;
+		uint8			*mpCbBuffer;
+		uint8			*mpCrBuffer;
+		vdblock<uint8>	mRowBuffer;
+
+		vdfastvector<uint32>	mCoefficientHeap;
+		VDJPEGBitWriter			mWriter;
+	};
+
+	void VDJPEGBandEncoder::Init(const JPEGFrameInfo& frame, int mcuRow1, int mcuRow2, bool tally) {
+		mpFrame = &frame;
+		mMCURow1 = mcuRow1;
+		mMCURow2 = mcuRow2;
+
+		mStripWidth = (frame.mWidth + 15) & ~15;
+		mStripBuffer.resize(mStripWidth * frame.mMCUHeight * 3);
+		mpYBuffer = mStripBuffer.data();
+		mpCbBuffer = mpYBuffer + mStripWidth * frame.mMCUHeight;
+		mpCrBuffer = mpCbBuffer + mStripWidth * frame.mMCUHeight;
+
+		if (frame.mFormat != IVDJPEGEncoder::kFormatRGB32)
+			mRowBuffer.resize(frame.mWidth * 4);
+
+		for(int i=0; i<3; ++i) {
+			ComponentInfo& comp = mComponents[i];
+			const int table = i ? 1 : 0;
+
+			comp.dc			= 128*8;
+			comp.pQuant		= frame.mpQuant[table];
+			comp.pInvQuant	= frame.mpInvQuant[table];
+			comp.pDCEncode	= frame.mpDCEncode[table];
+			comp.pACEncode	= frame.mpACEncode[table];
+			comp.pDCTable	= &mDCHuffman[table];
+			comp.pACTable	= &mACHuffman[table];
+		}
+
+		const int mcu_size = frame.mMCUBlocks;
+
+		for(int i=0; i<mcu_size-2; ++i)
+			mpBlockComponents[i] = &mComponents[0];
+
+		mpBlockComponents[mcu_size-2] = &mComponents[1];
+		mpBlockComponents[mcu_size-1] = &mComponents[2];
+
+		// Allocate the buffers here on the calling thread rather than in Run().
+		// The coefficient heap has a fixed worst case. The output is sized for
+		// a byte per pixel plus one worst-case MCU row, which holds all but
+		// extreme images, so the band rarely has to grow it.
+		const int mcuRows = mcuRow2 - mcuRow1;
+
+		if (tally)
+			mCoefficientHeap.resize(65 * mcu_size * frame.mMCUCountX * mcuRows);
+
+		mWriter.Reserve(frame.mMCUCountX * (frame.mMCUWidth * frame.mMCUHeight * mcuRows + kMaxBlockBytes * mcu_size));
+	}
+
+	void VDJPEGBandEncoder::Run() {
+		const JPEGFrameInfo& frame = *mpFrame;
+		const int mcu_size = frame.mMCUBlocks;
+		const int mcu_horiz_count = frame.mMCUCountX;
+		const uint32 mcu_bytes = kMaxBlockBytes * mcu_size;
+
+		if (mPass == kPassEmit) {
+			const uint32 *pHeap = mCoefficientHeap.data();
+
+			mWriter.Init();
+
+			for(int y=mMCURow1; y<mMCURow2; ++y) {
+				BeginMCURow(y);
+
+				for(int x=0; x<mcu_horiz_count; ++x) {
+					mWriter.Reserve(mcu_bytes);
+
+					for(int block=0; block<mcu_size; ++block)
+						EmitBlock(pHeap, *mpBlockComponents[block]);
+				}
+
+				EndMCURow(y);
+			}
+
+			return;
+		}
+
+		if (mPass == kPassTally) {
+			for(int i=0; i<2; ++i) {
+				mDCHuffman[i].Init();
+				mACHuffman[i].Init();
+			}
+		} else
+			mWriter.Init();
+
+		const JPEGEncodeFunctions& fn = *frame.mpFunctions;
+		uint32 *pHeap = mCoefficientHeap.data();
+		int dct_coeff[6][64];
+
+		for(int y=mMCURow1; y<mMCURow2; ++y) {
+			ConvertMCURow(y);
+			BeginMCURow(y);
+
+			const uint8 *ysrc = mpYBuffer;
+			const uint8 *cbsrc = mpCbBuffer;
+			const uint8 *crsrc = mpCrBuffer;
+			const ptrdiff_t pitch = mStripWidth;
+
+			for(int x=0; x<mcu_horiz_count; ++x) {
+				switch(frame.mChromaMode) {
+				case IVDJPEGEncoder::kYCC420:
+					fn.mpFDCT(dct_coeff[0], ysrc, pitch);
+					fn.mpFDCT(dct_coeff[1], ysrc+8, pitch);
+					fn.mpFDCT(dct_coeff[2], ysrc+(pitch<<3), pitch);
+					fn.mpFDCT(dct_coeff[3], ysrc+(pitch<<3)+8, pitch);
+					fn.mpFDCT(dct_coeff[4], cbsrc, pitch*2);
+					fn.mpFDCT(dct_coeff[5], crsrc, pitch*2);
+					ysrc += 16;
+					break;
+				case IVDJPEGEncoder::kYCC422:
+					fn.mpFDCT(dct_coeff[0], ysrc, pitch);
+					fn.mpFDCT(dct_coeff[1], ysrc+8, pitch);
+					fn.mpFDCT(dct_coeff[2], cbsrc, pitch);
+					fn.mpFDCT(dct_coeff[3], crsrc, pitch);
+					ysrc += 16;
+					break;
+				case IVDJPEGEncoder::kYCC444:
+					fn.mpFDCT(dct_coeff[0], ysrc, pitch);
+					fn.mpFDCT(dct_coeff[1], cbsrc, pitch);
+					fn.mpFDCT(dct_coeff[2], crsrc, pitch);
+					ysrc += 8;
+					break;
+				}
+
+				crsrc += 8;
+				cbsrc += 8;
+
+				if (mPass == kPassTally) {
+					for(int block=0; block<mcu_size; ++block)
+						TallyBlock(pHeap, *mpBlockComponents[block], dct_coeff[block]);
+				} else {
+					mWriter.Reserve(mcu_bytes);
+
+					for(int block=0; block<mcu_size; ++block)
+						EncodeBlock(*mpBlockComponents[block], dct_coeff[block]);
+				}
+			}
+
+			EndMCURow(y);
+		}
+	}
+
+	void VDJPEGBandEncoder::ConvertMCURow(int mcuRow) {
+		const JPEGFrameInfo& frame = *mpFrame;
+		const JPEGEncodeFunctions& fn = *frame.mpFunctions;
+		const int w = frame.mWidth;
+		const int mcu_height = frame.mMCUHeight;
+		const int y1 = mcuRow * mcu_height;
+		const int srch = std::min<int>(mcu_height, frame.mHeight - y1);
+		const uint8 *src = frame.mpSrc + frame.mSrcPitch * y1;
+
+		for(int y=0; y<srch; ++y) {
+			const uint8 *row = src;
+
+			switch(frame.mFormat) {
+			case IVDJPEGEncoder::kFormatRGB15:
+				JPEGExpandRowRGB15(mRowBuffer.data(), src, w);
+				row = mRowBuffer.data();
+				break;
+			case IVDJPEGEncoder::kFormatRGB24:
+				JPEGExpandRowRGB24(mRowBuffer.data(), src, w);
+				row = mRowBuffer.data();
+				break;
+			}
+
+			uint8 *yp = mpYBuffer + mStripWidth*y;
+			uint8 *cbp = mpCbBuffer + mStripWidth*y;
+			uint8 *crp = mpCrBuffer + mStripWidth*y;
+
+			fn.mpConvertRow(yp, cbp, crp, row, w);
+
+			// replicate Y/C right
+			if (w < mStripWidth) {
+				memset(yp + w, yp[w-1], mStripWidth - w);
+				memset(cbp + w, cbp[w-1], mStripWidth - w);
+				memset(crp + w, crp[w-1], mStripWidth - w);
+			}
+
+			src += frame.mSrcPitch;
+		}
+
+		// replicate Y/C down
+		for(int ypad = srch; ypad < mcu_height; ++ypad) {
+			memcpy(mpYBuffer  + mStripWidth*ypad, mpYBuffer  + mStripWidth*(srch-1), mStripWidth);
+			memcpy(mpCbBuffer + mStripWidth*ypad, mpCbBuffer + mStripWidth*(srch-1), mStripWidth);
+			memcpy(mpCrBuffer + mStripWidth*ypad, mpCrBuffer + mStripWidth*(srch-1), mStripWidth);
+		}
+
+		// Downsample the whole strip, including the replicated pixels, so that
+		// the padding blocks are smooth. 4:2:0 chroma stays in the even rows.
+		const int qw = mStripWidth >> 1;
+
+		switch(frame.mChromaMode) {
+		case IVDJPEGEncoder::kYCC422:
+			for(int y=0; y<mcu_height; ++y) {
+				uint8 *cbp = mpCbBuffer + mStripWidth*y;
+				uint8 *crp = mpCrBuffer + mStripWidth*y;
+
+				fn.mpDownsampleRow422(cbp, cbp, qw);
+				fn.mpDownsampleRow422(crp, crp, qw);
+			}
+			break;
+		case IVDJPEGEncoder::kYCC420:
+			for(int y=0; y<mcu_height; y += 2) {
+				uint8 *cbp = mpCbBuffer + mStripWidth*y;
+				uint8 *crp = mpCrBuffer + mStripWidth*y;
+
+				fn.mpDownsampleRow420(cbp, cbp, cbp + mStripWidth, qw);
+				fn.mpDownsampleRow420(crp, crp, crp + mStripWidth, qw);
+			}
+			break;
+		}
+	}
+
+	void VDJPEGBandEncoder::BeginMCURow(int mcuRow) {
+		const bool restart = mpFrame->mbRestartRows;
+
+		if (mcuRow == mMCURow1 || restart) {
+			for(int i=0; i<3; ++i)
+				mComponents[i].dc = 128*8;
+		}
+
+		if (restart && mcuRow > 0 && mPass != kPassTally) {
+			mWriter.Reserve(2);
+			mWriter.PutMarker((uint8)(RST0 + ((mcuRow - 1) & 7)));
+		}
+	}
+
+	void VDJPEGBandEncoder::EndMCURow(int mcuRow) {
+		// pad the restart interval or band with 1 bits
+		if (mPass != kPassTally && (mpFrame->mbRestartRows || mcuRow == mMCURow2 - 1)) {
+			mWriter.Reserve(16);
+			mWriter.Pad();
+		}
+	}
+
+	int VDJPEGBandEncoder::SizeValue(int coeff) {
+		static const unsigned char kBSRLookupTable[64]={
+			0, 1, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4,
+			5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+			6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+			6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6
+		};
+
+		int value_bits = 0;
+		int mag = abs(coeff);
+
+		while(mag >= 64) {
+			mag >>= 6;
+			value_bits += 6;
+		}
+
+		value_bits += kBSRLookupTable[mag];
+
+		return value_bits;
+	}
+
+	inline void VDJPEGBandEncoder::PutValue(int run, int coeff, const unsigned (*enctab)[2]) {
+		int value_bits = 0;
+
+		if (coeff) {
+			value_bits = SizeValue(coeff);
+
+			coeff += (coeff>>31);
+			coeff &= (1<<value_bits)-1;
+		}
+
+		const unsigned *enc = enctab[(run << 4) + value_bits];
+
+		mWriter.Put((enc[0] << value_bits) + coeff, enc[1] + value_bits);
+	}
+
+	uint32 VDJPEGBandEncoder::TallyValue(int run, int coeff, VDJPEGHuffmanTable& hufftab) {
+		int code = run << 4;
+		int value_bits = 0;
+
+		if (coeff) {
+			value_bits = SizeValue(coeff);
+
+			coeff += (coeff>>31);
+			coeff &= (1<<value_bits)-1;
+		}
+
+		code += value_bits;
+
+		hufftab.Tally((uint8)(code));
+
+		return code + (coeff<<16);
+	}
+
+	// The quantized coefficients are left in natural order; the entropy
+	// coders below read them back in zigzag order.
+	void VDJPEGBandEncoder::QuantizeBlock(int dst[64], ComponentInfo& comp, int *coeffs) {
+		coeffs[0] -= comp.dc;
+		mpFrame->mpFunctions->mpQuantize(dst, coeffs, comp.pInvQuant);
+		comp.dc += dst[0] * comp.pQuant[0];
+	}
+
+	void VDJPEGBandEncoder::EncodeBlock(ComponentInfo& comp, int *coeffs) {
+		const unsigned (*pACEncode)[2] = comp.pACEncode;
+		int tmp[64];
+
+		QuantizeBlock(tmp, comp, coeffs);
+
+		// Encode DC coefficient.
+
+		PutValue(0, tmp[0], comp.pDCEncode);
+
+		// RLE and Huffman-compress AC coefficients.
+
+		int run = 0;
+
+		for(int co=1; co<64; ++co) {
+			const int v = tmp[zigzag[co]];
+
+			if (!v)
+				++run;
+			else {
+				while(run >= 16) {
+					run -= 16;
+
+					PutValue(15, 0, pACEncode);	// 0xF0 is a special code for skip 16
+				}
+
+				PutValue(run, v, pACEncode);
+				run = 0;
+			}
+		}
+
+		// Write out end-of-block (0x00) if AC coefficient 63 was zero.
+
+		if (run)
+			PutValue(0, 0, pACEncode);
+	}
+
+	void VDJPEGBandEncoder::TallyBlock(uint32 *&pHeap, ComponentInfo& comp, int *coeffs) {
+		VDJPEGHuffmanTable& actable = *comp.pACTable;
+		int tmp[64];
+
+		QuantizeBlock(tmp, comp, coeffs);
+
+		*pHeap++ = TallyValue(0, tmp[0], *comp.pDCTable);
+
+		int run = 0;
+
+		for(int co=1; co<64; ++co) {
+			const int v = tmp[zigzag[co]];
+
+			if (!v)
+				++run;
+			else {
+				while(run >= 16) {
+					run -= 16;
+
+					*pHeap++ = TallyValue(15, 0, actable);	// 0xF0 is a special code for skip 16
+				}
+
+				*pHeap++ = TallyValue(run, v, actable);
+				run = 0;
+			}
+		}
+
+		if (run)
+			*pHeap++ = TallyValue(0, 0, actable);
+
+		*pHeap++ = 0xFFFFFFFFU;
+	}
+
+	void VDJPEGBandEncoder::EmitBlock(const uint32 *&pHeap, const ComponentInfo& comp) {
+		const unsigned (*pACEncode)[2] = comp.pACEncode;
+		const unsigned *enc;
+		uint32 v;
+
+		v = *pHeap++;
+		enc = comp.pDCEncode[v & 0xff];
+		mWriter.Put((enc[0] << (v & 15)) + (v >> 16), enc[1] + (v & 15));
+
+		while(0xFFFFFFFFU != (v = *pHeap++)) {
+			enc = pACEncode[v & 0xff];
+			mWriter.Put((enc[0] << (v & 15)) + (v >> 16), enc[1] + (v & 15));
+		}
+	}
+
+	class VDJPEGBandTask : public VDBandTask {
+	public:
+		VDJPEGBandTask(VDJPEGBandEncoder *bands) : mpBands(bands) {}
+
+		void RunBand(uint32 band, uint32 bandCount) {
+			mpBands[band].Run();
+		}
+
+	protected:
+		VDJPEGBandEncoder *const mpBands;
+	};
+
+	void JPEGRunBands(VDJPEGBandEncoder *bands, int bandCount, VDJPEGBandEncoder::Pass pass) {
+		for(int i=0; i<bandCount; ++i)
+			bands[i].SetPass(pass);
+
+		VDJPEGBandTask task(bands);
+
+		VDRunBandTask(task, bandCount);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+class VDJPEGEncoder : public IVDJPEGEncoder {
+public:
+	VDJPEGEncoder();
+
+	void SetParallelMode(bool enable);
+
+	// Quality ranges 0-100, higher is better image.
+	void Init(int quality = 50, bool bOptimizeHuffmanTables = false, eChromaMode cmode = kYCC420);
+	void Encode(vdfastvector<char>& dst, const char *src, ptrdiff_t srcpitch, int format, int w, int h);
+
+protected:
+	enum {
+		SOF0	= 0xC0,		// start of frame (baseline JPEG)
+		DHT		= 0xC4,		// define huffman tables
+		SOI		= 0xD8,		// start of image
+		EOI		= 0xD9,		// end of image
+		SOS		= 0xDA,		// start of scan
+		DQT		= 0xDB,		// define quantization tables
+		DRI		= 0xDD,		// define restart interval
+		APP0	= 0xE0
+	};
+
+	int	mQuant[2][64];				// Quantization matrices
+	uint32	mInvQuant[2][64];			// Inverse quantization matrices
+	unsigned mDCEncode[2][16][2];	// DC encoding tables - (data,bits) pairs
+	unsigned mACEncode[2][256][2];	// AC encoding tables - (data,bits) pairs
+
+	VDJPEGHuffmanTable	mACHuffman[2];
+	VDJPEGHuffmanTable	mDCHuffman[2];
+
+	eChromaMode	mChromaMode;
+
+	bool				mbOptimizeHuffmanTables;
+	bool				mbParallel;
+
+	vdfastvector<char> *mpDst;
+
+	void WriteChar(unsigned char c);
+	void WriteBlock(const void *block, int block_len);
+	void WriteHeader(int w, int h, bool bWriteCustomDHT, int restartInterval);
+
+	void dht_to_encoding_table(unsigned (*enctab)[2], const unsigned char *dht_seg);
+
+	static const unsigned char stock_Huffman_DC0[];
+	static const unsigned char stock_Huffman_DC1[];
+	static const unsigned char stock_Huffman_AC0[];
+	static const unsigned char stock_Huffman_AC1[];
+};
+
+const unsigned char VDJPEGEncoder::stock_Huffman_DC0[]={
+	0x00,0x01,0x05,0x01,0x01,0x01,0x01,0x01,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0A,0x0B
+};
+
+const unsigned char VDJPEGEncoder::stock_Huffman_DC1[]={
+	0x00,0x03,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0A,0x0B
+};
+
+const unsigned char VDJPEGEncoder::stock_Huffman_AC0[]={
+	0x00,0x02,0x01,0x03,0x03,0x02,0x04,0x03,0x05,0x05,0x04,0x04,0x00,0x00,0x01,0x7D,
+	0x01,0x02,0x03,0x00,0x04,0x11,0x05,0x12,0x21,0x31,0x41,0x06,0x13,0x51,0x61,
+	0x07,0x22,0x71,0x14,0x32,0x81,0x91,0xA1,0x08,0x23,0x42,0xB1,0xC1,0x15,0x52,0xD1,0xF0,0x24,
+	0x33,0x62,0x72,0x82,0x09,0x0A,0x16,0x17,0x18,0x19,0x1A,0x25,0x26,0x27,0x28,0x29,0x2A,0x34,
+	0x35,0x36,0x37,0x38,0x39,0x3A,0x43,0x44,0x45,0x46,0x47,0x48,0x49,0x4A,0x53,0x54,0x55,0x56,
+	0x57,0x58,0x59,0x5A,0x63,0x64,0x65,0x66,0x67,0x68,0x69,0x6A,0x73,0x74,0x75,0x76,0x77,0x78,
+	0x79,0x7A,0x83,0x84,0x85,0x86,0x87,0x88,0x89,0x8A,0x92,0x93,0x94,0x95,0x96,0x97,0x98,0x99,
+	0x9A,0xA2,0xA3,0xA4,0xA5,0xA6,0xA7,0xA8,0xA9,0xAA,0xB2,0xB3,0xB4,0xB5,0xB6,0xB7,0xB8,0xB9,
+	0xBA,0xC2,0xC3,0xC4,0xC5,0xC6,0xC7,0xC8,0xC9,0xCA,0xD2,0xD3,0xD4,0xD5,0xD6,0xD7,0xD8,0xD9,
+	0xDA,0xE1,0xE2,0xE3,0xE4,0xE5,0xE6,0xE7,0xE8,0xE9,0xEA,0xF1,0xF2,0xF3,0xF4,0xF5,0xF6,0xF7,
+	0xF8,0xF9,0xFA
+};
+
+const unsigned char VDJPEGEncoder::stock_Huffman_AC1[]={
+	0x00,0x02,0x01,0x02,0x04,0x04,0x03,0x04,0x07,0x05,0x04,0x04,0x00,0x01,0x02,0x77,
+	0x00,0x01,0x02,0x03,0x11,0x04,0x05,0x21,0x31,0x06,0x12,0x41,0x51,0x07,0x61,0x71,
+	0x13,0x22,0x32,0x81,0x08,0x14,0x42,0x91,0xA1,0xB1,0xC1,0x09,0x23,0x33,0x52,0xF0,0x15,0x62,
+	0x72,0xD1,0x0A,0x16,0x24,0x34,0xE1,0x25,0xF1,0x17,0x18,0x19,0x1A,0x26,0x27,0x28,0x29,0x2A,
+	0x35,0x36,0x37,0x38,0x39,0x3A,0x43,0x44,0x45,0x46,0x47,0x48,0x49,0x4A,0x53,0x54,0x55,0x56,
+	0x57,0x58,0x59,0x5A,0x63,0x64,0x65,0x66,0x67,0x68,0x69,0x6A,0x73,0x74,0x75,0x76,0x77,0x78,
+	0x79,0x7A,0x82,0x83,0x84,0x85,0x86,0x87,0x88,0x89,0x8A,0x92,0x93,0x94,0x95,0x96,0x97,0x98,
+	0x99,0x9A,0xA2,0xA3,0xA4,0xA5,0xA6,0xA7,0xA8,0xA9,0xAA,0xB2,0xB3,0xB4,0xB5,0xB6,0xB7,0xB8,
+	0xB9,0xBA,0xC2,0xC3,0xC4,0xC5,0xC6,0xC7,0xC8,0xC9,0xCA,0xD2,0xD3,0xD4,0xD5,0xD6,0xD7,0xD8,
+	0xD9,0xDA,0xE2,0xE3,0xE4,0xE5,0xE6,0xE7,0xE8,0xE9,0xEA,0xF2,0xF3,0xF4,0xF5,0xF6,0xF7,0xF8,
+	0xF9,0xFA
+};
+
+IVDJPEGEncoder *VDCreateJPEGEncoder() {
+	return new VDJPEGEncoder;
+}
+
+VDJPEGEncoder::VDJPEGEncoder()
+	: mChromaMode(kYCC420)
+	, mbOptimizeHuffmanTables(false)
+	, mbParallel(false)
+	, mpDst(NULL)
+{
+}
+
+void VDJPEGEncoder::SetParallelMode(bool enable) {
+	mbParallel = enable;
+}
+
+void VDJPEGEncoder::dht_to_encoding_table(unsigned (*enctab)[2], const unsigned char *dht_seg) {
+	unsigned code = 0;
+	unsigned inc = 0x8000;
+
+	const unsigned char *pCounts = dht_seg;
+	const unsigned char *pCodes = dht_seg + 16;
+
+	for(int bits=1; bits<=16; ++bits) {
+		int count = *pCounts++;
+
+		while(count--) {
+			int v = *pCodes++;
+
+			enctab[v][0] = code >> (16-bits);
+			enctab[v][1] = bits;
+			code += inc;
+		}
+
+		inc >>= 1;
+	}
+}
+
+void VDJPEGEncoder::WriteChar(unsigned char c) {
+	mpDst->push_back(c);
+}
+
+void VDJPEGEncoder::WriteBlock(const void *block, int block_len) {
+	mpDst->insert(mpDst->end(), (const char *)block, (const char *)block + block_len);
+}
+
+void VDJPEGEncoder::Init(int q, bool bOptimizeHuffmanTables, eChromaMode cmode) {
+
+	mbOptimizeHuffmanTables = bOptimizeHuffmanTables;
+
+	mDCHuffman[0].Init();
+	mDCHuffman[1].Init();
+	mACHuffman[0].Init();
+	mACHuffman[1].Init();
+
+	static const unsigned char base_quant_Y[64] = {
+		16, 11, 10, 16,  24,  40,  51,  61,
+		12, 12, 14, 19,  26,  58,  60,  55,
+		14, 13, 16, 24,  40,  57,  69,  56,
+		14, 17, 22, 29,  51,  87,  80,  62,
+		18, 22, 37, 56,  68, 109, 103,  77,
+		24, 35, 55, 64,  81, 104, 113,  92,
+		49, 64, 78, 87, 103, 121, 120, 101,
+		72, 92, 95, 98, 112, 100, 103,  99,
+	};
+
+	static const unsigned char base_quant_C[64] = {
+		17, 18, 24, 47, 99, 99, 99, 99,
+		18, 21, 26, 66, 99, 99, 99, 99,
+		24, 26, 56, 99, 99, 99, 99, 99,
+		47, 66, 99, 99, 99, 99, 99, 99,
+		99, 99, 99, 99, 99, 99, 99, 99,
+		99, 99, 99, 99, 99, 99, 99, 99,
+		99, 99, 99, 99, 99, 99, 99, 99,
+		99, 99, 99, 99, 99, 99, 99, 99,
+	};
+
+	// Scale the base quantizers into the target ones.  We use the same
+	// ramp as Tom Lane's IJG library, to match scales that people are
+	// used to.
+
+	const int scale = q<50 ? 5000/q : 200-(q+q);
+	int i, j;
+
+	for(i=0; i<64; ++i) {
+		int v = (base_quant_Y[i] * scale + 50) / 100;
+
+		if (v < 1)
+			v = 1;
+		if (v > 255)
+			v = 255;
+
+		mQuant[0][i] = v;
+
+		v = (base_quant_C[i] * scale + 50) / 100;
+
+		if (v < 1)
+			v = 1;
+		if (v > 255)
+			v = 255;
+
+		mQuant[1][i] = v;
+	}
+
+	// Compute inverse quantizers.
+	for(j=0; j<2; ++j)
+		for(i=0; i<64; ++i) {
+			if (mQuant[j][i] == 1)
+				mInvQuant[j][i] = 0xFFFFFFFF;
+			else
+				mInvQuant[j][i] = (uint32)(0x100000000 / mQuant[j][i]);
+		}
+
+	mChromaMode = cmode;
+}
+
+void VDJPEGEncoder::WriteHeader(int w, int h, bool bWriteCustomDHT, int restartInterval) {
+	WriteChar(0xff);
+	WriteChar(SOI);
+
+	///////////////////////////////////////
+	//
+	// JFIF header
+	//
+	///////////////////////////////////////
+
+	static const struct JFIF_header_t {
+		unsigned char	marker;
+		unsigned char	type;
+		unsigned char	length_hi, length_lo;
+		char			tag[5];
+		unsigned char	major_version, minor_version;
+		unsigned char	units;
+		unsigned char	xaspect_hi, xaspect_lo;
+		unsigned char	yaspect_hi, yaspect_lo;
+		unsigned char	thumbnail_width;
+		unsigned char	thumbnail_height;
+	} JFIF_hdr={
+		0xff,
+		APP0,
+		0,16,		// length = 16 (including length but excluding APP0)
+		"JFIF",		// "JFIF\0"
+		1,2,		// rev 1.02
+		0,			// no units (specify aspect ratio)
+		0,1,		// Xaspect = 1
+		0,1,		// Yaspect = 1
+		0,			// thumbnail width = 0
+		0,			// thumbnail height = 0
+	};
+
+	WriteBlock(&JFIF_hdr, sizeof JFIF_hdr);
+
+	///////////////////////////////////////
+	//
+	// define huffman tables (DHT)
+	//
+	// for now, we use standard MJPEG tables
+	//
+	///////////////////////////////////////
+
+	if (bWriteCustomDHT) {
+		int dc0_len = mDCHuffman[0].GetDHTSegmentLen();
+		int dc1_len = mDCHuffman[1].GetDHTSegmentLen();
+		int ac0_len = mACHuffman[0].GetDHTSegmentLen();
+		int ac1_len = mACHuffman[1].GetDHTSegmentLen();
+
+		WriteChar(0xff);
+		WriteChar(DHT);
+		int len = dc0_len + dc1_len + ac0_len + ac1_len + 6;
+		WriteChar((uint8)(len>>8));		// length = xx (including length but excluding DHT)
+		WriteChar((uint8)len);
+
+		WriteChar(0x00);	// target DC table 0
+
+		WriteBlock(mDCHuffman[0].GetDHTSegment(), dc0_len);
+
+		WriteChar(0x01);	// target DC table 1
+
+		WriteBlock(mDCHuffman[1].GetDHTSegment(), dc1_len);
+
+		WriteChar(0x10);	// target AC table 0
+
+		WriteBlock(mACHuffman[0].GetDHTSegment(), ac0_len);
+
+		WriteChar(0x11);	// target AC table 1
+
+		WriteBlock(mACHuffman[1].GetDHTSegment(), ac1_len);
+	} else {
+		int dc0_len = sizeof stock_Huffman_DC0;
+		int dc1_len = sizeof stock_Huffman_DC1;
+		int ac0_len = sizeof stock_Huffman_AC0;
+		int ac1_len = sizeof stock_Huffman_AC1;
+
+		WriteChar(0xff);
+		WriteChar(DHT);
+		int len = dc0_len + dc1_len + ac0_len + ac1_len + 6;
+		WriteChar((uint8)(len>>8));		// length = xx (including length but excluding DHT)
+		WriteChar((uint8)len);
+
+		WriteChar(0x00);	// target DC table 0
+
+		WriteBlock(stock_Huffman_DC0, dc0_len);
+
+		WriteChar(0x01);	// target DC table 1
+
+		WriteBlock(stock_Huffman_DC1, dc1_len);
+
+		WriteChar(0x10);	// target AC table 0
+
+		WriteBlock(stock_Huffman_AC0, ac0_len);
+
+		WriteChar(0x11);	// target AC table 1
+
+		WriteBlock(stock_Huffman_AC1, ac1_len);
+	}
+
+
+	///////////////////////////////////////
+	//
+	// define quantization tables (DQT)
+	//
+	///////////////////////////////////////
+
+	WriteChar(0xff);
+	WriteChar(DQT);
+	WriteChar(0);		// length = 132 (including length but excluding DQT)
+	WriteChar(132);
+	WriteChar(0x00);	// precision = 8 bits, define table 0 (Y)
+
+	int i;
+
+	for(i=0; i<64; ++i)
+		WriteChar((uint8)mQuant[0][zigzag[i]]);
+
+	WriteChar(0x01);	// precision = 8 bits, define table 1 (C)
+
+	for(i=0; i<64; ++i)
+		WriteChar((uint8)mQuant[1][zigzag[i]]);
+
+	///////////////////////////////////////
+	//
+	// start of baseline frame (SOF0)
+	//
+	///////////////////////////////////////
+
+	struct frame_header_t {
+		unsigned char	marker;
+		unsigned char	type;
+		unsigned char	length_hi, length_lo;
+		unsigned char	precision;
+		unsigned char	width_hi, width_lo;
+		unsigned char	height_hi, height_lo;
+		unsigned char	component_count;
+
+		struct component_info_t {
+			unsigned char	id;
+			unsigned char	sampling;
+			unsigned char	quant;
+		} components[3];
+	} frame_hdr={
+		0xff,
+		SOF0,
+		0,		// length = 17 (including length but excluding SOF)
+		17,
+		8,		// 8-bit samples
+		(uint8)(h>>8),	// height
+		(uint8)(h&255),
+		(uint8)(w>>8),	// width
+		(uint8)(w&255),
+		3,		// three components
+
+		// first component (Y)
+		1,		// component identifier
+		0x22,	// 2x2 = 4 blocks per MCU
+		0,		// select quantization table 0
+
+		// second component (Cb)
+		2,		// component identifier
+		0x11,	// 1x1 = 1 block per MCU
+		1,		// select quantization table 1
+
+		// third component (Cr)
+		3,		// component identifier
+		0x11,	// 1x1 = 1 block per MCU
+		1,		// select quantization table 1
+	};
+
+	switch(mChromaMode) {
+	case kYCC444:
+		frame_hdr.components[0].sampling = 0x11;
+		break;
+	case kYCC422:
+		frame_hdr.components[0].sampling = 0x21;
+		break;
+	case kYCC420:
+		frame_hdr.components[0].sampling = 0x22;
+		break;
+	}
+
+	WriteBlock(&frame_hdr, sizeof frame_hdr);
+
+	///////////////////////////////////////
+	//
+	// define restart interval (DRI)
+	//
+	///////////////////////////////////////
+
+	if (restartInterval) {
+		WriteChar(0xff);
+		WriteChar(DRI);
+		WriteChar(0);		// length = 4 (including length but excluding DRI)
+		WriteChar(4);
+		WriteChar((uint8)(restartInterval >> 8));
+		WriteChar((uint8)restartInterval);
+	}
+
+	///////////////////////////////////////
+	//
+	// start of scan (SOS)
+	//
+	///////////////////////////////////////
+
+	static const struct scan_info_t {
+		unsigned char	marker;
+		unsigned char	type;
+		unsigned char	length_hi, length_lo;
+		unsigned char	component_count;
+
+		struct component_info_t {
+			unsigned char id;
+			unsigned char table_select;
+		} components[3];
+
+		unsigned char	first_coeff;
+		unsigned char	last_coeff;
+		unsigned char	approx_bounds;
+	} scan_hdr={
+		0xff,
+		SOS,
+		0,		// length = 12 (including length but excluding SOS)
+		12,
+		3,		// three components
+		1,		// first component is Y
+		0x00,	// use DC table 0 and AC table 0
+		2,		// second component is Cb
+		0x11,	// use DC table 1 and AC table 1
+		3,		// third component is Cr
+		0x11,	// use DC table 1 and AC table 1
+		0,		// first spectral component (must be 0 for baseline)
+		63,		// last spectral component (must be 63 for baseline)
+		0x00,	// successive approximation values (must be 0 for sequential)
+	};
+
+	WriteBlock(&scan_hdr, sizeof scan_hdr);
+}
+
+void VDJPEGEncoder::Encode(vdfastvector<char>& dst, const char *src, ptrdiff_t srcpitch, int format, int w, int h) {
+	mpDst = &dst;
+
+	JPEGFrameInfo frame;
+
+	frame.mpSrc			= (const uint8 *)src;
+	frame.mSrcPitch		= srcpitch;
+	frame.mFormat		= format;
+	frame.mWidth		= w;
+	frame.mHeight		= h;
+	frame.mChromaMode	= mChromaMode;
+	frame.mpQuant		= mQuant;
+	frame.mpInvQuant	= mInvQuant;
+	frame.mpDCEncode	= mDCEncode;
+	frame.mpACEncode	= mACEncode;
+	frame.mpFunctions	= &JPEGGetEncodeFunctions();
+
+	switch(mChromaMode) {
+	case kYCC420:
+		frame.mMCUWidth = 16;
+		frame.mMCUHeight = 16;
+		frame.mMCUBlocks = 6;
+		break;
+
+	case kYCC422:
+		frame.mMCUWidth = 16;
+		frame.mMCUHeight = 8;
+		frame.mMCUBlocks = 4;
+		break;
+
+	case kYCC444:
+		frame.mMCUWidth = 8;
+		frame.mMCUHeight = 8;
+		frame.mMCUBlocks = 3;
+		break;
+	}
+
+	frame.mMCUCountX = (w + frame.mMCUWidth - 1) / frame.mMCUWidth;
+
+	const int mcu_vert_count = (h + frame.mMCUHeight - 1) / frame.mMCUHeight;
+
+	frame.mbRestartRows = mbParallel && mcu_vert_count > 1;
+
+	int bandCount = 1;
+
+	if (mbParallel)
+		bandCount = (int)VDGetBandCount((uint64)w * h, VDJPEGBandEncoder::kMinBandPixels, VDJPEGBandEncoder::kMaxBands, mcu_vert_count);
+
+	vdautoarrayptr<VDJPEGBandEncoder> bands(new VDJPEGBandEncoder[bandCount]);
+
+	for(int i=0; i<bandCount; ++i)
+		bands[i].Init(frame, mcu_vert_count * i / bandCount, mcu_vert_count * (i + 1) / bandCount, mbOptimizeHuffmanTables);
+
+	const int restartInterval = frame.mbRestartRows ? frame.mMCUCountX : 0;
+
+	if (!mbOptimizeHuffmanTables) {
+		dht_to_encoding_table(mDCEncode[0], stock_Huffman_DC0);
+		dht_to_encoding_table(mACEncode[0], stock_Huffman_AC0);
+		dht_to_encoding_table(mDCEncode[1], stock_Huffman_DC1);
+		dht_to_encoding_table(mACEncode[1], stock_Huffman_AC1);
+
+		JPEGRunBands(bands.get(), bandCount, VDJPEGBandEncoder::kPassEncode);
+
+		WriteHeader(w, h, false, restartInterval);
+	} else {
+		JPEGRunBands(bands.get(), bandCount, VDJPEGBandEncoder::kPassTally);
+
+		for(int i=0; i<2; ++i) {
+			mDCHuffman[i].Init();
+			mACHuffman[i].Init();
+
+			for(int j=0; j<bandCount; ++j) {
+				mDCHuffman[i].Add(bands[j].GetDCTable(i));
+				mACHuffman[i].Add(bands[j].GetACTable(i));
+			}
+		}
+
+		mDCHuffman[0].BuildCode();
+		mACHuffman[0].BuildCode();
+		mDCHuffman[1].BuildCode();
+		mACHuffman[1].BuildCode();
+
+		for(int i=0; i<16; ++i)
+			mDCEncode[0][i][1] = mDCEncode[1][i][1] = -1;
+
+		for(int j=0; j<256; ++j)
+			mACEncode[0][j][1] = mACEncode[1][j][1] = -1;
+
+		dht_to_encoding_table(mDCEncode[0], mDCHuffman[0].GetDHTSegment());
+		dht_to_encoding_table(mACEncode[0], mACHuffman[0].GetDHTSegment());
+		dht_to_encoding_table(mDCEncode[1], mDCHuffman[1].GetDHTSegment());
+		dht_to_encoding_table(mACEncode[1], mACHuffman[1].GetDHTSegment());
+
+		JPEGRunBands(bands.get(), bandCount, VDJPEGBandEncoder::kPassEmit);
+
+		WriteHeader(w, h, true, restartInterval);
+	}
+
+	///////////////////////////////////////
+	//
+	// entropy coded data
+	//
+	///////////////////////////////////////
+
+	for(int i=0; i<bandCount; ++i)
+		WriteBlock(bands[i].GetOutput(), bands[i].GetOutputSize());
+
+	///////////////////////////////////////
+	//
+	// end of image (EOI)
+	//
+	///////////////////////////////////////
+
+	WriteChar(0xFF);
+	WriteChar(EOI);
+}
@@ -83,6 +83,7 @@ protected:
 	};
 
 	float			mL3Pow43Tab[256];			// [-128,127] ^ (4/3)
+	bool			mbL3UseSSE2;				// use SSE2 requantization, stereo and hybrid filterbank
 
 	VDMPEGAudioPolyphaseFilter	*mpPolyphaseFilter;
 
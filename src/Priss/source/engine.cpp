@@ -17,6 +17,7 @@
 
 #include <math.h>
 #include <vd2/system/vdtypes.h>
+#include <vd2/system/cpuaccel.h>
 
 #include "engine.h"
 
@@ -158,6 +159,8 @@ void VDMPEGAudioDecoder::Reset() {
 
 	mpPolyphaseFilter->Reset();
 
+	mbL3UseSSE2 = (CPUGetEnabledExtensions() & CPUF_SUPPORTS_SSE2) != 0;
+
 	mL3BufferPos = 0;
 	mL3BufferLevel = 0;
 
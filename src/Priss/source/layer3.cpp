@@ -90,6 +90,7 @@
 
 #include <math.h>
 #include <float.h>
+#include <emmintrin.h>
 #include "engine.h"
 #include "bitreader.h"
 
@@ -298,25 +299,30 @@ namespace {
 	// layer III decoding is rather rare in MPEG-1 video files and
 	// this runs fast enough.
 
-	void IMDCT_9(const float (*b)[2], float *d) {
+	// The IMDCT core is a template so that the same factorization can be
+	// run either on single floats or on four subbands at a time in SSE
+	// registers (see L3Vec4 below).
+
+	template<class T>
+	void IMDCT_9(const T *b, T *d) {
 		static const float c1 = 0.93969262078591f;	// cos(1*(pi/9))
 		static const float c2 = 0.76604444311898f;	// cos(2*(pi/9))
 		static const float c4 = 0.17364817766693f;	// cos(4*(pi/9))
 
 		// 'g' stage (5-point IDCT)
-		const float G0 = b[0][0];
-		const float G1 = b[2][0];
-		const float G2 = b[4][0];
-		const float G3 = b[6][0];
-		const float G4 = b[8][0];
-		const float x0 = G3*0.5f + G0;
-		const float x1 = G0 - G3;
-		const float x2 = G1 - G2 - G4;
-		const float g0 = x0 + c1*G1 + c2*G2 + c4*G4;
-		const float g1 = x2*0.5f + x1;
-		const float g2 = x0 - c4*G1 - c1*G2 + c2*G4;
-		const float g3 = x0 - c2*G1 + c4*G2 - c1*G4;
-		const float g4 = x1 - x2;
+		const T G0 = b[0];
+		const T G1 = b[4];
+		const T G2 = b[8];
+		const T G3 = b[12];
+		const T G4 = b[16];
+		const T x0 = G3*0.5f + G0;
+		const T x1 = G0 - G3;
+		const T x2 = G1 - G2 - G4;
+		const T g0 = x0 + c1*G1 + c2*G2 + c4*G4;
+		const T g1 = x2*0.5f + x1;
+		const T g2 = x0 - c4*G1 - c1*G2 + c2*G4;
+		const T g3 = x0 - c2*G1 + c4*G2 - c1*G4;
+		const T g4 = x1 - x2;
 
 		// 'h prime' stage (4-point IDCT)
 		static const float odd[4]={
@@ -333,16 +339,16 @@ namespace {
 			-1.37373870972731f,
 		};
 
-		const float H0 = b[1][0];
-		const float H1 = b[1][0] + b[3][0];
-		const float H2 = b[3][0] + b[5][0];
-		const float H3 = b[5][0] + b[7][0];
-		const float y0 = H3*0.5f + H0;
-		const float y1 = H1 - H2;
-		const float h0 = odd[0]*(y0 + c1*H1 + c2*H2) + b[7][0]*covals[0];
-		const float h1 = odd[1]*(0.5f*y1 + H0 - H3)  + b[7][0]*covals[1];
-		const float h2 = odd[2]*(y0 - c4*H1 - c1*H2) + b[7][0]*covals[2];
-		const float h3 = odd[3]*(y0 - c2*H1 + c4*H2) + b[7][0]*covals[3];
+		const T H0 = b[2];
+		const T H1 = b[2] + b[6];
+		const T H2 = b[6] + b[10];
+		const T H3 = b[10] + b[14];
+		const T y0 = H3*0.5f + H0;
+		const T y1 = H1 - H2;
+		const T h0 = odd[0]*(y0 + c1*H1 + c2*H2) + b[14]*covals[0];
+		const T h1 = odd[1]*(0.5f*y1 + H0 - H3)  + b[14]*covals[1];
+		const T h2 = odd[2]*(y0 - c4*H1 - c1*H2) + b[14]*covals[2];
+		const T h3 = odd[3]*(y0 - c2*H1 + c4*H2) + b[14]*covals[3];
 
 		d[0] = g0 + h0;
 		d[1] = g1 + h1;
@@ -355,11 +361,9 @@ namespace {
 		d[8] = g0 - h0;
 	}
 
-	void IMDCT_18(const float *in, float (*out)[2][32], float *overlap, const float *window) {
-		static const float pi = 3.1415926535897932384626433832795f;
-
-		float a[18];
-		float t[18];
+	template<class T>
+	void IMDCT_18_Transform(const T *in, T *t) {
+		T a[18];
 
 		a[0] = in[0];
 		a[1] = in[0]+in[1];
@@ -389,10 +393,10 @@ namespace {
 		a[5] += a[3];
 		a[3] += a[1];
 
-		float d[18];
+		T d[18];
 
-		IMDCT_9((float(*)[2])&a[0], d);
-		IMDCT_9((float(*)[2])&a[1], d+9);
+		IMDCT_9(&a[0], d);
+		IMDCT_9(&a[1], d+9);
 		static const float coeff_9_to_18[9]={		// 1 / (2 cos((pi/36)(2i+1)))
 			0.50190991877167f,
 			0.51763809020504f,
@@ -405,7 +409,7 @@ namespace {
 			5.73685662283492f,
 		};
 
-		const float y[9]={
+		const T y[9]={
 			d[9+0] * coeff_9_to_18[0],
 			d[9+1] * coeff_9_to_18[1],
 			d[9+2] * coeff_9_to_18[2],
@@ -436,6 +440,12 @@ namespace {
 		t[16] = d[7] - y[7];
 		t[ 8] = d[8] + y[8];
 		t[17] = d[8] - y[8];
+	}
+
+	void IMDCT_18(const float *in, float (*out)[2][32], float *overlap, const float *window) {
+		float t[18];
+
+		IMDCT_18_Transform(in, t);
 
 		// multiplication to convert idct to imdct has already been folded
 		// into the windows
@@ -498,10 +508,154 @@ namespace {
 			overlap[k] = 0;
 		}
 	}
+
+	////////////////////////////////////////////////////////////
+	//
+	// SSE2 hybrid filterbank
+	//
+	// Four adjacent long-block subbands are transformed at once, one per
+	// lane.  Since each lane goes through exactly the same operations as
+	// the scalar IMDCT_18(), the results are identical to the scalar path
+	// when it is also compiled for SSE.
+
+	struct L3Vec4 {
+		__m128 v;
+	};
+
+	inline L3Vec4 operator+(const L3Vec4& x, const L3Vec4& y) { L3Vec4 r = { _mm_add_ps(x.v, y.v) }; return r; }
+	inline L3Vec4 operator-(const L3Vec4& x, const L3Vec4& y) { L3Vec4 r = { _mm_sub_ps(x.v, y.v) }; return r; }
+	inline L3Vec4& operator+=(L3Vec4& x, const L3Vec4& y) { x.v = _mm_add_ps(x.v, y.v); return x; }
+	inline L3Vec4 operator*(const L3Vec4& x, float c) { L3Vec4 r = { _mm_mul_ps(x.v, _mm_set1_ps(c)) }; return r; }
+	inline L3Vec4 operator*(float c, const L3Vec4& x) { L3Vec4 r = { _mm_mul_ps(_mm_set1_ps(c), x.v) }; return r; }
+
+	// Gather lines [0,18) of four consecutive 18-line rows into SoA form.
+	void IMDCT_18x4_Load(L3Vec4 *dst, const float *src) {
+		for(unsigned i=0; i<16; i+=4) {
+			__m128 r0 = _mm_loadu_ps(src + i);
+			__m128 r1 = _mm_loadu_ps(src + i + 18);
+			__m128 r2 = _mm_loadu_ps(src + i + 36);
+			__m128 r3 = _mm_loadu_ps(src + i + 54);
+
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+			dst[i+0].v = r0;
+			dst[i+1].v = r1;
+			dst[i+2].v = r2;
+			dst[i+3].v = r3;
+		}
+
+		dst[16].v = _mm_set_ps(src[54+16], src[36+16], src[18+16], src[16]);
+		dst[17].v = _mm_set_ps(src[54+17], src[36+17], src[18+17], src[17]);
+	}
+
+	void IMDCT_18x4_Store(float *dst, const L3Vec4 *src) {
+		for(unsigned i=0; i<16; i+=4) {
+			__m128 r0 = src[i+0].v;
+			__m128 r1 = src[i+1].v;
+			__m128 r2 = src[i+2].v;
+			__m128 r3 = src[i+3].v;
+
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+			_mm_storeu_ps(dst + i, r0);
+			_mm_storeu_ps(dst + i + 18, r1);
+			_mm_storeu_ps(dst + i + 36, r2);
+			_mm_storeu_ps(dst + i + 54, r3);
+		}
+
+		for(unsigned i=16; i<18; ++i) {
+			float tmp[4];
+
+			_mm_storeu_ps(tmp, src[i].v);
+			dst[i] = tmp[0];
+			dst[i+18] = tmp[1];
+			dst[i+36] = tmp[2];
+			dst[i+54] = tmp[3];
+		}
+	}
+
+	void IMDCT_18x4_SSE2(const float *in, float *out, float (*overlap)[18], const float *window) {
+		L3Vec4 x[18];
+		L3Vec4 t[18];
+
+		IMDCT_18x4_Load(x, in);
+		IMDCT_18_Transform(x, t);
+
+		// reuse x[] for the previous overlap
+		IMDCT_18x4_Load(x, overlap[0]);
+
+		for(unsigned k=0; k<9; ++k) {
+			_mm_storeu_ps(out + 64*k, (x[k] + t[17-k]*window[k]).v);
+			_mm_storeu_ps(out + 64*(k+9), (x[k+9] - t[k+9]*window[k+9]).v);
+		}
+
+		for(unsigned k=0; k<9; ++k) {
+			x[k] = t[8-k]*window[k+18];
+			x[k+9] = t[k]*window[k+27];
+		}
+
+		IMDCT_18x4_Store(overlap[0], x);
+	}
 #endif
 
 	////////////////////////////////////////////////////////////
 
+	static const float antialias_cs[8]={
+		0.85749292571254f,
+		0.88174199731771f,
+		0.94962864910273f,
+		0.98331459249179f,
+		0.99551781606759f,
+		0.99916055817815f,
+		0.99989919524445f,
+		0.99999315507028f
+	};
+
+	static const float antialias_ca[8]={
+		-0.51449575542753f,
+		-0.47173196856497f,
+		-0.31337745420390f,
+		-0.18191319961098f,
+		-0.09457419252642f,
+		-0.04096558288530f,
+		-0.01419856857247f,
+		-0.00369997467376f
+	};
+
+	// Alias reduction between subbands; p points to the first line of the
+	// upper subband.
+	void Antialias(float *p) {
+		for(unsigned i=0; i<8; ++i) {
+			const float x = p[-1-(int)i];
+			const float y = p[i];
+			const float cs = antialias_cs[i];
+			const float ca = antialias_ca[i];
+
+			p[-1-(int)i] = x*cs - y*ca;
+			p[i] = x*ca + y*cs;
+		}
+	}
+
+	void Antialias_SSE2(float *p) {
+		for(unsigned i=0; i<8; i+=4) {
+			const __m128 cs = _mm_loadu_ps(antialias_cs + i);
+			const __m128 ca = _mm_loadu_ps(antialias_ca + i);
+
+			// lower subband runs backwards from the boundary
+			__m128 x = _mm_loadu_ps(p - 4 - i);
+			x = _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 1, 2, 3));
+			__m128 y = _mm_loadu_ps(p + i);
+
+			__m128 xr = _mm_sub_ps(_mm_mul_ps(x, cs), _mm_mul_ps(y, ca));
+			__m128 yr = _mm_add_ps(_mm_mul_ps(x, ca), _mm_mul_ps(y, cs));
+
+			_mm_storeu_ps(p - 4 - i, _mm_shuffle_ps(xr, xr, _MM_SHUFFLE(0, 1, 2, 3)));
+			_mm_storeu_ps(p + i, yr);
+		}
+	}
+
+	////////////////////////////////////////////////////////////
+
 #if 0
 	void IMDCT_6_3(const float *in, float (*out)[2][32], float *overlap, const float *window) {
 		float t[24]={0};
@@ -801,6 +955,63 @@ namespace {
 			right[i+1] = (float)(x1-y1);
 		}
 	}
+
+	void MidSideButterfly_SSE2(float *left, float *right, uint32 n) {
+		VDASSERT(!(n & 1));
+
+		const __m128 invsqrt2 = _mm_set1_ps(0.70710678118654752440084436210485f);
+		uint32 i = 0;
+
+		for(; i+4 <= n; i += 4) {
+			const __m128 x = _mm_mul_ps(_mm_loadu_ps(left + i), invsqrt2);
+			const __m128 y = _mm_mul_ps(_mm_loadu_ps(right + i), invsqrt2);
+
+			_mm_storeu_ps(left + i, _mm_add_ps(x, y));
+			_mm_storeu_ps(right + i, _mm_sub_ps(x, y));
+		}
+
+		if (i < n)
+			MidSideButterfly(left + i, right + i, n - i);
+	}
+
+	void IntensityStereo(float *left, float *right, uint32 n, float coleft, float coright) {
+		for(uint32 i=0; i<n; ++i) {
+			const float x = left[i];
+
+			left[i] = x*coleft;
+			right[i] = x*coright;
+		}
+	}
+
+	void IntensityStereo_SSE2(float *left, float *right, uint32 n, float coleft, float coright) {
+		const __m128 cl = _mm_set1_ps(coleft);
+		const __m128 cr = _mm_set1_ps(coright);
+		uint32 i = 0;
+
+		for(; i+4 <= n; i += 4) {
+			const __m128 x = _mm_loadu_ps(left + i);
+
+			_mm_storeu_ps(left + i, _mm_mul_ps(x, cl));
+			_mm_storeu_ps(right + i, _mm_mul_ps(x, cr));
+		}
+
+		if (i < n)
+			IntensityStereo(left + i, right + i, n - i, coleft, coright);
+	}
+
+	// Requantizes the count1 region, where all values are -1, 0, or +1. The
+	// integer conversion and multiply are exact, so this matches the table
+	// lookup used by the scalar path.
+	void RequantizeCount1_SSE2(float *dst, const sint32 *src, uint32 n, float gain) {
+		const __m128 vgain = _mm_set1_ps(gain);
+		uint32 i = 0;
+
+		for(; i+4 <= n; i += 4)
+			_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(src + i))), vgain));
+
+		for(; i < n; ++i)
+			dst[i] = (float)src[i] * gain;
+	}
 }
 
 void VDMPEGAudioDecoder::PrereadLayerIII() {
@@ -832,6 +1043,7 @@ bool VDMPEGAudioDecoder::DecodeLayerIII() {
 	LayerIIISideInfo sideinfo;
 	const unsigned nch = mMode != 3 ? 2 : 1;
 	const bool is_mpeg2 = mHeader.nMPEGVer > 1;
+	const bool use_sse2 = mbL3UseSSE2;
 
 	if (is_mpeg2)
 		DecodeSideInfoMPEG2(sideinfo, mFrameBuffer, nch);
@@ -1142,11 +1354,18 @@ bool VDMPEGAudioDecoder::DecodeLayerIII() {
 						if (i >= zero_bound)
 							break;
 
-						const float recon_tab[3]={-gain, 0.f, +gain};
+						if (use_sse2) {
+							if (i < band_end) {
+								RequantizeCount1_SSE2(reconch + i, freq + i, band_end - i, gain);
+								i = band_end;
+							}
+						} else {
+							const float recon_tab[3]={-gain, 0.f, +gain};
 
-						for(; i < band_end; i += 2) {
-							reconch[i  ] = recon_tab[freq[i  ]+1];
-							reconch[i+1] = recon_tab[freq[i+1]+1];
+							for(; i < band_end; i += 2) {
+								reconch[i  ] = recon_tab[freq[i  ]+1];
+								reconch[i+1] = recon_tab[freq[i+1]+1];
+							}
 						}
 					} else {
 						for(; i < band_end; ++i) {
@@ -1260,7 +1479,10 @@ bool VDMPEGAudioDecoder::DecodeLayerIII() {
 				if (mModeExtension == 2)
 					ms_bound = 576;
 
-				MidSideButterfly(recon[0], recon[1], ms_bound);
+				if (use_sse2)
+					MidSideButterfly_SSE2(recon[0], recon[1], ms_bound);
+				else
+					MidSideButterfly(recon[0], recon[1], ms_bound);
 			}
 
 			if (mModeExtension & 1) {		// intensity stereo mode enabled
@@ -1407,23 +1629,18 @@ bool VDMPEGAudioDecoder::DecodeLayerIII() {
 							coright *= coright;
 						}
 
-						for(unsigned i = band_start; i<band_end; ++i) {
-							const float x = recon[0][i];
-
-							recon[0][i] = x*coleft;
-							recon[1][i] = x*coright;
-						}
+						if (use_sse2)
+							IntensityStereo_SSE2(recon[0] + band_start, recon[1] + band_start, band_end - band_start, coleft, coright);
+						else
+							IntensityStereo(recon[0] + band_start, recon[1] + band_start, band_end - band_start, coleft, coright);
 					} else if (mModeExtension & 2) {
 						const unsigned band_start = pLongBands[sfb];
 						const unsigned band_end = pLongBands[sfb+1];
 
-						for(unsigned i = band_start; i<band_end; ++i) {
-							const float x = recon[0][i] * invsqrt2;
-							const float y = recon[1][i] * invsqrt2;
-
-							recon[0][i] = x+y;
-							recon[1][i] = x-y;
-						}
+						if (use_sse2)
+							MidSideButterfly_SSE2(recon[0] + band_start, recon[1] + band_start, band_end - band_start);
+						else
+							MidSideButterfly(recon[0] + band_start, recon[1] + band_start, band_end - band_start);
 					}
 				}
 
@@ -1478,59 +1695,32 @@ bool VDMPEGAudioDecoder::DecodeLayerIII() {
 			if (rsi.window_switching_flag)
 				wintype = rsi.switched.block_type;
 
+			// Alias reduction is done for all subband boundaries before any
+			// of the IMDCTs; each IMDCT only depends on its own subband and
+			// both of its boundaries, so this is equivalent to interleaving.
+			const unsigned long_limit = wintype != 2 ? 32 : rsi.switched.mixed_block_flag ? 2 : 0;
+			float *const reconch = recon[ch];
+
+			for(unsigned sb=0; sb<long_limit && sb<31; ++sb) {
+				if (use_sse2)
+					Antialias_SSE2(&reconch[sb*18+18]);
+				else
+					Antialias(&reconch[sb*18+18]);
+			}
+
 			for(unsigned sb=0; sb<32; ++sb)	{
-				if (wintype == 2 && (!rsi.switched.mixed_block_flag || sb >= 2)) {
-					IMDCT_6_3(&recon[ch][sb*18], (float(*)[2][32])&subbands[0][ch][sb], mL3OverlapBuffer[ch][sb], mL3Windows[wintype]);
+				if (sb >= long_limit) {
+					IMDCT_6_3(&reconch[sb*18], (float(*)[2][32])&subbands[0][ch][sb], mL3OverlapBuffer[ch][sb], mL3Windows[wintype]);
+				} else if (sb*18 >= gr_zero_bound+35) {
+					IMDCT_18_Null((float(*)[2][32])&subbands[0][ch][sb], mL3OverlapBuffer[ch][sb]);
+				} else if (use_sse2 && !(sb & 3) && sb+4 <= long_limit) {
+					// Lines past the zero bound are zero, so running the
+					// full IMDCT on them gives the same result as the null
+					// IMDCT.
+					IMDCT_18x4_SSE2(&reconch[sb*18], &subbands[0][ch][sb], mL3OverlapBuffer[ch] + sb, mL3Windows[wintype]);
+					sb += 3;
 				} else {
-					if (sb < 31) {
-						static const float cs_tab[8]={
-							0.85749292571254f,
-							0.88174199731771f,
-							0.94962864910273f,
-							0.98331459249179f,
-							0.99551781606759f,
-							0.99916055817815f,
-							0.99989919524445f,
-							0.99999315507028f
-						};
-
-						static const float ca_tab[8]={
-							-0.51449575542753f,
-							-0.47173196856497f,
-							-0.31337745420390f,
-							-0.18191319961098f,
-							-0.09457419252642f,
-							-0.04096558288530f,
-							-0.01419856857247f,
-							-0.00369997467376f
-						};
-
-						float *p = &recon[ch][sb*18+18];
-
-						struct local {
-							static inline void antialias(float& x, float& y, float cs, float ca) {
-								const float xt = x, yt = y;
-
-								x = xt*cs - yt*ca;
-								y = xt*ca + yt*cs;
-							}
-						};
-
-						local::antialias(p[-1], p[0], cs_tab[0], ca_tab[0]);
-						local::antialias(p[-2], p[1], cs_tab[1], ca_tab[1]);
-						local::antialias(p[-3], p[2], cs_tab[2], ca_tab[2]);
-						local::antialias(p[-4], p[3], cs_tab[3], ca_tab[3]);
-						local::antialias(p[-5], p[4], cs_tab[4], ca_tab[4]);
-						local::antialias(p[-6], p[5], cs_tab[5], ca_tab[5]);
-						local::antialias(p[-7], p[6], cs_tab[6], ca_tab[6]);
-						local::antialias(p[-8], p[7], cs_tab[7], ca_tab[7]);
-					}
-
-					if (sb*18 >= gr_zero_bound+35) {
-						IMDCT_18_Null((float(*)[2][32])&subbands[0][ch][sb], mL3OverlapBuffer[ch][sb]);
-					} else {
-						IMDCT_18(&recon[ch][sb*18], (float(*)[2][32])&subbands[0][ch][sb], mL3OverlapBuffer[ch][sb], mL3Windows[wintype]);
-					}
+					IMDCT_18(&reconch[sb*18], (float(*)[2][32])&subbands[0][ch][sb], mL3OverlapBuffer[ch][sb], mL3Windows[wintype]);
 				}
 			}
 		}
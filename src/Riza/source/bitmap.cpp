@@ -118,6 +118,12 @@ int VDBitmapFormatToPixmapFormat(const VDAVIBitmapInfoHeader& hdr, int& variant)
 
 	case VDMAKEFOURCC('N', 'V', '1', '2'):
 		return kPixFormat_YUV420_NV12;
+
+	case VDMAKEFOURCC('P', '0', '1', '0'):
+		return kPixFormat_YUV420_P010;
+
+	case VDMAKEFOURCC('P', '0', '1', '6'):
+		return kPixFormat_YUV420_P016;
 	}
 	return 0;
 }
@@ -341,6 +347,16 @@ bool VDMakeBitmapFormatFromPixmapFormat(vdstructex<VDAVIBitmapInfoHeader>& dst,
 		dst->biBitCount		= 12;
 		dst->biSizeImage	= w*h + ((w+1)>>1)*((h+1)>>1)*2;
 		break;
+	case kPixFormat_YUV420_P010:
+		dst->biCompression	= VDMAKEFOURCC('P', '0', '1', '0');
+		dst->biBitCount		= 24;
+		dst->biSizeImage	= w*h*2 + ((w+1)>>1)*((h+1)>>1)*4;
+		break;
+	case kPixFormat_YUV420_P016:
+		dst->biCompression	= VDMAKEFOURCC('P', '0', '1', '6');
+		dst->biBitCount		= 24;
+		dst->biSizeImage	= w*h*2 + ((w+1)>>1)*((h+1)>>1)*4;
+		break;
 	case kPixFormat_Y8_FR:
 		dst->biCompression	= VDAVIBitmapInfoHeader::kCompressionRGB;
 		dst->biBitCount		= 8;
@@ -0,0 +1,132 @@
+#include <string.h>
+#include <vd2/system/vdtypes.h>
+#include <vd2/system/thread.h>
+#include <vd2/system/VDString.h>
+#include <vd2/system/vdstl_hashmap.h>
+
+#include "ScriptProgram.h"
+
+///////////////////////////////////////////////////////////////////////////
+
+VDScriptProgram::VDScriptProgram() {
+}
+
+int VDScriptProgram::AddConstant(const VDScriptValue& v) {
+	mConstants.push_back(v);
+	return (int)mConstants.size() - 1;
+}
+
+int VDScriptProgram::AddName(const char *s) {
+	const int n = (int)mNameOffsets.size();
+
+	for(int i=0; i<n; ++i) {
+		if (!strcmp(GetName(i), s))
+			return i;
+	}
+
+	mNameOffsets.push_back((uint32)mTextPool.size());
+	mTextPool.insert(mTextPool.end(), s, s + strlen(s) + 1);
+	return n;
+}
+
+int VDScriptProgram::AddString(const char *s, size_t len) {
+	mStringOffsets.push_back((uint32)mTextPool.size());
+	mStringLengths.push_back((uint32)len);
+	mTextPool.insert(mTextPool.end(), s, s + len);
+	mTextPool.push_back(0);
+	return (int)mStringOffsets.size() - 1;
+}
+
+void VDScriptProgram::AddOp(VDScriptOpcode op, int arg, int srcPos, const VDScriptFunctionDef *method) {
+	VDScriptInstruction& insn = mOps.push_back();
+
+	insn.mOp = op;
+	insn.mArg = arg;
+	insn.mSrcPos = srcPos;
+	insn.mpMethod = method;
+}
+
+const char *VDScriptProgram::GetString(int idx, size_t& len) const {
+	len = mStringLengths[idx];
+	return mTextPool.data() + mStringOffsets[idx];
+}
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Compiled line cache
+//
+//	Job scripts and configuration files repeat the same lines many times
+//	across runs, so compiled lines are kept for the life of the process.
+//	The cache is simply flushed when it gets too big.
+//
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	class VDScriptProgramCache {
+	public:
+		enum { kMaxPrograms = 4096 };
+
+		~VDScriptProgramCache();
+
+		bool Lookup(const char *text, VDScriptProgram **program);
+		void Add(const char *text, VDScriptProgram *program);
+
+	protected:
+		void Flush();
+
+		typedef vdhashmap<VDStringA, VDScriptProgram *, vdhash<VDStringA>, vdstringpred> Programs;
+
+		VDCriticalSection mLock;
+		Programs mPrograms;
+	};
+
+	VDScriptProgramCache::~VDScriptProgramCache() {
+		Flush();
+	}
+
+	bool VDScriptProgramCache::Lookup(const char *text, VDScriptProgram **program) {
+		vdsynchronized(mLock) {
+			Programs::const_iterator it(mPrograms.find_as(text));
+
+			if (it == mPrograms.end())
+				return false;
+
+			VDScriptProgram *p = it->second;
+			p->AddRef();
+			*program = p;
+		}
+
+		return true;
+	}
+
+	void VDScriptProgramCache::Add(const char *text, VDScriptProgram *program) {
+		vdsynchronized(mLock) {
+			if (mPrograms.size() >= kMaxPrograms)
+				Flush();
+
+			Programs::insert_return_type r(mPrograms.insert(VDStringA(text)));
+
+			if (r.second) {
+				program->AddRef();
+				r.first->second = program;
+			}
+		}
+	}
+
+	void VDScriptProgramCache::Flush() {
+		for(Programs::const_iterator it(mPrograms.begin()), itEnd(mPrograms.end()); it != itEnd; ++it)
+			it->second->Release();
+
+		mPrograms.clear();
+	}
+
+	VDScriptProgramCache g_VDScriptProgramCache;
+}
+
+bool VDScriptLookupCachedProgram(const char *text, VDScriptProgram **program) {
+	return g_VDScriptProgramCache.Lookup(text, program);
+}
+
+void VDScriptCacheProgram(const char *text, VDScriptProgram *program) {
+	g_VDScriptProgramCache.Add(text, program);
+}
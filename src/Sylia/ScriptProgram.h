@@ -0,0 +1,81 @@
+#ifndef f_SYLIA_SCRIPTPROGRAM_H
+#define f_SYLIA_SCRIPTPROGRAM_H
+
+#include <vector>
+#include <vd2/system/refcount.h>
+#include <vd2/system/vdstl.h>
+
+#include "ScriptValue.h"
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Compiled script lines
+//
+//	A line is parsed once into a flat list of stack machine instructions,
+//	which are then executed in order. Literals are decoded, names are
+//	interned and operators are bound to their Sylia methods at compile
+//	time. Member lookups and overload resolution still happen at runtime,
+//	since filter script objects are created per instance and can't be
+//	bound ahead of time.
+//
+//	Compiled lines do not refer to any interpreter state, so they are
+//	shared between interpreters through a cache keyed on the line text.
+//
+///////////////////////////////////////////////////////////////////////////
+
+enum VDScriptOpcode {
+	kVDScriptOp_PushConst,			// push constant mArg
+	kVDScriptOp_PushString,			// push copy of string literal mArg
+	kVDScriptOp_PushRoot,			// push root variable named mArg
+	kVDScriptOp_CastInt,
+	kVDScriptOp_CastLong,
+	kVDScriptOp_CastDouble,
+	kVDScriptOp_RequireObject,		// convert top to rvalue, which must be an object
+	kVDScriptOp_Member,				// replace object on top with its member named mArg
+	kVDScriptOp_Index,				// invoke [] on object below top, with top as index
+	kVDScriptOp_CallBegin,			// replace method on top with its object and save the method
+	kVDScriptOp_Call,				// invoke saved method with mArg arguments
+	kVDScriptOp_Invoke,				// invoke prebound operator mpMethod with mArg arguments
+	kVDScriptOp_Assign,				// store top into variable below it
+	kVDScriptOp_Declare,			// declare variable named mArg and push it
+	kVDScriptOp_DeclareInit,		// store top into the variable below it, without conversion
+	kVDScriptOp_Pop,
+	kVDScriptOp_Error				// raise script error mArg
+};
+
+struct VDScriptInstruction {
+	VDScriptOpcode				mOp;
+	int							mArg;
+	int							mSrcPos;		// offset into the line, for error reporting
+	const VDScriptFunctionDef	*mpMethod;
+};
+
+class VDScriptProgram : public vdrefcounted<IVDRefCount> {
+public:
+	VDScriptProgram();
+
+	int AddConstant(const VDScriptValue& v);
+	int AddName(const char *s);
+	int AddString(const char *s, size_t len);
+	void AddOp(VDScriptOpcode op, int arg, int srcPos, const VDScriptFunctionDef *method = NULL);
+
+	size_t GetOpCount() const { return mOps.size(); }
+	const VDScriptInstruction *GetOps() const { return mOps.data(); }
+
+	const VDScriptValue& GetConstant(int idx) const { return mConstants[idx]; }
+	const char *GetName(int idx) const { return mTextPool.data() + mNameOffsets[idx]; }
+	const char *GetString(int idx, size_t& len) const;
+
+protected:
+	vdfastvector<VDScriptInstruction>	mOps;
+	std::vector<VDScriptValue>			mConstants;
+	vdfastvector<char>					mTextPool;
+	vdfastvector<uint32>				mNameOffsets;
+	vdfastvector<uint32>				mStringOffsets;
+	vdfastvector<uint32>				mStringLengths;
+};
+
+bool VDScriptLookupCachedProgram(const char *text, VDScriptProgram **program);
+void VDScriptCacheProgram(const char *text, VDScriptProgram *program);
+
+#endif
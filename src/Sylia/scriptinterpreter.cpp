@@ -14,6 +14,7 @@
 #include "ScriptValue.h"
 #include "ScriptInterpreter.h"
 #include "VariableTable.h"
+#include "ScriptProgram.h"
 
 ///////////////////////////////////////////////////////////////////////////
 
@@ -60,13 +61,16 @@ private:
 		double tokdval;
 	};
 	int tokhold;
-	char **tokslit;
+	vdfastvector<char> mTokenString;
 	char szIdent[MAX_IDENT_CHARS+1];
+	VDScriptProgram		*mpProgram;
+	int					mErrorPos;
 	VDScriptValue		mErrorObject;
 	vdfastvector<char> mError;
 
 	std::vector<VDScriptValue> mStack;
 	vdfastvector<int> mOpStack;
+	vdfastvector<const VDScriptFunctionDef *> mCallStack;
 
 	VDScriptRootHandlerPtr lpRoothandler;
 	void *lpRoothandlerData;
@@ -82,14 +86,17 @@ private:
 
 	////////
 
+	void			Compile(const char *s, VDScriptProgram& program);
+	void			Emit(VDScriptOpcode op, int arg = 0, const VDScriptFunctionDef *method = NULL);
 	void			ParseExpression();
 	int				ExprOpPrecedence(int op);
 	bool			ExprOpIsRightAssoc(int op);
 	void			ParseValue();
 	void			Reduce();
 
+	void	Execute(const VDScriptProgram& program);
 	void	ConvertToRvalue();
-	void	InvokeMethod(const VDScriptObject *objdef, const char *name, int argc);
+	const VDScriptFunctionDef *FindMethod(const VDScriptObject *objdef, const char *name);
 	void	InvokeMethod(const VDScriptFunctionDef *sfd, int pcount);
 
 	bool	isExprFirstToken(int t);
@@ -121,12 +128,16 @@ public:
 	VDScriptValue	LookupObjectMember(const VDScriptObject *obj, void *lpVoid, char *szIdent);
 
 	const VDScriptFunctionDef *GetCurrentMethod() { return mpCurrentInvocationMethodOverload; }
-	int GetErrorLocation() { return tokstr - tokbase; }
+	int GetErrorLocation() { return mErrorPos; }
 };
 
 ///////////////////////////////////////////////////////////////////////////
 
-VDScriptInterpreter::VDScriptInterpreter() : vartbl(128) {
+VDScriptInterpreter::VDScriptInterpreter()
+	: mpProgram(NULL)
+	, mErrorPos(0)
+	, vartbl(128)
+{
 }
 
 VDScriptInterpreter::~VDScriptInterpreter() {
@@ -151,62 +162,31 @@ void VDScriptInterpreter::SetRootHandler(VDScriptRootHandlerPtr rh, void *rh_dat
 ///////////////////////////////////////////////////////////////////////////
 
 void VDScriptInterpreter::ExecuteLine(const char *s) {
-	int t;
-
 	mErrorExtraToken.clear();
+	mErrorPos = 0;
 
-	TokenBegin(s);
-
-	while(t = Token()) {
-		if (t == ';')
-			continue;
-
-		if (isExprFirstToken(t)) {
-			TokenUnput(t);
-			VDASSERT(mStack.empty());
-			ParseExpression();
-
-			VDASSERT(!mStack.empty());
-
-			VDScriptValue& val = mStack.back();
-
-			mStack.pop_back();
-			VDASSERT(mStack.empty());
-
-			if (Token() != ';')
-				SCRIPT_ERROR(SEMICOLON_EXPECTED);
-		} else if (t == TOK_DECLARE) {
-
-			do {
-				t = Token();
-
-				if (t != TOK_IDENT)
-					SCRIPT_ERROR(IDENTIFIER_EXPECTED);
-
-				VariableTableEntry *vte = vartbl.Declare(szIdent);
-
-				t = Token();
-
-				if (t == '=') {
-					ParseExpression();
-
-					VDASSERT(!mStack.empty());
-					vte->v = mStack.back();
-					mStack.pop_back();
-
-					t = Token();
-				}
+	vdrefptr<VDScriptProgram> program;
 
-			} while(t == ',');
+	if (!VDScriptLookupCachedProgram(s, ~program)) {
+		program = new VDScriptProgram;
 
-			if (t != ';')
-				SCRIPT_ERROR(SEMICOLON_EXPECTED);
+		Compile(s, *program);
+		VDScriptCacheProgram(s, program);
+	}
 
-		} else
-			SCRIPT_ERROR(PARSE_ERROR);
+	// A line that fails partway through, such as between pushing a method
+	// and calling it, leaves its operands behind; drop them so that the
+	// next line starts clean.
+	try {
+		Execute(*program);
+	} catch(...) {
+		mStack.clear();
+		mCallStack.clear();
+		throw;
 	}
 
 	VDASSERT(mStack.empty());
+	VDASSERT(mCallStack.empty());
 
 	GC();
 }
@@ -307,10 +287,74 @@ VDScriptValue VDScriptInterpreter::DupCString(const char *s) {
 
 ///////////////////////////////////////////////////////////////////////////
 //
-//	Expression parsing
+//	Compilation
+//
+//	The parser emits instructions at the points where it used to execute
+//	them, so side effects and error locations are the same as when lines
+//	were interpreted directly. A parse error does not discard the line;
+//	it becomes an error instruction so that earlier statements still run.
 //
 ///////////////////////////////////////////////////////////////////////////
 
+void VDScriptInterpreter::Compile(const char *s, VDScriptProgram& program) {
+	int t;
+
+	mpProgram = &program;
+	mOpStack.clear();
+
+	TokenBegin(s);
+
+	try {
+		while(t = Token()) {
+			if (t == ';')
+				continue;
+
+			if (isExprFirstToken(t)) {
+				TokenUnput(t);
+				ParseExpression();
+				Emit(kVDScriptOp_Pop);
+
+				if (Token() != ';')
+					SCRIPT_ERROR(SEMICOLON_EXPECTED);
+			} else if (t == TOK_DECLARE) {
+
+				do {
+					t = Token();
+
+					if (t != TOK_IDENT)
+						SCRIPT_ERROR(IDENTIFIER_EXPECTED);
+
+					Emit(kVDScriptOp_Declare, program.AddName(szIdent));
+
+					t = Token();
+
+					if (t == '=') {
+						ParseExpression();
+						Emit(kVDScriptOp_DeclareInit);
+
+						t = Token();
+					} else
+						Emit(kVDScriptOp_Pop);
+
+				} while(t == ',');
+
+				if (t != ';')
+					SCRIPT_ERROR(SEMICOLON_EXPECTED);
+
+			} else
+				SCRIPT_ERROR(PARSE_ERROR);
+		}
+	} catch(const VDScriptError& e) {
+		Emit(kVDScriptOp_Error, e.err);
+	}
+
+	mpProgram = NULL;
+}
+
+void VDScriptInterpreter::Emit(VDScriptOpcode op, int arg, const VDScriptFunctionDef *method) {
+	mpProgram->AddOp(op, arg, tokstr - tokbase, method);
+}
+
 int VDScriptInterpreter::ExprOpPrecedence(int op) {
 	// All of these need to be EVEN.
 	switch(op) {
@@ -359,55 +403,26 @@ void VDScriptInterpreter::ParseExpression() {
 			break;
 		}
 
-		VDScriptValue& v = mStack.back();
-
 		if (t=='.') {			// object indirection operator (object -> member)
-			ConvertToRvalue();
-
-			if (!v.isObject()) {
-				SCRIPT_ERROR(TYPE_OBJECT_REQUIRED);
-			}
+			Emit(kVDScriptOp_RequireObject);
 
 			if (Token() != TOK_IDENT)
 				SCRIPT_ERROR(OBJECT_MEMBER_NAME_REQUIRED);
 
-			try {
-				VDScriptValue v2 = LookupObjectMember(v.asObjectDef(), v.asObjectPtr(), szIdent);
-
-				if (v2.isVoid()) {
-					mErrorObject = v;
-					SCRIPT_ERROR(MEMBER_NOT_FOUND);
-				}
-
-				v = v2;
-			} catch(const VDScriptError&) {
-				mErrorObject = v;
-				throw;
-			}
+			Emit(kVDScriptOp_Member, mpProgram->AddName(szIdent));
 
 		} else if (t == '[') {	// array indexing operator (object, value -> value)
 			// Reduce lvalues to rvalues
 
-			ConvertToRvalue();
-
-			if (!v.isObject())
-				SCRIPT_ERROR(TYPE_OBJECT_REQUIRED);
+			Emit(kVDScriptOp_RequireObject);
 
 			ParseExpression();
-			InvokeMethod((mStack.end() - 2)->asObjectDef(), "[]", 1);
-
-			VDASSERT(mStack.size() >= 2);
-			mStack.erase(mStack.end() - 2);
+			Emit(kVDScriptOp_Index);
 
 			if (Token() != ']')
 				SCRIPT_ERROR(CLOSEBRACKET_EXPECTED);
 		} else if (t == '(') {	// function indirection operator (method -> value)
-			ConvertToRvalue();	// can happen if a method is assigned
-
-			const VDScriptValue fcall(mStack.back());
-			mStack.pop_back();
-
-			mStack.push_back(VDScriptValue(fcall.u.method.p, fcall.thisPtr));
+			Emit(kVDScriptOp_CallBegin);
 
 			int pcount = 0;
 
@@ -428,10 +443,7 @@ void VDScriptInterpreter::ParseExpression() {
 				}
 			}
 
-			InvokeMethod(fcall.u.method.pfn, pcount);
-
-			VDASSERT(mStack.size() >= 2);
-			mStack.erase(mStack.end() - 2);
+			Emit(kVDScriptOp_Call, pcount);
 		} else {
 			int prec = ExprOpPrecedence(t) + ExprOpIsRightAssoc(t);
 
@@ -456,37 +468,33 @@ void VDScriptInterpreter::Reduce() {
 	const int op = mOpStack.back();
 	mOpStack.pop_back();
 
+	const char *name;
+
 	switch(op) {
 	case '=':
-		{
-			VDScriptValue& v = mStack[mStack.size() - 2];
-
-			if (!v.isVarLV())
-				SCRIPT_ERROR(TYPE_OBJECT_REQUIRED);
-
-			ConvertToRvalue();
-
-			v.asVarLV()->v = mStack.back();
-			mStack.pop_back();
-		}
-		break;
-	case TOK_OR:		InvokeMethod(&obj_Sylia, "||", 2); break;
-	case TOK_AND:		InvokeMethod(&obj_Sylia, "&&", 2); break;
-	case '|':			InvokeMethod(&obj_Sylia, "|", 2); break;
-	case '^':			InvokeMethod(&obj_Sylia, "^", 2); break;
-	case '&':			InvokeMethod(&obj_Sylia, "&", 2); break;
-	case TOK_EQUALS:	InvokeMethod(&obj_Sylia, "==", 2); break;
-	case TOK_NOTEQ:		InvokeMethod(&obj_Sylia, "!=", 2); break;
-	case '<':			InvokeMethod(&obj_Sylia, "<", 2); break;
-	case '>':			InvokeMethod(&obj_Sylia, ">", 2); break;
-	case TOK_LESSEQ:	InvokeMethod(&obj_Sylia, "<=", 2); break;
-	case TOK_GRTREQ:	InvokeMethod(&obj_Sylia, ">=", 2); break;
-	case '+':			InvokeMethod(&obj_Sylia, "+", 2); break;
-	case '-':			InvokeMethod(&obj_Sylia, "-", 2); break;
-	case '*':			InvokeMethod(&obj_Sylia, "*", 2); break;
-	case '/':			InvokeMethod(&obj_Sylia, "/", 2); break;
-	case '%':			InvokeMethod(&obj_Sylia, "%", 2); break;
+		Emit(kVDScriptOp_Assign);
+		return;
+	case TOK_OR:		name = "||"; break;
+	case TOK_AND:		name = "&&"; break;
+	case '|':			name = "|"; break;
+	case '^':			name = "^"; break;
+	case '&':			name = "&"; break;
+	case TOK_EQUALS:	name = "=="; break;
+	case TOK_NOTEQ:		name = "!="; break;
+	case '<':			name = "<"; break;
+	case '>':			name = ">"; break;
+	case TOK_LESSEQ:	name = "<="; break;
+	case TOK_GRTREQ:	name = ">="; break;
+	case '+':			name = "+"; break;
+	case '-':			name = "-"; break;
+	case '*':			name = "*"; break;
+	case '/':			name = "/"; break;
+	case '%':			name = "%"; break;
+	default:
+		return;
 	}
+
+	Emit(kVDScriptOp_Invoke, 2, FindMethod(&obj_Sylia, name));
 }
 
 void VDScriptInterpreter::ParseValue() {
@@ -500,43 +508,19 @@ void VDScriptInterpreter::ParseValue() {
 				SCRIPT_ERROR(CLOSEPARENS_EXPECTED);
 
 			ParseExpression();
-
-			VDScriptValue& v = mStack.back();
-
-			if (v.isDouble())
-				v = (int)v.asDouble();
-			else if (v.isLong())
-				v = (int)v.asLong();
-			else if (!v.isInt())
-				SCRIPT_ERROR(CANNOT_CAST);
+			Emit(kVDScriptOp_CastInt);
 		} else if (t == TOK_LONG) {
 			if (Token() != ')')
 				SCRIPT_ERROR(CLOSEPARENS_EXPECTED);
 
 			ParseExpression();
-
-			VDScriptValue& v = mStack.back();
-
-			if (v.isDouble())
-				v = (sint64)v.asDouble();
-			else if (v.isInt())
-				v = (sint64)v.asInt();
-			else if (!v.isLong())
-				SCRIPT_ERROR(CANNOT_CAST);
+			Emit(kVDScriptOp_CastLong);
 		} else if (t == TOK_DOUBLE) {
 			if (Token() != ')')
 				SCRIPT_ERROR(CLOSEPARENS_EXPECTED);
 
 			ParseExpression();
-
-			VDScriptValue& v = mStack.back();
-
-			if (v.isInt())
-				v = (double)v.asInt();
-			else if (v.isLong())
-				v = (double)v.asLong();
-			else if (!v.isDouble())
-				SCRIPT_ERROR(CANNOT_CAST);
+			Emit(kVDScriptOp_CastDouble);
 		} else {
 			TokenUnput(t);
 
@@ -546,35 +530,221 @@ void VDScriptInterpreter::ParseValue() {
 				SCRIPT_ERROR(CLOSEPARENS_EXPECTED);
 		}
 	} else if (t==TOK_IDENT) {
-		mStack.push_back(LookupRootVariable(szIdent));
+		Emit(kVDScriptOp_PushRoot, mpProgram->AddName(szIdent));
 	} else if (t == TOK_INTVAL)
-		mStack.push_back(VDScriptValue(tokival));
+		Emit(kVDScriptOp_PushConst, mpProgram->AddConstant(VDScriptValue(tokival)));
 	else if (t == TOK_LONGVAL)
-		mStack.push_back(VDScriptValue(toklval));
+		Emit(kVDScriptOp_PushConst, mpProgram->AddConstant(VDScriptValue(toklval)));
 	else if (t == TOK_DBLVAL)
-		mStack.push_back(VDScriptValue(tokdval));
+		Emit(kVDScriptOp_PushConst, mpProgram->AddConstant(VDScriptValue(tokdval)));
 	else if (t == TOK_STRING)
-		mStack.push_back(VDScriptValue(tokslit));
+		Emit(kVDScriptOp_PushString, mpProgram->AddString(mTokenString.data(), mTokenString.size() - 1));
 	else if (t=='!' || t=='~' || t=='-' || t=='+') {
 		ParseValue();
 
 		switch(t) {
-		case '!':		InvokeMethod(&obj_Sylia, "!", 1); break;
-		case '~':		InvokeMethod(&obj_Sylia, "~", 1); break;
-		case '+':		InvokeMethod(&obj_Sylia, "+", 1); break;
-		case '-':		InvokeMethod(&obj_Sylia, "-", 1); break;
+		case '!':		Emit(kVDScriptOp_Invoke, 1, FindMethod(&obj_Sylia, "!")); break;
+		case '~':		Emit(kVDScriptOp_Invoke, 1, FindMethod(&obj_Sylia, "~")); break;
+		case '+':		Emit(kVDScriptOp_Invoke, 1, FindMethod(&obj_Sylia, "+")); break;
+		case '-':		Emit(kVDScriptOp_Invoke, 1, FindMethod(&obj_Sylia, "-")); break;
 			break;
 		default:
 			SCRIPT_ERROR(PARSE_ERROR);
 		}
 	} else if (t == TOK_TRUE)
-		mStack.push_back(VDScriptValue(1));
+		Emit(kVDScriptOp_PushConst, mpProgram->AddConstant(VDScriptValue(1)));
 	else if (t == TOK_FALSE)
-		mStack.push_back(VDScriptValue(0));
+		Emit(kVDScriptOp_PushConst, mpProgram->AddConstant(VDScriptValue(0)));
 	else
 		SCRIPT_ERROR(PARSE_ERROR);
 }
 
+///////////////////////////////////////////////////////////////////////////
+//
+//	Execution
+//
+///////////////////////////////////////////////////////////////////////////
+
+void VDScriptInterpreter::Execute(const VDScriptProgram& program) {
+	const VDScriptInstruction *insn = program.GetOps();
+	const VDScriptInstruction *const insnEnd = insn + program.GetOpCount();
+
+	for(; insn != insnEnd; ++insn) {
+		mErrorPos = insn->mSrcPos;
+
+		switch(insn->mOp) {
+		case kVDScriptOp_PushConst:
+			mStack.push_back(program.GetConstant(insn->mArg));
+			break;
+
+		case kVDScriptOp_PushString:
+			{
+				size_t len;
+				const char *s = program.GetString(insn->mArg, len);
+				char **handle = strheap.Allocate(len);
+
+				memcpy(*handle, s, len + 1);
+				mStack.push_back(VDScriptValue(handle));
+			}
+			break;
+
+		case kVDScriptOp_PushRoot:
+			strcpy(szIdent, program.GetName(insn->mArg));
+			mStack.push_back(LookupRootVariable(szIdent));
+			break;
+
+		case kVDScriptOp_CastInt:
+			{
+				VDScriptValue& v = mStack.back();
+
+				if (v.isDouble())
+					v = (int)v.asDouble();
+				else if (v.isLong())
+					v = (int)v.asLong();
+				else if (!v.isInt())
+					SCRIPT_ERROR(CANNOT_CAST);
+			}
+			break;
+
+		case kVDScriptOp_CastLong:
+			{
+				VDScriptValue& v = mStack.back();
+
+				if (v.isDouble())
+					v = (sint64)v.asDouble();
+				else if (v.isInt())
+					v = (sint64)v.asInt();
+				else if (!v.isLong())
+					SCRIPT_ERROR(CANNOT_CAST);
+			}
+			break;
+
+		case kVDScriptOp_CastDouble:
+			{
+				VDScriptValue& v = mStack.back();
+
+				if (v.isInt())
+					v = (double)v.asInt();
+				else if (v.isLong())
+					v = (double)v.asLong();
+				else if (!v.isDouble())
+					SCRIPT_ERROR(CANNOT_CAST);
+			}
+			break;
+
+		case kVDScriptOp_RequireObject:
+			ConvertToRvalue();
+
+			if (!mStack.back().isObject())
+				SCRIPT_ERROR(TYPE_OBJECT_REQUIRED);
+			break;
+
+		case kVDScriptOp_Member:
+			{
+				VDScriptValue& v = mStack.back();
+
+				strcpy(szIdent, program.GetName(insn->mArg));
+
+				try {
+					VDScriptValue v2 = LookupObjectMember(v.asObjectDef(), v.asObjectPtr(), szIdent);
+
+					if (v2.isVoid()) {
+						mErrorObject = v;
+						SCRIPT_ERROR(MEMBER_NOT_FOUND);
+					}
+
+					v = v2;
+				} catch(const VDScriptError&) {
+					mErrorObject = v;
+					throw;
+				}
+			}
+			break;
+
+		case kVDScriptOp_Index:
+			{
+				const VDScriptFunctionDef *sfd = FindMethod((mStack.end() - 2)->asObjectDef(), "[]");
+
+				if (!sfd)
+					SCRIPT_ERROR(OVERLOADED_FUNCTION_NOT_FOUND);
+
+				InvokeMethod(sfd, 1);
+
+				VDASSERT(mStack.size() >= 2);
+				mStack.erase(mStack.end() - 2);
+			}
+			break;
+
+		case kVDScriptOp_CallBegin:
+			{
+				ConvertToRvalue();	// can happen if a method is assigned
+
+				const VDScriptValue fcall(mStack.back());
+
+				mStack.back() = VDScriptValue(fcall.u.method.p, fcall.thisPtr);
+				mCallStack.push_back(fcall.u.method.pfn);
+			}
+			break;
+
+		case kVDScriptOp_Call:
+			{
+				const VDScriptFunctionDef *sfd = mCallStack.back();
+				mCallStack.pop_back();
+
+				InvokeMethod(sfd, insn->mArg);
+
+				VDASSERT(mStack.size() >= 2);
+				mStack.erase(mStack.end() - 2);
+			}
+			break;
+
+		case kVDScriptOp_Invoke:
+			if (!insn->mpMethod)
+				SCRIPT_ERROR(OVERLOADED_FUNCTION_NOT_FOUND);
+
+			InvokeMethod(insn->mpMethod, insn->mArg);
+			break;
+
+		case kVDScriptOp_Assign:
+			{
+				VDScriptValue& v = mStack[mStack.size() - 2];
+
+				if (!v.isVarLV())
+					SCRIPT_ERROR(TYPE_OBJECT_REQUIRED);
+
+				ConvertToRvalue();
+
+				v.asVarLV()->v = mStack.back();
+				mStack.pop_back();
+			}
+			break;
+
+		case kVDScriptOp_Declare:
+			mStack.push_back(VDScriptValue(vartbl.Declare(program.GetName(insn->mArg))));
+			break;
+
+		case kVDScriptOp_DeclareInit:
+			{
+				VDASSERT(mStack.size() >= 2);
+
+				VariableTableEntry *vte = mStack[mStack.size() - 2].asVarLV();
+
+				vte->v = mStack.back();
+				mStack.pop_back();
+				mStack.pop_back();
+			}
+			break;
+
+		case kVDScriptOp_Pop:
+			VDASSERT(!mStack.empty());
+			mStack.pop_back();
+			break;
+
+		case kVDScriptOp_Error:
+			throw VDScriptError(insn->mArg);
+		}
+	}
+}
 
 ///////////////////////////////////////////////////////////////////////////
 //
@@ -582,21 +752,19 @@ void VDScriptInterpreter::ParseValue() {
 //
 ///////////////////////////////////////////////////////////////////////////
 
-void VDScriptInterpreter::InvokeMethod(const VDScriptObject *obj, const char *name, int argc) {
+const VDScriptFunctionDef *VDScriptInterpreter::FindMethod(const VDScriptObject *obj, const char *name) {
 	if (obj->func_list) {
 		const VDScriptFunctionDef *sfd = obj->func_list;
 
 		while(sfd->arg_list) {
-			if (sfd->name && !strcmp(sfd->name, name)) {
-				InvokeMethod(sfd, argc);
-				return;
-			}
+			if (sfd->name && !strcmp(sfd->name, name))
+				return sfd;
 
 			++sfd;
 		}
 	}
 
-	SCRIPT_ERROR(OVERLOADED_FUNCTION_NOT_FOUND);
+	return NULL;
 }
 
 void VDScriptInterpreter::InvokeMethod(const VDScriptFunctionDef *sfd, int pcount) {
@@ -944,8 +1112,8 @@ int VDScriptInterpreter::Token() {
 			}
 		}
 
-		tokslit = strheap.Allocate(tokstr - s - 1 - len_adjust);
-		t = *tokslit;
+		mTokenString.resize(tokstr - s - len_adjust);
+		t = mTokenString.data();
 		while(s<tokstr-1) {
 			int val;
 
@@ -997,9 +1165,8 @@ int VDScriptInterpreter::Token() {
 
 		len = strA.size();
 
-		tokslit = strheap.Allocate(len);
-		memcpy(*tokslit, strA.data(), len);
-		(*tokslit)[len] = 0;
+		mTokenString.assign(strA.data(), strA.data() + len);
+		mTokenString.push_back(0);
 
 		return TOK_STRING;
 	}
@@ -18,6 +18,8 @@
 #ifndef f_VD2_VDFILTERS_BLUR_H
 #define f_VD2_VDFILTERS_BLUR_H
 
+#include <vd2/system/vdstl.h>
+
 struct VDPixmap;
 
 class VEffect {
@@ -31,4 +33,53 @@ public:
 VEffect *VCreateEffectBlur(const VDPixmapLayout&);
 VEffect *VCreateEffectBlurHi(const VDPixmapLayout&);
 
+///////////////////////////////////////////////////////////////////////////
+//
+//	Separable blur engine
+//
+//	Blurs 8-bit samples interleaved with a fixed channel count (1 for Y8,
+//	4 for XRGB8888). Each axis runs a 1D kernel with the edge samples
+//	replicated:
+//
+//		- binomial, radius 1 [1 2 1]/4 or radius 2 [1 4 6 4 1]/16
+//		- box of any radius, computed with a running sum and optionally
+//		  repeated to approximate a gaussian
+//
+//	The vertical passes step a row of running column sums down the image
+//	instead of walking columns, so memory is always read in row order.
+//	Each pass is split into row bands across threads. The source and
+//	destination may be the same buffer.
+//
+///////////////////////////////////////////////////////////////////////////
+
+class VDBlurEngine8 {
+public:
+	enum Kernel {
+		kKernelBinomial,
+		kKernelBox
+	};
+
+	VDBlurEngine8();
+
+	void InitBinomial(uint32 w, uint32 h, uint32 channels, int radius);
+	void InitBox(uint32 w, uint32 h, uint32 channels, int radius, int passes);
+	void Shutdown();
+
+	void Run(void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch);
+
+protected:
+	void Init(uint32 w, uint32 h, uint32 channels, Kernel kernel, int radiusH, int radiusV, int passes);
+
+	uint32	mWidth;
+	uint32	mHeight;
+	uint32	mChannels;
+	Kernel	mKernel;
+	int		mRadiusH;
+	int		mRadiusV;
+	int		mPasses;
+
+	ptrdiff_t mTempPitch;
+	vdfastvector<uint8, vdaligned_alloc<uint8> > mTempBuffer;
+};
+
 #endif
@@ -0,0 +1,42 @@
+//	VirtualDub - Video processing and capture application
+//	Internal filter library
+//	Copyright (C) 1998-2011 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef f_VD2_VDFILTERS_ROWTASK_H
+#define f_VD2_VDFILTERS_ROWTASK_H
+
+#include <vd2/system/vdtypes.h>
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Row band threading
+//
+//	Filters whose output scanlines can be computed independently split
+//	large frames into horizontal bands, which are run as a system row task
+//	on the shared worker pool. Each band gets its own 16-byte aligned
+//	scratch buffer of the requested size.
+//
+///////////////////////////////////////////////////////////////////////////
+
+class VDFilterRowTask {
+public:
+	virtual void RunRows(uint32 y1, uint32 y2, void *tempBuf) = 0;
+};
+
+void VDFilterRunRowTask(VDFilterRowTask& task, uint32 rows, uint32 rowBytes, size_t tempBytes = 0);
+
+#endif
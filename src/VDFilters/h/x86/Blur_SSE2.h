@@ -0,0 +1,29 @@
+//	VirtualDub - Video processing and capture application
+//	Internal filter library
+//	Copyright (C) 1998-2011 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifndef f_VD2_VDFILTERS_X86_BLUR_SSE2_H
+#define f_VD2_VDFILTERS_X86_BLUR_SSE2_H
+
+void VDBlurBinomial3_8_SSE2(uint8 *dst, const uint8 *const *src, uint32 n16);
+void VDBlurBinomial5_8_SSE2(uint8 *dst, const uint8 *const *src, uint32 n16);
+void VDBlurBoxRow8_X8R8G8B8_SSE2(uint8 *dst, const uint8 *src, uint32 w, uint32 radius, uint32 mult);
+void VDBlurAddRow8_SSE2(uint16 *sums, const uint8 *src, uint32 n16);
+void VDBlurBoxColumn8_SSE2(uint8 *dst, uint16 *sums, const uint8 *add, const uint8 *sub, uint32 n16, uint32 mult);
+
+#endif
@@ -10,7 +10,6 @@
 #define IDD_FILTER_DEINTERLACE          203
 #define IDD_FILTER_ROTATE2              207
 #define IDD_FILTER_BOX                  233
-#define IDD_FILTER_TIMESMOOTH           237
 #define IDD_FILTER_HSV                  243
 #define IDD_FILTER_CHROMASMOOTHER       260
 #define IDD_FILTER_PERSPECTIVE          264
@@ -67,7 +66,6 @@
 #define IDC_SLIDER_POWER                1352
 #define IDC_STATIC_WIDTH                1353
 #define IDC_STATIC_POWER                1354
-#define IDC_STRENGTH                    1371
 #define IDC_EVEN_NONE                   1379
 #define IDC_EVEN_SMOOTH                 1380
 #define IDC_EVEN_HALFUP                 1381
@@ -131,6 +129,7 @@
 #define IDC_CR_FULL                     1497
 #define IDC_STATIC_COLORSPACE           1498
 #define IDC_BLEND_WEIGHTING             1522
+#define IDC_METRICS_FILE                1523
 #define IDD_FILTER_ALIASFORMAT          2001
 #define IDD_FILTER_TV                   2002
 #define IDD_FILTER_ROTATE               2003
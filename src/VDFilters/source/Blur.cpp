@@ -16,998 +16,426 @@
 //	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 
 #include "stdafx.h"
-
-#include <vd2/system/error.h>
 #include <vd2/system/cpuaccel.h>
 #include <vd2/Kasumi/pixmap.h>
 #include "Blur.h"
+#include "RowTask.h"
+#include "x86/Blur_SSE2.h"
 
-static const __int64 mmx_offset2 = 0x0002000200020002i64;
-static const __int64 mmx_offset8 = 0x0008000800080008i64;
-static const __int64 mmx_by11	 = 0x000b000b000b000bi64;
-static const __int64 mmx_by6	 = 0x0006000600060006i64;
-
-#ifdef _MSC_VER
-	#pragma warning(disable: 4799)		// warning C4799: function 'dorow_MMX' has no EMMS instruction
-#endif
-
+///////////////////////////////////////////////////////////////////////////
+//
+//	kernels
+//
 ///////////////////////////////////////////////////////////////////////////
 
-class VEffectBlur : public VEffect {
-public:
-	VEffectBlur(const VDPixmapLayout&);
-	~VEffectBlur();
+namespace {
+	void VDBlurBinomial3_8_scalar(uint8 *dst, const uint8 *const *src, uint32 offset, uint32 n) {
+		const uint8 *src0 = src[0];
+		const uint8 *src1 = src[1];
+		const uint8 *src2 = src[2];
 
-	void run(const VDPixmap&);
-	void run(const VDPixmap&, const VDPixmap&);
-
-private:
-	uint32 *rows[3];
+		for(uint32 i=offset; i<n; ++i)
+			dst[i] = (uint8)((src0[i] + 2*src1[i] + src2[i] + 2) >> 2);
+	}
 
-};
+	void VDBlurBinomial5_8_scalar(uint8 *dst, const uint8 *const *src, uint32 offset, uint32 n) {
+		const uint8 *src0 = src[0];
+		const uint8 *src1 = src[1];
+		const uint8 *src2 = src[2];
+		const uint8 *src3 = src[3];
+		const uint8 *src4 = src[4];
 
-///////////////////////////////////////////////////////////////////////////
+		for(uint32 i=offset; i<n; ++i)
+			dst[i] = (uint8)((src0[i] + 4*(src1[i] + src3[i]) + 6*src2[i] + src4[i] + 8) >> 4);
+	}
 
-VEffect *VCreateEffectBlur(const VDPixmapLayout& vbm) {
-	return new VEffectBlur(vbm);
-}
+	// Evaluates the binomial kernel of the given radius over n bytes, where
+	// src holds pointers to the 2*radius+1 input taps.
+	void VDBlurBinomial8(uint8 *dst, const uint8 *const *src, uint32 n, int radius) {
+		uint32 offset = 0;
 
-VEffectBlur::VEffectBlur(const VDPixmapLayout& vbm) {
-	int i;
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+		if (SSE2_enabled) {
+			const uint32 n16 = n >> 4;
 
-	for(i=0; i<3; i++)
-		if (!(rows[i] = new uint32[vbm.w])) {
-			while(--i>=0)
-				delete rows[i];
+			if (n16) {
+				if (radius == 1)
+					VDBlurBinomial3_8_SSE2(dst, src, n16);
+				else
+					VDBlurBinomial5_8_SSE2(dst, src, n16);
 
-			throw MyMemoryError();
+				offset = n16 << 4;
+			}
 		}
-}
-
-VEffectBlur::~VEffectBlur() {
-	int i;
-
-	for(i=0; i<3; i++)
-		delete rows[i];
-}
-
-#ifdef _M_IX86
-static void __declspec(naked) dorow_MMX(uint32 *dst, const uint32 *src, uint32 w) {
-	__asm {
-		mov		eax,[esp+8]
-		mov		edx,[esp+4]
-		pxor	mm7,mm7
-		movq	mm3,mmx_offset2
-
-		;first pixel
-
-		movd		mm0,[eax]
-		movd		mm6,[eax+4]
-		punpcklbw	mm0,mm7
-		punpcklbw	mm6,mm7
-		movq		mm5,mm0
-		paddw		mm0,mm0
-		paddw		mm0,mm5
-		paddw		mm0,mm6
-		paddw		mm0,mm3
-		psraw		mm0,2
-		packuswb	mm0,mm0
-		movd		[edx],mm0
-
-		mov			ecx,[esp+12]
-		shl			ecx,2
-		neg			ecx
-		add			ecx,16
-
-		sub			eax,ecx
-		sub			edx,ecx
-
-		;on entry into pixel loop:
-		;
-		;	mm3		2
-		;	mm5		pixel[-2]
-		;	mm6		pixel[-1]
-		;	mm7		zero
-
-xloop:
-		movd		mm4,[eax+ecx+8]
-		punpcklbw	mm4,mm7
-
-		paddw		mm5,mm6
-		paddw		mm5,mm4
-		paddw		mm5,mm6
-		paddw		mm5,mm3
-		psraw		mm5,2
-		packuswb	mm5,mm5
-		movd		[edx+ecx+4],mm5
-
-		;	mm4		pixel[-1]
-		;	mm5
-		;	mm6		pixel[-2]
-
-		movd		mm5,[eax+ecx+12]
-		punpcklbw	mm5,mm7
-
-		paddw		mm6,mm4
-		paddw		mm6,mm4
-		paddw		mm6,mm5
-		paddw		mm6,mm3
-		psraw		mm6,2
-		packuswb	mm6,mm6
-		movd		[edx+ecx+8],mm6
-
-		;	mm4		pixel[-2]
-		;	mm5		pixel[-1]
-		;	mm6
-
-		movd		mm6,[eax+ecx+16]
-		punpcklbw	mm6,mm7
-
-		paddw		mm4,mm5
-		paddw		mm4,mm5
-		paddw		mm4,mm6
-		paddw		mm4,mm3
-		psraw		mm4,2
-		packuswb	mm4,mm4
-		movd		[edx+ecx+12],mm4
-
-		add			ecx,12
-		jnc			xloop
-
-		;last pixel
-		;
-		;w=5 -> ecx=+8, 1 odd left
-		;w=6 -> ecx=+4, 2 odd left
-		;w=7 -> ecx=0, 3 odd left
-
-		sub			ecx,4
-		jnc			odd1
-
-		movd		mm4,[eax+8]
-		punpcklbw	mm4,mm7
-
-		paddw		mm5,mm6
-		paddw		mm5,mm4
-		paddw		mm5,mm6
-		paddw		mm5,mm3
-		psraw		mm5,2
-		packuswb	mm5,mm5
-		movd		[edx+4],mm5
-
-		;	mm4		pixel[-1]
-		;	mm5
-		;	mm6		pixel[-2]
-
-		movd		mm5,[eax+12]
-		punpcklbw	mm5,mm7
-
-		paddw		mm6,mm4
-		paddw		mm6,mm4
-		paddw		mm6,mm5
-		paddw		mm6,mm3
-		psraw		mm6,2
-		packuswb	mm6,mm6
-		movd		[edx+8],mm6
-
-		;	mm4		pixel[-2]
-		;	mm5		pixel[-1]
-		;	mm6
-
-		paddw		mm4,mm5
-		paddw		mm4,mm5
-		paddw		mm4,mm5
-		paddw		mm4,mm3
-		psraw		mm4,2
-		packuswb	mm4,mm4
-		movd		[edx+12],mm4
-
-		ret
-odd1:
-		sub			ecx,4
-		jnc			odd2
-
-		movd		mm4,[eax+8+4]
-		punpcklbw	mm4,mm7
-
-		paddw		mm5,mm6
-		paddw		mm5,mm4
-		paddw		mm5,mm6
-		paddw		mm5,mm3
-		psraw		mm5,2
-		packuswb	mm5,mm5
-		movd		[edx+4+4],mm5
-
-		;	mm4		pixel[-1]
-		;	mm5
-		;	mm6		pixel[-2]
-
-		paddw		mm6,mm4
-		paddw		mm6,mm4
-		paddw		mm6,mm4
-		paddw		mm6,mm3
-		psraw		mm6,2
-		packuswb	mm6,mm6
-		movd		[edx+8+4],mm6
-		ret
-odd2:
-
-		paddw		mm5,mm6
-		paddw		mm5,mm6
-		paddw		mm5,mm6
-		paddw		mm5,mm3
-		psraw		mm5,2
-		packuswb	mm5,mm5
-		movd		[edx+4+8],mm5
-
-		ret
-	}
-}
 #endif
 
-static void dorow(uint32 *dst, const uint32 *src, uint32 w) {
-	if (w == 1) {
-		*dst = *src;
-		return;
+		if (radius == 1)
+			VDBlurBinomial3_8_scalar(dst, src, offset, n);
+		else
+			VDBlurBinomial5_8_scalar(dst, src, offset, n);
 	}
 
-#ifdef _M_IX86
-	if (MMX_enabled) {
-		dorow_MMX(dst, src, w);
-		return;
-	}
+	// The source row is padded with radius pixels on the left and radius+1
+	// pixels on the right.
+	void VDBlurBoxRow8(uint8 *dst, const uint8 *src, uint32 w, uint32 channels, uint32 radius, uint32 mult) {
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+		if (SSE2_enabled && channels == 4) {
+			VDBlurBoxRow8_X8R8G8B8_SSE2(dst, src, w, radius, mult);
+			return;
+		}
 #endif
 
-	dst[0] = ((((src[0] & 0x00FF00FF)*3 + (src[1] & 0x00FF00FF) + 0x00020002)>>2) & 0x00FF00FF)
-		   + ((((src[0] & 0x0000FF00)*3 + (src[1] & 0x0000FF00) + 0x00000200)>>2) & 0x0000FF00);
-
-	++dst;
+		const uint32 window = 2*radius + 1;
 
-	w -= 2;
-	if (w) {
-		src += w;
-		dst += w;
+		for(uint32 c=0; c<channels; ++c) {
+			const uint8 *sub = src + c;
+			const uint8 *add = src + c + channels*window;
+			uint8 *out = dst + c;
+			uint32 sum = 0;
 
-		ptrdiff_t x = -(ptrdiff_t)w;
-		do {
-			uint32 s1, s2, s3;
+			for(uint32 i=0; i<window; ++i)
+				sum += sub[channels*i];
 
-			s1 = src[x+0];
-			s2 = src[x+1];
-			s3 = src[x+2];
+			for(uint32 x=0; x<w; ++x) {
+				*out = (uint8)((sum * mult) >> 16);
+				out += channels;
 
-			dst[x]= ((((s1&0xFF00FF) + 2*(s2&0xFF00FF) + (s3&0xFF00FF) + 0x020002)>>2) & 0xFF00FF)
-					+ ((((s1&0x00FF00) + 2*(s2&0x00FF00) + (s3&0x00FF00) + 0x000200)>>2) & 0x00FF00);
-
-		} while(++x);
+				sum += *add;
+				sum -= *sub;
+				add += channels;
+				sub += channels;
+			}
+		}
 	}
 
-	dst[0] = ((((src[0] & 0x00FF00FF) + (src[1] & 0x00FF00FF)*3 + 0x00020002)>>2) & 0xFF00FF)
-		   + ((((src[0] & 0x0000FF00) + (src[1] & 0x0000FF00)*3 + 0x00000200)>>2) & 0x00FF00);
-}
+	void VDBlurAddRow8(uint16 *sums, const uint8 *src, uint32 n) {
+		uint32 offset = 0;
 
-static void dorow_8(uint8 *dst, const uint8 *src, uint32 w) {
-	if (w == 1) {
-		*dst = *src;
-		return;
-	}
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+		if (SSE2_enabled) {
+			const uint32 n16 = n >> 4;
 
-	dst[0] = (src[0] * 3 + src[1] + 2) >> 2;
-	++dst;
+			if (n16) {
+				VDBlurAddRow8_SSE2(sums, src, n16);
+				offset = n16 << 4;
+			}
+		}
+#endif
 
-	w -= 2;
-	if (w) {
-		src += w;
-		dst += w;
+		for(uint32 i=offset; i<n; ++i)
+			sums[i] = (uint16)(sums[i] + src[i]);
+	}
 
-		ptrdiff_t x = -(ptrdiff_t)w;
-		do {
-			uint32 s1, s2, s3;
+	void VDBlurBoxColumn8(uint8 *dst, uint16 *sums, const uint8 *add, const uint8 *sub, uint32 n, uint32 mult) {
+		uint32 offset = 0;
 
-			s1 = src[x+0];
-			s2 = src[x+1];
-			s3 = src[x+2];
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+		if (SSE2_enabled) {
+			const uint32 n16 = n >> 4;
 
-			dst[x] = (uint8)((s1 + 2*s2 + s3 + 2) >> 2);
-		} while(++x);
-	}
+			if (n16) {
+				VDBlurBoxColumn8_SSE2(dst, sums, add, sub, n16, mult);
+				offset = n16 << 4;
+			}
+		}
+#endif
 
-	dst[0] = (src[0] + src[1]*3 + 2) >> 2;
-}
+		for(uint32 i=offset; i<n; ++i) {
+			const uint32 sum = sums[i];
 
-#ifdef _M_IX86
-static void __declspec(naked) docol_MMX(uint32 *dst, const uint32 *src1, const uint32 *src2, const uint32 *src3, uint32 w) {
-	__asm {
-		push		ebp
-		push		ebx
-
-		mov			eax,[esp+8+8]
-		mov			ebx,[esp+12+8]
-		mov			ecx,[esp+16+8]
-		mov			edx,[esp+4+8]
-		pxor		mm7,mm7
-		movq		mm6,mmx_offset2
-
-		mov			ebp,[esp+20+8]
-		shl			ebp,2
-		neg			ebp
-
-		sub			eax,ebp
-		sub			ebx,ebp
-		sub			ecx,ebp
-		sub			edx,ebp
-
-xloop:
-		movd		mm0,[eax+ebp]
-		movd		mm1,[ebx+ebp]
-		movd		mm2,[ecx+ebp]
-		punpcklbw	mm0,mm7
-		punpcklbw	mm1,mm7
-		punpcklbw	mm2,mm7
-		paddw		mm0,mm2
-		paddw		mm1,mm1
-		paddw		mm0,mm6
-		paddw		mm0,mm1
-		psraw		mm0,2
-		packuswb	mm0,mm0
-		movd		[edx+ebp],mm0
-
-		add			ebp,4
-		jne			xloop
-
-		pop			ebx
-		pop			ebp
-		ret
+			dst[i] = (uint8)((sum * mult) >> 16);
+			sums[i] = (uint16)(sum + add[i] - sub[i]);
+		}
 	}
-}
-#endif
 
-static void docol(uint32 *dst, const uint32 *row1, const uint32 *row2, const uint32 *row3, uint32 w) {
-#ifdef _M_IX86
-	if (MMX_enabled) {
-		docol_MMX(dst, row1, row2, row3, w);
-		return;
+	uint32 VDBlurGetBoxMultiplier(int radius) {
+		return 0xffff / (2*radius + 1) + 1;
 	}
-#endif
-
-	row1 += w;
-	row2 += w;
-	row3 += w;
-	dst += w;
 
-	ptrdiff_t x = -(ptrdiff_t)w;
-	do {
-		uint32 s1, s2, s3;
+	// Copies a row into the middle of a padded row, replicating the edge
+	// pixels into the left and right borders.
+	void VDBlurPadRow8(uint8 *dst, const uint8 *src, uint32 w, uint32 channels, uint32 left, uint32 right) {
+		const uint32 rowBytes = w * channels;
 
-		s1 = row1[x];
-		s2 = row2[x];
-		s3 = row3[x];
+		if (dst + left*channels != src)
+			memcpy(dst + left*channels, src, rowBytes);
 
-		dst[x+0]= ((((s1&0xFF00FF) + 2*(s2&0xFF00FF) + (s3&0xFF00FF) + 0x020002)>>2) & 0xFF00FF)
-				+ ((((s1&0x00FF00) + 2*(s2&0x00FF00) + (s3&0x00FF00) + 0x000200)>>2) & 0x00FF00);
+		for(uint32 i=0; i<left; ++i)
+			memcpy(dst + i*channels, src, channels);
 
-	} while(++x);
+		uint8 *dstRight = dst + (left + w)*channels;
+		const uint8 *srcRight = src + rowBytes - channels;
+		for(uint32 i=0; i<right; ++i)
+			memcpy(dstRight + i*channels, srcRight, channels);
+	}
 }
 
-static void docol_8(uint8 *dst, const uint8 *row1, const uint8 *row2, const uint8 *row3, uint32 w) {
-	row1 += w;
-	row2 += w;
-	row3 += w;
-	dst += w;
-
-	ptrdiff_t x = -(ptrdiff_t)w;
-	do {
-		uint32 s1, s2, s3;
+///////////////////////////////////////////////////////////////////////////
+//
+//	passes
+//
+///////////////////////////////////////////////////////////////////////////
 
-		s1 = row1[x];
-		s2 = row2[x];
-		s3 = row3[x];
+namespace {
+	class VDBlurHorizontalTask : public VDFilterRowTask {
+	public:
+		VDBlurHorizontalTask(void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch, uint32 w, uint32 channels, VDBlurEngine8::Kernel kernel, int radius, int passes)
+			: mpDst(dst), mDstPitch(dstpitch), mpSrc(src), mSrcPitch(srcpitch), mWidth(w), mChannels(channels), mKernel(kernel), mRadius(radius), mPasses(passes) {}
 
-		dst[x] = (uint8)((s1 + 2*s2 + s1 + 2) >> 2);
-	} while(++x);
-}
+		static size_t GetTempSize(uint32 w, uint32 channels, int radius) {
+			return 2 * (((w + 2*radius + 1) * channels + 15) & ~15);
+		}
 
-void VEffectBlur::run(const VDPixmap& vbm) {
-	run(vbm, vbm);
-}
+		void RunRows(uint32 y1, uint32 y2, void *tempBuf) {
+			const uint32 channels = mChannels;
+			const uint32 radius = mRadius;
+			const uint32 rowBytes = mWidth * channels;
+			const size_t paddedBytes = ((mWidth + 2*radius + 1) * channels + 15) & ~15;
+			uint8 *padA = (uint8 *)tempBuf;
+			uint8 *padB = padA + paddedBytes;
 
-void VEffectBlur::run(const VDPixmap& vbmdst, const VDPixmap& vbm) {
-	uint32 *srcr = (uint32 *)vbm.data;
-	uint32 *dstr = (uint32 *)vbmdst.data;
-	uint32 h;
-	int crow = 2;
-
-	if (vbm.h == 1) {
-		dorow(rows[0], srcr, vbm.w);
-		memcpy(srcr, rows[0], sizeof(uint32)*vbm.w);
-		return;
-	} else if (vbm.h == 2) {
-		dorow(rows[0], (const uint32 *)vbm.data, vbm.w);
-		dorow(rows[1], (const uint32 *)((const char *)vbm.data + vbm.pitch), vbm.w);
-		docol((uint32 *)vbmdst.data, rows[0], rows[0], rows[1], vbm.w);
-		docol((uint32 *)((char *)vbmdst.data + vbmdst.pitch), rows[1], rows[0], rows[0], vbm.w);
-		return;
-
-	}
+			for(uint32 y=y1; y<y2; ++y) {
+				const uint8 *src = (const uint8 *)mpSrc + mSrcPitch * y;
+				uint8 *dst = (uint8 *)mpDst + mDstPitch * y;
 
-	dorow(rows[0], srcr, vbm.w);
-	memcpy(rows[1], rows[0], sizeof(uint32)*vbm.w);
+				if (!radius) {
+					if (dst != src)
+						memcpy(dst, src, rowBytes);
+					continue;
+				}
 
-	h = vbm.h;
-	do {
-		if (h>1)
-			dorow(rows[crow], (uint32 *)((char *)srcr + vbm.pitch), vbm.w);
-		else
-			memcpy(rows[crow], rows[crow ? crow-1 : 2], vbm.w*sizeof(uint32));
+				VDBlurPadRow8(padA, src, mWidth, channels, radius, radius + 1);
 
-		switch(crow) {
-		case 0:	docol(dstr, rows[1], rows[2], rows[0], vbm.w); break;
-		case 1:	docol(dstr, rows[2], rows[0], rows[1], vbm.w); break;
-		case 2:	docol(dstr, rows[0], rows[1], rows[2], vbm.w); break;
-		}
+				if (mKernel == VDBlurEngine8::kKernelBinomial) {
+					const uint8 *taps[5];
 
-		if (++crow >= 3)
-			crow = 0;
+					for(uint32 i=0; i<=2*radius; ++i)
+						taps[i] = padA + channels*i;
 
-		srcr = (uint32 *)((char *)srcr + vbm.pitch);
-		dstr = (uint32 *)((char *)dstr + vbmdst.pitch);
-	} while(--h);
+					VDBlurBinomial8(dst, taps, rowBytes, radius);
+					continue;
+				}
 
-#ifdef _M_IX86
-	if (MMX_enabled)
-		__asm emms
-#endif
-}
+				const uint32 mult = VDBlurGetBoxMultiplier(radius);
+				uint8 *in = padA;
+				uint8 *out = padB;
 
-///////////////////////////////////////////////////////////////////////////
+				for(int pass=1; pass<mPasses; ++pass) {
+					uint8 *center = out + radius*channels;
 
-class VEffectBlurHi : public VEffect {
-public:
-	VEffectBlurHi(const VDPixmapLayout&);
-	~VEffectBlurHi();
+					VDBlurBoxRow8(center, in, mWidth, channels, radius, mult);
+					VDBlurPadRow8(out, center, mWidth, channels, radius, radius + 1);
+					std::swap(in, out);
+				}
 
-	void run(const VDPixmap&);
-	void run(const VDPixmap&, const VDPixmap&);
+				VDBlurBoxRow8(dst, in, mWidth, channels, radius, mult);
+			}
+		}
 
-private:
-	uint32 *rows[5];
+	protected:
+		void *const mpDst;
+		const ptrdiff_t mDstPitch;
+		const void *const mpSrc;
+		const ptrdiff_t mSrcPitch;
+		const uint32 mWidth;
+		const uint32 mChannels;
+		const VDBlurEngine8::Kernel mKernel;
+		const int mRadius;
+		const int mPasses;
+	};
+
+	class VDBlurVerticalTask : public VDFilterRowTask {
+	public:
+		VDBlurVerticalTask(void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch, uint32 rowBytes, uint32 h, VDBlurEngine8::Kernel kernel, int radius)
+			: mpDst(dst), mDstPitch(dstpitch), mpSrc(src), mSrcPitch(srcpitch), mRowBytes(rowBytes), mHeight(h), mKernel(kernel), mRadius(radius) {}
+
+		static size_t GetTempSize(uint32 rowBytes, VDBlurEngine8::Kernel kernel) {
+			return kernel == VDBlurEngine8::kKernelBox ? ((rowBytes + 15) & ~15) * 2 : 0;
+		}
 
-};
+		void RunRows(uint32 y1, uint32 y2, void *tempBuf) {
+			if (mKernel == VDBlurEngine8::kKernelBinomial)
+				RunBinomial(y1, y2);
+			else
+				RunBox(y1, y2, (uint16 *)tempBuf);
+		}
 
-///////////////////////////////////////////////////////////////////////////
+	protected:
+		const uint8 *GetSrcRow(sint32 y) const {
+			if (y < 0)
+				y = 0;
+			else if (y >= (sint32)mHeight)
+				y = mHeight - 1;
 
-VEffect *VCreateEffectBlurHi(const VDPixmapLayout& vbm) {
-	return new VEffectBlurHi(vbm);
-}
+			return (const uint8 *)mpSrc + mSrcPitch * y;
+		}
 
-VEffectBlurHi::VEffectBlurHi(const VDPixmapLayout& vbm) {
-	int i;
+		void RunBinomial(uint32 y1, uint32 y2) {
+			const uint8 *taps[5];
 
-	for(i=0; i<5; i++)
-		if (!(rows[i] = new uint32[vbm.w])) {
-			while(--i>=0)
-				delete rows[i];
+			for(uint32 y=y1; y<y2; ++y) {
+				for(int i=-mRadius; i<=mRadius; ++i)
+					taps[i + mRadius] = GetSrcRow((sint32)y + i);
 
-			throw MyMemoryError();
+				VDBlurBinomial8((uint8 *)mpDst + mDstPitch * y, taps, mRowBytes, mRadius);
+			}
 		}
-}
 
-VEffectBlurHi::~VEffectBlurHi() {
-	int i;
+		void RunBox(uint32 y1, uint32 y2, uint16 *sums) {
+			const uint32 mult = VDBlurGetBoxMultiplier(mRadius);
 
-	for(i=0; i<5; i++)
-		delete rows[i];
-}
-
-#ifdef _M_IX86
-static void __declspec(naked) dorow2_MMX(uint32 *dst, const uint32 *src, uint32 w) {
-	__asm {
-		mov		eax,[esp+8]
-		mov		edx,[esp+4]
-		pxor	mm7,mm7
-
-		;first pixel
-
-		movd		mm2,[eax]
-		movd		mm3,[eax+4]
-		movd		mm4,[eax+8]
-		punpcklbw	mm2,mm7
-		punpcklbw	mm3,mm7
-		punpcklbw	mm4,mm7
-
-		movq		mm0,mm2
-		movq		mm1,mm3
-		pmullw		mm0,mmx_by11
-		psllw		mm1,2
-		paddw		mm1,mm4
-		paddw		mm1,mmx_offset8
-		paddw		mm0,mm1
-		psraw		mm0,4
-		packuswb	mm0,mm0
-		movd		[edx],mm0
-
-		movd		mm5,[eax+12]
-		punpcklbw	mm5,mm7
-
-		movq		mm0,mm2
-		movq		mm1,mm3
-		paddw		mm0,mm4
-		pmullw		mm1,mmx_by6
-		psllw		mm0,2
-		paddw		mm0,mm2
-		paddw		mm0,mm5
-		paddw		mm0,mmx_offset8
-		paddw		mm0,mm1
-		psraw		mm0,4
-		packuswb	mm0,mm0
-		movd		[edx+4],mm0
-
-		;We stop when the counter overflows.  This is tricky, because we
-		;have to make sure we write at least 4 border pixels.
-		;
-		;	 9 pixels:	w*-4=-36, ecx=-4,	end ecx=+16
-		;	10 pixels:	w*-4=-40, ecx=-8,	end ecx=+12
-		;	11 pixels:	w*-4=-44, ecx=-12,	end ecx=+8
-		;	12 pixels:	w*-4=-48, ecx=-16,	end ecx=+4
-		;	13 pixels:	w*-4=-52, ecx=-20,	end ecx=+0
-		;	14 pixels:	w*-4=-56, ecx=-24,	end ecx=+16
-
-		mov			ecx,[esp+12]
-		shl			ecx,2
-		neg			ecx
-		add			ecx,32
-
-		sub			eax,ecx
-		sub			edx,ecx
-
-		;	mm2		pixel[-2]
-		;	mm3		pixel[-1]
-		;	mm4		pixel[ 0]
-		;	mm5		pixel[+1]
-		;	mm6		pixel[+2]	(to be loaded)
-		;	mm7		zero
-
-xloop:
-		movd		mm6,[eax+ecx+16]
-		movq		mm1,mm4
-		pmullw		mm1,mmx_by6
-		punpcklbw	mm6,mm7
-		movq		mm0,mm3
-		paddw		mm2,mm6
-		paddw		mm2,mmx_offset8
-		paddw		mm0,mm5
-		paddw		mm2,mm1
-		psllw		mm0,2
-		paddw		mm0,mm2
-		psraw		mm0,4
-		packuswb	mm0,mm0
-		movd		[edx+ecx+8],mm0
-
-		;	mm2		pixel[+2]	(to be loaded)
-		;	mm3		pixel[-2]
-		;	mm4		pixel[-1]
-		;	mm5		pixel[ 0]
-		;	mm6		pixel[+1]
-		;	mm7		zero
-
-		movd		mm2,[eax+ecx+20]
-		movq		mm1,mm5
-		pmullw		mm1,mmx_by6
-		punpcklbw	mm2,mm7
-		movq		mm0,mm4
-		paddw		mm3,mm2
-		paddw		mm3,mmx_offset8
-		paddw		mm0,mm6
-		paddw		mm3,mm1
-		psllw		mm0,2
-		paddw		mm0,mm3
-		psraw		mm0,4
-		packuswb	mm0,mm0
-		movd		[edx+ecx+12],mm0
-
-		;	mm2		pixel[+1]
-		;	mm3		pixel[+2]	(to be loaded)
-		;	mm4		pixel[-2]
-		;	mm5		pixel[-1]
-		;	mm6		pixel[ 0]
-		;	mm7		zero
-
-		movd		mm3,[eax+ecx+24]
-		movq		mm1,mm6
-		pmullw		mm1,mmx_by6
-		punpcklbw	mm3,mm7
-		movq		mm0,mm5
-		paddw		mm4,mm3
-		paddw		mm4,mmx_offset8
-		paddw		mm0,mm2
-		paddw		mm4,mm1
-		psllw		mm0,2
-		paddw		mm0,mm4
-		psraw		mm0,4
-		packuswb	mm0,mm0
-		movd		[edx+ecx+16],mm0
-
-		;	mm2		pixel[ 0]
-		;	mm3		pixel[+1]
-		;	mm4		pixel[+2]	(to be loaded)
-		;	mm5		pixel[-2]
-		;	mm6		pixel[-1]
-		;	mm7		zero
-
-		movd		mm4,[eax+ecx+28]
-		movq		mm1,mm2
-		pmullw		mm1,mmx_by6
-		punpcklbw	mm4,mm7
-		movq		mm0,mm6
-		paddw		mm5,mm4
-		paddw		mm5,mmx_offset8
-		paddw		mm0,mm3
-		paddw		mm5,mm1
-		psllw		mm0,2
-		paddw		mm0,mm5
-		psraw		mm0,4
-		packuswb	mm0,mm0
-		movd		[edx+ecx+20],mm0
-
-		;	mm2		pixel[-1]
-		;	mm3		pixel[ 0]
-		;	mm4		pixel[+1]
-		;	mm5		pixel[+2]	(to be loaded)
-		;	mm6		pixel[-2]
-		;	mm7		zero
-
-		movd		mm5,[eax+ecx+32]
-		movq		mm1,mm3
-		pmullw		mm1,mmx_by6
-		punpcklbw	mm5,mm7
-		movq		mm0,mm2
-		paddw		mm6,mm5
-		paddw		mm6,mmx_offset8
-		paddw		mm0,mm4
-		paddw		mm6,mm1
-		psllw		mm0,2
-		paddw		mm0,mm6
-		psraw		mm0,4
-		packuswb	mm0,mm0
-		movd		[edx+ecx+24],mm0
-
-		add			ecx,20
-		jnc			xloop
-
-		;last pixel
-		;
-		;	mm2		pixel[-2]
-		;	mm3		pixel[-1]
-		;	mm4		pixel[ 0]
-		;	mm5		pixel[+1]
-		;	mm6		pixel[+2]	(to be loaded)
-		;	mm7		zero
-		;
-
-oddloop:
-		cmp			ecx,16
-		jz			last2
-
-		movq		mm6,mm2
-		movq		mm2,mm3
-		movq		mm3,mm4
-		movq		mm4,mm5
-		movd		mm5,[eax+ecx+16]
-		movq		mm1,mm3
-		pmullw		mm1,mmx_by6
-		punpcklbw	mm5,mm7
-		movq		mm0,mm2
-		paddw		mm6,mm5
-		paddw		mm6,mmx_offset8
-		paddw		mm0,mm4
-		paddw		mm6,mm1
-		psllw		mm0,2
-		paddw		mm0,mm6
-		psraw		mm0,4
-		packuswb	mm0,mm0
-		movd		[edx+ecx+8],mm0
-
-		add			ecx,4
-		jmp			short oddloop
-
-		;	mm2		pixel[-2]
-		;	mm3		pixel[-1]
-		;	mm4		pixel[ 0]
-		;	mm5		pixel[+1]
-		;	mm7		zero
-last2:
-		movq		mm0,mm3
-		movq		mm1,mm3
-		pmullw		mm0,mmx_by6
-		paddw		mm1,mm5
-		paddw		mm2,mmx_offset8
-		psllw		mm1,2
-		paddw		mm1,mm5
-		paddw		mm0,mm2
-		paddw		mm0,mm1
-		psraw		mm0,4
-		packuswb	mm0,mm0
-		movd		[edx+16+8],mm0
-
-		;	mm3		pixel[-2]
-		;	mm4		pixel[-1]
-		;	mm5		pixel[ 0]
-		;	mm7		zero
-
-		pmullw		mm5,mmx_by11
-		psllw		mm4,2
-		paddw		mm4,mm3
-		paddw		mm4,mmx_offset8
-		paddw		mm4,mm5
-		psraw		mm4,4
-		packuswb	mm4,mm4
-		movd		[edx+20+8],mm0
-
-		ret
-	}
-}
-#endif
+			memset(sums, 0, mRowBytes * sizeof(uint16));
 
-static void dorow2(uint32 *dst, const uint32 *src, uint32 w) {
-	if (w < 4) {
-		dorow(dst, src, w);
-		return;
-	}
-
-#ifdef _M_IX86
-	if (MMX_enabled) {
-		dorow2_MMX(dst, src, w);
-		return;
-	}
-#endif
+			for(int i=-mRadius; i<=mRadius; ++i)
+				VDBlurAddRow8(sums, GetSrcRow((sint32)y1 + i), mRowBytes);
 
-	dst[0] = ((((src[0] & 0x00FF00FF)*11 + (src[1] & 0x00FF00FF)*4 + (src[2] & 0x00FF00FF) + 0x00080008)>>4) & 0x00FF00FF)
-		   + ((((src[0] & 0x0000FF00)*11 + (src[1] & 0x0000FF00)*4 + (src[2] & 0x0000FF00) + 0x00000800)>>4) & 0x0000FF00);
+			for(uint32 y=y1; y<y2; ++y) {
+				VDBlurBoxColumn8((uint8 *)mpDst + mDstPitch * y, sums, GetSrcRow((sint32)y + mRadius + 1), GetSrcRow((sint32)y - mRadius), mRowBytes, mult);
+			}
+		}
 
-	dst[1] = ((((src[0] & 0x00FF00FF)*5 + (src[1] & 0x00FF00FF)*6 + (src[2] & 0x00FF00FF)*4 + (src[3] & 0x00FF00FF) + 0x00080008)>>4) & 0x00FF00FF)
-		   + ((((src[0] & 0x0000FF00)*5 + (src[1] & 0x0000FF00)*6 + (src[2] & 0x0000FF00)*4 + (src[3] & 0x0000FF00) + 0x00000800)>>4) & 0x0000FF00);
+		void *const mpDst;
+		const ptrdiff_t mDstPitch;
+		const void *const mpSrc;
+		const ptrdiff_t mSrcPitch;
+		const uint32 mRowBytes;
+		const uint32 mHeight;
+		const VDBlurEngine8::Kernel mKernel;
+		const int mRadius;
+	};
+}
 
-	dst += 2;
+///////////////////////////////////////////////////////////////////////////
+//
+//	VDBlurEngine8
+//
+///////////////////////////////////////////////////////////////////////////
 
-	w -= 4;
-	if (w) {
-		src += w;
-		dst += w;
+VDBlurEngine8::VDBlurEngine8()
+	: mWidth(0)
+	, mHeight(0)
+	, mChannels(0)
+	, mKernel(kKernelBinomial)
+	, mRadiusH(0)
+	, mRadiusV(0)
+	, mPasses(0)
+	, mTempPitch(0)
+{
+}
 
-		ptrdiff_t x = -(ptrdiff_t)w;
-		do {
-			uint32 s1, s2, s3, s4, s5;
+void VDBlurEngine8::InitBinomial(uint32 w, uint32 h, uint32 channels, int radius) {
+	VDASSERT(radius == 1 || radius == 2);
 
-			s1 = src[x+0];
-			s2 = src[x+1];
-			s3 = src[x+2];
-			s4 = src[x+3];
-			s5 = src[x+4];
+	Init(w, h, channels, kKernelBinomial, radius, radius, 1);
+}
 
-			dst[x+0]= ((((s1&0xFF00FF) + 4*(s2&0xFF00FF) + 6*(s3&0xFF00FF) + 4*(s4&0xFF00FF) + (s5&0xFF00FF) + 0x080008)>>4) & 0xFF00FF)
-					+ ((((s1&0x00FF00) + 4*(s2&0x00FF00) + 6*(s3&0x00FF00) + 4*(s4&0x00FF00) + (s5&0x00FF00) + 0x000800)>>4) & 0x00FF00);
+void VDBlurEngine8::InitBox(uint32 w, uint32 h, uint32 channels, int radius, int passes) {
+	// The box can't be wider than the image, since the running sum only
+	// replicates the edges once.
+	int radiusH = radius;
+	int radiusV = radius;
 
-		} while(++x);
-	}
+	if (2*radiusH + 1 > (int)w)
+		radiusH = (w - 1) >> 1;
 
-	dst[0] = ((((src[0] & 0x00FF00FF) + (src[1] & 0x00FF00FF)*4 + (src[2] & 0x00FF00FF)*6 + (src[3] & 0x00FF00FF)*5 + 0x00080008)>>4) & 0x00FF00FF)
-		   + ((((src[0] & 0x0000FF00) + (src[1] & 0x0000FF00)*4 + (src[2] & 0x0000FF00)*6 + (src[3] & 0x0000FF00)*5 + 0x00000800)>>4) & 0x0000FF00);
+	if (2*radiusV + 1 > (int)h)
+		radiusV = (h - 1) >> 1;
 
-	dst[1] = ((((src[0] & 0x00FF00FF) + (src[1] & 0x00FF00FF)*4 + (src[2] & 0x00FF00FF)*11 + 0x00080008)>>4) & 0x00FF00FF)
-		   + ((((src[0] & 0x0000FF00) + (src[1] & 0x0000FF00)*4 + (src[2] & 0x0000FF00)*11 + 0x00000800)>>4) & 0x0000FF00);
+	Init(w, h, channels, kKernelBox, radiusH, radiusV, passes);
 }
 
-static void dorow2_8(unsigned char *dst, unsigned char *src, uint32 w) {
-	if (w < 4)
-		return;
+void VDBlurEngine8::Init(uint32 w, uint32 h, uint32 channels, Kernel kernel, int radiusH, int radiusV, int passes) {
+	mWidth = w;
+	mHeight = h;
+	mChannels = channels;
+	mKernel = kernel;
+	mRadiusH = radiusH;
+	mRadiusV = radiusV;
+	mPasses = passes;
+
+	mTempPitch = (w * channels + 15) & ~15;
+	mTempBuffer.resize(mTempPitch * h);
+}
 
-	dst[0] = (uint8)((src[0]*11 + src[1]*4 + src[2] + 8) >> 4);
-	dst[1] = (uint8)((src[0]*5 + src[1]*6 + src[2]*4 + src[3] + 8) >> 4);
+void VDBlurEngine8::Shutdown() {
+	vdfastvector<uint8, vdaligned_alloc<uint8> >().swap(mTempBuffer);
+}
 
-	dst += 2;
+void VDBlurEngine8::Run(void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch) {
+	const uint32 rowBytes = mWidth * mChannels;
+	const int vpasses = mRadiusV ? mPasses : 0;
+	uint8 *temp = mTempBuffer.data();
+
+	// Pick the target of the horizontal pass so that the last vertical
+	// pass lands in the destination.
+	void *hdst = dst;
+	ptrdiff_t hdstpitch = dstpitch;
+	if (vpasses & 1) {
+		hdst = temp;
+		hdstpitch = mTempPitch;
+	}
 
-	w -= 4;
-	if (w) {
-		src += w;
-		dst += w;
+	VDBlurHorizontalTask htask(hdst, hdstpitch, src, srcpitch, mWidth, mChannels, mKernel, mRadiusH, mPasses);
+	VDFilterRunRowTask(htask, mHeight, rowBytes * mPasses, VDBlurHorizontalTask::GetTempSize(mWidth, mChannels, mRadiusH));
 
-		ptrdiff_t x = -(ptrdiff_t)w;
-		do {
-			unsigned s1, s2, s3, s4, s5;
+	for(int pass=0; pass<vpasses; ++pass) {
+		void *vsrc = hdst;
+		ptrdiff_t vsrcpitch = hdstpitch;
+		void *vdst = temp;
+		ptrdiff_t vdstpitch = mTempPitch;
 
-			s1 = src[x+0];
-			s2 = src[x+1];
-			s3 = src[x+2];
-			s4 = src[x+3];
-			s5 = src[x+4];
+		if (hdst == temp) {
+			vdst = dst;
+			vdstpitch = dstpitch;
+		}
 
-			dst[x+0] = (uint8)((s1 + 4*s2 + 6*s3 + 4*s4 + s5 + 8) >> 4);
+		VDBlurVerticalTask vtask(vdst, vdstpitch, vsrc, vsrcpitch, rowBytes, mHeight, mKernel, mRadiusV);
+		VDFilterRunRowTask(vtask, mHeight, rowBytes, VDBlurVerticalTask::GetTempSize(rowBytes, mKernel));
 
-		} while(++x);
+		hdst = vdst;
+		hdstpitch = vdstpitch;
 	}
-
-	dst[0] = (uint8)((src[0] + src[1]*4 + src[2]*6 + src[3]*5 + 8) >> 4);
-	dst[1] = (uint8)((src[0] + src[1]*4 + src[2]*11 + 8) >> 4);
 }
 
-#ifdef _M_IX86
-static void __declspec(naked) docol2_MMX(uint32 *dst, uint32 *src1, uint32 *src2, uint32 *src3, uint32 *src4, uint32 *src5, uint32 w) {
-	__asm {
-		push		ebp
-		push		edi
-		push		esi
-		push		ebx
-
-		mov			eax,[esp+8+16]
-		mov			ebx,[esp+12+16]
-		mov			ecx,[esp+16+16]
-		mov			edx,[esp+20+16]
-		mov			esi,[esp+24+16]
-		mov			edi,[esp+4+16]
-		pxor		mm7,mm7
-		movq		mm6,mmx_offset8
-
-		mov			ebp,[esp+28+16]
-		shl			ebp,2
-		neg			ebp
-
-		sub			eax,ebp
-		sub			ebx,ebp
-		sub			ecx,ebp
-		sub			edx,ebp
-		sub			esi,ebp
-		sub			edi,ebp
-
-xloop:
-		movd		mm0,[eax+ebp]
-		movd		mm1,[ebx+ebp]
-		movd		mm2,[ecx+ebp]
-		movd		mm3,[edx+ebp]
-		movd		mm4,[esi+ebp]
-		punpcklbw	mm0,mm7
-		punpcklbw	mm1,mm7
-		punpcklbw	mm2,mm7
-		punpcklbw	mm3,mm7
-		punpcklbw	mm4,mm7
-		paddw		mm0,mm4
-		paddw		mm1,mm3
-		psllw		mm1,2
-		movq		mm5,mm2
-		paddw		mm2,mm2
-		paddw		mm2,mm5
-		paddw		mm2,mm2
-		paddw		mm0,mm1
-		paddw		mm0,mm2
-		paddw		mm0,mm6
-		psraw		mm0,4
-		packuswb	mm0,mm0
-		movd		[edi+ebp],mm0
-
-		add			ebp,4
-		jne			xloop
-
-		pop			ebx
-		pop			esi
-		pop			edi
-		pop			ebp
-		ret
-	}
-}
-#endif
+///////////////////////////////////////////////////////////////////////////
+//
+//	VEffectBlur / VEffectBlurHi
+//
+///////////////////////////////////////////////////////////////////////////
 
-static void docol2(uint32 *dst, uint32 *row1, uint32 *row2, uint32 *row3, uint32 *row4, uint32 *row5, uint32 w) {
-#ifdef _M_IX86
-	if (MMX_enabled) {
-		docol2_MMX(dst, row1, row2, row3, row4, row5, w);
-		return;
-	}
-#endif
+class VEffectBlur : public VEffect {
+public:
+	VEffectBlur(const VDPixmapLayout&, int radius);
 
-	row1 += w;
-	row2 += w;
-	row3 += w;
-	row4 += w;
-	row5 += w;
-	dst += w;
+	void run(const VDPixmap&);
+	void run(const VDPixmap&, const VDPixmap&);
 
-	ptrdiff_t x = -(ptrdiff_t)w;
-	do {
-		uint32 s1, s2, s3, s4, s5;
+private:
+	sint32 mFormat;
+	VDBlurEngine8 mEngine;
+};
 
-		s1 = row1[x];
-		s2 = row2[x];
-		s3 = row3[x];
-		s4 = row4[x];
-		s5 = row5[x];
+VEffect *VCreateEffectBlur(const VDPixmapLayout& vbm) {
+	return new VEffectBlur(vbm, 1);
+}
 
-		dst[x]= ((((s1&0xFF00FF) + 4*(s2&0xFF00FF) + 6*(s3&0xFF00FF) + 4*(s4&0xFF00FF) + (s5&0xFF00FF) + 0x080008)>>4) & 0xFF00FF)
-				+ ((((s1&0xFF00FF00)>>4) + ((s2&0xFF00FF00)>>2) + 3*((s3&0xFF00FF00)>>3) + ((s4&0xFF00FF00)>>2) + ((s5&0xFF00FF00)>>4) + 0x00800080) & 0xFF00FF00);
+VEffect *VCreateEffectBlurHi(const VDPixmapLayout& vbm) {
+	return new VEffectBlur(vbm, 2);
+}
 
-	} while(++x);
+VEffectBlur::VEffectBlur(const VDPixmapLayout& vbm, int radius)
+	: mFormat(vbm.format)
+{
+	mEngine.InitBinomial(vbm.w, vbm.h, vbm.format == nsVDPixmap::kPixFormat_Y8 ? 1 : 4, radius);
 }
 
-void VEffectBlurHi::run(const VDPixmap& vbm) {
+void VEffectBlur::run(const VDPixmap& vbm) {
 	run(vbm, vbm);
 }
 
-void VEffectBlurHi::run(const VDPixmap& vbmdst, const VDPixmap& vbm) {
-	if (vbmdst.format != vbm.format)
-		return;
-
-	bool mode8 = false;
-	if (vbmdst.format == nsVDXPixmap::kPixFormat_Y8)
-		mode8 = true;
-	else if (vbmdst.format != nsVDXPixmap::kPixFormat_XRGB8888)
-		return;
-
-	const uint32 *srcr = (const uint32 *)vbm.data;
-	uint32 *dstr = (uint32 *)vbmdst.data;
-	uint32 h;
-	int crow = 4;
-
-	int rowdwords = mode8 ? (vbm.w + 3) >> 2 : vbm.w;
-
-	if (vbm.h == 1) {
-		if (mode8)
-			dorow_8((uint8 *)rows[0], (const uint8 *)srcr, vbm.w);
-		else
-			dorow(rows[0], srcr, vbm.w);
-		memcpy(dstr, rows[0], sizeof(uint32)*vbm.w);
-		return;
-	} else if (vbm.h == 2) {
-		if (mode8) {
-			dorow_8((uint8 *)rows[0], (const uint8 *)vbm.data, vbm.w);
-			dorow_8((uint8 *)rows[1], (const uint8 *)((const char *)vbm.data + vbm.pitch), vbm.w);
-			docol_8((uint8 *)vbm.data, (const uint8 *)rows[0], (const uint8 *)rows[0], (const uint8 *)rows[1], vbm.w);
-			docol_8((uint8 *)((char *)vbm.data + vbm.pitch), (const uint8 *)rows[1], (const uint8 *)rows[0], (const uint8 *)rows[0], vbm.w);
-		} else {
-			dorow(rows[0], (const uint32 *)vbm.data, vbm.w);
-			dorow(rows[1], (const uint32 *)((const char *)vbm.data + vbm.pitch), vbm.w);
-			docol((uint32 *)vbm.data, rows[0], rows[0], rows[1], vbm.w);
-			docol((uint32 *)((char *)vbm.data + vbm.pitch), rows[1], rows[0], rows[0], vbm.w);
-		}
+void VEffectBlur::run(const VDPixmap& vbmdst, const VDPixmap& vbm) {
+	if (vbmdst.format != vbm.format || vbm.format != mFormat)
 		return;
 
-	}
-
-	if (mode8)
-		dorow2_8((unsigned char *)rows[0], (unsigned char *)srcr, vbm.w);
-	else
-		dorow2(rows[0], srcr, vbm.w);
-	memcpy(rows[1], rows[0], sizeof(uint32)*rowdwords);
-	memcpy(rows[2], rows[0], sizeof(uint32)*rowdwords);
-
-	if (mode8)
-		dorow2_8((unsigned char *)rows[3], (unsigned char *)((char *)srcr + vbm.pitch), vbm.w);
-	else
-		dorow2(rows[3], (uint32 *)((char *)srcr + vbm.pitch), vbm.w);
-
-	h = vbm.h;
-	do {
-		if (h>2) {
-			if (mode8)
-				dorow2_8((unsigned char *)rows[crow], (unsigned char *)((char *)srcr + vbm.pitch*2), vbm.w);
-			else
-				dorow2(rows[crow], (uint32 *)((char *)srcr + vbm.pitch*2), vbm.w);
-		} else
-			memcpy(rows[crow], rows[crow ? crow-1 : 4], rowdwords*sizeof(uint32));
-
-		switch(crow) {
-		case 0:	docol2(dstr, rows[1], rows[2], rows[3], rows[4], rows[0], rowdwords); break;
-		case 1:	docol2(dstr, rows[2], rows[3], rows[4], rows[0], rows[1], rowdwords); break;
-		case 2:	docol2(dstr, rows[3], rows[4], rows[0], rows[1], rows[2], rowdwords); break;
-		case 3:	docol2(dstr, rows[4], rows[0], rows[1], rows[2], rows[3], rowdwords); break;
-		case 4:	docol2(dstr, rows[0], rows[1], rows[2], rows[3], rows[4], rowdwords); break;
-		}
-
-		if (++crow >= 5)
-			crow = 0;
-
-		srcr = (uint32 *)((char *)srcr + vbm.pitch);
-		dstr = (uint32 *)((char *)dstr + vbmdst.pitch);
-	} while(--h);
-
-#ifdef _M_IX86
-	if (MMX_enabled)
-		__asm emms
-#endif
+	mEngine.Run(vbmdst.data, vbmdst.pitch, vbm.data, vbm.pitch);
 }
@@ -0,0 +1,45 @@
+//	VirtualDub - Video processing and capture application
+//	Internal filter library
+//	Copyright (C) 1998-2011 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <stdafx.h>
+#include <vd2/system/bandtask.h>
+#include <vd2/system/vdstl.h>
+#include "RowTask.h"
+
+namespace {
+	class VDFilterRowTaskAdapter : public VDRowTask {
+	public:
+		VDFilterRowTaskAdapter(VDFilterRowTask& task, size_t tempBytes) : mTask(task), mTempBytes(tempBytes) {}
+
+		void RunRows(uint32 y1, uint32 y2) {
+			vdfastvector<uint8, vdaligned_alloc<uint8> > tempbuf(mTempBytes);
+
+			mTask.RunRows(y1, y2, mTempBytes ? tempbuf.data() : NULL);
+		}
+
+	protected:
+		VDFilterRowTask& mTask;
+		const size_t mTempBytes;
+	};
+}
+
+void VDFilterRunRowTask(VDFilterRowTask& task, uint32 rows, uint32 rowBytes, size_t tempBytes) {
+	VDFilterRowTaskAdapter adapter(task, tempBytes);
+
+	VDRunRowTask(adapter, rows, rowBytes);
+}
@@ -16,7 +16,6 @@
 //	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 
 #include "stdafx.h"
-#include <vd2/system/vdalloc.h>
 #include <vd2/plugin/vdplugin.h>
 #include <vd2/plugin/vdvideofilt.h>
 #include <vd2/plugin/vdvideoaccel.h>
@@ -29,14 +28,23 @@
 
 class VDVFilterBlurBase : public VDXVideoFilter {
 public:
+	VDVFilterBlurBase(int radius);
+
 	uint32 GetParams();
+	void Start();
 	void End();
 	void Run();
 
 protected:
-	vdautoptr<VEffect> mpEffect;
+	const int mRadius;
+	VDBlurEngine8 mEngine;
 };
 
+VDVFilterBlurBase::VDVFilterBlurBase(int radius)
+	: mRadius(radius)
+{
+}
+
 uint32 VDVFilterBlurBase::GetParams() {
 	const VDXPixmapLayout& pxlsrc = *fa->src.mpPixmapLayout;
 	VDXPixmapLayout& pxldst = *fa->dst.mpPixmapLayout;
@@ -58,13 +66,20 @@ uint32 VDVFilterBlurBase::GetParams() {
 	}
 }
 
+void VDVFilterBlurBase::Start() {
+	const VDXPixmapLayout& pxldst = *fa->dst.mpPixmapLayout;
+
+	mEngine.InitBinomial(pxldst.w, pxldst.h, 4, mRadius);
+}
+
 void VDVFilterBlurBase::End() {
-	mpEffect = NULL;
+	mEngine.Shutdown();
 }
 
 void VDVFilterBlurBase::Run() {
-	if (mpEffect)
-		mpEffect->run((VDPixmap&)*fa->dst.mpPixmap);
+	const VDXPixmap& pxdst = *fa->dst.mpPixmap;
+
+	mEngine.Run(pxdst.data, pxdst.pitch, pxdst.data, pxdst.pitch);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -73,8 +88,6 @@ class VDVFilterBlur : public VDVFilterBlurBase {
 public:
 	VDVFilterBlur();
 
-	void Start();
-
 	void StartAccel(IVDXAContext *vdxa);
 	void RunAccel(IVDXAContext *vdxa);
 	void EndAccel(IVDXAContext *vdxa);
@@ -84,16 +97,11 @@ protected:
 };
 
 VDVFilterBlur::VDVFilterBlur()
-	: mAccelFP(0)
+	: VDVFilterBlurBase(1)
+	, mAccelFP(0)
 {
 }
 
-void VDVFilterBlur::Start() {
-	mpEffect = VCreateEffectBlur((VDPixmapLayout&)*fa->dst.mpPixmapLayout);
-	if (!mpEffect)
-		ff->ExceptOutOfMemory();
-}
-
 void VDVFilterBlur::StartAccel(IVDXAContext *vdxa) {
 	mAccelFP = vdxa->CreateFragmentProgram(kVDXAPF_D3D9ByteCodePS20, kVDFilterBlurPS, sizeof kVDFilterBlurPS);
 }
@@ -121,8 +129,6 @@ class VDVFilterBlurHi : public VDVFilterBlurBase {
 public:
 	VDVFilterBlurHi();
 
-	void Start();
-
 	void StartAccel(IVDXAContext *vdxa);
 	void RunAccel(IVDXAContext *vdxa);
 	void EndAccel(IVDXAContext *vdxa);
@@ -132,16 +138,11 @@ protected:
 };
 
 VDVFilterBlurHi::VDVFilterBlurHi()
-	: mAccelFP(0)
+	: VDVFilterBlurBase(2)
+	, mAccelFP(0)
 {
 }
 
-void VDVFilterBlurHi::Start() {
-	mpEffect = VCreateEffectBlurHi((VDPixmapLayout&)*fa->dst.mpPixmapLayout);
-	if (!mpEffect)
-		ff->ExceptOutOfMemory();
-}
-
 void VDVFilterBlurHi::StartAccel(IVDXAContext *vdxa) {
 	mAccelFP = vdxa->CreateFragmentProgram(kVDXAPF_D3D9ByteCodePS20, kVDFilterBlurMorePS, sizeof kVDFilterBlurMorePS);
 }
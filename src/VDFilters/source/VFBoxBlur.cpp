@@ -14,22 +14,6 @@
 //	You should have received a copy of the GNU General Public License
 //	along with this program; if not, write to the Free Software
 //	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
-//
-/////////////////////////////////////////////////////////////////////////////
-//
-//	COMPILER BUG WARNING:
-//
-//	VC6 will sometimes miscompile expressions having both downcasts and
-//	upcasts:
-//
-//		// compile with /O2axb2 /G6s
-//		void foo(unsigned short *dst, unsigned v, int mul) {
-//			*dst = (int)(unsigned char)(v>>8) * mul;
-//
-//	The emitted code is missing the truncating downcast to unsigned
-//	char, and thus fails to separate channels properly.  To work around
-//	the problem, this filter now explicitly does (&255).  The bug is
-//	not present in Visual Studio .NET (2003).
 
 #include "stdafx.h"
 
@@ -37,15 +21,9 @@
 #include <commctrl.h>
 
 #include "resource.h"
-#include <vd2/system/cpuaccel.h>
-#include <vd2/system/memory.h>
+#include "Blur.h"
 
 extern HINSTANCE g_hInst;
-extern "C" unsigned char YUV_clip_table[];
-
-#if defined(VD_COMPILER_MSVC) && defined(VD_CPU_X86)
-	#pragma warning(disable: 4799)		// warning C4799: function has no EMMS instruction
-#endif
 
 ///////////////////////////////////////////////////////////////////////////
 
@@ -61,12 +39,9 @@ bool boxFssProc(VDXFilterActivation *fa, const VDXFilterFunctions *ff, char *buf
 
 ///////////////////////////////////////////////////////////////////////////
 
-typedef unsigned short uint16;
-
 typedef struct BoxFilterData {
 	IVDXFilterPreview *ifp;
-	uint32 *rows;
-	uint16 *trow;
+	VDBlurEngine8 *engine;
 	int 	filter_width;
 	int 	filter_power;
 } BoxFilterData;
@@ -84,7 +59,7 @@ extern const VDXFilterDefinition g_VDVFBoxBlur = {
 
 	NULL, NULL, NULL,		// next, prev, module
 	"box blur",					// name
-	"Performs a fast box, triangle, or cubic blur.",
+	"Performs a fast box, triangle, or cubic blur.\n\n[SSE2 optimized]",
 							// desc
 	NULL,					// maker
 	NULL,					// private_data
@@ -125,510 +100,27 @@ int boxStartProc(VDXFilterActivation *fa, const VDXFilterFunctions *ff) {
 	if (mfd->filter_width < 1)
 		mfd->filter_width = 1;
 
-	mfd->trow = NULL;
-
-	if (!(mfd->rows = (uint32 *)malloc(((fa->dst.w+1)&-2)*4*fa->dst.h)))
+	if (!(mfd->engine = new_nothrow VDBlurEngine8))
 		return 1;
 
-	if (!(mfd->trow = (uint16 *)malloc(fa->dst.w*8)))
-		return 1;
+	mfd->engine->InitBox(fa->dst.w, fa->dst.h, 4, mfd->filter_width, mfd->filter_power);
 
 	return 0;
 }
 
-static void box_filter_row(uint32 *dst, uint32 *src, int filtwidth, int cnt, int mult) {
-	int i;
-	unsigned r, g, b;
-	uint32 A, B;
-
-	A = src[0];
-	r = (int)((A>>16)&255) * filtwidth;
-	g = (int)((A>> 8)&255) * filtwidth;
-	b = (int)((A    )&255) * filtwidth;
-
-	i = filtwidth + 1;
-	do {
-		B = *src++;
-
-		r += (int)((B>>16) & 255);
-		g += (int)((B>> 8) & 255);
-		b += (int)((B    ) & 255);
-	} while(--i);
-
-	i = filtwidth;
-
-	do {
-		*dst++ = ((r*mult)&0xff0000) + (((g*mult)>>8)&0xff00) + ((b*mult)>>16);
-
-		B = src[0];
-		++src;
-
-		r = r - (int)((A>>16) & 255) + (int)((B>>16) & 255);
-		g = g - (int)((A>> 8) & 255) + (int)((B>> 8) & 255);
-		b = b - (int)((A    ) & 255) + (int)((B    ) & 255);
-
-	} while(--i);
-
-	i = cnt - 2*filtwidth - 1;
-	do {
-		*dst++ = ((r*mult)&0xff0000) + (((g*mult)>>8)&0xff00) + ((b*mult)>>16);
-
-		A = src[-(2*filtwidth+1)];
-		B = src[0];
-		++src;
-
-		r = r - (int)((A>>16) & 255) + (int)((B>>16) & 255);
-		g = g - (int)((A>> 8) & 255) + (int)((B>> 8) & 255);
-		b = b - (int)((A    ) & 255) + (int)((B    ) & 255);
-	} while(--i);
-
-	i = filtwidth;
-	do {
-		*dst++ = ((r*mult)&0xff0000) + (((g*mult)>>8)&0xff00) + ((b*mult)>>16);
-
-		A = src[-(2*filtwidth+1)];
-		++src;
-
-		r = r - (int)((A>>16) & 255) + (int)((B>>16) & 255);
-		g = g - (int)((A>> 8) & 255) + (int)((B>> 8) & 255);
-		b = b - (int)((A    ) & 255) + (int)((B    ) & 255);
-
-	} while(--i);
-
-	*dst = ((r*mult)&0xff0000) + (((g*mult)>>8)&0xff00) + ((b*mult)>>16);
-}
-
-#ifdef _M_IX86
-static void __declspec(naked) box_filter_row_MMX(uint32 *dst, uint32 *src, int filtwidth, int cnt, int divisor) {
-	__asm {
-		push		ebx
-
-		mov			ecx,[esp+12+4]			;ecx = filtwidth
-		mov			eax,[esp+8+4]			;eax = src
-		movd		mm6,ecx
-		pxor		mm7,mm7
-		movd		mm5,[eax]				;A = source pixel
-		punpcklwd	mm6,mm6
-		pcmpeqw		mm4,mm4					;mm4 = all -1's
-		punpckldq	mm6,mm6
-		psubw		mm6,mm4					;mm6 = filtwidth+1
-		punpcklbw	mm5,mm7					;mm5 = src[0] (word)
-		movq		mm0,mm5					;mm0 = A
-		pmullw		mm5,mm6					;mm5 = src[0]*(filtwidth+1)
-		add			eax,4					;next source pixel
-xloop1:
-		movd		mm1,[eax]				;B = next source pixel
-		pxor		mm7,mm7
-		punpcklbw	mm1,mm7
-		add			eax,4
-		paddw		mm5,mm1
-		dec			ecx
-		jne			xloop1
-
-		mov			ecx,[esp+12+4]			;ecx = filtwidth
-		movd		mm6,[esp+20+4]
-		punpcklwd	mm6,mm6
-		mov			edx,[esp+4+4]			;edx = dst
-		punpckldq	mm6,mm6
-xloop2:
-		movd		mm1,[eax]				;B = next source pixel
-		movq		mm2,mm5					;mm1 = accum
-
-		pmulhw		mm2,mm6
-		punpcklbw	mm1,mm7
-
-		psubw		mm5,mm0					;accum -= A
-		add			eax,4
-
-		paddw		mm5,mm1					;accum += B
-		add			edx,4
-
-		packuswb	mm2,mm2
-		dec			ecx
-
-		movd		[edx-4],mm2
-		jne			xloop2
-
-		;main loop.
-		
-		mov			ebx,[esp+12+4]			;ebx = filtwidth
-		mov			ecx,[esp+16+4]			;ecx = cnt
-		lea			ebx,[ebx+ebx+1]			;ebx = 2*filtwidth+1
-		sub			ecx,ebx					;ecx = cnt - (2*filtwidth+1)
-		jz			xloop3e
-		shl			ebx,2
-		neg			ebx						;ebx = -4*(2*filtwidth+1)
-xloop3:
-		movd		mm0,[eax+ebx]			;mm0 = A = src[-(2*filtwidth+1)]
-		movq		mm2,mm5
-
-		movd		mm1,[eax]				;mm0 = B = src[0]
-		pmulhw		mm2,mm6
-
-		punpcklbw	mm0,mm7
-		add			edx,4
-
-		punpcklbw	mm1,mm7
-		add			eax,4
-
-		psubw		mm5,mm0					;accum -= A
-		packuswb	mm2,mm2					;pack finished pixel
-
-		paddw		mm5,mm1					;accum += B
-		dec			ecx
-
-		movd		[edx-4],mm2
-		jne			xloop3
-xloop3e:
-
-		;finish up remaining pixels
-
-		mov			ecx,[esp+12+4]			;ecx = filtwidth
-xloop4:
-		movd		mm0,[eax+ebx]			;mm0 = A = src[-(2*filtwidth+1)]
-		movq		mm2,mm5
-
-		pmulhw		mm2,mm6
-		add			edx,4
-
-		punpcklbw	mm0,mm7
-		add			eax,4
-
-		psubw		mm5,mm0					;accum -= A
-		packuswb	mm2,mm2					;pack finished pixel
-
-		paddw		mm5,mm1					;accum += B
-		dec			ecx
-
-		movd		[edx-4],mm2
-		jne			xloop4
-
-		pmulhw		mm5,mm6
-		packuswb	mm5,mm5
-		movd		[edx],mm5
-
-		pop			ebx
-		ret
-	}
-}
-#endif
-
-///////////////////////////////////////////////////////////////////////////
-
-static void box_filter_mult_row(uint16 *dst, uint32 *src, int cnt, int mult) {
-	uint32 A;
-
-#ifdef _M_IX86
-	if (MMX_enabled)
-		__asm {
-			mov			eax,src
-			movd		mm6,mult
-			mov			edx,dst
-			punpcklwd	mm6,mm6
-			mov			ecx,cnt
-			punpckldq	mm6,mm6
-xloop:
-			movd		mm0,[eax+ecx*4-4]
-			pxor		mm7,mm7
-
-			punpcklbw	mm0,mm7
-
-			pmullw		mm0,mm6
-
-			movq		[edx+ecx*8-8],mm0
-
-			dec			ecx
-			jne			xloop
-		}
-	else
-#endif
-		do {
-			A = *src++;
-
-			dst[0] = (uint16)((int)((A>>16) & 255) * mult);
-			dst[1] = (uint16)((int)((A>> 8) & 255) * mult);
-			dst[2] = (uint16)((int)((A    ) & 255) * mult);
-
-			dst += 3;
-		} while(--cnt);
-}
-
-static void box_filter_add_row(uint16 *dst, uint32 *src, int cnt) {
-	uint32 A;
-
-#ifdef _M_IX86
-	if (MMX_enabled)
-		__asm {
-			mov			eax,src
-			mov			edx,dst
-			mov			ecx,cnt
-xloop:
-			movd		mm0,[eax+ecx*4-4]
-			pxor		mm7,mm7
-
-			punpcklbw	mm0,mm7
-
-			paddw		mm0,[edx+ecx*8-8]
-
-			movq		[edx+ecx*8-8],mm0
-
-			dec			ecx
-			jne			xloop
-		}
-	else
-#endif
-		do {
-			A = *src++;
-
-			dst[0] = (uint16)(dst[0] + ((A>>16) & 255));
-			dst[1] = (uint16)(dst[1] + ((A>> 8) & 255));
-			dst[2] = (uint16)(dst[2] + ((A    ) & 255));
-
-			dst += 3;
-		} while(--cnt);
-}
-
-static void box_filter_produce_row(uint32 *dst, uint16 *tmp, uint32 *src_add, uint32 *src_sub, int cnt, int filter_width) {
-	uint32 A, B;
-	uint16 r, g, b;
-	int mult = 0xffff / (2*filter_width+1) + 1;
-
-#ifdef _M_IX86
-	if (MMX_enabled)
-		__asm {
-			mov			eax,src_add
-			movd		mm6,mult
-			mov			edx,tmp
-			punpcklwd	mm6,mm6
-			mov			ecx,cnt
-			punpckldq	mm6,mm6
-			mov			ebx,src_sub
-			mov			edi,dst
-xloop:
-			movq		mm2,[edx+ecx*8-8]
-			pxor		mm7,mm7
-
-			movd		mm0,[eax+ecx*4-4]
-			movq		mm3,mm2
-
-			movd		mm1,[ebx+ecx*4-4]
-			pmulhw		mm2,mm6
-
-			punpcklbw	mm0,mm7
-			;
-
-			punpcklbw	mm1,mm7
-			paddw		mm0,mm3
-
-			psubw		mm0,mm1
-			packuswb	mm2,mm2
-
-			movq		[edx+ecx*8-8],mm0
-
-			movd		[edi+ecx*4-4],mm2
-
-			dec			ecx
-			jne			xloop
-		}
-	else
-#endif
-		do {
-			A = *src_add++;
-			B = *src_sub++;
-
-			r = tmp[0];
-			g = tmp[1];
-			b = tmp[2];
-
-			*dst++	= ((r*mult) & 0xff0000)
-					+(((g*mult) & 0xff0000) >> 8)
-					+ ((b*mult) >> 16);
-
-			tmp[0] = (uint16)(r + ((A>>16)&255) - ((B>>16) & 255));
-			tmp[1] = (uint16)(g + ((A>> 8)&255) - ((B>> 8) & 255));
-			tmp[2] = (uint16)(b + ((A    )&255) - ((B    ) & 255));
-
-			tmp += 3;
-		} while(--cnt);
-}
-
-static void box_filter_produce_row2(uint32 *dst, uint16 *tmp, int cnt, int filter_width) {
-	uint16 r, g, b;
-	int mult = 0xffff / (2*filter_width+1) + 1;
-
-#ifdef _M_IX86
-	if (MMX_enabled)
-		__asm {
-			movd		mm6,mult
-			mov			eax,tmp
-			punpcklwd	mm6,mm6
-			mov			ecx,cnt
-			punpckldq	mm6,mm6
-			mov			edx,dst
-xloop:
-			movq		mm2,[eax+ecx*8-8]
-			pxor		mm7,mm7
-
-			pmulhw		mm2,mm6
-
-			packuswb	mm2,mm2
-
-			movd		[edx+ecx*4-4],mm2
-
-			dec			ecx
-			jne			xloop
-		}
-	else
-#endif
-		do {
-			r = tmp[0];
-			g = tmp[1];
-			b = tmp[2];
-
-			*dst++	= ((r*mult) & 0xff0000)
-					+(((g*mult) & 0xff0000) >> 8)
-					+ ((b*mult) >> 16);
-
-			tmp += 3;
-		} while(--cnt);
-}
-
-///////////////////////////////////////////////////////////////////////
-
-static void box_do_vertical_pass(uint32 *dst, ptrdiff_t dstpitch, uint32 *src, ptrdiff_t srcpitch, uint16 *trow, int w, int h, int filtwidth) {
-	uint32 *srch = src;
-	int j;
-
-	box_filter_mult_row(trow, src, w, filtwidth + 1);
-
-	src = (uint32 *)((char *)src + srcpitch);
-
-	for(j=0; j<filtwidth; j++) {
-		box_filter_add_row(trow, src, w);
-
-		src = (uint32 *)((char *)src + srcpitch);
-	}
-
-	for(j=0; j<filtwidth; j++) {
-		box_filter_produce_row(dst, trow, src, srch, w, filtwidth);
-
-		src = (uint32 *)((char *)src + srcpitch);
-		dst = (uint32 *)((char *)dst + dstpitch);
-	}
-	
-	for(j=0; j<h - (2*filtwidth+1); j++) {
-		box_filter_produce_row(dst, trow, src, (uint32 *)((char *)src - srcpitch*(2*filtwidth+1)), w, filtwidth);
-
-		src = (uint32 *)((char *)src + srcpitch);
-		dst = (uint32 *)((char *)dst + dstpitch);
-	}
-
-	srch = (uint32 *)((char *)src - srcpitch);
-
-	for(j=0; j<filtwidth; j++) {
-		box_filter_produce_row(dst, trow, srch, (uint32 *)((char *)src - srcpitch*(2*filtwidth+1)), w, filtwidth);
-
-		src = (uint32 *)((char *)src + srcpitch);
-		dst = (uint32 *)((char *)dst + dstpitch);
-	}
-
-	box_filter_produce_row2(dst, trow, w, filtwidth);
-}
-
 int boxRunProc(const VDXFilterActivation *fa, const VDXFilterFunctions *ff) {
 	BoxFilterData *mfd = (BoxFilterData *)fa->filter_data;
-	uint32 h;
-	uint32 *src, *dst;
-	uint32 *tmp;
-	ptrdiff_t srcpitch, dstpitch;
-	int i;
-
-	src = fa->src.data;
-	dst = fa->dst.data;
-	tmp = mfd->rows;
-
-	// Horizontal filtering.
-	int hfiltwidth = mfd->filter_width;
-
-	if (hfiltwidth * 2 + 1 > fa->dst.w)
-		hfiltwidth = (fa->dst.w - 1) >> 1;
-
-	if (hfiltwidth > 0) {
-#ifdef _M_IX86
-		void (*const pRowFilt)(uint32*, uint32*, int, int, int) = MMX_enabled ? box_filter_row_MMX : box_filter_row;
-#else
-		void (*const pRowFilt)(uint32*, uint32*, int, int, int) = box_filter_row;
-#endif
-		int mult = 0xffff / (2*hfiltwidth+1) + 1;
-
-		h = fa->src.h;
-		do {
-			switch(mfd->filter_power) {
-			case 1:
-				pRowFilt(tmp, src, hfiltwidth, fa->dst.w, mult);
-				break;
-			case 2:
-				pRowFilt(tmp, src, hfiltwidth, fa->dst.w, mult);
-				pRowFilt(dst, tmp, hfiltwidth, fa->dst.w, mult);
-				break;
-			case 3:
-				pRowFilt(tmp, src, hfiltwidth, fa->dst.w, mult);
-				pRowFilt(dst, tmp, hfiltwidth, fa->dst.w, mult);
-				pRowFilt(tmp, dst, hfiltwidth, fa->dst.w, mult);
-				break;
-			}
 
-			src = (uint32 *)((char *)src + fa->src.pitch);
-			dst = (uint32 *)((char *)dst + fa->dst.pitch);
-			tmp += (fa->dst.w+1)&-2;
-		} while(--h);
-	} else if (mfd->filter_power & 1){
-		VDMemcpyRect(tmp, ((fa->dst.w + 1) & -2)*4, src, fa->src.pitch, fa->src.w * 4, fa->src.h);
-	}
-
-	// Vertical filtering.
-
-	if (mfd->filter_power & 1) {
-		src = mfd->rows;
-		dst = fa->dst.data;
-		srcpitch = ((fa->dst.w+1)&-2)*4;
-		dstpitch = fa->dst.pitch;
-	} else {
-		src = fa->dst.data;
-		dst = mfd->rows;
-		srcpitch = fa->dst.pitch;
-		dstpitch = ((fa->dst.w+1)&-2)*4;
-	}
-
-	int vfiltwidth = mfd->filter_width;
-	if (2*vfiltwidth+1 > fa->dst.h)
-		vfiltwidth = (fa->dst.h - 1) >> 1;
-
-	if (vfiltwidth > 0) {
-		for(i=0; i<mfd->filter_power; i++) {
-			if (i & 1)
-				box_do_vertical_pass(src, srcpitch, dst, dstpitch, mfd->trow, fa->dst.w, fa->dst.h, vfiltwidth);
-			else
-				box_do_vertical_pass(dst, dstpitch, src, srcpitch, mfd->trow, fa->dst.w, fa->dst.h, vfiltwidth);
-		}
-	} else if (mfd->filter_power & 1) {
-		VDMemcpyRect(dst, dstpitch, src, srcpitch, fa->dst.w * 4, fa->dst.h);
-	}
-
-#ifdef _M_IX86
-	if (MMX_enabled)
-		__asm emms
-#endif
+	mfd->engine->Run(fa->dst.data, fa->dst.pitch, fa->src.data, fa->src.pitch);
 
 	return 0;
 }
 
-
 int boxEndProc(VDXFilterActivation *fa, const VDXFilterFunctions *ff) {
 	BoxFilterData *mfd = (BoxFilterData *)fa->filter_data;
 
-	free(mfd->rows);	mfd->rows = NULL;
-	free(mfd->trow);	mfd->trow = NULL;
+	delete mfd->engine;
+	mfd->engine = NULL;
 
 	return 0;
 }
@@ -144,6 +144,7 @@ public:
 	uint32 GetParams();
 	void Start();
 	void Run();
+	bool OnGetPointTable(const VDXFilterPointTable& table);
 
 	void StartAccel(IVDXAContext *vdxa);
 	void RunAccel(IVDXAContext *vdxa);
@@ -291,6 +292,42 @@ void VDVFilterBrightCont::Start() {
 	mConfig.RedoTables();
 }
 
+bool VDVFilterBrightCont::OnGetPointTable(const VDXFilterPointTable& table) {
+	const uint8 *ytab = mConfig.mYLookup;
+	const uint8 *ctab = mConfig.mCLookup;
+
+	// These must match the tables used by Run() for each format.
+	switch(fa->dst.mpPixmapLayout->format) {
+		case nsVDXPixmap::kPixFormat_XRGB8888:
+		case nsVDXPixmap::kPixFormat_RGB888:
+			ytab = mConfig.mLookup;
+			ctab = mConfig.mLookup;
+			break;
+
+		case nsVDXPixmap::kPixFormat_YUV410_Planar:
+		case nsVDXPixmap::kPixFormat_YUV410_Planar_709:
+		case nsVDXPixmap::kPixFormat_YUV444_Planar_FR:
+		case nsVDXPixmap::kPixFormat_YUV422_Planar_FR:
+		case nsVDXPixmap::kPixFormat_YUV420_Planar_FR:
+		case nsVDXPixmap::kPixFormat_YUV420i_Planar_FR:
+		case nsVDXPixmap::kPixFormat_YUV411_Planar_FR:
+		case nsVDXPixmap::kPixFormat_YUV410_Planar_FR:
+		case nsVDXPixmap::kPixFormat_YUV444_Planar_709_FR:
+		case nsVDXPixmap::kPixFormat_YUV422_Planar_709_FR:
+		case nsVDXPixmap::kPixFormat_YUV420_Planar_709_FR:
+		case nsVDXPixmap::kPixFormat_YUV420i_Planar_709_FR:
+		case nsVDXPixmap::kPixFormat_YUV411_Planar_709_FR:
+		case nsVDXPixmap::kPixFormat_YUV410_Planar_709_FR:
+			ytab = mConfig.mLookup;
+			break;
+	}
+
+	memcpy(table.mpTables[0], ytab, 256);
+	memcpy(table.mpTables[1], ctab, 256);
+	memcpy(table.mpTables[2], ctab, 256);
+	return true;
+}
+
 uint32 VDVFilterBrightCont::GetParams() {
 	const VDXPixmapLayout& srcLayout = *fa->src.mpPixmapLayout;
 	VDXPixmapLayout& dstLayout = *fa->dst.mpPixmapLayout;
@@ -335,7 +372,7 @@ uint32 VDVFilterBrightCont::GetParams() {
 
 	dstLayout.pitch = srcLayout.pitch;
 
-	return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM;
+	return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM | FILTERPARAM_POINT_TRANSFORM;
 }
 
 void VDVFilterBrightCont::StartAccel(IVDXAContext *vdxa) {
@@ -30,6 +30,7 @@
 #include <vd2/plugin/vdvideoaccel.h>
 
 #include "VFDeinterlace.inl"
+#include "RowTask.h"
 
 #if defined(VD_COMPILER_MSVC) && defined(VD_CPU_X86)
 	#pragma warning(disable: 4799)		// warning C4799: function has no EMMS instruction
@@ -1325,13 +1326,13 @@ namespace {
 		} while(--w);
 	}
 
-	void BlendScanLine_NELA_scalar(void *dst, const void *srcT, const void *srcB, uint32 w, uint8 *tempBuf) {
+	void BlendScanLine_NELA_scalar(void *dst, const void *srcT, const void *srcB, uint32 w, void *tempBuf) {
 		const uint8 *srcat = (const uint8 *)srcT;
 		const uint8 *srcab = (const uint8 *)srcB;
 		uint32 w16 = (w + 15) >> 4;
 		uint32 wr = w16 << 4;
 
-		uint8 *elabuf = tempBuf;
+		uint8 *elabuf = (uint8 *)tempBuf;
 		uint8 *topbuf = elabuf + 10*wr;
 		uint8 *botbuf = topbuf + wr + 32;
 
@@ -1613,11 +1614,11 @@ xloop:
 	}
 #endif
 
-	void BlendScanLine_NELA_SSE2(void *dst, const void *srcT, const void *srcB, uint32 w, __m128i *tempBuf) {
+	void BlendScanLine_NELA_SSE2(void *dst, const void *srcT, const void *srcB, uint32 w, void *tempBuf) {
 		const __m128i *srcat = (const __m128i *)srcT;
 		const __m128i *srcab = (const __m128i *)srcB;
 		uint32 w16 = (w + 15) >> 4;
-		__m128i *elabuf = tempBuf;
+		__m128i *elabuf = (__m128i *)tempBuf;
 		__m128i *topbuf = elabuf + 10*w16;
 		__m128i *botbuf = topbuf + w16 + 2;
 
@@ -1649,71 +1650,211 @@ xloop:
 		nela_L8_SSE2((__m128i *)dst, elabuf, w16);
 	}
 
-	void InterpPlane_NELA_X8R8G8B8(void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch, uint32 w, uint32 h, bool interpField2) {
-		uint32 w16 = (w + 15) >> 4;
-		vdfastvector<uint8, vdaligned_alloc<uint8> > tempbuf((12 * w16 + 4) * 16);
-		void *elabuf = tempbuf.data();
+	// Computes the smoothed edge score 2*e[1] + e[0] + e[2] for four pixels.
+	inline __m128i ELAScore_X8R8G8B8_SSE2(const uint32 *e) {
+		const __m128i c = _mm_loadu_si128((const __m128i *)(e + 1));
 
-		if (!interpField2)
-			memcpy(dst, src, w16 << 4);
+		return _mm_add_epi32(_mm_add_epi32(c, c), _mm_add_epi32(_mm_loadu_si128((const __m128i *)e), _mm_loadu_si128((const __m128i *)(e + 2))));
+	}
 
-		int y0 = interpField2 ? 1 : 2;
-		for(uint32 y = y0; y < h - 1; y += 2) {
-			const __m128i *srcat = (const __m128i *)((const char *)src + srcpitch * (y-1));
-			const __m128i *srcab = (const __m128i *)((const char *)src + srcpitch * (y+1));
+	inline __m128i ELASelect_SSE2(__m128i mask, __m128i a, __m128i b) {
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
 
-#if defined(VD_CPU_X86)
-			if (MMX_enabled)
-				BlendScanLine_NELA_X8R8G8B8_MMX((char *)dst + dstpitch*y, srcat, srcab, w, (uint8 *)elabuf);
-			else
-#endif
-				BlendScanLine_NELA_X8R8G8B8_scalar((char *)dst + dstpitch*y, srcat, srcab, w, (uint8 *)elabuf);
+	void BlendScanLine_NELA_X8R8G8B8_SSE2(void *dst, const void *srcT, const void *srcB, uint32 w, void *tempBuf) {
+		const uint32 *srcat = (const uint32 *)srcT;
+		const uint32 *srcab = (const uint32 *)srcB;
+		const uint32 w4 = (w + 3) >> 2;
+
+		// The edge scores are kept as five separate rows instead of being
+		// interleaved per pixel as in the scalar version, so that four
+		// pixels can be scored at a time.
+		const uint32 scoreStride = ((w4 + 3) & ~3) + 4;
+		uint32 *scores = (uint32 *)tempBuf;
+		uint32 *topbuf = scores + 5*scoreStride;
+		uint32 *botbuf = topbuf + w4 + 12;
+
+		topbuf[0] = topbuf[1] = topbuf[2] = topbuf[3] = srcat[0];
+		botbuf[0] = botbuf[1] = botbuf[2] = botbuf[3] = srcab[0];
+
+		for(uint32 x=0; x<w4; ++x) {
+			topbuf[x+4] = srcat[x];
+			botbuf[x+4] = srcab[x];
 		}
 
-		if (interpField2)
-			memcpy((char *)dst + dstpitch*(h - 1), (const char *)src + srcpitch*(h - 1), w16 << 4);
-	}
+		topbuf[w4+4] = topbuf[w4+5] = topbuf[w4+6] = topbuf[w4+7] = topbuf[w4+3];
+		botbuf[w4+4] = botbuf[w4+5] = botbuf[w4+6] = botbuf[w4+7] = botbuf[w4+3];
 
-	void InterpPlane_NELA(void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch, uint32 w, uint32 h, bool interpField2) {
-		uint32 w16 = (w + 15) >> 4;
-		vdfastvector<uint8, vdaligned_alloc<uint8> > tempbuf((12 * w16 + 4) * 16);
-		void *elabuf = tempbuf.data();
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i coeff = _mm_set_epi16(0, 54, 183, 19, 0, 54, 183, 19);
 
-		if (!interpField2)
-			memcpy(dst, src, w16 << 4);
+		for(uint32 x=0; x<w4; x += 4) {
+			for(int i=0; i<5; ++i) {
+				const __m128i a = _mm_loadu_si128((const __m128i *)(topbuf + x + 1 + i));
+				const __m128i b = _mm_loadu_si128((const __m128i *)(botbuf + x + 5 - i));
+				const __m128i d = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
 
-		int y0 = interpField2 ? 1 : 2;
-		if (SSE2_enabled) {
-			for(uint32 y = y0; y < h - 1; y += 2) {
-				const __m128i *srcat = (const __m128i *)((const char *)src + srcpitch * (y-1));
-				const __m128i *srcab = (const __m128i *)((const char *)src + srcpitch * (y+1));
+				__m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(d, zero), coeff);
+				__m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(d, zero), coeff);
+
+				lo = _mm_shuffle_epi32(_mm_add_epi32(lo, _mm_srli_epi64(lo, 32)), _MM_SHUFFLE(3, 1, 2, 0));
+				hi = _mm_shuffle_epi32(_mm_add_epi32(hi, _mm_srli_epi64(hi, 32)), _MM_SHUFFLE(3, 1, 2, 0));
 
-				BlendScanLine_NELA_SSE2((char *)dst + dstpitch*y, srcat, srcab, w, (__m128i *)elabuf);
+				_mm_storeu_si128((__m128i *)(scores + scoreStride*i + x), _mm_unpacklo_epi64(lo, hi));
 			}
 		}
-#if defined(VD_CPU_X86)
-		else if (MMX_enabled || ISSE_enabled) {
-			for(uint32 y = y0; y < h - 1; y += 2) {
-				const __m128i *srcat = (const __m128i *)((const char *)src + srcpitch * (y-1));
-				const __m128i *srcab = (const __m128i *)((const char *)src + srcpitch * (y+1));
 
-				BlendScanLine_NELA_MMX_ISSE((char *)dst + dstpitch*y, srcat, srcab, w, (uint8 *)elabuf);
+		// The scalar version scores the last pixel using entries past the end
+		// of the score buffer, which is where the padded top row lives. Copy
+		// those in so that the output matches.
+		for(int i=0; i<5; ++i) {
+			scores[scoreStride*i + w4] = topbuf[i];
+			scores[scoreStride*i + w4 + 1] = topbuf[i + 5];
+		}
+
+		const uint32 *scoresl2 = scores;
+		const uint32 *scoresl1 = scores + scoreStride;
+		const uint32 *scoresc0 = scores + scoreStride*2;
+		const uint32 *scoresr1 = scores + scoreStride*3;
+		const uint32 *scoresr2 = scores + scoreStride*4;
+		const uint32 *srca = topbuf + 4;
+		const uint32 *srcb = botbuf + 4;
+		uint32 *dst32 = (uint32 *)dst;
+
+		for(uint32 x=0; x<w4; x += 4) {
+			__m128i score = ELAScore_X8R8G8B8_SSE2(scoresc0 + x);
+			__m128i result = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(srca + x)), _mm_loadu_si128((const __m128i *)(srcb + x)));
+
+			const __m128i scorel1 = ELAScore_X8R8G8B8_SSE2(scoresl1 + x);
+			const __m128i scorel2 = ELAScore_X8R8G8B8_SSE2(scoresl2 + x);
+			const __m128i resultl1 = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(srca + x - 1)), _mm_loadu_si128((const __m128i *)(srcb + x + 1)));
+			const __m128i resultl2 = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(srca + x - 2)), _mm_loadu_si128((const __m128i *)(srcb + x + 2)));
+
+			const __m128i usel1 = _mm_cmplt_epi32(scorel1, score);
+			score = ELASelect_SSE2(usel1, scorel1, score);
+			result = ELASelect_SSE2(usel1, resultl1, result);
+
+			const __m128i usel2 = _mm_and_si128(usel1, _mm_cmplt_epi32(scorel2, score));
+			score = ELASelect_SSE2(usel2, scorel2, score);
+			result = ELASelect_SSE2(usel2, resultl2, result);
+
+			const __m128i scorer1 = ELAScore_X8R8G8B8_SSE2(scoresr1 + x);
+			const __m128i scorer2 = ELAScore_X8R8G8B8_SSE2(scoresr2 + x);
+			const __m128i resultr1 = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(srca + x + 1)), _mm_loadu_si128((const __m128i *)(srcb + x - 1)));
+			const __m128i resultr2 = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(srca + x + 2)), _mm_loadu_si128((const __m128i *)(srcb + x - 2)));
+
+			const __m128i user1 = _mm_cmplt_epi32(scorer1, score);
+			score = ELASelect_SSE2(user1, scorer1, score);
+			result = ELASelect_SSE2(user1, resultr1, result);
+
+			const __m128i user2 = _mm_and_si128(user1, _mm_cmplt_epi32(scorer2, score));
+			result = ELASelect_SSE2(user2, resultr2, result);
+
+			if (x + 4 <= w4) {
+				_mm_storeu_si128((__m128i *)(dst32 + x), result);
+			} else {
+				uint32 tail[4];
+				_mm_storeu_si128((__m128i *)tail, result);
+
+				for(uint32 i=0; i<w4-x; ++i)
+					dst32[x + i] = tail[i];
 			}
 		}
-#endif
-		else {
-			for(uint32 y = y0; y < h - 1; y += 2) {
-				const __m128i *srcat = (const __m128i *)((const char *)src + srcpitch * (y-1));
-				const __m128i *srcab = (const __m128i *)((const char *)src + srcpitch * (y+1));
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	//
+	//	Row band tasks
+	//
+	//	Each interpolated scanline only depends on the source and on the
+	//	precomputed Yadif buffers, so large frames are split into horizontal
+	//	bands that are run on separate threads. Each band gets its own ELA
+	//	scratch buffer.
+	//
+	///////////////////////////////////////////////////////////////////////////
+
+	size_t GetELATempBufferSize(uint32 rowBytes) {
+		return (12 * ((rowBytes + 15) >> 4) + 16) * 16;
+	}
+
+	typedef void (*ELAScanLineFn)(void *dst, const void *srcT, const void *srcB, uint32 w, void *tempBuf);
+
+	class VDDeinterlaceELATask : public VDFilterRowTask {
+	public:
+		VDDeinterlaceELATask(ELAScanLineFn fn, void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch, uint32 w, uint32 y0)
+			: mpFn(fn)
+			, mpDst(dst)
+			, mDstPitch(dstpitch)
+			, mpSrc(src)
+			, mSrcPitch(srcpitch)
+			, mWidth(w)
+			, mY0(y0)
+		{
+		}
 
-				BlendScanLine_NELA_scalar((char *)dst + dstpitch*y, srcat, srcab, w, (uint8 *)elabuf);
+		void RunRows(uint32 y1, uint32 y2, void *tempBuf) {
+			for(uint32 i = y1; i < y2; ++i) {
+				const uint32 y = mY0 + 2*i;
+				const void *srcT = (const char *)mpSrc + mSrcPitch * (y-1);
+				const void *srcB = (const char *)mpSrc + mSrcPitch * (y+1);
+
+				mpFn((char *)mpDst + mDstPitch*y, srcT, srcB, mWidth, tempBuf);
 			}
 		}
 
+	protected:
+		const ELAScanLineFn mpFn;
+		void *const mpDst;
+		const ptrdiff_t mDstPitch;
+		const void *const mpSrc;
+		const ptrdiff_t mSrcPitch;
+		const uint32 mWidth;
+		const uint32 mY0;
+	};
+
+	void InterpPlane_ELA(ELAScanLineFn fn, void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch, uint32 w, uint32 h, bool interpField2) {
+		uint32 w16 = (w + 15) >> 4;
+
+		if (!interpField2)
+			memcpy(dst, src, w16 << 4);
+
+		// interpolate scanlines y0, y0+2, ... up to but not including the last scanline
+		uint32 y0 = interpField2 ? 1 : 2;
+		uint32 rows = h > y0 ? (h - y0) >> 1 : 0;
+
+		VDDeinterlaceELATask task(fn, dst, dstpitch, src, srcpitch, w, y0);
+		VDFilterRunRowTask(task, rows, w, GetELATempBufferSize(w));
+
 		if (interpField2)
 			memcpy((char *)dst + dstpitch*(h - 1), (const char *)src + srcpitch*(h - 1), w16 << 4);
 	}
 
+	void InterpPlane_NELA_X8R8G8B8(void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch, uint32 w, uint32 h, bool interpField2) {
+		ELAScanLineFn fn = BlendScanLine_NELA_X8R8G8B8_scalar;
+
+		if (SSE2_enabled)
+			fn = BlendScanLine_NELA_X8R8G8B8_SSE2;
+#if defined(VD_CPU_X86)
+		else if (MMX_enabled)
+			fn = BlendScanLine_NELA_X8R8G8B8_MMX;
+#endif
+
+		InterpPlane_ELA(fn, dst, dstpitch, src, srcpitch, w, h, interpField2);
+	}
+
+	void InterpPlane_NELA(void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch, uint32 w, uint32 h, bool interpField2) {
+		ELAScanLineFn fn = BlendScanLine_NELA_scalar;
+
+		if (SSE2_enabled)
+			fn = BlendScanLine_NELA_SSE2;
+#if defined(VD_CPU_X86)
+		else if (MMX_enabled || ISSE_enabled)
+			fn = BlendScanLine_NELA_MMX_ISSE;
+#endif
+
+		InterpPlane_ELA(fn, dst, dstpitch, src, srcpitch, w, h, interpField2);
+	}
+
 	void Average_scalar(void *dst, ptrdiff_t dstPitch, const void *src1, const void *src2, ptrdiff_t srcPitch, uint32 w16, uint32 h) {
 		uint32 w4 = w16 << 2;
 		do {
@@ -2776,6 +2917,87 @@ xloop:
 			*dst2++ = (uint8)pred;
 		} while(--w);
 	}
+
+	struct YadifPlane {
+		void *mpDst;				// first interpolated scanline
+		ptrdiff_t mDstPitch;		// field pitch
+		const void *mpSrc;			// kept field of the center frame
+		ptrdiff_t mSrcPitch;		// field pitch
+		const void *mpAvg;			// field 1/3 average
+		const void *mpAdfC;			// field 1/3 absdiff
+		const void *mpAdfP;			// field 0/2 blended absdiff
+		const void *mpAdfN;			// field 2/4 blended absdiff
+		ptrdiff_t mBufferPitch;
+		uint32 mRowBytes;
+	};
+
+	class VDDeinterlaceYadifTask : public VDFilterRowTask {
+	public:
+		VDDeinterlaceYadifTask(const YadifPlane *planes, int planeCount, uint32 h2, bool interpolatingTopField)
+			: mpPlanes(planes)
+			, mPlaneCount(planeCount)
+			, mH2(h2)
+			, mbInterpolatingTopField(interpolatingTopField)
+		{
+		}
+
+		void RunRows(uint32 y1, uint32 y2, void *tempBuf);
+
+	protected:
+		const YadifPlane *const mpPlanes;
+		const int mPlaneCount;
+		const uint32 mH2;
+		const bool mbInterpolatingTopField;
+	};
+
+	void VDDeinterlaceYadifTask::RunRows(uint32 y1, uint32 y2, void *elabuf) {
+		const uint32 h2 = mH2;
+
+		//	top			bottom
+		//
+		//	-1				-1
+		//		-1		0
+		//	0	*		*	0
+		//		0		+1
+		//	+1				+1
+		for(int plane=0; plane<mPlaneCount; ++plane) {
+			const YadifPlane& pl = mpPlanes[plane];
+			const uint32 rowBytes = pl.mRowBytes;
+			const ptrdiff_t planePitch = pl.mBufferPitch;
+
+			for(uint32 y=y1; y<y2; ++y) {
+				int y_top = (mbInterpolatingTopField && y > 0 ? y-1 : y);
+				int y_bot = (!mbInterpolatingTopField && y < h2-1 ? y+1 : y);
+				void *dst = (char *)pl.mpDst + pl.mDstPitch * y;
+				const void *srcT = (const char *)pl.mpSrc + pl.mSrcPitch * y_top;
+				const void *srcB = (const char *)pl.mpSrc + pl.mSrcPitch * y_bot;
+				const void *srcAvgT = (const char *)pl.mpAvg + planePitch * (y>0 ? y-1 : y);
+				const void *srcAvgC = (const char *)pl.mpAvg + planePitch * y;
+				const void *srcAvgB = (const char *)pl.mpAvg + planePitch * (y<h2-1 ? y+1 : y);
+				const void *srcAdfC = (const char *)pl.mpAdfC + planePitch * y;
+				const void *srcAdfP = (const char *)pl.mpAdfP + planePitch * y;
+				const void *srcAdfN = (const char *)pl.mpAdfN + planePitch * y;
+
+				if (SSE2_enabled) {
+					BlendScanLine_NELA_SSE2(dst, srcT, srcB, rowBytes, elabuf);
+					YadifTemporal_SSE2(dst, srcT, srcB, srcAvgT, srcAvgC, srcAvgB, srcAdfC, srcAdfP, srcAdfN, planePitch >> 4);
+				}
+#if defined(VD_CPU_X86)
+				else if (ISSE_enabled) {
+					BlendScanLine_NELA_MMX_ISSE(dst, srcT, srcB, rowBytes, elabuf);
+					YadifTemporal_ISSE(dst, srcT, srcB, srcAvgT, srcAvgC, srcAvgB, srcAdfC, srcAdfP, srcAdfN, planePitch >> 4);
+				} else if (MMX_enabled) {
+					BlendScanLine_NELA_MMX_ISSE(dst, srcT, srcB, rowBytes, elabuf);
+					YadifTemporal_MMX(dst, srcT, srcB, srcAvgT, srcAvgC, srcAvgB, srcAdfC, srcAdfP, srcAdfN, planePitch >> 4);
+				}
+#endif
+				else {
+					BlendScanLine_NELA_scalar(dst, srcT, srcB, rowBytes, elabuf);
+					YadifTemporal_scalar(dst, srcT, srcB, srcAvgT, srcAvgC, srcAvgB, srcAdfC, srcAdfP, srcAdfN, planePitch >> 4);
+				}
+			}
+		}
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2986,8 +3208,6 @@ protected:
 	uint32	mBufferClock;
 	Buffer	mBuffers[3][kMaxBuffers];
 
-	vdblock<uint8, vdaligned_alloc<uint8> > mElaBuffer;
-
 	uint32	mVDXAFP_ELA1;
 	uint32	mVDXAFP_ELA2;
 	uint32	mVDXAFP_Final;
@@ -3144,9 +3364,6 @@ void VDVideoFilterDeinterlace::Start() {
 	}
 
 	OnInvalidateCaches();
-
-	uint32 wr = (mLumaRowBytes + 15) & ~15;
-	mElaBuffer.resize(12 * wr + 4*16);
 }
 
 void VDVideoFilterDeinterlace::End() {
@@ -3155,8 +3372,6 @@ void VDVideoFilterDeinterlace::End() {
 			mBuffers[plane][i].mStorage.clear();
 		}
 	}
-
-	mElaBuffer.clear();
 }
 
 void VDVideoFilterDeinterlace::Run() {
@@ -3219,6 +3434,8 @@ void VDVideoFilterDeinterlace::Run_Yadif(bool keepField2) {
 	const sint64 field1 = field2 - 1;
 	const sint64 field0 = field2 - 2;
 
+	YadifPlane yadifPlanes[3];
+
 	for(int plane=0; plane<planeCount; ++plane) {
 		struct Plane {
 			void *data;
@@ -3357,13 +3574,6 @@ void VDVideoFilterDeinterlace::Run_Yadif(bool keepField2) {
 			planeBuffers[i].mDesc = neededBuffers[i];
 		}
 
-		//	top			bottom
-		//
-		//	-1				-1
-		//		-1		0
-		//	0	*		*	0
-		//		0		+1
-		//	+1				+1
 		void *dst = plane==0 ? pxdst.data : plane == 1 ? pxdst.data2 : pxdst.data3;
 		ptrdiff_t dstpitch = plane==0 ? pxdst.pitch : plane == 1 ? pxdst.pitch2 : pxdst.pitch3;
 
@@ -3374,43 +3584,23 @@ void VDVideoFilterDeinterlace::Run_Yadif(bool keepField2) {
 			dst = (char *)dst + dstpitch;
 		}
 
-		dstpitch += dstpitch;
-
-		void *elabuf = mElaBuffer.data();
-
-		for(uint32 y=0; y<h2; ++y) {
-			int y_top = (interpolatingTopField && y > 0 ? y-1 : y);
-			int y_bot = (!interpolatingTopField && y < h2-1 ? y+1 : y);
-			const void *srcT = (const char *)srcPlanes[2].data + srcPlanes[2].pitch * y_top;
-			const void *srcB = (const char *)srcPlanes[2].data + srcPlanes[2].pitch * y_bot;
-			const void *srcAvgT = (const char *)planeBuffers[3].mStorage.data() + planePitch * (y>0 ? y-1 : y);
-			const void *srcAvgC = (const char *)planeBuffers[3].mStorage.data() + planePitch * y;
-			const void *srcAvgB = (const char *)planeBuffers[3].mStorage.data() + planePitch * (y<h2-1 ? y+1 : y);
-			const void *srcAdfC = (const char *)planeBuffers[2].mStorage.data() + planePitch * y;
-			const void *srcAdfP = (const char *)planeBuffers[0].mStorage.data() + planePitch * y;
-			const void *srcAdfN = (const char *)planeBuffers[1].mStorage.data() + planePitch * y;
-
-			if (SSE2_enabled) {
-				BlendScanLine_NELA_SSE2(dst, srcT, srcB, rowBytes, (__m128i *)elabuf);
-				YadifTemporal_SSE2(dst, srcT, srcB, srcAvgT, srcAvgC, srcAvgB, srcAdfC, srcAdfP, srcAdfN, planePitch >> 4);
-			}
-#if defined(VD_CPU_X86)
-			else if (ISSE_enabled) {
-				BlendScanLine_NELA_MMX_ISSE(dst, srcT, srcB, rowBytes, elabuf);
-				YadifTemporal_ISSE(dst, srcT, srcB, srcAvgT, srcAvgC, srcAvgB, srcAdfC, srcAdfP, srcAdfN, planePitch >> 4);
-			} else if (MMX_enabled) {
-				BlendScanLine_NELA_MMX_ISSE(dst, srcT, srcB, rowBytes, elabuf);
-				YadifTemporal_MMX(dst, srcT, srcB, srcAvgT, srcAvgC, srcAvgB, srcAdfC, srcAdfP, srcAdfN, planePitch >> 4);
-			}
-#endif
-			else {
-				BlendScanLine_NELA_scalar(dst, srcT, srcB, rowBytes, (uint8 *)elabuf);
-				YadifTemporal_scalar(dst, srcT, srcB, srcAvgT, srcAvgC, srcAvgB, srcAdfC, srcAdfP, srcAdfN, planePitch >> 4);
-			}
-
-			dst = (char *)dst + dstpitch;
-		}
+		YadifPlane& ypl = yadifPlanes[plane];
+		ypl.mpDst = dst;
+		ypl.mDstPitch = dstpitch + dstpitch;
+		ypl.mpSrc = srcPlanes[2].data;
+		ypl.mSrcPitch = srcPlanes[2].pitch;
+		ypl.mpAvg = planeBuffers[3].mStorage.data();
+		ypl.mpAdfC = planeBuffers[2].mStorage.data();
+		ypl.mpAdfP = planeBuffers[0].mStorage.data();
+		ypl.mpAdfN = planeBuffers[1].mStorage.data();
+		ypl.mBufferPitch = planePitch;
+		ypl.mRowBytes = rowBytes;
 	}
+
+	// The interpolation pass is the expensive part, so it is split into
+	// row bands across all planes once the buffers are ready.
+	VDDeinterlaceYadifTask task(yadifPlanes, planeCount, h2, interpolatingTopField);
+	VDFilterRunRowTask(task, h2, mLumaRowBytes + 2*mChromaRowBytes, GetELATempBufferSize(mLumaRowBytes));
 }
 
 void VDVideoFilterDeinterlace::Run_ELA(bool field2) {
@@ -62,6 +62,7 @@ public:
 	uint32 GetParams();
 	void Start();
 	void Run();
+	bool OnGetPointTable(const VDXFilterPointTable& table);
 	bool Configure(VDXHWND hwnd);
 	void GetSettingString(char *buf, int maxlen);
 	void GetScriptString(char *buf, int maxlen);
@@ -88,7 +89,7 @@ uint32 VDVideoFilterGammaCorrect::GetParams() {
 
 	pxldst.pitch = pxlsrc.pitch;
 
-	return FILTERPARAM_ALIGN_SCANLINES | FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM;
+	return FILTERPARAM_ALIGN_SCANLINES | FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM | FILTERPARAM_POINT_TRANSFORM;
 }
 
 void VDVideoFilterGammaCorrect::Start() {
@@ -143,6 +144,13 @@ void VDVideoFilterGammaCorrect::Run() {
 	}
 }
 
+bool VDVideoFilterGammaCorrect::OnGetPointTable(const VDXFilterPointTable& table) {
+	memcpy(table.mpTables[0], mLookup, 256);
+	memcpy(table.mpTables[1], mLookup, 256);
+	memcpy(table.mpTables[2], mLookup, 256);
+	return true;
+}
+
 bool VDVideoFilterGammaCorrect::Configure(VDXHWND hwnd) {
 	VDVideoFilterGammaCorrectDialog dlg(mConfig);
 
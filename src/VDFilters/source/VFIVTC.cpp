@@ -17,10 +17,15 @@
 
 #include "stdafx.h"
 
+#include <vd2/system/bandtask.h>
 #include <vd2/system/cpuaccel.h>
 #include <vd2/system/vdstl.h>
 #include <vd2/system/fraction.h>
 #include <vd2/system/memory.h>
+#include <vd2/system/file.h>
+#include <vd2/system/text.h>
+#include <vd2/system/thread.h>
+#include <vd2/system/VDString.h>
 #include <vd2/VDXFrame/VideoFilter.h>
 #include <vd2/VDLib/Dialog.h>
 #include <vd2/Kasumi/pixmap.h>
@@ -1070,6 +1075,337 @@ namespace {
 				break;
 		}
 	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	//
+	//	Field match metrics
+	//
+	//	Each entry holds the score between source frame n and frame n+1. The
+	//	autodetect, TFF and BFF modes use scanline improvement scores; the
+	//	blurred and duplicated modes use frame correlation, stored in mVar[0].
+	//
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	enum IVTCMetricKind {
+		kIVTCMetric_ScanImprovement,
+		kIVTCMetric_Correlation
+	};
+
+	IVTCScore ComputeFrameMetric(IVTCMetricKind kind, const VDXPixmap& px1, const VDXPixmap& px2) {
+		if (kind == kIVTCMetric_ScanImprovement)
+			return ComputeScanImprovement(px1, px2);
+
+		IVTCScore score = {0};
+		score.mVar[0] = (sint64)(fabs(ComputeFrameCorrelation(px1, px2)) * 1e+10);
+		return score;
+	}
+
+	struct IVTCMetricsHeader {
+		char	mSignature[8];
+		uint32	mKind;
+		uint32	mWidth;
+		uint32	mHeight;
+		uint32	mFormat;
+		uint32	mFrameCount;
+		uint32	mReserved;
+	};
+
+	const char kIVTCMetricsSignature[8]={'V','D','I','V','T','C','M','1'};
+
+	class IVTCMetricsTable {
+	public:
+		IVTCMetricsTable();
+		IVTCMetricsTable(const IVTCMetricsTable&);
+		IVTCMetricsTable& operator=(const IVTCMetricsTable&);
+
+		void Init(IVTCMetricKind kind, const VDXPixmapLayout& layout);
+		void Clear();
+
+		IVTCMetricKind GetKind() const { return mKind; }
+
+		bool Lookup(sint64 frame, IVTCScore& score);
+		bool LookupWindow(sint64 firstFrame, int count, IVTCScore *scores);
+		void Store(sint64 frame, const IVTCScore& score);
+
+		bool Load(const wchar_t *path);
+		bool Save(const wchar_t *path);
+
+		bool IsDirty() const { return mbDirty; }
+
+	protected:
+		VDCriticalSection mLock;
+
+		IVTCMetricKind mKind;
+		uint32	mWidth;
+		uint32	mHeight;
+		uint32	mFormat;
+		bool	mbDirty;
+
+		vdfastvector<IVTCScore> mScores;
+		vdfastvector<uint8> mValid;
+	};
+
+	IVTCMetricsTable::IVTCMetricsTable()
+		: mKind(kIVTCMetric_ScanImprovement)
+		, mWidth(0)
+		, mHeight(0)
+		, mFormat(0)
+		, mbDirty(false)
+	{
+	}
+
+	IVTCMetricsTable::IVTCMetricsTable(const IVTCMetricsTable& src)
+		: mKind(src.mKind)
+		, mWidth(src.mWidth)
+		, mHeight(src.mHeight)
+		, mFormat(src.mFormat)
+		, mbDirty(src.mbDirty)
+		, mScores(src.mScores)
+		, mValid(src.mValid)
+	{
+	}
+
+	IVTCMetricsTable& IVTCMetricsTable::operator=(const IVTCMetricsTable& src) {
+		if (this != &src) {
+			mKind = src.mKind;
+			mWidth = src.mWidth;
+			mHeight = src.mHeight;
+			mFormat = src.mFormat;
+			mbDirty = src.mbDirty;
+			mScores = src.mScores;
+			mValid = src.mValid;
+		}
+
+		return *this;
+	}
+
+	void IVTCMetricsTable::Init(IVTCMetricKind kind, const VDXPixmapLayout& layout) {
+		vdsynchronized(mLock) {
+			mKind = kind;
+			mWidth = layout.w;
+			mHeight = layout.h;
+			mFormat = layout.format;
+			mbDirty = false;
+			mScores.clear();
+			mValid.clear();
+		}
+	}
+
+	void IVTCMetricsTable::Clear() {
+		vdsynchronized(mLock) {
+			mbDirty = false;
+			mScores.clear();
+			mValid.clear();
+		}
+	}
+
+	bool IVTCMetricsTable::Lookup(sint64 frame, IVTCScore& score) {
+		vdsynchronized(mLock) {
+			if (frame < 0 || (uint64)frame >= mValid.size() || !mValid[(size_t)frame])
+				return false;
+
+			score = mScores[(size_t)frame];
+		}
+
+		return true;
+	}
+
+	bool IVTCMetricsTable::LookupWindow(sint64 firstFrame, int count, IVTCScore *scores) {
+		vdsynchronized(mLock) {
+			if (firstFrame < 0 || (uint64)(firstFrame + count) > mValid.size())
+				return false;
+
+			const size_t base = (size_t)firstFrame;
+			for(int i=0; i<count; ++i) {
+				if (!mValid[base + i])
+					return false;
+
+				scores[i] = mScores[base + i];
+			}
+		}
+
+		return true;
+	}
+
+	void IVTCMetricsTable::Store(sint64 frame, const IVTCScore& score) {
+		if (frame < 0)
+			return;
+
+		vdsynchronized(mLock) {
+			const size_t index = (size_t)frame;
+
+			if (index >= mValid.size()) {
+				static const IVTCScore zero = {0};
+
+				mScores.resize(index + 1, zero);
+				mValid.resize(index + 1, 0);
+			}
+
+			mScores[index] = score;
+			mValid[index] = 1;
+			mbDirty = true;
+		}
+	}
+
+	bool IVTCMetricsTable::Load(const wchar_t *path) {
+		VDFile f;
+
+		if (!f.openNT(path))
+			return false;
+
+		IVTCMetricsHeader hdr;
+		if (f.readData(&hdr, sizeof hdr) != sizeof hdr)
+			return false;
+
+		if (memcmp(hdr.mSignature, kIVTCMetricsSignature, sizeof hdr.mSignature)
+			|| hdr.mKind != (uint32)mKind
+			|| hdr.mWidth != mWidth
+			|| hdr.mHeight != mHeight
+			|| hdr.mFormat != mFormat)
+			return false;
+
+		const uint32 n = hdr.mFrameCount;
+		const uint32 recordSize = mKind == kIVTCMetric_Correlation ? sizeof(sint64) : sizeof(IVTCScore);
+
+		if (f.size() != (sint64)sizeof hdr + (sint64)n * (1 + recordSize))
+			return false;
+
+		vdfastvector<uint8> valid(n);
+		vdfastvector<IVTCScore> scores(n);
+
+		if (n) {
+			if (f.readData(valid.data(), n) != (long)n)
+				return false;
+
+			if (mKind == kIVTCMetric_Correlation) {
+				vdfastvector<sint64> corr(n);
+
+				if (f.readData(corr.data(), n * sizeof(sint64)) != (long)(n * sizeof(sint64)))
+					return false;
+
+				memset(scores.data(), 0, n * sizeof(IVTCScore));
+				for(uint32 i=0; i<n; ++i)
+					scores[i].mVar[0] = corr[i];
+			} else {
+				if (f.readData(scores.data(), n * sizeof(IVTCScore)) != (long)(n * sizeof(IVTCScore)))
+					return false;
+			}
+		}
+
+		vdsynchronized(mLock) {
+			mScores.swap(scores);
+			mValid.swap(valid);
+			mbDirty = false;
+		}
+
+		return true;
+	}
+
+	bool IVTCMetricsTable::Save(const wchar_t *path) {
+		IVTCMetricsHeader hdr = {0};
+		vdfastvector<uint8> valid;
+		vdfastvector<IVTCScore> scores;
+
+		vdsynchronized(mLock) {
+			valid = mValid;
+			scores = mScores;
+		}
+
+		const uint32 n = (uint32)valid.size();
+
+		memcpy(hdr.mSignature, kIVTCMetricsSignature, sizeof hdr.mSignature);
+		hdr.mKind = mKind;
+		hdr.mWidth = mWidth;
+		hdr.mHeight = mHeight;
+		hdr.mFormat = mFormat;
+		hdr.mFrameCount = n;
+
+		VDFile f;
+
+		if (!f.openNT(path, nsVDFile::kWrite | nsVDFile::kDenyAll | nsVDFile::kCreateAlways))
+			return false;
+
+		bool success = f.writeData(&hdr, sizeof hdr) == sizeof hdr;
+
+		if (success && n) {
+			success = f.writeData(valid.data(), n) == (long)n;
+
+			if (mKind == kIVTCMetric_Correlation) {
+				vdfastvector<sint64> corr(n);
+
+				for(uint32 i=0; i<n; ++i)
+					corr[i] = scores[i].mVar[0];
+
+				success = success && f.writeData(corr.data(), n * sizeof(sint64)) == (long)(n * sizeof(sint64));
+			} else {
+				success = success && f.writeData(scores.data(), n * sizeof(IVTCScore)) == (long)(n * sizeof(IVTCScore));
+			}
+		}
+
+		if (!f.closeNT())
+			success = false;
+
+		if (success) {
+			vdsynchronized(mLock) {
+				mbDirty = false;
+			}
+		}
+
+		return success;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	struct IVTCAnalysisJob {
+		const VDXPixmap *mpSrc1;
+		const VDXPixmap *mpSrc2;
+		sint64	mFrame;
+		IVTCScore mScore;
+	};
+
+	class IVTCAnalysisTask : public VDBandTask {
+	public:
+		IVTCAnalysisTask(IVTCAnalysisJob *jobs, int jobCount, IVTCMetricKind kind) : mpJobs(jobs), mJobCount(jobCount), mKind(kind) {}
+
+		void RunBand(uint32 band, uint32 bandCount) {
+			for(int i=(int)band; i<mJobCount; i += (int)bandCount) {
+				IVTCAnalysisJob& job = mpJobs[i];
+
+				job.mScore = ComputeFrameMetric(mKind, *job.mpSrc1, *job.mpSrc2);
+			}
+		}
+
+	protected:
+		IVTCAnalysisJob *const mpJobs;
+		const int		mJobCount;
+		const IVTCMetricKind mKind;
+	};
+
+	// Computes the metrics for a set of frame pairs, with the pairs dealt out
+	// across one band per processor.
+	void RunAnalysisJobs(IVTCAnalysisJob *jobs, int jobCount, IVTCMetricKind kind) {
+		IVTCAnalysisTask task(jobs, jobCount, kind);
+
+		VDRunBandTask(task, std::min<uint32>(VDGetLogicalProcessorCount(), (uint32)jobCount));
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	// Describes how an output frame is assembled from the source frames
+	// around it. Slots are relative to the source frame at the center of the
+	// 11-frame analysis window, with slot 5 being the center frame.
+	struct IVTCDecision {
+		enum Action {
+			kActionCopy,
+			kActionWeave,
+			kActionDeblur
+		};
+
+		Action	mAction;
+		int		mSlots[4];
+		int		mSlotCount;
+		bool	mbPolarity;
+	};
 }
 
 ////////////////////////////////////////////////////////////
@@ -1088,6 +1424,7 @@ struct VDVideoFilterIVTCConfig {
 	int mOffset;
 	int mBlendWeight;
 	FieldMode mFieldMode;
+	VDStringW mMetricsPath;
 
 	VDVideoFilterIVTCConfig()
 		: mbReduceRate(false)
@@ -1101,14 +1438,16 @@ struct VDVideoFilterIVTCConfig {
 		return mbReduceRate == x.mbReduceRate &&
 			mOffset == x.mOffset &&
 			mFieldMode == x.mFieldMode &&
-			mBlendWeight == x.mBlendWeight;
+			mBlendWeight == x.mBlendWeight &&
+			mMetricsPath == x.mMetricsPath;
 	}
 
 	bool operator!=(const VDVideoFilterIVTCConfig& x) const {
 		return mbReduceRate != x.mbReduceRate ||
 			mOffset != x.mOffset ||
 			mFieldMode != x.mFieldMode ||
-			mBlendWeight != x.mBlendWeight;
+			mBlendWeight != x.mBlendWeight ||
+			mMetricsPath != x.mMetricsPath;
 	}
 };
 
@@ -1172,6 +1511,8 @@ void VDVideoFilterIVTCDialog::OnDataExchange(bool write) {
 		}
 
 		mConfig.mBlendWeight = TBGetValue(IDC_BLEND_WEIGHTING);
+
+		GetControlText(IDC_METRICS_FILE, mConfig.mMetricsPath);
 	} else {
 		if (mConfig.mbReduceRate)
 			CheckButton(IDC_MODE_REDUCE, true);
@@ -1204,6 +1545,8 @@ void VDVideoFilterIVTCDialog::OnDataExchange(bool write) {
 		}
 
 		TBSetValue(IDC_BLEND_WEIGHTING, mConfig.mBlendWeight);
+
+		SetControlText(IDC_METRICS_FILE, mConfig.mMetricsPath.c_str());
 	}
 }
 
@@ -1270,6 +1613,7 @@ public:
 	uint32 GetParams();
 	void Start();
 	void Run();
+	void End();
 	bool OnInvalidateCaches();
 	bool Prefetch2(sint64 frame, IVDXVideoPrefetcher *prefetcher);
 	bool Configure(VDXHWND);
@@ -1281,21 +1625,30 @@ public:
 	VDXVF_DECLARE_SCRIPT_METHODS();
 
 protected:
-	VDVideoFilterIVTCConfig mConfig;
-
-	struct CacheEntry {
-		sint64	mBaseFrame1;
-		sint64	mBaseFrame2;
-		IVTCScore	mScore;
+	enum {
+		kWindowSlots = 11,
+
+		// Number of source frames past the window to pull in when metrics
+		// are missing, so that the metrics for several output frames can be
+		// computed in parallel.
+		kLookaheadSlots = 8,
+		kMaxSlots = kWindowSlots + kLookaheadSlots
 	};
 
-	enum { kCacheSize = 64 };
-	CacheEntry mCache[kCacheSize];
+	sint64 GetCenterFrame(sint64 dstFrame) const;
+	void DecideFrame(sint64 center, sint64 dstFrame, const IVTCScore *windowScores, IVTCDecision& decision) const;
+	void UpdateMetrics(const VDXFBitmap *const *slots);
+	void ReloadMetrics();
+
+	VDVideoFilterIVTCConfig mConfig;
+
+	IVTCMetricsTable mMetrics;
 };
 
 VDXVF_BEGIN_SCRIPT_METHODS(VDVideoFilterIVTC)
 	VDXVF_DEFINE_SCRIPT_METHOD(VDVideoFilterIVTC, ScriptConfig, "iii")
 	VDXVF_DEFINE_SCRIPT_METHOD2(VDVideoFilterIVTC, ScriptConfig, "iiii")
+	VDXVF_DEFINE_SCRIPT_METHOD2(VDVideoFilterIVTC, ScriptConfig, "iiiis")
 VDXVF_END_SCRIPT_METHODS()
 
 uint32 VDVideoFilterIVTC::GetParams() {
@@ -1343,49 +1696,153 @@ uint32 VDVideoFilterIVTC::GetParams() {
 }
 
 void VDVideoFilterIVTC::Start() {
-	for(int i=0; i<kCacheSize; ++i) {
-		mCache[i].mBaseFrame1 = -1;
-		mCache[i].mBaseFrame2 = -1;
-	}
+	const bool correlation = mConfig.mFieldMode == VDVideoFilterIVTCConfig::kFieldMode_Blurred
+						|| mConfig.mFieldMode == VDVideoFilterIVTCConfig::kFieldMode_Duplicated;
+
+	mMetrics.Init(correlation ? kIVTCMetric_Correlation : kIVTCMetric_ScanImprovement, *fa->src.mpPixmapLayout);
+
+	ReloadMetrics();
 }
 
 void VDVideoFilterIVTC::Run() {
-	const VDXPixmap *pxsrc[11]={
-			fa->mpSourceFrames[0]->mpPixmap,
-			fa->mpSourceFrames[1]->mpPixmap,
-			fa->mpSourceFrames[2]->mpPixmap,
-			fa->mpSourceFrames[3]->mpPixmap,
-			fa->mpSourceFrames[4]->mpPixmap,
-			fa->mpSourceFrames[5]->mpPixmap,
-			fa->mpSourceFrames[6]->mpPixmap,
-			fa->mpSourceFrames[7]->mpPixmap,
-			fa->mpSourceFrames[8]->mpPixmap,
-			fa->mpSourceFrames[9]->mpPixmap,
-			fa->mpSourceFrames[10]->mpPixmap
-	};
+	// Source frames are tagged with their slot in the analysis window when
+	// they are prefetched; only the slots needed for this frame may be
+	// present.
+	const VDXFBitmap *slots[kMaxSlots] = {NULL};
+
+	for(uint32 i=0; i<fa->mSourceFrameCount; ++i) {
+		const VDXFBitmap *src = fa->mpSourceFrames[i];
+		const uint64 slot = (uint64)src->mCookie;
+
+		if (slot < kMaxSlots)
+			slots[slot] = src;
+	}
+
+	UpdateMetrics(slots);
+
+	const sint64 dstFrame = fa->dst.mFrameNumber;
+	const sint64 center = GetCenterFrame(dstFrame);
+
+	IVTCScore scores[10];
+	for(int i=0; i<10; ++i) {
+		if (mMetrics.Lookup(center - 5 + i, scores[i]))
+			continue;
+
+		// Pairs that run off either end of the source are made of repeated
+		// frames and aren't kept in the metrics table.
+		const VDXFBitmap *src1 = slots[i];
+		const VDXFBitmap *src2 = slots[i+1];
+
+		if (src1 && src2) {
+			scores[i] = ComputeFrameMetric(mMetrics.GetKind(), *src1->mpPixmap, *src2->mpPixmap);
+		} else {
+			IVTCScore zero = {0};
+
+			scores[i] = zero;
+		}
+	}
+
+	IVTCDecision decision;
+	DecideFrame(center, dstFrame, scores, decision);
+
+	// The slots chosen at prefetch time can only be missing if the metrics
+	// were discarded in between; fall back to whatever frame we have.
+	const VDXPixmap *pxsrc[4];
+	for(int i=0; i<decision.mSlotCount; ++i) {
+		const VDXFBitmap *src = slots[decision.mSlots[i]];
+
+		if (!src)
+			src = slots[5] ? slots[5] : fa->mpSourceFrames[0];
+
+		pxsrc[i] = src->mpPixmap;
+	}
 
 	const VDXPixmap& pxdst = *fa->mpOutputFrames[0]->mpPixmap;
 
-	if (mConfig.mFieldMode == VDVideoFilterIVTCConfig::kFieldMode_Duplicated) {
-		IVTCScore scores[20];
-		for(int i=0; i<10; ++i) {
-			const VDXPixmap& src1 = *pxsrc[i];
-			const VDXPixmap& src2 = *pxsrc[i+1];
-			sint64 frame1 = fa->mpSourceFrames[i]->mFrameNumber;
-			sint64 frame2 = fa->mpSourceFrames[i+1]->mFrameNumber;
-			int hkey = (int)frame1 & (kCacheSize - 1);
-
-			CacheEntry& cent = mCache[hkey];
-			if (cent.mBaseFrame1 != frame1 || cent.mBaseFrame2 != frame2) {
-				cent.mScore.mVar[0] = (sint64)(fabs(ComputeFrameCorrelation(src1, src2)) * 1e+10);
-				cent.mBaseFrame1 = frame1;
-				cent.mBaseFrame2 = frame2;
-			}
+	switch(decision.mAction) {
+		case IVTCDecision::kActionCopy:
+			CopyPixmap(pxdst, *pxsrc[0]);
+			break;
+
+		case IVTCDecision::kActionWeave:
+			CopyPixmap(SlicePixmap(pxdst, decision.mbPolarity), SlicePixmap(*pxsrc[0], decision.mbPolarity));
+			CopyPixmap(SlicePixmap(pxdst, !decision.mbPolarity), SlicePixmap(*pxsrc[1], !decision.mbPolarity));
+			break;
+
+		case IVTCDecision::kActionDeblur:
+			DeblurFrames(pxdst, *pxsrc[0], *pxsrc[1], *pxsrc[2], *pxsrc[3], mConfig.mBlendWeight);
+			break;
+	}
+}
+
+void VDVideoFilterIVTC::End() {
+	// There is no way to report an error here, so a metrics file that can't be
+	// written just means that the next run has to redo the analysis.
+	if (!mConfig.mMetricsPath.empty() && mMetrics.IsDirty())
+		mMetrics.Save(mConfig.mMetricsPath.c_str());
+}
+
+bool VDVideoFilterIVTC::OnInvalidateCaches() {
+	ReloadMetrics();
+	return true;
+}
 
-			scores[i] = scores[i+10] = cent.mScore;
-	//		VDDEBUG("Scores[%d]: %10lld | %-10lld\n", i, scores[i][0], scores[i][1]);
+bool VDVideoFilterIVTC::Prefetch2(sint64 frame, IVDXVideoPrefetcher *prefetcher) {
+	const sint64 center = GetCenterFrame(frame);
+
+	// If the metrics for the whole window are known, we can make the decision
+	// now and only fetch the frames that go into the output.
+	IVTCScore scores[10];
+	if (mMetrics.LookupWindow(center - 5, 10, scores)) {
+		IVTCDecision decision;
+		DecideFrame(center, frame, scores, decision);
+
+		for(int i=0; i<decision.mSlotCount; ++i) {
+			const int slot = decision.mSlots[i];
+
+			if (i && slot == decision.mSlots[i-1])
+				continue;
+
+			prefetcher->PrefetchFrame(0, center - 5 + slot, slot);
 		}
 
+		return true;
+	}
+
+	for(int i=0; i<kWindowSlots; ++i)
+		prefetcher->PrefetchFrame(0, center - 5 + i, i);
+
+	// Also pull in the frames past the window whose metrics are missing, so
+	// that they are computed in parallel in this batch instead of one pair
+	// per output frame.
+	const sint64 srcCount = fa->src.mFrameCount;
+
+	for(int i=kWindowSlots; i<kMaxSlots; ++i) {
+		const sint64 srcFrame = center - 5 + i;
+		IVTCScore score;
+
+		if ((srcCount >= 0 && srcFrame >= srcCount) || mMetrics.Lookup(srcFrame - 1, score))
+			break;
+
+		prefetcher->PrefetchFrame(0, srcFrame, i);
+	}
+
+	return true;
+}
+
+sint64 VDVideoFilterIVTC::GetCenterFrame(sint64 dstFrame) const {
+	if (mConfig.mbReduceRate)
+		return (dstFrame >> 2) * 5 + (dstFrame & 3);
+
+	return dstFrame;
+}
+
+void VDVideoFilterIVTC::DecideFrame(sint64 center, sint64 dstFrame, const IVTCScore *windowScores, IVTCDecision& decision) const {
+	IVTCScore scores[20];
+	for(int i=0; i<10; ++i)
+		scores[i] = scores[i+10] = windowScores[i];
+
+	if (mConfig.mFieldMode == VDVideoFilterIVTCConfig::kFieldMode_Duplicated) {
 		// The raw scores we have are the amount of variance between each frame and the next.
 		//
 		// Polarity == true means TFF field order.
@@ -1416,7 +1873,7 @@ void VDVideoFilterIVTC::Run() {
 		int bestPhase = mConfig.mOffset;
 
 		if (bestPhase >= 0) {
-			int offset = mConfig.mOffset - (int)(fa->mpSourceFrames[5]->mFrameNumber % 5) - 1;
+			int offset = mConfig.mOffset - (int)(center % 5) - 1;
 
 			if (offset < 0)
 				offset += 5;
@@ -1436,41 +1893,22 @@ void VDVideoFilterIVTC::Run() {
 			}
 		}
 
-		VDDEBUG("bestPhase: %d (offset=%d)\n", bestPhase, (int)((fa->src.mFrameNumber + bestPhase + 1) % 5));
+		VDDEBUG("bestPhase: %d (offset=%d)\n", bestPhase, (int)((center + bestPhase + 1) % 5));
+
+		decision.mAction = IVTCDecision::kActionCopy;
+		decision.mSlots[0] = 5;
+		decision.mSlotCount = 1;
 
 		if (mConfig.mbReduceRate) {
 			// Compute where the duplicated frame occurs in a repeated 5-frame pattern.
-			int dupeOffset = (int)((fa->mpSourceFrames[5]->mFrameNumber + bestPhase) % 5);
+			int dupeOffset = (int)((center + bestPhase) % 5);
 
 			// If we're past that point, then read one frame ahead.
-			int localOffset = (int)fa->dst.mFrameNumber & 3;
-			if (localOffset >= dupeOffset) {
-				CopyPixmap(pxdst, *pxsrc[6]);
-				return;
-			}
+			int localOffset = (int)dstFrame & 3;
+			if (localOffset >= dupeOffset)
+				decision.mSlots[0] = 6;
 		}
-
-		CopyPixmap(pxdst, *pxsrc[5]);
 	} else if (mConfig.mFieldMode == VDVideoFilterIVTCConfig::kFieldMode_Blurred) {
-		IVTCScore scores[20];
-		for(int i=0; i<10; ++i) {
-			const VDXPixmap& src1 = *pxsrc[i];
-			const VDXPixmap& src2 = *pxsrc[i+1];
-			sint64 frame1 = fa->mpSourceFrames[i]->mFrameNumber;
-			sint64 frame2 = fa->mpSourceFrames[i+1]->mFrameNumber;
-			int hkey = (int)frame1 & (kCacheSize - 1);
-
-			CacheEntry& cent = mCache[hkey];
-			if (cent.mBaseFrame1 != frame1 || cent.mBaseFrame2 != frame2) {
-				cent.mScore.mVar[0] = (sint64)(fabs(ComputeFrameCorrelation(src1, src2)) * 1e+10);
-				cent.mBaseFrame1 = frame1;
-				cent.mBaseFrame2 = frame2;
-			}
-
-			scores[i] = scores[i+10] = cent.mScore;
-	//		VDDEBUG("Scores[%d]: %10lld | %-10lld\n", i, scores[i][0], scores[i][1]);
-		}
-
 		// The raw scores we have are the amount of variance between each frame and the next.
 		//
 		// Polarity == true means TFF field order.
@@ -1502,7 +1940,7 @@ void VDVideoFilterIVTC::Run() {
 		int bestPhase = mConfig.mOffset;
 
 		if (bestPhase >= 0) {
-			int offset = mConfig.mOffset - (int)(fa->mpSourceFrames[5]->mFrameNumber % 5) - 1;
+			int offset = mConfig.mOffset - (int)(center % 5) - 1;
 
 			if (offset < 0)
 				offset += 5;
@@ -1521,53 +1959,51 @@ void VDVideoFilterIVTC::Run() {
 			}
 		}
 
-		VDDEBUG("bestPhase: %d (offset=%d)\n", bestPhase, (int)((fa->src.mFrameNumber + bestPhase + 1) % 5));
+		VDDEBUG("bestPhase: %d (offset=%d)\n", bestPhase, (int)((center + bestPhase + 1) % 5));
+
+		// Blended frames are rebuilt from the four frames around them; all
+		// other frames are passed through.
+		int copySlot = 5;
+		int deblurSlot = -1;
 
+		bool pastDupe = false;
 		if (mConfig.mbReduceRate) {
 			// Compute where the second duplicate C frame occurs in a repeated 5-frame, phase-0
 			// pattern.
-			int dupeOffset = (int)((fa->mpSourceFrames[5]->mFrameNumber + bestPhase + 1) % 5);
+			int dupeOffset = (int)((center + bestPhase + 1) % 5);
 
 			// If we're past that point, then read one frame ahead.
-			int localOffset = (int)fa->dst.mFrameNumber & 3;
-			if (localOffset >= dupeOffset) {
-				if (bestPhase == 1)
-					DeblurFrames(pxdst, *pxsrc[5], *pxsrc[6], *pxsrc[7], *pxsrc[8], mConfig.mBlendWeight);
-				else if (bestPhase == 0)
-					DeblurFrames(pxdst, *pxsrc[4], *pxsrc[5], *pxsrc[6], *pxsrc[7], mConfig.mBlendWeight);
-				else
-					CopyPixmap(pxdst, *pxsrc[6]);
-
-				return;
-			}
+			int localOffset = (int)dstFrame & 3;
+			pastDupe = localOffset >= dupeOffset;
 		}
 
-		if (bestPhase == 0)
-			DeblurFrames(pxdst, *pxsrc[4], *pxsrc[5], *pxsrc[6], *pxsrc[7], mConfig.mBlendWeight);
-		else if (bestPhase == 4)
-			DeblurFrames(pxdst, *pxsrc[3], *pxsrc[4], *pxsrc[5], *pxsrc[6], mConfig.mBlendWeight);
-		else
-			CopyPixmap(pxdst, *pxsrc[5]);
-	} else {
-		IVTCScore scores[20];
-		for(int i=0; i<10; ++i) {
-			const VDXPixmap& src1 = *pxsrc[i];
-			const VDXPixmap& src2 = *pxsrc[i+1];
-			sint64 frame1 = fa->mpSourceFrames[i]->mFrameNumber;
-			sint64 frame2 = fa->mpSourceFrames[i+1]->mFrameNumber;
-			int hkey = (int)frame1 & (kCacheSize - 1);
-
-			CacheEntry& cent = mCache[hkey];
-			if (cent.mBaseFrame1 != frame1 || cent.mBaseFrame2 != frame2) {
-				cent.mScore = ComputeScanImprovement(src1, src2);
-				cent.mBaseFrame1 = frame1;
-				cent.mBaseFrame2 = frame2;
-			}
+		if (pastDupe) {
+			copySlot = 6;
 
-			scores[i] = scores[i+10] = cent.mScore;
-	//		VDDEBUG("Scores[%d]: %10lld | %-10lld\n", i, scores[i][0], scores[i][1]);
+			if (bestPhase == 1)
+				deblurSlot = 5;
+			else if (bestPhase == 0)
+				deblurSlot = 4;
+		} else {
+			if (bestPhase == 0)
+				deblurSlot = 4;
+			else if (bestPhase == 4)
+				deblurSlot = 3;
 		}
 
+		if (deblurSlot >= 0) {
+			decision.mAction = IVTCDecision::kActionDeblur;
+			decision.mSlots[0] = deblurSlot;
+			decision.mSlots[1] = deblurSlot + 1;
+			decision.mSlots[2] = deblurSlot + 2;
+			decision.mSlots[3] = deblurSlot + 3;
+			decision.mSlotCount = 4;
+		} else {
+			decision.mAction = IVTCDecision::kActionCopy;
+			decision.mSlots[0] = copySlot;
+			decision.mSlotCount = 1;
+		}
+	} else {
 		// The raw scores we have are the amount of improvement we get at that frame from
 		// shifting the opposite field back one frame.
 		//
@@ -1600,7 +2036,7 @@ void VDVideoFilterIVTC::Run() {
 		int maxOffset = 5;
 
 		if (mConfig.mOffset >= 0) {
-			int offset = mConfig.mOffset - (int)(fa->mpSourceFrames[5]->mFrameNumber % 5) - 1;
+			int offset = mConfig.mOffset - (int)(center % 5) - 1;
 
 			if (offset < 0)
 				offset += 5;
@@ -1633,54 +2069,72 @@ void VDVideoFilterIVTC::Run() {
 		//
 		//  c d r c c (copy, decomb, drop, copy, copy)
 
-		VDDEBUG("bestPhase: %d/%d (offset=%d)\n", bestPhase, bestPolarity, (int)((fa->src.mFrameNumber + bestPhase + 1) % 5));
+		VDDEBUG("bestPhase: %d/%d (offset=%d)\n", bestPhase, bestPolarity, (int)((center + bestPhase + 1) % 5));
+
+		decision.mAction = IVTCDecision::kActionWeave;
+		decision.mbPolarity = bestPolarity;
+		decision.mSlots[0] = 5;
+		decision.mSlots[1] = bestPhase == 4 || bestPhase == 3 ? 6 : 5;
+		decision.mSlotCount = 2;
 
 		if (mConfig.mbReduceRate) {
 			// Compute where the first duplicate C frame occurs in a repeated 5-frame, phase-0
 			// pattern (second decombed frame). This is the one that we drop. Technically we
 			// can also drop the second C frame, which we used to do, except that reacts badly
 			// if there isn't actual interlacing (ugh).
-			int dupeOffset = (int)((fa->mpSourceFrames[5]->mFrameNumber + bestPhase + 2) % 5);
+			int dupeOffset = (int)((center + bestPhase + 2) % 5);
 
 			// If we're past that point, then read one frame ahead.
-			int localOffset = (int)fa->dst.mFrameNumber & 3;
+			int localOffset = (int)dstFrame & 3;
 			if (localOffset >= dupeOffset) {
-				CopyPixmap(SlicePixmap(pxdst, bestPolarity), SlicePixmap(*pxsrc[6], bestPolarity));
-				CopyPixmap(SlicePixmap(pxdst, !bestPolarity), SlicePixmap(*pxsrc[bestPhase == 0 || bestPhase == 4 ? 7 : 6], !bestPolarity));
-				return;
+				decision.mSlots[0] = 6;
+				decision.mSlots[1] = bestPhase == 0 || bestPhase == 4 ? 7 : 6;
 			}
 		}
-
-		CopyPixmap(SlicePixmap(pxdst, bestPolarity), SlicePixmap(*pxsrc[5], bestPolarity));
-		CopyPixmap(SlicePixmap(pxdst, !bestPolarity), SlicePixmap(*pxsrc[bestPhase == 4 || bestPhase == 3 ? 6 : 5], !bestPolarity));
 	}
 }
 
-bool VDVideoFilterIVTC::OnInvalidateCaches() {
-	for(int i=0; i<kCacheSize; ++i) {
-		mCache[i].mBaseFrame1 = -1;
-		mCache[i].mBaseFrame2 = -1;
+void VDVideoFilterIVTC::UpdateMetrics(const VDXFBitmap *const *slots) {
+	IVTCAnalysisJob jobs[kMaxSlots - 1];
+	int jobCount = 0;
+
+	for(int i=0; i<kMaxSlots-1; ++i) {
+		const VDXFBitmap *src1 = slots[i];
+		const VDXFBitmap *src2 = slots[i+1];
+
+		if (!src1 || !src2)
+			continue;
+
+		// Frames are clamped at the ends of the source, so the slots aren't
+		// necessarily consecutive frames.
+		const sint64 frame = src1->mFrameNumber;
+		if (src2->mFrameNumber != frame + 1)
+			continue;
+
+		IVTCScore score;
+		if (mMetrics.Lookup(frame, score))
+			continue;
+
+		IVTCAnalysisJob& job = jobs[jobCount++];
+		job.mpSrc1 = src1->mpPixmap;
+		job.mpSrc2 = src2->mpPixmap;
+		job.mFrame = frame;
 	}
 
-	return true;
+	if (!jobCount)
+		return;
+
+	RunAnalysisJobs(jobs, jobCount, mMetrics.GetKind());
+
+	for(int i=0; i<jobCount; ++i)
+		mMetrics.Store(jobs[i].mFrame, jobs[i].mScore);
 }
 
-bool VDVideoFilterIVTC::Prefetch2(sint64 frame, IVDXVideoPrefetcher *prefetcher) {
-	if (mConfig.mbReduceRate)
-		frame = (frame >> 2) * 5 + (frame & 3);
-
-	prefetcher->PrefetchFrame(0, frame-5, 0);
-	prefetcher->PrefetchFrame(0, frame-4, 0);
-	prefetcher->PrefetchFrame(0, frame-3, 0);
-	prefetcher->PrefetchFrame(0, frame-2, 0);
-	prefetcher->PrefetchFrame(0, frame-1, 0);
-	prefetcher->PrefetchFrame(0, frame  , 0);
-	prefetcher->PrefetchFrame(0, frame+1, 0);
-	prefetcher->PrefetchFrame(0, frame+2, 0);
-	prefetcher->PrefetchFrame(0, frame+3, 0);
-	prefetcher->PrefetchFrame(0, frame+4, 0);
-	prefetcher->PrefetchFrame(0, frame+5, 0);
-	return true;
+void VDVideoFilterIVTC::ReloadMetrics() {
+	mMetrics.Clear();
+
+	if (!mConfig.mMetricsPath.empty())
+		mMetrics.Load(mConfig.mMetricsPath.c_str());
 }
 
 bool VDVideoFilterIVTC::Configure(VDXHWND parent) {
@@ -1710,7 +2164,25 @@ void VDVideoFilterIVTC::GetSettingString(char *buf, int maxlen) {
 }
 
 void VDVideoFilterIVTC::GetScriptString(char *buf, int maxlen) {
-	if (mConfig.mFieldMode == VDVideoFilterIVTCConfig::kFieldMode_Blurred)
+	if (!mConfig.mMetricsPath.empty()) {
+		// Script strings are UTF-8 with C-style escapes.
+		const VDStringA path(VDTextWToU8(mConfig.mMetricsPath));
+		VDStringA encodedPath;
+
+		for(VDStringA::const_iterator it(path.begin()), itEnd(path.end()); it != itEnd; ++it) {
+			const char c = *it;
+
+			if ((unsigned char)c < 0x20) {
+				encodedPath.append_sprintf("\\x%02x", (int)c);
+			} else {
+				if (c == '"' || c == '\\')
+					encodedPath += '\\';
+				encodedPath += c;
+			}
+		}
+
+		SafePrintf(buf, maxlen, "Config(%d,%d,%d,%d,\"%s\")", mConfig.mbReduceRate, mConfig.mFieldMode, mConfig.mOffset, mConfig.mBlendWeight, encodedPath.c_str());
+	} else if (mConfig.mFieldMode == VDVideoFilterIVTCConfig::kFieldMode_Blurred)
 		SafePrintf(buf, maxlen, "Config(%d,%d,%d,%d)", mConfig.mbReduceRate, mConfig.mFieldMode, mConfig.mOffset, mConfig.mBlendWeight);
 	else
 		SafePrintf(buf, maxlen, "Config(%d,%d,%d)", mConfig.mbReduceRate, mConfig.mFieldMode, mConfig.mOffset);
@@ -1731,6 +2203,13 @@ void VDVideoFilterIVTC::ScriptConfig(IVDXScriptInterpreter *interp, const VDXScr
 
 	if (argc >= 4)
 		mConfig.mBlendWeight = argv[3].asInt();
+
+	mConfig.mMetricsPath.clear();
+	if (argc >= 5) {
+		const char *path = *argv[4].asString();
+
+		mConfig.mMetricsPath = VDTextU8ToW(path, -1);
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -100,6 +100,7 @@ public:
 
 	uint32 GetParams();
 	void Run();
+	bool OnGetPointTable(const VDXFilterPointTable& table);
 
 	void StartAccel(IVDXAContext *vdxa);
 	void RunAccel(IVDXAContext *vdxa);
@@ -121,7 +122,7 @@ uint32 VDVideoFilterInvert::GetParams() {
 	switch(pxlsrc.format) {
 		case nsVDXPixmap::kPixFormat_XRGB8888:
 			pxldst.pitch = pxlsrc.pitch;
-			return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM;
+			return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM | FILTERPARAM_POINT_TRANSFORM;
 
 		case nsVDXPixmap::kPixFormat_VDXA_RGB:
 		case nsVDXPixmap::kPixFormat_VDXA_YUV:
@@ -141,6 +142,18 @@ void VDVideoFilterInvert::Run() {
 			);
 }
 
+bool VDVideoFilterInvert::OnGetPointTable(const VDXFilterPointTable& table) {
+	for(int i=0; i<256; ++i) {
+		const uint8 v = (uint8)(255 - i);
+
+		table.mpTables[0][i] = v;
+		table.mpTables[1][i] = v;
+		table.mpTables[2][i] = v;
+	}
+
+	return true;
+}
+
 void VDVideoFilterInvert::StartAccel(IVDXAContext *vdxa) {
 	mAccelFP = vdxa->CreateFragmentProgram(kVDXAPF_D3D9ByteCodePS20, kVDFilterInvertPS, sizeof kVDFilterInvertPS);
 }
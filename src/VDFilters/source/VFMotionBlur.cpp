@@ -17,10 +17,158 @@
 
 #include "stdafx.h"
 
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+	#include <emmintrin.h>
+#endif
+
+#include <vd2/system/cpuaccel.h>
 #include <vd2/VDXFrame/VideoFilter.h>
-#include <vd2/Kasumi/pixmap.h>
-#include <vd2/Kasumi/pixmaputils.h>
 #include "resource.h"
+#include "RowTask.h"
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Motion blur weights the last eight frames by 128, 64, 32, ..., 1 and
+//	divides the sum by 255. The weighted sum is kept as 16 bits per channel
+//	and slid forward one frame at a time:
+//
+//		S[n] = (S[n-1] - F[n-8]) / 2 + 128*F[n]
+//
+//	Subtracting the oldest frame leaves only even weights, so the halving is
+//	exact and a sequentially updated sum is identical to one rebuilt after a
+//	seek.
+//
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	enum {
+		kMotionBlurFrames = 8
+	};
+
+	uint32 VDMotionBlurOutput(uint32 sum) {
+		sum += 128;
+
+		return (sum + (sum >> 8)) >> 8;
+	}
+
+	void VDMotionBlurRebuildRow_scalar(uint32 *dst, uint16 *accum, const uint8 *const *src, uint32 w) {
+		for(uint32 i=0; i<w*4; ++i) {
+			uint32 sum = 0;
+
+			for(int j=0; j<kMotionBlurFrames; ++j)
+				sum = sum*2 + src[j][i];
+
+			accum[i] = (uint16)sum;
+			((uint8 *)dst)[i] = (uint8)VDMotionBlurOutput(sum);
+		}
+	}
+
+	void VDMotionBlurUpdateRow_scalar(uint32 *dst, uint16 *accum, const uint8 *newest, const uint8 *oldest, uint32 w) {
+		for(uint32 i=0; i<w*4; ++i) {
+			const uint32 sum = ((accum[i] - oldest[i]) >> 1) + ((uint32)newest[i] << 7);
+
+			accum[i] = (uint16)sum;
+			((uint8 *)dst)[i] = (uint8)VDMotionBlurOutput(sum);
+		}
+	}
+
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	__m128i VDMotionBlurOutput_SSE2(__m128i lo, __m128i hi) {
+		const __m128i round = _mm_set1_epi16(128);
+
+		lo = _mm_add_epi16(lo, round);
+		hi = _mm_add_epi16(hi, round);
+		lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+		return _mm_packus_epi16(lo, hi);
+	}
+
+	// Scanlines and the accumulator are padded to 16 bytes of pixels, so the
+	// last partial group is processed whole.
+	void VDMotionBlurRebuildRow_SSE2(uint32 *dst, uint16 *accum, const uint8 *const *src, uint32 w) {
+		const __m128i zero = _mm_setzero_si128();
+
+		for(uint32 x=0; x<w; x += 4) {
+			__m128i lo = zero;
+			__m128i hi = zero;
+
+			for(int j=0; j<kMotionBlurFrames; ++j) {
+				const __m128i c = _mm_loadu_si128((const __m128i *)(src[j] + x*4));
+
+				lo = _mm_add_epi16(_mm_add_epi16(lo, lo), _mm_unpacklo_epi8(c, zero));
+				hi = _mm_add_epi16(_mm_add_epi16(hi, hi), _mm_unpackhi_epi8(c, zero));
+			}
+
+			_mm_store_si128((__m128i *)(accum + x*4), lo);
+			_mm_store_si128((__m128i *)(accum + x*4 + 8), hi);
+			_mm_store_si128((__m128i *)(dst + x), VDMotionBlurOutput_SSE2(lo, hi));
+		}
+	}
+
+	void VDMotionBlurUpdateRow_SSE2(uint32 *dst, uint16 *accum, const uint8 *newest, const uint8 *oldest, uint32 w) {
+		const __m128i zero = _mm_setzero_si128();
+
+		for(uint32 x=0; x<w; x += 4) {
+			const __m128i n = _mm_loadu_si128((const __m128i *)(newest + x*4));
+			const __m128i o = _mm_loadu_si128((const __m128i *)(oldest + x*4));
+			__m128i lo = _mm_load_si128((const __m128i *)(accum + x*4));
+			__m128i hi = _mm_load_si128((const __m128i *)(accum + x*4 + 8));
+
+			lo = _mm_srli_epi16(_mm_sub_epi16(lo, _mm_unpacklo_epi8(o, zero)), 1);
+			hi = _mm_srli_epi16(_mm_sub_epi16(hi, _mm_unpackhi_epi8(o, zero)), 1);
+			lo = _mm_add_epi16(lo, _mm_slli_epi16(_mm_unpacklo_epi8(n, zero), 7));
+			hi = _mm_add_epi16(hi, _mm_slli_epi16(_mm_unpackhi_epi8(n, zero), 7));
+
+			_mm_store_si128((__m128i *)(accum + x*4), lo);
+			_mm_store_si128((__m128i *)(accum + x*4 + 8), hi);
+			_mm_store_si128((__m128i *)(dst + x), VDMotionBlurOutput_SSE2(lo, hi));
+		}
+	}
+#endif
+
+	class VDMotionBlurTask : public VDFilterRowTask {
+	public:
+		VDMotionBlurTask(const VDXPixmap& dst, uint16 *accum, ptrdiff_t accumPitch, const VDXPixmap *const *src, bool rebuild)
+			: mDst(dst), mpAccum(accum), mAccumPitch(accumPitch), mpSrc(src), mbRebuild(rebuild) {}
+
+		void RunRows(uint32 y1, uint32 y2, void *tempBuf) {
+			const uint8 *srcRows[kMotionBlurFrames + 1];
+
+			for(uint32 y=y1; y<y2; ++y) {
+				for(int i=0; i<=kMotionBlurFrames; ++i)
+					srcRows[i] = (const uint8 *)mpSrc[i]->data + mpSrc[i]->pitch * y;
+
+				uint32 *dstRow = (uint32 *)((char *)mDst.data + mDst.pitch * y);
+				uint16 *accumRow = mpAccum + mAccumPitch * y;
+
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+				if (SSE2_enabled) {
+					if (mbRebuild)
+						VDMotionBlurRebuildRow_SSE2(dstRow, accumRow, srcRows, mDst.w);
+					else
+						VDMotionBlurUpdateRow_SSE2(dstRow, accumRow, srcRows[0], srcRows[kMotionBlurFrames], mDst.w);
+					continue;
+				}
+#endif
+
+				if (mbRebuild)
+					VDMotionBlurRebuildRow_scalar(dstRow, accumRow, srcRows, mDst.w);
+				else
+					VDMotionBlurUpdateRow_scalar(dstRow, accumRow, srcRows[0], srcRows[kMotionBlurFrames], mDst.w);
+			}
+		}
+
+	protected:
+		const VDXPixmap& mDst;
+		uint16 *const mpAccum;
+		const ptrdiff_t mAccumPitch;
+		const VDXPixmap *const *mpSrc;
+		const bool mbRebuild;
+	};
+}
+
+///////////////////////////////////////////////////////////////////////////
 
 class VDVFMotionBlur : public VDXVideoFilter {
 public:
@@ -33,7 +181,8 @@ public:
 
 protected:
 	sint64	mPrevFrame;
-	VDPixmapBuffer mAccumBuffer;
+	ptrdiff_t mAccumPitch;
+	vdfastvector<uint16, vdaligned_alloc<uint16> > mAccum;
 };
 
 uint32 VDVFMotionBlur::GetParams() {
@@ -42,7 +191,7 @@ uint32 VDVFMotionBlur::GetParams() {
 	if (pxlsrc.format != nsVDXPixmap::kPixFormat_XRGB8888)
 		return FILTERPARAM_NOT_SUPPORTED;
 
-	return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_ALIGN_SCANLINES;
+	return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_SWAP_BUFFERS | FILTERPARAM_ALIGN_SCANLINES | FILTERPARAM_PURE_TRANSFORM;
 }
 
 void VDVFMotionBlur::Start() {
@@ -50,75 +199,35 @@ void VDVFMotionBlur::Start() {
 
 	mPrevFrame = -2;
 
-	mAccumBuffer.init(pxldst.w, pxldst.h, nsVDPixmap::kPixFormat_XRGB8888);
+	// four 16-bit channels per pixel, padded to a multiple of four pixels
+	mAccumPitch = ((pxldst.w + 3) & ~3) * 4;
+	mAccum.resize(mAccumPitch * pxldst.h);
 }
 
 void VDVFMotionBlur::End() {
-	mAccumBuffer.clear();
+	vdfastvector<uint16, vdaligned_alloc<uint16> >().swap(mAccum);
 }
 
 void VDVFMotionBlur::Run() {
-	const VDXFBitmap& bmdst = fa->dst;
-	uint32 framesToProcess = 1;
-	bool doClear = false;
-
-	if (bmdst.mFrameCount != mPrevFrame + 1) {
-		doClear = true;
-		framesToProcess = fa->mSourceFrameCount;
-	}
-
-	mPrevFrame = bmdst.mFrameCount;
-
-	const VDXPixmap pxdst = *fa->dst.mpPixmap;
-
-	for(uint32 i = 0; i < framesToProcess; ++i) {
-		const VDXPixmap& pxsrc = *fa->mpSourceFrames[(framesToProcess - 1) - i]->mpPixmap;
-
-		uint32 *dst = (uint32 *)mAccumBuffer.data;
-		const uint32 *src = (const uint32 *)pxsrc.data;
-		ptrdiff_t srcpitch = pxsrc.pitch;
-
-		if (doClear) {
-			doClear = false;
-
-			uint32 h = pxdst.h;
-			do {
-				memcpy(dst, src, 4*mAccumBuffer.w);
-
-				src = (uint32 *)((char *)src + pxsrc.pitch);
-				dst = (uint32 *)((char *)dst + mAccumBuffer.pitch);
-			} while(--h);
-		} else {
-			uint32 h = pxdst.h;
-			do {
-				for(uint32 x = 0; x < (uint32)mAccumBuffer.w; ++x) {
-					uint32 a = dst[x];
-					uint32 b = src[x];
-
-					dst[x] = (a & b) + (((a ^ b) & 0xfefefefe) >> 1);
-				}
-
-				src = (uint32 *)((char *)src + pxsrc.pitch);
-				dst = (uint32 *)((char *)dst + mAccumBuffer.pitch);
-			} while(--h);
-		}
-	}
+	const VDXPixmap& pxdst = *fa->dst.mpPixmap;
+	const VDXPixmap *src[kMotionBlurFrames + 1];
 
-	uint32 *dst = (uint32 *)pxdst.data;
-	const uint32 *src = (const uint32 *)mAccumBuffer.data;
-	ptrdiff_t srcpitch = mAccumBuffer.pitch;
+	for(int i=0; i<=kMotionBlurFrames; ++i)
+		src[i] = fa->mpSourceFrames[i]->mpPixmap;
 
-	uint32 h = pxdst.h;
-	do {
-		memcpy(dst, src, 4*pxdst.w);
+	// The running sum can only be slid forward if it holds the previous
+	// frame; otherwise it is rebuilt from the full window.
+	const bool rebuild = (fa->dst.mFrameCount != mPrevFrame + 1);
+	mPrevFrame = fa->dst.mFrameCount;
 
-		src = (uint32 *)((char *)src + mAccumBuffer.pitch);
-		dst = (uint32 *)((char *)dst + pxdst.pitch);
-	} while(--h);
+	VDMotionBlurTask task(pxdst, mAccum.data(), mAccumPitch, src, rebuild);
+	VDFilterRunRowTask(task, pxdst.h, pxdst.w * 4 * (rebuild ? kMotionBlurFrames + 4 : 6));
 }
 
 bool VDVFMotionBlur::Prefetch2(sint64 frame, IVDXVideoPrefetcher *prefetcher) {
-	for(int i=0; i<8; ++i)
+	// The last frame is the one that drops out of the window, and is only
+	// used when sliding the sum forward.
+	for(int i=0; i<=kMotionBlurFrames; ++i)
 		prefetcher->PrefetchFrame(0, frame-i, 0);
 
 	return true;
@@ -127,4 +236,4 @@ bool VDVFMotionBlur::Prefetch2(sint64 frame, IVDXVideoPrefetcher *prefetcher) {
 extern const VDXFilterDefinition g_VDVFMotionBlur = VDXVideoFilterDefinition<VDVFMotionBlur>(
 	NULL,
 	"motion blur",
-	"Blurs adjacent frames together.");
+	"Blurs adjacent frames together.\n\n[SSE2 optimized]");
@@ -16,417 +16,275 @@
 //	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 
 #include "stdafx.h"
-#include <windows.h>
-#include <commctrl.h>
+
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+	#include <emmintrin.h>
+#endif
 
 #include <vd2/system/cpuaccel.h>
+#include <vd2/VDXFrame/VideoFilter.h>
 #include "resource.h"
+#include "RowTask.h"
+#include "SingleValueDialog.h"
 
-#define KERNEL		(7)
-
-extern HINSTANCE g_hInst;
-
-class timesmoothFilterData {
-public:
-   uint32 *accum;
-   int framecount;
-   int strength;
-   int *square_table;
-   IVDXFilterPreview *ifp;
-   bool bIsFirstFrame;
-};
-
-/////////////////////////////////////////////////////////////
-
-long timesmooth_param(VDXFilterActivation *fa, const VDXFilterFunctions *ff) {
-	const VDXPixmapLayout& pxlsrc = *fa->src.mpPixmapLayout;
-	VDXPixmapLayout& pxldst = *fa->dst.mpPixmapLayout;
-
-	if (pxlsrc.format != nsVDXPixmap::kPixFormat_XRGB8888)
-		return FILTERPARAM_NOT_SUPPORTED;
-
-	pxldst.data = pxlsrc.data;
-	pxldst.pitch = pxlsrc.pitch;
-
-	return FILTERPARAM_HAS_LAG(KERNEL/2) | FILTERPARAM_PURE_TRANSFORM | FILTERPARAM_SUPPORTS_ALTFORMATS;
-}
-
-int timesmooth_start(VDXFilterActivation *fa, const VDXFilterFunctions *ff) {
-	timesmoothFilterData *mfd = (timesmoothFilterData *)fa->filter_data;
-	int i;
-
-	mfd->accum = new_nothrow uint32[fa->src.w * fa->src.h * KERNEL];
-	mfd->square_table = new_nothrow int[255*2+1];
-
-	if (!mfd->accum || !mfd->square_table)
-		ff->ExceptOutOfMemory();
-
-	memset(mfd->accum, 0, fa->src.w*fa->src.h*KERNEL*4);
-
-	mfd->framecount = 0;
-
-	for(i=0; i<=510; ++i)
-		mfd->square_table[i] = (i-255)*(i-255);
-
-	mfd->bIsFirstFrame = true;
-
-	return 0;
-}
-
-int timesmooth_end(VDXFilterActivation *fa, const VDXFilterFunctions *ff) {
-	timesmoothFilterData *mfd = (timesmoothFilterData *)fa->filter_data;
-
-	delete[] mfd->accum; mfd->accum = NULL;
-	delete[] mfd->square_table; mfd->square_table = NULL;
-
-	return 0;
-}
+///////////////////////////////////////////////////////////////////////////
+//
+//	The smoother averages each pixel with the same pixel in the three frames
+//	before and after it, weighting each frame by how close its color is to
+//	the center frame. The window is fetched through the prefetcher, so the
+//	source frames are shared through the frame cache instead of being copied
+//	into a private history, and any frame can be rendered independently.
+//
+///////////////////////////////////////////////////////////////////////////
 
-/////////////////////////////////////////////////////////////
-
-#define SCALE(i) (0x0000000100010001i64 * (0x10000 / (i)))
-#define SCALE2(i)	SCALE((i)+0),SCALE((i)+1),SCALE((i)+2),SCALE((i)+3),SCALE((i)+4),\
-					SCALE((i)+5),SCALE((i)+6),SCALE((i)+7),SCALE((i)+8),SCALE((i)+9)
-
-	static const __int64 scaletab[]={
-		0,
-		0x00007fff7fff7fffi64,		// special case for 1
-		0x00007fff7fff7fffi64,		// special case for 2
-		SCALE(3),
-		SCALE(4),
-		SCALE(5),
-		SCALE(6),
-		SCALE(7),
-		SCALE(8),
-		SCALE(9),
-		SCALE2(10),
-		SCALE2(20),
-		SCALE2(30),
-		SCALE2(40),
-		SCALE2(50),
-		SCALE2(60),
-		SCALE2(70),
-		SCALE2(80),
-		SCALE2(90),
-		SCALE2(100),
-		SCALE2(110),
-		SCALE2(120),
+namespace {
+	enum {
+		kTimeSmoothRadius = 3,
+		kTimeSmoothKernel = kTimeSmoothRadius*2 + 1,
+		kTimeSmoothMaxWeight = 16
 	};
 
-#undef SCALE
-
-#ifdef _M_IX86
-static void __declspec(naked) asm_timesmooth_run_MMX(uint32 *dstbuf, uint32 *accumbuf, int w, int h, int modulo, int kernel, int noffset, int coffset, int strength) {
-	static const __int64 sixteen = 0x0010001000100010i64;
-	static const __int64 noalpha = 0x0000000000ffffffi64;
-	static const __int64 noalpha2 = 0x0000ffffffffffffi64;
-
-	__asm {
-		push		ebp
-		push		edi
-		push		esi
-		push		ebx
-
-		movd		mm6,[esp+36+16]			;strength+32
-		pxor		mm7,mm7
-
-		mov			esi,[esp+4+16]			;src/dstbuf
-		mov			edi,[esp+8+16]			;accumbuf
-
-		mov			ebp,[esp+16+16]			;hcount
-yloop:
-		mov			ecx,[esp+12+16]			;wcount
-xloop:
-		mov			ebx,[esp+28+16]			;replace offset
-		mov			eax,[esp+32+16]			;center offset
-		movd		mm5,[esi]				;get new pixel
-		pand		mm5,noalpha
-		movd		[edi+ebx],mm5			;put into place
-		movq		mm4,mm7					;clear pixel accumulator
-		movd		mm5,[edi+eax]			;get center pixel
-		punpcklbw	mm5,mm7
-		add			esi,4
-		mov			edx,[esp+24+16]			;load kernel length
-
-		;mm4: pixel accumulator
-		;mm5: center pixel
-		;mm6: shift
-		;mm7: zero
-
-timeloop:
-		movd		mm0,[edi]
-		movq		mm1,mm5
-
-		punpcklbw	mm0,mm7
+	struct VDTimeSmoothTables {
+		int mSquares[511];
+		uint32 mDivisors[kTimeSmoothKernel * kTimeSmoothMaxWeight + 1];
+	};
 
-		psubw		mm1,mm0
+	void VDTimeSmoothRow_scalar(uint32 *dst, const uint32 *const *src, uint32 w, int strength, const VDTimeSmoothTables& tables) {
+		const int *squaretab = tables.mSquares;
+
+		for(uint32 x=0; x<w; ++x) {
+			const uint32 center = src[kTimeSmoothRadius][x];
+			const int *crtab = squaretab + 255 - ((center>>16)&0xff);
+			const int *cgtab = squaretab + 255 - ((center>> 8)&0xff);
+			const int *cbtab = squaretab + 255 - ((center    )&0xff);
+			int raccum = 0, gaccum = 0, baccum = 0;
+			int count = 0;
+
+			for(int i=0; i<kTimeSmoothKernel; ++i) {
+				const uint32 c = src[i][x];
+				int cr = (c>>16)&0xff;
+				int cg = (c&0xff00)>>8;
+				int cb = c&0xff;
+				int sqerr = (crtab[cr] + cgtab[cg] + cbtab[cb]) >> strength;
+
+				if (sqerr > kTimeSmoothMaxWeight)
+					sqerr = kTimeSmoothMaxWeight;
+
+				sqerr = kTimeSmoothMaxWeight - sqerr;
+
+				raccum += cr * sqerr;
+				gaccum += cg * sqerr;
+				baccum += cb * sqerr;
+				count += sqerr;
+			}
 
-		pmaddwd		mm1,mm1
-		add			edi,4
+			const int divisor = tables.mDivisors[count];
 
-		punpckldq	mm2,mm1
+			raccum = (raccum * divisor)>>16;
+			gaccum = (gaccum * divisor)>>16;
+			baccum = (baccum * divisor)>>16;
 
-		paddd		mm1,mm2					;mm0 = |r|^2 + |g|^2 + |b|^2 in high dword
+			dst[x] = (raccum<<16) + (gaccum<<8) + baccum;
+		}
+	}
 
-		movq		mm2,sixteen
-		psrlq		mm1,mm6
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+	// Smooths two pixels held as 16-bit BGRA. The alpha word of each source
+	// pixel is forced to 1, so that the alpha lane of the accumulator ends up
+	// holding the sum of the weights.
+	__m128i VDTimeSmoothPixels2_SSE2(const __m128i *px, __m128i strength, const VDTimeSmoothTables& tables) {
+		const __m128i maxWeight = _mm_set1_epi16(kTimeSmoothMaxWeight);
+		const __m128i center = px[kTimeSmoothRadius];
+		__m128i accum = _mm_setzero_si128();
 
-		punpcklwd	mm1,mm1
+		for(int i=0; i<kTimeSmoothKernel; ++i) {
+			const __m128i c = px[i];
+			const __m128i d = _mm_sub_epi16(c, center);
+			__m128i sqerr = _mm_madd_epi16(d, d);
 
-		punpckldq	mm1,mm1
+			sqerr = _mm_add_epi32(sqerr, _mm_shuffle_epi32(sqerr, _MM_SHUFFLE(2, 3, 0, 1)));
+			sqerr = _mm_srl_epi32(sqerr, strength);
+			sqerr = _mm_packs_epi32(sqerr, sqerr);
+			sqerr = _mm_unpacklo_epi32(sqerr, sqerr);
 
-		psubusw		mm2,mm1
+			const __m128i weight = _mm_sub_epi16(maxWeight, _mm_min_epi16(sqerr, maxWeight));
 
-		pmullw		mm0,mm2
+			accum = _mm_add_epi16(accum, _mm_mullo_epi16(c, weight));
+		}
 
-		psllq		mm2,48
+		const uint32 div0 = tables.mDivisors[_mm_extract_epi16(accum, 3)];
+		const uint32 div1 = tables.mDivisors[_mm_extract_epi16(accum, 7)];
+		const __m128i divisors = _mm_set_epi16(0, (short)div1, (short)div1, (short)div1, 0, (short)div0, (short)div0, (short)div0);
 
-		paddw		mm4,mm2					;add scale to scale accumulator
-		sub			edx,1
-		paddw		mm4,mm0					;add scaled pixel to pixel accumulator
-		jne			timeloop
+		return _mm_mulhi_epi16(accum, divisors);
+	}
 
-		movq		mm0,mm4
-		psrlq		mm4,48
+	void VDTimeSmoothRow_SSE2(uint32 *dst, const uint32 *const *src, uint32 w, int strength, const VDTimeSmoothTables& tables) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i colorMask = _mm_set1_epi32(0x00ffffff);
+		const __m128i alphaOne = _mm_set1_epi32(0x01000000);
+		const __m128i shift = _mm_cvtsi32_si128(strength);
+		__m128i pxlo[kTimeSmoothKernel];
+		__m128i pxhi[kTimeSmoothKernel];
+
+		// Source and destination scanlines are padded to 16 bytes, so the
+		// last partial group is processed whole.
+		for(uint32 x=0; x<w; x += 4) {
+			for(int i=0; i<kTimeSmoothKernel; ++i) {
+				__m128i c = _mm_loadu_si128((const __m128i *)(src[i] + x));
+
+				c = _mm_or_si128(_mm_and_si128(c, colorMask), alphaOne);
+				pxlo[i] = _mm_unpacklo_epi8(c, zero);
+				pxhi[i] = _mm_unpackhi_epi8(c, zero);
+			}
 
-		movd		eax,mm4					;eax = scale accumulator
+			const __m128i lo = VDTimeSmoothPixels2_SSE2(pxlo, shift, tables);
+			const __m128i hi = VDTimeSmoothPixels2_SSE2(pxhi, shift, tables);
 
-		pmulhw		mm0,[scaletab+eax*8]	;produce output pixel
+			_mm_store_si128((__m128i *)(dst + x), _mm_and_si128(_mm_packus_epi16(lo, hi), colorMask));
+		}
+	}
+#endif
 
-		packuswb	mm0,mm0
-		dec			ecx
+	class VDTimeSmoothTask : public VDFilterRowTask {
+	public:
+		VDTimeSmoothTask(const VDXPixmap& dst, const VDXPixmap *const *src, int strength, const VDTimeSmoothTables& tables)
+			: mDst(dst), mpSrc(src), mStrength(strength), mTables(tables) {}
 
-;		mov			eax,[esp+32+16]			;center offset
-;		movd		[edi+ebx],mm0			;put into place
+		void RunRows(uint32 y1, uint32 y2, void *tempBuf) {
+			const uint32 *srcRows[kTimeSmoothKernel];
 
-		movd		[esi-4],mm0
-		jne			xloop
+			for(uint32 y=y1; y<y2; ++y) {
+				for(int i=0; i<kTimeSmoothKernel; ++i)
+					srcRows[i] = (const uint32 *)((const char *)mpSrc[i]->data + mpSrc[i]->pitch * y);
 
-		add			esi,[esp+20+16]			;skip to next scanline
+				uint32 *dstRow = (uint32 *)((char *)mDst.data + mDst.pitch * y);
 
-		dec			ebp
-		jne			yloop
+#if defined(VD_CPU_X86) || defined(VD_CPU_AMD64)
+				if (SSE2_enabled)
+					VDTimeSmoothRow_SSE2(dstRow, srcRows, mDst.w, mStrength, mTables);
+				else
+#endif
+					VDTimeSmoothRow_scalar(dstRow, srcRows, mDst.w, mStrength, mTables);
+			}
+		}
 
-		pop			ebx
-		pop			esi
-		pop			edi
-		pop			ebp
-		emms
-		ret
+	protected:
+		const VDXPixmap& mDst;
+		const VDXPixmap *const *mpSrc;
+		const int mStrength;
+		const VDTimeSmoothTables& mTables;
 	};
 }
-#endif
 
-static int timesmooth_run(const VDXFilterActivation *fa, const VDXFilterFunctions *ff) {
-	timesmoothFilterData *sfd = (timesmoothFilterData *)fa->filter_data;
-	int offset1 = sfd->framecount;
-	int offset2 = ((sfd->framecount+KERNEL-(KERNEL/2))%KERNEL);
+///////////////////////////////////////////////////////////////////////////
 
-	if (sfd->bIsFirstFrame) {
-		uint32 w = fa->src.w, x;
-		uint32 y = fa->src.h;
-		uint32 *srcdst = fa->src.data;
-		uint32 *accum = sfd->accum;
-
-		do {
-			x = w;
-
-			do {
-				accum[0] = accum[1] = accum[2] = accum[3] =
-					accum[4] = accum[5] = accum[6] = *srcdst++ & 0xffffff;
+class VDVFTemporalSmoother : public VDXVideoFilter {
+public:
+	VDVFTemporalSmoother();
 
-				accum += 7;
-			} while(--x);
+	uint32 GetParams();
+	void Start();
+	void Run();
+	bool Prefetch2(sint64 frame, IVDXVideoPrefetcher *prefetcher);
+	bool Configure(VDXHWND hwnd);
+	void GetSettingString(char *buf, int maxlen);
+	void GetScriptString(char *buf, int maxlen);
 
-			srcdst = (uint32 *)((char *)srcdst + fa->src.modulo);
+	VDXVF_DECLARE_SCRIPT_METHODS();
 
-		} while(--y);
+	void ScriptConfig(IVDXScriptInterpreter *isi, const VDXScriptValue *argv, int argc);
 
-		sfd->bIsFirstFrame = false;
+protected:
+	static void Update(long value, void *pvThis);
 
-		sfd->framecount = 1;
+	sint32 mStrength;
+	VDTimeSmoothTables mTables;
+};
 
-		return 0;
-	}
+VDVFTemporalSmoother::VDVFTemporalSmoother()
+	: mStrength(0)
+{
+}
 
-#ifdef _M_IX86
-	if (MMX_enabled)
-		asm_timesmooth_run_MMX(fa->src.data, sfd->accum, fa->src.w, fa->src.h, fa->src.modulo, KERNEL, offset1*4, offset2*4, sfd->strength+32);
-	else
-#endif
-	{
-		uint32 w = fa->src.w, x;
-		uint32 y = fa->src.h;
-		uint32 *srcdst = fa->src.data;
-		uint32 *accum = sfd->accum;
-		int *squaretab = sfd->square_table;
-		int strength = sfd->strength;
-		int i;
-
-		do {
-			x = w;
-			do {
-				const uint32 center = accum[offset2];
-				const int *crtab = squaretab + 255 - ((center>>16)&0xff);
-				const int *cgtab = squaretab + 255 - ((center>> 8)&0xff);
-				const int *cbtab = squaretab + 255 - ((center    )&0xff);
-				int raccum = 0, gaccum = 0, baccum = 0;
-				int count = 0;
-
-				accum[offset1] = *srcdst & 0xffffff;
-
-				for(i=0; i<KERNEL; ++i) {
-					const uint32 c = *accum++;
-					int cr = (c>>16)&0xff;
-					int cg = (c&0xff00)>>8;
-					int cb = c&0xff;
-					int sqerr = (crtab[cr] + cgtab[cg] + cbtab[cb]) >> strength;
-
-					if (sqerr > 16)
-						sqerr = 16;
-
-					sqerr = 16 - sqerr;
-
-					raccum += cr * sqerr;
-					gaccum += cg * sqerr;
-					baccum += cb * sqerr;
-					count += sqerr;
-				}
-
-				int divisor = ((long *)scaletab)[2*count+1];
-
-				raccum = (raccum * divisor)>>16;
-				gaccum = (gaccum * divisor)>>16;
-				baccum = (baccum * divisor)>>16;
-
-				*srcdst++ = (raccum<<16) + (gaccum<<8) + baccum;
-				
-			} while(--x);
-
-			srcdst = (uint32 *)((char *)srcdst + fa->src.modulo);
-
-		} while(--y);
-	}
+uint32 VDVFTemporalSmoother::GetParams() {
+	const VDXPixmapLayout& pxlsrc = *fa->src.mpPixmapLayout;
 
-	if (++sfd->framecount >= KERNEL)
-		sfd->framecount = 0;
+	if (pxlsrc.format != nsVDXPixmap::kPixFormat_XRGB8888)
+		return FILTERPARAM_NOT_SUPPORTED;
 
-	return 0;
+	return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_SWAP_BUFFERS | FILTERPARAM_ALIGN_SCANLINES | FILTERPARAM_PURE_TRANSFORM;
 }
 
-static void timesmooth_string2(const VDXFilterActivation *fa, const VDXFilterFunctions *ff, char *buf, int maxlen) {
-	timesmoothFilterData *mfd = (timesmoothFilterData *)fa->filter_data;
+void VDVFTemporalSmoother::Start() {
+	for(int i=0; i<=510; ++i)
+		mTables.mSquares[i] = (i-255)*(i-255);
 
-	_snprintf(buf, maxlen, " (%d)", mfd->strength);
+	// The center frame always has full weight, so the smaller counts are
+	// never looked up.
+	mTables.mDivisors[0] = 0;
+	for(int i=1; i<=kTimeSmoothKernel * kTimeSmoothMaxWeight; ++i)
+		mTables.mDivisors[i] = 0x10000 / i;
 }
 
-static INT_PTR CALLBACK timesmoothDlgProc( HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam) {
-	timesmoothFilterData *mfd = (timesmoothFilterData *)GetWindowLongPtr(hDlg, DWLP_USER);
-
-    switch (message)
-    {
-        case WM_INITDIALOG:
-			{
-				HWND hwndItem;
-
-				mfd = (timesmoothFilterData *)lParam;
-
-				SetWindowLongPtr(hDlg, DWLP_USER, (LONG)mfd);
-
-				hwndItem = GetDlgItem(hDlg, IDC_STRENGTH);
-				SendMessage(hwndItem, TBM_SETRANGE, TRUE, MAKELONG(0, 10));
-				SendMessage(hwndItem, TBM_SETPOS, TRUE, mfd->strength);
+void VDVFTemporalSmoother::Run() {
+	const VDXPixmap& pxdst = *fa->dst.mpPixmap;
+	const VDXPixmap *src[kTimeSmoothKernel];
 
-				mfd->ifp->InitButton((VDXHWND)GetDlgItem(hDlg, IDC_PREVIEW));
-			}
-            return (TRUE);
-
-        case WM_COMMAND:                      
-			switch(LOWORD(wParam)) {
-			case IDOK:
-				mfd->ifp->Close();
-				EndDialog(hDlg, 0);
-				return TRUE;
-
-			case IDCANCEL:
-				mfd->ifp->Close();
-                EndDialog(hDlg, 1);
-                return TRUE;
-
-			case IDC_PREVIEW:
-				mfd->ifp->Toggle((VDXHWND)hDlg);
-				return TRUE;
-			}
-			break;
-
-		case WM_HSCROLL:
-			mfd->strength = SendDlgItemMessage(hDlg, IDC_STRENGTH, TBM_GETPOS, 0, 0);
-			mfd->ifp->RedoFrame();
-			break;
+	for(int i=0; i<kTimeSmoothKernel; ++i)
+		src[i] = fa->mpSourceFrames[i]->mpPixmap;
 
-    }
-    return FALSE;
+	VDTimeSmoothTask task(pxdst, src, mStrength, mTables);
+	VDFilterRunRowTask(task, pxdst.h, pxdst.w * 4 * kTimeSmoothKernel);
 }
 
-static int timesmooth_config(VDXFilterActivation *fa, const VDXFilterFunctions *ff, VDXHWND hWnd) {
-	timesmoothFilterData *mfd = (timesmoothFilterData *)fa->filter_data;
-	timesmoothFilterData mfd2 = *mfd;
-	int ret;
-
-	mfd->ifp = fa->ifp;
-
-	ret = DialogBoxParam(g_hInst, MAKEINTRESOURCE(IDD_FILTER_TIMESMOOTH), (HWND)hWnd, timesmoothDlgProc, (LPARAM)mfd);
-
-	if (ret)
-		*mfd = mfd2;
+bool VDVFTemporalSmoother::Prefetch2(sint64 frame, IVDXVideoPrefetcher *prefetcher) {
+	for(int i=-kTimeSmoothRadius; i<=kTimeSmoothRadius; ++i)
+		prefetcher->PrefetchFrame(0, frame + i, 0);
 
-	return ret;
+	return true;
 }
 
-/////////////////////////////////////////////////////////////
-
-static void timesmooth_script_config(IVDXScriptInterpreter *isi, void *lpVoid, VDXScriptValue *argv, int argc) {
-	VDXFilterActivation *fa = (VDXFilterActivation *)lpVoid;
+bool VDVFTemporalSmoother::Configure(VDXHWND hwnd) {
+	if (!hwnd)
+		return true;
 
-	timesmoothFilterData *mfd = (timesmoothFilterData *)fa->filter_data;
+	sint32 result;
+	if (!VDFilterGetSingleValue(hwnd, mStrength, &result, 0, 10, "temporal smoother", fa->ifp2, Update, this)) {
+		mStrength = result;
+		return false;
+	}
 
-	mfd->strength = argv[0].asInt();
+	mStrength = result;
+	return true;
 }
 
-static VDXScriptFunctionDef timesmooth_func_defs[]={
-	{ (VDXScriptFunctionPtr)timesmooth_script_config, "Config", "0i" },
-	{ NULL },
-};
+void VDVFTemporalSmoother::GetSettingString(char *buf, int maxlen) {
+	SafePrintf(buf, maxlen, " (%d)", mStrength);
+}
 
-static VDXScriptObject timesmooth_obj={
-	NULL, timesmooth_func_defs
-};
+void VDVFTemporalSmoother::GetScriptString(char *buf, int maxlen) {
+	SafePrintf(buf, maxlen, "Config(%d)", mStrength);
+}
 
-static bool timesmooth_script_line(VDXFilterActivation *fa, const VDXFilterFunctions *ff, char *buf, int buflen) {
-	timesmoothFilterData *mfd = (timesmoothFilterData *)fa->filter_data;
+VDXVF_BEGIN_SCRIPT_METHODS(VDVFTemporalSmoother)
+	VDXVF_DEFINE_SCRIPT_METHOD(VDVFTemporalSmoother, ScriptConfig, "i")
+VDXVF_END_SCRIPT_METHODS()
 
-	_snprintf(buf, buflen, "Config(%d)", mfd->strength);
+void VDVFTemporalSmoother::ScriptConfig(IVDXScriptInterpreter *isi, const VDXScriptValue *argv, int argc) {
+	mStrength = argv[0].asInt();
 
-	return true;
+	if (mStrength < 0)
+		mStrength = 0;
+	else if (mStrength > 31)
+		mStrength = 31;
 }
 
-/////////////////////////////////////////////////////////////
+void VDVFTemporalSmoother::Update(long value, void *pvThis) {
+	((VDVFTemporalSmoother *)pvThis)->mStrength = value;
+}
 
-extern const VDXFilterDefinition g_VDVFTemporalSmoother = {
-	0,0,NULL,
-	"temporal smoother",
-	"Performs an adaptive smooth along the time axis.\n\n[Assembly optimized][MMX optimized][Lag: 4]",
-	NULL,
-	NULL,sizeof(timesmoothFilterData),
-	NULL,NULL,
-	timesmooth_run,
-	timesmooth_param,
-	timesmooth_config,
+extern const VDXFilterDefinition g_VDVFTemporalSmoother = VDXVideoFilterDefinition<VDVFTemporalSmoother>(
 	NULL,
-	timesmooth_start,
-	timesmooth_end,
-
-	&timesmooth_obj,
-	timesmooth_script_line,
-	timesmooth_string2
-};
+	"temporal smoother",
+	"Performs an adaptive smooth along the time axis.\n\n[SSE2 optimized]");
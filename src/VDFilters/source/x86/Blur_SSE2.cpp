@@ -0,0 +1,159 @@
+//	VirtualDub - Video processing and capture application
+//	Internal filter library
+//	Copyright (C) 1998-2011 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include <stdafx.h>
+#include <emmintrin.h>
+#include "x86/Blur_SSE2.h"
+
+void VDBlurBinomial3_8_SSE2(uint8 *dst, const uint8 *const *src, uint32 n16) {
+	const uint8 *src0 = src[0];
+	const uint8 *src1 = src[1];
+	const uint8 *src2 = src[2];
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi16(2);
+
+	do {
+		const __m128i a = _mm_loadu_si128((const __m128i *)src0);
+		const __m128i b = _mm_loadu_si128((const __m128i *)src1);
+		const __m128i c = _mm_loadu_si128((const __m128i *)src2);
+		__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(c, zero));
+		__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(c, zero));
+		const __m128i blo = _mm_unpacklo_epi8(b, zero);
+		const __m128i bhi = _mm_unpackhi_epi8(b, zero);
+
+		lo = _mm_add_epi16(lo, _mm_add_epi16(_mm_add_epi16(blo, blo), round));
+		hi = _mm_add_epi16(hi, _mm_add_epi16(_mm_add_epi16(bhi, bhi), round));
+
+		_mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(_mm_srli_epi16(lo, 2), _mm_srli_epi16(hi, 2)));
+
+		src0 += 16;
+		src1 += 16;
+		src2 += 16;
+		dst += 16;
+	} while(--n16);
+}
+
+void VDBlurBinomial5_8_SSE2(uint8 *dst, const uint8 *const *src, uint32 n16) {
+	const uint8 *src0 = src[0];
+	const uint8 *src1 = src[1];
+	const uint8 *src2 = src[2];
+	const uint8 *src3 = src[3];
+	const uint8 *src4 = src[4];
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi16(8);
+	const __m128i six = _mm_set1_epi16(6);
+
+	do {
+		const __m128i a = _mm_loadu_si128((const __m128i *)src0);
+		const __m128i b = _mm_loadu_si128((const __m128i *)src1);
+		const __m128i c = _mm_loadu_si128((const __m128i *)src2);
+		const __m128i d = _mm_loadu_si128((const __m128i *)src3);
+		const __m128i e = _mm_loadu_si128((const __m128i *)src4);
+
+		// 1*(a+e) + 4*(b+d) + 6*c
+		__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(e, zero));
+		__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(e, zero));
+		const __m128i bdlo = _mm_add_epi16(_mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(d, zero));
+		const __m128i bdhi = _mm_add_epi16(_mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(d, zero));
+
+		lo = _mm_add_epi16(lo, _mm_slli_epi16(bdlo, 2));
+		hi = _mm_add_epi16(hi, _mm_slli_epi16(bdhi, 2));
+		lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_unpacklo_epi8(c, zero), six));
+		hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_unpackhi_epi8(c, zero), six));
+		lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 4);
+		hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 4);
+
+		_mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+
+		src0 += 16;
+		src1 += 16;
+		src2 += 16;
+		src3 += 16;
+		src4 += 16;
+		dst += 16;
+	} while(--n16);
+}
+
+// The running sum is serial along the row, so this works one pixel at a
+// time with the four channels in 16-bit lanes. The source row is padded
+// with radius pixels on the left and radius+1 pixels on the right.
+void VDBlurBoxRow8_X8R8G8B8_SSE2(uint8 *dst, const uint8 *src, uint32 w, uint32 radius, uint32 mult) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i vmult = _mm_set1_epi16((short)mult);
+	const uint8 *sub = src;
+	const uint8 *add = src + 4*(2*radius + 1);
+	__m128i sum = zero;
+
+	for(uint32 i=0; i<=2*radius; ++i)
+		sum = _mm_add_epi16(sum, _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const int *)(src + 4*i)), zero));
+
+	do {
+		const __m128i px = _mm_mulhi_epu16(sum, vmult);
+
+		*(int *)dst = _mm_cvtsi128_si32(_mm_packus_epi16(px, px));
+
+		sum = _mm_add_epi16(sum, _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const int *)add), zero));
+		sum = _mm_sub_epi16(sum, _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const int *)sub), zero));
+
+		add += 4;
+		sub += 4;
+		dst += 4;
+	} while(--w);
+}
+
+void VDBlurAddRow8_SSE2(uint16 *sums, const uint8 *src, uint32 n16) {
+	const __m128i zero = _mm_setzero_si128();
+	__m128i *dst = (__m128i *)sums;
+
+	do {
+		const __m128i a = _mm_loadu_si128((const __m128i *)src);
+
+		dst[0] = _mm_add_epi16(dst[0], _mm_unpacklo_epi8(a, zero));
+		dst[1] = _mm_add_epi16(dst[1], _mm_unpackhi_epi8(a, zero));
+
+		src += 16;
+		dst += 2;
+	} while(--n16);
+}
+
+void VDBlurBoxColumn8_SSE2(uint8 *dst, uint16 *sums, const uint8 *add, const uint8 *sub, uint32 n16, uint32 mult) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i vmult = _mm_set1_epi16((short)mult);
+	__m128i *acc = (__m128i *)sums;
+
+	do {
+		const __m128i a = _mm_loadu_si128((const __m128i *)add);
+		const __m128i s = _mm_loadu_si128((const __m128i *)sub);
+		__m128i lo = acc[0];
+		__m128i hi = acc[1];
+
+		_mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(_mm_mulhi_epu16(lo, vmult), _mm_mulhi_epu16(hi, vmult)));
+
+		lo = _mm_sub_epi16(_mm_add_epi16(lo, _mm_unpacklo_epi8(a, zero)), _mm_unpacklo_epi8(s, zero));
+		hi = _mm_sub_epi16(_mm_add_epi16(hi, _mm_unpackhi_epi8(a, zero)), _mm_unpackhi_epi8(s, zero));
+
+		acc[0] = lo;
+		acc[1] = hi;
+
+		acc += 2;
+		add += 16;
+		sub += 16;
+		dst += 16;
+	} while(--n16);
+}
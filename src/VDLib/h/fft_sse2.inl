@@ -0,0 +1,121 @@
+//	VirtualDub - Video processing and capture application
+//	Application helper library
+//	Copyright (C) 1998-2011 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+// Intrinsic versions of the table-driven radix-4 DIT butterflies. These
+// mirror fft_radix4.inl exactly, but process two adjacent complex points per
+// vector. Unlike the inline asm in fft_sse.inl, these also build for AMD64.
+
+#include <emmintrin.h>
+
+namespace {
+	// Multiply two complex values (r0,i0,r1,i1) by twiddles; wa holds
+	// (c,s) pairs and wb holds the matching (-s,c) pairs.
+	inline __m128 VDFFTComplexMul_SSE2(__m128 x, __m128 wa, __m128 wb) {
+		__m128 xr = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 xi = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 1, 1));
+
+		return _mm_add_ps(_mm_mul_ps(xr, wa), _mm_mul_ps(xi, wb));
+	}
+
+	// (r,i) rot -j = (i,-r)
+	inline __m128 VDFFTRotateNegJ_SSE2(__m128 x) {
+		return _mm_xor_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)), _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f));
+	}
+}
+
+void VDComputeComplexFFT_DIT_radix4_iter0_SSE2(float *p, unsigned bits) {
+	const unsigned N = 1 << bits;		// size of whole FT
+	const unsigned Np = N+N;			// number of elements in FT
+	const __m128 kNegateHigh = _mm_set_ps(-0.0f, -0.0f, 0.0f, 0.0f);
+
+	for(unsigned i=0; i<Np; i+=8) {
+		__m128 x02 = _mm_loadu_ps(p);		// r0 | i0 | r2 | i2
+		__m128 x13 = _mm_loadu_ps(p + 4);	// r1 | i1 | r3 | i3
+
+		// first layer of butterflies
+		__m128 a = _mm_add_ps(_mm_movelh_ps(x02, x02), _mm_xor_ps(_mm_movehl_ps(x02, x02), kNegateHigh));	// r0b | i0b | r2b | i2b
+		__m128 b = _mm_add_ps(_mm_movelh_ps(x13, x13), _mm_xor_ps(_mm_movehl_ps(x13, x13), kNegateHigh));	// r1b | i1b | r3b | i3b
+
+		// second layer of butterflies, imaginary rotation on the odd half
+		__m128 c = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 1, 0));
+		c = _mm_xor_ps(c, _mm_set_ps(-0.0f, 0.0f, 0.0f, 0.0f));									// r1b | i1b | i3b | -r3b
+
+		_mm_storeu_ps(p, _mm_add_ps(a, c));
+		_mm_storeu_ps(p + 4, _mm_sub_ps(a, c));
+
+		p += 8;
+	}
+}
+
+void VDComputeComplexFFT_DIT_radix4_table_SSE2(float *p, unsigned bits, unsigned subbits, const float *table, int table_step) {
+	const unsigned N = 1 << bits;		// size of whole FT
+	const unsigned Np = N+N;			// number of elements in FT
+	const unsigned Mh = 1 << subbits;	// half-size of sub-FT, or quarter the number of elements
+	const unsigned Mp = Mh<<2;			// number of elements in sub-FT
+
+	VDASSERT(subbits >= 2);
+
+	for(unsigned j=0; j<Mh; j+=4) {
+		float *p0 = p+j;			// phase 0/4
+		float *p1 = p0 + Mh;		// phase 1/4
+		float *p2 = p1 + Mh;		// phase 2/4
+		float *p3 = p2 + Mh;		// phase 3/4
+
+		// load single, double and triple shifts for both points
+		const float *t0 = table;
+		const float *t1 = table + table_step;
+		table += table_step * 2;
+
+		const __m128 w1a = _mm_set_ps(-t1[1], t1[0], -t0[1], t0[0]);
+		const __m128 w1b = _mm_set_ps( t1[0], t1[1],  t0[0], t0[1]);
+		const __m128 w2a = _mm_set_ps(-t1[3], t1[2], -t0[3], t0[2]);
+		const __m128 w2b = _mm_set_ps( t1[2], t1[3],  t0[2], t0[3]);
+		const __m128 w3a = _mm_set_ps(-t1[5], t1[4], -t0[5], t0[4]);
+		const __m128 w3b = _mm_set_ps( t1[4], t1[5],  t0[4], t0[5]);
+
+		// perform one step across all sub-FTs
+		for(unsigned i=0; i<Np; i+=Mp) {
+			__m128 x0 = _mm_loadu_ps(p0);
+			__m128 x1 = _mm_loadu_ps(p2);	// swap middle two to undo intervening bitrev layer swap
+			__m128 x2 = _mm_loadu_ps(p1);
+			__m128 x3 = _mm_loadu_ps(p3);
+
+			// do shifts
+			__m128 x1s = VDFFTComplexMul_SSE2(x1, w1a, w1b);
+			__m128 x2s = VDFFTComplexMul_SSE2(x2, w2a, w2b);
+			__m128 x3s = VDFFTComplexMul_SSE2(x3, w3a, w3b);
+
+			// first layer of butterflies
+			__m128 y0 = _mm_add_ps(x0, x2s);
+			__m128 y2 = _mm_sub_ps(x0, x2s);
+			__m128 y1 = _mm_add_ps(x1s, x3s);
+			__m128 y3 = VDFFTRotateNegJ_SSE2(_mm_sub_ps(x1s, x3s));
+
+			// second layer of butterflies
+			_mm_storeu_ps(p0, _mm_add_ps(y0, y1));
+			_mm_storeu_ps(p1, _mm_add_ps(y2, y3));
+			_mm_storeu_ps(p2, _mm_sub_ps(y0, y1));
+			_mm_storeu_ps(p3, _mm_sub_ps(y2, y3));
+
+			p0 += Mp;
+			p1 += Mp;
+			p2 += Mp;
+			p3 += Mp;
+		}
+	}
+}
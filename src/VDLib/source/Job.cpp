@@ -9,6 +9,9 @@ VDJob::VDJob()
 	, mRunnerId(0)
 	, mDateStart(0)
 	, mDateEnd(0)
+	, mChunkGroupId(0)
+	, mChunkIndex(0)
+	, mChunkCount(0)
 	, mbContainsReloadMarker(false)
 {
 }
@@ -23,6 +26,9 @@ bool VDJob::operator==(const VDJob& job) const {
 	TEST(mId);
 	TEST(mDateStart);
 	TEST(mDateEnd);
+	TEST(mChunkGroupId);
+	TEST(mChunkIndex);
+	TEST(mChunkCount);
 	TEST(mRunnerId);
 	TEST(mRunnerName);
 	TEST(mName);
@@ -27,6 +27,9 @@
 #ifdef _M_IX86
 	#include "fft_sse.inl"
 #endif
+#ifdef _M_AMD64
+	#include "fft_sse2.inl"
+#endif
 
 inline uint32 VDRevBits32(uint32 x) {
 	uint32 y;
@@ -104,7 +107,12 @@ void VDComputeComplexFFT_DIT(float *p, unsigned bits) {
 
 void VDComputeComplexFFT_DIT_table(float *p, unsigned bits, const float *table) {
 	if (bits >= 2) {
-#ifdef _M_IX86
+#if defined(_M_AMD64)
+		VDComputeComplexFFT_DIT_radix4_iter0_SSE2(p, bits);
+		for(unsigned k = 3; k<bits; k += 2)
+			VDComputeComplexFFT_DIT_radix4_table_SSE2(p, bits, k, table, 6 << (bits - k - 1));
+#else
+	#ifdef _M_IX86
 		if (SSE_enabled) {
 			VDComputeComplexFFT_DIT_radix4_iter0_SSE(p, bits);
 			for(unsigned k = 3; k<bits; k += 2)
@@ -115,12 +123,13 @@ void VDComputeComplexFFT_DIT_table(float *p, unsigned bits, const float *table)
 					VDComputeComplexFFT_DIT_radix4_table_SSE(p, bits, k, table, 6 << (bits - k - 1));
 			}
 		} else
-#endif
+	#endif
 		{
 			VDComputeComplexFFT_DIT_radix4_iter0(p, bits);
 			for(unsigned k = 3; k<bits; k += 2)
 				VDComputeComplexFFT_DIT_radix4_table(p, bits, k, table, 6 << (bits - k - 1));
 		}
+#endif
 	}
 
 	if (bits & 1)
@@ -606,3 +615,226 @@ float VDRollingRealFFT::GetPower(int bin) const {
 	return re*re + im*im;
 }
 
+
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	void VDConjugateComplex(float *p, uint32 n) {
+		for(uint32 i=0; i<n; ++i)
+			p[i*2+1] = -p[i*2+1];
+	}
+}
+
+VDComplexFFT::VDComplexFFT()
+	: mPoints(0)
+	, mBits(0)
+	, mpPermuteTable(NULL)
+	, mpTwiddleTable(NULL)
+	, mpChirp(NULL)
+	, mpChirpSpectrum(NULL)
+	, mpWorkArea(NULL)
+{
+}
+
+VDComplexFFT::VDComplexFFT(uint32 points)
+	: mPoints(0)
+	, mBits(0)
+	, mpPermuteTable(NULL)
+	, mpTwiddleTable(NULL)
+	, mpChirp(NULL)
+	, mpChirpSpectrum(NULL)
+	, mpWorkArea(NULL)
+{
+	Init(points);
+}
+
+VDComplexFFT::~VDComplexFFT() {
+	Shutdown();
+}
+
+void VDComplexFFT::Init(uint32 points) {
+	Shutdown();
+
+	VDASSERT(points > 0);
+
+	mPoints = points;
+
+	// Lengths that aren't a power of two are convolved with a chirp of
+	// length 2N-1, so the underlying transform must cover that.
+	const bool pow2 = !(points & (points - 1));
+	const uint32 minPoints = pow2 ? points : points*2 - 1;
+
+	mBits = 0;
+	while((1U << mBits) < minPoints)
+		++mBits;
+
+	const uint32 M = 1 << mBits;
+
+	mpPermuteTable = new uint32[M];
+
+	VDMakePermuteTable(mpPermuteTable, mBits);
+
+	// twiddle table for the radix-4 passes: w^i, w^2i, w^3i for w = e^(2*pi*i/M)
+	mpTwiddleTable = (float *)VDAlignedMalloc(sizeof(float) * 6 * M, 16);
+	if (!mpTwiddleTable)
+		throw MyMemoryError();
+
+	const double step = nsVDMath::krTwoPi / (double)M;
+	float *w = mpTwiddleTable;
+	for(uint32 i=0; i<M; ++i) {
+		*w++ = (float)cos(step * i);
+		*w++ = (float)sin(step * i);
+		*w++ = (float)cos(step * i * 2);
+		*w++ = (float)sin(step * i * 2);
+		*w++ = (float)cos(step * i * 3);
+		*w++ = (float)sin(step * i * 3);
+	}
+
+	if (pow2)
+		return;
+
+	mpChirp = (float *)VDAlignedMalloc(sizeof(float) * 2 * points, 16);
+	mpChirpSpectrum = (float *)VDAlignedMalloc(sizeof(float) * 2 * M, 16);
+	mpWorkArea = (float *)VDAlignedMalloc(sizeof(float) * 2 * M, 16);
+	if (!mpChirp || !mpChirpSpectrum || !mpWorkArea)
+		throw MyMemoryError();
+
+	// n^2 is reduced mod 2N before conversion to an angle to keep the chirp
+	// accurate for large n.
+	const double chirpStep = nsVDMath::krPi / (double)points;
+	for(uint32 i=0; i<points; ++i) {
+		const double ang = chirpStep * (double)(uint32)(((uint64)i * i) % (points * 2));
+
+		mpChirp[i*2+0] = (float)cos(ang);
+		mpChirp[i*2+1] = (float)-sin(ang);
+	}
+
+	// build the conjugate chirp, wrapped circularly, and transform it; the
+	// 1/M normalization of the inverse transform is folded in here
+	const float scale = 1.0f / (float)M;
+	float *b = mpChirpSpectrum;
+	memset(b, 0, sizeof(float) * 2 * M);
+
+	b[0] = mpChirp[0] * scale;
+	b[1] = -mpChirp[1] * scale;
+	for(uint32 i=1; i<points; ++i) {
+		b[i*2+0] = b[(M-i)*2+0] = mpChirp[i*2+0] * scale;
+		b[i*2+1] = b[(M-i)*2+1] = -mpChirp[i*2+1] * scale;
+	}
+
+	TransformPow2(b);
+}
+
+void VDComplexFFT::Shutdown() {
+	if (mpPermuteTable) {
+		delete[] mpPermuteTable;
+		mpPermuteTable = NULL;
+	}
+
+	if (mpTwiddleTable) {
+		VDAlignedFree(mpTwiddleTable);
+		mpTwiddleTable = NULL;
+	}
+
+	if (mpChirp) {
+		VDAlignedFree(mpChirp);
+		mpChirp = NULL;
+	}
+
+	if (mpChirpSpectrum) {
+		VDAlignedFree(mpChirpSpectrum);
+		mpChirpSpectrum = NULL;
+	}
+
+	if (mpWorkArea) {
+		VDAlignedFree(mpWorkArea);
+		mpWorkArea = NULL;
+	}
+
+	mPoints = 0;
+	mBits = 0;
+}
+
+void VDComplexFFT::Transform(float *p) {
+	if (mpChirp)
+		TransformBluestein(p);
+	else
+		TransformPow2(p);
+}
+
+void VDComplexFFT::InverseTransform(float *p) {
+	// IFFT(x) = conj(FFT(conj(x)))
+	VDConjugateComplex(p, mPoints);
+	Transform(p);
+	VDConjugateComplex(p, mPoints);
+}
+
+void VDComplexFFT::TransformBatch(float *p, uint32 channels, ptrdiff_t pitch) {
+	while(channels--) {
+		Transform(p);
+		p += pitch;
+	}
+}
+
+void VDComplexFFT::InverseTransformBatch(float *p, uint32 channels, ptrdiff_t pitch) {
+	while(channels--) {
+		InverseTransform(p);
+		p += pitch;
+	}
+}
+
+void VDComplexFFT::TransformPow2(float *p) {
+	VDPermuteRevBitsComplex(p, mBits, mpPermuteTable);
+
+	// The table routines use the conjugate of the stored twiddles, giving
+	// the same forward kernel as VDComputeComplexFFT_DIT().
+	VDComputeComplexFFT_DIT_table(p, mBits, mpTwiddleTable);
+}
+
+void VDComplexFFT::TransformBluestein(float *p) {
+	const uint32 N = mPoints;
+	const uint32 M = 1 << mBits;
+	const float *chirp = mpChirp;
+	const float *spec = mpChirpSpectrum;
+	float *work = mpWorkArea;
+
+	// premultiply by chirp and zero pad
+	for(uint32 i=0; i<N; ++i) {
+		const float r = p[i*2+0];
+		const float im = p[i*2+1];
+		const float cr = chirp[i*2+0];
+		const float ci = chirp[i*2+1];
+
+		work[i*2+0] = r*cr - im*ci;
+		work[i*2+1] = r*ci + im*cr;
+	}
+
+	memset(work + N*2, 0, sizeof(float) * 2 * (M - N));
+
+	// convolve with the conjugate chirp; the inverse transform is done as a
+	// forward transform of the conjugate
+	TransformPow2(work);
+
+	for(uint32 i=0; i<M; ++i) {
+		const float r = work[i*2+0];
+		const float im = work[i*2+1];
+		const float sr = spec[i*2+0];
+		const float si = spec[i*2+1];
+
+		work[i*2+0] = r*sr - im*si;
+		work[i*2+1] = -(r*si + im*sr);
+	}
+
+	TransformPow2(work);
+
+	// postmultiply by chirp, undoing the conjugation from the inverse
+	for(uint32 i=0; i<N; ++i) {
+		const float r = work[i*2+0];
+		const float im = -work[i*2+1];
+		const float cr = chirp[i*2+0];
+		const float ci = chirp[i*2+1];
+
+		p[i*2+0] = r*cr - im*ci;
+		p[i*2+1] = r*ci + im*cr;
+	}
+}
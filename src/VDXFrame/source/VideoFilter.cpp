@@ -100,6 +100,9 @@ bool VDXVideoFilter::OnEvent(uint32 event, const void *eventData) {
 		case kVDXVFEvent_InvalidateCaches:
 			return OnInvalidateCaches();
 
+		case kVDXVFEvent_GetPointTable:
+			return OnGetPointTable(*(const VDXFilterPointTable *)eventData);
+
 		default:
 			return false;
 	}
@@ -109,6 +112,10 @@ bool VDXVideoFilter::OnInvalidateCaches() {
 	return false;
 }
 
+bool VDXVideoFilter::OnGetPointTable(const VDXFilterPointTable& table) {
+	return false;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 
 void __cdecl VDXVideoFilter::FilterDeinit   (VDXFilterActivation *fa, const VDXFilterFunctions *ff) {
@@ -259,6 +259,7 @@ public:
 protected:
 	IVDAudioFilterSink *mpFilterIF;
 
+	VDSignal	mFilterSystemSignal;
 	VDScheduler mFilterSystemScheduler;
 	VDAudioFilterSystem mFilterSystem;
 	sint64		mStartTime;
@@ -7,6 +7,8 @@
 #include <vd2/system/VDScheduler.h>
 #include <vd2/system/VDString.h>
 #include <vd2/system/thread.h>
+#include <vd2/system/vdalloc.h>
+#include <vd2/system/Error.h>
 #include <vd2/plugin/vdplugin.h>
 #include <vd2/plugin/vdaudiofilt.h>
 #include "plugins.h"
@@ -55,7 +57,7 @@ struct VDAudioFilterGraph {
 	FilterConnectionList	mConnections;
 };
 
-class VDAudioFilterSystem {
+class VDAudioFilterSystem : protected IVDAsyncErrorCallback {
 public:
 	VDAudioFilterSystem();
 	~VDAudioFilterSystem();
@@ -63,6 +65,12 @@ public:
 	void SetScheduler(VDScheduler *pIOScheduler, VDScheduler *pFastScheduler = NULL);
 	VDScheduler *GetIOScheduler() { return mpIOScheduler; }
 
+	/// Sets the number of worker threads used to run filters that are not
+	/// bound to the I/O scheduler: -1 runs everything on the supplied
+	/// schedulers, 0 picks a count automatically. Takes effect on Start().
+	/// The I/O scheduler must have a wakeup signal for workers to be used.
+	void SetAsyncThreadCount(sint32 threadsToUse);
+
 	IVDAudioFilterInstance *Create(VDPluginDescription *);
 	void Destroy(IVDAudioFilterInstance *);
 
@@ -78,16 +86,34 @@ public:
 
 	void Seek(sint64 us);
 
+	/// Runs one filter on the I/O scheduler. If none is ready but worker
+	/// threads are still busy, waits for them. Returns false only if no
+	/// filter can make progress; rethrows errors from worker threads.
+	bool Run();
+
 	IVDAudioFilterInstance *GetClock();
 
 protected:
 	void Unprepare(VDAudioFilterInstance *pInst);
 	void TryPrepare(VDAudioFilterInstance *pInst);
 	void Prepare(VDAudioFilterInstance *pInst, bool mustSucceed);
+	VDScheduler *GetScheduler(VDAudioFilterInstance *pInst) const;
+
+	void StartWorkers();
+	void StopWorkers();
+	bool OnAsyncError(MyError& e);
 
 	VDScheduler		*mpIOScheduler;
 	VDScheduler		*mpFastScheduler;
 
+	sint32			mThreadsRequested;
+	vdautoptr<VDScheduler>	mpWorkerScheduler;
+	vdautoptr<VDSchedulerThreadPool>	mpWorkerThreadPool;
+	VDSignal		mWorkerSignal;
+
+	VDCriticalSection	mcsAsyncError;
+	MyError			mAsyncError;
+
 	VDAudioFilterInstance	*mpClock;
 
 	typedef std::list<VDAudioFilterInstance *> tFilterList;
@@ -134,8 +134,6 @@ public:
 
 class DubPerfOptions {
 public:
-	bool	dynamicEnable;
-	bool	dynamicShowDisassembly;
 	bool	useDirectDraw;
 	bool	fDropFrames;
 };
@@ -49,7 +49,7 @@ protected:
 	IVDFilterFrameSource *mpSource;
 	VDPixmapLayout		mSourceLayout;
 
-	vdautoptr<IVDPixmapBlitter> mpBlitter;
+	IVDPixmapBlitter *mpBlitter;
 	vdrefptr<VDFilterFrameRequest> mpRequest;
 
 	VDPixmap	mPixmapSrc;
@@ -40,6 +40,7 @@
 #include "FilterFrameAllocatorProxy.h"
 #include "FilterFrameCache.h"
 #include "FilterFrameSharingPredictor.h"
+#include "FilterPointTransform.h"
 
 //////////////////
 
@@ -338,6 +339,10 @@ public:
 	void	PrepareReset();
 	uint32	Prepare(const VFBitmapInternal *inputs, uint32 numInputs, VDFilterPrepareInfo& prepareInfo);
 
+	bool	IsPointTransform() const;
+	bool	IsPointTransformFused() const { return !mFusedFilters.empty(); }
+	void	FusePointTransform(FilterInstance *upstream);
+
 	void	SetEngine(IVDFilterFrameEngine *engine);
 	void	Start(IVDFilterFrameEngine *engine);
 	void	Start(uint32 flags, IVDFilterFrameSource *const *pSources, IVDFilterFrameEngine *engine, VDFilterAccelEngine *accelEngine);
@@ -421,6 +426,9 @@ protected:
 	static void StopFilterCallback(VDFilterAccelEngineDispatchQueue *queue, VDFilterAccelEngineMessage *message);
 	void StopInner();
 
+	bool	GetPointTable(const VDXFilterPointTable& table);
+	bool	UpdatePointTransform();
+
 	void	RunFilter();
 	void	RunFilterInner();
 	bool	ConnectAccelBuffers();
@@ -518,6 +526,10 @@ protected:
 	VDFilterAccelEngine		*mpAccelEngine;
 	VDFilterAccelContext	*mpAccelContext;
 
+	typedef vdfastvector<FilterInstance *> FusedFilters;
+	FusedFilters			mFusedFilters;			// upstream point transforms applied by this instance
+	VDFilterPointTransform	mPointTransform;
+
 	VDFilterThreadContext	mThreadContext;
 
 	VDProfileEventCache		mProfileCacheFilterName;
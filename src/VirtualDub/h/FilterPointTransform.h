@@ -0,0 +1,58 @@
+//	VirtualDub - Video processing and capture application
+//	Copyright (C) 1998-2009 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+
+#ifndef f_VD2_FILTERPOINTTRANSFORM_H
+#define f_VD2_FILTERPOINTTRANSFORM_H
+
+#include <vd2/system/vdtypes.h>
+
+struct VDPixmap;
+struct VDXFilterPointTable;
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	VDFilterPointTransform
+//
+//	Composes the per-channel lookup tables of a run of point transform
+//	filters so that the whole run can be applied in a single pass over the
+//	frame. Channel 0/1/2 are R/G/B for RGB formats and Y/Cb/Cr for YCbCr
+//	formats.
+//
+///////////////////////////////////////////////////////////////////////////
+
+class VDFilterPointTransform {
+public:
+	VDFilterPointTransform();
+
+	static bool IsFormatSupported(int format);
+
+	void Reset();
+	void Append(const VDXFilterPointTable& table);
+
+	/// Applies the composed tables from src to dst, which must have the same
+	/// format and size. The source and destination may be the same buffer.
+	void Apply(const VDPixmap& dst, const VDPixmap& src) const;
+
+protected:
+	void ApplyPlane(void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch, uint32 w, uint32 h, int channel) const;
+
+	bool	mbIdentity[3];
+	uint8	mTables[3][256];
+};
+
+#endif
@@ -24,10 +24,11 @@
 
 #include <vd2/system/file.h>
 #include <vd2/system/refcount.h>
+#include <vd2/system/thread.h>
 #include "AudioSource.h"
 #include "InputFile.h"
 
-class VDInputFileMP3 : public InputFile {
+class VDInputFileMP3 : public InputFile, protected VDThread {
 public:
 	VDInputFileMP3();
 	~VDInputFileMP3();
@@ -60,26 +61,56 @@ public:
 	sint64	GetDataLength() const { return mDataLength; }
 	uint32	GetSamplesPerFrame() const { return mSamplesPerFrame; }
 
-	uint32	GetFrameCount() const { return mFrames.size(); }
-	const FrameInfo& GetFrameInfo(uint32 frame) const;
+	uint32	GetFrameCount() const { return mFrameCount; }
+	bool	GetFrameInfo(uint32 frame, FrameInfo& fi);
 
 	void	ReadSpan(sint64 pos, void *buffer, uint32 len);
 
 private:
+	struct VBRHeader {
+		uint32	mFrames;
+		uint32	mBytes;
+		bool	mbVBR;
+	};
+
+	enum {
+		kProbeFrames		= 256,		// frames scanned for format statistics when a VBR header is present
+		kCheckpointShift	= 6			// sparse index holds the position of every 64th frame
+	};
+
 	void ParseWave();
 	void ParseWave64();
 
+	bool ReadVBRHeader(VBRHeader& vbr);
+	bool ScanFrames(VDBufferedStream& stream, sint64& pos, uint32 count, FrameInfo *lastFrame);
+	bool ExtendIndex(VDBufferedStream& stream);
+	void ThreadRun();
+
 	VDFileStream		mFile;
 	VDBufferedStream	mBufferedFile;
 
 	sint64			mDataStart;
 	sint64			mDataLength;
 	uint32			mSamplesPerFrame;
+	uint32			mFrameCount;
 	bool			mbVBRMode;
 
 	typedef vdfastvector<FrameInfo> Frames;
 	Frames mFrames;
 
+	// Sparse frame index, used instead of mFrames when a Xing/Info or VBRI
+	// header allowed the full scan to be skipped. Checkpoints are extended
+	// on demand by readers and in the background by the indexing thread,
+	// which uses its own file handle.
+	VDCriticalSection		mIndexLock;
+	vdfastvector<sint64>	mCheckpoints;
+	bool					mbSparseIndex;
+	bool					mbIndexComplete;
+	volatile bool			mbIndexThreadExit;
+	uint32					mLastFrame;
+	FrameInfo				mLastFrameInfo;
+	VDFileStream			mIndexFile;
+
 	vdstructex<VDWaveFormat>	mWaveFormat;
 
 	BitRateMode	mBitRateMode;
@@ -6,6 +6,7 @@
 #endif
 
 #include <vd2/system/vdstl.h>
+#include <vd2/system/vdstl_hashmap.h>
 #include <vd2/system/filewatcher.h>
 #include <vd2/system/log.h>
 #include <vd2/system/time.h>
@@ -13,6 +14,8 @@
 
 class VDJob;
 class IVDStream;
+class IVDRandomAccessStream;
+class VDTextOutputStream;
 
 enum VDJobQueueStatus {
 	kVDJQS_Idle,
@@ -20,6 +23,13 @@ enum VDJobQueueStatus {
 	kVDJQS_Blocked
 };
 
+struct VDJobQueueClaimStats {
+	uint32	mClaims;			///< Jobs claimed by this runner.
+	uint32	mConflicts;			///< Claim attempts that lost to another runner.
+	uint32	mExpiredLeases;		///< Jobs put back in the queue after their runner stopped renewing its lease.
+	float	mClaimsPerSecond;
+};
+
 class IVDJobQueueStatusCallback {
 public:
 	virtual void OnJobQueueStatusChanged(VDJobQueueStatus status) = 0;
@@ -48,6 +58,7 @@ public:
 
 	int32 GetJobIndexById(uint64 id) const;
 	VDJob *GetJobById(uint64 id) const;
+	bool IsJobReady(const VDJob *job) const;
 	VDJob *ListGet(int index);
 	int ListFind(VDJob *vdj_find);
 	long ListSize();
@@ -109,11 +120,55 @@ public:
 	void SetBlocked(bool blocked);
 	void SetCallback(IVDJobQueueStatusCallback *cb);
 
+	void GetClaimStats(VDJobQueueClaimStats& stats) const;
+
 protected:
 	typedef vdfastvector<VDJob *> JobQueue;
 
+	enum {
+		// don't bother compacting the journal into the snapshot until it gets this big
+		kJournalCompactSize = 65536,
+
+		// how often a runner renews the lease on the job it is running, and checks
+		// the leases of other runners
+		kLeaseRenewPeriod = 5000,
+
+		// how long a lease has to go without being renewed before the job is requeued
+		kLeaseTimeout = 60000
+	};
+
+	struct ClaimRecord {
+		uint64	mRunnerId;
+		uint32	mClaimTick;
+		uint32	mHeartbeat;
+	};
+
+	struct LeaseObservation {
+		ClaimRecord	mRecord;
+		uint32		mLastChangeTick;
+	};
+
+	typedef vdhashmap<uint64, LeaseObservation> LeaseObservations;
+
 	bool Load(IVDStream *stream, bool skipIfSignatureSame);
+	bool LoadJournal(IVDRandomAccessStream *stream);
+	bool ApplyJournalBatch(JobQueue& jobs, const vdfastvector<uint64>& deletedIds, uint32 revision);
+	void ValidateJobRunner(VDJob *job);
 	void Save(IVDStream *stream, uint64 signature, uint32 revision, bool resetJobRevisions);
+	void SaveJob(VDTextOutputStream& output, VDJob *job, uint32 revision, bool resetJobRevisions);
+	void SaveJournalHeader(IVDStream *stream, uint64 signature, uint32 revision);
+	bool SaveJournal(IVDStream *stream, uint32 revision);
+	VDStringW GetJournalPath() const;
+
+	bool ClaimJob(uint64 id);
+	bool BreakExpiredClaim(uint64 id);
+	void ReleaseClaim();
+	void RenewLease();
+	bool IsLeaseExpired(uint64 id);
+	bool IsLeaseCheckNeeded(const VDJob *job) const;
+	void RequeueExpiredJobs();
+	VDStringW GetClaimPath(uint64 id) const;
+	void OnLeaseTimer();
 
 	void NotifyStatus();
 	uint64 CreateListSignature();
@@ -142,10 +197,25 @@ protected:
 	uint64	mLastSignature;
 	uint32	mLastRevision;
 
+	uint64	mJournalSignature;			///< Signature of the snapshot that mJournalOffset is valid for.
+	sint64	mJournalOffset;				///< Offset just past the last journal batch we have applied.
+	vdfastvector<uint64>	mDeletedJobIds;	///< Deletions not yet written to the journal.
+
+	uint64		mClaimedJobId;			///< Job that we hold the claim file for, if any.
+	ClaimRecord	mClaimRecord;
+	bool		mbClaimLost;			///< Another runner took over the job we are running.
+	LeaseObservations	mLeaseObservations;	///< Last claim record seen for each job run by another runner.
+
+	uint32	mClaimCount;
+	uint32	mClaimConflictCount;
+	uint32	mExpiredLeaseCount;
+	uint32	mFirstClaimTick;
+
 	VDStringW		mJobFilePath;
 	VDStringW		mDefaultJobFilePath;
 
 	VDFileWatcher	mFileWatcher;
+	VDFileWatcher	mJournalWatcher;
 	VDLazyTimer		mFlushTimer;
 
 	struct RetryTimer : public IVDTimerCallback {
@@ -155,8 +225,16 @@ protected:
 
 		RetryTimer() : mbRetryOK(true), mLastPeriod(0) {}
 
+		void Defer();
 		void TimerCallback();
 	} mRetryTimer;
+
+	struct LeaseTimer : public IVDTimerCallback {
+		VDLazyTimer	mTimer;
+		VDJobQueue	*mpParent;
+
+		void TimerCallback();
+	} mLeaseTimer;
 };
 
 #endif
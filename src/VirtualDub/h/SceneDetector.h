@@ -19,6 +19,7 @@
 #define f_SCENEDETECTOR_H
 
 #include <vd2/system/vdstl.h>
+#include <vd2/Kasumi/pixmaputils.h>
 
 struct VDPixmap;
 
@@ -34,6 +35,7 @@ public:
 private:
 	vdfastvector<uint32>	mCurrentLummap;
 	vdfastvector<uint32>	mPrevLummap;
+	VDPixmapBuffer			mNarrowBuffer;
 	uint32 tile_w, tile_h;
 	bool last_valid;
 	bool first_diff;
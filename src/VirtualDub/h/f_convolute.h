@@ -20,12 +20,14 @@
 
 #include <vd2/plugin/vdvideofilt.h>
 
+struct ConvoluteFilterData;
+
+typedef void (*ConvoluteRowProc)(uint32 *dst, ptrdiff_t dstpitch, const uint32 *src, ptrdiff_t srcpitch, uint32 w, uint32 h, const ConvoluteFilterData& cfd);
+
 struct ConvoluteFilterData {
 	long m[9];
 	long bias;
-	void *dyna_func;
-	uint32 dyna_size;
-	uint32 dyna_old_protect;
+	ConvoluteRowProc rowProc;		// interior kernel, picked at start
 	bool fClip;
 };
 
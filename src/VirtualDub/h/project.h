@@ -159,7 +159,7 @@ public:
 	void CloseAVI();			// to be removed later....
 	void Close();
 
-	void SaveAVI(const wchar_t *filename, bool compat, bool addAsJob);
+	void SaveAVI(const wchar_t *filename, bool compat, bool addAsJob, int jobChunkCount = 0);
 	void SaveFilmstrip(const wchar_t *pFilename, bool propagateErrors);
 	void SaveAnimatedGIF(const wchar_t *pFilename, int loopCount, bool propagateErrors, DubOptions *optsOverride = NULL);
 	void SaveRawAudio(const wchar_t *pFilename, bool propagateErrors, DubOptions *optsOverride = NULL);
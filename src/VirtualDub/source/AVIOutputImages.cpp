@@ -18,13 +18,13 @@
 #include "stdafx.h"
 
 #include <vd2/system/error.h>
+#include <vd2/Meia/encode_jpeg.h>
 #include <vd2/Meia/encode_png.h>
 #include <vd2/Kasumi/pixmap.h>
 #include <vd2/Kasumi/pixmaputils.h>
 #include <vd2/Riza/bitmap.h>
 #include "AVIOutput.h"
 #include "AVIOutputImages.h"
-#include "imagejpeg.h"
 
 class AVIOutputImages;
 
@@ -82,10 +82,13 @@ AVIVideoImageOutputStream::AVIVideoImageOutputStream(const wchar_t *pszPrefix, c
 {
 	dwFrame = 0;
 
-	if (mFormat == AVIOutputImages::kFormatJPEG)
+	if (mFormat == AVIOutputImages::kFormatJPEG) {
 		mpJPEGEncoder = VDCreateJPEGEncoder();
-	else if (mFormat == AVIOutputImages::kFormatPNG)
+		mpJPEGEncoder->SetParallelMode(true);
+	} else if (mFormat == AVIOutputImages::kFormatPNG) {
 		mpPNGEncoder = VDCreateImageEncoderPNG();
+		mpPNGEncoder->SetParallelMode(true);
+	}
 }
 
 AVIVideoImageOutputStream::~AVIVideoImageOutputStream() {
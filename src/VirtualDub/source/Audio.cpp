@@ -2098,7 +2098,9 @@ AudioFilterSystemStream::AudioFilterSystemStream(const VDAudioFilterGraph& graph
 		throw MyError("Audio filter graph lacks an output node.");
 
 	std::vector<IVDAudioFilterInstance *> filterPtrs;
+	mFilterSystemScheduler.setSignal(&mFilterSystemSignal);
 	mFilterSystem.SetScheduler(&mFilterSystemScheduler);
+	mFilterSystem.SetAsyncThreadCount(0);
 	mFilterSystem.LoadFromGraph(graph2, filterPtrs);
 	mFilterSystem.Start();
 
@@ -2144,7 +2146,7 @@ long AudioFilterSystemStream::_Read(void *buffer, long samples, long *lplBytes)
 			if (total_samples >= samples)
 				break;
 
-			if (!mFilterSystemScheduler.Run())
+			if (!mFilterSystem.Run())
 				break;
 		}
 	}
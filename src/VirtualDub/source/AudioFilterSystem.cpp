@@ -10,6 +10,8 @@
 #include <vd2/system/protscope.h>
 #include <vd2/system/VDRingBuffer.h>
 #include <vd2/system/fraction.h>
+#include <vd2/system/profile.h>
+#include <vd2/system/time.h>
 #include <vd2/plugin/vdplugin.h>
 #include <vd2/plugin/vdaudiofilt.h>
 #include <vd2/Priss/convert.h>
@@ -168,6 +170,8 @@ public:
 
 	void Seek(sint64 us);
 
+	void DumpTimings();
+
 	const VDXWaveFormat *GetOutputPinFormat(int outputPin);
 	bool GetInputPinConnection(unsigned inputPin, IVDAudioFilterInstance*& pFilt, unsigned& outputPin);
 	bool GetOutputPinConnection(unsigned outputPin, IVDAudioFilterInstance*& pFilt, unsigned& inputPin);
@@ -199,6 +203,10 @@ protected:
 	sint64		mLastSeekPoint;
 	sint64		mSamplesSinceLastSeekPoint;
 
+	uint32		mRunCount;
+	uint64		mRunTicks;
+	VDProfileEventCache	mProfileCache;
+
 	MyError		mError;
 };
 
@@ -312,6 +320,9 @@ VDAudioFilterInstance::VDAudioFilterInstance(VDPluginDescription *pDesc)
 	: mpDescription(pDesc)
 	, mpPluginInfo(NULL)
 	, mbPrepared(false)
+	, mRunCount(0)
+	, mRunTicks(0)
+	, mProfileCache(0)
 {
 	mpPluginInfo = VDLockPlugin(pDesc);
 	mpDefinition = reinterpret_cast<const VDAudioFilterDefinition *>(mpPluginInfo->mpTypeSpecificInfo);
@@ -413,6 +424,9 @@ void VDAudioFilterInstance::Start() {
 
 	mLastSeekPoint = 0;
 	mSamplesSinceLastSeekPoint = 0;
+
+	mRunCount = 0;
+	mRunTicks = 0;
 }
 
 void VDAudioFilterInstance::Stop() {
@@ -693,11 +707,15 @@ bool VDAudioFilterInstance::Service() {
 		VDAudioFilterPinImpl& inpin			= InputPin(i);
 		VDAudioFilterPinImpl& inpinconn		= *inpin.Connection();
 
+		// The upstream filter may be running on another thread. It raises its
+		// end flag only after committing its final samples, so the flag must
+		// be read before the level or the tail could be dropped.
+		const bool	ended		= *(const volatile bool *)&inpinconn.mbEnded;
 		unsigned	samples		= inpinconn.Filter()->mOutputBuffers[inpinconn.Number()].getLevel() / inpinconn.mpFormat->mBlockSize;
 		unsigned	granules	= samples / inpin.mGranularity;
 
 		inpin.mCurrentLevel = samples;
-		inpin.mbEnded		= inpinconn.mbEnded;
+		inpin.mbEnded		= ended;
 
 		if (inpin.mbEnded)
 			++mInputsEnded;
@@ -760,10 +778,18 @@ bool VDAudioFilterInstance::Service() {
 	uint32 res = 0;
 
 	if (bForceFinalRun || mInputGranules || mOutputGranules) {
+		const uint64 t0 = VDGetPreciseTick();
+
+		VDPROFILEBEGINDYNAMICEX(mProfileCache, mDebugName.c_str(), mRunCount);
 		mError.clear();
 		vdprotected1("running audio filter \"%s\"", const char *, mDebugName.c_str()) {
 			res = mpDefinition->mpVtbl->mpRun(this);
 		}
+		VDPROFILEEND();
+
+		mRunTicks += VDGetPreciseTick() - t0;
+		++mRunCount;
+
 		if (mError.gets())
 			throw mError;
 	}
@@ -791,13 +817,13 @@ bool VDAudioFilterInstance::Service() {
 		VDAudioFilterPinImpl& outpin = OutputPin(j);
 		VDRingBuffer<char>& buffer = mOutputBuffers[j];
 
-		outpin.mbEnded = mbEnded;
-
 		if (!j)
 			mSamplesSinceLastSeekPoint += outpin.mSamplesWritten;
 
 		buffer.UnlockWrite(outpin.mSamplesWritten * outpin.mpFormat->mBlockSize);
 
+		outpin.mbEnded = mbEnded;
+
 		outpin.mCurrentLevel = buffer.getLevel() / outpin.mpFormat->mBlockSize;
 
 		if (mbEnded || outpin.mSamplesWritten) {
@@ -897,6 +923,12 @@ void VDAudioFilterInstance::DumpStatus() {
 
 		VDDEBUG2("            Output pin %d: %d/%d bytes (%s)\n", j, buffer.getLevel(), buffer.getSize(), pin.mbEnded ? "ended" : "active");
 	}
+
+	VDDEBUG2("            Run time: %.2fms over %u runs\n", (double)mRunTicks * 1000.0 / VDGetPreciseTicksPerSecond(), mRunCount);
+}
+
+void VDAudioFilterInstance::DumpTimings() {
+	VDDEBUG("AudioFilterSystem: Filter \"%-30s\": %8.2fms over %u runs\n", mDebugName.c_str(), (double)mRunTicks * 1000.0 / VDGetPreciseTicksPerSecond(), mRunCount);
 }
 
 void VDXAPIENTRYV VDAudioFilterInstance::SetError(const char *format, ...) {
@@ -926,6 +958,7 @@ uint32 VDXAPIENTRY VDAudioFilterInstance::GetCPUFeatureFlags() {
 VDAudioFilterSystem::VDAudioFilterSystem()
 	: mpIOScheduler(NULL)
 	, mpFastScheduler(NULL)
+	, mThreadsRequested(-1)
 {
 }
 
@@ -941,15 +974,15 @@ void VDAudioFilterSystem::SetScheduler(VDScheduler *pIOScheduler, VDScheduler *p
 		mpFastScheduler	= pIOScheduler;
 }
 
+void VDAudioFilterSystem::SetAsyncThreadCount(sint32 threadsToUse) {
+	mThreadsRequested = threadsToUse;
+}
+
 IVDAudioFilterInstance *VDAudioFilterSystem::Create(VDPluginDescription *pDesc) {
 	vdautoptr<VDAudioFilterInstance> pFilter(new VDAudioFilterInstance(pDesc));
 
 	mFilters.push_back(pFilter);
-
-	if (pFilter->IsSerializedIOOnly())
-		mpIOScheduler->Add(pFilter);
-	else
-		mpFastScheduler->Add(pFilter);
+	GetScheduler(pFilter)->Add(pFilter);
 
 	return pFilter.release();
 }
@@ -1252,19 +1285,51 @@ void VDAudioFilterSystem::Start() {
 				mStartedFilters.push_back(pInst);
 			}
 		}
+
+		StartWorkers();
 	}
 }
 
 void VDAudioFilterSystem::Stop() {
 	vdsynchronized(mcsStateChange) {
+		StopWorkers();
+
 		while(!mStartedFilters.empty()) {
 			VDAudioFilterInstance *pInst = mStartedFilters.front();
 			mStartedFilters.pop_front();
+			pInst->DumpTimings();
 			pInst->Stop();
 		}
 	}
 }
 
+bool VDAudioFilterSystem::Run() {
+	for(;;) {
+		if (mpIOScheduler->Run())
+			return true;
+
+		if (!mpWorkerScheduler)
+			return false;
+
+		const bool idle = mpWorkerScheduler->IsIdle();
+
+		vdsynchronized(mcsAsyncError) {
+			if (mAsyncError.gets()) {
+				MyError e;
+				e.TransferFrom(mAsyncError);
+				throw e;
+			}
+		}
+
+		// The last worker to go idle may have queued a filter for this thread
+		// just before doing so, so take one more look once the workers are quiet.
+		if (idle)
+			return mpIOScheduler->Run();
+
+		mpIOScheduler->IdleWait();
+	}
+}
+
 void VDAudioFilterSystem::Seek(sint64 us) {
 	vdsynchronized(mcsStateChange) {
 		Suspend();
@@ -1296,9 +1361,92 @@ void VDAudioFilterSystem::Resume() {
 	for(tFilterList::const_iterator it(mFilters.begin()), itEnd(mFilters.end()); it!=itEnd; ++it) {
 		VDAudioFilterInstance *pInst = *it;
 
-		if (pInst->IsSerializedIOOnly())
-			mpIOScheduler->Add(pInst);
-		else
-			mpFastScheduler->Add(pInst);
+		GetScheduler(pInst)->Add(pInst);
+	}
+}
+
+VDScheduler *VDAudioFilterSystem::GetScheduler(VDAudioFilterInstance *pInst) const {
+	if (pInst->IsSerializedIOOnly())
+		return mpIOScheduler;
+
+	return mpWorkerScheduler ? mpWorkerScheduler : mpFastScheduler;
+}
+
+// Filters that are not bound to the I/O thread can run on a private pool of
+// worker threads. Independent branches of the graph then run concurrently,
+// and each filter can overlap with its neighbors. A filter node is only ever
+// serviced by one thread at a time, and each output ring buffer has a single
+// producer and a single consumer, so the fixed-size pin buffers both carry
+// the data safely and limit how far a branch can run ahead of the others.
+
+void VDAudioFilterSystem::StartWorkers() {
+	if (mThreadsRequested < 0 || mpWorkerScheduler || !mpIOScheduler->getSignal())
+		return;
+
+	uint32 asyncFilters = 0;
+	for(tFilterList::const_iterator it(mFilters.begin()), itEnd(mFilters.end()); it!=itEnd; ++it) {
+		if (!(*it)->IsSerializedIOOnly())
+			++asyncFilters;
 	}
+
+	uint32 threadsToUse = VDGetLogicalProcessorCount();
+
+	if (mThreadsRequested > 0) {
+		threadsToUse = mThreadsRequested;
+
+		if (threadsToUse > 32)
+			threadsToUse = 32;
+	} else {
+		// a single filter off the I/O thread isn't worth the handoffs
+		if (threadsToUse < 2 || asyncFilters < 2)
+			return;
+
+		if (threadsToUse > 4)
+			threadsToUse = 4;
+	}
+
+	if (threadsToUse > asyncFilters)
+		threadsToUse = asyncFilters;
+
+	if (!threadsToUse)
+		return;
+
+	Suspend();
+
+	mAsyncError.clear();
+
+	mpWorkerScheduler = new VDScheduler;
+	mpWorkerScheduler->setSignal(&mWorkerSignal);
+	mpWorkerScheduler->setIdleSignal(mpIOScheduler->getSignal());
+	mpWorkerScheduler->setErrorCallback(this);
+
+	mpWorkerThreadPool = new VDSchedulerThreadPool;
+	mpWorkerThreadPool->Start(mpWorkerScheduler, threadsToUse);
+
+	VDDEBUG("AudioFilterSystem: Running %u filters on %u worker threads.\n", asyncFilters, threadsToUse);
+
+	Resume();
+}
+
+void VDAudioFilterSystem::StopWorkers() {
+	if (!mpWorkerScheduler)
+		return;
+
+	Suspend();
+
+	mpWorkerScheduler->BeginShutdown();
+	mpWorkerThreadPool = NULL;
+	mpWorkerScheduler = NULL;
+
+	Resume();
+}
+
+bool VDAudioFilterSystem::OnAsyncError(MyError& e) {
+	vdsynchronized(mcsAsyncError) {
+		if (!mAsyncError.gets())
+			mAsyncError.TransferFrom(e);
+	}
+
+	mpIOScheduler->Ping();
+	return true;
 }
@@ -168,8 +168,6 @@ DubOptions g_dubOpts = {
 	},
 
 	{
-		true,					// dynamic enable
-		false,
 		false,					// directdraw,
 		true,					// drop frames
 	},
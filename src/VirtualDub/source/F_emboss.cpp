@@ -176,7 +176,7 @@ static bool emboss_script_line(VDXFilterActivation *fa, const VDXFilterFunctions
 VDXFilterDefinition filterDef_emboss={
 	0,0,NULL,
 	"emboss",
-	"Converts edges and gradiations in an image to shades, producing a 3D-like emboss effect.\n\n[Assembly optimized] [Dynamic compilation]",
+	"Converts edges and gradiations in an image to shades, producing a 3D-like emboss effect.\n\n[SSE2 optimized] [Multithreaded]",
 	NULL,NULL,
 	sizeof(MyFilterData),
 	emboss_init,				NULL,
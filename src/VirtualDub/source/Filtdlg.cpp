@@ -1109,6 +1109,12 @@ void VDVideoFiltersDialog::FilterListItem::GetText(int subItem, VDStringW& s) co
 						"YUV420ib-FR",
 						"YUV420ib-709",
 						"YUV420ib-709-FR",
+						"RGB64",
+						"YUV444-16",
+						"YUV422-16",
+						"YUV420-16",
+						"P010",
+						"P016",
 					};
 
 					VDASSERTCT(sizeof(kFormatNames)/sizeof(kFormatNames[0]) == nsVDPixmap::kPixFormat_Max_Standard);
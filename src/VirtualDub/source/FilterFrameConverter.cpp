@@ -20,18 +20,24 @@
 #include "FilterFrameConverter.h"
 
 VDFilterFrameConverter::VDFilterFrameConverter()
-	: mbRequestPending(false)
+	: mpBlitter(NULL)
+	, mbRequestPending(false)
 {
 }
 
 VDFilterFrameConverter::~VDFilterFrameConverter() {
+	if (mpBlitter)
+		VDPixmapGetBlitterCache().Release(mpBlitter);
 }
 
 void VDFilterFrameConverter::Init(IVDFilterFrameSource *source, const VDPixmapLayout& outputLayout, const VDPixmapLayout *sourceLayoutOverride) {
 	mpSource = source;
 	mSourceLayout = sourceLayoutOverride ? *sourceLayoutOverride : source->GetOutputLayout();
 	SetOutputLayout(outputLayout);
-	mpBlitter = VDPixmapCreateBlitter(mLayout, mSourceLayout);
+	if (mpBlitter)
+		VDPixmapGetBlitterCache().Release(mpBlitter);
+
+	mpBlitter = VDPixmapGetBlitterCache().Acquire(mLayout, mSourceLayout);
 }
 
 void VDFilterFrameConverter::Start(IVDFilterFrameEngine *engine) {
@@ -939,6 +939,7 @@ bool FilterInstance::Configure(VDXHWND parent, IVDXFilterPreview2 *ifp2) {
 
 void FilterInstance::PrepareReset() {
 	mbInvalidFormatHandling = false;
+	mFusedFilters.clear();
 }
 
 uint32 FilterInstance::Prepare(const VFBitmapInternal *inputs, uint32 numInputs, VDFilterPrepareInfo& prepareInfo) {
@@ -1360,6 +1361,9 @@ void FilterInstance::Start(uint32 flags, IVDFilterFrameSource *const *pSources,
 	if (mpLogicError)
 		throw MyError("Cannot start filter '%s': %s", filter->name, mpLogicError->mError.c_str());
 
+	if (!mFusedFilters.empty() && !UpdatePointTransform())
+		throw MyError("Cannot start filter '%s': Unable to retrieve point transform tables.", filter->name);
+
 	VDASSERT(mRealDst.mBorderWidth < 10000000 && mRealDst.mBorderHeight < 10000000);
 
 	mbRequestFramePending = false;
@@ -1372,6 +1376,82 @@ void FilterInstance::Start(uint32 flags, IVDFilterFrameSource *const *pSources,
 	VDASSERT(!mExternalDst.GetBuffer());
 }
 
+namespace {
+	bool VDIsSamePixmapLayout(const VDPixmapLayout& a, const VDPixmapLayout& b) {
+		return a.format == b.format
+			&& a.w == b.w
+			&& a.h == b.h
+			&& a.data == b.data
+			&& a.pitch == b.pitch
+			&& a.data2 == b.data2
+			&& a.pitch2 == b.pitch2
+			&& a.data3 == b.data3
+			&& a.pitch3 == b.pitch3;
+	}
+}
+
+bool FilterInstance::IsPointTransform() const {
+	if (mAPIVersion < 18 || !(mFlags & FILTERPARAM_POINT_TRANSFORM))
+		return false;
+
+	if (mbAccelerated || mbInvalidFormat || mbForceSingleFB || GetAlphaParameterCurve() || IsCroppingEnabled())
+		return false;
+
+	if (mFlags & (FILTERPARAM_NEEDS_LAST | FILTERPARAM_SWAP_BUFFERS))
+		return false;
+
+	if (GetFrameDelay() || mSourceStreamCount != 1)
+		return false;
+
+	if (!filter->eventProc || filter->prefetchProc || filter->prefetchProc2)
+		return false;
+
+	if (!VDFilterPointTransform::IsFormatSupported(mRealSrc.mPixmapLayout.format))
+		return false;
+
+	return VDIsSamePixmapLayout(mRealSrc.mPixmapLayout, mRealDst.mPixmapLayout);
+}
+
+void FilterInstance::FusePointTransform(FilterInstance *upstream) {
+	VDASSERT(upstream != this && upstream->IsPointTransform());
+
+	mFusedFilters = upstream->mFusedFilters;
+	mFusedFilters.push_back(upstream);
+}
+
+bool FilterInstance::GetPointTable(const VDXFilterPointTable& table) {
+	bool success = false;
+
+	vdprotected1("querying point table from filter \"%s\"", const char *, filter->name) {
+		VDFilterThreadContext context;
+		VDFilterThreadContextSwapper autoSwap(&context);
+
+		success = filter->eventProc(AsVDXFilterActivation(), &g_VDFilterCallbacks, kVDXVFEvent_GetPointTable, &table);
+	}
+
+	return success;
+}
+
+bool FilterInstance::UpdatePointTransform() {
+	uint8 tables[3][256];
+	VDXFilterPointTable table = { { tables[0], tables[1], tables[2] } };
+
+	mPointTransform.Reset();
+
+	for(FusedFilters::const_iterator it(mFusedFilters.begin()), itEnd(mFusedFilters.end()); it != itEnd; ++it) {
+		if (!(*it)->GetPointTable(table))
+			return false;
+
+		mPointTransform.Append(table);
+	}
+
+	if (!GetPointTable(table))
+		return false;
+
+	mPointTransform.Append(table);
+	return true;
+}
+
 void FilterInstance::StartFilterCallback(VDFilterAccelEngineDispatchQueue *queue, VDFilterAccelEngineMessage *message) {
 	StopStartMessage& msg = *static_cast<StopStartMessage *>(message);
 	
@@ -2200,6 +2280,8 @@ void FilterInstance::RunFilterInner() {
 
 				if (sampleCB) {
 					sampleCB(&AsVDXFilterActivation()->src, mfsi.mOutputFrame, VDClampToSint32(mRealDst.mFrameCount), sampleCBData);
+				} else if (!mFusedFilters.empty()) {
+					mPointTransform.Apply(mRealDst.mPixmap, mRealSrc.mPixmap);
 				} else {
 					// Deliberately ignore the return code. It was supposed to be an error value,
 					// but earlier versions didn't check it and logoaway returns true in some cases.
@@ -2296,6 +2378,10 @@ void FilterInstance::InvalidateAllCachedFrames() {
 
 			filter->eventProc(AsVDXFilterActivation(), &g_VDFilterCallbacks, kVDXVFEvent_InvalidateCaches, NULL);
 		}
+
+		// Upstream filters in the fused run may have changed their tables.
+		if (!mFusedFilters.empty() && !UpdatePointTransform())
+			SetLogicError("Unable to retrieve point transform tables.");
 	}
 }
 
@@ -2371,6 +2457,10 @@ sint64 FilterInstance::GetSymbolicFrame(sint64 outputFrame, IVDFilterFrameSource
 	if (source == this)
 		return outputFrame;
 
+	// Fused point transforms have the same timing as this filter.
+	if (std::find(mFusedFilters.begin(), mFusedFilters.end(), source) != mFusedFilters.end())
+		return outputFrame;
+
 	VideoPrefetcher vp((uint32)mSources.size());
 	GetPrefetchInfo(outputFrame, vp, true);
 	vp.Finalize();
@@ -0,0 +1,258 @@
+//	VirtualDub - Video processing and capture application
+//	Copyright (C) 1998-2009 Avery Lee
+//
+//	This program is free software; you can redistribute it and/or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation; either version 2 of the License, or
+//	(at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with this program; if not, write to the Free Software
+//	Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+
+#include "stdafx.h"
+#include <vd2/system/memory.h>
+#include <vd2/Kasumi/pixmaputils.h>
+#include <vd2/plugin/vdvideofilt.h>
+#include "FilterPointTransform.h"
+
+VDFilterPointTransform::VDFilterPointTransform() {
+	Reset();
+}
+
+bool VDFilterPointTransform::IsFormatSupported(int format) {
+	using namespace nsVDPixmap;
+
+	switch(format) {
+		case kPixFormat_XRGB8888:
+		case kPixFormat_RGB888:
+		case kPixFormat_YUV422_UYVY:
+		case kPixFormat_YUV422_YUYV:
+		case kPixFormat_YUV422_UYVY_709:
+		case kPixFormat_YUV422_YUYV_709:
+		case kPixFormat_YUV422_UYVY_FR:
+		case kPixFormat_YUV422_YUYV_FR:
+		case kPixFormat_YUV422_UYVY_709_FR:
+		case kPixFormat_YUV422_YUYV_709_FR:
+			return true;
+
+		case kPixFormat_Null:
+		case kPixFormat_Pal1:
+		case kPixFormat_Pal2:
+		case kPixFormat_Pal4:
+		case kPixFormat_Pal8:
+			return false;
+	}
+
+	if ((uint32)format >= kPixFormat_Max_Standard)
+		return false;
+
+	// Y8 and the 8-bit planar YCbCr formats.
+	const VDPixmapFormatInfo& info = VDPixmapGetInfo(format);
+
+	return !info.qchunky && info.qsize == 1 && (info.auxbufs == 0 || (info.auxbufs == 2 && info.auxsize == 1));
+}
+
+void VDFilterPointTransform::Reset() {
+	for(int ch=0; ch<3; ++ch) {
+		mbIdentity[ch] = true;
+
+		for(int i=0; i<256; ++i)
+			mTables[ch][i] = (uint8)i;
+	}
+}
+
+void VDFilterPointTransform::Append(const VDXFilterPointTable& table) {
+	for(int ch=0; ch<3; ++ch) {
+		uint8 *VDRESTRICT dst = mTables[ch];
+		const uint8 *VDRESTRICT tbl = table.mpTables[ch];
+		bool identity = true;
+
+		for(int i=0; i<256; ++i) {
+			const uint8 v = tbl[dst[i]];
+
+			dst[i] = v;
+			if (v != i)
+				identity = false;
+		}
+
+		mbIdentity[ch] = identity;
+	}
+}
+
+void VDFilterPointTransform::Apply(const VDPixmap& dst, const VDPixmap& src) const {
+	using namespace nsVDPixmap;
+
+	const uint32 w = dst.w;
+	const uint32 h = dst.h;
+
+	switch(dst.format) {
+		case kPixFormat_XRGB8888:
+			{
+				const uint8 *VDRESTRICT tr = mTables[0];
+				const uint8 *VDRESTRICT tg = mTables[1];
+				const uint8 *VDRESTRICT tb = mTables[2];
+				uint8 *dstRow = (uint8 *)dst.data;
+				const uint8 *srcRow = (const uint8 *)src.data;
+
+				for(uint32 y=0; y<h; ++y) {
+					uint8 *d = dstRow;
+					const uint8 *s = srcRow;
+
+					for(uint32 x=0; x<w; ++x) {
+						const uint8 b = s[0];
+						const uint8 g = s[1];
+						const uint8 r = s[2];
+						const uint8 a = s[3];
+
+						d[0] = tb[b];
+						d[1] = tg[g];
+						d[2] = tr[r];
+						d[3] = a;
+						d += 4;
+						s += 4;
+					}
+
+					dstRow += dst.pitch;
+					srcRow += src.pitch;
+				}
+			}
+			break;
+
+		case kPixFormat_RGB888:
+			{
+				const uint8 *VDRESTRICT tr = mTables[0];
+				const uint8 *VDRESTRICT tg = mTables[1];
+				const uint8 *VDRESTRICT tb = mTables[2];
+				uint8 *dstRow = (uint8 *)dst.data;
+				const uint8 *srcRow = (const uint8 *)src.data;
+
+				for(uint32 y=0; y<h; ++y) {
+					uint8 *d = dstRow;
+					const uint8 *s = srcRow;
+
+					for(uint32 x=0; x<w; ++x) {
+						const uint8 b = s[0];
+						const uint8 g = s[1];
+						const uint8 r = s[2];
+
+						d[0] = tb[b];
+						d[1] = tg[g];
+						d[2] = tr[r];
+						d += 3;
+						s += 3;
+					}
+
+					dstRow += dst.pitch;
+					srcRow += src.pitch;
+				}
+			}
+			break;
+
+		case kPixFormat_YUV422_UYVY:
+		case kPixFormat_YUV422_YUYV:
+		case kPixFormat_YUV422_UYVY_709:
+		case kPixFormat_YUV422_YUYV_709:
+		case kPixFormat_YUV422_UYVY_FR:
+		case kPixFormat_YUV422_YUYV_FR:
+		case kPixFormat_YUV422_UYVY_709_FR:
+		case kPixFormat_YUV422_YUYV_709_FR:
+			{
+				// Byte order within each pixel pair is either U Y V Y or Y U Y V.
+				const bool uyvy = (dst.format == kPixFormat_YUV422_UYVY
+					|| dst.format == kPixFormat_YUV422_UYVY_709
+					|| dst.format == kPixFormat_YUV422_UYVY_FR
+					|| dst.format == kPixFormat_YUV422_UYVY_709_FR);
+
+				const uint8 *VDRESTRICT ty = mTables[0];
+				const uint8 *VDRESTRICT tcb = mTables[1];
+				const uint8 *VDRESTRICT tcr = mTables[2];
+				const uint32 pairs = (w + 1) >> 1;
+				uint8 *dstRow = (uint8 *)dst.data;
+				const uint8 *srcRow = (const uint8 *)src.data;
+
+				for(uint32 y=0; y<h; ++y) {
+					uint8 *d = dstRow;
+					const uint8 *s = srcRow;
+
+					if (uyvy) {
+						for(uint32 x=0; x<pairs; ++x) {
+							const uint8 u  = s[0];
+							const uint8 y0 = s[1];
+							const uint8 v  = s[2];
+							const uint8 y1 = s[3];
+
+							d[0] = tcb[u];
+							d[1] = ty[y0];
+							d[2] = tcr[v];
+							d[3] = ty[y1];
+							d += 4;
+							s += 4;
+						}
+					} else {
+						for(uint32 x=0; x<pairs; ++x) {
+							const uint8 y0 = s[0];
+							const uint8 u  = s[1];
+							const uint8 y1 = s[2];
+							const uint8 v  = s[3];
+
+							d[0] = ty[y0];
+							d[1] = tcb[u];
+							d[2] = ty[y1];
+							d[3] = tcr[v];
+							d += 4;
+							s += 4;
+						}
+					}
+
+					dstRow += dst.pitch;
+					srcRow += src.pitch;
+				}
+			}
+			break;
+
+		default:
+			{
+				const VDPixmapFormatInfo& info = VDPixmapGetInfo(dst.format);
+
+				ApplyPlane(dst.data, dst.pitch, src.data, src.pitch, w, h, 0);
+
+				if (info.auxbufs >= 2) {
+					const uint32 auxw = -(-(sint32)w >> info.auxwbits);
+					const uint32 auxh = -(-(sint32)h >> info.auxhbits);
+
+					ApplyPlane(dst.data2, dst.pitch2, src.data2, src.pitch2, auxw, auxh, 1);
+					ApplyPlane(dst.data3, dst.pitch3, src.data3, src.pitch3, auxw, auxh, 2);
+				}
+			}
+			break;
+	}
+}
+
+void VDFilterPointTransform::ApplyPlane(void *dst, ptrdiff_t dstpitch, const void *src, ptrdiff_t srcpitch, uint32 w, uint32 h, int channel) const {
+	if (mbIdentity[channel]) {
+		if (dst != src)
+			VDMemcpyRect(dst, dstpitch, src, srcpitch, w, h);
+
+		return;
+	}
+
+	const uint8 *VDRESTRICT tbl = mTables[channel];
+
+	for(uint32 y=0; y<h; ++y) {
+		uint8 *d = (uint8 *)dst;
+		const uint8 *s = (const uint8 *)src;
+
+		for(uint32 x=0; x<w; ++x)
+			d[x] = tbl[s[x]];
+
+		dst = (char *)dst + dstpitch;
+		src = (const char *)src + srcpitch;
+	}
+}
@@ -355,7 +355,7 @@ void FilterSystem::prepareLinearChain(VDFilterChainDesc *desc, uint32 src_width,
 		if (flags == FILTERPARAM_NOT_SUPPORTED || (flags & FILTERPARAM_SUPPORTS_ALTFORMATS)) {
 			using namespace nsVDPixmap;
 
-			VDASSERTCT(kPixFormat_Max_Standard == kPixFormat_YUV420ib_Planar_709_FR + 1);
+			VDASSERTCT(kPixFormat_Max_Standard == kPixFormat_YUV420_P016 + 1);
 
 			std::bitset<nsVDPixmap::kPixFormat_Max_Standard> formatMask;
 
@@ -766,6 +766,14 @@ void FilterSystem::initLinearChain(IVDFilterSystemScheduler *scheduler, uint32 f
 
 	tailset[VDStringA("$input")] = inputTail;
 
+	// Runs of adjacent point transform filters are collapsed into the last filter
+	// of the run, which applies the composed lookup tables in a single pass. This
+	// is skipped for non-real-time previews, which sample and reconfigure
+	// individual filters.
+	const bool fusePointTransforms = !(filterStateFlags & VDXFilterStateInfo::kStatePreview) || (filterStateFlags & VDXFilterStateInfo::kStateRealTime);
+	FilterInstance *prevPointFilter = NULL;
+	StreamTail pointRunTail(inputTail);
+
 	for(VDFilterChainDesc::Entries::const_iterator it(desc->mEntries.begin()), itEnd(desc->mEntries.end());
 		it != itEnd;
 		++it)
@@ -893,6 +901,15 @@ void FilterSystem::initLinearChain(IVDFilterSystemScheduler *scheduler, uint32 f
 			}
 		}
 
+		const bool isPointFilter = fusePointTransforms && inputCount == 1 && fa->IsPointTransform();
+
+		if (isPointFilter && prevPointFilter && tails.back().mpSrc == prevPointFilter) {
+			fa->FusePointTransform(prevPointFilter);
+			tails.back() = pointRunTail;
+		} else if (isPointFilter) {
+			pointRunTail = tails.back();
+		}
+
 		FilterEntry& fe = mFilters.push_back();
 		fe.mpFilter = fa;
 		fe.mSources.resize(inputCount);
@@ -915,6 +932,10 @@ void FilterSystem::initLinearChain(IVDFilterSystemScheduler *scheduler, uint32 f
 		prevTail.mpSrc = fa;
 		prevTail.mpProxy = fa->GetOutputAllocatorProxy();
 
+		// A named output may be consumed by more than one filter, so only unnamed
+		// point filters can be folded into the next filter.
+		prevPointFilter = isPointFilter && ent->mOutputName.empty() ? fa : NULL;
+
 		if (!ent->mOutputName.empty())
 			tailset[ent->mOutputName] = prevTail;
 	}
@@ -106,7 +106,14 @@ int VDAudioSourceMP3::_read(VDPosition start, uint32 count, void *buffer, uint32
 			return IVDStreamSource::kOK;
 		}
 
-		const VDInputFileMP3::FrameInfo& frameInfo = mpParent->GetFrameInfo((uint32)start);
+		// Frames past a truncated end of file read as empty.
+		VDInputFileMP3::FrameInfo frameInfo;
+		if (!mpParent->GetFrameInfo((uint32)start, frameInfo)) {
+			frameInfo.mPos = 0;
+			frameInfo.mSize = 0;
+			frameInfo.mSamples = 0;
+		}
+
 		uint32 bytes = frameInfo.mSize;
 
 		if (lSamplesRead)
@@ -221,13 +228,145 @@ int VDInputFileOptionsMP3::write(char *buf, int buflen) const {
 
 /////////////////////////////////////////////////////////////////////
 
+namespace {
+	struct VDMPEGAudioFrameHeader {
+		uint32	mHeader;
+		bool	mbMPEG2;
+		int		mLayer;
+		int		mBitrate;
+		int		mFrequency;
+		int		mPadding;
+		sint32	mFrameSize;
+		uint32	mSamples;
+		uint32	mSamplesDiv192;
+	};
+
+	bool VDDecodeMPEGAudioFrameHeader(uint32 header, VDMPEGAudioFrameHeader& hdr) {
+		// check for valid header
+		if ((header & 0xFFE00000) != 0xFFE00000)
+			return false;
+
+		// MPEG-1.5 isn't valid
+		if ((header & 0x00180000) == 0x00080000)
+			return false;
+
+		// check for valid bitrate
+		if (!(header & 0x0000F000))
+			return false;
+
+		// we don't allow free-form
+		if ((header & 0x0000F000) == 0x0000F000)
+			return false;
+
+		// check for valid sampling rate
+		if ((header & 0x00000C00) == 0x00000C00)
+			return false;
+
+		// check for valid layer
+		if ((header & 0x00060000) == 0)
+			return false;
+
+		// syncword			12 bits		FFF00000
+		// id				1 bit		00080000
+		// layer			2 bits		00060000
+		// protection		1 bit		00010000
+		// bitrate			4 bits		0000F000
+		// sampling rate	2 bits		00000C00
+		// padding			1 bit		00000200
+		// private bit		1 bit		00000100
+		// mode				2 bits		000000C0
+		// mode extension	2 bits		00000030
+		// copyright		1 bit		00000008
+		// original/copy	1 bit		00000004
+		// emphasis			2 bits		00000003
+
+		// compute frame size
+		static const int sBitrateTable[2][3][16]={
+			{
+				{ 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 },	// MPEG-1 layer I
+				{ 0, 32, 48, 56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 384, 0 },	// MPEG-1 layer II
+				{ 0, 32, 40, 48,  56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 0 },	// MPEG-1 layer III
+			},
+			{
+				{ 0, 32, 48, 56,  64,  80,  96, 112, 128, 144, 160, 176, 192, 224, 256, 0 },	// MPEG-2 layer I
+				{ 0,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160, 0 },	// MPEG-2 layer II
+				{ 0,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160, 0 },	// MPEG-2 layer III
+			}
+		};
+
+		static const int sFrequencyTable[2][4]={{44100,48000,32000,0}, {22050,24000,16000,0}};
+
+		bool is_mpeg2	= (header & 0x00080000) == 0;
+		bool is_mpeg25	= (header & 0x00100000) == 0;
+		int layer		= 4 - ((header>>17)&3);
+		int bitrate_idx	= (header>>12)&15;
+		int freq_idx	= (header>>10)&3;
+		int padding		= (header>>9)&1;
+		int bitrate		= sBitrateTable[is_mpeg2][layer-1][bitrate_idx];
+		int freq		= sFrequencyTable[is_mpeg2][freq_idx];
+
+		if (is_mpeg25)
+			freq >>= 1;
+
+		hdr.mHeader		= header;
+		hdr.mbMPEG2		= is_mpeg2;
+		hdr.mLayer		= layer;
+		hdr.mBitrate	= bitrate;
+		hdr.mFrequency	= freq;
+		hdr.mPadding	= padding;
+
+		if (layer == 1) {
+			hdr.mFrameSize = 4*(12000*bitrate/freq + padding);
+			hdr.mSamplesDiv192 = 2;		// 384 samples
+		} else if (is_mpeg2 && layer == 3) {
+			hdr.mFrameSize = (72000*bitrate/freq + padding);
+			hdr.mSamplesDiv192 = 3;		// 576 samples
+		} else {
+			hdr.mFrameSize = (144000*bitrate/freq + padding);
+			hdr.mSamplesDiv192 = 6;		// 1152 samples
+		}
+
+		hdr.mSamples = hdr.mSamplesDiv192 * 192;
+		return true;
+	}
+
+	// Scan forward byte by byte to the next valid frame header. On success, the
+	// stream is positioned just past the four header bytes.
+	bool VDFindNextMPEGAudioFrame(VDBufferedStream& stream, VDMPEGAudioFrameHeader& hdr) {
+		uint32 header = 0;
+
+		for(;;) {
+			uint8 c;
+			if (0 == stream.ReadData(&c, 1))
+				return false;
+
+			header = (header << 8) + c;
+
+			if (VDDecodeMPEGAudioFrameHeader(header, hdr))
+				return true;
+		}
+	}
+
+	uint32 VDReadBE32(const uint8 *p) {
+		return ((uint32)p[0] << 24) + ((uint32)p[1] << 16) + ((uint32)p[2] << 8) + p[3];
+	}
+}
+
 VDInputFileMP3::VDInputFileMP3()
-	: mBufferedFile(&mFile, VDPreferencesGetRenderWaveBufferSize())
+	: VDThread("MP3 indexer")
+	, mBufferedFile(&mFile, VDPreferencesGetRenderWaveBufferSize())
+	, mFrameCount(0)
+	, mbSparseIndex(false)
+	, mbIndexComplete(false)
+	, mbIndexThreadExit(false)
+	, mLastFrame((uint32)0 - 2)
 	, mBitRateMode(kBRM_Autodetect)
 {
 }
 
 VDInputFileMP3::~VDInputFileMP3() {
+	mbIndexThreadExit = true;
+	ThreadWait();
 }
 
 void VDInputFileMP3::Init(const wchar_t *szFile) {
@@ -257,13 +396,21 @@ void VDInputFileMP3::Init(const wchar_t *szFile) {
 		}
 	}
 
+	// If the first frame carries a Xing/Info or VBRI header, the frame count
+	// and stream size are known up front. In that case only a prefix of the
+	// file is scanned for format statistics, and frame positions are indexed
+	// lazily instead of walking every header in the file before it can open.
+	VBRHeader vbrHeader;
+	mBufferedFile.Seek(mDataStart);
+	const bool haveVBRHeader = ReadVBRHeader(vbrHeader);
+	const uint32 frameLimit = haveVBRHeader ? kProbeFrames : 0xFFFFFFFFU;
+
 	mBufferedFile.Seek(mDataStart);
 
 	uint32 currentTrackedHeader = 0;
 	uint32 currentConfidence = 0;
 	uint32 bestConfidence = 0;
 
-	uint32 header = 0;
 	uint32 channels = 0;
 	uint32 samplingRate = 0;
 	uint32 totalSamplesDiv192 = 0;
@@ -288,91 +435,11 @@ void VDInputFileMP3::Init(const wchar_t *szFile) {
 
 	mDataLength = 0;
 	mSamplesPerFrame = 0;
-	for(;;) {
-		uint8 c;
-		if (0 == mBufferedFile.ReadData(&c, 1))
-			break;
 
-		header = (header << 8) + c;
-
-		// check for valid header
-		if ((header & 0xFFE00000) != 0xFFE00000)
-			continue;
-
-		// MPEG-1.5 isn't valid
-		if ((header & 0x00180000) == 0x00080000)
-			continue;
-
-		// check for valid bitrate
-		if (!(header & 0x0000F000))
-			continue;
-
-		// we don't allow free-form
-		if ((header & 0x0000F000) == 0x0000F000)
-			continue;
-
-		// check for valid sampling rate
-		if ((header & 0x00000C00) == 0x00000C00)
-			continue;
-
-		// check for valid layer
-		if ((header & 0x00060000) == 0)
-			continue;
-
-		// syncword			12 bits		FFF00000
-		// id				1 bit		00080000
-		// layer			2 bits		00060000
-		// protection		1 bit		00010000
-		// bitrate			4 bits		0000F000
-		// sampling rate	2 bits		00000C00
-		// padding			1 bit		00000200
-		// private bit		1 bit		00000100
-		// mode				2 bits		000000C0
-		// mode extension	2 bits		00000030
-		// copyright		1 bit		00000008
-		// original/copy	1 bit		00000004
-		// emphasis			2 bits		00000003
-
-		// compute frame size
-		static const int sBitrateTable[2][3][16]={
-			{
-				{ 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 },	// MPEG-1 layer I
-				{ 0, 32, 48, 56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 384, 0 },	// MPEG-1 layer II
-				{ 0, 32, 40, 48,  56,  64,  80,  96, 112, 128, 160, 192, 224, 256, 320, 0 },	// MPEG-1 layer III
-			},
-			{
-				{ 0, 32, 48, 56,  64,  80,  96, 112, 128, 144, 160, 176, 192, 224, 256, 0 },	// MPEG-2 layer I
-				{ 0,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160, 0 },	// MPEG-2 layer II
-				{ 0,  8, 16, 24,  32,  40,  48,  56,  64,  80,  96, 112, 128, 144, 160, 0 },	// MPEG-2 layer III
-			}
-		};
-
-		static const int sFrequencyTable[2][4]={{44100,48000,32000,0}, {22050,24000,16000,0}};
-
-		bool is_mpeg2	= (header & 0x00080000) == 0;
-		bool is_mpeg25	= (header & 0x00100000) == 0;
-		int layer		= 4 - ((header>>17)&3);
-		int bitrate_idx	= (header>>12)&15;
-		int freq_idx	= (header>>10)&3;
-		int padding		= (header>>9)&1;
-		int bitrate		= sBitrateTable[is_mpeg2][layer-1][bitrate_idx];
-		int freq		= sFrequencyTable[is_mpeg2][freq_idx];
-
-		if (is_mpeg25)
-			freq >>= 1;
-
-		sint32 frameDataSize;
-		uint32 frameSamplesDiv192 = 0;
-		if (layer == 1) {
-			frameDataSize = 4*(12000*bitrate/freq + padding);
-			frameSamplesDiv192 = 2;		// 384 samples
-		} else if (is_mpeg2 && layer == 3) {
-			frameDataSize = (72000*bitrate/freq + padding);
-			frameSamplesDiv192 = 3;		// 576 samples
-		} else {
-			frameDataSize = (144000*bitrate/freq + padding);
-			frameSamplesDiv192 = 6;		// 1152 samples
-		}
+	VDMPEGAudioFrameHeader hdr;
+	while(mFrames.size() < frameLimit && VDFindNextMPEGAudioFrame(mBufferedFile, hdr)) {
+		const uint32 header = hdr.mHeader;
+		sint32 frameDataSize = hdr.mFrameSize;
 
 		if (currentTrackedHeader && !((currentTrackedHeader ^ header) & 0x00000CC0)) {
 			++currentConfidence;
@@ -381,15 +448,12 @@ void VDInputFileMP3::Init(const wchar_t *szFile) {
 			currentConfidence = 1;
 		}
 
-		static const int kLayerFrameSizes[2][3]={{384,1152,1152},{384,1152,576}};
-		int samples = kLayerFrameSizes[is_mpeg2][layer - 1];
-
 		if (currentConfidence > bestConfidence) {
 			bestConfidence = currentConfidence;
 
 			channels = (header & 0xc0) == 0xc0 ? 1 : 2;
-			samplingRate = freq;
-			mSamplesPerFrame = samples;
+			samplingRate = hdr.mFrequency;
+			mSamplesPerFrame = hdr.mSamples;
 		}
 
 		++framesWithMode[(header >> 6) & 3];
@@ -407,22 +471,22 @@ void VDInputFileMP3::Init(const wchar_t *szFile) {
 		if (header & 0x00000008)
 			++framesWithCopyright;
 
-		if (!is_mpeg2)
+		if (!hdr.mbMPEG2)
 			++framesWithMPEG1;
 
-		switch(layer) {
+		switch(hdr.mLayer) {
 		case 1:	++framesWithLayer1; break;
 		case 2:	++framesWithLayer2; break;
 		case 3:	++framesWithLayer3; break;
 		}
 
-		if (bitrate > highestBitrate)
-			highestBitrate = bitrate;
+		if ((uint32)hdr.mBitrate > highestBitrate)
+			highestBitrate = hdr.mBitrate;
 
 		FrameInfo fi;
 		fi.mPos		= mBufferedFile.Pos() - 4 - mDataStart;
 		fi.mSize	= frameDataSize;
-		fi.mSamples	= samples;
+		fi.mSamples	= hdr.mSamples;
 
 		// skip data payload
 		frameDataSize -= 4;
@@ -430,11 +494,11 @@ void VDInputFileMP3::Init(const wchar_t *szFile) {
 			break;
 
 		mDataLength += frameDataSize + 4;
-		totalSamplesDiv192 += frameSamplesDiv192;
+		totalSamplesDiv192 += hdr.mSamplesDiv192;
 
 		mFrames.push_back(fi);
 
-		pads += padding;
+		pads += hdr.mPadding;
 
 		if (maxFrameSize < fi.mSize)
 			maxFrameSize = fi.mSize;
@@ -443,10 +507,35 @@ void VDInputFileMP3::Init(const wchar_t *szFile) {
 	if (mFrames.empty())
 		throw MyError("No valid MPEG audio data was detected in file \"%ls.\"", szFile);
 
+	// Ratios below are computed over the scanned frames; with a VBR header
+	// that is only the probed prefix.
+	const int frameCount = (int)mFrames.size();
+
+	mFrameCount = frameCount;
+	mbSparseIndex = haveVBRHeader && mFrames.size() >= frameLimit;
+
+	if (mbSparseIndex) {
+		// The header frame itself is kept as a frame, as it is with a full scan.
+		mFrameCount = vbrHeader.mFrames + 1;
+		mDataLength = vbrHeader.mBytes;
+		totalSamplesDiv192 = mFrameCount * (mSamplesPerFrame / 192);
+
+		// No frame can be larger than one at the highest bitrate with padding.
+		VDMPEGAudioFrameHeader maxhdr;
+		if (VDDecodeMPEGAudioFrameHeader((currentTrackedHeader & ~0x0000F000) | 0x0000E200, maxhdr))
+			maxFrameSize = std::max<uint32>(maxFrameSize, maxhdr.mFrameSize);
+
+		for(uint32 i=0; i<kProbeFrames; i += (1 << kCheckpointShift))
+			mCheckpoints.push_back(mFrames[i].mPos);
+	}
+
 	// decide if we want to use CBR or VBR mode
 	double seconds = (double)totalSamplesDiv192 * 192.0 / (double)samplingRate;
 	double averageDataRate = (double)mDataLength / (double)seconds;
-	if (mBitRateMode == kBRM_Autodetect) {
+	if (mbSparseIndex && mBitRateMode == kBRM_Autodetect) {
+		// LAME writes "Info" instead of "Xing" for CBR streams.
+		mbVBRMode = vbrHeader.mbVBR;
+	} else if (mBitRateMode == kBRM_Autodetect) {
 
 		Frames::const_iterator it(mFrames.begin()), itEnd(mFrames.end());
 		sint64 localBytes = 0;
@@ -481,7 +570,6 @@ void VDInputFileMP3::Init(const wchar_t *szFile) {
 	uint32 vbrBlockAlign = maxFrameSize + 1151;
 	vbrBlockAlign -= vbrBlockAlign % 1152;
 
-	int frameCount = (int)mFrames.size();
 	if (framesWithLayer3 * 10 > frameCount * 9) {
 		mWaveFormat.resize(sizeof(mpeglayer3waveformat_tag));
 		mpeglayer3waveformat_tag& wf = *(mpeglayer3waveformat_tag *)mWaveFormat.data();
@@ -559,6 +647,16 @@ void VDInputFileMP3::Init(const wchar_t *szFile) {
 		wf.dwPTSLow			= 0;
 		wf.dwPTSHigh		= 0;
 	}
+
+	if (mbSparseIndex) {
+		mFrames.clear();
+
+		// Byte-addressed CBR reads never consult the frame index.
+		if (mbVBRMode) {
+			mIndexFile.open(szFile);
+			ThreadStart();
+		}
+	}
 }
 
 void VDInputFileMP3::setOptions(InputFileOptions *opts0) {
@@ -639,8 +737,168 @@ bool VDInputFileMP3::GetAudioSource(int index, AudioSource **ppSrc) {
 	return true;
 }
 
-const VDInputFileMP3::FrameInfo& VDInputFileMP3::GetFrameInfo(uint32 frame) const {
-	return mFrames[frame];
+bool VDInputFileMP3::GetFrameInfo(uint32 frame, FrameInfo& fi) {
+	if (!mbSparseIndex) {
+		if (frame >= mFrames.size())
+			return false;
+
+		fi = mFrames[frame];
+		return true;
+	}
+
+	vdsynchronized(mIndexLock) {
+		sint64 pos;
+		uint32 skip;
+
+		if (frame == mLastFrame + 1) {
+			// sequential read -- continue from the last frame
+			pos = mLastFrameInfo.mPos + mLastFrameInfo.mSize;
+			skip = 0;
+		} else {
+			const uint32 checkpoint = frame >> kCheckpointShift;
+
+			while(checkpoint >= mCheckpoints.size()) {
+				if (!ExtendIndex(mBufferedFile))
+					return false;
+			}
+
+			pos = mCheckpoints[checkpoint];
+			skip = frame & ((1 << kCheckpointShift) - 1);
+		}
+
+		if (!ScanFrames(mBufferedFile, pos, skip + 1, &fi)) {
+			mLastFrame = (uint32)0 - 2;
+			return false;
+		}
+
+		mLastFrame = frame;
+		mLastFrameInfo = fi;
+	}
+
+	return true;
+}
+
+bool VDInputFileMP3::ReadVBRHeader(VBRHeader& vbr) {
+	VDMPEGAudioFrameHeader hdr;
+	if (!VDFindNextMPEGAudioFrame(mBufferedFile, hdr) || hdr.mLayer != 3)
+		return false;
+
+	uint8 buf[192];
+	const uint32 len = std::min<uint32>(hdr.mFrameSize, sizeof buf);
+
+	buf[0] = (uint8)(hdr.mHeader >> 24);
+	buf[1] = (uint8)(hdr.mHeader >> 16);
+	buf[2] = (uint8)(hdr.mHeader >>  8);
+	buf[3] = (uint8)(hdr.mHeader      );
+
+	if (len < 4 || (sint32)(len - 4) != mBufferedFile.ReadData(buf + 4, len - 4))
+		return false;
+
+	// Xing/Info headers follow the side info; VBRI headers are always at
+	// offset 32 past the frame header.
+	const bool mono = (hdr.mHeader & 0xc0) == 0xc0;
+	const uint32 xingOffset = 4 + (hdr.mbMPEG2 ? (mono ? 9 : 17) : (mono ? 17 : 32));
+	const uint32 vbriOffset = 4 + 32;
+
+	if (xingOffset + 16 <= len && (!memcmp(buf + xingOffset, "Xing", 4) || !memcmp(buf + xingOffset, "Info", 4))) {
+		const uint8 *xing = buf + xingOffset;
+
+		// need both the frame count and the byte count
+		if ((VDReadBE32(xing + 4) & 3) != 3)
+			return false;
+
+		vbr.mFrames	= VDReadBE32(xing + 8);
+		vbr.mBytes	= VDReadBE32(xing + 12);
+		vbr.mbVBR	= (xing[0] == 'X');
+	} else if (vbriOffset + 18 <= len && !memcmp(buf + vbriOffset, "VBRI", 4)) {
+		const uint8 *vbri = buf + vbriOffset;
+
+		vbr.mBytes	= VDReadBE32(vbri + 10);
+		vbr.mFrames	= VDReadBE32(vbri + 14);
+		vbr.mbVBR	= true;
+	} else
+		return false;
+
+	// Don't trust a header that disagrees with the file.
+	if (!vbr.mFrames || vbr.mFrames < kProbeFrames)
+		return false;
+
+	const sint64 available = mBufferedFile.Length() - mDataStart;
+	if (vbr.mBytes > available || vbr.mBytes < (sint64)vbr.mFrames * 24)
+		return false;
+
+	return true;
+}
+
+bool VDInputFileMP3::ScanFrames(VDBufferedStream& stream, sint64& pos, uint32 count, FrameInfo *lastFrame) {
+	stream.Seek(mDataStart + pos);
+
+	VDMPEGAudioFrameHeader hdr;
+	while(count--) {
+		if (!VDFindNextMPEGAudioFrame(stream, hdr))
+			return false;
+
+		const sint64 framePos = stream.Pos() - 4 - mDataStart;
+		const sint32 payload = hdr.mFrameSize - 4;
+
+		if (payload != stream.ReadData(NULL, payload))
+			return false;
+
+		pos = framePos + hdr.mFrameSize;
+
+		if (!count && lastFrame) {
+			lastFrame->mPos		= framePos;
+			lastFrame->mSize	= hdr.mFrameSize;
+			lastFrame->mSamples	= hdr.mSamples;
+		}
+	}
+
+	return true;
+}
+
+bool VDInputFileMP3::ExtendIndex(VDBufferedStream& stream) {
+	// must be called with mIndexLock held
+	if (mbIndexComplete)
+		return false;
+
+	sint64 pos = mCheckpoints.back();
+	if (!ScanFrames(stream, pos, 1 << kCheckpointShift, NULL)) {
+		mbIndexComplete = true;
+		return false;
+	}
+
+	mCheckpoints.push_back(pos);
+	return true;
+}
+
+void VDInputFileMP3::ThreadRun() {
+	VDBufferedStream stream(&mIndexFile, 65536);
+
+	while(!mbIndexThreadExit) {
+		sint64 pos;
+		size_t n;
+
+		vdsynchronized(mIndexLock) {
+			if (mbIndexComplete)
+				return;
+
+			pos = mCheckpoints.back();
+			n = mCheckpoints.size();
+		}
+
+		// Scan without holding the lock; a reader may have extended the
+		// index meanwhile, in which case this result is simply dropped.
+		bool valid = ScanFrames(stream, pos, 1 << kCheckpointShift, NULL);
+
+		vdsynchronized(mIndexLock) {
+			if (mCheckpoints.size() == n) {
+				if (valid)
+					mCheckpoints.push_back(pos);
+				else
+					mbIndexComplete = true;
+			}
+		}
+	}
 }
 
 void VDInputFileMP3::ReadSpan(sint64 pos, void *buffer, uint32 len) {
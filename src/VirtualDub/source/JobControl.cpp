@@ -57,7 +57,17 @@ VDJobQueue::VDJobQueue()
 	, mJobIdToRun(0)
 	, mLastSignature(0)
 	, mLastRevision(0)
+	, mJournalSignature(0)
+	, mJournalOffset(0)
+	, mClaimedJobId(0)
+	, mbClaimLost(false)
+	, mClaimCount(0)
+	, mClaimConflictCount(0)
+	, mExpiredLeaseCount(0)
+	, mFirstClaimTick(0)
 {
+	mLeaseTimer.mpParent = this;
+
 	char name[MAX_COMPUTERNAME_LENGTH + 1];
 	DWORD len = MAX_COMPUTERNAME_LENGTH + 1;
 
@@ -115,8 +125,17 @@ void VDJobQueue::SetJobFilePath(const wchar_t *path, bool enableDistributedMode,
 	SetAutoUpdateEnabled(enableAutoUpdate);
 	mLastSignature = 0;
 	mLastRevision = 0;
+	mJournalSignature = 0;
+	mJournalOffset = 0;
+	mDeletedJobIds.clear();
+	mLeaseObservations.clear();
 	mbDistributedMode = enableDistributedMode;
 
+	if (mbDistributedMode)
+		mLeaseTimer.mTimer.SetPeriodic(&mLeaseTimer, kLeaseRenewPeriod);
+	else
+		mLeaseTimer.mTimer.Stop();
+
 	ListLoad(NULL, false);
 
 	if (g_pVDJobQueueStatusCallback) {
@@ -129,6 +148,10 @@ void VDJobQueue::SetDefaultJobFilePath(const wchar_t *path) {
 	mDefaultJobFilePath = path;
 }
 
+VDStringW VDJobQueue::GetJournalPath() const {
+	return mJobFilePath + L".journal";
+}
+
 int32 VDJobQueue::GetJobIndexById(uint64 id) const {
 	int32 index = 0;
 	JobQueue::const_iterator it(mJobQueue.begin()), itEnd(mJobQueue.end());
@@ -154,6 +177,30 @@ VDJob *VDJobQueue::GetJobById(uint64 id) const {
 	return NULL;
 }
 
+bool VDJobQueue::IsJobReady(const VDJob *job) const {
+	if (job->GetState() != VDJob::kStateWaiting)
+		return false;
+
+	// The job that joins a chunked render has to wait until every chunk has
+	// been rendered, possibly by other runners.
+	if (job->IsChunkJoin()) {
+		int completed = 0;
+
+		JobQueue::const_iterator it(mJobQueue.begin()), itEnd(mJobQueue.end());
+		for(; it != itEnd; ++it) {
+			const VDJob *chunk = *it;
+
+			if (chunk != job && chunk->mChunkGroupId == job->mChunkGroupId && chunk->GetState() == VDJob::kStateCompleted)
+				++completed;
+		}
+
+		if (completed < job->mChunkCount)
+			return false;
+	}
+
+	return true;
+}
+
 VDJob *VDJobQueue::ListGet(int index) {
 	if ((unsigned)index >= mJobQueue.size())
 		return NULL;
@@ -186,6 +233,9 @@ void VDJobQueue::ListClear(bool force_no_update) {
 			VDASSERT(vdj->mpJobQueue == this);
 			vdj->mpJobQueue = NULL;
 
+			if (vdj->mCreationRevision)
+				mDeletedJobIds.push_back(vdj->mId);
+
 			mJobQueue.erase(mJobQueue.begin() + i);
 			--mJobCount;
 			
@@ -247,6 +297,10 @@ void VDJobQueue::Delete(VDJob *job, bool force_no_update) {
 
 	mJobQueue.erase(mJobQueue.begin() + index);
 	--mJobCount;
+
+	// jobs that were never flushed don't need to be deleted from the journal
+	if (job->mCreationRevision)
+		mDeletedJobIds.push_back(job->mId);
 	
 	if (!force_no_update) SetModified();
 }
@@ -258,16 +312,7 @@ void VDJobQueue::Run(VDJob *job) {
 		try {
 			Flush();
 		} catch(const MyError&) {
-			if (!mRetryTimer.mLastPeriod)
-				mRetryTimer.mLastPeriod = 100;
-			else {
-				mRetryTimer.mLastPeriod += mRetryTimer.mLastPeriod;
-				if (mRetryTimer.mLastPeriod > 1000)
-					mRetryTimer.mLastPeriod = 1000;
-			}
-
-			mRetryTimer.mbRetryOK = false;
-			mRetryTimer.mTimer.SetOneShot(&mRetryTimer, mRetryTimer.mLastPeriod);
+			mRetryTimer.Defer();
 			return;
 		}
 	}
@@ -276,6 +321,33 @@ void VDJobQueue::Run(VDJob *job) {
 	if (!job || job->IsRunning())
 		return;
 
+	// The claim file decides which runner gets the job when several try to
+	// start it at once; the others back off until they see the winner's
+	// update to the queue.
+	if (mbDistributedMode) {
+		if (!ClaimJob(id)) {
+			mRetryTimer.Defer();
+			return;
+		}
+
+		// Another runner may have finished the job and dropped its claim
+		// between our flush and our claim, so check the job again now that
+		// nobody else can start it.
+		try {
+			Flush();
+		} catch(const MyError&) {
+			ReleaseClaim();
+			mRetryTimer.Defer();
+			return;
+		}
+
+		job = GetJobById(id);
+		if (!job || !IsJobReady(job)) {
+			ReleaseClaim();
+			return;
+		}
+	}
+
 	FILETIME ft;
 	GetSystemTimeAsFileTime(&ft);
 
@@ -312,16 +384,8 @@ void VDJobQueue::Run(VDJob *job) {
 			job->SetModified(false);
 			job->Refresh();
 
-			if (!mRetryTimer.mLastPeriod)
-				mRetryTimer.mLastPeriod = 100;
-			else {
-				mRetryTimer.mLastPeriod += mRetryTimer.mLastPeriod;
-				if (mRetryTimer.mLastPeriod > 1000)
-					mRetryTimer.mLastPeriod = 1000;
-			}
-
-			mRetryTimer.mbRetryOK = false;
-			mRetryTimer.mTimer.SetOneShot(&mRetryTimer, mRetryTimer.mLastPeriod);
+			ReleaseClaim();
+			mRetryTimer.Defer();
 			return;
 		}
 	} else {
@@ -339,13 +403,17 @@ void VDJobQueue::Run(VDJob *job) {
 
 	job = GetJobById(id);
 
-	if (!job || !job->IsLocal())
+	if (!job || !job->IsLocal()) {
+		ReleaseClaim();
 		return;
+	}
 
 	VDASSERT(job->GetState() != VDJob::kStateStarting);
 
-	if (!job->IsRunning())
+	if (!job->IsRunning()) {
+		ReleaseClaim();
 		return;
+	}
 
 	mpRunningJob = job;
 
@@ -383,6 +451,15 @@ void VDJobQueue::Run(VDJob *job) {
 		g_pVDJobQueueStatusCallback->OnJobEnded(*job);
 	mpRunningJob = NULL;
 
+	// If another runner took the job over while we were rendering it, the
+	// job record is theirs now, so leave it for them to update.
+	if (mbClaimLost) {
+		mbClaimLost = false;
+		job->SetModified(false);
+		job->Refresh();
+		return;
+	}
+
 	if (job->GetState() == VDJob::kStateInProgress)
 		job->SetState(VDJob::kStateCompleted);
 
@@ -400,8 +477,236 @@ void VDJobQueue::Run(VDJob *job) {
 		// up, but as long as our in-memory queue is OK, we can at least finish
 		// remaining jobs.
 	}
+
+	ReleaseClaim();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+//	Job claims
+//
+//	In distributed mode, a runner claims a job by creating a claim file for it
+//	next to the job list, which fails if another runner got there first.
+//	While the job runs, the runner bumps a heartbeat counter in the claim file
+//	to renew its lease. Other runners only watch for the claim file to change,
+//	so the clocks of the machines don't need to agree. A job whose claim file
+//	hasn't changed for kLeaseTimeout is put back in the queue.
+//
+//	Breaking an expired claim must not race with another runner doing the
+//	same, so the claim file is renamed out of the way before it is deleted;
+//	only one runner's rename can succeed. A runner that finds its claim gone
+//	or replaced aborts its render.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+	bool VDReadJobClaimFile(const wchar_t *path, void *dst, long len) {
+		VDFile f;
+
+		return f.openNT(path, nsVDFile::kRead | nsVDFile::kDenyNone | nsVDFile::kOpenExisting) && f.readData(dst, len) == len;
+	}
+}
+
+VDStringW VDJobQueue::GetClaimPath(uint64 id) const {
+	VDStringW path(mJobFilePath);
+
+	path.append_sprintf(L".%016llx.claim", id);
+	return path;
+}
+
+bool VDJobQueue::ClaimJob(uint64 id) {
+	VDASSERT(!mClaimedJobId);
+
+	if (!mFirstClaimTick)
+		mFirstClaimTick = VDGetCurrentTick();
+
+	const VDStringW path(GetClaimPath(id));
+	const uint32 flags = nsVDFile::kWrite | nsVDFile::kDenyNone | nsVDFile::kCreateNew;
+
+	VDFile f;
+	if (!f.openNT(path.c_str(), flags)) {
+		// Another runner holds the claim. Only break it if the runner has
+		// stopped renewing it, which happens if it died before it could
+		// mark the job as started.
+		if (!IsLeaseExpired(id) || !BreakExpiredClaim(id) || !f.openNT(path.c_str(), flags)) {
+			++mClaimConflictCount;
+			return false;
+		}
+	}
+
+	mClaimRecord.mRunnerId = mRunnerId;
+	mClaimRecord.mClaimTick = VDGetCurrentTick();
+	mClaimRecord.mHeartbeat = 0;
+
+	if (f.writeData(&mClaimRecord, sizeof mClaimRecord) != sizeof mClaimRecord) {
+		f.closeNT();
+		VDRemoveFile(path.c_str());
+		++mClaimConflictCount;
+		return false;
+	}
+
+	mClaimedJobId = id;
+	mbClaimLost = false;
+	++mClaimCount;
+	return true;
+}
+
+bool VDJobQueue::BreakExpiredClaim(uint64 id) {
+	const VDStringW path(GetClaimPath(id));
+	VDStringW stalePath(path);
+
+	stalePath.append_sprintf(L".%016llx.stale", mRunnerId);
+
+	// A claim file that has been missing for the whole lease timeout has
+	// nothing to break.
+	if (!VDDoesPathExist(path.c_str())) {
+		mLeaseObservations.erase(id);
+		return true;
+	}
+
+	try {
+		VDMoveFile(path.c_str(), stalePath.c_str());
+	} catch(const MyError&) {
+		// another runner got to it first
+		return false;
+	}
+
+	// Between our lease check and the rename, another runner may have broken
+	// the claim and made a new one, which is what we just moved. If so, put
+	// it back.
+	ClaimRecord rec;
+	if (!VDReadJobClaimFile(stalePath.c_str(), &rec, sizeof rec))
+		memset(&rec, 0, sizeof rec);
+
+	LeaseObservations::iterator it(mLeaseObservations.find(id));
+	if (it == mLeaseObservations.end() || memcmp(&it->second.mRecord, &rec, sizeof rec)) {
+		try {
+			VDMoveFile(stalePath.c_str(), path.c_str());
+		} catch(const MyError&) {
+			VDRemoveFile(stalePath.c_str());
+		}
+
+		return false;
+	}
+
+	VDRemoveFile(stalePath.c_str());
+	mLeaseObservations.erase(id);
+	return true;
 }
 
+void VDJobQueue::ReleaseClaim() {
+	if (!mClaimedJobId)
+		return;
+
+	const VDStringW path(GetClaimPath(mClaimedJobId));
+	mClaimedJobId = 0;
+
+	// Don't remove the claim file if another runner has taken the job from us.
+	ClaimRecord rec;
+	if (VDReadJobClaimFile(path.c_str(), &rec, sizeof rec) && rec.mRunnerId == mClaimRecord.mRunnerId && rec.mClaimTick == mClaimRecord.mClaimTick)
+		VDRemoveFile(path.c_str());
+}
+
+void VDJobQueue::RenewLease() {
+	if (!mClaimedJobId)
+		return;
+
+	const VDStringW path(GetClaimPath(mClaimedJobId));
+
+	VDFile f;
+	ClaimRecord rec;
+	if (!f.openNT(path.c_str(), nsVDFile::kReadWrite | nsVDFile::kDenyNone | nsVDFile::kOpenExisting)
+		|| f.readData(&rec, sizeof rec) != sizeof rec
+		|| rec.mRunnerId != mClaimRecord.mRunnerId
+		|| rec.mClaimTick != mClaimRecord.mClaimTick)
+	{
+		// Another runner decided that our lease had expired and requeued or
+		// took over the job, so stop rendering it.
+		mClaimedJobId = 0;
+		mbClaimLost = true;
+
+		if (mpRunningJob && g_dubber)
+			g_dubber->Abort();
+		return;
+	}
+
+	++mClaimRecord.mHeartbeat;
+
+	if (f.seekNT(0))
+		f.writeData(&mClaimRecord, sizeof mClaimRecord);
+}
+
+bool VDJobQueue::IsLeaseExpired(uint64 id) {
+	// A missing claim file is treated like one that is never renewed.
+	ClaimRecord rec;
+	if (!VDReadJobClaimFile(GetClaimPath(id).c_str(), &rec, sizeof rec))
+		memset(&rec, 0, sizeof rec);
+
+	const uint32 t = VDGetCurrentTick();
+
+	LeaseObservations::insert_return_type r(mLeaseObservations.insert(id));
+	LeaseObservation& obs = r.first->second;
+
+	if (r.second || memcmp(&obs.mRecord, &rec, sizeof rec)) {
+		obs.mRecord = rec;
+		obs.mLastChangeTick = t;
+		return false;
+	}
+
+	return t - obs.mLastChangeTick >= kLeaseTimeout;
+}
+
+bool VDJobQueue::IsLeaseCheckNeeded(const VDJob *job) const {
+	const int state = job->GetState();
+
+	return (state == VDJob::kStateInProgress || state == VDJob::kStateAborting) && !IsLocal(job);
+}
+
+void VDJobQueue::RequeueExpiredJobs() {
+	for(JobQueue::const_iterator it(mJobQueue.begin()), itEnd(mJobQueue.end()); it != itEnd; ++it) {
+		VDJob *job = *it;
+
+		if (!IsLeaseCheckNeeded(job) || !IsLeaseExpired(job->mId) || !BreakExpiredClaim(job->mId))
+			continue;
+
+		// a job that was being aborted stays aborted
+		job->SetState(job->GetState() == VDJob::kStateAborting ? VDJob::kStateAborted : VDJob::kStateWaiting);
+		job->SetRunner(0, "");
+		job->Refresh();
+
+		++mExpiredLeaseCount;
+	}
+}
+
+void VDJobQueue::OnLeaseTimer() {
+	RenewLease();
+
+	// Nothing else makes us look at the queue when no runner is making any
+	// progress, so check the other runners' leases here and flush to requeue
+	// the jobs of any that have died.
+	for(JobQueue::const_iterator it(mJobQueue.begin()), itEnd(mJobQueue.end()); it != itEnd; ++it) {
+		VDJob *job = *it;
+
+		if (IsLeaseCheckNeeded(job) && IsLeaseExpired(job->mId)) {
+			SetModified();
+			break;
+		}
+	}
+}
+
+void VDJobQueue::GetClaimStats(VDJobQueueClaimStats& stats) const {
+	stats.mClaims = mClaimCount;
+	stats.mConflicts = mClaimConflictCount;
+	stats.mExpiredLeases = mExpiredLeaseCount;
+	stats.mClaimsPerSecond = 0;
+
+	const uint32 elapsed = VDGetCurrentTick() - mFirstClaimTick;
+	if (mFirstClaimTick && elapsed)
+		stats.mClaimsPerSecond = (float)mClaimCount * 1000.0f / (float)elapsed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void VDJobQueue::Reload(VDJob *job) {
 	// safety guard
 	if (mbRunning)
@@ -519,237 +824,324 @@ static void strgetarg2(VDStringA& str, const char *s) {
 	str.assign(buf.data(), buf.size());
 }
 
-void VDJobQueue::ListLoad(const wchar_t *fileName, bool merge) {
-	vdautoptr<VDJob> job;
+///////////////////////////////////////////////////////////////////////////////
 
-	// Try to create VirtualDub.jobs in the same directory as VirtualDub.
+namespace {
+	// Parses the $-commands embedded in job list comments. This is shared
+	// between the job list snapshot and the journal, which stores job records
+	// in the same format.
+	class VDJobListParser {
+	public:
+		enum Command {
+			kCommandNone,
+			kCommandSignature,
+			kCommandSnapshot,
+			kCommandEndJob,
+			kCommandDelete,
+			kCommandCommit
+		};
+
+		VDJobListParser(IVDJobQueue *queue, uint64 signature, uint32 revision);
+
+		Command ParseLine(const char *line);
+
+		VDJob *DetachJob() { return mpJob.release(); }
+
+		uint64 GetSignature() const { return mSignature; }
+		uint32 GetRevision() const { return mRevision; }
+		uint64 GetDeletedId() const { return mDeletedId; }
+
+	protected:
+		IVDJobQueue *mpJobQueue;
+		vdautoptr<VDJob> mpJob;
+		uint64	mSignature;
+		uint32	mRevision;
+		uint64	mDeletedId;
+		bool	mbScriptCapture;
+		bool	mbScriptReloadable;
+
+		vdfastvector<char> mScript;
+		vdfastvector<char> mLineBuffer;
+	};
+
+	VDJobListParser::VDJobListParser(IVDJobQueue *queue, uint64 signature, uint32 revision)
+		: mpJobQueue(queue)
+		, mSignature(signature)
+		, mRevision(revision)
+		, mDeletedId(0)
+		, mbScriptCapture(false)
+		, mbScriptReloadable(false)
+	{
+	}
 
-	bool usingGlobalFile = false;
-	if (!fileName) {
-		usingGlobalFile = true;
+	VDJobListParser::Command VDJobListParser::ParseLine(const char *line) {
+		mLineBuffer.assign(line, line+strlen(line)+1);
 
-		fileName = mJobFilePath.c_str();
-	}
+		char *s = mLineBuffer.data();
 
-	try {
-		VDFileStream fileStream(fileName);
+		// scan for a command
 
-		if (!Load(&fileStream, merge) || !merge) {
-			mbOrderModified = false;
-			mbModified = false;
-		}
-	} catch(const MyError& e) {
-		if (!usingGlobalFile)
-			throw MyError("Failure loading job list: %s.", e.c_str());
-	}
-}
+		if (s = findcmdline(mLineBuffer.data())) {
+			char *t = s;
 
-bool VDJobQueue::Load(IVDStream *stream, bool merge) {
-	JobQueue newJobs;
-	vdautoptr<VDJob> job;
+			while(isalpha((unsigned char)*t) || *t=='_') ++t;
 
-	bool modified = false;
-	try {
-		bool script_capture = false;
-		bool script_reloadable = false;
-		vdfastvector<char> script;
+			if (*t) *t++=0;
+			while(isspace((unsigned char)*t)) ++t;
 
-		uint64 newSignature		= mBaseSignature;
-		uint32 newRevision		= 1;
+			if (!_stricmp(s, "signature") || !_stricmp(s, "snapshot")) {
+				uint64 sig;
+				uint32 revision;
 
-		VDTextStream input(stream);
+				if (2 != sscanf(t, "%llx %x", &sig, &revision))
+					throw MyError("invalid signature");
 
-		vdfastvector<char> linebuffer;
+				mSignature = sig;
+				mRevision = revision;
 
-		for(;;) {
-			// read in the line
+				return _stricmp(s, "signature") ? kCommandSnapshot : kCommandSignature;
+			} else if (!_stricmp(s, "job")) {
+				mpJob = new_nothrow VDJob;
+				if (!mpJob) throw MyError("out of memory");
 
-			const char *line = input.GetNextLine();
-			if (!line)
-				break;
+				mpJob->mpJobQueue			= mpJobQueue;
+				mpJob->mCreationRevision	= mRevision;
+				mpJob->mChangeRevision		= mRevision;
 
-			linebuffer.assign(line, line+strlen(line)+1);
+				VDStringA name;
+				strgetarg(name, t);
+				mpJob->SetName(name.c_str());
 
-			char *s = linebuffer.data();
+			} else if (!_stricmp(s, "input")) {
 
-			// scan for a command
+				VDStringA inputFile;
+				strgetarg(inputFile, t);
+				mpJob->SetInputFile(inputFile.c_str());
 
-			if (s = findcmdline(linebuffer.data())) {
-				char *t = s;
+			} else if (!_stricmp(s, "output")) {
 
-				while(isalpha((unsigned char)*t) || *t=='_') ++t;
+				VDStringA outputFile;
+				strgetarg(outputFile, t);
+				mpJob->SetOutputFile(outputFile.c_str());
 
-				if (*t) *t++=0;
-				while(isspace((unsigned char)*t)) ++t;
+			} else if (!_stricmp(s, "error")) {
 
-				if (!_stricmp(s, "signature")) {
-					uint64 sig;
-					uint32 revision;
+				VDStringA error;
+				strgetarg2(error, t);
+				mpJob->SetError(error.c_str());
 
-					if (2 != sscanf(t, "%llx %x", &sig, &revision))
-						throw MyError("invalid signature");
+			} else if (!_stricmp(s, "state")) {
 
-					if (merge && sig == mLastSignature && revision == mLastRevision)
-						return false;
+				mpJob->SetState(atoi(t));
 
-					newSignature = sig;
-					newRevision = revision;
-				} else if (!_stricmp(s, "job")) {
-					job = new_nothrow VDJob;
-					if (!job) throw MyError("out of memory");
+			} else if (!_stricmp(s, "id")) {
 
-					job->mpJobQueue			= this;
-					job->mCreationRevision	= newRevision;
-					job->mChangeRevision	= newRevision;
+				uint64 id;
+				if (1 != sscanf(t, "%llx", &id))
+					throw MyError("invalid ID");
 
-					VDStringA name;
-					strgetarg(name, t);
-					job->SetName(name.c_str());
+				mpJob->mId = id;
 
-				} else if (!_stricmp(s, "input")) {
+			} else if (!_stricmp(s, "runner_id")) {
 
-					VDStringA inputFile;
-					strgetarg(inputFile, t);
-					job->SetInputFile(inputFile.c_str());
+				uint64 id;
+				if (1 != sscanf(t, "%llx", &id))
+					throw MyError("invalid runner ID");
 
-				} else if (!_stricmp(s, "output")) {
+				mpJob->mRunnerId = id;
 
-					VDStringA outputFile;
-					strgetarg(outputFile, t);
-					job->SetOutputFile(outputFile.c_str());
+			} else if (!_stricmp(s, "chunk")) {
 
-				} else if (!_stricmp(s, "error")) {
+				uint64 groupId;
+				int index, count;
 
-					VDStringA error;
-					strgetarg2(error, t);
-					job->SetError(error.c_str());
+				if (3 != sscanf(t, "%llx %d %d", &groupId, &index, &count) || index < 0 || count <= 0 || index > count)
+					throw MyError("invalid chunk");
 
-				} else if (!_stricmp(s, "state")) {
+				mpJob->mChunkGroupId = groupId;
+				mpJob->mChunkIndex = index;
+				mpJob->mChunkCount = count;
 
-					job->SetState(atoi(t));
+			} else if (!_stricmp(s, "runner_name")) {
 
-				} else if (!_stricmp(s, "id")) {
+				strgetarg2(mpJob->mRunnerName, t);
 
-					uint64 id;
-					if (1 != sscanf(t, "%llx", &id))
-						throw MyError("invalid ID");
+			} else if (!_stricmp(s, "revision")) {
 
-					job->mId = id;
+				uint32 createrev, changerev;
 
-				} else if (!_stricmp(s, "runner_id")) {
+				if (2 != sscanf(t, "%x %x", &createrev, &changerev))
+					throw MyError("invalid revisions");
 
-					uint64 id;
-					if (1 != sscanf(t, "%llx", &id))
-						throw MyError("invalid runner ID");
+				mpJob->mCreationRevision = createrev;
+				mpJob->mChangeRevision = changerev;
 
-					job->mRunnerId = id;
+			} else if (!_stricmp(s, "start_time")) {
+				uint32 lo, hi;
 
-				} else if (!_stricmp(s, "runner_name")) {
+				if (2 != sscanf(t, "%08lx %08lx", &hi, &lo))
+					throw MyError("invalid start time");
 
-					strgetarg2(job->mRunnerName, t);
+				mpJob->mDateStart = ((uint64)hi << 32) + lo;
+			} else if (!_stricmp(s, "end_time")) {
+				uint32 lo, hi;
 
-				} else if (!_stricmp(s, "revision")) {
+				if (2 != sscanf(t, "%08lx %08lx", &hi, &lo))
+					throw MyError("invalid start time");
 
-					uint32 createrev, changerev;
+				mpJob->mDateEnd = ((uint64)hi << 32) + lo;
 
-					if (2 != sscanf(t, "%x %x", &createrev, &changerev))
-						throw MyError("invalid revisions");
+			} else if (!_stricmp(s, "script")) {
 
-					job->mCreationRevision = createrev;
-					job->mChangeRevision = changerev;
+				mbScriptCapture = true;
+				mbScriptReloadable = false;
+				mScript.clear();
 
-				} else if (!_stricmp(s, "start_time")) {
-					uint32 lo, hi;
+			} else if (!_stricmp(s, "endjob")) {
+				if (mbScriptCapture) {
+					mpJob->SetScript(mScript.begin(), mScript.size(), mbScriptReloadable);
+					mbScriptCapture = false;
+				}
 
-					if (2 != sscanf(t, "%08lx %08lx", &hi, &lo))
-						throw MyError("invalid start time");
+				mpJob->SetModified(false);
+				return kCommandEndJob;
 
-					job->mDateStart = ((uint64)hi << 32) + lo;
-				} else if (!_stricmp(s, "end_time")) {
-					uint32 lo, hi;
+			} else if (!_stricmp(s, "logent")) {
 
-					if (2 != sscanf(t, "%08lx %08lx", &hi, &lo))
-						throw MyError("invalid start time");
+				int severity;
+				char dummyspace;
+				int pos;
 
-					job->mDateEnd = ((uint64)hi << 32) + lo;
+				if (2 != sscanf(t, "%d%c%n", &severity, &dummyspace, &pos))
+					throw MyError("invalid log entry");
 
-				} else if (!_stricmp(s, "script")) {
+				mpJob->mLogEntries.push_back(VDJob::tLogEntries::value_type(severity, VDTextAToW(t + pos, -1).c_str()));
 
-					script_capture = true;
-					script_reloadable = false;
-					script.clear();
+			} else if (!_stricmp(s, "delete")) {
 
-				} else if (!_stricmp(s, "endjob")) {
-					if (script_capture) {
-						job->SetScript(script.begin(), script.size(), script_reloadable);
-						script_capture = false;
-					}
+				uint64 id;
+				if (1 != sscanf(t, "%llx", &id))
+					throw MyError("invalid ID");
 
-					job->SetModified(false);
+				mDeletedId = id;
+				return kCommandDelete;
 
-					// Check if the job is running and if the process corresponds to the same machine as
-					// us. If so, check if the process is still running and if not, mark the job as aborted.
+			} else if (!_stricmp(s, "commit")) {
 
-					int state = job->GetState();
-					if (state == VDJob::kStateInProgress || state == VDJob::kStateAborting) {
-						if (job->mRunnerId && job->mRunnerId != mRunnerId) {
-							uint32 machineid = (uint32)(job->mRunnerId >> 32);
-							if (machineid == (uint32)(mRunnerId >> 32)) {
-								uint32 pid = (uint32)job->mRunnerId;
-								HANDLE hProcess = OpenProcess(SYNCHRONIZE, FALSE, pid);
+				uint32 revision;
+				if (1 != sscanf(t, "%x", &revision))
+					throw MyError("invalid revision");
 
-								bool processExists = false;
-								if (hProcess) {
-									if (WAIT_TIMEOUT == WaitForSingleObject(hProcess, 0))
-										processExists = true;
+				mRevision = revision;
+				return kCommandCommit;
+			}
+		} else if (mbScriptCapture) {
+			// kill starting spaces
 
-									CloseHandle(hProcess);
-								}
+			s = mLineBuffer.data();
 
-								if (!processExists)
-									job->SetState(VDJob::kStateAborted);
-							}
-						} else {
-							if (!mpRunningJob || mpRunningJob->mId != job->mId)
-								job->SetState(VDJob::kStateAborted);
-						}
-					}
+			while(isspace((unsigned char)*s)) ++s;
 
-					newJobs.push_back(job);
-					job.release();
+			// check for reload marker
+			if (s[0] == '/' && s[1] == '/' && strstr(s, "$reloadstop"))
+				mbScriptReloadable = true;
 
-				} else if (!_stricmp(s, "logent")) {
+			// don't add blank lines
 
-					int severity;
-					char dummyspace;
-					int pos;
+			if (*s) {
+				mScript.insert(mScript.end(), s, s+strlen(s));
+				mScript.push_back('\r');
+				mScript.push_back('\n');
+			}
+		}
 
-					if (2 != sscanf(t, "%d%c%n", &severity, &dummyspace, &pos))
-						throw MyError("invalid log entry");
+		return kCommandNone;
+	}
+}
 
-					job->mLogEntries.push_back(VDJob::tLogEntries::value_type(severity, VDTextAToW(t + pos, -1).c_str()));
-				}
-			} else if (script_capture) {
-				// kill starting spaces
+void VDJobQueue::ListLoad(const wchar_t *fileName, bool merge) {
+	vdautoptr<VDJob> job;
 
-				s = linebuffer.data();
+	// Try to create VirtualDub.jobs in the same directory as VirtualDub.
 
-				while(isspace((unsigned char)*s)) ++s;
+	bool usingGlobalFile = false;
+	if (!fileName) {
+		usingGlobalFile = true;
 
-				// check for reload marker
-				if (s[0] == '/' && s[1] == '/' && strstr(s, "$reloadstop"))
-					script_reloadable = true;
+		fileName = mJobFilePath.c_str();
+	}
 
-				// don't add blank lines
+	try {
+		VDFileStream fileStream(fileName);
 
-				if (*s) {
-					script.insert(script.end(), s, s+strlen(s));
-					script.push_back('\r');
-					script.push_back('\n');
-				}
+		bool modified = Load(&fileStream, merge);
+
+		// The snapshot stays open while the journal is read, which keeps other
+		// runners from appending to or compacting it underneath us.
+		if (usingGlobalFile && mbDistributedMode) {
+			const VDStringW& journalPath = GetJournalPath();
+
+			if (VDDoesPathExist(journalPath.c_str())) {
+				VDFileStream journalStream(journalPath.c_str());
+
+				if (LoadJournal(&journalStream))
+					modified = true;
+			}
+		}
+
+		if (!modified || !merge) {
+			mbOrderModified = false;
+			mbModified = false;
+		}
+	} catch(const MyError& e) {
+		if (!usingGlobalFile)
+			throw MyError("Failure loading job list: %s.", e.c_str());
+	}
+}
+
+bool VDJobQueue::Load(IVDStream *stream, bool merge) {
+	JobQueue newJobs;
+	vdautoptr<VDJob> job;
+
+	bool modified = false;
+	try {
+		VDJobListParser parser(this, mBaseSignature, 1);
+
+		VDTextStream input(stream);
+
+		for(;;) {
+			// read in the line
+
+			const char *line = input.GetNextLine();
+			if (!line)
+				break;
+
+			switch(parser.ParseLine(line)) {
+				case VDJobListParser::kCommandSignature:
+					// The snapshot only gets a new signature when it is rewritten; journal
+					// commits advance the revision past it without touching the snapshot.
+					if (merge && parser.GetSignature() == mLastSignature && parser.GetRevision() <= mLastRevision)
+						return false;
+					break;
+
+				case VDJobListParser::kCommandEndJob:
+					job = parser.DetachJob();
+
+					ValidateJobRunner(job);
+
+					newJobs.push_back(job);
+					job.release();
+					break;
 			}
 		}
 
+		const uint64 newSignature	= parser.GetSignature();
+		const uint32 newRevision	= parser.GetRevision();
+
+		// any journal position we had refers to the old snapshot
+		mJournalSignature = 0;
+		mJournalOffset = 0;
+
 		if (merge) {
 			// Merge the in-memory and on-disk job queues.
 			typedef stdext::hash_map<uint64, int> JobQueueLookup;
@@ -918,6 +1310,220 @@ bool VDJobQueue::Load(IVDStream *stream, bool merge) {
 	return modified;
 }
 
+// Check if the job is running and if the process corresponds to the same machine as
+// us. If so, check if the process is still running and if not, mark the job as aborted.
+void VDJobQueue::ValidateJobRunner(VDJob *job) {
+	int state = job->GetState();
+	if (state == VDJob::kStateInProgress || state == VDJob::kStateAborting) {
+		if (job->mRunnerId && job->mRunnerId != mRunnerId) {
+			uint32 machineid = (uint32)(job->mRunnerId >> 32);
+			if (machineid == (uint32)(mRunnerId >> 32)) {
+				uint32 pid = (uint32)job->mRunnerId;
+				HANDLE hProcess = OpenProcess(SYNCHRONIZE, FALSE, pid);
+
+				bool processExists = false;
+				if (hProcess) {
+					if (WAIT_TIMEOUT == WaitForSingleObject(hProcess, 0))
+						processExists = true;
+
+					CloseHandle(hProcess);
+				}
+
+				if (!processExists)
+					job->SetState(VDJob::kStateAborted);
+			}
+		} else {
+			if (!mpRunningJob || mpRunningJob->mId != job->mId)
+				job->SetState(VDJob::kStateAborted);
+		}
+	}
+}
+
+// VDJobQueue::LoadJournal()
+//
+// Applies the job records appended to the journal since we last read it.
+// The journal starts with a header naming the snapshot it applies to,
+// followed by batches of job records and deletions, each terminated by a
+// $commit line. Only committed batches are applied, so a batch left half
+// written by a runner that died while appending is ignored.
+
+bool VDJobQueue::LoadJournal(IVDRandomAccessStream *stream) {
+	const sint64 len = stream->Length();
+	sint64 pos = mJournalOffset;
+
+	// start over from the header if we haven't validated this journal yet
+	if (mJournalSignature != mLastSignature || pos > len) {
+		pos = 0;
+		mJournalSignature = 0;
+		mJournalOffset = 0;
+	}
+
+	if (len - pos > 0x7FFFFFFF)
+		throw MyError("job journal is too large");
+
+	vdfastvector<char> buf;
+	buf.resize((uint32)(len - pos));
+
+	if (!buf.empty()) {
+		stream->Seek(pos);
+		stream->Read(buf.data(), (sint32)buf.size());
+	}
+
+	VDJobListParser parser(this, mLastSignature, mLastRevision);
+	JobQueue batchJobs;
+	vdfastvector<uint64> batchDeletes;
+	vdfastvector<char> linebuffer;
+	bool modified = false;
+
+	try {
+		const char *s = buf.begin();
+		const char *end = buf.end();
+
+		while(s != end) {
+			const char *eol = (const char *)memchr(s, '\n', end - s);
+
+			// stop at an incomplete line -- it is part of an uncommitted batch
+			if (!eol)
+				break;
+
+			const char *next = eol + 1;
+
+			if (eol != s && eol[-1] == '\r')
+				--eol;
+
+			linebuffer.assign(s, eol);
+			linebuffer.push_back(0);
+			s = next;
+
+			const VDJobListParser::Command cmd = parser.ParseLine(linebuffer.data());
+
+			if (!mJournalSignature) {
+				if (cmd == VDJobListParser::kCommandNone)
+					continue;
+
+				// A journal for a different snapshot is left over from a compaction
+				// that didn't finish; ignore it until the next writer resets it.
+				if (cmd != VDJobListParser::kCommandSnapshot || parser.GetSignature() != mLastSignature)
+					break;
+
+				mJournalSignature = mLastSignature;
+				mJournalOffset = pos + (s - buf.begin());
+				continue;
+			}
+
+			switch(cmd) {
+				case VDJobListParser::kCommandEndJob:
+					{
+						vdautoptr<VDJob> job(parser.DetachJob());
+
+						batchJobs.push_back(job);
+						job.release();
+					}
+					break;
+
+				case VDJobListParser::kCommandDelete:
+					batchDeletes.push_back(parser.GetDeletedId());
+					break;
+
+				case VDJobListParser::kCommandCommit:
+					if (ApplyJournalBatch(batchJobs, batchDeletes, parser.GetRevision()))
+						modified = true;
+
+					batchDeletes.clear();
+					mJournalOffset = pos + (s - buf.begin());
+					break;
+			}
+		}
+	} catch(const MyError&) {
+		while(!batchJobs.empty()) {
+			delete batchJobs.back();
+			batchJobs.pop_back();
+		}
+
+		throw;
+	}
+
+	while(!batchJobs.empty()) {
+		delete batchJobs.back();
+		batchJobs.pop_back();
+	}
+
+	// check if the current job is now marked as Aborting -- if so, issue an abort
+	if (mpRunningJob && mpRunningJob->GetState() == VDJob::kStateAborting && g_dubber) {
+		g_dubber->Abort();
+	}
+
+	return modified;
+}
+
+// VDJobQueue::ApplyJournalBatch()
+//
+// Merges one committed journal batch into the in-memory queue. Ownership of
+// the jobs in the batch is taken and the batch is left empty.
+
+bool VDJobQueue::ApplyJournalBatch(JobQueue& jobs, const vdfastvector<uint64>& deletedIds, uint32 revision) {
+	bool modified = false;
+
+	// skip batches that we have already seen
+	if (revision > mLastRevision) {
+		for(JobQueue::iterator it(jobs.begin()), itEnd(jobs.end()); it != itEnd; ++it) {
+			VDJob *newJob = *it;
+
+			ValidateJobRunner(newJob);
+
+			VDJob *job = GetJobById(newJob->mId);
+			if (job) {
+				if (job->Merge(*newJob)) {
+					modified = true;
+					job->Refresh();
+				}
+			} else if (newJob->mCreationRevision > mLastRevision) {
+				// new job from another runner; a job that we already knew about and
+				// can't find was deleted here, and the deletion will go out on our
+				// next flush
+				mJobQueue.push_back(newJob);
+				++mJobCount;
+				*it = NULL;
+
+				if (g_pVDJobQueueStatusCallback)
+					g_pVDJobQueueStatusCallback->OnJobAdded(*newJob, mJobCount - 1);
+			}
+		}
+
+		for(vdfastvector<uint64>::const_iterator it(deletedIds.begin()), itEnd(deletedIds.end()); it != itEnd; ++it) {
+			VDJob *job = GetJobById(*it);
+
+			if (!job || job == mpRunningJob)
+				continue;
+
+			int index = ListFind(job);
+
+			if (g_pVDJobQueueStatusCallback)
+				g_pVDJobQueueStatusCallback->OnJobRemoved(*job, index);
+
+			mJobQueue.erase(mJobQueue.begin() + index);
+			--mJobCount;
+
+			job->mpJobQueue = NULL;
+			delete job;
+		}
+
+		mLastRevision = revision;
+	}
+
+	while(!jobs.empty()) {
+		VDJob *job = jobs.back();
+		jobs.pop_back();
+
+		if (job) {
+			job->mpJobQueue = NULL;
+			delete job;
+		}
+	}
+
+	return modified;
+}
+
 void VDJobQueue::SetModified() {
 	mbModified = true;
 
@@ -931,6 +1537,11 @@ void VDJobQueue::SetModified() {
 // We store the job list in a file called VirtualDub.jobs.  It's actually a
 // human-readable, human-editable Sylia script with extra comments to tell
 // VirtualDub about each of the scripts.
+//
+// In distributed mode, the job list is only a snapshot, and changes are
+// appended to a journal next to it as batches of job records. The snapshot
+// is only rewritten when the journal gets bigger than it, or when the job
+// order changes. The snapshot file doubles as the lock for both files.
 
 bool VDJobQueue::Flush(const wchar_t *fileName) {
 	// Try to create VirtualDub.jobs in the same directory as VirtualDub.
@@ -945,8 +1556,13 @@ bool VDJobQueue::Flush(const wchar_t *fileName) {
 	if (usingGlobalFile && mbDistributedMode) {
 		try {
 			VDFileStream outputStream(fileName, nsVDFile::kReadWrite | nsVDFile::kDenyAll | nsVDFile::kOpenAlways);
+			VDFileStream journalStream(GetJournalPath().c_str(), nsVDFile::kReadWrite | nsVDFile::kDenyWrite | nsVDFile::kOpenAlways);
 
+			// Catch up with the other runners. Unless the snapshot was compacted,
+			// this is just a signature check and a read of the journal tail.
 			Load(&outputStream, true);
+			LoadJournal(&journalStream);
+			RequeueExpiredJobs();
 
 			for(JobQueue::iterator it(mJobQueue.begin()), itEnd(mJobQueue.end()); it != itEnd; ++it) {
 				VDJob *job = *it;
@@ -959,18 +1575,48 @@ bool VDJobQueue::Flush(const wchar_t *fileName) {
 				}
 			}
 
-			uint64 signature = CreateListSignature();
-			outputStream.seek(0);
-			outputStream.truncate();
-
 			uint32 revision = mLastRevision + 1;
 
-			Save(&outputStream, signature, revision, false);
+			// The journal can't express a change in job order, and isn't usable at all
+			// if it doesn't match the snapshot.
+			bool compact = mbOrderModified || mJournalSignature != mLastSignature;
+
+			if (!compact) {
+				const sint64 journalSize = journalStream.Length();
+
+				compact = journalSize > kJournalCompactSize && journalSize > outputStream.Length();
+			}
+
+			if (compact) {
+				uint64 signature = CreateListSignature();
+				outputStream.seek(0);
+				outputStream.truncate();
+
+				Save(&outputStream, signature, revision, false);
+
+				journalStream.seek(0);
+				journalStream.truncate();
+
+				SaveJournalHeader(&journalStream, signature, revision);
+
+				mLastSignature = signature;
+				mLastRevision = revision;
+				mJournalSignature = signature;
+				mJournalOffset = journalStream.Length();
+				mDeletedJobIds.clear();
+			} else {
+				// drop any uncommitted batch left behind by a runner that died
+				journalStream.seek(mJournalOffset);
+				journalStream.truncate();
+
+				if (SaveJournal(&journalStream, revision)) {
+					mLastRevision = revision;
+					mJournalOffset = journalStream.Length();
+				}
+			}
 
 			mbModified = false;
 			mbOrderModified = false;
-			mLastSignature = signature;
-			mLastRevision = revision;
 
 			JobQueue::const_iterator it(mJobQueue.begin()), itEnd(mJobQueue.end());
 			for(; it != itEnd; ++it) {
@@ -994,6 +1640,7 @@ bool VDJobQueue::Flush(const wchar_t *fileName) {
 
 		mbModified = false;
 		mbOrderModified = false;
+		mDeletedJobIds.clear();
 	}
 
 	return true;
@@ -1012,79 +1659,130 @@ void VDJobQueue::Save(IVDStream *stream, uint64 signature, uint32 revision, bool
 
 	JobQueue::const_iterator it(mJobQueue.begin()), itEnd(mJobQueue.end());
 
-	for(; it != itEnd; ++it) {
-		VDJob *vdj = *it;
-		const int state = vdj->GetState();
+	for(; it != itEnd; ++it)
+		SaveJob(output, *it, revision, resetJobRevisions);
 
-		output.FormatLine("// $job \"%s\""		, vdj->GetName());
-		output.FormatLine("// $input \"%s\""	, vdj->GetInputFile());
-		output.FormatLine("// $output \"%s\""	, vdj->GetOutputFile());
-		output.FormatLine("// $state %d"		, state);
-		output.FormatLine("// $id %llx"			, vdj->mId);
+	output.PutLine("// $done");
 
-		if (!resetJobRevisions) {
-			if (vdj->IsModified())
-				vdj->mChangeRevision = revision;
+	output.Flush();
+}
 
-			output.FormatLine("// $revision %x %x", vdj->mCreationRevision ? vdj->mCreationRevision : revision, vdj->mChangeRevision);
-		}
+void VDJobQueue::SaveJob(VDTextOutputStream& output, VDJob *vdj, uint32 revision, bool resetJobRevisions) {
+	const int state = vdj->GetState();
 
-		if (state == VDJob::kStateInProgress || state == VDJob::kStateAborting || state == VDJob::kStateCompleted || state == VDJob::kStateError) {
-			output.FormatLine("// $runner_id %llx", vdj->mRunnerId);
-			output.FormatLine("// $runner_name \"%s\"", VDEncodeScriptString(VDStringSpanA(vdj->GetRunnerName())).c_str());
-		}
+	output.FormatLine("// $job \"%s\""		, vdj->GetName());
+	output.FormatLine("// $input \"%s\""	, vdj->GetInputFile());
+	output.FormatLine("// $output \"%s\""	, vdj->GetOutputFile());
+	output.FormatLine("// $state %d"		, state);
+	output.FormatLine("// $id %llx"			, vdj->mId);
 
-		output.FormatLine("// $start_time %08lx %08lx", (unsigned long)(vdj->mDateStart >> 32), (unsigned long)vdj->mDateStart);
-		output.FormatLine("// $end_time %08lx %08lx", (unsigned long)(vdj->mDateEnd >> 32), (unsigned long)vdj->mDateEnd);
+	if (vdj->IsChunk())
+		output.FormatLine("// $chunk %llx %d %d", vdj->mChunkGroupId, vdj->mChunkIndex, vdj->mChunkCount);
 
-		for(VDJob::tLogEntries::const_iterator it(vdj->mLogEntries.begin()), itEnd(vdj->mLogEntries.end()); it!=itEnd; ++it) {
-			const VDJob::tLogEntries::value_type& ent = *it;
-			output.FormatLine("// $logent %d %s", ent.severity, VDTextWToA(ent.text).c_str());
-		}
+	if (!resetJobRevisions) {
+		if (vdj->IsModified())
+			vdj->mChangeRevision = revision;
+
+		output.FormatLine("// $revision %x %x", vdj->mCreationRevision ? vdj->mCreationRevision : revision, vdj->mChangeRevision);
+	}
 
-		if (state == VDJob::kStateError)
-			output.FormatLine("// $error \"%s\"", VDEncodeScriptString(VDStringSpanA(vdj->GetError())).c_str());
+	if (state == VDJob::kStateInProgress || state == VDJob::kStateAborting || state == VDJob::kStateCompleted || state == VDJob::kStateError) {
+		output.FormatLine("// $runner_id %llx", vdj->mRunnerId);
+		output.FormatLine("// $runner_name \"%s\"", VDEncodeScriptString(VDStringSpanA(vdj->GetRunnerName())).c_str());
+	}
+
+	output.FormatLine("// $start_time %08lx %08lx", (unsigned long)(vdj->mDateStart >> 32), (unsigned long)vdj->mDateStart);
+	output.FormatLine("// $end_time %08lx %08lx", (unsigned long)(vdj->mDateEnd >> 32), (unsigned long)vdj->mDateEnd);
 
-		output.PutLine("// $script");
-		output.PutLine("");
+	for(VDJob::tLogEntries::const_iterator it(vdj->mLogEntries.begin()), itEnd(vdj->mLogEntries.end()); it!=itEnd; ++it) {
+		const VDJob::tLogEntries::value_type& ent = *it;
+		output.FormatLine("// $logent %d %s", ent.severity, VDTextWToA(ent.text).c_str());
+	}
 
-		// Dump script
+	if (state == VDJob::kStateError)
+		output.FormatLine("// $error \"%s\"", VDEncodeScriptString(VDStringSpanA(vdj->GetError())).c_str());
 
-		const char *s = vdj->GetScript();
+	output.PutLine("// $script");
+	output.PutLine("");
 
-		while(*s) {
-			const char *t = s;
-			char c;
+	// Dump script
 
-			while((c=*t) && c!='\r' && c!='\n')
-				++t;
+	const char *s = vdj->GetScript();
 
-			if (t>s)
-				output.Write(s, t-s);
+	while(*s) {
+		const char *t = s;
+		char c;
 
-			output.PutLine();
+		while((c=*t) && c!='\r' && c!='\n')
+			++t;
 
-			// handle CR, CR/LF, LF, and NUL terminators
+		if (t>s)
+			output.Write(s, t-s);
 
-			if (*t == '\r') ++t;
-			if (*t == '\n') ++t;
+		output.PutLine();
 
-			s=t;
-		}
+		// handle CR, CR/LF, LF, and NUL terminators
 
-		// Next...
+		if (*t == '\r') ++t;
+		if (*t == '\n') ++t;
 
-		output.PutLine("");
-		output.PutLine("// $endjob");
-		output.PutLine("//");
-		output.PutLine("//--------------------------------------------------");
+		s=t;
 	}
 
-	output.PutLine("// $done");
+	// Next...
+
+	output.PutLine("");
+	output.PutLine("// $endjob");
+	output.PutLine("//");
+	output.PutLine("//--------------------------------------------------");
+}
+
+void VDJobQueue::SaveJournalHeader(IVDStream *stream, uint64 signature, uint32 revision) {
+	VDTextOutputStream output(stream);
+
+	output.PutLine("// VirtualDub job list journal");
+	output.PutLine("// This is a program generated file -- edit at your own risk.");
+	output.PutLine("//");
+	output.FormatLine("// $snapshot %llx %x", signature, revision);
 
 	output.Flush();
 }
 
+// VDJobQueue::SaveJournal()
+//
+// Appends a batch with all jobs changed since the last flush, along with
+// any pending deletions. Returns false if there was nothing to write.
+
+bool VDJobQueue::SaveJournal(IVDStream *stream, uint32 revision) {
+	VDTextOutputStream output(stream);
+	bool changed = false;
+
+	JobQueue::const_iterator it(mJobQueue.begin()), itEnd(mJobQueue.end());
+	for(; it != itEnd; ++it) {
+		VDJob *vdj = *it;
+
+		if (vdj->IsModified() || !vdj->mCreationRevision) {
+			SaveJob(output, vdj, revision, false);
+			changed = true;
+		}
+	}
+
+	for(vdfastvector<uint64>::const_iterator itDel(mDeletedJobIds.begin()), itDelEnd(mDeletedJobIds.end()); itDel != itDelEnd; ++itDel) {
+		output.FormatLine("// $delete %llx", *itDel);
+		changed = true;
+	}
+
+	if (!changed)
+		return false;
+
+	// the batch only becomes visible once the commit line is complete
+	output.FormatLine("// $commit %x", revision);
+	output.Flush();
+
+	mDeletedJobIds.clear();
+	return true;
+}
+
 void VDJobQueue::RunAllStart() {
 	if (mbRunning || mbRunAll)
 		return;
@@ -1105,7 +1803,7 @@ bool VDJobQueue::RunAllNext() {
 	for(; it != itEnd; ++it) {
 		VDJob *testJob = *it;
 
-		if (testJob->GetState() == VDJob::kStateWaiting) {
+		if (IsJobReady(testJob)) {
 			mJobIdToRun = testJob->GetId();
 			return true;
 		}
@@ -1214,11 +1912,13 @@ void VDJobQueue::SetAutoUpdateEnabled(bool enabled) {
 	if (enabled) {
 		try {
 			mFileWatcher.Init(mJobFilePath.c_str(), this);
+			mJournalWatcher.Init(GetJournalPath().c_str(), this);
 		} catch(const MyError&) {
 			// for now, eat the error
 		}
 	} else {
 		mFileWatcher.Shutdown();
+		mJournalWatcher.Shutdown();
 	}
 }
 
@@ -1240,7 +1940,7 @@ bool VDJobQueue::PollAutoRun() {
 			return false;
 
 		VDJob *job = GetJobById(mJobIdToRun);
-		if (job && job->GetState() == VDJob::kStateWaiting) {
+		if (job && IsJobReady(job)) {
 			job->Run();
 			return true;
 		}
@@ -1258,7 +1958,7 @@ bool VDJobQueue::PollAutoRun() {
 	for(; it!=itEnd; ++it) {
 		VDJob *job = *it;
 
-		if (job->GetState() == VDJob::kStateWaiting) {
+		if (IsJobReady(job)) {
 			RunAllStart();
 			return true;
 		}
@@ -1335,6 +2035,23 @@ void VDJobQueue::TimerCallback() {
 		SetModified();
 }
 
+void VDJobQueue::RetryTimer::Defer() {
+	if (!mLastPeriod)
+		mLastPeriod = 100;
+	else {
+		mLastPeriod += mLastPeriod;
+		if (mLastPeriod > 1000)
+			mLastPeriod = 1000;
+	}
+
+	mbRetryOK = false;
+	mTimer.SetOneShot(this, mLastPeriod);
+}
+
 void VDJobQueue::RetryTimer::TimerCallback() {
 	mbRetryOK = true;
 }
+
+void VDJobQueue::LeaseTimer::TimerCallback() {
+	mpParent->OnLeaseTimer();
+}
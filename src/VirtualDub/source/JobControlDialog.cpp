@@ -857,9 +857,16 @@ void VDUIJobControlDialog::OnJobQueueStatusChanged(VDJobQueueStatus status) {
 	if (status == kVDJQS_Running)
 		title.append_sprintf(L" (%d remaining)", g_VDJobQueue.GetPendingJobCount());
 
-	if (g_VDJobQueue.IsAutoUpdateEnabled())
+	if (g_VDJobQueue.IsAutoUpdateEnabled()) {
 		title.append_sprintf(L" [%s] (%hs:%d)", g_VDJobQueue.GetJobFilePath(), g_VDJobQueue.GetRunnerName(), (uint32)g_VDJobQueue.GetRunnerId());
 
+		VDJobQueueClaimStats stats;
+		g_VDJobQueue.GetClaimStats(stats);
+
+		if (stats.mClaims || stats.mConflicts || stats.mExpiredLeases)
+			title.append_sprintf(L" - %u claimed (%.2f/sec), %u lost, %u requeued", stats.mClaims, stats.mClaimsPerSecond, stats.mConflicts, stats.mExpiredLeases);
+	}
+
 	switch(status) {
 		case kVDJQS_Idle:
 			EnableControl(IDC_START, true);
@@ -286,15 +286,43 @@ void OpenAVI(bool ext_opt) {
 
 ////////////////////////////////////
 
+static const char g_szRegKeySplitJobIntoChunks[]="Split job into chunks";
+static const char g_szRegKeyJobChunkCount[]="Job chunk count";
+
 void SaveAVI(HWND hWnd, bool fUseCompatibility, bool queueAsJob) {
 	if (!inputVideo) {
 		MessageBox(hWnd, "No input video stream to process.", g_szError, MB_OK);
 		return;
 	}
 
-	VDStringW fname(VDGetSaveFileName(VDFSPECKEY_SAVEVIDEOFILE, (VDGUIHandle)hWnd, fUseCompatibility ? L"Save AVI 1.0 File" : L"Save AVI 2.0 File", fileFilters0, L"avi"));
+	const wchar_t *title = fUseCompatibility ? L"Save AVI 1.0 File" : L"Save AVI 2.0 File";
+
+	if (!queueAsJob) {
+		VDStringW fname(VDGetSaveFileName(VDFSPECKEY_SAVEVIDEOFILE, (VDGUIHandle)hWnd, title, fileFilters0, L"avi"));
+		if (!fname.empty()) {
+			g_project->SaveAVI(fname.c_str(), fUseCompatibility, false);
+		}
+		return;
+	}
+
+	static const VDFileDialogOption sOptions[]={
+		{ VDFileDialogOption::kEnabledInt, 0, L"&Split into chunks for job runners (2-999):", 2, 999 },
+		{0}
+	};
+
+	VDRegistryAppKey key(g_szRegKeyPersistence);
+	int optVals[2]={
+		key.getBool(g_szRegKeySplitJobIntoChunks, false),
+		key.getInt(g_szRegKeyJobChunkCount, 4),
+	};
+
+	VDStringW fname(VDGetSaveFileName(VDFSPECKEY_SAVEVIDEOFILE, (VDGUIHandle)hWnd, title, fileFilters0, L"avi", sOptions, optVals));
 	if (!fname.empty()) {
-		g_project->SaveAVI(fname.c_str(), fUseCompatibility, queueAsJob);
+		key.setBool(g_szRegKeySplitJobIntoChunks, !!optVals[0]);
+		if (optVals[0])
+			key.setInt(g_szRegKeyJobChunkCount, optVals[1]);
+
+		g_project->SaveAVI(fname.c_str(), fUseCompatibility, true, optVals[0] ? optVals[1] : 0);
 	}
 }
 
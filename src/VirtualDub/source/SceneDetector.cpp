@@ -20,6 +20,7 @@
 #include <vd2/system/error.h>
 #include <vd2/Kasumi/pixel.h>
 #include <vd2/Kasumi/pixmap.h>
+#include <vd2/Kasumi/pixmapops.h>
 #include <vd2/Kasumi/pixmaputils.h>
 
 #include "SceneDetector.h"
@@ -468,6 +469,37 @@ namespace {
 #endif
 
 void SceneDetector::BitmapToLummap(uint32 *lummap, const VDPixmap& pxsrc) {
+	// The tile sums only use 8-bit precision, so high bit depth frames are
+	// narrowed to the matching 8-bit format first.
+	int narrowFormat = nsVDPixmap::kPixFormat_Null;
+
+	switch(pxsrc.format) {
+		case nsVDPixmap::kPixFormat_XRGB64:
+			narrowFormat = nsVDPixmap::kPixFormat_XRGB8888;
+			break;
+
+		case nsVDPixmap::kPixFormat_YUV444_Planar16:
+			narrowFormat = nsVDPixmap::kPixFormat_YUV444_Planar;
+			break;
+
+		case nsVDPixmap::kPixFormat_YUV422_Planar16:
+			narrowFormat = nsVDPixmap::kPixFormat_YUV422_Planar;
+			break;
+
+		case nsVDPixmap::kPixFormat_YUV420_Planar16:
+		case nsVDPixmap::kPixFormat_YUV420_P010:
+		case nsVDPixmap::kPixFormat_YUV420_P016:
+			narrowFormat = nsVDPixmap::kPixFormat_YUV420_Planar;
+			break;
+	}
+
+	if (narrowFormat) {
+		mNarrowBuffer.init(pxsrc.w, pxsrc.h, narrowFormat);
+		VDPixmapBlt(mNarrowBuffer, pxsrc);
+		BitmapToLummap(lummap, mNarrowBuffer);
+		return;
+	}
+
 	int mh = 8;
 	uint32 w, h;
 
@@ -581,7 +613,7 @@ void SceneDetector::BitmapToLummap(uint32 *lummap, const VDPixmap& pxsrc) {
 					break;
 
 				default:
-					VDASSERTCT(nsVDPixmap::kPixFormat_Max_Standard == nsVDPixmap::kPixFormat_YUV420ib_Planar_709_FR + 1);
+					VDASSERTCT(nsVDPixmap::kPixFormat_Max_Standard == nsVDPixmap::kPixFormat_YUV420_P016 + 1);
 					VDASSERT(false);
 			}
 		} while(--h);
@@ -6,17 +6,18 @@
 #include <vd2/system/vdstl.h>
 #include <vd2/system/error.h>
 #include <vd2/system/filesys.h>
+#include <vd2/system/thread.h>
 #include <vd2/system/vdalloc.h>
 #include <vd2/Dita/resources.h>
 #include <vd2/Meia/decode_png.h>
 #include <vd2/Kasumi/pixmapops.h>
+#include <vd2/Riza/bitmap.h>
 #include "ProgressDialog.h"
 #include "InputFileImages.h"
 #include "VideoSourceImages.h"
 #include "image.h"
 #include "imagejpegdec.h"
 #include "imageiff.h"
-#include "VBitmap.h"
 
 ///////////////////////////////////////////////////////////////////////////
 
@@ -24,6 +25,155 @@ namespace {
 	enum { kVDST_PNGDecodeErrors = 100 };
 }
 
+///////////////////////////////////////////////////////////////////////////
+//
+//	VideoSourceImagesDecoder
+//
+//	Identifies and decodes a single still. Each decoding thread has its
+//	own instance, since the format decoders keep per-image state.
+//
+///////////////////////////////////////////////////////////////////////////
+
+class VideoSourceImagesDecoder {
+public:
+	VideoSourceImagesDecoder(VDInputFileImages *parent);
+
+	void Begin(const void *src, uint32 len, VDPosition frame, int& w, int& h);
+	void Decode(const VDPixmap& dst);
+
+protected:
+	enum ImageType {
+		kTypePNG,
+		kTypeJPEG,
+		kTypeBMP,
+		kTypeIFF,
+		kTypeTGA
+	};
+
+	VDInputFileImages *mpParent;
+	const void	*mpSrc;
+	uint32		mSrcLen;
+	VDPosition	mFrame;
+	ImageType	mType;
+	VDPixmap	mIFFFrame;
+
+	vdautoptr<IVDJPEGDecoder> mpJPEGDecoder;
+	vdautoptr<IVDImageDecoderIFF> mpIFFDecoder;
+	vdautoptr<IVDImageDecoderPNG> mpPNGDecoder;
+};
+
+VideoSourceImagesDecoder::VideoSourceImagesDecoder(VDInputFileImages *parent)
+	: mpParent(parent)
+	, mpSrc(NULL)
+	, mSrcLen(0)
+	, mFrame(-1)
+	, mType(kTypePNG)
+{
+}
+
+void VideoSourceImagesDecoder::Begin(const void *src, uint32 len, VDPosition frame, int& w, int& h) {
+	bool bHasAlpha;
+
+	mpSrc = src;
+	mSrcLen = len;
+	mFrame = frame;
+
+	if (VDDecodePNGHeader(src, len, w, h, bHasAlpha))
+		mType = kTypePNG;
+	else if (VDIsJPEGHeader(src, len))
+		mType = kTypeJPEG;
+	else if (DecodeBMPHeader(src, len, w, h, bHasAlpha))
+		mType = kTypeBMP;
+	else if (VDIsMayaIFFHeader(src, len))
+		mType = kTypeIFF;
+	else if (DecodeTGAHeader(src, len, w, h, bHasAlpha))
+		mType = kTypeTGA;
+	else
+		throw MyError("Image file must be in PNG, Windows BMP, truecolor TARGA format, MayaIFF, or sequential JPEG format.");
+
+	if (mType == kTypeJPEG) {
+		if (!mpJPEGDecoder)
+			mpJPEGDecoder = VDCreateJPEGDecoder();
+		mpJPEGDecoder->Begin(src, len);
+		mpJPEGDecoder->DecodeHeader(w, h);
+	}
+
+	if (mType == kTypeIFF) {
+		if (!mpIFFDecoder)
+			mpIFFDecoder = VDCreateImageDecoderIFF();
+		mIFFFrame = mpIFFDecoder->Decode(src, len);
+		w = mIFFFrame.w;
+		h = mIFFFrame.h;
+	}
+}
+
+void VideoSourceImagesDecoder::Decode(const VDPixmap& dst) {
+	switch(mType) {
+	case kTypeJPEG:
+		{
+			int format;
+
+			switch(dst.format) {
+			case nsVDPixmap::kPixFormat_XRGB1555:	format = IVDJPEGDecoder::kFormatXRGB1555;	break;
+			case nsVDPixmap::kPixFormat_RGB888:		format = IVDJPEGDecoder::kFormatRGB888;		break;
+			case nsVDPixmap::kPixFormat_XRGB8888:	format = IVDJPEGDecoder::kFormatXRGB8888;	break;
+			}
+
+			mpJPEGDecoder->DecodeImage(dst.data, dst.pitch, format);
+			mpJPEGDecoder->End();
+		}
+		break;
+
+	case kTypeIFF:
+		VDPixmapBlt(dst, mIFFFrame);
+		break;
+
+	case kTypeBMP:
+		DecodeBMP(mpSrc, mSrcLen, dst);
+		break;
+
+	case kTypeTGA:
+		DecodeTGA(mpSrc, mSrcLen, dst);
+		break;
+
+	case kTypePNG:
+		{
+			if (!mpPNGDecoder)
+				mpPNGDecoder = VDCreateImageDecoderPNG();
+
+			PNGDecodeError err = mpPNGDecoder->Decode(mpSrc, mSrcLen);
+
+			if (err) {
+				if (err == kPNGDecodeOutOfMemory)
+					throw MyMemoryError();
+
+				vdfastvector<wchar_t> errBuf;
+
+				throw MyError("Error decoding \"%ls\": %ls\n", mpParent->ComputeFilename(errBuf, mFrame), VDLoadString(0, kVDST_PNGDecodeErrors, err));
+			}
+
+			VDPixmapBlt(dst, mpPNGDecoder->GetFrameBuffer());
+		}
+		break;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+class VideoSourceImages;
+
+class VideoSourceImagesDecodeWorker : public VDThread {
+public:
+	VideoSourceImagesDecodeWorker();
+
+	void Init(VideoSourceImages *parent);
+
+protected:
+	void ThreadRun();
+
+	VideoSourceImages *mpParent;
+};
+
 ///////////////////////////////////////////////////////////////////////////
 
 class VideoSourceImages : public VideoSource {
@@ -53,19 +203,68 @@ public:
 	bool isType1()							{ return false; }
 	bool isDecodable(VDPosition sample_num)		{ return true; }
 
+	void RunDecodeWorker();
+
 private:
+	enum {
+		kMaxDecodeThreads		= 8,
+		kReadAheadPerThread		= 4,			// frames queued ahead of the request per decoding thread
+		kMaxDecodedFrames		= 256,
+		kDecodedFrameBudget		= 128 << 20		// bytes of decoded frames kept, including frames being decoded
+	};
+
+	enum DecodedFrameState {
+		kStateQueued,
+		kStateDecoding,
+		kStateReady,
+		kStateFailed
+	};
+
+	struct DecodedFrame {
+		VDPosition			mFrame;
+		DecodedFrameState	mState;
+		uint32				mLastUse;
+		vdblock<char>		mData;
+	};
+
+	typedef vdfastvector<DecodedFrame *> DecodedFrames;
+
+	bool FetchDecodedFrame(VDPosition frame);
+	void QueueReadAhead(VDPosition frame);
+	DecodedFrame *AllocDecodedFrame(VDPosition frame, VDPosition windowStart, VDPosition windowEnd);
+	DecodedFrame *FindDecodedFrame(VDPosition frame);
+	void FreeDecodedFrame(DecodedFrame *df);
+	void FlushDecodedFrames();
+	void StartDecodeWorkers();
+	void ShutdownDecodeWorkers();
+
 	vdrefptr<VDInputFileImages> mpParent;
 	vdfastvector<wchar_t> mPathBuf;
 
 	VDPosition	mCachedFrame;
-	VBitmap	mvbFrameBuffer;
 
 	VDPosition	mCachedHandleFrame;
 	VDFile	mCachedFile;
 
-	vdautoptr<IVDJPEGDecoder> mpJPEGDecoder;
-	vdautoptr<IVDImageDecoderIFF> mpIFFDecoder;
-	vdautoptr<IVDImageDecoderPNG> mpPNGDecoder;
+	VideoSourceImagesDecoder mDecoder;
+
+	// decode-ahead
+	VDPixmapLayout	mFrameLayout;
+	uint32		mFrameSize;					// zero until a target format is set
+	uint32		mReadAheadFrames;			// zero if decode-ahead is disabled
+	uint32		mDecodeThreadCount;
+	VDPosition	mLastRequestedFrame;
+	int			mReadDirection;
+	uint32		mUseCounter;
+
+	VDCriticalSection	mDecodeLock;
+	VDSemaphore			mDecodeRequests;
+	VDSignal			mDecodeComplete;
+	DecodedFrames		mDecodedFrames;			// all cache entries
+	DecodedFrames		mDecodeQueue;			// queued entries, nearest first
+	bool				mbDecodeWorkersQuit;
+
+	vdfastvector<VideoSourceImagesDecodeWorker *> mDecodeWorkers;
 };
 
 IVDVideoSource *VDCreateVideoSourceImages(VDInputFileImages *parent) {
@@ -74,9 +273,34 @@ IVDVideoSource *VDCreateVideoSourceImages(VDInputFileImages *parent) {
 
 ///////////////////////////////////////////////////////////////////////////
 
+VideoSourceImagesDecodeWorker::VideoSourceImagesDecodeWorker()
+	: VDThread("Image sequence decoder")
+	, mpParent(NULL)
+{
+}
+
+void VideoSourceImagesDecodeWorker::Init(VideoSourceImages *parent) {
+	mpParent = parent;
+}
+
+void VideoSourceImagesDecodeWorker::ThreadRun() {
+	mpParent->RunDecodeWorker();
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 VideoSourceImages::VideoSourceImages(VDInputFileImages *parent)
 	: mpParent(parent)
 	, mCachedHandleFrame(-1)
+	, mDecoder(parent)
+	, mFrameSize(0)
+	, mReadAheadFrames(0)
+	, mDecodeThreadCount(std::min<uint32>(VDGetLogicalProcessorCount(), kMaxDecodeThreads))
+	, mLastRequestedFrame(-1)
+	, mReadDirection(+1)
+	, mUseCounter(0)
+	, mDecodeRequests(0)
+	, mbDecodeWorkersQuit(false)
 {
 	mSampleFirst = 0;
 
@@ -115,6 +339,8 @@ VideoSourceImages::VideoSourceImages(VDInputFileImages *parent)
 }
 
 VideoSourceImages::~VideoSourceImages() {
+	ShutdownDecodeWorkers();
+	FlushDecodedFrames();
 }
 
 int VideoSourceImages::_read(VDPosition lStart, uint32 lCount, void *lpBuffer, uint32 cbBuffer, uint32 *plBytesRead, uint32 *plSamplesRead) {
@@ -185,8 +411,22 @@ bool VideoSourceImages::setTargetFormat(int format) {
 
 		invalidateFrameBuffer();
 
-		mvbFrameBuffer.init((void *)getFrameBuffer(), mpTargetFormatHeader->biWidth, mpTargetFormatHeader->biHeight, mpTargetFormatHeader->biBitCount);
-		mvbFrameBuffer.AlignTo4();
+		// Decoded frames are stored in the layout of the frame buffer, so
+		// changing the format invalidates all of them.
+		FlushDecodedFrames();
+
+		vdsynchronized(mDecodeLock) {
+			const VDAVIBitmapInfoHeader *bih = getImageFormat();
+
+			mFrameSize = VDMakeBitmapCompatiblePixmapLayout(mFrameLayout, bih->biWidth, bih->biHeight, format, 0);
+
+			// Leave room in the budget for frames that have already been viewed.
+			const uint32 framesInBudget = std::min<uint32>(kDecodedFrameBudget / mFrameSize, kMaxDecodedFrames);
+
+			mReadAheadFrames = std::min<uint32>(mDecodeThreadCount * kReadAheadPerThread, framesInBudget / 2);
+			mLastRequestedFrame = -1;
+			mReadDirection = +1;
+		}
 
 		return true;
 	}
@@ -202,46 +442,23 @@ const void *VideoSourceImages::streamGetFrame(const void *inputBuffer, uint32 da
 	if (!data_len)
 		return getFrameBuffer();
 
-	int w, h;
-	bool bHasAlpha;
+	// Queue the read-ahead before decoding on this thread, so that the
+	// decoding threads are already busy with the following frames.
 
-	bool bIsPNG = false;
-	bool bIsJPG = false;
-	bool bIsBMP = false;
-	bool bIsIFF = false;
-	bool bIsTGA = false;
-
-	bIsPNG = VDDecodePNGHeader(inputBuffer, data_len, w, h, bHasAlpha);
-	if (!bIsPNG) {
-		bIsJPG = VDIsJPEGHeader(inputBuffer, data_len);
-		if (!bIsJPG) {
-			bIsBMP = DecodeBMPHeader(inputBuffer, data_len, w, h, bHasAlpha);
-			if (!bIsBMP) {
-				bIsIFF = VDIsMayaIFFHeader(inputBuffer, data_len);
-				if (!bIsIFF)
-					bIsTGA = DecodeTGAHeader(inputBuffer, data_len, w, h, bHasAlpha);
-			}
-		}
-	}
+	if (mFrameSize) {
+		bool decoded = FetchDecodedFrame(frame_num);
 
-	if (!bIsBMP && !bIsTGA && !bIsJPG && !bIsPNG && !bIsIFF)
-		throw MyError("Image file must be in PNG, Windows BMP, truecolor TARGA format, MayaIFF, or sequential JPEG format.");
+		QueueReadAhead(frame_num);
 
-	if (bIsJPG) {
-		if (!mpJPEGDecoder)
-			mpJPEGDecoder = VDCreateJPEGDecoder();
-		mpJPEGDecoder->Begin(inputBuffer, data_len);
-		mpJPEGDecoder->DecodeHeader(w, h);
+		if (decoded) {
+			mCachedFrame = frame_num;
+			return mpFrameBuffer;
+		}
 	}
 
-	VDPixmap pxIFF;
-	if (bIsIFF) {
-		if (!mpIFFDecoder)
-			mpIFFDecoder = VDCreateImageDecoderIFF();
-		pxIFF = mpIFFDecoder->Decode(inputBuffer, data_len);
-		w = pxIFF.w;
-		h = pxIFF.h;
-	}
+	int w, h;
+
+	mDecoder.Begin(inputBuffer, data_len, frame_num, w, h);
 
 	// Check image header.
 
@@ -276,43 +493,7 @@ const void *VideoSourceImages::streamGetFrame(const void *inputBuffer, uint32 da
 		return NULL;
 	}
 
-	if (bIsJPG) {
-		int format;
-
-		switch(mvbFrameBuffer.depth) {
-		case 16:	format = IVDJPEGDecoder::kFormatXRGB1555;	break;
-		case 24:	format = IVDJPEGDecoder::kFormatRGB888;		break;
-		case 32:	format = IVDJPEGDecoder::kFormatXRGB8888;	break;
-		}
-
-		mpJPEGDecoder->DecodeImage((char *)mvbFrameBuffer.data + mvbFrameBuffer.pitch * (mvbFrameBuffer.h - 1), -mvbFrameBuffer.pitch, format);
-		mpJPEGDecoder->End();
-	}
-
-	if (bIsIFF)
-		VDPixmapBlt(getTargetFormat(), pxIFF);
-
-	if (bIsBMP)
-		DecodeBMP(inputBuffer, data_len, VDAsPixmap(mvbFrameBuffer));
-	if (bIsTGA)
-		DecodeTGA(inputBuffer, data_len, VDAsPixmap(mvbFrameBuffer));
-	if (bIsPNG) {
-		if (!mpPNGDecoder)
-			mpPNGDecoder = VDCreateImageDecoderPNG();
-
-		PNGDecodeError err = mpPNGDecoder->Decode(inputBuffer, data_len);
-
-		if (err) {
-			if (err == kPNGDecodeOutOfMemory)
-				throw MyMemoryError();
-
-			vdfastvector<wchar_t> errBuf;
-
-			throw MyError("Error decoding \"%ls\": %ls\n", mpParent->ComputeFilename(errBuf, frame_num), VDLoadString(0, kVDST_PNGDecodeErrors, err));
-		}
-
-		VDPixmapBlt(VDAsPixmap(mvbFrameBuffer), mpPNGDecoder->GetFrameBuffer());
-	}
+	mDecoder.Decode(getTargetFormat());
 
 	mCachedFrame = frame_num;
 
@@ -326,6 +507,15 @@ const void *VideoSourceImages::getFrame(VDPosition frameNum) {
 	if (mCachedFrame == frameNum)
 		return mpFrameBuffer;
 
+	// Skip reading the file if the frame has already been decoded ahead.
+
+	if (mFrameSize && FetchDecodedFrame(frameNum)) {
+		QueueReadAhead(frameNum);
+
+		mCachedFrame = frameNum;
+		return mpFrameBuffer;
+	}
+
 	if (!read(frameNum, 1, NULL, 0x7FFFFFFF, &lBytes, NULL) && lBytes) {
 		char *pBuffer = new char[lBytes];
 
@@ -344,3 +534,306 @@ const void *VideoSourceImages::getFrame(VDPosition frameNum) {
 
 	return pFrame;
 }
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Decode-ahead
+//
+//	Stills don't depend on each other, so the frames following the last
+//	request in the direction of travel are decoded on worker threads. Each
+//	worker reads its own files, so file reads overlap with decoding on the
+//	other workers. Decoded frames are kept in the frame buffer layout under
+//	a byte budget and are evicted least recently used first, except for
+//	the frames in the read-ahead window.
+//
+//	A frame that fails to decode on a worker is dropped, and the request
+//	thread decodes it again to report the error.
+//
+///////////////////////////////////////////////////////////////////////////
+
+bool VideoSourceImages::FetchDecodedFrame(VDPosition frame) {
+	bool found = false;
+
+	mDecodeLock.Lock();
+
+	for(;;) {
+		DecodedFrame *df = FindDecodedFrame(frame);
+
+		if (!df)
+			break;
+
+		if (df->mState == kStateDecoding) {
+			mDecodeLock.Unlock();
+			mDecodeComplete.wait();
+			mDecodeLock.Lock();
+			continue;
+		}
+
+		if (df->mState == kStateReady) {
+			memcpy(mpFrameBuffer, df->mData.data(), mFrameSize);
+			df->mLastUse = ++mUseCounter;
+			found = true;
+		} else {
+			// Not started yet, or failed; the caller decodes it now.
+			FreeDecodedFrame(df);
+		}
+
+		break;
+	}
+
+	mDecodeLock.Unlock();
+
+	return found;
+}
+
+void VideoSourceImages::QueueReadAhead(VDPosition frame) {
+	if (frame > mLastRequestedFrame)
+		mReadDirection = +1;
+	else if (frame < mLastRequestedFrame)
+		mReadDirection = -1;
+
+	mLastRequestedFrame = frame;
+
+	if (!mReadAheadFrames)
+		return;
+
+	if (mDecodeWorkers.empty()) {
+		StartDecodeWorkers();
+
+		if (mDecodeWorkers.empty())
+			return;
+	}
+
+	VDPosition windowStart;
+	VDPosition windowEnd;
+
+	if (mReadDirection > 0) {
+		windowStart = frame + 1;
+		windowEnd = std::min<VDPosition>(windowStart + mReadAheadFrames, mSampleLast);
+	} else {
+		windowEnd = frame;
+		windowStart = std::max<VDPosition>(windowEnd - mReadAheadFrames, 0);
+	}
+
+	uint32 newRequests = 0;
+
+	vdsynchronized(mDecodeLock) {
+		// Frames left over from a previous window that haven't been started
+		// are abandoned, so that scrubbing doesn't build up a backlog.
+		while(!mDecodeQueue.empty()) {
+			DecodedFrame *df = mDecodeQueue.back();
+
+			if (df->mFrame < windowStart || df->mFrame >= windowEnd)
+				FreeDecodedFrame(df);
+			else
+				mDecodeQueue.pop_back();
+		}
+
+		for(VDPosition i = 0, n = windowEnd - windowStart; i < n; ++i) {
+			const VDPosition pos = mReadDirection > 0 ? windowStart + i : windowEnd - 1 - i;
+			DecodedFrame *df = FindDecodedFrame(pos);
+
+			if (!df) {
+				df = AllocDecodedFrame(pos, windowStart, windowEnd);
+				if (!df)
+					continue;
+
+				++newRequests;
+			}
+
+			if (df->mState == kStateQueued)
+				mDecodeQueue.push_back(df);
+		}
+	}
+
+	// Queue entries that were dropped above leave extra counts in the
+	// semaphore; the workers just find an empty queue for those.
+	while(newRequests--)
+		mDecodeRequests.Post();
+}
+
+VideoSourceImages::DecodedFrame *VideoSourceImages::AllocDecodedFrame(VDPosition frame, VDPosition windowStart, VDPosition windowEnd) {
+	DecodedFrame *df = NULL;
+
+	if (mDecodedFrames.size() >= kMaxDecodedFrames || (mDecodedFrames.size() + 1) * (uint64)mFrameSize > kDecodedFrameBudget) {
+		// Reuse the least recently used decoded frame outside of the window.
+		DecodedFrames::iterator itVictim(mDecodedFrames.end());
+
+		for(DecodedFrames::iterator it(mDecodedFrames.begin()), itEnd(mDecodedFrames.end()); it != itEnd; ++it) {
+			DecodedFrame *cand = *it;
+
+			if (cand->mState != kStateReady && cand->mState != kStateFailed)
+				continue;
+
+			if (cand->mFrame >= windowStart && cand->mFrame < windowEnd)
+				continue;
+
+			if (itVictim == mDecodedFrames.end() || (sint32)(cand->mLastUse - (*itVictim)->mLastUse) < 0)
+				itVictim = it;
+		}
+
+		if (itVictim == mDecodedFrames.end())
+			return NULL;
+
+		df = *itVictim;
+	} else {
+		df = new DecodedFrame;
+		df->mData.resize(mFrameSize);
+		mDecodedFrames.push_back(df);
+	}
+
+	df->mFrame = frame;
+	df->mState = kStateQueued;
+	df->mLastUse = mUseCounter;
+
+	return df;
+}
+
+VideoSourceImages::DecodedFrame *VideoSourceImages::FindDecodedFrame(VDPosition frame) {
+	for(DecodedFrames::const_iterator it(mDecodedFrames.begin()), itEnd(mDecodedFrames.end()); it != itEnd; ++it) {
+		DecodedFrame *df = *it;
+
+		if (df->mFrame == frame)
+			return df;
+	}
+
+	return NULL;
+}
+
+void VideoSourceImages::FreeDecodedFrame(DecodedFrame *df) {
+	DecodedFrames::iterator it(std::find(mDecodeQueue.begin(), mDecodeQueue.end(), df));
+	if (it != mDecodeQueue.end())
+		mDecodeQueue.erase(it);
+
+	it = std::find(mDecodedFrames.begin(), mDecodedFrames.end(), df);
+	if (it != mDecodedFrames.end())
+		mDecodedFrames.erase(it);
+
+	delete df;
+}
+
+void VideoSourceImages::FlushDecodedFrames() {
+	mDecodeLock.Lock();
+
+	mDecodeQueue.clear();
+
+	for(;;) {
+		bool decoding = false;
+
+		for(DecodedFrames::const_iterator it(mDecodedFrames.begin()), itEnd(mDecodedFrames.end()); it != itEnd; ++it) {
+			if ((*it)->mState == kStateDecoding) {
+				decoding = true;
+				break;
+			}
+		}
+
+		if (!decoding)
+			break;
+
+		mDecodeLock.Unlock();
+		mDecodeComplete.wait();
+		mDecodeLock.Lock();
+	}
+
+	while(!mDecodedFrames.empty()) {
+		delete mDecodedFrames.back();
+		mDecodedFrames.pop_back();
+	}
+
+	mDecodeLock.Unlock();
+}
+
+void VideoSourceImages::StartDecodeWorkers() {
+	mbDecodeWorkersQuit = false;
+
+	for(uint32 i=0; i<mDecodeThreadCount; ++i) {
+		vdautoptr<VideoSourceImagesDecodeWorker> worker(new VideoSourceImagesDecodeWorker);
+
+		worker->Init(this);
+		if (!worker->ThreadStart())
+			break;
+
+		mDecodeWorkers.push_back(worker.release());
+	}
+}
+
+void VideoSourceImages::ShutdownDecodeWorkers() {
+	vdsynchronized(mDecodeLock) {
+		mbDecodeWorkersQuit = true;
+	}
+
+	for(uint32 i=0, n=(uint32)mDecodeWorkers.size(); i<n; ++i)
+		mDecodeRequests.Post();
+
+	while(!mDecodeWorkers.empty()) {
+		VideoSourceImagesDecodeWorker *worker = mDecodeWorkers.back();
+		mDecodeWorkers.pop_back();
+
+		worker->ThreadWait();
+		delete worker;
+	}
+}
+
+void VideoSourceImages::RunDecodeWorker() {
+	VideoSourceImagesDecoder decoder(mpParent);
+	vdfastvector<wchar_t> pathBuf;
+	vdfastvector<char> fileBuf;
+	VDFile file;
+
+	for(;;) {
+		mDecodeRequests.Wait();
+
+		DecodedFrame *df = NULL;
+		VDPosition frame = -1;
+		VDPixmapLayout layout;
+
+		vdsynchronized(mDecodeLock) {
+			if (mbDecodeWorkersQuit)
+				return;
+
+			if (!mDecodeQueue.empty()) {
+				df = mDecodeQueue.front();
+				mDecodeQueue.erase(mDecodeQueue.begin());
+
+				df->mState = kStateDecoding;
+				frame = df->mFrame;
+				layout = mFrameLayout;
+			}
+		}
+
+		if (!df)
+			continue;
+
+		// The entry can't be freed or reused while it is marked as decoding,
+		// so its buffer is safe to write without the lock.
+		bool success = false;
+
+		try {
+			file.open(mpParent->ComputeFilename(pathBuf, frame), nsVDFile::kRead | nsVDFile::kDenyWrite | nsVDFile::kOpenExisting | nsVDFile::kSequential);
+
+			sint64 size = file.size();
+			if (size > 0 && size <= 0x3fffffff) {
+				fileBuf.resize((uint32)size);
+				file.read(fileBuf.data(), (long)size);
+				file.close();
+
+				int w, h;
+				decoder.Begin(fileBuf.data(), (uint32)size, frame, w, h);
+
+				if (w == layout.w && h == layout.h) {
+					decoder.Decode(VDPixmapFromLayout(layout, df->mData.data()));
+					success = true;
+				}
+			}
+		} catch(const MyError&) {
+		}
+
+		file.closeNT();
+
+		vdsynchronized(mDecodeLock) {
+			df->mState = success ? kStateReady : kStateFailed;
+		}
+
+		mDecodeComplete.signal();
+	}
+}
@@ -1,2330 +0,0 @@
-;	VirtualDub - Video processing and capture application
-;	Copyright (C) 1998-2001 Avery Lee
-;
-;	This program is free software; you can redistribute it and/or modify
-;	it under the terms of the GNU General Public License as published by
-;	the Free Software Foundation; either version 2 of the License, or
-;	(at your option) any later version.
-;
-;	This program is distributed in the hope that it will be useful,
-;	but WITHOUT ANY WARRANTY; without even the implied warranty of
-;	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-;	GNU General Public License for more details.
-;
-;	You should have received a copy of the GNU General Public License
-;	along with this program; if not, write to the Free Software
-;	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
-
-	segment	.rdata, align=16
-
-	global	_asm_const_multiply_tab	
-
-_asm_const_multiply_tab	dd	im0,im1,im2,im3,im4,im5,im6,im7
-	dd	im8,im9,im10,im11,im12,im13,im14,im15
-	dd	im16,im17,im18,im19,im20,im21,im22,im23
-	dd	im24,im25,im26,im27,im28,im29,im30,im31
-	dd	im32,im33,im34,im35,im36,im37,im38,im39
-	dd	im40,im41,im42,im43,im44,im45,im46,im47
-	dd	im48,im49,im50,im51,im52,im53,im54,im55
-	dd	im56,im57,im58,im59,im60,im61,im62,im63
-	dd	im64,im65,im66,im67,im68,im69,im70,im71
-	dd	im72,im73,im74,im75,im76,im77,im78,im79
-	dd	im80,im81,im82,im83,im84,im85,im86,im87
-	dd	im88,im89,im90,im91,im92,im93,im94,im95
-	dd	im96,im97,im98,im99,im100,im101,im102,im103
-	dd	im104,im105,im106,im107,im108,im109,im110,im111
-	dd	im112,im113,im114,im115,im116,im117,im118,im119
-	dd	im120,im121,im122,im123,im124,im125,im126,im127
-	dd	im128,im129,im130,im131,im132,im133,im134,im135
-	dd	im136,im137,im138,im139,im140,im141,im142,im143
-	dd	im144,im145,im146,im147,im148,im149,im150,im151
-	dd	im152,im153,im154,im155,im156,im157,im158,im159
-	dd	im160,im161,im162,im163,im164,im165,im166,im167
-	dd	im168,im169,im170,im171,im172,im173,im174,im175
-	dd	im176,im177,im178,im179,im180,im181,im182,im183
-	dd	im184,im185,im186,im187,im188,im189,im190,im191
-	dd	im192,im193,im194,im195,im196,im197,im198,im199
-	dd	im200,im201,im202,im203,im204,im205,im206,im207
-	dd	im208,im209,im210,im211,im212,im213,im214,im215
-	dd	im216,im217,im218,im219,im220,im221,im222,im223
-	dd	im224,im225,im226,im227,im228,im229,im230,im231
-	dd	im232,im233,im234,im235,im236,im237,im238,im239
-	dd	im240,im241,im242,im243,im244,im245,im246,im247
-	dd	im248,im249,im250,im251,im252,im253,im254,im255
-	dd	im256,im257,im258,im259,im260,im261,im262,im263
-	dd	im264,im265,im266,im267,im268,im269,im270,im271
-	dd	im272,im273,im274,im275,im276,im277,im278,im279
-	dd	im280,im281,im282,im283,im284,im285,im286,im287
-	dd	im288,im289,im290,im291,im292,im293,im294,im295
-	dd	im296,im297,im298,im299,im300,im301,im302,im303
-	dd	im304,im305,im306,im307,im308,im309,im310,im311
-	dd	im312,im313,im314,im315,im316,im317,im318,im319
-	dd	im320,im321,im322,im323,im324,im325,im326,im327
-	dd	im328,im329,im330,im331,im332,im333,im334,im335
-	dd	im336,im337,im338,im339,im340,im341,im342,im343
-	dd	im344,im345,im346,im347,im348,im349,im350,im351
-	dd	im352,im353,im354,im355,im356,im357,im358,im359
-	dd	im360,im361,im362,im363,im364,im365,im366,im367
-	dd	im368,im369,im370,im371,im372,im373,im374,im375
-	dd	im376,im377,im378,im379,im380,im381,im382,im383
-	dd	im384,im385,im386,im387,im388,im389,im390,im391
-	dd	im392,im393,im394,im395,im396,im397,im398,im399
-	dd	im400,im401,im402,im403,im404,im405,im406,im407
-	dd	im408,im409,im410,im411,im412,im413,im414,im415
-	dd	im416,im417,im418,im419,im420,im421,im422,im423
-	dd	im424,im425,im426,im427,im428,im429,im430,im431
-	dd	im432,im433,im434,im435,im436,im437,im438,im439
-	dd	im440,im441,im442,im443,im444,im445,im446,im447
-	dd	im448,im449,im450,im451,im452,im453,im454,im455
-	dd	im456,im457,im458,im459,im460,im461,im462,im463
-	dd	im464,im465,im466,im467,im468,im469,im470,im471
-	dd	im472,im473,im474,im475,im476,im477,im478,im479
-	dd	im480,im481,im482,im483,im484,im485,im486,im487
-	dd	im488,im489,im490,im491,im492,im493,im494,im495
-	dd	im496,im497,im498,im499,im500,im501,im502,im503
-	dd	im504,im505,im506,im507,im508,im509,im510,im511
-	dd	im512,im513,im514,im515,im516,im517,im518,im519
-	dd	im520,im521,im522,im523,im524,im525,im526,im527
-	dd	im528,im529,im530,im531,im532,im533,im534,im535
-	dd	im536,im537,im538,im539,im540,im541,im542,im543
-	dd	im544,im545,im546,im547,im548,im549,im550,im551
-	dd	im552,im553,im554,im555,im556,im557,im558,im559
-	dd	im560,im561,im562,im563,im564,im565,im566,im567
-	dd	im568,im569,im570,im571,im572,im573,im574,im575
-	dd	im576,im577,im578,im579,im580,im581,im582,im583
-	dd	im584,im585,im586,im587,im588,im589,im590,im591
-	dd	im592,im593,im594,im595,im596,im597,im598,im599
-	dd	im600,im601,im602,im603,im604,im605,im606,im607
-	dd	im608,im609,im610,im611,im612,im613,im614,im615
-	dd	im616,im617,im618,im619,im620,im621,im622,im623
-	dd	im624,im625,im626,im627,im628,im629,im630,im631
-	dd	im632,im633,im634,im635,im636,im637,im638,im639
-	dd	im640,im641,im642,im643,im644,im645,im646,im647
-	dd	im648,im649,im650,im651,im652,im653,im654,im655
-	dd	im656,im657,im658,im659,im660,im661,im662,im663
-	dd	im664,im665,im666,im667,im668,im669,im670,im671
-	dd	im672,im673,im674,im675,im676,im677,im678,im679
-	dd	im680,im681,im682,im683,im684,im685,im686,im687
-	dd	im688,im689,im690,im691,im692,im693,im694,im695
-	dd	im696,im697,im698,im699,im700,im701,im702,im703
-	dd	im704,im705,im706,im707,im708,im709,im710,im711
-	dd	im712,im713,im714,im715,im716,im717,im718,im719
-	dd	im720,im721,im722,im723,im724,im725,im726,im727
-	dd	im728,im729,im730,im731,im732,im733,im734,im735
-	dd	im736,im737,im738,im739,im740,im741,im742,im743
-	dd	im744,im745,im746,im747,im748,im749,im750,im751
-	dd	im752,im753,im754,im755,im756,im757,im758,im759
-	dd	im760,im761,im762,im763,im764,im765,im766,im767
-	dd	im768,im769,im770,im771,im772,im773,im774,im775
-	dd	im776,im777,im778,im779,im780,im781,im782,im783
-	dd	im784,im785,im786,im787,im788,im789,im790,im791
-	dd	im792,im793,im794,im795,im796,im797,im798,im799
-	dd	im800,im801,im802,im803,im804,im805,im806,im807
-	dd	im808,im809,im810,im811,im812,im813,im814,im815
-	dd	im816,im817,im818,im819,im820,im821,im822,im823
-	dd	im824,im825,im826,im827,im828,im829,im830,im831
-	dd	im832,im833,im834,im835,im836,im837,im838,im839
-	dd	im840,im841,im842,im843,im844,im845,im846,im847
-	dd	im848,im849,im850,im851,im852,im853,im854,im855
-	dd	im856,im857,im858,im859,im860,im861,im862,im863
-	dd	im864,im865,im866,im867,im868,im869,im870,im871
-	dd	im872,im873,im874,im875,im876,im877,im878,im879
-	dd	im880,im881,im882,im883,im884,im885,im886,im887
-	dd	im888,im889,im890,im891,im892,im893,im894,im895
-	dd	im896,im897,im898,im899,im900,im901,im902,im903
-	dd	im904,im905,im906,im907,im908,im909,im910,im911
-	dd	im912,im913,im914,im915,im916,im917,im918,im919
-	dd	im920,im921,im922,im923,im924,im925,im926,im927
-	dd	im928,im929,im930,im931,im932,im933,im934,im935
-	dd	im936,im937,im938,im939,im940,im941,im942,im943
-	dd	im944,im945,im946,im947,im948,im949,im950,im951
-	dd	im952,im953,im954,im955,im956,im957,im958,im959
-	dd	im960,im961,im962,im963,im964,im965,im966,im967
-	dd	im968,im969,im970,im971,im972,im973,im974,im975
-	dd	im976,im977,im978,im979,im980,im981,im982,im983
-	dd	im984,im985,im986,im987,im988,im989,im990,im991
-	dd	im992,im993,im994,im995,im996,im997,im998,im999
-	dd	im1000,im1001,im1002,im1003,im1004,im1005,im1006,im1007
-	dd	im1008,im1009,im1010,im1011,im1012,im1013,im1014,im1015
-	dd	im1016,im1017,im1018,im1019,im1020,im1021,im1022,im1023
-	dd	im1024,im1025,im1026,im1027,im1028,im1029,im1030,im1031
-	dd	im1032,im1033,im1034,im1035,im1036,im1037,im1038,im1039
-	dd	im1040,im1041,im1042,im1043,im1044,im1045,im1046,im1047
-	dd	im1048,im1049,im1050,im1051,im1052,im1053,im1054,im1055
-	dd	im1056,im1057,im1058,im1059,im1060,im1061,im1062,im1063
-	dd	im1064,im1065,im1066,im1067,im1068,im1069,im1070,im1071
-	dd	im1072,im1073,im1074,im1075,im1076,im1077,im1078,im1079
-	dd	im1080,im1081,im1082,im1083,im1084,im1085,im1086,im1087
-	dd	im1088,im1089,im1090,im1091,im1092,im1093,im1094,im1095
-	dd	im1096,im1097,im1098,im1099,im1100,im1101,im1102,im1103
-	dd	im1104,im1105,im1106,im1107,im1108,im1109,im1110,im1111
-	dd	im1112,im1113,im1114,im1115,im1116,im1117,im1118,im1119
-	dd	im1120,im1121,im1122,im1123,im1124,im1125,im1126,im1127
-	dd	im1128,im1129,im1130,im1131,im1132,im1133,im1134,im1135
-	dd	im1136,im1137,im1138,im1139,im1140,im1141,im1142,im1143
-	dd	im1144,im1145,im1146,im1147,im1148,im1149,im1150,im1151
-	dd	im1152,im1153,im1154,im1155,im1156,im1157,im1158,im1159
-	dd	im1160,im1161,im1162,im1163,im1164,im1165,im1166,im1167
-	dd	im1168,im1169,im1170,im1171,im1172,im1173,im1174,im1175
-	dd	im1176,im1177,im1178,im1179,im1180,im1181,im1182,im1183
-	dd	im1184,im1185,im1186,im1187,im1188,im1189,im1190,im1191
-	dd	im1192,im1193,im1194,im1195,im1196,im1197,im1198,im1199
-	dd	im1200,im1201,im1202,im1203,im1204,im1205,im1206,im1207
-	dd	im1208,im1209,im1210,im1211,im1212,im1213,im1214,im1215
-	dd	im1216,im1217,im1218,im1219,im1220,im1221,im1222,im1223
-	dd	im1224,im1225,im1226,im1227,im1228,im1229,im1230,im1231
-	dd	im1232,im1233,im1234,im1235,im1236,im1237,im1238,im1239
-	dd	im1240,im1241,im1242,im1243,im1244,im1245,im1246,im1247
-	dd	im1248,im1249,im1250,im1251,im1252,im1253,im1254,im1255
-	dd	im1256,im1257,im1258,im1259,im1260,im1261,im1262,im1263
-	dd	im1264,im1265,im1266,im1267,im1268,im1269,im1270,im1271
-	dd	im1272,im1273,im1274,im1275,im1276,im1277,im1278,im1279
-	dd	im1280,im1281,im1282,im1283,im1284,im1285,im1286,im1287
-	dd	im1288,im1289,im1290,im1291,im1292,im1293,im1294,im1295
-	dd	im1296,im1297,im1298,im1299,im1300,im1301,im1302,im1303
-	dd	im1304,im1305,im1306,im1307,im1308,im1309,im1310,im1311
-	dd	im1312,im1313,im1314,im1315,im1316,im1317,im1318,im1319
-	dd	im1320,im1321,im1322,im1323,im1324,im1325,im1326,im1327
-	dd	im1328,im1329,im1330,im1331,im1332,im1333,im1334,im1335
-	dd	im1336,im1337,im1338,im1339,im1340,im1341,im1342,im1343
-	dd	im1344,im1345,im1346,im1347,im1348,im1349,im1350,im1351
-	dd	im1352,im1353,im1354,im1355,im1356,im1357,im1358,im1359
-	dd	im1360,im1361,im1362,im1363,im1364,im1365,im1366,im1367
-	dd	im1368,im1369,im1370,im1371,im1372,im1373,im1374,im1375
-	dd	im1376,im1377,im1378,im1379,im1380,im1381,im1382,im1383
-	dd	im1384,im1385,im1386,im1387,im1388,im1389,im1390,im1391
-	dd	im1392,im1393,im1394,im1395,im1396,im1397,im1398,im1399
-	dd	im1400,im1401,im1402,im1403,im1404,im1405,im1406,im1407
-	dd	im1408,im1409,im1410,im1411,im1412,im1413,im1414,im1415
-	dd	im1416,im1417,im1418,im1419,im1420,im1421,im1422,im1423
-	dd	im1424,im1425,im1426,im1427,im1428,im1429,im1430,im1431
-	dd	im1432,im1433,im1434,im1435,im1436,im1437,im1438,im1439
-	dd	im1440,im1441,im1442,im1443,im1444,im1445,im1446,im1447
-	dd	im1448,im1449,im1450,im1451,im1452,im1453,im1454,im1455
-	dd	im1456,im1457,im1458,im1459,im1460,im1461,im1462,im1463
-	dd	im1464,im1465,im1466,im1467,im1468,im1469,im1470,im1471
-	dd	im1472,im1473,im1474,im1475,im1476,im1477,im1478,im1479
-	dd	im1480,im1481,im1482,im1483,im1484,im1485,im1486,im1487
-	dd	im1488,im1489,im1490,im1491,im1492,im1493,im1494,im1495
-	dd	im1496,im1497,im1498,im1499,im1500,im1501,im1502,im1503
-	dd	im1504,im1505,im1506,im1507,im1508,im1509,im1510,im1511
-	dd	im1512,im1513,im1514,im1515,im1516,im1517,im1518,im1519
-	dd	im1520,im1521,im1522,im1523,im1524,im1525,im1526,im1527
-	dd	im1528,im1529,im1530,im1531,im1532,im1533,im1534,im1535
-	dd	im1536,im1537,im1538,im1539,im1540,im1541,im1542,im1543
-	dd	im1544,im1545,im1546,im1547,im1548,im1549,im1550,im1551
-	dd	im1552,im1553,im1554,im1555,im1556,im1557,im1558,im1559
-	dd	im1560,im1561,im1562,im1563,im1564,im1565,im1566,im1567
-	dd	im1568,im1569,im1570,im1571,im1572,im1573,im1574,im1575
-	dd	im1576,im1577,im1578,im1579,im1580,im1581,im1582,im1583
-	dd	im1584,im1585,im1586,im1587,im1588,im1589,im1590,im1591
-	dd	im1592,im1593,im1594,im1595,im1596,im1597,im1598,im1599
-	dd	im1600,im1601,im1602,im1603,im1604,im1605,im1606,im1607
-	dd	im1608,im1609,im1610,im1611,im1612,im1613,im1614,im1615
-	dd	im1616,im1617,im1618,im1619,im1620,im1621,im1622,im1623
-	dd	im1624,im1625,im1626,im1627,im1628,im1629,im1630,im1631
-	dd	im1632,im1633,im1634,im1635,im1636,im1637,im1638,im1639
-	dd	im1640,im1641,im1642,im1643,im1644,im1645,im1646,im1647
-	dd	im1648,im1649,im1650,im1651,im1652,im1653,im1654,im1655
-	dd	im1656,im1657,im1658,im1659,im1660,im1661,im1662,im1663
-	dd	im1664,im1665,im1666,im1667,im1668,im1669,im1670,im1671
-	dd	im1672,im1673,im1674,im1675,im1676,im1677,im1678,im1679
-	dd	im1680,im1681,im1682,im1683,im1684,im1685,im1686,im1687
-	dd	im1688,im1689,im1690,im1691,im1692,im1693,im1694,im1695
-	dd	im1696,im1697,im1698,im1699,im1700,im1701,im1702,im1703
-	dd	im1704,im1705,im1706,im1707,im1708,im1709,im1710,im1711
-	dd	im1712,im1713,im1714,im1715,im1716,im1717,im1718,im1719
-	dd	im1720,im1721,im1722,im1723,im1724,im1725,im1726,im1727
-	dd	im1728,im1729,im1730,im1731,im1732,im1733,im1734,im1735
-	dd	im1736,im1737,im1738,im1739,im1740,im1741,im1742,im1743
-	dd	im1744,im1745,im1746,im1747,im1748,im1749,im1750,im1751
-	dd	im1752,im1753,im1754,im1755,im1756,im1757,im1758,im1759
-	dd	im1760,im1761,im1762,im1763,im1764,im1765,im1766,im1767
-	dd	im1768,im1769,im1770,im1771,im1772,im1773,im1774,im1775
-	dd	im1776,im1777,im1778,im1779,im1780,im1781,im1782,im1783
-	dd	im1784,im1785,im1786,im1787,im1788,im1789,im1790,im1791
-	dd	im1792,im1793,im1794,im1795,im1796,im1797,im1798,im1799
-	dd	im1800,im1801,im1802,im1803,im1804,im1805,im1806,im1807
-	dd	im1808,im1809,im1810,im1811,im1812,im1813,im1814,im1815
-	dd	im1816,im1817,im1818,im1819,im1820,im1821,im1822,im1823
-	dd	im1824,im1825,im1826,im1827,im1828,im1829,im1830,im1831
-	dd	im1832,im1833,im1834,im1835,im1836,im1837,im1838,im1839
-	dd	im1840,im1841,im1842,im1843,im1844,im1845,im1846,im1847
-	dd	im1848,im1849,im1850,im1851,im1852,im1853,im1854,im1855
-	dd	im1856,im1857,im1858,im1859,im1860,im1861,im1862,im1863
-	dd	im1864,im1865,im1866,im1867,im1868,im1869,im1870,im1871
-	dd	im1872,im1873,im1874,im1875,im1876,im1877,im1878,im1879
-	dd	im1880,im1881,im1882,im1883,im1884,im1885,im1886,im1887
-	dd	im1888,im1889,im1890,im1891,im1892,im1893,im1894,im1895
-	dd	im1896,im1897,im1898,im1899,im1900,im1901,im1902,im1903
-	dd	im1904,im1905,im1906,im1907,im1908,im1909,im1910,im1911
-	dd	im1912,im1913,im1914,im1915,im1916,im1917,im1918,im1919
-	dd	im1920,im1921,im1922,im1923,im1924,im1925,im1926,im1927
-	dd	im1928,im1929,im1930,im1931,im1932,im1933,im1934,im1935
-	dd	im1936,im1937,im1938,im1939,im1940,im1941,im1942,im1943
-	dd	im1944,im1945,im1946,im1947,im1948,im1949,im1950,im1951
-	dd	im1952,im1953,im1954,im1955,im1956,im1957,im1958,im1959
-	dd	im1960,im1961,im1962,im1963,im1964,im1965,im1966,im1967
-	dd	im1968,im1969,im1970,im1971,im1972,im1973,im1974,im1975
-	dd	im1976,im1977,im1978,im1979,im1980,im1981,im1982,im1983
-	dd	im1984,im1985,im1986,im1987,im1988,im1989,im1990,im1991
-	dd	im1992,im1993,im1994,im1995,im1996,im1997,im1998,im1999
-	dd	im2000,im2001,im2002,im2003,im2004,im2005,im2006,im2007
-	dd	im2008,im2009,im2010,im2011,im2012,im2013,im2014,im2015
-	dd	im2016,im2017,im2018,im2019,im2020,im2021,im2022,im2023
-	dd	im2024,im2025,im2026,im2027,im2028,im2029,im2030,im2031
-	dd	im2032,im2033,im2034,im2035,im2036,im2037,im2038,im2039
-	dd	im2040,im2041,im2042,im2043,im2044,im2045,im2046,im2047
-	dd	im2048
-
-im0	db	255
-im1	db	0,0,0,0,0,0,0,0,255
-im2	db	50,255
-im3	db	4,255
-im4	db	52,255
-im5	db	8,255
-im6	db	4,50,255
-im7	db	37,8,16,255
-im8	db	54,255
-im9	db	12,255
-im10	db	8,50,255
-im11	db	37,12,16,255
-im12	db	4,52,255
-im13	db	41,12,16,255
-im14	db	9,12,16,255
-im15	db	4,8,255
-im16	db	56,255
-im17	db	45,12,16,255
-im18	db	12,50,255
-im19	db	13,6,255
-im20	db	8,52,255
-im21	db	9,10,255
-im22	db	37,8,24,255
-im23	db	13,58,82,255
-im24	db	4,54,255
-im25	db	8,8,255
-im26	db	37,4,28,255
-im27	db	4,12,255
-im28	db	9,12,16,50,255
-im29	db	5,58,82,255
-im30	db	37,58,82,255
-im31	db	33,58,82,255
-im32	db	58,255
-im33	db	33,58,16,255
-im34	db	37,58,16,255
-im35	db	5,58,16,255
-im36	db	12,52,255
-im37	db	13,10,255
-im38	db	37,12,24,255
-im39	db	5,12,24,255
-im40	db	8,54,255
-im41	db	9,14,255
-im42	db	37,8,28,255
-im43	db	5,8,28,255
-im44	db	41,8,28,255
-im45	db	8,12,255
-im46	db	37,4,56,82,255
-im47	db	33,4,56,82,255
-im48	db	4,56,255
-im49	db	5,57,16,255
-im50	db	37,4,56,16,255
-im51	db	5,4,56,16,255
-im52	db	41,4,56,16,255
-im53	db	5,8,57,16,255
-im54	db	4,50,12,255
-im55	db	13,60,82,255
-im56	db	9,12,16,52,255
-im57	db	5,12,57,16,255
-im58	db	5,51,60,82,255
-im59	db	9,60,82,255
-im60	db	41,60,82,255
-im61	db	5,60,82,255
-im62	db	37,60,82,255
-im63	db	33,60,82,255
-im64	db	60,255
-im65	db	33,60,16,255
-im66	db	37,60,16,255
-im67	db	5,60,16,255
-im68	db	41,60,16,255
-im69	db	9,60,16,255
-im70	db	37,12,54,82,255
-im71	db	33,12,54,82,255
-im72	db	12,54,255
-im73	db	13,14,255
-im74	db	37,12,28,255
-im75	db	5,12,28,255
-im76	db	41,12,28,255
-im77	db	9,12,28,255
-im78	db	37,8,56,82,255
-im79	db	33,8,56,82,255
-im80	db	8,56,255
-im81	db	12,12,255
-im82	db	37,8,56,16,255
-im83	db	5,8,56,16,255
-im84	db	41,8,56,16,255
-im85	db	9,8,56,16,255
-im86	db	9,16,57,16,255
-im87	db	13,4,58,82,255
-im88	db	37,12,16,54,255
-im89	db	9,12,57,16,255
-im90	db	8,50,12,255
-im91	db	9,4,58,82,255
-im92	db	41,4,58,82,255
-im93	db	5,4,58,82,255
-im94	db	37,4,58,82,255
-im95	db	33,4,58,82,255
-im96	db	4,58,255
-im97	db	5,59,16,255
-im98	db	37,4,58,16,255
-im99	db	5,4,58,16,255
-im100	db	41,4,58,16,255
-im101	db	5,8,59,16,255
-im102	db	5,4,58,6,255
-im103	db	13,8,16,54,82,255
-im104	db	41,12,16,54,255
-im105	db	5,12,59,16,255
-im106	db	5,8,59,20,255
-im107	db	9,12,16,54,82,255
-im108	db	4,52,12,255
-im109	db	45,8,3,14,255
-im110	db	13,51,62,82,255
-im111	db	4,13,10,255
-im112	db	9,12,16,54,255
-im113	db	45,81,57,16,255
-im114	db	5,12,59,20,255
-im115	db	41,4,3,57,16,255
-im116	db	5,58,82,52,255
-im117	db	9,12,16,28,255
-im118	db	9,51,62,82,255
-im119	db	13,62,82,255
-im120	db	45,62,82,255
-im121	db	9,12,3,14,255
-im122	db	5,51,62,82,255
-im123	db	9,62,82,255
-im124	db	41,62,82,255
-im125	db	5,62,82,255
-im126	db	37,62,82,255
-im127	db	33,62,82,255
-im128	db	62,255
-im129	db	33,62,16,255
-im130	db	37,62,16,255
-im131	db	5,62,16,255
-im132	db	41,62,16,255
-im133	db	9,62,16,255
-im134	db	5,62,6,255
-im135	db	13,12,56,82,255
-im136	db	45,62,16,255
-im137	db	13,62,16,255
-im138	db	9,62,6,255
-im139	db	9,12,56,82,255
-im140	db	41,12,56,82,255
-im141	db	5,12,56,82,255
-im142	db	37,12,56,82,255
-im143	db	33,12,56,82,255
-im144	db	12,56,255
-im145	db	13,57,16,255
-im146	db	37,12,56,16,255
-im147	db	5,12,56,16,255
-im148	db	41,12,56,16,255
-im149	db	9,12,56,16,255
-im150	db	5,12,28,50,255
-im151	db	13,8,58,82,255
-im152	db	45,8,58,82,255
-im153	db	13,12,56,16,255
-im154	db	13,16,57,16,255
-im155	db	9,8,58,82,255
-im156	db	41,8,58,82,255
-im157	db	5,8,58,82,255
-im158	db	37,8,58,82,255
-im159	db	33,8,58,82,255
-im160	db	8,58,255
-im161	db	9,59,16,255
-im162	db	37,8,58,16,255
-im163	db	5,8,58,16,255
-im164	db	41,8,58,16,255
-im165	db	9,8,58,16,255
-im166	db	9,16,59,16,255
-im167	db	37,8,3,58,16,255
-im168	db	45,8,58,16,255
-im169	db	9,12,59,16,255
-im170	db	9,8,58,6,255
-im171	db	12,13,6,255
-im172	db	5,8,58,10,255
-im173	db	45,8,3,58,16,255
-im174	db	9,12,16,59,16,255
-im175	db	5,58,16,8,255
-im176	db	37,12,16,56,255
-im177	db	9,60,82,4,255
-im178	db	9,12,59,20,255
-im179	db	45,4,3,57,16,255
-im180	db	8,52,12,255
-im181	db	45,4,3,60,82,255
-im182	db	9,51,4,60,82,255
-im183	db	13,4,60,82,255
-im184	db	45,4,60,82,255
-im185	db	37,12,3,57,16,255
-im186	db	5,51,4,60,82,255
-im187	db	9,4,60,82,255
-im188	db	41,4,60,82,255
-im189	db	5,4,60,82,255
-im190	db	37,4,60,82,255
-im191	db	33,4,60,82,255
-im192	db	4,60,255
-im193	db	5,61,16,255
-im194	db	37,4,60,16,255
-im195	db	5,4,60,16,255
-im196	db	41,4,60,16,255
-im197	db	5,8,61,16,255
-im198	db	5,4,60,6,255
-im199	db	41,4,3,60,16,255
-im200	db	45,4,60,16,255
-im201	db	5,12,61,16,255
-im202	db	5,8,61,20,255
-im203	db	45,4,3,60,16,255
-im204	db	5,4,60,10,255
-im205	db	8,9,14,255
-im206	db	13,8,16,51,56,82,255
-im207	db	5,55,81,30,255
-im208	db	41,12,16,56,255
-im209	db	13,56,16,28,255
-im210	db	5,12,61,20,255
-im211	db	5,10,56,16,255
-im212	db	5,8,61,24,255
-im213	db	45,8,3,57,16,255
-im214	db	9,12,16,51,56,82,255
-im215	db	13,8,16,56,82,255
-im216	db	4,54,12,255
-im217	db	41,12,3,57,16,255
-im218	db	13,55,16,20,255
-im219	db	9,12,16,56,82,255
-im220	db	13,60,82,52,255
-im221	db	9,58,82,28,255
-im222	db	37,8,16,58,82,255
-im223	db	33,54,82,58,82,255
-im224	db	9,12,16,56,255
-im225	db	45,81,59,16,255
-im226	db	37,8,16,58,16,255
-im227	db	41,4,3,59,16,255
-im228	db	5,12,61,24,255
-im229	db	9,12,16,56,16,255
-im230	db	5,51,16,58,16,255
-im231	db	5,15,64,82,255
-im232	db	5,58,82,54,255
-im233	db	9,12,3,57,16,255
-im234	db	13,51,12,16,28,255
-im235	db	5,58,82,28,255
-im236	db	9,60,82,52,255
-im237	db	9,57,81,22,255
-im238	db	13,51,64,82,255
-im239	db	13,29,64,82,255
-im240	db	4,56,8,255
-im241	db	5,57,16,10,255
-im242	db	9,57,16,20,255
-im243	db	4,12,12,255
-im244	db	5,60,82,52,255
-im245	db	5,57,16,8,255
-im246	db	9,51,64,82,255
-im247	db	13,64,82,255
-im248	db	45,64,82,255
-im249	db	45,81,64,82,255
-im250	db	5,51,64,82,255
-im251	db	9,64,82,255
-im252	db	41,64,82,255
-im253	db	5,64,82,255
-im254	db	37,64,82,255
-im255	db	33,64,82,255
-im256	db	64,255
-im257	db	33,64,16,255
-im258	db	37,64,16,255
-im259	db	5,64,16,255
-im260	db	41,64,16,255
-im261	db	9,64,16,255
-im262	db	5,64,6,255
-im263	db	45,81,64,16,255
-im264	db	45,64,16,255
-im265	db	13,64,16,255
-im266	db	9,64,6,255
-im267	db	37,12,16,63,16,255
-im268	db	5,64,10,255
-im269	db	41,12,16,61,16,255
-im270	db	13,51,12,58,82,255
-im271	db	45,12,3,58,82,255
-im272	db	45,12,16,56,255
-im273	db	45,12,16,59,16,255
-im274	db	13,64,6,255
-im275	db	41,12,3,58,82,255
-im276	db	9,64,10,255
-im277	db	37,12,3,58,82,255
-im278	db	33,12,3,58,82,255
-im279	db	13,12,58,82,255
-im280	db	45,12,58,82,255
-im281	db	45,81,12,58,82,255
-im282	db	5,51,12,58,82,255
-im283	db	9,12,58,82,255
-im284	db	41,12,58,82,255
-im285	db	5,12,58,82,255
-im286	db	37,12,58,82,255
-im287	db	33,12,58,82,255
-im288	db	12,58,255
-im289	db	13,59,16,255
-im290	db	37,12,58,16,255
-im291	db	5,12,58,16,255
-im292	db	41,12,58,16,255
-im293	db	9,12,58,16,255
-im294	db	5,12,58,6,255
-im295	db	45,81,12,58,16,255
-im296	db	45,12,58,16,255
-im297	db	13,12,58,16,255
-im298	db	13,16,59,16,255
-im299	db	37,12,3,58,16,255
-im300	db	5,12,58,10,255
-im301	db	41,12,3,58,16,255
-im302	db	9,12,3,58,16,255
-im303	db	5,12,28,24,255
-im304	db	13,6,56,255
-im305	db	45,12,3,58,16,255
-im306	db	13,12,58,6,255
-im307	db	45,8,3,60,82,255
-im308	db	9,12,58,10,255
-im309	db	5,12,29,10,255
-im310	db	9,51,8,60,82,255
-im311	db	13,8,60,82,255
-im312	db	45,8,60,82,255
-im313	db	37,8,3,60,82,255
-im314	db	33,8,3,60,82,255
-im315	db	9,8,60,82,255
-im316	db	41,8,60,82,255
-im317	db	5,8,60,82,255
-im318	db	37,8,60,82,255
-im319	db	33,8,60,82,255
-im320	db	8,60,255
-im321	db	9,61,16,255
-im322	db	37,8,60,16,255
-im323	db	5,8,60,16,255
-im324	db	41,8,60,16,255
-im325	db	9,8,60,16,255
-im326	db	9,16,61,16,255
-im327	db	37,8,3,60,16,255
-im328	db	45,8,60,16,255
-im329	db	9,12,61,16,255
-im330	db	9,8,60,6,255
-im331	db	9,6,61,16,255
-im332	db	5,8,60,10,255
-im333	db	45,8,3,60,16,255
-im334	db	9,12,16,61,16,255
-im335	db	5,60,16,8,255
-im336	db	9,10,56,255
-im337	db	13,58,16,28,255
-im338	db	9,12,61,20,255
-im339	db	13,16,3,58,16,255
-im340	db	9,8,60,10,255
-im341	db	9,10,56,16,255
-im342	db	9,51,16,58,82,255
-im343	db	13,20,58,82,255
-im344	db	5,8,60,14,255
-im345	db	9,60,16,8,255
-im346	db	33,8,3,16,58,82,255
-im347	db	9,6,58,82,255
-im348	db	13,4,58,82,52,255
-im349	db	5,28,58,82,255
-im350	db	37,12,16,58,82,255
-im351	db	9,55,81,30,255
-im352	db	37,12,16,58,255
-im353	db	5,29,59,16,255
-im354	db	37,12,16,58,16,255
-im355	db	45,4,3,59,16,255
-im356	db	9,12,61,24,255
-im357	db	13,62,82,4,255
-im358	db	9,16,3,59,16,255
-im359	db	33,4,29,62,82,255
-im360	db	8,54,12,255
-im361	db	37,12,3,59,16,255
-im362	db	9,51,16,58,16,255
-im363	db	5,8,12,28,255
-im364	db	9,4,58,82,52,255
-im365	db	8,13,14,255
-im366	db	13,51,4,62,82,255
-im367	db	13,57,3,66,82,255
-im368	db	13,58,82,56,255
-im369	db	12,9,14,255
-im370	db	37,12,28,8,255
-im371	db	33,4,25,62,82,255
-im372	db	13,4,3,62,82,255
-im373	db	45,4,3,62,82,255
-im374	db	9,51,4,62,82,255
-im375	db	13,4,62,82,255
-im376	db	45,4,62,82,255
-im377	db	41,4,3,62,82,255
-im378	db	5,51,4,62,82,255
-im379	db	9,4,62,82,255
-im380	db	41,4,62,82,255
-im381	db	5,4,62,82,255
-im382	db	37,4,62,82,255
-im383	db	33,4,62,82,255
-im384	db	4,62,255
-im385	db	5,63,16,255
-im386	db	37,4,62,16,255
-im387	db	5,4,62,16,255
-im388	db	41,4,62,16,255
-im389	db	5,8,63,16,255
-im390	db	5,4,62,6,255
-im391	db	41,4,3,62,16,255
-im392	db	45,4,62,16,255
-im393	db	5,12,63,16,255
-im394	db	5,8,63,20,255
-im395	db	45,4,3,62,16,255
-im396	db	5,4,62,10,255
-im397	db	5,10,63,16,255
-im398	db	37,4,62,82,14,255
-im399	db	9,62,16,4,255
-im400	db	8,56,8,255
-im401	db	9,57,16,10,255
-im402	db	5,12,63,20,255
-im403	db	5,14,56,16,255
-im404	db	5,8,63,24,255
-im405	db	8,12,12,255
-im406	db	9,51,4,16,58,82,255
-im407	db	13,24,58,82,255
-im408	db	5,4,62,14,255
-im409	db	5,14,63,16,255
-im410	db	37,8,56,16,8,255
-im411	db	13,62,16,4,255
-im412	db	41,12,16,58,82,255
-im413	db	5,10,58,82,255
-im414	db	13,51,12,16,56,82,255
-im415	db	33,4,24,58,82,255
-im416	db	41,12,16,58,255
-im417	db	5,11,59,16,255
-im418	db	37,4,28,56,16,255
-im419	db	5,10,58,16,255
-im420	db	5,12,63,24,255
-im421	db	45,8,3,59,16,255
-im422	db	5,10,58,6,255
-im423	db	5,57,81,30,255
-im424	db	5,8,63,28,255
-im425	db	41,12,3,59,16,255
-im426	db	5,8,50,3,59,16,255
-im427	db	9,58,82,56,82,255
-im428	db	5,53,16,58,16,255
-im429	db	13,57,81,22,255
-im430	db	13,8,16,51,58,82,255
-im431	db	13,66,31,82,255
-im432	db	4,56,12,255
-im433	db	5,57,16,14,255
-im434	db	13,57,16,20,255
-im435	db	13,57,16,4,255
-im436	db	13,57,16,52,82,255
-im437	db	9,58,82,56,16,255
-im438	db	5,12,56,3,6,255
-im439	db	13,8,16,58,82,255
-im440	db	13,60,82,54,255
-im441	db	5,57,16,12,255
-im442	db	5,51,16,60,82,255
-im443	db	9,12,16,58,82,255
-im444	db	41,4,16,60,82,255
-im445	db	5,6,60,82,255
-im446	db	37,8,16,60,82,255
-im447	db	33,54,82,60,82,255
-im448	db	9,12,16,58,255
-im449	db	45,81,61,16,255
-im450	db	37,8,16,60,16,255
-im451	db	41,4,3,61,16,255
-im452	db	41,4,16,60,16,255
-im453	db	9,12,16,58,16,255
-im454	db	5,51,16,60,16,255
-im455	db	5,8,59,81,26,255
-im456	db	5,12,63,28,255
-im457	db	9,12,3,59,16,255
-im458	db	9,12,16,58,6,255
-im459	db	5,4,56,16,12,255
-im460	db	41,4,3,61,24,255
-im461	db	5,58,82,56,82,255
-im462	db	9,12,16,33,58,16,255
-im463	db	5,57,3,66,82,255
-im464	db	5,58,82,56,255
-im465	db	5,57,81,66,82,255
-im466	db	9,12,3,59,20,255
-im467	db	9,66,31,82,255
-im468	db	9,12,16,58,10,255
-im469	db	5,8,15,57,16,255
-im470	db	9,51,8,16,58,82,255
-im471	db	9,15,66,82,255
-im472	db	9,60,82,54,255
-im473	db	9,55,81,66,82,255
-im474	db	5,51,12,16,58,82,255
-im475	db	5,59,81,26,255
-im476	db	13,62,82,52,255
-im477	db	9,60,82,28,255
-im478	db	37,58,3,56,82,255
-im479	db	33,56,82,58,82,255
-im480	db	4,58,8,255
-im481	db	5,59,16,10,255
-im482	db	9,59,16,20,255
-im483	db	9,59,16,4,255
-im484	db	5,59,16,24,255
-im485	db	5,59,16,8,255
-im486	db	5,8,58,3,6,255
-im487	db	5,15,66,82,255
-im488	db	5,60,82,54,255
-im489	db	5,55,81,66,82,255
-im490	db	9,8,58,3,6,255
-im491	db	5,60,82,28,255
-im492	db	9,62,82,52,255
-im493	db	13,7,66,82,255
-im494	db	13,51,66,82,255
-im495	db	13,60,82,12,255
-im496	db	33,58,82,56,255
-im497	db	9,62,82,24,255
-im498	db	9,12,59,16,20,255
-im499	db	5,11,66,82,255
-im500	db	5,62,82,52,255
-im501	db	5,29,66,82,255
-im502	db	9,51,66,82,255
-im503	db	13,66,82,255
-im504	db	45,66,82,255
-im505	db	45,81,66,82,255
-im506	db	5,51,66,82,255
-im507	db	9,66,82,255
-im508	db	41,66,82,255
-im509	db	5,66,82,255
-im510	db	37,66,82,255
-im511	db	33,66,82,255
-im512	db	66,255
-im513	db	33,66,16,255
-im514	db	37,66,16,255
-im515	db	5,66,16,255
-im516	db	41,66,16,255
-im517	db	9,66,16,255
-im518	db	5,66,6,255
-im519	db	45,81,66,16,255
-im520	db	45,66,16,255
-im521	db	13,66,16,255
-im522	db	9,66,6,255
-im523	db	37,12,16,65,16,255
-im524	db	5,66,10,255
-im525	db	41,12,16,63,16,255
-im526	db	37,66,82,14,255
-im527	db	5,62,16,24,255
-im528	db	33,56,67,16,255
-im529	db	45,12,16,61,16,255
-im530	db	13,66,6,255
-im531	db	9,60,82,12,255
-im532	db	9,66,10,255
-im533	db	5,66,82,14,255
-im534	db	37,12,16,65,20,255
-im535	db	13,28,58,82,255
-im536	db	5,66,14,255
-im537	db	9,62,16,24,255
-im538	db	41,12,16,63,20,255
-im539	db	5,60,16,28,255
-im540	db	13,12,56,82,52,255
-im541	db	9,12,54,82,28,255
-im542	db	37,14,58,82,255
-im543	db	33,56,16,58,82,255
-im544	db	45,12,16,58,255
-im545	db	13,29,59,16,255
-im546	db	37,14,58,16,255
-im547	db	9,66,82,14,255
-im548	db	13,66,10,255
-im549	db	5,60,82,12,255
-im550	db	37,12,24,65,16,255
-im551	db	33,67,81,8,28,255
-im552	db	9,66,14,255
-im553	db	45,12,3,59,16,255
-im554	db	37,8,28,65,16,255
-im555	db	5,12,54,82,28,255
-im556	db	9,12,56,82,52,255
-im557	db	9,60,16,28,255
-im558	db	13,51,12,60,82,255
-im559	db	45,12,3,60,82,255
-im560	db	5,58,16,56,255
-im561	db	9,57,14,82,255
-im562	db	9,12,3,60,82,255
-im563	db	41,12,3,60,82,255
-im564	db	5,12,3,60,82,255
-im565	db	37,12,3,60,82,255
-im566	db	33,12,3,60,82,255
-im567	db	13,12,60,82,255
-im568	db	45,12,60,82,255
-im569	db	45,81,12,60,82,255
-im570	db	5,51,12,60,82,255
-im571	db	9,12,60,82,255
-im572	db	41,12,60,82,255
-im573	db	5,12,60,82,255
-im574	db	37,12,60,82,255
-im575	db	33,12,60,82,255
-im576	db	12,60,255
-im577	db	13,61,16,255
-im578	db	37,12,60,16,255
-im579	db	5,12,60,16,255
-im580	db	41,12,60,16,255
-im581	db	9,12,60,16,255
-im582	db	5,12,60,6,255
-im583	db	45,81,12,60,16,255
-im584	db	45,12,60,16,255
-im585	db	13,12,60,16,255
-im586	db	13,16,61,16,255
-im587	db	37,12,3,60,16,255
-im588	db	5,12,60,10,255
-im589	db	41,12,3,60,16,255
-im590	db	9,12,3,60,16,255
-im591	db	33,12,24,56,82,255
-im592	db	13,10,56,255
-im593	db	45,12,3,60,16,255
-im594	db	13,12,60,6,255
-im595	db	13,62,82,8,255
-im596	db	9,12,60,10,255
-im597	db	9,58,16,56,16,255
-im598	db	33,12,3,16,58,82,255
-im599	db	13,6,58,82,255
-im600	db	5,12,60,14,255
-im601	db	13,10,56,16,255
-im602	db	41,12,3,60,6,255
-im603	db	5,60,16,12,255
-im604	db	13,8,58,82,52,255
-im605	db	5,56,16,58,82,255
-im606	db	37,4,14,58,82,255
-im607	db	33,12,20,58,82,255
-im608	db	13,6,58,255
-im609	db	13,7,59,16,255
-im610	db	45,12,3,60,6,255
-im611	db	5,56,16,58,16,255
-im612	db	13,12,60,10,255
-im613	db	13,10,61,16,255
-im614	db	37,12,25,60,16,255
-im615	db	9,62,82,8,255
-im616	db	9,12,60,14,255
-im617	db	13,6,58,16,255
-im618	db	13,16,3,59,16,255
-im619	db	33,8,25,62,82,255
-im620	db	9,8,58,82,52,255
-im621	db	9,60,16,12,255
-im622	db	13,51,8,62,82,255
-im623	db	5,8,11,62,82,255
-im624	db	5,12,24,56,255
-im625	db	5,62,82,8,255
-im626	db	13,8,3,62,82,255
-im627	db	45,8,3,62,82,255
-im628	db	5,8,58,82,52,255
-im629	db	33,8,21,62,82,255
-im630	db	9,51,8,62,82,255
-im631	db	13,8,62,82,255
-im632	db	45,8,62,82,255
-im633	db	37,8,3,62,82,255
-im634	db	33,8,3,62,82,255
-im635	db	9,8,62,82,255
-im636	db	41,8,62,82,255
-im637	db	5,8,62,82,255
-im638	db	37,8,62,82,255
-im639	db	33,8,62,82,255
-im640	db	8,62,255
-im641	db	9,63,16,255
-im642	db	37,8,62,16,255
-im643	db	5,8,62,16,255
-im644	db	41,8,62,16,255
-im645	db	9,8,62,16,255
-im646	db	9,16,63,16,255
-im647	db	37,8,3,62,16,255
-im648	db	45,8,62,16,255
-im649	db	9,12,63,16,255
-im650	db	9,8,62,6,255
-im651	db	9,6,63,16,255
-im652	db	5,8,62,10,255
-im653	db	45,8,3,62,16,255
-im654	db	9,12,16,63,16,255
-im655	db	5,62,16,8,255
-im656	db	9,14,56,255
-im657	db	12,13,14,255
-im658	db	9,12,63,20,255
-im659	db	13,16,3,60,16,255
-im660	db	9,8,62,10,255
-im661	db	9,10,63,16,255
-im662	db	37,8,25,62,16,255
-im663	db	9,63,81,4,28,255
-im664	db	5,8,62,14,255
-im665	db	9,62,16,8,255
-im666	db	37,12,28,12,255
-im667	db	9,10,58,82,255
-im668	db	9,12,16,63,20,255
-im669	db	5,8,15,62,16,255
-im670	db	37,8,14,58,82,255
-im671	db	33,8,24,58,82,255
-im672	db	9,10,58,255
-im673	db	5,59,14,82,255
-im674	db	37,8,14,58,16,255
-im675	db	5,12,28,12,255
-im676	db	9,12,63,24,255
-im677	db	9,10,58,16,255
-im678	db	13,16,3,60,6,255
-im679	db	9,63,81,8,28,255
-im680	db	9,8,62,14,255
-im681	db	9,14,63,16,255
-im682	db	37,8,29,62,16,255
-im683	db	5,8,29,62,16,255
-im684	db	5,12,3,16,58,16,255
-im685	db	13,62,16,8,255
-im686	db	9,16,14,63,16,255
-im687	db	13,4,64,31,82,255
-im688	db	5,8,28,56,255
-im689	db	9,12,14,63,16,255
-im690	db	5,12,50,3,59,16,255
-im691	db	5,8,28,56,16,255
-im692	db	9,53,16,58,16,255
-im693	db	9,12,28,12,255
-im694	db	9,51,16,60,82,255
-im695	db	13,20,60,82,255
-im696	db	13,4,58,82,54,255
-im697	db	13,55,81,4,64,82,255
-im698	db	33,8,3,16,60,82,255
-im699	db	9,6,60,82,255
-im700	db	41,12,56,82,8,255
-im701	db	5,28,60,82,255
-im702	db	37,12,16,60,82,255
-im703	db	33,4,14,60,82,255
-im704	db	37,12,16,60,255
-im705	db	5,29,61,16,255
-im706	db	37,12,16,60,16,255
-im707	db	45,4,3,61,16,255
-im708	db	37,12,16,60,6,255
-im709	db	9,6,60,16,255
-im710	db	9,16,3,61,16,255
-im711	db	9,57,81,30,255
-im712	db	9,12,63,28,255
-im713	db	37,12,3,61,16,255
-im714	db	9,51,16,60,16,255
-im715	db	13,57,81,26,255
-im716	db	9,4,53,16,58,82,255
-im717	db	5,8,56,12,82,255
-im718	db	13,51,8,16,58,82,255
-im719	db	33,8,56,12,82,255
-im720	db	8,56,12,255
-im721	db	9,57,16,14,255
-im722	db	9,12,3,16,58,82,255
-im723	db	5,8,56,3,28,255
-im724	db	13,57,16,24,255
-im725	db	13,57,16,8,255
-im726	db	9,16,57,16,14,255
-im727	db	13,58,82,58,82,255
-im728	db	9,4,58,82,54,255
-im729	db	12,12,12,255
-im730	db	37,12,56,16,8,255
-im731	db	9,4,10,58,82,255
-im732	db	13,4,60,82,52,255
-im733	db	5,8,59,81,14,255
-im734	db	37,4,56,82,56,82,255
-im735	db	13,59,3,68,82,255
-im736	db	13,58,82,58,255
-im737	db	5,55,81,59,16,255
-im738	db	37,8,56,16,12,255
-im739	db	5,8,24,58,16,255
-im740	db	9,12,56,3,10,255
-im741	db	13,64,82,4,255
-im742	db	37,4,29,64,82,255
-im743	db	33,4,29,64,82,255
-im744	db	5,4,58,82,54,255
-im745	db	13,58,82,58,16,255
-im746	db	45,4,3,51,64,82,255
-im747	db	5,4,58,82,28,255
-im748	db	9,4,60,82,52,255
-im749	db	13,7,4,64,82,255
-im750	db	13,51,4,64,82,255
-im751	db	9,4,25,64,82,255
-im752	db	33,4,56,82,56,255
-im753	db	9,64,82,4,255
-im754	db	9,12,50,3,59,16,255
-im755	db	33,4,25,64,82,255
-im756	db	13,4,3,64,82,255
-im757	db	45,4,3,64,82,255
-im758	db	9,51,4,64,82,255
-im759	db	13,4,64,82,255
-im760	db	45,4,64,82,255
-im761	db	41,4,3,64,82,255
-im762	db	5,51,4,64,82,255
-im763	db	9,4,64,82,255
-im764	db	41,4,64,82,255
-im765	db	5,4,64,82,255
-im766	db	37,4,64,82,255
-im767	db	33,4,64,82,255
-im768	db	4,64,255
-im769	db	5,65,16,255
-im770	db	37,4,64,16,255
-im771	db	5,4,64,16,255
-im772	db	41,4,64,16,255
-im773	db	5,8,65,16,255
-im774	db	5,4,64,6,255
-im775	db	41,4,3,64,16,255
-im776	db	45,4,64,16,255
-im777	db	5,12,65,16,255
-im778	db	5,8,65,20,255
-im779	db	45,4,3,64,16,255
-im780	db	5,4,64,10,255
-im781	db	5,10,65,16,255
-im782	db	37,4,64,82,14,255
-im783	db	9,64,16,4,255
-im784	db	5,56,65,16,255
-im785	db	5,57,3,57,16,255
-im786	db	5,12,65,20,255
-im787	db	5,56,16,65,16,255
-im788	db	5,8,65,24,255
-im789	db	5,4,64,82,14,255
-im790	db	37,8,58,82,8,255
-im791	db	13,56,16,58,82,255
-im792	db	5,4,64,14,255
-im793	db	5,14,65,16,255
-im794	db	37,4,29,64,16,255
-im795	db	9,59,81,26,255
-im796	db	41,4,3,64,10,255
-im797	db	5,14,58,82,255
-im798	db	37,8,58,8,82,255
-im799	db	33,4,28,58,82,255
-im800	db	8,58,8,255
-im801	db	9,59,16,10,255
-im802	db	37,8,58,3,24,255
-im803	db	5,14,58,16,255
-im804	db	5,12,65,24,255
-im805	db	9,59,16,8,255
-im806	db	5,14,58,6,255
-im807	db	5,65,81,8,28,255
-im808	db	5,8,65,28,255
-im809	db	13,56,16,58,16,255
-im810	db	37,8,58,16,8,255
-im811	db	5,8,28,65,16,255
-im812	db	5,8,58,3,10,255
-im813	db	5,8,59,3,14,255
-im814	db	9,16,15,62,16,255
-im815	db	5,8,58,16,8,255
-im816	db	5,4,56,16,56,255
-im817	db	5,57,16,57,16,255
-im818	db	37,4,56,3,56,16,255
-im819	db	5,8,59,81,30,255
-im820	db	5,53,16,60,82,255
-im821	db	5,8,57,16,57,16,255
-im822	db	9,51,4,16,60,82,255
-im823	db	13,24,60,82,255
-im824	db	45,8,16,60,82,255
-im825	db	9,8,58,16,8,255
-im826	db	5,51,6,60,82,255
-im827	db	9,28,60,82,255
-im828	db	41,12,16,60,82,255
-im829	db	5,10,60,82,255
-im830	db	37,4,28,58,82,255
-im831	db	33,4,24,60,82,255
-im832	db	41,12,16,60,255
-im833	db	5,11,61,16,255
-im834	db	37,4,28,58,16,255
-im835	db	5,10,60,16,255
-im836	db	41,12,16,60,16,255
-im837	db	45,8,3,61,16,255
-im838	db	5,10,60,6,255
-im839	db	5,65,81,12,28,255
-im840	db	5,12,65,28,255
-im841	db	41,12,3,61,16,255
-im842	db	5,8,50,3,61,16,255
-im843	db	5,12,28,65,16,255
-im844	db	5,53,16,60,16,255
-im845	db	9,12,59,16,8,255
-im846	db	13,51,12,16,58,82,255
-im847	db	5,65,81,8,56,16,255
-im848	db	5,8,56,65,16,255
-im849	db	5,12,59,3,14,255
-im850	db	41,12,3,61,20,255
-im851	db	5,8,56,16,65,16,255
-im852	db	41,12,58,82,4,255
-im853	db	5,8,57,3,57,16,255
-im854	db	41,12,3,16,61,16,255
-im855	db	5,59,81,30,255
-im856	db	9,12,16,54,82,54,255
-im857	db	5,15,16,58,16,255
-im858	db	37,12,58,82,4,255
-im859	db	9,58,82,58,82,255
-im860	db	13,8,16,56,82,52,255
-im861	db	13,59,81,22,255
-im862	db	37,4,58,12,82,255
-im863	db	33,4,58,12,82,255
-im864	db	4,58,12,255
-im865	db	5,59,16,14,255
-im866	db	13,59,16,20,255
-im867	db	13,59,16,4,255
-im868	db	13,59,16,52,82,255
-im869	db	9,58,82,58,16,255
-im870	db	5,12,58,3,6,255
-im871	db	13,60,82,56,82,255
-im872	db	5,59,16,28,255
-im873	db	5,59,16,12,255
-im874	db	9,12,58,3,6,255
-im875	db	5,62,82,33,54,82,255
-im876	db	9,12,16,56,82,52,255
-im877	db	9,12,16,3,60,82,255
-im878	db	13,8,16,51,60,82,255
-im879	db	13,57,3,68,82,255
-im880	db	13,60,82,56,255
-im881	db	13,57,81,68,82,255
-im882	db	13,12,58,3,6,255
-im883	db	5,11,16,60,82,255
-im884	db	13,8,59,16,52,82,255
-im885	db	41,4,16,3,62,82,255
-im886	db	9,12,16,51,60,82,255
-im887	db	13,8,16,60,82,255
-im888	db	5,4,58,3,14,255
-im889	db	13,60,82,56,16,255
-im890	db	5,51,16,62,82,255
-im891	db	9,12,16,60,82,255
-im892	db	41,4,16,62,82,255
-im893	db	5,6,62,82,255
-im894	db	37,8,16,62,82,255
-im895	db	33,54,82,62,82,255
-im896	db	9,12,16,60,255
-im897	db	45,81,63,16,255
-im898	db	37,8,16,62,16,255
-im899	db	41,4,3,63,16,255
-im900	db	41,4,16,62,16,255
-im901	db	9,12,16,60,16,255
-im902	db	5,51,16,62,16,255
-im903	db	5,12,65,81,56,16,255
-im904	db	33,63,16,54,82,255
-im905	db	9,12,3,61,16,255
-im906	db	9,12,16,60,6,255
-im907	db	41,4,16,3,62,16,255
-im908	db	9,12,53,16,58,82,255
-im909	db	5,8,59,16,12,255
-im910	db	9,12,16,33,60,16,255
-im911	db	5,65,81,12,56,16,255
-im912	db	5,12,56,65,16,255
-im913	db	5,65,3,12,56,16,255
-im914	db	9,12,3,61,20,255
-im915	db	5,12,61,81,26,255
-im916	db	9,12,16,60,10,255
-im917	db	5,62,16,33,54,82,255
-im918	db	5,4,58,6,12,255
-im919	db	13,8,24,58,82,255
-im920	db	33,4,63,16,54,82,255
-im921	db	5,12,57,3,57,16,255
-im922	db	33,8,3,10,58,82,255
-im923	db	9,4,28,58,82,255
-im924	db	5,59,25,68,82,255
-im925	db	5,58,82,58,82,255
-im926	db	5,59,21,68,82,255
-im927	db	5,59,3,68,82,255
-im928	db	5,58,82,58,255
-im929	db	5,59,81,68,82,255
-im930	db	5,12,12,65,20,255
-im931	db	5,58,82,58,16,255
-im932	db	9,12,3,61,24,255
-im933	db	9,12,61,81,22,255
-im934	db	9,16,25,59,16,255
-im935	db	5,8,61,81,26,255
-im936	db	5,12,59,16,28,255
-im937	db	9,12,11,59,16,255
-im938	db	13,16,21,59,16,255
-im939	db	9,60,82,56,82,255
-im940	db	41,4,60,82,8,255
-im941	db	9,12,16,28,28,255
-im942	db	9,16,61,81,22,255
-im943	db	13,68,31,82,255
-im944	db	9,60,82,56,255
-im945	db	9,57,81,68,82,255
-im946	db	9,12,11,59,20,255
-im947	db	13,16,3,16,58,16,255
-im948	db	13,4,3,16,60,82,255
-im949	db	9,60,82,56,16,255
-im950	db	9,51,8,16,60,82,255
-im951	db	13,15,68,82,255
-im952	db	13,62,82,54,255
-im953	db	13,55,81,68,82,255
-im954	db	5,51,12,16,60,82,255
-im955	db	5,61,81,26,255
-im956	db	41,60,3,56,82,255
-im957	db	9,61,81,22,255
-im958	db	37,58,82,58,82,255
-im959	db	33,56,82,60,82,255
-im960	db	4,60,8,255
-im961	db	5,61,16,10,255
-im962	db	9,61,16,20,255
-im963	db	9,61,16,4,255
-im964	db	5,61,16,24,255
-im965	db	5,61,16,8,255
-im966	db	5,8,60,3,6,255
-im967	db	33,60,3,16,54,82,255
-im968	db	9,12,3,61,28,255
-im969	db	5,8,60,16,4,255
-im970	db	9,8,60,3,6,255
-im971	db	9,12,16,24,56,82,255
-im972	db	5,4,60,3,10,255
-im973	db	5,60,82,56,82,255
-im974	db	5,15,51,68,82,255
-im975	db	5,57,3,68,82,255
-im976	db	5,60,82,56,255
-im977	db	5,57,81,68,82,255
-im978	db	9,12,61,16,20,255
-im979	db	9,68,31,82,255
-im980	db	5,8,61,16,24,255
-im981	db	33,63,81,8,81,14,255
-im982	db	5,51,62,82,28,255
-im983	db	9,15,68,82,255
-im984	db	9,62,82,54,255
-im985	db	9,55,81,68,82,255
-im986	db	13,50,11,66,82,255
-im987	db	13,11,68,82,255
-im988	db	13,64,82,52,255
-im989	db	9,62,82,28,255
-im990	db	37,58,3,58,82,255
-im991	db	33,58,3,58,82,255
-im992	db	33,58,82,58,255
-im993	db	33,58,82,58,16,255
-im994	db	37,60,82,56,16,255
-im995	db	33,59,81,4,59,16,255
-im996	db	5,12,61,16,24,255
-im997	db	13,64,82,24,255
-im998	db	5,50,15,66,82,255
-im999	db	5,15,68,82,255
-im1000	db	5,62,82,54,255
-im1001	db	5,55,81,68,82,255
-im1002	db	5,29,51,68,82,255
-im1003	db	5,62,82,28,255
-im1004	db	9,64,82,52,255
-im1005	db	13,7,68,82,255
-im1006	db	13,51,68,82,255
-im1007	db	13,29,68,82,255
-im1008	db	33,60,82,56,255
-im1009	db	9,64,82,24,255
-im1010	db	37,62,82,28,255
-im1011	db	5,11,68,82,255
-im1012	db	5,64,82,52,255
-im1013	db	5,29,68,82,255
-im1014	db	9,51,68,82,255
-im1015	db	13,68,82,255
-im1016	db	45,68,82,255
-im1017	db	45,81,68,82,255
-im1018	db	5,51,68,82,255
-im1019	db	9,68,82,255
-im1020	db	41,68,82,255
-im1021	db	5,68,82,255
-im1022	db	37,68,82,255
-im1023	db	33,68,82,255
-im1024	db	68,255
-im1025	db	33,68,16,255
-im1026	db	37,68,16,255
-im1027	db	5,68,16,255
-im1028	db	41,68,16,255
-im1029	db	9,68,16,255
-im1030	db	5,68,6,255
-im1031	db	45,81,68,16,255
-im1032	db	45,68,16,255
-im1033	db	13,68,16,255
-im1034	db	9,68,6,255
-im1035	db	37,12,16,67,16,255
-im1036	db	5,68,10,255
-im1037	db	41,12,16,65,16,255
-im1038	db	37,68,82,14,255
-im1039	db	5,64,16,24,255
-im1040	db	33,56,69,16,255
-im1041	db	45,12,16,63,16,255
-im1042	db	13,68,6,255
-im1043	db	13,7,68,16,255
-im1044	db	9,68,10,255
-im1045	db	5,68,82,14,255
-im1046	db	37,12,16,67,20,255
-im1047	db	33,69,81,4,28,255
-im1048	db	5,68,14,255
-im1049	db	9,64,16,24,255
-im1050	db	41,12,16,65,20,255
-im1051	db	5,62,16,28,255
-im1052	db	41,68,82,14,255
-im1053	db	5,12,14,58,82,255
-im1054	db	37,58,82,67,16,255
-im1055	db	33,58,16,58,82,255
-im1056	db	33,58,16,58,255
-im1057	db	33,58,16,58,16,255
-im1058	db	37,58,16,67,16,255
-im1059	db	9,68,82,14,255
-im1060	db	13,68,10,255
-im1061	db	13,11,68,16,255
-im1062	db	37,12,24,67,16,255
-im1063	db	33,69,81,8,28,255
-im1064	db	9,68,14,255
-im1065	db	9,15,68,16,255
-im1066	db	37,8,28,67,16,255
-im1067	db	9,12,54,82,56,82,255
-im1068	db	37,12,16,67,24,255
-im1069	db	9,62,16,28,255
-im1070	db	37,4,56,82,67,16,255
-im1071	db	13,62,82,12,255
-im1072	db	5,60,16,56,255
-im1073	db	5,57,3,68,16,255
-im1074	db	37,4,56,16,67,16,255
-im1075	db	5,60,16,56,16,255
-im1076	db	5,8,53,16,60,82,255
-im1077	db	5,12,29,62,82,255
-im1078	db	37,12,29,62,82,255
-im1079	db	13,28,60,82,255
-im1080	db	13,12,56,82,54,255
-im1081	db	9,12,57,81,62,82,255
-im1082	db	13,16,57,81,14,255
-im1083	db	9,4,24,60,82,255
-im1084	db	41,10,60,82,255
-im1085	db	5,8,10,60,82,255
-im1086	db	37,14,60,82,255
-im1087	db	13,68,82,14,255
-im1088	db	45,12,16,60,255
-im1089	db	13,29,61,16,255
-im1090	db	37,14,60,16,255
-im1091	db	5,60,3,56,16,255
-im1092	db	41,10,60,16,255
-im1093	db	9,60,3,56,16,255
-im1094	db	37,12,54,82,67,16,255
-im1095	db	33,69,81,12,28,255
-im1096	db	13,68,14,255
-im1097	db	45,12,3,61,16,255
-im1098	db	37,12,28,67,16,255
-im1099	db	9,60,16,56,82,255
-im1100	db	5,8,53,16,60,16,255
-im1101	db	5,12,54,82,56,82,255
-im1102	db	37,8,56,82,67,16,255
-im1103	db	9,57,81,68,16,255
-im1104	db	9,60,16,56,255
-im1105	db	13,62,16,28,255
-im1106	db	45,12,3,61,20,255
-im1107	db	9,62,82,12,255
-im1108	db	45,12,25,62,82,255
-im1109	db	9,60,16,56,16,255
-im1110	db	5,51,12,56,82,28,255
-im1111	db	9,12,25,62,82,255
-im1112	db	9,12,56,82,54,255
-im1113	db	5,12,25,62,82,255
-im1114	db	37,12,25,62,82,255
-im1115	db	33,12,25,62,82,255
-im1116	db	13,12,58,82,52,255
-im1117	db	5,58,16,58,82,255
-im1118	db	45,12,3,51,62,82,255
-im1119	db	5,59,81,68,16,255
-im1120	db	5,58,16,58,255
-im1121	db	9,59,14,82,255
-im1122	db	37,4,58,16,67,16,255
-im1123	db	5,58,16,58,16,255
-im1124	db	9,12,3,51,62,82,255
-im1125	db	5,62,82,12,255
-im1126	db	45,12,21,62,82,255
-im1127	db	5,15,12,62,82,255
-im1128	db	5,12,56,82,54,255
-im1129	db	9,12,59,14,82,255
-im1130	db	41,12,21,62,82,255
-im1131	db	5,12,56,82,28,255
-im1132	db	9,12,58,82,52,255
-im1133	db	33,12,21,62,82,255
-im1134	db	13,51,12,62,82,255
-im1135	db	45,12,3,62,82,255
-im1136	db	33,12,54,82,56,255
-im1137	db	13,55,81,57,16,255
-im1138	db	9,12,3,62,82,255
-im1139	db	41,12,3,62,82,255
-im1140	db	5,12,3,62,82,255
-im1141	db	37,12,3,62,82,255
-im1142	db	33,12,3,62,82,255
-im1143	db	13,12,62,82,255
-im1144	db	45,12,62,82,255
-im1145	db	45,81,12,62,82,255
-im1146	db	5,51,12,62,82,255
-im1147	db	9,12,62,82,255
-im1148	db	41,12,62,82,255
-im1149	db	5,12,62,82,255
-im1150	db	37,12,62,82,255
-im1151	db	33,12,62,82,255
-im1152	db	12,62,255
-im1153	db	13,63,16,255
-im1154	db	37,12,62,16,255
-im1155	db	5,12,62,16,255
-im1156	db	41,12,62,16,255
-im1157	db	9,12,62,16,255
-im1158	db	5,12,62,6,255
-im1159	db	45,81,12,62,16,255
-im1160	db	45,12,62,16,255
-im1161	db	13,12,62,16,255
-im1162	db	13,16,63,16,255
-im1163	db	37,12,3,62,16,255
-im1164	db	5,12,62,10,255
-im1165	db	41,12,3,62,16,255
-im1166	db	9,12,3,62,16,255
-im1167	db	33,12,28,56,82,255
-im1168	db	13,14,56,255
-im1169	db	45,12,3,62,16,255
-im1170	db	13,12,62,6,255
-im1171	db	13,6,63,16,255
-im1172	db	9,12,62,10,255
-im1173	db	5,12,62,82,14,255
-im1174	db	37,12,3,62,6,255
-im1175	db	13,10,58,82,255
-im1176	db	5,12,62,14,255
-im1177	db	13,14,56,16,255
-im1178	db	41,12,3,62,6,255
-im1179	db	5,62,16,12,255
-im1180	db	9,12,3,62,6,255
-im1181	db	9,12,11,62,16,255
-im1182	db	37,12,28,56,82,255
-im1183	db	33,12,24,58,82,255
-im1184	db	13,10,58,255
-im1185	db	13,11,59,16,255
-im1186	db	45,12,3,62,6,255
-im1187	db	9,12,62,82,14,255
-im1188	db	13,12,62,10,255
-im1189	db	13,10,63,16,255
-im1190	db	37,12,25,62,16,255
-im1191	db	13,63,81,8,28,255
-im1192	db	9,12,62,14,255
-im1193	db	13,10,58,16,255
-im1194	db	5,12,50,29,14,255
-im1195	db	9,8,56,3,56,82,255
-im1196	db	37,12,3,62,10,255
-im1197	db	9,62,16,12,255
-im1198	db	13,51,16,60,82,255
-im1199	db	13,8,64,31,82,255
-im1200	db	5,12,28,56,255
-im1201	db	9,12,15,62,16,255
-im1202	db	13,8,3,16,60,82,255
-im1203	db	5,12,28,56,16,255
-im1204	db	41,12,3,62,10,255
-im1205	db	9,8,56,82,56,16,255
-im1206	db	33,12,3,16,60,82,255
-im1207	db	13,6,60,82,255
-im1208	db	13,8,58,82,54,255
-im1209	db	5,12,29,57,16,255
-im1210	db	5,66,82,61,20,255
-im1211	db	9,12,6,60,82,255
-im1212	db	13,4,53,16,58,82,255
-im1213	db	5,56,16,60,82,255
-im1214	db	37,4,14,60,82,255
-im1215	db	33,12,20,60,82,255
-im1216	db	13,6,60,255
-im1217	db	13,7,61,16,255
-im1218	db	37,4,14,60,16,255
-im1219	db	5,56,16,60,16,255
-im1220	db	13,53,16,58,16,255
-im1221	db	9,12,6,60,16,255
-im1222	db	13,16,63,81,28,255
-im1223	db	13,63,81,12,28,255
-im1224	db	13,12,62,14,255
-im1225	db	13,6,60,16,255
-im1226	db	13,16,3,61,16,255
-im1227	db	5,12,29,62,16,255
-im1228	db	41,12,29,62,16,255
-im1229	db	9,12,29,62,16,255
-im1230	db	9,12,16,3,61,16,255
-im1231	db	13,8,29,64,82,255
-im1232	db	9,12,28,56,255
-im1233	db	13,62,16,12,255
-im1234	db	13,51,16,60,16,255
-im1235	db	13,64,82,8,255
-im1236	db	41,8,29,64,82,255
-im1237	db	5,8,29,64,82,255
-im1238	db	37,8,29,64,82,255
-im1239	db	33,8,29,64,82,255
-im1240	db	9,8,58,82,54,255
-im1241	db	9,12,29,57,16,255
-im1242	db	12,9,62,6,255
-im1243	db	13,11,8,64,82,255
-im1244	db	13,8,60,82,52,255
-im1245	db	9,8,58,82,28,255
-im1246	db	37,8,56,82,56,82,255
-im1247	db	33,8,54,82,58,82,255
-im1248	db	5,12,24,58,255
-im1249	db	9,55,81,59,16,255
-im1250	db	37,8,56,82,56,16,255
-im1251	db	9,12,56,82,12,255
-im1252	db	13,8,3,51,64,82,255
-im1253	db	9,12,61,81,10,255
-im1254	db	45,8,3,51,64,82,255
-im1255	db	9,64,82,8,255
-im1256	db	5,8,58,82,54,255
-im1257	db	5,8,25,64,82,255
-im1258	db	37,8,25,64,82,255
-im1259	db	33,8,25,64,82,255
-im1260	db	9,8,60,82,52,255
-im1261	db	13,16,3,62,82,255
-im1262	db	13,51,8,64,82,255
-im1263	db	5,8,11,64,82,255
-im1264	db	33,8,56,82,56,255
-im1265	db	5,64,82,8,255
-im1266	db	13,8,3,64,82,255
-im1267	db	45,8,3,64,82,255
-im1268	db	5,8,60,82,52,255
-im1269	db	33,8,21,64,82,255
-im1270	db	9,51,8,64,82,255
-im1271	db	13,8,64,82,255
-im1272	db	45,8,64,82,255
-im1273	db	37,8,3,64,82,255
-im1274	db	33,8,3,64,82,255
-im1275	db	9,8,64,82,255
-im1276	db	41,8,64,82,255
-im1277	db	5,8,64,82,255
-im1278	db	37,8,64,82,255
-im1279	db	33,8,64,82,255
-im1280	db	8,64,255
-im1281	db	9,65,16,255
-im1282	db	37,8,64,16,255
-im1283	db	5,8,64,16,255
-im1284	db	41,8,64,16,255
-im1285	db	9,8,64,16,255
-im1286	db	9,16,65,16,255
-im1287	db	37,8,3,64,16,255
-im1288	db	45,8,64,16,255
-im1289	db	9,12,65,16,255
-im1290	db	9,8,64,6,255
-im1291	db	9,6,65,16,255
-im1292	db	5,8,64,10,255
-im1293	db	45,8,3,64,16,255
-im1294	db	9,12,16,65,16,255
-im1295	db	5,64,16,8,255
-im1296	db	12,56,12,255
-im1297	db	13,57,16,14,255
-im1298	db	9,12,65,20,255
-im1299	db	13,16,3,62,16,255
-im1300	db	9,8,64,10,255
-im1301	db	9,10,65,16,255
-im1302	db	37,8,25,64,16,255
-im1303	db	13,58,16,58,82,255
-im1304	db	5,8,64,14,255
-im1305	db	9,64,16,8,255
-im1306	db	45,8,3,64,6,255
-im1307	db	9,14,58,82,255
-im1308	db	9,12,16,65,20,255
-im1309	db	5,8,15,64,16,255
-im1310	db	37,8,56,16,56,82,255
-im1311	db	33,8,28,58,82,255
-im1312	db	9,14,58,255
-im1313	db	9,15,59,16,255
-im1314	db	37,12,56,16,12,255
-im1315	db	9,8,64,82,14,255
-im1316	db	9,12,65,24,255
-im1317	db	9,14,58,16,255
-im1318	db	13,16,3,62,6,255
-im1319	db	9,65,81,8,28,255
-im1320	db	9,8,64,14,255
-im1321	db	9,14,65,16,255
-im1322	db	37,8,29,64,16,255
-im1323	db	5,12,56,16,12,255
-im1324	db	9,53,16,60,82,255
-im1325	db	13,64,16,8,255
-im1326	db	13,51,4,16,60,82,255
-im1327	db	5,57,81,8,64,16,255
-im1328	db	5,8,56,16,56,255
-im1329	db	9,12,14,65,16,255
-im1330	db	8,9,64,6,255
-im1331	db	5,8,56,16,56,16,255
-im1332	db	5,12,3,16,60,82,255
-im1333	db	5,8,57,3,64,16,255
-im1334	db	9,16,59,3,14,255
-im1335	db	13,4,6,60,82,255
-im1336	db	9,12,16,65,24,255
-im1337	db	5,61,81,34,54,82,255
-im1338	db	5,61,81,14,82,255
-im1339	db	9,10,60,82,255
-im1340	db	41,8,10,60,82,255
-im1341	db	9,12,56,16,12,255
-im1342	db	37,8,14,60,82,255
-im1343	db	33,8,24,60,82,255
-im1344	db	9,10,60,255
-im1345	db	5,61,14,82,255
-im1346	db	37,8,14,60,16,255
-im1347	db	5,4,61,14,82,255
-im1348	db	9,12,52,3,59,16,255
-im1349	db	9,10,60,16,255
-im1350	db	5,12,28,50,12,255
-im1351	db	9,65,81,12,28,255
-im1352	db	9,12,65,28,255
-im1353	db	9,65,3,12,28,255
-im1354	db	9,10,60,6,255
-im1355	db	9,8,56,16,56,82,255
-im1356	db	5,12,3,16,60,16,255
-im1357	db	9,12,28,65,16,255
-im1358	db	9,14,3,58,16,255
-im1359	db	9,12,59,81,30,255
-im1360	db	9,8,56,16,56,255
-im1361	db	9,57,16,57,16,255
-im1362	db	5,12,50,3,61,16,255
-im1363	db	5,8,56,3,56,16,255
-im1364	db	9,53,16,60,16,255
-im1365	db	9,8,56,16,56,16,255
-im1366	db	9,11,16,61,16,255
-im1367	db	9,15,4,16,58,82,255
-im1368	db	13,12,56,3,14,255
-im1369	db	9,12,57,16,57,16,255
-im1370	db	8,13,64,6,255
-im1371	db	9,4,14,58,82,255
-im1372	db	13,60,82,63,24,255
-im1373	db	5,8,28,58,82,255
-im1374	db	5,12,11,16,61,16,255
-im1375	db	5,59,81,8,64,16,255
-im1376	db	5,8,28,58,255
-im1377	db	13,12,56,16,12,255
-im1378	db	13,31,16,57,16,255
-im1379	db	5,8,28,58,16,255
-im1380	db	8,9,64,10,255
-im1381	db	5,8,29,59,16,255
-im1382	db	5,8,28,58,6,255
-im1383	db	13,4,58,82,56,82,255
-im1384	db	5,8,61,16,54,82,255
-im1385	db	9,15,16,58,16,255
-im1386	db	9,16,59,81,30,255
-im1387	db	9,11,16,60,82,255
-im1388	db	13,20,3,62,82,255
-im1389	db	13,4,57,3,66,82,255
-im1390	db	13,16,59,81,26,255
-im1391	db	13,57,3,4,66,82,255
-im1392	db	13,4,58,82,56,255
-im1393	db	13,57,81,4,66,82,255
-im1394	db	5,28,3,62,82,255
-im1395	db	9,8,58,82,12,255
-im1396	db	5,64,82,63,24,255
-im1397	db	37,12,16,33,62,82,255
-im1398	db	9,51,16,62,82,255
-im1399	db	13,20,62,82,255
-im1400	db	45,4,16,62,82,255
-im1401	db	5,12,59,81,57,16,255
-im1402	db	33,8,3,16,62,82,255
-im1403	db	9,6,62,82,255
-im1404	db	13,12,53,16,58,82,255
-im1405	db	5,28,62,82,255
-im1406	db	37,12,16,62,82,255
-im1407	db	33,4,14,62,82,255
-im1408	db	37,12,16,62,255
-im1409	db	5,29,63,16,255
-im1410	db	37,12,16,62,16,255
-im1411	db	45,4,3,63,16,255
-im1412	db	37,12,16,62,6,255
-im1413	db	9,6,62,16,255
-im1414	db	9,16,3,63,16,255
-im1415	db	9,12,58,82,8,255
-im1416	db	45,4,16,62,16,255
-im1417	db	37,12,3,63,16,255
-im1418	db	9,51,16,62,16,255
-im1419	db	9,12,56,82,65,16,255
-im1420	db	41,12,58,82,8,255
-im1421	db	37,12,16,3,62,16,255
-im1422	db	37,8,58,82,12,255
-im1423	db	9,65,81,12,56,16,255
-im1424	db	9,12,56,65,16,255
-im1425	db	5,12,58,82,8,255
-im1426	db	37,12,3,63,20,255
-im1427	db	45,4,16,3,62,16,255
-im1428	db	37,12,3,16,63,16,255
-im1429	db	9,12,56,16,65,16,255
-im1430	db	37,12,58,82,8,255
-im1431	db	9,59,81,30,255
-im1432	db	45,4,3,63,28,255
-im1433	db	9,12,57,3,57,16,255
-im1434	db	13,16,29,57,16,255
-im1435	db	13,59,81,26,255
-im1436	db	41,8,58,12,82,255
-im1437	db	5,8,58,12,82,255
-im1438	db	37,8,58,12,82,255
-im1439	db	33,8,58,12,82,255
-im1440	db	8,58,12,255
-im1441	db	9,59,16,14,255
-im1442	db	37,8,58,3,28,255
-im1443	db	5,8,58,3,28,255
-im1444	db	13,59,16,24,255
-im1445	db	13,59,16,8,255
-im1446	db	9,16,59,16,14,255
-im1447	db	13,59,81,4,16,24,255
-im1448	db	9,59,16,28,255
-im1449	db	9,59,16,12,255
-im1450	db	37,12,58,16,8,255
-im1451	db	9,4,58,82,56,82,255
-im1452	db	5,12,58,3,10,255
-im1453	db	9,4,57,3,66,82,255
-im1454	db	13,51,8,16,60,82,255
-im1455	db	5,12,58,16,8,255
-im1456	db	9,4,58,82,56,255
-im1457	db	9,57,81,4,66,82,255
-im1458	db	9,12,3,16,60,82,255
-im1459	db	9,4,57,81,66,82,255
-im1460	db	9,12,58,3,10,255
-im1461	db	13,4,15,66,82,255
-im1462	db	33,12,3,24,58,82,255
-im1463	db	13,58,82,60,82,255
-im1464	db	13,4,60,82,54,255
-im1465	db	9,12,58,16,8,255
-im1466	db	33,8,3,28,58,82,255
-im1467	db	5,8,58,16,12,255
-im1468	db	41,4,58,82,56,82,255
-im1469	db	5,8,24,60,82,255
-im1470	db	37,4,56,82,58,82,255
-im1471	db	13,61,3,70,82,255
-im1472	db	13,58,82,60,255
-im1473	db	5,55,81,61,16,255
-im1474	db	37,4,56,82,58,16,255
-im1475	db	5,8,24,60,16,255
-im1476	db	13,12,58,3,10,255
-im1477	db	5,8,25,61,16,255
-im1478	db	9,16,15,59,16,255
-im1479	db	13,4,56,3,58,82,255
-im1480	db	9,8,58,3,14,255
-im1481	db	13,58,82,60,16,255
-im1482	db	13,51,66,82,4,255
-im1483	db	9,4,56,3,58,82,255
-im1484	db	41,4,56,3,58,82,255
-im1485	db	9,8,58,16,12,255
-im1486	db	9,12,3,16,60,16,255
-im1487	db	33,4,56,3,58,82,255
-im1488	db	5,4,58,82,56,255
-im1489	db	5,57,81,4,66,82,255
-im1490	db	9,12,50,3,61,16,255
-im1491	db	9,4,66,31,82,255
-im1492	db	5,8,52,3,61,16,255
-im1493	db	9,4,15,66,82,255
-im1494	db	9,16,59,16,12,255
-im1495	db	9,15,4,66,82,255
-im1496	db	9,4,60,82,54,255
-im1497	db	13,4,11,66,82,255
-im1498	db	33,4,59,21,66,82,255
-im1499	db	13,11,4,66,82,255
-im1500	db	13,4,62,82,52,255
-im1501	db	5,8,61,81,14,255
-im1502	db	37,4,58,82,56,82,255
-im1503	db	13,4,29,66,82,255
-im1504	db	33,4,56,82,58,255
-im1505	db	5,57,81,59,16,255
-im1506	db	37,4,58,82,56,16,255
-im1507	db	9,4,29,66,82,255
-im1508	db	41,4,60,82,28,255
-im1509	db	13,66,82,4,255
-im1510	db	37,4,29,66,82,255
-im1511	db	33,4,29,66,82,255
-im1512	db	5,4,60,82,54,255
-im1513	db	9,4,11,66,82,255
-im1514	db	45,4,3,51,66,82,255
-im1515	db	5,4,60,82,28,255
-im1516	db	9,4,62,82,52,255
-im1517	db	13,7,4,66,82,255
-im1518	db	13,51,4,66,82,255
-im1519	db	9,4,25,66,82,255
-im1520	db	33,4,58,82,56,255
-im1521	db	9,66,82,4,255
-im1522	db	37,4,60,82,28,255
-im1523	db	33,4,25,66,82,255
-im1524	db	13,4,3,66,82,255
-im1525	db	45,4,3,66,82,255
-im1526	db	9,51,4,66,82,255
-im1527	db	13,4,66,82,255
-im1528	db	45,4,66,82,255
-im1529	db	41,4,3,66,82,255
-im1530	db	5,51,4,66,82,255
-im1531	db	9,4,66,82,255
-im1532	db	41,4,66,82,255
-im1533	db	5,4,66,82,255
-im1534	db	37,4,66,82,255
-im1535	db	33,4,66,82,255
-im1536	db	4,66,255
-im1537	db	5,67,16,255
-im1538	db	37,4,66,16,255
-im1539	db	5,4,66,16,255
-im1540	db	41,4,66,16,255
-im1541	db	5,8,67,16,255
-im1542	db	5,4,66,6,255
-im1543	db	41,4,3,66,16,255
-im1544	db	45,4,66,16,255
-im1545	db	5,12,67,16,255
-im1546	db	5,8,67,20,255
-im1547	db	45,4,3,66,16,255
-im1548	db	5,4,66,10,255
-im1549	db	5,10,67,16,255
-im1550	db	37,4,66,82,14,255
-im1551	db	9,66,16,4,255
-im1552	db	5,56,67,16,255
-im1553	db	5,59,3,57,16,255
-im1554	db	5,12,67,20,255
-im1555	db	5,56,16,67,16,255
-im1556	db	5,8,67,24,255
-im1557	db	5,4,66,82,14,255
-im1558	db	45,4,3,66,6,255
-im1559	db	5,67,81,4,28,255
-im1560	db	5,4,66,14,255
-im1561	db	5,14,67,16,255
-im1562	db	37,4,29,66,16,255
-im1563	db	13,66,16,4,255
-im1564	db	41,4,3,66,10,255
-im1565	db	5,58,82,67,16,255
-im1566	db	37,4,58,16,56,82,255
-im1567	db	5,67,81,58,16,255
-im1568	db	5,58,67,16,255
-im1569	db	5,57,3,59,16,255
-im1570	db	37,4,58,16,56,16,255
-im1571	db	5,58,16,67,16,255
-im1572	db	5,12,67,24,255
-im1573	db	5,67,3,12,24,255
-im1574	db	5,51,14,58,16,255
-im1575	db	5,67,81,8,28,255
-im1576	db	5,8,67,28,255
-im1577	db	5,67,3,8,28,255
-im1578	db	13,16,25,59,16,255
-im1579	db	5,8,28,67,16,255
-im1580	db	9,8,53,16,60,82,255
-im1581	db	5,8,61,3,14,255
-im1582	db	9,16,15,64,16,255
-im1583	db	5,57,81,4,66,16,255
-im1584	db	5,4,56,67,16,255
-im1585	db	5,57,16,59,16,255
-im1586	db	37,4,56,3,58,16,255
-im1587	db	5,4,56,16,67,16,255
-im1588	db	41,4,56,3,58,16,255
-im1589	db	5,8,57,16,59,16,255
-im1590	db	37,8,60,82,8,255
-im1591	db	13,56,16,60,82,255
-im1592	db	41,4,3,66,14,255
-im1593	db	5,12,57,16,59,16,255
-im1594	db	5,51,10,60,82,255
-im1595	db	9,61,81,26,255
-im1596	db	41,8,60,8,82,255
-im1597	db	5,14,60,82,255
-im1598	db	37,8,60,8,82,255
-im1599	db	33,4,28,60,82,255
-im1600	db	8,60,8,255
-im1601	db	9,61,16,10,255
-im1602	db	37,8,60,3,24,255
-im1603	db	5,14,60,16,255
-im1604	db	9,61,16,24,255
-im1605	db	9,61,16,8,255
-im1606	db	5,14,60,6,255
-im1607	db	5,67,81,12,28,255
-im1608	db	5,12,67,28,255
-im1609	db	13,56,16,60,16,255
-im1610	db	37,8,60,16,8,255
-im1611	db	5,12,28,67,16,255
-im1612	db	5,8,60,3,10,255
-im1613	db	5,8,56,82,67,16,255
-im1614	db	5,12,24,67,20,255
-im1615	db	5,8,60,16,8,255
-im1616	db	5,8,56,67,16,255
-im1617	db	5,12,61,3,14,255
-im1618	db	13,56,16,60,6,255
-im1619	db	5,8,56,16,67,16,255
-im1620	db	9,8,60,3,10,255
-im1621	db	5,8,59,3,57,16,255
-im1622	db	5,8,28,67,20,255
-im1623	db	5,12,59,81,16,56,16,255
-im1624	db	5,55,16,60,16,255
-im1625	db	9,8,60,16,8,255
-im1626	db	5,15,16,61,16,255
-im1627	db	5,8,58,3,16,14,255
-im1628	db	5,14,3,60,16,255
-im1629	db	5,4,56,16,58,82,255
-im1630	db	9,16,61,16,8,255
-im1631	db	5,59,81,4,66,16,255
-im1632	db	5,4,56,16,58,255
-im1633	db	5,59,16,57,16,255
-im1634	db	37,4,58,3,56,16,255
-im1635	db	5,4,56,16,58,16,255
-im1636	db	9,12,61,16,24,255
-im1637	db	5,8,59,16,57,16,255
-im1638	db	5,4,58,29,6,255
-im1639	db	5,15,16,60,82,255
-im1640	db	45,8,60,16,8,255
-im1641	db	5,12,59,16,57,16,255
-im1642	db	13,24,3,62,82,255
-im1643	db	45,8,16,3,62,82,255
-im1644	db	4,13,66,10,255
-im1645	db	9,12,61,16,8,255
-im1646	db	9,28,3,62,82,255
-im1647	db	5,12,61,81,30,255
-im1648	db	5,59,16,56,16,255
-im1649	db	5,55,16,3,60,16,255
-im1650	db	5,12,59,14,20,255
-im1651	db	41,12,16,33,62,82,255
-im1652	db	5,53,16,62,82,255
-im1653	db	13,50,3,16,62,82,255
-im1654	db	9,51,4,16,62,82,255
-im1655	db	13,24,62,82,255
-im1656	db	45,8,16,62,82,255
-im1657	db	33,4,50,3,16,62,82,255
-im1658	db	5,51,6,62,82,255
-im1659	db	9,28,62,82,255
-im1660	db	41,12,16,62,82,255
-im1661	db	5,10,62,82,255
-im1662	db	37,4,28,60,82,255
-im1663	db	33,4,24,62,82,255
-im1664	db	41,12,16,62,255
-im1665	db	5,11,63,16,255
-im1666	db	37,4,28,60,16,255
-im1667	db	5,10,62,16,255
-im1668	db	41,12,16,62,16,255
-im1669	db	45,8,3,63,16,255
-im1670	db	5,10,62,6,255
-im1671	db	5,12,67,81,56,16,255
-im1672	db	45,8,16,62,16,255
-im1673	db	41,12,3,63,16,255
-im1674	db	5,8,50,3,63,16,255
-im1675	db	37,12,16,3,63,16,255
-im1676	db	5,53,16,62,16,255
-im1677	db	5,12,56,82,67,16,255
-im1678	db	5,11,16,63,16,255
-im1679	db	5,67,81,12,56,16,255
-im1680	db	5,12,56,67,16,255
-im1681	db	5,67,3,12,56,16,255
-im1682	db	41,12,3,63,20,255
-im1683	db	5,8,61,81,30,255
-im1684	db	45,8,3,63,24,255
-im1685	db	45,8,16,3,62,16,255
-im1686	db	41,12,3,16,63,16,255
-im1687	db	5,8,24,3,61,16,255
-im1688	db	37,4,54,3,61,16,255
-im1689	db	5,12,59,3,57,16,255
-im1690	db	9,12,61,20,8,255
-im1691	db	5,8,67,81,58,16,255
-im1692	db	41,4,60,82,12,255
-im1693	db	5,8,58,82,67,16,255
-im1694	db	5,65,81,8,58,6,255
-im1695	db	5,67,81,8,58,16,255
-im1696	db	5,8,58,67,16,255
-im1697	db	5,67,3,8,58,16,255
-im1698	db	13,16,61,81,22,255
-im1699	db	5,8,58,16,67,16,255
-im1700	db	41,12,3,63,24,255
-im1701	db	5,4,60,82,12,255
-im1702	db	9,16,29,59,16,255
-im1703	db	41,12,16,5,62,16,255
-im1704	db	5,4,55,16,60,82,255
-im1705	db	13,60,82,33,58,82,255
-im1706	db	13,8,16,15,62,82,255
-im1707	db	9,12,16,54,82,56,82,255
-im1708	db	5,8,28,67,24,255
-im1709	db	41,12,3,59,3,10,255
-im1710	db	13,51,12,16,60,82,255
-im1711	db	13,8,16,62,31,82,255
-im1712	db	5,8,59,16,56,16,255
-im1713	db	9,12,60,82,4,255
-im1714	db	9,12,3,60,4,82,255
-im1715	db	37,12,3,59,81,26,255
-im1716	db	41,12,60,82,4,255
-im1717	db	5,8,59,16,33,56,16,255
-im1718	db	33,4,60,82,12,82,255
-im1719	db	5,61,81,30,255
-im1720	db	13,8,16,56,82,54,255
-im1721	db	37,8,3,24,60,82,255
-im1722	db	37,12,60,82,4,255
-im1723	db	9,58,82,60,82,255
-im1724	db	41,4,60,12,82,255
-im1725	db	13,61,81,22,255
-im1726	db	37,4,60,12,82,255
-im1727	db	33,4,60,12,82,255
-im1728	db	4,60,12,255
-im1729	db	5,61,16,14,255
-im1730	db	13,61,16,20,255
-im1731	db	13,61,16,4,255
-im1732	db	37,12,60,3,6,255
-im1733	db	9,58,82,60,16,255
-im1734	db	5,12,60,3,6,255
-im1735	db	13,61,81,8,16,20,255
-im1736	db	5,61,16,28,255
-im1737	db	5,61,16,12,255
-im1738	db	9,12,60,3,6,255
-im1739	db	37,12,3,60,3,20,255
-im1740	db	41,12,60,16,4,255
-im1741	db	13,61,3,8,16,20,255
-im1742	db	13,51,62,82,56,82,255
-im1743	db	9,12,60,16,4,255
-im1744	db	5,8,57,16,58,16,255
-im1745	db	5,61,3,16,28,255
-im1746	db	13,12,60,3,6,255
-im1747	db	9,12,16,62,31,82,255
-im1748	db	13,16,61,16,20,255
-im1749	db	13,61,3,12,16,20,255
-im1750	db	9,12,16,5,62,82,255
-im1751	db	13,60,82,58,82,255
-im1752	db	5,4,60,3,14,255
-im1753	db	5,8,61,16,3,10,255
-im1754	db	9,12,16,3,51,62,82,255
-im1755	db	5,4,60,16,12,255
-im1756	db	13,8,16,58,82,52,255
-im1757	db	9,64,82,33,54,82,255
-im1758	db	13,16,61,16,4,255
-im1759	db	13,59,3,70,82,255
-im1760	db	13,60,82,58,255
-im1761	db	13,59,81,70,82,255
-im1762	db	33,8,65,81,14,82,255
-im1763	db	45,4,3,59,16,10,255
-im1764	db	41,4,60,16,12,255
-im1765	db	5,31,16,60,82,255
-im1766	db	9,12,16,55,81,62,82,255
-im1767	db	33,4,29,16,60,82,255
-im1768	db	5,8,61,16,28,255
-im1769	db	13,60,82,58,16,255
-im1770	db	9,12,3,60,16,4,255
-im1771	db	5,64,82,33,54,82,255
-im1772	db	9,12,16,58,82,52,255
-im1773	db	5,8,61,16,12,255
-im1774	db	13,8,16,51,62,82,255
-im1775	db	45,4,3,59,16,8,255
-im1776	db	5,12,57,16,58,82,255
-im1777	db	5,61,3,8,16,28,255
-im1778	db	9,12,16,33,62,82,255
-im1779	db	5,11,16,62,82,255
-im1780	db	9,20,3,64,82,255
-im1781	db	41,4,16,3,64,82,255
-im1782	db	9,12,16,51,62,82,255
-im1783	db	13,8,16,62,82,255
-im1784	db	45,60,82,58,82,255
-im1785	db	45,81,34,64,82,255
-im1786	db	5,51,16,64,82,255
-im1787	db	9,12,16,62,82,255
-im1788	db	41,4,16,64,82,255
-im1789	db	5,6,64,82,255
-im1790	db	37,8,16,64,82,255
-im1791	db	33,54,82,64,82,255
-im1792	db	9,12,16,62,255
-im1793	db	45,81,65,16,255
-im1794	db	37,8,16,64,16,255
-im1795	db	41,4,3,65,16,255
-im1796	db	41,4,16,64,16,255
-im1797	db	9,12,16,62,16,255
-im1798	db	5,51,16,64,16,255
-im1799	db	45,81,34,64,16,255
-im1800	db	5,12,61,16,28,255
-im1801	db	9,12,3,63,16,255
-im1802	db	9,12,16,62,6,255
-im1803	db	41,4,16,3,64,16,255
-im1804	db	41,4,3,65,24,255
-im1805	db	5,11,16,62,16,255
-im1806	db	9,12,16,33,62,16,255
-im1807	db	9,12,16,60,16,20,255
-im1808	db	45,81,56,65,16,255
-im1809	db	5,12,61,16,12,255
-im1810	db	9,12,3,63,20,255
-im1811	db	9,12,16,3,62,16,255
-im1812	db	9,12,16,62,10,255
-im1813	db	5,8,61,3,16,28,255
-im1814	db	5,67,81,12,81,58,16,255
-im1815	db	9,12,3,16,63,16,255
-im1816	db	41,4,3,65,28,255
-im1817	db	5,14,3,61,16,255
-im1818	db	5,8,61,20,12,255
-im1819	db	5,31,16,60,16,255
-im1820	db	9,12,16,33,62,6,255
-im1821	db	5,12,58,82,67,16,255
-im1822	db	9,4,28,3,60,82,255
-im1823	db	5,67,81,12,58,16,255
-im1824	db	5,12,58,67,16,255
-im1825	db	5,67,3,12,58,16,255
-im1826	db	9,12,16,11,62,16,255
-im1827	db	5,12,58,16,67,16,255
-im1828	db	9,12,3,63,24,255
-im1829	db	9,60,82,33,58,82,255
-im1830	db	5,12,50,63,81,26,255
-im1831	db	45,81,14,58,16,255
-im1832	db	9,12,16,62,14,255
-im1833	db	5,12,57,3,59,16,255
-im1834	db	9,12,16,5,62,16,255
-im1835	db	45,81,12,24,65,16,255
-im1836	db	9,12,53,16,60,82,255
-im1837	db	13,16,3,16,60,82,255
-im1838	db	9,12,3,16,63,20,255
-im1839	db	5,57,81,12,16,58,16,255
-im1840	db	41,4,3,56,65,16,255
-im1841	db	45,81,65,3,4,56,16,255
-im1842	db	9,12,3,24,63,16,255
-im1843	db	41,4,3,57,3,57,16,255
-im1844	db	5,58,82,56,82,52,255
-im1845	db	9,62,82,33,56,82,255
-im1846	db	33,12,3,6,60,82,255
-im1847	db	13,8,24,60,82,255
-im1848	db	5,61,29,70,82,255
-im1849	db	45,81,10,60,82,255
-im1850	db	33,8,3,10,60,82,255
-im1851	db	9,4,28,60,82,255
-im1852	db	5,61,25,70,82,255
-im1853	db	5,58,82,60,82,255
-im1854	db	5,61,21,70,82,255
-im1855	db	5,61,3,70,82,255
-im1856	db	5,58,82,60,255
-im1857	db	5,61,81,70,82,255
-im1858	db	5,50,61,81,68,82,255
-im1859	db	5,58,82,60,16,255
-im1860	db	5,12,12,67,24,255
-im1861	db	5,8,15,61,16,255
-im1862	db	9,16,25,61,16,255
-im1863	db	45,81,10,60,16,255
-im1864	db	9,12,3,63,28,255
-im1865	db	9,12,11,61,16,255
-im1866	db	13,16,21,61,16,255
-im1867	db	9,12,16,28,56,82,255
-im1868	db	5,58,82,60,10,255
-im1869	db	41,12,16,11,61,16,255
-im1870	db	5,8,50,63,81,26,255
-im1871	db	45,81,12,28,65,16,255
-im1872	db	9,12,16,28,56,255
-im1873	db	9,12,3,57,3,14,255
-im1874	db	9,12,11,61,20,255
-im1875	db	5,12,63,81,26,255
-im1876	db	9,12,53,16,60,16,255
-im1877	db	9,12,16,28,56,16,255
-im1878	db	9,51,62,82,56,82,255
-im1879	db	37,8,3,56,16,65,16,255
-im1880	db	5,8,55,16,60,16,255
-im1881	db	5,12,61,3,16,28,255
-im1882	db	37,4,29,16,60,16,255
-im1883	db	9,60,82,58,82,255
-im1884	db	9,59,25,70,82,255
-im1885	db	5,58,82,33,60,16,255
-im1886	db	13,51,70,31,82,255
-im1887	db	9,59,3,70,82,255
-im1888	db	9,60,82,58,255
-im1889	db	9,59,81,70,82,255
-im1890	db	5,12,61,20,12,255
-im1891	db	5,60,82,33,58,82,255
-im1892	db	9,12,11,61,24,255
-im1893	db	9,60,82,58,16,255
-im1894	db	9,12,11,16,61,16,255
-im1895	db	13,62,82,56,82,255
-im1896	db	45,8,62,82,4,255
-im1897	db	33,63,81,12,81,57,16,255
-im1898	db	9,60,82,58,6,255
-im1899	db	5,12,11,16,60,82,255
-im1900	db	41,4,62,82,8,255
-im1901	db	41,4,8,3,62,82,255
-im1902	db	9,16,63,81,22,255
-im1903	db	13,57,3,70,82,255
-im1904	db	13,62,82,56,255
-im1905	db	13,57,81,70,82,255
-im1906	db	13,50,57,81,68,82,255
-im1907	db	45,8,3,62,4,82,255
-im1908	db	13,4,3,16,62,82,255
-im1909	db	9,12,16,29,62,16,255
-im1910	db	9,51,8,16,62,82,255
-im1911	db	13,62,3,56,82,255
-im1912	db	45,62,3,56,82,255
-im1913	db	13,62,82,56,16,255
-im1914	db	5,51,12,16,62,82,255
-im1915	db	5,63,81,26,255
-im1916	db	41,60,82,58,82,255
-im1917	db	9,63,81,22,255
-im1918	db	37,58,82,60,82,255
-im1919	db	33,56,82,62,82,255
-im1920	db	4,62,8,255
-im1921	db	5,63,16,10,255
-im1922	db	9,63,16,20,255
-im1923	db	9,63,16,4,255
-im1924	db	5,63,16,24,255
-im1925	db	5,63,16,8,255
-im1926	db	5,8,62,3,6,255
-im1927	db	5,63,81,4,16,24,255
-im1928	db	45,62,82,56,16,255
-im1929	db	5,8,62,16,4,255
-im1930	db	9,8,62,3,6,255
-im1931	db	45,4,3,62,3,24,255
-im1932	db	5,4,62,3,10,255
-im1933	db	9,63,3,8,16,20,255
-im1934	db	5,63,3,12,16,10,255
-im1935	db	5,4,62,16,8,255
-im1936	db	9,12,3,14,56,255
-im1937	db	5,63,3,4,16,24,255
-im1938	db	9,12,63,16,20,255
-im1939	db	41,4,8,3,62,16,255
-im1940	db	5,8,63,16,24,255
-im1941	db	9,63,3,12,16,20,255
-im1942	db	45,4,16,50,3,61,16,255
-im1943	db	45,81,62,82,56,16,255
-im1944	db	45,8,62,16,4,255
-im1945	db	5,8,63,16,8,255
-im1946	db	5,51,62,82,56,82,255
-im1947	db	9,12,63,16,4,255
-im1948	db	5,59,25,70,82,255
-im1949	db	5,60,82,58,82,255
-im1950	db	5,59,21,70,82,255
-im1951	db	5,59,3,70,82,255
-im1952	db	5,60,82,58,255
-im1953	db	5,59,81,70,82,255
-im1954	db	5,50,59,81,68,82,255
-im1955	db	5,60,82,58,16,255
-im1956	db	5,12,63,16,24,255
-im1957	db	9,12,16,24,58,16,255
-im1958	db	9,51,70,31,82,255
-im1959	db	45,8,3,62,16,4,255
-im1960	db	45,4,62,16,8,255
-im1961	db	5,63,3,12,16,24,255
-im1962	db	9,12,16,63,16,4,255
-im1963	db	9,62,82,56,82,255
-im1964	db	5,60,82,58,10,255
-im1965	db	5,12,63,16,8,255
-im1966	db	9,15,51,70,82,255
-im1967	db	13,70,31,82,255
-im1968	db	9,62,82,56,255
-im1969	db	9,57,81,70,82,255
-im1970	db	5,8,63,20,8,255
-im1971	db	9,12,16,56,82,12,255
-im1972	db	5,60,11,58,82,255
-im1973	db	9,62,82,56,16,255
-im1974	db	13,50,15,68,82,255
-im1975	db	13,15,70,82,255
-im1976	db	13,64,82,54,255
-im1977	db	13,55,81,70,82,255
-im1978	db	9,51,64,82,28,255
-im1979	db	9,60,3,58,82,255
-im1980	db	41,60,3,58,82,255
-im1981	db	5,60,3,58,82,255
-im1982	db	37,60,3,58,82,255
-im1983	db	33,58,82,60,82,255
-im1984	db	33,58,82,60,255
-im1985	db	13,64,82,28,255
-im1986	db	37,60,82,58,16,255
-im1987	db	33,59,81,4,61,16,255
-im1988	db	41,62,82,56,16,255
-im1989	db	33,59,81,8,61,16,255
-im1990	db	33,59,81,4,61,20,255
-im1991	db	45,81,15,70,82,255
-im1992	db	45,64,82,28,255
-im1993	db	33,59,81,12,61,16,255
-im1994	db	13,51,66,82,24,255
-im1995	db	37,12,3,6,60,16,255
-im1996	db	5,57,25,70,82,255
-im1997	db	5,62,82,56,82,255
-im1998	db	5,15,51,70,82,255
-im1999	db	5,57,3,70,82,255
-im2000	db	5,62,82,56,255
-im2001	db	5,57,81,70,82,255
-im2002	db	9,31,3,70,82,255
-im2003	db	9,70,31,82,255
-im2004	db	9,31,81,70,82,255
-im2005	db	33,65,81,8,81,14,255
-im2006	db	5,51,64,82,28,255
-im2007	db	9,15,70,82,255
-im2008	db	9,64,82,54,255
-im2009	db	9,55,81,70,82,255
-im2010	db	13,50,11,68,82,255
-im2011	db	13,11,70,82,255
-im2012	db	13,66,82,52,255
-im2013	db	9,64,82,28,255
-im2014	db	37,58,3,60,82,255
-im2015	db	33,58,3,60,82,255
-im2016	db	33,60,82,58,255
-im2017	db	33,60,82,58,16,255
-im2018	db	37,62,82,56,16,255
-im2019	db	33,61,81,4,59,16,255
-im2020	db	41,64,82,28,255
-im2021	db	13,66,82,24,255
-im2022	db	5,50,15,68,82,255
-im2023	db	5,15,70,82,255
-im2024	db	5,64,82,54,255
-im2025	db	5,55,81,70,82,255
-im2026	db	5,29,51,70,82,255
-im2027	db	5,64,82,28,255
-im2028	db	9,66,82,52,255
-im2029	db	13,7,70,82,255
-im2030	db	13,51,70,82,255
-im2031	db	13,29,70,82,255
-im2032	db	33,62,82,56,255
-im2033	db	9,66,82,24,255
-im2034	db	37,64,82,28,255
-im2035	db	5,11,70,82,255
-im2036	db	5,66,82,52,255
-im2037	db	5,29,70,82,255
-im2038	db	9,51,70,82,255
-im2039	db	13,70,82,255
-im2040	db	45,70,82,255
-im2041	db	45,81,70,82,255
-im2042	db	5,51,70,82,255
-im2043	db	9,70,82,255
-im2044	db	41,70,82,255
-im2045	db	5,70,82,255
-im2046	db	37,70,82,255
-im2047	db	33,70,82,255
-im2048	db	70,255
-
-	end
@@ -113,9 +113,12 @@ bool VDAudioFilterSink::IsEnded() {
 	return mpContext->mpInputs[0]->mbEnded && mOutputBuffer.getLevel()==0;
 }
 
+// The sink is read from the thread that owns the I/O scheduler, so it must
+// also run there; otherwise the reader could see the input end flag before
+// the last samples have been moved into the output buffer.
 extern const struct VDAudioFilterDefinition afilterDef_sink = {
 	sizeof(VDAudioFilterDefinition),
-	kVFAF_Zero,
+	kVFAF_SerializedIO,
 
 	sizeof(VDAudioFilterSink),	1,	0,
 
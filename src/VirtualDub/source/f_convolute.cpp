@@ -19,42 +19,20 @@
 
 #include <windows.h>
 
-#include <vd2/system/thunk.h>
+#include <vd2/system/bandtask.h>
+#include <vd2/system/cpuaccel.h>
 #include <vd2/plugin/vdplugin.h>
 #include <vd2/plugin/vdvideofilt.h>
 
 #include "resource.h"
 #include "filter.h"
-#include "dub.h"
-
-#include "disasm.h"
 
 #include "f_convolute.h"
 
-#ifdef VD_CPU_X86
-#define USE_ASM
-#define USE_ASM_DYNAMIC
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+	#include <emmintrin.h>
 #endif
 
-extern "C" void asm_convolute_run(
-		void *dst,
-		void *src,
-		unsigned long width,
-		unsigned long height,
-		unsigned long srcstride,
-		unsigned long dststride,
-		const long *matrix);
-
-extern "C" void asm_dynamic_convolute_run(
-		void *dst,
-		void *src,
-		unsigned long width,
-		unsigned long height,
-		unsigned long srcstride,
-		unsigned long dststride,
-		const long *matrix,
-		const void *dyna_func);
-
 extern HINSTANCE g_hInst;
 
 ///////////////////////////////////
@@ -64,16 +42,25 @@ extern HINSTANCE g_hInst;
 #define C_LEFTOK	(4)
 #define C_RIGHTOK	(8)
 
-static void inline conv_add(long& rt, long& gt, long& bt, unsigned long dv, long m) {
-	bt += m*(0xFFUL & (dv));
-	gt += m*(0xFFUL & (dv>>8));
-	rt += m*(0xFFUL & (dv>>16));
+static void inline conv_add(long& rt, long& gt, long& bt, uint32 dv, long m) {
+	bt += m*(long)(0xFFUL & (dv));
+	gt += m*(long)(0xFFUL & (dv>>8));
+	rt += m*(long)(0xFFUL & (dv>>16));
 }
 
-static unsigned long __fastcall do_conv(unsigned long *data, const ConvoluteFilterData *cfd, long sflags, long pit) {
-	long rt0=cfd->m[9], gt0=cfd->m[9], bt0=cfd->m[9];
+static inline uint32 conv_pack(long rt0, long gt0, long bt0) {
 	long rt,gt,bt;
 
+	rt = rt0>>8;	if (rt<0) rt=0; else if (rt>255) rt=255;
+	gt = gt0>>8;	if (gt<0) gt=0; else if (gt>255) gt=255;
+	bt = bt0>>8;	if (bt<0) bt=0; else if (bt>255) bt=255;
+
+	return (uint32)((rt<<16) | (gt<<8) | (bt));
+}
+
+static uint32 do_conv(const uint32 *data, const ConvoluteFilterData *cfd, long sflags, ptrdiff_t pit) {
+	long rt0=cfd->bias, gt0=cfd->bias, bt0=cfd->bias;
+
 	if (sflags & C_TOPOK) {
 		if (sflags & (C_LEFTOK))		conv_add(rt0, gt0, bt0, data[        -1], cfd->m[6]);
 		else							conv_add(rt0, gt0, bt0, data[         0], cfd->m[6]);
@@ -123,87 +110,330 @@ static unsigned long __fastcall do_conv(unsigned long *data, const ConvoluteFilt
 		else							conv_add(rt0, gt0, bt0, data[(pit>>2)  ], cfd->m[2]);
 	}
 
-	rt = rt0>>8;	if (rt<0) rt=0; else if (rt>255) rt=255;
-	gt = gt0>>8;	if (gt<0) gt=0; else if (gt>255) gt=255;
-	bt = bt0>>8;	if (bt<0) bt=0; else if (bt>255) bt=255;
-
-	return (unsigned long)((rt<<16) | (gt<<8) | (bt));
+	return conv_pack(rt0, gt0, bt0);
 }
 
-static inline unsigned long do_conv2(unsigned long *data, const long *m, long pit) {
-	long rt0=m[9], gt0=m[9], bt0=m[9];
-	long rt,gt,bt;
+///////////////////////////////////
+//
+//	Interior kernels
+//
+//	These compute columns 1 to w-2 of a run of rows whose neighbors all
+//	exist. The source pointer addresses the row above the first output row,
+//	as with do_conv(). Each kernel is specialized at compile time on which
+//	taps are nonzero, and one is picked in filter_convolute_start() once the
+//	matrix is known; this replaces the code that used to be generated at
+//	runtime, and works the same in 32-bit and 64-bit builds.
+//
+///////////////////////////////////
 
-	conv_add(rt0, gt0, bt0, data[        -1], m[6]);
-	conv_add(rt0, gt0, bt0, data[         0], m[7]);
-	conv_add(rt0, gt0, bt0, data[        +1], m[8]);
-	conv_add(rt0, gt0, bt0, data[(pit>>2)-1], m[3]);
-	conv_add(rt0, gt0, bt0, data[(pit>>2)  ], m[4]);
-	conv_add(rt0, gt0, bt0, data[(pit>>2)+1], m[5]);
-	conv_add(rt0, gt0, bt0, data[(pit>>1)-1], m[0]);
-	conv_add(rt0, gt0, bt0, data[(pit>>1)  ], m[1]);
-	conv_add(rt0, gt0, bt0, data[(pit>>1)+1], m[2]);
+// Row mask bits for the scalar kernels: 1 = m[0-2], 2 = m[3-5], 4 = m[6-8].
+template<int T_RowMask>
+static void conv_rows_scalar(uint32 *dst, ptrdiff_t dstpitch, const uint32 *src, ptrdiff_t srcpitch, uint32 w, uint32 h, const ConvoluteFilterData& cfd) {
+	const long *const m = cfd.m;
 
-	rt = rt0>>8;	if (rt<0) rt=0; else if (rt>255) rt=255;
-	gt = gt0>>8;	if (gt<0) gt=0; else if (gt>255) gt=255;
-	bt = bt0>>8;	if (bt<0) bt=0; else if (bt>255) bt=255;
+	do {
+		const uint32 *src0 = src;
+		const uint32 *src1 = (const uint32 *)((const char *)src0 + srcpitch);
+		const uint32 *src2 = (const uint32 *)((const char *)src1 + srcpitch);
+
+		for(uint32 x=1; x<w-1; ++x) {
+			long rt0=cfd.bias, gt0=cfd.bias, bt0=cfd.bias;
+
+			if (T_RowMask & 4) {
+				conv_add(rt0, gt0, bt0, src0[x-1], m[6]);
+				conv_add(rt0, gt0, bt0, src0[x  ], m[7]);
+				conv_add(rt0, gt0, bt0, src0[x+1], m[8]);
+			}
+
+			if (T_RowMask & 2) {
+				conv_add(rt0, gt0, bt0, src1[x-1], m[3]);
+				conv_add(rt0, gt0, bt0, src1[x  ], m[4]);
+				conv_add(rt0, gt0, bt0, src1[x+1], m[5]);
+			}
+
+			if (T_RowMask & 1) {
+				conv_add(rt0, gt0, bt0, src2[x-1], m[0]);
+				conv_add(rt0, gt0, bt0, src2[x  ], m[1]);
+				conv_add(rt0, gt0, bt0, src2[x+1], m[2]);
+			}
+
+			dst[x] = conv_pack(rt0, gt0, bt0);
+		}
 
-	return (unsigned long)((rt<<16) | (gt<<8) | (bt));
+		src = (const uint32 *)((const char *)src + srcpitch);
+		dst = (uint32 *)((char *)dst + dstpitch);
+	} while(--h);
 }
 
-int filter_convolute_run(const FilterActivation *fa, const FilterFunctions *ff) {
-	unsigned long w,h;
-	unsigned long *src = (unsigned long *)fa->src.data, *dst = (unsigned long *)fa->dst.data;
-	ptrdiff_t pitch = fa->src.pitch;
-	const ConvoluteFilterData *cfd = (ConvoluteFilterData *)fa->filter_data;
-	const long *const m = cfd->m;
-
-#ifdef USE_ASM
-#ifdef USE_ASM_DYNAMIC
-	if (((ConvoluteFilterData *)fa->filter_data)->dyna_func)
-		asm_dynamic_convolute_run(dst+(fa->dst.pitch>>2)+1, src, fa->src.w-2, fa->src.h-2, fa->dst.pitch, fa->src.pitch, m, ((ConvoluteFilterData *)fa->filter_data)->dyna_func);
-	else
-#endif
-		asm_convolute_run(dst+(fa->dst.pitch>>2)+1, src, fa->src.w-2, fa->src.h-2, fa->dst.pitch, fa->src.pitch, m);
+static const ConvoluteRowProc g_convRowProcsScalar[8]={
+	conv_rows_scalar<0>, conv_rows_scalar<1>, conv_rows_scalar<2>, conv_rows_scalar<3>,
+	conv_rows_scalar<4>, conv_rows_scalar<5>, conv_rows_scalar<6>, conv_rows_scalar<7>,
+};
+
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+	// The SSE2 kernels widen two output pixels' worth of channels to 16 bits
+	// and accumulate tap pairs with PMADDWD, so all coefficients must fit in
+	// 16 bits. The sums are exact in 32 bits and saturate the same way as
+	// conv_pack(). Tap pairs, as mask bits:
+	//
+	//	1: m[6], m[7]	(row above)
+	//	2: m[3], m[4]	(center row)
+	//	4: m[0], m[1]	(row below)
+	//	8: m[8], m[5]	(right column, rows above and center)
+	//	16: m[2]		(right column, row below)
+
+	static inline __m128i conv_pair_coeffs(long m1, long m2) {
+		return _mm_set1_epi32((int)(((uint32)m1 & 0xffff) + ((uint32)m2 << 16)));
+	}
+
+	template<int T_PairMask>
+	static void conv_rows_SSE2(uint32 *dst, ptrdiff_t dstpitch, const uint32 *src, ptrdiff_t srcpitch, uint32 w, uint32 h, const ConvoluteFilterData& cfd) {
+		const long *const m = cfd.m;
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i coeff0 = conv_pair_coeffs(m[6], m[7]);
+		const __m128i coeff1 = conv_pair_coeffs(m[3], m[4]);
+		const __m128i coeff2 = conv_pair_coeffs(m[0], m[1]);
+		const __m128i coeff3 = conv_pair_coeffs(m[8], m[5]);
+		const __m128i coeff4 = conv_pair_coeffs(m[2], 0);
+		const __m128i bias = _mm_set1_epi32(cfd.bias);
+		const __m128i rgbmask = _mm_set1_epi32(0x00ffffff);
+		const uint32 pairs = (w - 2) >> 1;
+
+		do {
+			const uint32 *src0 = src;
+			const uint32 *src1 = (const uint32 *)((const char *)src0 + srcpitch);
+			const uint32 *src2 = (const uint32 *)((const char *)src1 + srcpitch);
+			uint32 x = 1;
+
+			for(uint32 i=0; i<pairs; ++i, x += 2) {
+				// Each load covers x-1 to x+2, which is everything the two
+				// output pixels x and x+1 need from that row.
+				const __m128i p0 = _mm_loadu_si128((const __m128i *)(src0 + x - 1));
+				const __m128i p1 = _mm_loadu_si128((const __m128i *)(src1 + x - 1));
+				const __m128i p2 = _mm_loadu_si128((const __m128i *)(src2 + x - 1));
+				__m128i sum0 = bias;
+				__m128i sum1 = bias;
+
+				if (T_PairMask & 1) {
+					const __m128i l = _mm_unpacklo_epi8(p0, zero);
+					const __m128i c = _mm_unpacklo_epi8(_mm_srli_si128(p0, 4), zero);
+
+					sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_unpacklo_epi16(l, c), coeff0));
+					sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_unpackhi_epi16(l, c), coeff0));
+				}
+
+				if (T_PairMask & 2) {
+					const __m128i l = _mm_unpacklo_epi8(p1, zero);
+					const __m128i c = _mm_unpacklo_epi8(_mm_srli_si128(p1, 4), zero);
+
+					sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_unpacklo_epi16(l, c), coeff1));
+					sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_unpackhi_epi16(l, c), coeff1));
+				}
+
+				if (T_PairMask & 4) {
+					const __m128i l = _mm_unpacklo_epi8(p2, zero);
+					const __m128i c = _mm_unpacklo_epi8(_mm_srli_si128(p2, 4), zero);
+
+					sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_unpacklo_epi16(l, c), coeff2));
+					sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_unpackhi_epi16(l, c), coeff2));
+				}
+
+				if (T_PairMask & 8) {
+					const __m128i r0 = _mm_unpackhi_epi8(p0, zero);
+					const __m128i r1 = _mm_unpackhi_epi8(p1, zero);
+
+					sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_unpacklo_epi16(r0, r1), coeff3));
+					sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_unpackhi_epi16(r0, r1), coeff3));
+				}
+
+				if (T_PairMask & 16) {
+					const __m128i r2 = _mm_unpackhi_epi8(p2, zero);
+
+					sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(_mm_unpacklo_epi16(r2, zero), coeff4));
+					sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(_mm_unpackhi_epi16(r2, zero), coeff4));
+				}
+
+				__m128i result = _mm_packs_epi32(_mm_srai_epi32(sum0, 8), _mm_srai_epi32(sum1, 8));
+
+				result = _mm_and_si128(_mm_packus_epi16(result, result), rgbmask);
+
+				_mm_storel_epi64((__m128i *)(dst + x), result);
+			}
+
+			if (x < w - 1) {
+				long rt0=cfd.bias, gt0=cfd.bias, bt0=cfd.bias;
+
+				conv_add(rt0, gt0, bt0, src0[x-1], m[6]);
+				conv_add(rt0, gt0, bt0, src0[x  ], m[7]);
+				conv_add(rt0, gt0, bt0, src0[x+1], m[8]);
+				conv_add(rt0, gt0, bt0, src1[x-1], m[3]);
+				conv_add(rt0, gt0, bt0, src1[x  ], m[4]);
+				conv_add(rt0, gt0, bt0, src1[x+1], m[5]);
+				conv_add(rt0, gt0, bt0, src2[x-1], m[0]);
+				conv_add(rt0, gt0, bt0, src2[x  ], m[1]);
+				conv_add(rt0, gt0, bt0, src2[x+1], m[2]);
+
+				dst[x] = conv_pack(rt0, gt0, bt0);
+			}
+
+			src = (const uint32 *)((const char *)src + srcpitch);
+			dst = (uint32 *)((char *)dst + dstpitch);
+		} while(--h);
+	}
+
+	static const ConvoluteRowProc g_convRowProcsSSE2[32]={
+		conv_rows_SSE2< 0>, conv_rows_SSE2< 1>, conv_rows_SSE2< 2>, conv_rows_SSE2< 3>,
+		conv_rows_SSE2< 4>, conv_rows_SSE2< 5>, conv_rows_SSE2< 6>, conv_rows_SSE2< 7>,
+		conv_rows_SSE2< 8>, conv_rows_SSE2< 9>, conv_rows_SSE2<10>, conv_rows_SSE2<11>,
+		conv_rows_SSE2<12>, conv_rows_SSE2<13>, conv_rows_SSE2<14>, conv_rows_SSE2<15>,
+		conv_rows_SSE2<16>, conv_rows_SSE2<17>, conv_rows_SSE2<18>, conv_rows_SSE2<19>,
+		conv_rows_SSE2<20>, conv_rows_SSE2<21>, conv_rows_SSE2<22>, conv_rows_SSE2<23>,
+		conv_rows_SSE2<24>, conv_rows_SSE2<25>, conv_rows_SSE2<26>, conv_rows_SSE2<27>,
+		conv_rows_SSE2<28>, conv_rows_SSE2<29>, conv_rows_SSE2<30>, conv_rows_SSE2<31>,
+	};
 #endif
 
-	src -= pitch>>2;
+static ConvoluteRowProc conv_select_rowproc(const ConvoluteFilterData& cfd) {
+	const long *const m = cfd.m;
 
-	*dst++ = do_conv(src++, cfd, C_BOTTOMOK | C_RIGHTOK, pitch);
-	w = fa->src.w-2;
-	do { *dst++ = do_conv(src++, cfd, C_BOTTOMOK | C_LEFTOK | C_RIGHTOK, pitch); } while(--w);
-	*dst++ = do_conv(src++, cfd, C_BOTTOMOK | C_LEFTOK, pitch);
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+	if (SSE2_enabled) {
+		bool fits16 = true;
 
-	src += fa->src.modulo>>2;
-	dst += fa->dst.modulo>>2;
+		for(int i=0; i<9; ++i) {
+			if (m[i] < -0x8000 || m[i] > 0x7fff) {
+				fits16 = false;
+				break;
+			}
+		}
 
-#ifndef USE_ASM
-	h = fa->src.h-2;
-	do {
-		*dst++ = do_conv(src++, cfd, C_TOPOK | C_BOTTOMOK | C_RIGHTOK, pitch);
-		w = fa->src.w-2;
-		do { *dst++ = do_conv2(src++, m, pitch); } while(--w);
-		*dst++ = do_conv(src++, cfd, C_TOPOK | C_BOTTOMOK | C_LEFTOK, pitch);
+		if (fits16) {
+			int pairMask = 0;
 
-		src += fa->src.modulo>>2;
-		dst += fa->dst.modulo>>2;
-	} while(--h);
-#else
-	h = fa->src.h-2;
-	w = fa->src.w;
-	do {
-		dst[0] = do_conv(src+0, cfd, C_TOPOK | C_BOTTOMOK | C_RIGHTOK, pitch);
-		dst[w-1] = do_conv(src+w-1, cfd, C_TOPOK | C_BOTTOMOK | C_LEFTOK, pitch);
+			if (m[6] || m[7]) pairMask += 1;
+			if (m[3] || m[4]) pairMask += 2;
+			if (m[0] || m[1]) pairMask += 4;
+			if (m[8] || m[5]) pairMask += 8;
+			if (m[2]) pairMask += 16;
 
-		src += fa->src.pitch>>2;
-		dst += fa->dst.pitch>>2;
-	} while(--h);
+			return g_convRowProcsSSE2[pairMask];
+		}
+	}
 #endif
 
-	*dst++ = do_conv(src++, cfd, C_TOPOK | C_RIGHTOK, pitch);
-	w = fa->src.w-2;
-	do { *dst++ = do_conv(src++, cfd, C_TOPOK | C_LEFTOK | C_RIGHTOK, pitch); } while(--w);
-	*dst++ = do_conv(src++, cfd, C_TOPOK | C_LEFTOK, pitch);
+	int rowMask = 0;
+
+	if (m[0] || m[1] || m[2]) rowMask += 1;
+	if (m[3] || m[4] || m[5]) rowMask += 2;
+	if (m[6] || m[7] || m[8]) rowMask += 4;
+
+	return g_convRowProcsScalar[rowMask];
+}
+
+///////////////////////////////////
+
+namespace {
+	class VDConvoluteRenderer : public VDRowTask {
+	public:
+		VDConvoluteRenderer(const ConvoluteFilterData& cfd, uint32 *dst, ptrdiff_t dstpitch, const uint32 *src, ptrdiff_t srcpitch, uint32 w, uint32 h);
+
+		void Render();
+		void RenderInteriorRows(uint32 y1, uint32 y2);
+
+	protected:
+		void RunRows(uint32 y1, uint32 y2);
+		void RenderEdgeRow(uint32 y, long vflags);
+
+		const ConvoluteFilterData& mData;
+		uint32 *const mpDst;
+		const ptrdiff_t mDstPitch;
+		const uint32 *const mpSrc;
+		const ptrdiff_t mSrcPitch;
+		const uint32 mWidth;
+		const uint32 mHeight;
+	};
+
+	VDConvoluteRenderer::VDConvoluteRenderer(const ConvoluteFilterData& cfd, uint32 *dst, ptrdiff_t dstpitch, const uint32 *src, ptrdiff_t srcpitch, uint32 w, uint32 h)
+		: mData(cfd)
+		, mpDst(dst)
+		, mDstPitch(dstpitch)
+		, mpSrc(src)
+		, mSrcPitch(srcpitch)
+		, mWidth(w)
+		, mHeight(h)
+	{
+	}
+
+	void VDConvoluteRenderer::Render() {
+		RenderEdgeRow(0, mHeight > 1 ? C_BOTTOMOK : 0);
+
+		if (mHeight < 2)
+			return;
+
+		RenderEdgeRow(mHeight - 1, C_TOPOK);
+
+		if (mHeight < 3)
+			return;
+
+		// Interior rows only read the source, so they can be split into
+		// bands and computed in parallel.
+		VDRunRowTask(*this, mHeight - 2, mWidth * 4);
+	}
+
+	void VDConvoluteRenderer::RunRows(uint32 y1, uint32 y2) {
+		RenderInteriorRows(y1 + 1, y2 + 1);
+	}
+
+	void VDConvoluteRenderer::RenderInteriorRows(uint32 y1, uint32 y2) {
+		if (y1 >= y2)
+			return;
+
+		const uint32 *src = (const uint32 *)((const char *)mpSrc + mSrcPitch * (ptrdiff_t)(y1 - 1));
+		uint32 *dst = (uint32 *)((char *)mpDst + mDstPitch * (ptrdiff_t)y1);
+		const uint32 w = mWidth;
+
+		if (w >= 3)
+			mData.rowProc(dst, mDstPitch, src, mSrcPitch, w, y2 - y1, mData);
+
+		for(uint32 y=y1; y<y2; ++y) {
+			if (w > 1) {
+				dst[0] = do_conv(src, &mData, C_TOPOK | C_BOTTOMOK | C_RIGHTOK, mSrcPitch);
+				dst[w-1] = do_conv(src+w-1, &mData, C_TOPOK | C_BOTTOMOK | C_LEFTOK, mSrcPitch);
+			} else
+				dst[0] = do_conv(src, &mData, C_TOPOK | C_BOTTOMOK, mSrcPitch);
+
+			src = (const uint32 *)((const char *)src + mSrcPitch);
+			dst = (uint32 *)((char *)dst + mDstPitch);
+		}
+	}
+
+	void VDConvoluteRenderer::RenderEdgeRow(uint32 y, long vflags) {
+		// do_conv() never touches the row above when C_TOPOK is clear, so
+		// forming the pointer for the first row is harmless.
+		const uint32 *src = (const uint32 *)((const char *)mpSrc + mSrcPitch * ((ptrdiff_t)y - 1));
+		uint32 *dst = (uint32 *)((char *)mpDst + mDstPitch * (ptrdiff_t)y);
+		const uint32 w = mWidth;
+
+		for(uint32 x=0; x<w; ++x) {
+			long flags = vflags;
+
+			if (x > 0)
+				flags |= C_LEFTOK;
+
+			if (x < w - 1)
+				flags |= C_RIGHTOK;
+
+			dst[x] = do_conv(src + x, &mData, flags, mSrcPitch);
+		}
+	}
+}
+
+int filter_convolute_run(const FilterActivation *fa, const FilterFunctions *ff) {
+	const ConvoluteFilterData *cfd = (const ConvoluteFilterData *)fa->filter_data;
+
+	VDConvoluteRenderer renderer(*cfd, (uint32 *)fa->dst.data, fa->dst.pitch, (const uint32 *)fa->src.data, fa->src.pitch, fa->src.w, fa->src.h);
+
+	renderer.Render();
 
 	return 0;
 }
@@ -222,7 +452,7 @@ long filter_convolute_param(FilterActivation *fa, const FilterFunctions *ff) {
 static int convolute_init(FilterActivation *fa, const FilterFunctions *ff) {
 	((ConvoluteFilterData *)fa->filter_data)->m[4] = 256;
 	((ConvoluteFilterData *)fa->filter_data)->bias = 128;
-	((ConvoluteFilterData *)fa->filter_data)->dyna_func = NULL;
+	((ConvoluteFilterData *)fa->filter_data)->rowProc = NULL;
 
 	return 0;
 }
@@ -315,336 +545,10 @@ static bool convolute_script_line(FilterActivation *fa, const FilterFunctions *f
 
 ///////////////////////////////////
 
-extern DubOptions g_dubOpts;
-
-#define REG_EAX		(0)
-#define REG_ECX		(1)
-#define REG_EDX		(2)
-#define REG_EBX		(3)
-#define REG_ESP		(4)
-#define REG_EBP		(5)
-#define REG_ESI		(6)
-#define REG_EDI		(7)
-
-char *DCG_emit_MOV(char *ptr, int dest, int src) {
-	ptr[0] = (char)0x8b;
-	ptr[1] = (char)(0xc0 + (dest<<3) + src);
-
-	return ptr+2;
-}
-
-char *DCG_emit_MOV_from_indexed(char *ptr, int dest, int src, long disp32) {
-	ptr[0] = (char)0x8b;
-	if (src != REG_ESP) {
-		if (src != REG_EBP && !disp32) {
-			ptr[1] = (char)((dest<<3) + src);
-			return ptr+2;
-		}
-		if (disp32>=-128 && disp32<128) {
-			ptr[1] = (char)(0x40 + (dest<<3) + src);
-			ptr[2] = (char)(disp32 & 0xff);
-			return ptr+3;
-		}
-		ptr[1] = (char)(0x80 + (dest<<3) + src);
-		*(long *)(ptr+2) = disp32;
-		return ptr+6;
-	}
-
-	ptr[2] = 0x24;
-	if (!disp32) {
-		ptr[1] = (char)(0x00 + (dest<<3));
-		return ptr+3;
-	}
-	if (disp32>=-128 && disp32<128) {
-		ptr[1] = (char)(0x40 + (dest<<3));
-		ptr[3] = 0;
-		return ptr+4;
-	}
-	ptr[1] = (char)(0x80 + (dest<<3));
-	*(long *)(ptr+3) = 0;
-	return ptr+7;
-}
-
-char *DCG_emit_ADD(char *ptr, int dest, int src) {
-	ptr[0] = 0x03;
-	ptr[1] = (char)(0xc0 + (dest<<3) + src);
-
-	return ptr+2;
-}
-
-char *DCG_emit_SUB(char *ptr, int dest, int src) {
-	ptr[0] = 0x2B;
-	ptr[1] = (char)(0xc0 + (dest<<3) + src);
-
-	return ptr+2;
-}
-
-char *DCG_emit_SHL(char *ptr, int dest, int bits) {
-	if (bits==1) {
-		ptr[0] = (char)0xd1;
-		ptr[1] = (char)(0xe0 + dest);
-
-		return ptr+2;
-	}
-	ptr[0] = (char)0xc1;
-	ptr[1] = (char)(0xe0 + dest);
-	ptr[2] = (char)bits;
-
-	return ptr+3;
-}
-
-char *DCG_emit_SHR(char *ptr, int dest, int bits) {
-	if (bits==1) {
-		ptr[0] = (char)0xd1;
-		ptr[1] = (char)(0xe8 + dest);
-
-		return ptr+2;
-	}
-	ptr[0] = (char)0xc1;
-	ptr[1] = (char)(0xe8 + dest);
-	ptr[2] = (char)bits;
-
-	return ptr+3;
-}
-
-char *DCG_emit_AND_immediate(char *ptr, int dest, long imm32) {
-	ptr[0] = (char)0x81;
-	ptr[1] = (char)(0xe0 + dest);
-	*(long *)(ptr+2) = imm32;
-
-	return ptr+6;
-}
-
-// LEA dest,[src1*scale] (scale = 0 to 3)
-
-char *DCG_emit_LEA(char *ptr, int dest, int src1, int scale) {
-	ptr[0] = (char)0x8d;
-	if (!scale && src1!=REG_EBP && src1!=REG_ESP) {
-		ptr[1] = (char)((dest<<3) | src1);
-		return ptr+2;
-	}
-	ptr[1] = (char)(0x04 | (dest<<3));
-	ptr[2] = (char)((scale<<6) | (src1<<3) | 0x05);
-	*(long *)(ptr+3)=0;
-
-	return ptr+7;
-}
-
-// LEA dest,[src2 + src1*scale]
-
-char *DCG_emit_LEA(char *ptr, int dest, int src1, int scale, int src2) {
-	ptr[0] = (char)0x8d;
-	if (src2 == REG_EBP) {
-		ptr[1] = (char)(0x44 | (dest<<3));
-		ptr[2] = (char)((scale<<6) | (src1<<3) | src2);
-		ptr[3] = 0;
-		return ptr+4;
-	}
-	ptr[1] = (char)(0x04 | (dest<<3));
-	ptr[2] = (char)((scale<<6) | (src1<<3) | src2);
-
-	return ptr+3;
-}
-
-enum {
-	CODE_LEA1	= 0,	// 2 dest * 2 src1 * 2 src2 * 4 multipliers = 32 ops
-	CODE_LEA2	= 32,	// 2 dest * 2 src1 * 4 multipliers = 16 ops
-	CODE_SHL	= 48,	// 2 dest * 16 shifts = 32 ops
-	CODE_SUB	= 80,	// 2 dest * 2 src = 4 ops
-	CODE_MAX	= 84
-};
-
-// src2(16), multiplier(4), src1(2), dest(1)
-
-char *DCG_emit_mult_op(char *ptr, int reg1, int reg2, char op) {
-	if (op < CODE_LEA2) {
-		// special cases:
-		//		add - scale=1, src1=dest or src2=dest
-
-		if (!(op&12) && !((op ^ (op>>1))&1))
-			return DCG_emit_ADD(ptr, op&1 ? reg2 : reg1, op&16 ? reg2 : reg1);
-		else if (!(op&12) && !((op ^ (op>>4))&1))
-			return DCG_emit_ADD(ptr, op&1 ? reg2 : reg1, op&2 ? reg2 : reg1);
-		else
-			return DCG_emit_LEA(
-					ptr,
-					op&1 ? reg2 : reg1,
-					op&2 ? reg2 : reg1,
-					(op>>2) & 3,
-					op&16 ? reg2 : reg1);
-	} else if (op < CODE_SHL) {
-		// special cases:
-		//		mov - scale=1
-
-		if (!((op>>2)&3))
-			return DCG_emit_MOV(ptr, op&1 ? reg2 : reg1, op&2 ? reg2 : reg1);
-		else
-			return DCG_emit_LEA(
-					ptr,
-					op&1 ? reg2 : reg1,
-					op&2 ? reg2 : reg1,
-					(op>>2) & 3);
-	} else if (op < CODE_SUB) {
-		// special cases:
-		//		add - shift=1
-
-		if (((op-CODE_SHL)>>1)==1)
-			return DCG_emit_ADD(ptr, op&1?reg2:reg1, op&1?reg2:reg1);
-		else
-			return DCG_emit_SHL(ptr, op&1?reg2:reg1, (op - CODE_SHL)>>1);
-	} else {
-		return DCG_emit_SUB(ptr, op&1?reg2:reg1, op&2?reg2:reg1);
-	}
-}
-
-extern "C" char *asm_dynamic_convolute_codecopy(char *, int);
-extern "C" const char *const asm_const_multiply_tab[2049];
-
 int filter_convolute_start(FilterActivation *fa, const FilterFunctions *ff) {
-#ifdef USE_ASM_DYNAMIC
 	ConvoluteFilterData *cfd = (ConvoluteFilterData *)fa->filter_data;
-	char *pptr,c;
-	const char *pcode;
-	int x, y;
-	long m;
-
-	///////////////
-
-	if (!g_dubOpts.perf.dynamicEnable) return 0;
-
-	if (!(cfd->dyna_func = VDAllocateThunkMemory(4096))) return 1;
-
-	pptr = (char *)cfd->dyna_func;
-
-	pptr = asm_dynamic_convolute_codecopy(pptr, 0);
-
-	for(y=0; y<3; y++)
-		for(x=0; x<3; x++) {
-			m = cfd->m[(2-y)*3+x];
-			if (!m) continue;
-
-			// MOV eax,[esi+disp32]
-			// SHR eax,(0/8/16)
-			// AND eax,000000ffh
-			// (generate multiplication series)
-
-			// red=EBP, green=EDI, blue=EDX
-
-			// If the coefficient is 2, 4, or 8, generate a compact LEA sequence
-
-			if (m==2 || m==4 || m==8) {
-				int scale = (m>>2)+1;
-
-				// v MOV eax,[esi+disp32]
-				// u MOV ebx,eax
-				// v AND eax,000000ffh			eax: ready
-				// u MOV ecx,ebx
-				// v AND ebx,0000ff00h
-				// u SHR ebx,8					ebx: ready
-				// v AND ecx,00ff0000h
-				// u SHR ecx,16
-				// v LEA edx,[edx+eax*mult]
-				// u LEA edi,[edi+ebx*mult]
-				// v LEA ebp,[ebp+ecx*mult]		;AGI (arrgh!!!)
-
-				pptr = DCG_emit_MOV_from_indexed(pptr, REG_EAX, REG_ESI, fa->src.pitch*y + 4*x - 4);
-				pptr = DCG_emit_MOV(pptr, REG_EBX, REG_EAX);
-				pptr = DCG_emit_AND_immediate(pptr, REG_EAX, 0x000000ff);
-				pptr = DCG_emit_MOV(pptr, REG_ECX, REG_EBX);
-				pptr = DCG_emit_AND_immediate(pptr, REG_EBX, 0x0000ff00);
-				pptr = DCG_emit_SHR(pptr, REG_EBX, 8);
-				pptr = DCG_emit_AND_immediate(pptr, REG_ECX, 0x00ff0000);
-				pptr = DCG_emit_SHR(pptr, REG_ECX, 16);
-				pptr = DCG_emit_LEA(pptr, REG_EDX, REG_EAX, scale, REG_EDX);
-				pptr = DCG_emit_LEA(pptr, REG_EDI, REG_EBX, scale, REG_EDI);
-				pptr = DCG_emit_LEA(pptr, REG_EBP, REG_ECX, scale, REG_EBP);
-
-			// If the coefficient is <=256, then generate red and blue simultaneously
-
-			} else if (abs(m)<=256) {
-
-				pptr = DCG_emit_MOV_from_indexed(pptr, REG_EAX, REG_ESI, fa->src.pitch*y + 4*x - 4);
-				pptr = DCG_emit_AND_immediate(pptr, REG_EAX, 0x00ff00ff);
-
-				pcode = asm_const_multiply_tab[abs(m)];
-				while((c=*pcode++) != (char)0xff) {
-					pptr = DCG_emit_mult_op(pptr, REG_EAX, REG_EBX, c);
-				}
-
-				pptr = DCG_emit_MOV(pptr, REG_EBX, REG_EAX);
-
-				pptr = DCG_emit_SHR(pptr, REG_EAX, 16);
-				pptr = DCG_emit_AND_immediate(pptr, REG_EBX, 0x0000ffff);
-
-				if (m<0)	pptr = DCG_emit_SUB(pptr, REG_EBP, REG_EAX);
-				else		pptr = DCG_emit_ADD(pptr, REG_EBP, REG_EAX);
-
-				if (m<0)	pptr = DCG_emit_SUB(pptr, REG_EDX, REG_EBX);
-				else		pptr = DCG_emit_ADD(pptr, REG_EDX, REG_EBX);
 
-			} else {
-
-				// red
-
-				pptr = DCG_emit_MOV_from_indexed(pptr, REG_EAX, REG_ESI, fa->src.pitch*y + 4*x - 4);
-				pptr = DCG_emit_SHR(pptr, REG_EAX, 16);
-				pptr = DCG_emit_AND_immediate(pptr, REG_EAX, 0x000000ff);
-
-				pcode = asm_const_multiply_tab[abs(m)];
-				while((c=*pcode++) != (char)0xff) {
-					pptr = DCG_emit_mult_op(pptr, REG_EAX, REG_EBX, c);
-				}
-
-				if (m<0)	pptr = DCG_emit_SUB(pptr, REG_EBP, REG_EAX);
-				else		pptr = DCG_emit_ADD(pptr, REG_EBP, REG_EAX);
-
-				// blue
-
-				pptr = DCG_emit_MOV_from_indexed(pptr, REG_EAX, REG_ESI, fa->src.pitch*y + 4*x - 4);
-				pptr = DCG_emit_AND_immediate(pptr, REG_EAX, 0x000000ff);
-
-				pcode = asm_const_multiply_tab[abs(m)];
-				while((c=*pcode++) != (char)0xff)
-					pptr = DCG_emit_mult_op(pptr, REG_EAX, REG_EBX, c);
-
-				if (m<0)	pptr = DCG_emit_SUB(pptr, REG_EDX, REG_EAX);
-				else		pptr = DCG_emit_ADD(pptr, REG_EDX, REG_EAX);
-			}
-
-			// green
-
-			pptr = DCG_emit_MOV_from_indexed(pptr, REG_EAX, REG_ESI, fa->src.pitch*y + 4*x - 4);
-			pptr = DCG_emit_AND_immediate(pptr, REG_EAX, 0x0000ff00);
-
-			pcode = asm_const_multiply_tab[abs(m)];
-			while((c=*pcode++) != (char)0xff)
-				pptr = DCG_emit_mult_op(pptr, REG_EAX, REG_EBX, c);
-
-			if (m<0)	pptr = DCG_emit_SUB(pptr, REG_EDI, REG_EAX);
-			else		pptr = DCG_emit_ADD(pptr, REG_EDI, REG_EAX);
-		}
-
-	if (cfd->bias)
-		pptr = asm_dynamic_convolute_codecopy(pptr, 1);
-
-	pptr = asm_dynamic_convolute_codecopy(pptr, 2);
-
-	pptr[0] = 0x0f;
-	pptr[1] = (char)0x85;
-	*(long *)(pptr+2) = (char *)cfd->dyna_func - (pptr+6);
-	pptr[6] = (char)0xc3;	// RET
-
-	cfd->dyna_size = (pptr+7) - (char *)cfd->dyna_func;
-
-	//////
-
-	if (g_dubOpts.perf.dynamicShowDisassembly) {
-		CodeDisassemblyWindow cdw(cfd->dyna_func, cfd->dyna_size, cfd->dyna_func, cfd->dyna_func);
-
-		cdw.parse();
-		cdw.post(NULL);
-	}
-#endif
+	cfd->rowProc = conv_select_rowproc(*cfd);
 
 	return 0;
 }
@@ -654,10 +558,7 @@ int filter_convolute_start(FilterActivation *fa, const FilterFunctions *ff) {
 int filter_convolute_end(FilterActivation *fa, const FilterFunctions *ff) {
 	ConvoluteFilterData *cfd = (ConvoluteFilterData *)fa->filter_data;
 
-	if (cfd->dyna_func) {
-		VDFreeThunkMemory(cfd->dyna_func, cfd->dyna_size);
-		cfd->dyna_func = NULL;
-	}
+	cfd->rowProc = NULL;
 
 	return 0;
 }
@@ -666,7 +567,7 @@ FilterDefinition filterDef_convolute={
 	0,0,NULL,
 	"general convolution",
 	"Applies a general 3x3 convolution matrix to a pixel that depends on the pixel's value and the eight neighboring pixels around it.\n\n"
-		"[Assembly optimized] [Dynamic compilation]",
+		"[SSE2 optimized] [Multithreaded]",
 	NULL,NULL,
 	sizeof(ConvoluteFilterData),
 	convolute_init,
@@ -109,6 +109,7 @@ class VDVideoFilterCurves : public VDXVideoFilter {
 public:
 	uint32 GetParams();
 	void Run();
+	bool OnGetPointTable(const VDXFilterPointTable& table);
 
 protected:
 	uint32 mChromaWidth;
@@ -121,7 +122,8 @@ protected:
 };
 
 uint32 VDVideoFilterCurves::GetParams() {
-	const VDXPixmapLayout& pxldst = *fa->dst.mpPixmapLayout;
+	const VDXPixmapLayout& pxlsrc = *fa->src.mpPixmapLayout;
+	VDXPixmapLayout& pxldst = *fa->dst.mpPixmapLayout;
 	const uint32 w = pxldst.w;
 	const uint32 h = pxldst.h;
 	bool ycbcrMode = true;
@@ -251,8 +253,9 @@ uint32 VDVideoFilterCurves::GetParams() {
 		}
 	}
 
+	pxldst.pitch = pxlsrc.pitch;
 	fa->dst.offset = fa->src.offset;
-	return FILTERPARAM_SUPPORTS_ALTFORMATS;
+	return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_POINT_TRANSFORM;
 }
 
 void VDVideoFilterCurves::Run() {
@@ -289,6 +292,13 @@ void VDVideoFilterCurves::Run() {
 	}
 }
 
+bool VDVideoFilterCurves::OnGetPointTable(const VDXFilterPointTable& table) {
+	for(int i=0; i<3; ++i)
+		memcpy(table.mpTables[i], mLookupTables[i], 256);
+
+	return true;
+}
+
 extern const VDXFilterDefinition filterDef_curves = VDXVideoFilterDefinition<VDVideoFilterCurves>(
 	NULL,
 	"curves",
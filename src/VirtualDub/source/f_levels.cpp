@@ -278,6 +278,7 @@ static int levels_run(const FilterActivation *fa, const FilterFunctions *ff) {
 					AsmLevelsRunScalar((uint32 *)px.data, px.pitch, px.w, px.h, mfd->xtblluma);
 				break;
 
+			case nsVDXPixmap::kPixFormat_Y8:
 			case nsVDXPixmap::kPixFormat_YUV444_Planar:
 			case nsVDXPixmap::kPixFormat_YUV422_Planar:
 			case nsVDXPixmap::kPixFormat_YUV420_Planar:
@@ -367,13 +368,44 @@ static long levels_param(FilterActivation *fa, const FilterFunctions *ff) {
 				return FILTERPARAM_NOT_SUPPORTED;
 		}
 
-		return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM;
+		// Luma mode on RGB mixes channels, so only the YCbCr path is a point transform.
+		if (pxlsrc.format == nsVDXPixmap::kPixFormat_XRGB8888)
+			return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM;
+
+		return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM | FILTERPARAM_POINT_TRANSFORM;
 	}
 
 	if (pxlsrc.format != nsVDXPixmap::kPixFormat_XRGB8888)
 		return FILTERPARAM_NOT_SUPPORTED;
 
-	return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM;
+	return FILTERPARAM_SUPPORTS_ALTFORMATS | FILTERPARAM_PURE_TRANSFORM | FILTERPARAM_POINT_TRANSFORM;
+}
+
+static bool levels_event(const FilterActivation *fa, const FilterFunctions *ff, uint32 event, const void *eventData) {
+	const LevelsFilterData *mfd = (const LevelsFilterData *)fa->filter_data;
+
+	if (event != kVDXVFEvent_GetPointTable)
+		return false;
+
+	const VDXFilterPointTable& table = *(const VDXFilterPointTable *)eventData;
+
+	if (mfd->bLuma) {
+		if (fa->dst.mpPixmapLayout->format == nsVDXPixmap::kPixFormat_XRGB8888)
+			return false;
+
+		memcpy(table.mpTables[0], mfd->xtblmono2, 256);
+
+		for(int i=0; i<256; ++i) {
+			table.mpTables[1][i] = (uint8)i;
+			table.mpTables[2][i] = (uint8)i;
+		}
+	} else {
+		memcpy(table.mpTables[0], mfd->xtblmono, 256);
+		memcpy(table.mpTables[1], mfd->xtblmono, 256);
+		memcpy(table.mpTables[2], mfd->xtblmono, 256);
+	}
+
+	return true;
 }
 
 static void levelsButtonCallback(bool fNewState, void *pvData) {
@@ -1000,4 +1032,11 @@ FilterDefinition filterDef_levels={
 	&levels_obj,
 	levels_script_line,
 	levels_string2,
+	NULL,					// serialize
+	NULL,					// deserialize
+	NULL,					// copy
+	NULL,					// prefetch
+	NULL,					// copy2
+	NULL,					// prefetch2
+	levels_event,
 };
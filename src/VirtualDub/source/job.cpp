@@ -575,13 +575,17 @@ static void JobAddClose(JobScriptOutput& output) {
 	output.adds("VirtualDub.Close();");
 }
 
-static void JobCreateEntry(JobScriptOutput& output, const wchar_t *inputPath, const wchar_t *outputPath) {
+static void JobCreateEntry(JobScriptOutput& output, const wchar_t *inputPath, const wchar_t *outputPath, uint64 chunkGroupId = 0, int chunkIndex = 0, int chunkCount = 0) {
 	vdautoptr<VDJob> vdj(new VDJob);
 	vdj->SetInputFile(inputPath);
 
 	if (outputPath)
 		vdj->SetOutputFile(outputPath);
 
+	vdj->mChunkGroupId = chunkGroupId;
+	vdj->mChunkIndex = chunkIndex;
+	vdj->mChunkCount = chunkCount;
+
 	const JobScriptOutput::Script& script = output.getscript();
 	vdj->SetScript(script.data(), script.size(), true);
 	g_VDJobQueue.Add(vdj, false);
@@ -605,6 +609,95 @@ void JobAddConfiguration(const DubOptions *opt, const wchar_t *szFileInput, cons
 	JobCreateEntry(output, szFileInput, szFileOutput);
 }
 
+// Splits a render into jobs for frame ranges that can be picked up by
+// different job runners, followed by a job that joins the parts once they
+// have all completed. Chunk starts are moved back to key frames so that each
+// chunk can decode from its first frame; each chunk still runs the whole
+// filter chain, so filters that look ahead or behind fetch the frames they
+// need from outside the chunk's range. The parts are named the same way as
+// segmented output and are joined by direct stream copy.
+void JobAddConfigurationChunked(const DubOptions *opt, const wchar_t *szFileInput, const wchar_t *pszInputDriver, const wchar_t *szFileOutput, bool fCompatibility, List2<InputFilenameNode> *pListAppended, int chunkCount) {
+	VDTimeline& timeline = g_project->GetTimeline();
+	VDPosition start = 0;
+	VDPosition end = timeline.GetLength();
+
+	if (g_project->IsSelectionPresent()) {
+		start = g_project->GetSelectionStartFrame();
+		end = g_project->GetSelectionEndFrame();
+	}
+
+	vdfastvector<VDPosition> bounds;
+	bounds.push_back(start);
+
+	for(int i=1; i<chunkCount; ++i) {
+		VDPosition pos = timeline.GetNearestKey(start + (end - start) * i / chunkCount);
+
+		// drop split points that collapse onto the same key frame
+		if (pos > bounds.back() && pos < end)
+			bounds.push_back(pos);
+	}
+
+	bounds.push_back(end);
+
+	const int n = (int)bounds.size() - 1;
+	if (n < 2) {
+		JobAddConfiguration(opt, szFileInput, pszInputDriver, szFileOutput, fCompatibility, pListAppended, 0, 0, true, 0);
+		return;
+	}
+
+	int digits = 2;
+	for(int i = n - 1; i >= 100; i /= 10)
+		++digits;
+
+	const VDStringW outputBase(szFileOutput, VDFileSplitExt(szFileOutput));
+	const wchar_t *outputExt = VDFileSplitExt(szFileOutput);
+	const uint64 groupId = g_VDJobQueue.GetUniqueId();
+
+	std::vector<VDStringA> partNames(n);
+
+	for(int i=0; i<n; ++i) {
+		VDStringW partName(outputBase);
+		partName.append_sprintf(L".%0*d", digits, i);
+		partName += outputExt;
+
+		partNames[i] = strCify(VDTextWToU8(partName).c_str());
+
+		JobScriptOutput output;
+
+		JobAddConfigurationInputs(output, szFileInput, pszInputDriver, pListAppended);
+		JobCreateScript(output, opt);
+		output.addf("VirtualDub.video.SetRangeFrames(%I64d,%I64d);", bounds[i], bounds[i+1]);
+		JobAddReloadMarker(output);
+		output.addf("VirtualDub.Save%sAVI(\"%s\");", fCompatibility ? "Compatible" : "", partNames[i].c_str());
+		JobAddClose(output);
+		JobCreateEntry(output, szFileInput, partName.c_str(), groupId, i, n);
+	}
+
+	JobScriptOutput output;
+
+	output.addf("VirtualDub.Open(\"%s\",\"\",0);", partNames[0].c_str());
+
+	for(int i=1; i<n; ++i)
+		output.addf("VirtualDub.Append(\"%s\");", partNames[i].c_str());
+
+	output.adds("VirtualDub.audio.SetSource(1);");
+	output.adds("VirtualDub.audio.SetMode(0);");
+	output.addf("VirtualDub.audio.SetInterleave(%d,%d,%d,%d,%d);",
+			opt->audio.enabled,
+			opt->audio.preload,
+			opt->audio.interval,
+			opt->audio.is_ms,
+			0);		// the offset was already applied to each chunk
+	output.adds("VirtualDub.video.SetMode(0);");
+	output.adds("VirtualDub.video.SetFrameRate2(0,0,1);");
+	output.adds("VirtualDub.subset.Delete();");
+	output.adds("VirtualDub.video.SetRange();");
+	JobAddReloadMarker(output);
+	output.addf("VirtualDub.Save%sAVI(\"%s\");", fCompatibility ? "Compatible" : "", strCify(VDTextWToU8(VDStringW(szFileOutput)).c_str()));
+	JobAddClose(output);
+	JobCreateEntry(output, szFileInput, szFileOutput, groupId, n, n);
+}
+
 void JobAddConfigurationImages(const DubOptions *opt, const wchar_t *szFileInput, const wchar_t *pszInputDriver, const wchar_t *szFilePrefix, const wchar_t *szFileSuffix, int minDigits, int imageFormat, int quality, List2<InputFilenameNode> *pListAppended) {
 	JobScriptOutput output;
 
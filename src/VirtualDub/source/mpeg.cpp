@@ -30,6 +30,7 @@
 #include <vd2/system/log.h>
 #include <vd2/system/file.h>
 #include <vd2/system/thread.h>
+#include <vd2/system/vdalloc.h>
 #include <vd2/system/VDRingBuffer.h>
 #include <vd2/system/memory.h>
 #include <vd2/Dita/resources.h>
@@ -1665,8 +1666,161 @@ unsigned MPEGAudioHeader::GetPayloadSizeL3() const {
 	return size;
 }
 
+//////////////////////////////////////////////////////////////////////////
+//
+//	AudioSourceMPEGDecodeWorker
+//
+//	Decodes a run of packets out of a compressed batch buffer on its own
+//	thread, using its own decoder instance.
+//
+//////////////////////////////////////////////////////////////////////////
+
+class AudioSourceMPEGDecodeWorker : public IVDMPEGAudioBitsource, protected VDThread {
+public:
+	AudioSourceMPEGDecodeWorker();
+	~AudioSourceMPEGDecodeWorker();
+
+	void Start(const char *data, const uint32 *offsets, long count, long decodeStart, long outputStart, sint16 *dst, uint32 frameElements);
+	bool Wait();
+
+	// IVDMPEGAudioBitsource methods
+	int read(void *buffer, int bytes);
+
+protected:
+	void ThreadRun();
+	bool Decode();
+
+	IVDMPEGAudioDecoder *mpDecoder;
+	VDSignal	msigStart;
+	VDSignal	msigDone;
+	volatile bool mbQuit;
+	bool		mbSuccess;
+
+	const char	*mpData;
+	const uint32 *mpOffsets;
+	long		mCount;
+	long		mDecodeStart;
+	long		mOutputStart;
+	sint16		*mpDst;
+	uint32		mFrameElements;
+
+	const char	*mpSrc;
+	const char	*mpSrcLimit;
+
+	sint16		mScratch[1152*2];
+};
+
+AudioSourceMPEGDecodeWorker::AudioSourceMPEGDecodeWorker()
+	: VDThread("MPEG audio decoder")
+	, mpDecoder(VDCreateMPEGAudioDecoder())
+	, mbQuit(false)
+	, mbSuccess(false)
+{
+	if (!mpDecoder)
+		throw MyMemoryError();
+
+	try {
+		mpDecoder->Init();
+		mpDecoder->SetSource(this);
+	} catch(int i) {
+		MyError e(mpDecoder->GetErrorString(i));
+		delete mpDecoder;
+		throw e;
+	}
+
+	if (!ThreadStart()) {
+		delete mpDecoder;
+		throw MyError("Unable to start MPEG audio decoding thread.");
+	}
+}
+
+AudioSourceMPEGDecodeWorker::~AudioSourceMPEGDecodeWorker() {
+	mbQuit = true;
+	msigStart.signal();
+	ThreadWait();
+
+	delete mpDecoder;
+}
+
+// Packets [0, decodeStart) only preload the layer III bit reservoir, and
+// packets [decodeStart, outputStart) only prime the synthesis filters; the
+// remaining packets are decoded to dst.
+void AudioSourceMPEGDecodeWorker::Start(const char *data, const uint32 *offsets, long count, long decodeStart, long outputStart, sint16 *dst, uint32 frameElements) {
+	mpData			= data;
+	mpOffsets		= offsets;
+	mCount			= count;
+	mDecodeStart	= decodeStart;
+	mOutputStart	= outputStart;
+	mpDst			= dst;
+	mFrameElements	= frameElements;
+
+	msigStart.signal();
+}
+
+bool AudioSourceMPEGDecodeWorker::Wait() {
+	msigDone.wait();
+	return mbSuccess;
+}
+
+int AudioSourceMPEGDecodeWorker::read(void *buffer, int bytes) {
+	if (bytes > mpSrcLimit - mpSrc)
+		bytes = (int)(mpSrcLimit - mpSrc);
+
+	memcpy(buffer, mpSrc, bytes);
+	mpSrc += bytes;
+
+	return bytes;
+}
+
+void AudioSourceMPEGDecodeWorker::ThreadRun() {
+	for(;;) {
+		msigStart.wait();
+
+		if (mbQuit)
+			break;
+
+		mbSuccess = Decode();
+		msigDone.signal();
+	}
+}
+
+bool AudioSourceMPEGDecodeWorker::Decode() {
+	// Any error fails the whole batch, in which case the source falls back
+	// to serial decoding to report or conceal it.
+	try {
+		mpDecoder->Reset();
+
+		for(long i=0; i<mCount; ++i) {
+			mpSrc = mpData + mpOffsets[i];
+			mpSrcLimit = mpData + mpOffsets[i+1];
+
+			if ((unsigned char)mpSrc[0] != 0xff || ((unsigned char)mpSrc[1]&0xe0)!=0xe0)
+				return false;
+
+			mpDecoder->SetDestination(i >= mOutputStart ? mpDst + mFrameElements * (i - mOutputStart) : mScratch);
+			mpDecoder->ReadHeader();
+
+			if (i < mDecodeStart)
+				mpDecoder->PrereadFrame();
+			else if (!mpDecoder->DecodeFrame())
+				return false;
+		}
+	} catch(int) {
+		return false;
+	}
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 class AudioSourceMPEG : public AudioSource, IVDMPEGAudioBitsource {
 private:
+	enum {
+		kMaxDecodeThreads		= 8,
+		kFramesPerDecodeThread	= 32		// frames decoded by each thread per parallel batch
+	};
+
 	vdrefptr<InputFileMPEG> parentPtr;
 	IVDMPEGAudioDecoder *mpDecoder;
 	void *pkt_buffer;
@@ -1677,12 +1831,27 @@ private:
 	long lCurrentPacket;
 	int layer;
 	int		mSamplesPerFrame;
+	int		mWarmupFrames;
+	int		mPhaseFrames;
 
 	bool	mbIsMPEG2;
 	ErrorMode	mErrorMode;
 
+	// parallel range decoding
+	uint32	mDecodeThreadCount;
+	vdfastvector<AudioSourceMPEGDecodeWorker *> mDecodeWorkers;
+	vdfastvector<char>		mBatchData;
+	vdfastvector<uint32>	mBatchOffsets;
+	vdfastvector<sint16>	mPCMCache;
+	long	mCacheFirst;
+	long	mCacheCount;
+
 	BOOL _isKey(LONG lSample);
 
+	long GetDecodeStartPacket(long packet) const;
+	long GetPrereadStartPacket(long packet) const;
+	bool DecodeParallel(long packet);
+
 public:
 	AudioSourceMPEG(InputFileMPEG *);
 	~AudioSourceMPEG();
@@ -1705,6 +1874,9 @@ public:
 AudioSourceMPEG::AudioSourceMPEG(InputFileMPEG *pp)
 	: AudioSource()
 	, mErrorMode(kErrorModeReportAll)
+	, mDecodeThreadCount(1)
+	, mCacheFirst(0)
+	, mCacheCount(0)
 {
 	parentPtr = pp;
 
@@ -1721,6 +1893,11 @@ AudioSourceMPEG::AudioSourceMPEG(InputFileMPEG *pp)
 }
 
 AudioSourceMPEG::~AudioSourceMPEG() {
+	while(!mDecodeWorkers.empty()) {
+		delete mDecodeWorkers.back();
+		mDecodeWorkers.pop_back();
+	}
+
 	delete pkt_buffer;
 	delete mpDecoder;
 }
@@ -1738,6 +1915,20 @@ void AudioSourceMPEG::init() {
 
 	mSamplesPerFrame = (layer==1 ? 384 : layer == 3 && header.IsMPEG2() ? 576 : 1152);
 
+	// The synthesis window holds 512 samples and layer III additionally
+	// overlaps each granule with the previous one, so a decode restarted
+	// at an arbitrary packet needs this many frames of history before its
+	// output matches a continuous decode.
+	mWarmupFrames = (mSamplesPerFrame < 1152 ? 2 : 1);
+
+	// The synthesis window is circular over 16 blocks of 32 samples, and
+	// the order of the windowing sums depends on its phase. Restarting only
+	// on multiples of this many frames keeps the phase identical to a
+	// decode from the start of the stream.
+	mPhaseFrames = (mSamplesPerFrame == 576 ? 8 : 4);
+
+	mDecodeThreadCount = std::min<uint32>(VDGetLogicalProcessorCount(), kMaxDecodeThreads);
+
 	mSampleFirst = 0;
 	mSampleLast = parentPtr->aframes * mSamplesPerFrame;
 
@@ -1792,7 +1983,22 @@ int AudioSourceMPEG::_read(VDPosition lStart64, uint32 lCount, void *lpBuffer, u
 	long samples, ba = getWaveFormat()->mBlockSize;
 
 	lAudioPacket = lStart/mSamplesPerFrame;
-	samples = mSamplesPerFrame - (lStart % mSamplesPerFrame);
+
+	// Reads that span more than one frame are decoded ahead in parallel
+	// batches, and are then served out of the PCM cache.
+	if (lpBuffer && mDecodeThreadCount > 1 && lCount != IVDStreamSource::kConvenient && (uint32)(lAudioPacket - mCacheFirst) >= (uint32)mCacheCount) {
+		const long lLastPacket = (long)((lStart + lCount - 1) / mSamplesPerFrame);
+
+		if (lLastPacket > lAudioPacket)
+			DecodeParallel(lAudioPacket);
+	}
+
+	const bool cached = (uint32)(lAudioPacket - mCacheFirst) < (uint32)mCacheCount;
+
+	if (cached)
+		samples = (mCacheFirst + mCacheCount) * mSamplesPerFrame - lStart;
+	else
+		samples = mSamplesPerFrame - (lStart % mSamplesPerFrame);
 
 	if (lCount != IVDStreamSource::kConvenient)
 		if (samples > lCount) samples = lCount;
@@ -1813,12 +2019,19 @@ int AudioSourceMPEG::_read(VDPosition lStart64, uint32 lCount, void *lpBuffer, u
 		return IVDStreamSource::kOK;
 	}
 
+	if (cached) {
+		memcpy(lpBuffer, &mPCMCache[(lStart - mCacheFirst * mSamplesPerFrame) * (ba/2)], samples*ba);
+
+		if (lSamplesRead) *lSamplesRead = samples;
+		if (lBytesRead) *lBytesRead = samples*ba;
+
+		return IVDStreamSource::kOK;
+	}
+
 	// Because of the overlap from the subband synthesis window, we must
-	// decode the previous packet in order to avoid glitches in the output.
-	// For layer III, we must also ensure that at least 511 bytes are present
-	// in the bit reservoir, as packets may dig that far back using
-	// main_data_begin.  An MPEG-1 stereo stream may use up to 32 bytes of
-	// the data payload for sideband information.
+	// decode previous packets in order to avoid glitches in the output
+	// (see GetDecodeStartPacket()). For layer III, we must also preload the
+	// bit reservoir (see GetPrereadStartPacket()).
 
 	if (lCurrentPacket != lAudioPacket) {
 		try {
@@ -1828,23 +2041,8 @@ int AudioSourceMPEG::_read(VDPosition lStart64, uint32 lCount, void *lpBuffer, u
 //				_RPT0(0,"Resetting...\n");
 				mpDecoder->Reset();
 
-				lCurrentPacket = lAudioPacket;
-				--lCurrentPacket;
-				if (lCurrentPacket < 0)
-					lCurrentPacket = 0;
-
-				nDecodeStart = lCurrentPacket;
-
-				// layer III: add packets to preload bit reservoir
-				if (layer == 3) {
-					long nReservoirDelay = 511;		// main_data_start is 9 bits (0..511)
-					
-					while(lCurrentPacket > 0 && nReservoirDelay > 0) {
-						--lCurrentPacket;
-
-						nReservoirDelay -= MPEGAudioHeader(parentPtr->audio_sample_list[lCurrentPacket].header).GetPayloadSizeL3();
-					}
-				}
+				nDecodeStart = GetDecodeStartPacket(lAudioPacket);
+				lCurrentPacket = GetPrereadStartPacket(nDecodeStart);
 			} else {
 				lCurrentPacket	= lAudioPacket;
 				nDecodeStart	= lAudioPacket;
@@ -1908,6 +2106,119 @@ int AudioSourceMPEG::_read(VDPosition lStart64, uint32 lCount, void *lpBuffer, u
 	return IVDStreamSource::kOK;
 }
 
+// Returns the first packet to fully decode in order to decode the given
+// packet exactly as a continuous decode from the start of the stream would.
+long AudioSourceMPEG::GetDecodeStartPacket(long packet) const {
+	long start = packet - mWarmupFrames;
+
+	if (start <= 0)
+		return 0;
+
+	return start - start % mPhaseFrames;
+}
+
+// Layer III packets may reach back up to 511 bytes into the payloads of
+// previous packets using main_data_begin, so those must be preread to fill
+// the bit reservoir.  An MPEG-1 stereo stream may use up to 32 bytes of
+// the data payload for sideband information.
+long AudioSourceMPEG::GetPrereadStartPacket(long packet) const {
+	if (layer != 3)
+		return packet;
+
+	long nReservoirDelay = 511;		// main_data_start is 9 bits (0..511)
+
+	while(packet > 0 && nReservoirDelay > 0) {
+		--packet;
+
+		nReservoirDelay -= MPEGAudioHeader(parentPtr->audio_sample_list[packet].header).GetPayloadSizeL3();
+	}
+
+	return packet;
+}
+
+// Decodes a batch of packets starting at the given packet into the PCM
+// cache, splitting them at frame boundaries across worker threads. Each
+// worker restarts its own decoder far enough back that its output is
+// identical to a serial decode. On any decoding error the cache is left
+// empty and false is returned, so that the serial path reports or conceals
+// the error.
+bool AudioSourceMPEG::DecodeParallel(long packet) {
+	long count = mDecodeThreadCount * kFramesPerDecodeThread;
+
+	if (count > parentPtr->aframes - packet)
+		count = parentPtr->aframes - packet;
+
+	mCacheFirst = 0;
+	mCacheCount = 0;
+
+	if (count < 2)
+		return false;
+
+	uint32 threads = (count + kFramesPerDecodeThread - 1) / kFramesPerDecodeThread;
+	if (threads > mDecodeThreadCount)
+		threads = mDecodeThreadCount;
+
+	const long chunkSize = (count + threads - 1) / threads;
+
+	mDecodeWorkers.reserve(threads);
+
+	while(mDecodeWorkers.size() < threads) {
+		vdautoptr<AudioSourceMPEGDecodeWorker> worker(new AudioSourceMPEGDecodeWorker);
+
+		mDecodeWorkers.push_back(worker.release());
+	}
+
+	// Read all of the compressed data on this thread, since the parent's
+	// stream reader isn't thread-safe.
+	const long readStart = GetPrereadStartPacket(GetDecodeStartPacket(packet));
+	const long readCount = packet + count - readStart;
+	uint32 pos = 0;
+
+	mBatchOffsets.resize(readCount + 1);
+	for(long i=0; i<readCount; ++i) {
+		mBatchOffsets[i] = pos;
+		pos += parentPtr->audio_sample_list[readStart + i].size;
+	}
+	mBatchOffsets[readCount] = pos;
+
+	mBatchData.resize(pos);
+	for(long i=0; i<readCount; ++i) {
+		const MPEGSampleInfo& msi = parentPtr->audio_sample_list[readStart + i];
+
+		parentPtr->ReadStream(mBatchData.data() + mBatchOffsets[i], msi.stream_pos, msi.size, TRUE);
+	}
+
+	const uint32 frameElements = mSamplesPerFrame * (getWaveFormat()->mBlockSize / 2);
+
+	mPCMCache.resize(frameElements * count);
+
+	uint32 started = 0;
+	for(; started < threads; ++started) {
+		const long chunkStart = packet + chunkSize * started;
+		if (chunkStart >= packet + count)
+			break;
+
+		const long chunkEnd = std::min<long>(chunkStart + chunkSize, packet + count);
+		const long decodeStart = GetDecodeStartPacket(chunkStart);
+		const long prereadStart = GetPrereadStartPacket(decodeStart);
+
+		mDecodeWorkers[started]->Start(mBatchData.data(), &mBatchOffsets[prereadStart - readStart], chunkEnd - prereadStart, decodeStart - prereadStart, chunkStart - prereadStart, &mPCMCache[frameElements * (chunkStart - packet)], frameElements);
+	}
+
+	bool success = true;
+	for(uint32 i=0; i<started; ++i) {
+		if (!mDecodeWorkers[i]->Wait())
+			success = false;
+	}
+
+	if (!success)
+		return false;
+
+	mCacheFirst = packet;
+	mCacheCount = count;
+	return true;
+}
+
 int AudioSourceMPEG::read(void *buffer, int bytes) {
 	if (pDecoderPoint+bytes > pDecoderLimit)
 		throw MyError("Incomplete audio frame");
@@ -502,7 +502,7 @@ bool VDDialogSelectVideoFormatW32::OnErase(VDZHDC hdc) {
 
 void VDDialogSelectVideoFormatW32::FormatItem::Init(int format) {
 	mFormat = format;
-	VDASSERTCT(nsVDPixmap::kPixFormat_Max_Standard == 57);
+	VDASSERTCT(nsVDPixmap::kPixFormat_Max_Standard == nsVDPixmap::kPixFormat_YUV420_P016 + 1);
 }
 
 void VDDialogSelectVideoFormatW32::FormatItem::GetText(int subItem, VDStringW& s) const {
@@ -513,6 +513,7 @@ void VDDialogSelectVideoFormatW32::FormatItem::GetText(int subItem, VDStringW& s
 				case nsVDPixmap::kPixFormat_RGB565:
 				case nsVDPixmap::kPixFormat_RGB888:
 				case nsVDPixmap::kPixFormat_XRGB8888:
+				case nsVDPixmap::kPixFormat_XRGB64:
 					s = L"RGB";
 					break;
 				case nsVDPixmap::kPixFormat_Y8:
@@ -543,6 +544,11 @@ void VDDialogSelectVideoFormatW32::FormatItem::GetText(int subItem, VDStringW& s
 				case nsVDPixmap::kPixFormat_YUV420it_Planar_FR:
 				case nsVDPixmap::kPixFormat_YUV420ib_Planar:
 				case nsVDPixmap::kPixFormat_YUV420ib_Planar_FR:
+				case nsVDPixmap::kPixFormat_YUV444_Planar16:
+				case nsVDPixmap::kPixFormat_YUV422_Planar16:
+				case nsVDPixmap::kPixFormat_YUV420_Planar16:
+				case nsVDPixmap::kPixFormat_YUV420_P010:
+				case nsVDPixmap::kPixFormat_YUV420_P016:
 					s = L"YCbCr (Rec.601)";
 					break;
 
@@ -577,6 +583,7 @@ void VDDialogSelectVideoFormatW32::FormatItem::GetText(int subItem, VDStringW& s
 				case nsVDPixmap::kPixFormat_RGB565:
 				case nsVDPixmap::kPixFormat_RGB888:
 				case nsVDPixmap::kPixFormat_XRGB8888:
+				case nsVDPixmap::kPixFormat_XRGB64:
 				case nsVDPixmap::kPixFormat_Y8_FR:
 				case nsVDPixmap::kPixFormat_YUV444_Planar_FR:
 				case nsVDPixmap::kPixFormat_YUV444_Planar_709_FR:
@@ -625,6 +632,11 @@ void VDDialogSelectVideoFormatW32::FormatItem::GetText(int subItem, VDStringW& s
 				case nsVDPixmap::kPixFormat_YUV411_Planar_709:
 				case nsVDPixmap::kPixFormat_YUV410_Planar:
 				case nsVDPixmap::kPixFormat_YUV410_Planar_709:
+				case nsVDPixmap::kPixFormat_YUV444_Planar16:
+				case nsVDPixmap::kPixFormat_YUV422_Planar16:
+				case nsVDPixmap::kPixFormat_YUV420_Planar16:
+				case nsVDPixmap::kPixFormat_YUV420_P010:
+				case nsVDPixmap::kPixFormat_YUV420_P016:
 					s = L"Limited";
 					break;
 			}
@@ -644,6 +656,9 @@ void VDDialogSelectVideoFormatW32::FormatItem::GetText(int subItem, VDStringW& s
 				case nsVDPixmap::kPixFormat_XRGB8888:
 					s = L"32-bit (8888)";
 					break;
+				case nsVDPixmap::kPixFormat_XRGB64:
+					s = L"64-bit (16161616)";
+					break;
 				case nsVDPixmap::kPixFormat_Y8:
 				case nsVDPixmap::kPixFormat_Y8_FR:
 					s = L"8-bit";
@@ -710,6 +725,21 @@ void VDDialogSelectVideoFormatW32::FormatItem::GetText(int subItem, VDStringW& s
 				case nsVDPixmap::kPixFormat_YUV422_V210:
 					s = L"4:2:2 10-bit (V210)";
 					break;
+				case nsVDPixmap::kPixFormat_YUV444_Planar16:
+					s = L"4:4:4 16-bit";
+					break;
+				case nsVDPixmap::kPixFormat_YUV422_Planar16:
+					s = L"4:2:2 16-bit";
+					break;
+				case nsVDPixmap::kPixFormat_YUV420_Planar16:
+					s = L"4:2:0 16-bit";
+					break;
+				case nsVDPixmap::kPixFormat_YUV420_P010:
+					s = L"4:2:0 10-bit (P010)";
+					break;
+				case nsVDPixmap::kPixFormat_YUV420_P016:
+					s = L"4:2:0 16-bit (P016)";
+					break;
 			}
 			break;
 
@@ -751,6 +781,12 @@ void VDDialogSelectVideoFormatW32::FormatItem::GetText(int subItem, VDStringW& s
 				case nsVDPixmap::kPixFormat_YUV422_YUYV_FR:
 				case nsVDPixmap::kPixFormat_YUV422_YUYV_709_FR:
 				case nsVDPixmap::kPixFormat_YUV422_V210:
+				case nsVDPixmap::kPixFormat_XRGB64:
+				case nsVDPixmap::kPixFormat_YUV444_Planar16:
+				case nsVDPixmap::kPixFormat_YUV422_Planar16:
+				case nsVDPixmap::kPixFormat_YUV420_Planar16:
+				case nsVDPixmap::kPixFormat_YUV420_P010:
+				case nsVDPixmap::kPixFormat_YUV420_P016:
 					s = L"-";
 					break;
 				case nsVDPixmap::kPixFormat_YUV422_Planar_Centered:
@@ -1161,37 +1197,6 @@ void VDShowPerformanceDialog(VDGUIHandle hParent) {
 	dlg.ShowDialog(hParent);
 }
 
-INT_PTR CALLBACK DynamicCompileOptionsDlgProc( HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam)
-{
-	DubOptions *dopt = (DubOptions *)GetWindowLongPtr(hDlg, DWLP_USER);
-
-    switch (message)
-    {
-        case WM_INITDIALOG:
-			SetWindowLongPtr(hDlg, DWLP_USER, lParam);
-			dopt = (DubOptions *)lParam;
-
-			CheckDlgButton(hDlg, IDC_ENABLE, dopt->perf.dynamicEnable);
-			CheckDlgButton(hDlg, IDC_DISPLAY_CODE, dopt->perf.dynamicShowDisassembly);
-
-            return (TRUE);
-
-        case WM_COMMAND:
-			switch(LOWORD(wParam)) {
-			case IDOK:
-				dopt->perf.dynamicEnable = !!IsDlgButtonChecked(hDlg, IDC_ENABLE);
-				dopt->perf.dynamicShowDisassembly = !!IsDlgButtonChecked(hDlg, IDC_DISPLAY_CODE);
-				EndDialog(hDlg, TRUE);
-				return TRUE;
-			case IDCANCEL:
-				EndDialog(hDlg, FALSE);
-				return TRUE;
-			}
-            break;
-    }
-    return FALSE;
-}
-
 ///////////////////////////////////////////////////////////////////////////
 //
 //	video frame rate dialog
@@ -1513,11 +1513,13 @@ void VDProject::Close() {
 	}
 }
 
-void VDProject::SaveAVI(const wchar_t *filename, bool compat, bool addAsJob) {
+void VDProject::SaveAVI(const wchar_t *filename, bool compat, bool addAsJob, int jobChunkCount) {
 	if (!inputVideo)
 		throw MyError("No input file to process.");
 
-	if (addAsJob)
+	if (addAsJob && jobChunkCount > 1)
+		JobAddConfigurationChunked(&g_dubOpts, g_szInputAVIFile, mInputDriverName.c_str(), filename, compat, &inputAVI->listFiles, jobChunkCount);
+	else if (addAsJob)
 		JobAddConfiguration(&g_dubOpts, g_szInputAVIFile, mInputDriverName.c_str(), filename, compat, &inputAVI->listFiles, 0, 0, true, 0);
 	else
 		::SaveAVI(filename, false, NULL, compat);
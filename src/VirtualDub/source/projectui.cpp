@@ -352,7 +352,6 @@ namespace {
 		{ ID_AUDIO_MODE_FULL,			"Audio.SetModeFull" },
 		{ ID_AUDIO_ERRORMODE,			"Audio.ShowErrorModeDialog" },
 		{ ID_OPTIONS_PERFORMANCE,		"Options.ShowPerformanceDialog" },
-		{ ID_OPTIONS_DYNAMICCOMPILATION,	"Options.ShowJITDialog" },
 		{ ID_OPTIONS_PREFERENCES,		"Options.ShowPreferencesDialog" },
 		{ ID_OPTIONS_KEYBOARDSHORTCUTS,	"Options.ShowShortcutsDialog" },
 		{ ID_OPTIONS_PLUGINS,			"Options.ShowPluginsDialog" },
@@ -1923,10 +1922,6 @@ bool VDProjectUI::MenuHit(UINT id) {
 			VDShowPerformanceDialog((VDGUIHandle)mhwnd);
 			break;
 
-		case ID_OPTIONS_DYNAMICCOMPILATION:
-			ActivateDubDialog(g_hInst, MAKEINTRESOURCE(IDD_PERF_DYNAMIC), (HWND)mhwnd, DynamicCompileOptionsDlgProc);
-			break;
-
 		case ID_OPTIONS_EXTERNALENCODERS:
 			VDUIDisplayDialogConfigureExternalEncoders((VDGUIHandle)mhwnd);
 			break;
@@ -2,6 +2,8 @@
 #define f_VD2_KASUMI_BLITTER_H
 
 #include <vd2/system/vectors.h>
+#include <vd2/system/vdstl.h>
+#include <vd2/system/thread.h>
 
 struct VDPixmap;
 struct VDPixmapLayout;
@@ -16,6 +18,80 @@ public:
 IVDPixmapBlitter *VDPixmapCreateBlitter(const VDPixmap& dst, const VDPixmap& src);
 IVDPixmapBlitter *VDPixmapCreateBlitter(const VDPixmapLayout& dst, const VDPixmapLayout& src);
 
+struct VDPixmapBlitterCacheStats {
+	uint32	mHits;
+	uint32	mMisses;
+	uint32	mEvictions;
+	uint32	mIdleBlitters;
+	uint32	mActiveBlitters;
+};
+
+///////////////////////////////////////////////////////////////////////////
+//	VDPixmapBlitterCache
+//
+//	Thread-safe pool of compiled blitters, keyed by the format and size of
+//	the source and destination and by the enabled CPU extensions, which
+//	decide the generators a blitter is compiled with. Blitters hold per-blit
+//	state, so each one is checked out for exclusive use by Acquire() and
+//	must be handed back with Release(), after which it can be reused by any
+//	other caller asking for the same conversion. Idle blitters beyond the
+//	limit are freed on a least-recently-used basis.
+//
+class VDPixmapBlitterCache {
+	VDPixmapBlitterCache(const VDPixmapBlitterCache&);
+	VDPixmapBlitterCache& operator=(const VDPixmapBlitterCache&);
+public:
+	VDPixmapBlitterCache(uint32 maxIdleBlitters = 16);
+	~VDPixmapBlitterCache();
+
+	IVDPixmapBlitter *Acquire(const VDPixmap& dst, const VDPixmap& src);
+	IVDPixmapBlitter *Acquire(const VDPixmapLayout& dst, const VDPixmapLayout& src);
+	void Release(IVDPixmapBlitter *blitter);
+
+	/// Frees all idle blitters. Blitters that are checked out are not
+	/// affected.
+	void Flush();
+
+	void GetStats(VDPixmapBlitterCacheStats& stats);
+	void ResetStats();
+
+protected:
+	struct Entry {
+		sint32	mDstW;
+		sint32	mDstH;
+		sint32	mDstFormat;
+		sint32	mSrcW;
+		sint32	mSrcH;
+		sint32	mSrcFormat;
+		long	mCPUExtensions;
+		uint32	mLastUse;
+		bool	mbActive;
+		IVDPixmapBlitter *mpBlitter;
+
+		bool Matches(const Entry& e) const {
+			return mDstW == e.mDstW && mDstH == e.mDstH && mDstFormat == e.mDstFormat
+				&& mSrcW == e.mSrcW && mSrcH == e.mSrcH && mSrcFormat == e.mSrcFormat
+				&& mCPUExtensions == e.mCPUExtensions;
+		}
+	};
+
+	IVDPixmapBlitter *Lookup(const Entry& key);
+	void Add(const Entry& key, IVDPixmapBlitter *blitter);
+	void Trim();
+
+	VDCriticalSection mMutex;
+	vdfastvector<Entry> mEntries;
+	uint32	mMaxIdleBlitters;
+	uint32	mIdleBlitters;
+	uint32	mUseCounter;
+	uint32	mHits;
+	uint32	mMisses;
+	uint32	mEvictions;
+};
+
+/// Returns the process-wide blitter cache.
+VDPixmapBlitterCache& VDPixmapGetBlitterCache();
+
 class VDPixmapCachedBlitter {
 	VDPixmapCachedBlitter(const VDPixmapCachedBlitter&);
 	VDPixmapCachedBlitter& operator=(const VDPixmapCachedBlitter&);
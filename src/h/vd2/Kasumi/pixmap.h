@@ -66,6 +66,12 @@ namespace nsVDPixmap {
 		kPixFormat_YUV420ib_Planar_FR,
 		kPixFormat_YUV420ib_Planar_709,
 		kPixFormat_YUV420ib_Planar_709_FR,
+		kPixFormat_XRGB64,
+		kPixFormat_YUV444_Planar16,
+		kPixFormat_YUV422_Planar16,
+		kPixFormat_YUV420_Planar16,
+		kPixFormat_YUV420_P010,				// 10-bit data in the high bits of 16-bit words
+		kPixFormat_YUV420_P016,
 		kPixFormat_Max_Standard
 	};
 }
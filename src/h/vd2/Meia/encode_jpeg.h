@@ -1,4 +1,5 @@
 //	VirtualDub - Video processing and capture application
+//	Video decoding/encoding library
 //	Copyright (C) 1998-2004 Avery Lee
 //
 //	This program is free software; you can redistribute it and/or modify
@@ -15,12 +16,11 @@
 //	along with this program; if not, write to the Free Software
 //	Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 
-#ifndef f_IMAGEJPEG_H
-#define f_IMAGEJPEG_H
+#ifndef f_VD2_MEIA_ENCODE_JPEG_H
+#define f_VD2_MEIA_ENCODE_JPEG_H
 
 #include <vd2/system/vdtypes.h>
 #include <vd2/system/vdstl.h>
-#include <vector>
 
 class VDINTERFACE IVDJPEGEncoder {
 public:
@@ -38,6 +38,10 @@ public:
 
 	virtual ~IVDJPEGEncoder() {}
 
+	// Enables encoding bands of MCU rows on separate threads. Each MCU row
+	// is then ended with a restart marker, so the output is slightly larger.
+	virtual void SetParallelMode(bool enable) = 0;
+
 	virtual void Init(int quality = 50, bool bOptimizeHuffmanTables = false, eChromaMode cmode = kYCC420) = 0;
 	virtual void Encode(vdfastvector<char>& dst, const char *src, ptrdiff_t stride_pixels, int format, int w, int h) = 0;
 };
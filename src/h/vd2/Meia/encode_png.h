@@ -26,6 +26,11 @@ struct VDPixmap;
 class VDINTERFACE IVDImageEncoderPNG {
 public:
 	virtual ~IVDImageEncoderPNG() {}
+
+	// Enables splitting large images into row bands that are compressed on
+	// separate threads. The output is slightly larger.
+	virtual void SetParallelMode(bool enable) = 0;
+
 	virtual void Encode(const VDPixmap& px, const void *&p, uint32& len, bool quick_compress) = 0;
 };
 
@@ -36,6 +36,10 @@ public:
 	uint64		mDateStart;		///< Same units as NT FILETIME.
 	uint64		mDateEnd;		///< Same units as NT FILETIME.
 
+	uint64		mChunkGroupId;	///< Nonzero if the job is part of a render that was split into chunks.
+	int			mChunkIndex;	///< Index of the chunk; equal to mChunkCount for the job that joins the chunks.
+	int			mChunkCount;
+
 	typedef VDAutoLogger::tEntries tLogEntries;
 	tLogEntries	mLogEntries;
 
@@ -64,6 +68,9 @@ public:
 	const char *	GetRunnerName() const			{ return mRunnerName.c_str(); }
 	uint64			GetRunnerId() const				{ return mRunnerId; }
 
+	bool	IsChunk() const { return mChunkGroupId != 0; }
+	bool	IsChunkJoin() const { return mChunkGroupId && mChunkIndex >= mChunkCount; }
+
 	bool	IsRunning() const { return mState == kStateInProgress || mState == kStateAborting; }
 	bool	IsModified() const { return mbModified; }
 	void	SetModified(bool mod) { mbModified = mod; }
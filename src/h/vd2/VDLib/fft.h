@@ -48,6 +48,48 @@ protected:
 	float *mpWeightTable;
 };
 
+/// Planned complex FFT of arbitrary length. Data is interleaved (re, im)
+/// in natural order on both input and output. Power-of-two lengths run
+/// directly on the table-driven radix-4 engine; other lengths are mapped
+/// onto a larger power-of-two transform with Bluestein's chirp-z
+/// algorithm. The plan owns scratch space, so a single instance must not be
+/// used from more than one thread at a time.
+class VDComplexFFT {
+public:
+	VDComplexFFT();
+	VDComplexFFT(uint32 points);
+	~VDComplexFFT();
+
+	void Init(uint32 points);
+	void Shutdown();
+
+	uint32 GetPointCount() const { return mPoints; }
+
+	/// Forward transform, exp(-2*pi*i*n*k/N) kernel.
+	void Transform(float *p);
+
+	/// Inverse transform, exp(+2*pi*i*n*k/N) kernel. The result is not
+	/// scaled; multiply by 1/N to invert Transform().
+	void InverseTransform(float *p);
+
+	/// Forward-transform several channels sharing this plan. Each channel
+	/// is GetPointCount() complex values; pitch is in floats.
+	void TransformBatch(float *p, uint32 channels, ptrdiff_t pitch);
+	void InverseTransformBatch(float *p, uint32 channels, ptrdiff_t pitch);
+
+protected:
+	void TransformPow2(float *p);
+	void TransformBluestein(float *p);
+
+	uint32	mPoints;
+	uint32	mBits;				// log2 of the underlying power-of-two transform
+	uint32	*mpPermuteTable;
+	float	*mpTwiddleTable;
+	float	*mpChirp;			// exp(-pi*i*n^2/N), N entries
+	float	*mpChirpSpectrum;	// FFT of the conjugate chirp, 2^mBits entries
+	float	*mpWorkArea;		// 2^mBits entries
+};
+
 class VDRollingRealFFT {
 public:
 	VDRollingRealFFT();
@@ -65,6 +65,7 @@ public:
 
 	virtual bool OnEvent(uint32 event, const void *eventData);
 	virtual bool OnInvalidateCaches();
+	virtual bool OnGetPointTable(const VDXFilterPointTable& table);
 
 	static void __cdecl FilterDeinit   (VDXFilterActivation *fa, const VDXFilterFunctions *ff);
 	static int  __cdecl FilterRun      (const VDXFilterActivation *fa, const VDXFilterFunctions *ff);
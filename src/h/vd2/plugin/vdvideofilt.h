@@ -72,6 +72,16 @@ enum {
 	///
 	FILTERPARAM_PURE_TRANSFORM		= 0x00000010L,
 
+	/// Filter's output is a per-channel lookup table applied to the source image (V18+). The output
+	/// has the same layout and timing as the input, and every 8-bit channel is mapped through its own
+	/// 256 entry table, which the host retrieves with kVDXVFEvent_GetPointTable after the filter has
+	/// started. This allows the host to compose the tables of adjacent filters and apply them in a
+	/// single pass instead of running each filter. The filter must still implement runProc.
+	///
+	/// Supported only for 8-bit RGB and YCbCr formats.
+	///
+	FILTERPARAM_POINT_TRANSFORM		= 0x00000020L,
+
 	/// Filter cannot support the requested source format. Note that this sets all bits, so the meaning
 	/// of other bits is ignored. The one exception is that FILTERPARAM_SUPPORTS_ALTFORMATS is assumed
 	/// to be implicitly set.
@@ -98,7 +108,16 @@ class IVDXAContext;
 
 enum {
 	kVDXVFEvent_None				= 0,
-	kVDXVFEvent_InvalidateCaches	= 1
+	kVDXVFEvent_InvalidateCaches	= 1,
+	kVDXVFEvent_GetPointTable		= 2		// (V18+) eventData is VDXFilterPointTable
+};
+
+/// Event data for kVDXVFEvent_GetPointTable. The filter fills in one table per
+/// channel: red, green, and blue for RGB formats, or Y, Cb, and Cr for YCbCr
+/// formats. Channels that the filter does not change must receive an identity
+/// table. The filter returns true from the event if the tables are valid.
+struct VDXFilterPointTable {
+	uint8 *mpTables[3];
 };
 
 typedef int  (__cdecl *VDXFilterInitProc     )(VDXFilterActivation *fa, const VDXFilterFunctions *ff);
@@ -178,7 +197,7 @@ public:
 
 enum {
 	// This is the highest API version supported by this header file.
-	VIRTUALDUB_FILTERDEF_VERSION		= 17,
+	VIRTUALDUB_FILTERDEF_VERSION		= 18,
 
 	// This is the absolute lowest API version supported by this header file.
 	// Note that V4 is rather old, corresponding to VirtualDub 1.2.
@@ -207,6 +226,8 @@ enum {
 // v14 (1.9.1): added copyProc2, prefetchProc2, input/output frame arrays
 // v15 (1.9.3): added VDXA support
 // v16 (1.10.x): added multi-source support, feature deprecation
+// v17 (1.10.2): added static about/configure procs
+// v18 (1.10.4): added point transform tables
 
 struct VDXFilterDefinition {
 	void *_next;		// deprecated - set to NULL
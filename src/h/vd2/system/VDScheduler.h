@@ -42,6 +42,7 @@ public:
 
 	void setSignal(VDSignal *);
 	VDSignal *getSignal() { return pWakeupSignal; }
+	void setIdleSignal(VDSignal *pSignal) { pIdleSignal = pSignal; }	///< Signaled when the last running node returns with no nodes ready.
 	void setSchedulerNode(VDSchedulerNode *pSchedulerNode);
 
 	IVDAsyncErrorCallback *getErrorCallback() const { return mpErrorCB; }
@@ -62,13 +63,17 @@ public:
 	void Remove(VDSchedulerNode *pNode);			///< Remove node from scheduler.
 	void DumpStatus();
 
+	bool IsIdle();									///< Returns true if no nodes are ready or running.
+
 protected:
 	void Repost(VDSchedulerNode *, bool);
 
 	VDCriticalSection csScheduler;
 	IVDAsyncErrorCallback	*mpErrorCB;
 	VDSignal *pWakeupSignal;
+	VDSignal *pIdleSignal;
 	volatile bool	mbExitThreads;
+	uint32	mRunningNodes;
 	VDSchedulerNode *pParentSchedulerNode;
 
 	typedef vdlist<VDSchedulerNode> tNodeList;
@@ -0,0 +1,78 @@
+//	VirtualDub - Video processing and capture application
+//	System library component
+//	Copyright (C) 1998-2011 Avery Lee, All Rights Reserved.
+//
+//	Beginning with 1.6.0, the VirtualDub system library is licensed
+//	differently than the remainder of VirtualDub.  This particular file is
+//	thus licensed as follows (the "zlib" license):
+//
+//	This software is provided 'as-is', without any express or implied
+//	warranty.  In no event will the authors be held liable for any
+//	damages arising from the use of this software.
+//
+//	Permission is granted to anyone to use this software for any purpose,
+//	including commercial applications, and to alter it and redistribute it
+//	freely, subject to the following restrictions:
+//
+//	1.	The origin of this software must not be misrepresented; you must
+//		not claim that you wrote the original software. If you use this
+//		software in a product, an acknowledgment in the product
+//		documentation would be appreciated but is not required.
+//	2.	Altered source versions must be plainly marked as such, and must
+//		not be misrepresented as being the original software.
+//	3.	This notice may not be removed or altered from any source
+//		distribution.
+
+#ifndef f_VD2_SYSTEM_BANDTASK_H
+#define f_VD2_SYSTEM_BANDTASK_H
+
+#include <vd2/system/vdtypes.h>
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Band tasks
+//
+//	Work that can be split into independent bands, such as groups of
+//	scanlines, is run on a process-wide pool of worker threads that is
+//	started on first use and shared by all callers. The calling thread
+//	runs the first band itself and helps with other queued bands while it
+//	waits, so band tasks may be started from within other band tasks.
+//
+//	If bands throw, the remaining bands still run to completion and the
+//	first error is rethrown from VDRunBandTask(). An error from the first
+//	band, which runs on the calling thread, is rethrown as-is; errors from
+//	worker threads other than MyError are reported as a generic MyError.
+//
+///////////////////////////////////////////////////////////////////////////
+
+class VDBandTask {
+public:
+	virtual void RunBand(uint32 band, uint32 bandCount) = 0;
+};
+
+/// Returns the number of bands worth using for an amount of work, which
+/// is one unless there is at least twice the minimum per band. The result
+/// is limited to maxBands, the number of logical processors, and the number
+/// of indivisible units (rows, tiles) that the work consists of.
+uint32 VDGetBandCount(uint64 work, uint64 minWorkPerBand, uint32 maxBands, uint32 units);
+
+/// Runs bands [0, bandCount) and returns when all of them have completed.
+void VDRunBandTask(VDBandTask& task, uint32 bandCount);
+
+///////////////////////////////////////////////////////////////////////////
+//
+//	Row tasks
+//
+//	Images whose output scanlines can be computed independently are split
+//	into horizontal bands of about 128K each, up to eight bands.
+//
+///////////////////////////////////////////////////////////////////////////
+
+class VDRowTask {
+public:
+	virtual void RunRows(uint32 y1, uint32 y2) = 0;
+};
+
+void VDRunRowTask(VDRowTask& task, uint32 rows, uint32 rowBytes);
+
+#endif
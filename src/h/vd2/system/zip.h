@@ -32,6 +32,7 @@
 #include <vd2/system/file.h>
 #include <vd2/system/file.h>
 #include <vd2/system/VDString.h>
+#include <vd2/system/vdstl.h>
 #include <string.h>
 #include <vector>
 
@@ -131,8 +132,8 @@ public:
 		kCRC32		= 0xEDB88320		// CRC-32 used by PKZIP, PNG (x^32 + x^26 + x^23 + x^22 + x^16 + x^12 + x^11 + x^10 + x^8 + x^7 + x^5 + x^4 + x^2 + x^1 + 1)
 	};
 
-	VDCRCChecker() {}
-	VDCRCChecker(uint32 crc) { Init(crc); }
+	VDCRCChecker() : mPoly(0) {}
+	VDCRCChecker(uint32 crc) : mPoly(0) { Init(crc); }
 
 	void Init(uint32 crc);
 	void Process(const void *src, sint32 len);
@@ -142,7 +143,32 @@ public:
 
 protected:
 	uint32	mValue;
-	uint32	mTable[256];
+	uint32	mPoly;				// polynomial that the tables were built for
+	uint32	mTable[8][256];		// slicing-by-8 tables; mTable[0] is the usual byte table
+};
+
+/// Computes the Adler-32 checksum of a block of memory.
+class VDAdler32Checker {
+public:
+	VDAdler32Checker() : mS1(1), mS2(0) {}
+
+	void Process(const void *src, sint32 len);
+
+	uint32 Adler32() const { return mS1 + (mS2 << 16); }
+
+	static uint32 Adler32(const void *src, sint32 len) {
+		VDAdler32Checker checker;
+		checker.Process(src, len);
+		return checker.Adler32();
+	}
+
+	/// Returns the checksum of two runs of data from their separate
+	/// checksums and the length of the second run.
+	static uint32 Combine(uint32 adler1, uint32 adler2, uint64 len2);
+
+protected:
+	uint32	mS1;
+	uint32	mS2;
 };
 
 class VDZipStream : public IVDStream {
@@ -164,6 +190,7 @@ public:
 
 protected:
 	bool	ParseBlockHeader();
+	void	PairLiteralCodes();
 	bool	Inflate();
 
 	VDDeflateBitReader mBits;					// critical -- make this first!
@@ -182,13 +209,109 @@ protected:
 	sint64	mPos;
 	uint8	mBuffer[65536];
 
-	uint16	mCodeDecode[32768];
+	uint32	mCodeDecode[32768];			// symbol, or a pair of literals and their total length
 	uint8	mCodeLengths[288 + 32];
 	uint16	mDistDecode[32768];
 
 	VDCRCChecker	mCRCChecker;
 };
 
+/// Compresses data to a Deflate stream, optionally with a zlib header and
+/// Adler-32 trailer. Compressed data accumulates in the output buffer until
+/// the caller takes it.
+class VDDeflateEncoder {
+public:
+	VDDeflateEncoder();
+	VDDeflateEncoder(const VDDeflateEncoder&);
+	~VDDeflateEncoder();
+
+	VDDeflateEncoder& operator=(const VDDeflateEncoder&);
+
+	void Init(bool quick, bool zlibWrapper = true);
+	void Write(const void *src, size_t len);
+	void ForceNewBlock();
+
+	/// Compresses all pending data and ends the output on a byte boundary
+	/// with an empty stored block, so that another raw Deflate stream can be
+	/// appended after it.
+	void SyncFlush();
+
+	void Finish();
+
+	uint32 EstimateOutputSize();
+
+	vdfastvector<uint8>& GetOutput() { return mOutput; }
+
+protected:
+	void EndBlock(bool term);
+	void Compress(bool flush);
+	void PutBits(uint32 encoding, int enclen);
+	void FlushBits();
+	uint32 Flush(int n, int ndists, bool term, bool test);
+
+	uint32	mAccum;
+	int		mAccBits;
+	uint32	mHistoryPos;
+	uint32	mHistoryTail;
+	uint32	mHistoryBase;
+	uint32	mHistoryBlockStart;
+	uint32	mLenExtraBits;
+	uint32	mPendingLen;
+	uint8	*mpLen;
+	uint16	*mpCode;
+	uint16	*mpDist;
+
+	uint32	mWindowLimit;
+	bool	mbZlibWrapper;
+
+	vdfastvector<uint8> mOutput;
+	VDAdler32Checker mAdler32;
+
+	// Block coding tables
+	uint16	mCodeEnc[288];
+	int		mCodeLen[288];
+
+	uint16	mDistEnc[32];
+	int		mDistLen[32];
+
+	uint8	mHistoryBuffer[65536+6];
+	sint32	mHashNext[32768];
+	sint32	mHashTable[65536];
+	uint8	mLenBuf[32769];
+	uint16	mCodeBuf[32769];
+	uint16	mDistBuf[32769];
+};
+
+/// Write-only stream that compresses to raw Deflate data in another stream.
+class VDDeflateStream : public IVDStream {
+public:
+	VDDeflateStream(IVDStream *pDst, bool quick = false);
+	~VDDeflateStream();
+
+	void	EnableCRC(uint32 crc = VDCRCChecker::kCRC32) { mCRCChecker.Init(crc); mbCRCEnabled = true; }
+	uint32	CRC() { return mCRCChecker.CRC(); }
+
+	const wchar_t *GetNameForError();
+
+	sint64	Pos();
+	void	Read(void *buffer, sint32 bytes);
+	sint32	ReadData(void *buffer, sint32 bytes);
+	void	Write(const void *buffer, sint32 bytes);
+
+	void	Finish();
+
+protected:
+	void	FlushOutput();
+
+	IVDStream	*mpDst;
+	sint64	mPos;
+	bool	mbCRCEnabled;
+	bool	mbFinished;
+
+	VDCRCChecker		mCRCChecker;
+	VDDeflateEncoder	mEncoder;
+};
+
 class VDZipArchive {
 public:
 	struct FileInfo {
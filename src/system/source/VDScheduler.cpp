@@ -33,8 +33,10 @@
 VDScheduler::VDScheduler()
 	: mpErrorCB(NULL)
 	, pWakeupSignal(NULL)
+	, pIdleSignal(NULL)
 	, pParentSchedulerNode(NULL)
 	, mbExitThreads(false)
+	, mRunningNodes(0)
 {
 }
 
@@ -56,6 +58,8 @@ void VDScheduler::BeginShutdown() {
 
 void VDScheduler::Repost(VDSchedulerNode *pNode, bool bReschedule) {
 	vdsynchronized(csScheduler) {
+		--mRunningNodes;
+
 		if (pNode->bCondemned) {
 			tSuspendList::iterator it(listSuspends.begin()), itEnd(listSuspends.end());
 
@@ -77,6 +81,9 @@ void VDScheduler::Repost(VDSchedulerNode *pNode, bool bReschedule) {
 			} else
 				listWaiting.push_back(pNode);
 		}
+
+		if (pIdleSignal && !mRunningNodes && listReady.empty())
+			pIdleSignal->signal();
 	}
 }
 
@@ -88,6 +95,7 @@ bool VDScheduler::Run() {
 			listReady.pop_front();
 			pNode->bRunning = true;
 			pNode->bReady = false;
+			++mRunningNodes;
 		}
 	}
 
@@ -98,15 +106,20 @@ bool VDScheduler::Run() {
 	try {
 		bReschedule = pNode->Service();
 	} catch(MyError& e) {
-		Repost(pNode, false);
+		bool handled = true;
 
+		// Report the error before reposting the node, so that anyone waiting
+		// for the scheduler to go idle sees the error once it does.
 		vdsynchronized(csScheduler) {
-			if (mpErrorCB) {
-				if (!mpErrorCB->OnAsyncError(e))
-					throw;
-			}
+			if (mpErrorCB)
+				handled = mpErrorCB->OnAsyncError(e);
 		}
 
+		Repost(pNode, false);
+
+		if (!handled)
+			throw;
+
 		return true;
 	} catch(...) {
 		Repost(pNode, false);
@@ -219,6 +232,12 @@ void VDScheduler::Remove(VDSchedulerNode *pNode) {
 		suspendNode.mSignal.wait();
 }
 
+bool VDScheduler::IsIdle() {
+	VDCriticalSection::AutoLock lock(csScheduler);
+
+	return !mRunningNodes && listReady.empty();
+}
+
 void VDScheduler::DumpStatus() {
 	vdsynchronized(csScheduler) {
 		VDDEBUG2("\n    Waiting nodes:\n");
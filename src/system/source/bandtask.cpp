@@ -0,0 +1,260 @@
+//	VirtualDub - Video processing and capture application
+//	System library component
+//	Copyright (C) 1998-2011 Avery Lee, All Rights Reserved.
+//
+//	Beginning with 1.6.0, the VirtualDub system library is licensed
+//	differently than the remainder of VirtualDub.  This particular file is
+//	thus licensed as follows (the "zlib" license):
+//
+//	This software is provided 'as-is', without any express or implied
+//	warranty.  In no event will the authors be held liable for any
+//	damages arising from the use of this software.
+//
+//	Permission is granted to anyone to use this software for any purpose,
+//	including commercial applications, and to alter it and redistribute it
+//	freely, subject to the following restrictions:
+//
+//	1.	The origin of this software must not be misrepresented; you must
+//		not claim that you wrote the original software. If you use this
+//		software in a product, an acknowledgment in the product
+//		documentation would be appreciated but is not required.
+//	2.	Altered source versions must be plainly marked as such, and must
+//		not be misrepresented as being the original software.
+//	3.	This notice may not be removed or altered from any source
+//		distribution.
+
+#include "stdafx.h"
+#include <vd2/system/atomic.h>
+#include <vd2/system/bandtask.h>
+#include <vd2/system/error.h>
+#include <vd2/system/thread.h>
+#include <vd2/system/vdalloc.h>
+#include <vd2/system/VDScheduler.h>
+
+namespace {
+	struct VDBandTaskJob {
+		VDBandTask *mpTask;
+		uint32		mBandCount;
+		VDAtomicInt	mPending;
+		VDSignal	mDoneSignal;
+		VDAtomicPtr<MyError>	mpError;
+
+		VDBandTaskJob() : mpError(NULL) {}
+		~VDBandTaskJob() { delete mpError; }
+
+		void SetError(MyError& e);
+		void ThrowError();
+	};
+
+	// Keeps the first error thrown by a band; later ones are dropped.
+	void VDBandTaskJob::SetError(MyError& e) {
+		MyError *p = new MyError;
+
+		p->TransferFrom(e);
+
+		if (mpError.compareExchange(p, NULL))
+			delete p;
+	}
+
+	void VDBandTaskJob::ThrowError() {
+		MyError *e = mpError.xchg(NULL);
+
+		if (e) {
+			MyError tmp;
+			tmp.TransferFrom(*e);
+			delete e;
+
+			throw tmp;
+		}
+	}
+
+	class VDBandTaskNode : public VDSchedulerNode {
+	public:
+		VDBandTaskNode() : mpJob(NULL), mBand(0) {}
+
+		void Init(VDBandTaskJob *job, uint32 band) {
+			mpJob = job;
+			mBand = band;
+		}
+
+		bool Service() {
+			VDBandTaskJob& job = *mpJob;
+
+			// Adding several nodes may only wake one thread, since the wakeup
+			// signal doesn't count; pass the wakeup on to the next thread.
+			mpScheduler->Ping();
+
+			// Exceptions can't be allowed to leave here: the scheduler would
+			// repost the node without the band being counted as done.
+			try {
+				job.mpTask->RunBand(mBand, job.mBandCount);
+			} catch(MyError& e) {
+				job.SetError(e);
+			} catch(...) {
+				MyError e("An unexpected error occurred while processing a band on a worker thread.");
+
+				job.SetError(e);
+			}
+
+			if (!--job.mPending)
+				job.mDoneSignal.signal();
+
+			return false;
+		}
+
+	protected:
+		VDBandTaskJob *mpJob;
+		uint32 mBand;
+	};
+
+	class VDBandTaskPool {
+	public:
+		VDBandTaskPool();
+		~VDBandTaskPool();
+
+		void Start(uint32 threadCount);
+		void Run(VDBandTask& task, uint32 bandCount);
+
+	protected:
+		void Wait(VDBandTaskJob& job, VDBandTaskNode *nodes, uint32 nodeCount);
+
+		VDScheduler mScheduler;
+		VDSignal mWakeSignal;
+		VDSchedulerThreadPool mThreadPool;
+	};
+
+	VDBandTaskPool::VDBandTaskPool() {
+		mScheduler.setSignal(&mWakeSignal);
+	}
+
+	VDBandTaskPool::~VDBandTaskPool() {
+		mScheduler.BeginShutdown();
+	}
+
+	void VDBandTaskPool::Start(uint32 threadCount) {
+		mThreadPool.Start(&mScheduler, threadCount);
+	}
+
+	void VDBandTaskPool::Run(VDBandTask& task, uint32 bandCount) {
+		VDBandTaskJob job;
+		job.mpTask = &task;
+		job.mBandCount = bandCount;
+		job.mPending = bandCount - 1;
+
+		vdautoarrayptr<VDBandTaskNode> nodes(new VDBandTaskNode[bandCount - 1]);
+
+		for(uint32 i=1; i<bandCount; ++i) {
+			VDBandTaskNode& node = nodes[i - 1];
+
+			node.Init(&job, i);
+			mScheduler.Add(&node);
+		}
+
+		// The nodes refer to the job on this stack frame, so the other bands
+		// must finish even if the first band throws.
+		try {
+			task.RunBand(0, bandCount);
+		} catch(...) {
+			Wait(job, nodes.get(), bandCount - 1);
+			throw;
+		}
+
+		Wait(job, nodes.get(), bandCount - 1);
+
+		job.ThrowError();
+	}
+
+	void VDBandTaskPool::Wait(VDBandTaskJob& job, VDBandTaskNode *nodes, uint32 nodeCount) {
+		// Help with queued bands instead of blocking while there are any. This
+		// also keeps nested band tasks from deadlocking on a busy pool.
+		while(job.mPending != 0) {
+			if (!mScheduler.Run())
+				job.mDoneSignal.wait();
+		}
+
+		for(uint32 i=0; i<nodeCount; ++i)
+			mScheduler.Remove(&nodes[i]);
+	}
+
+	VDAtomicPtr<VDBandTaskPool> g_pVDBandTaskPool;
+
+	struct VDBandTaskPoolShutdown {
+		~VDBandTaskPoolShutdown() {
+			delete g_pVDBandTaskPool.xchg(NULL);
+		}
+	} g_VDBandTaskPoolShutdown;
+
+	VDBandTaskPool *VDGetBandTaskPool() {
+		VDBandTaskPool *pool = g_pVDBandTaskPool;
+
+		if (!pool) {
+			pool = new VDBandTaskPool;
+
+			VDBandTaskPool *prevPool = g_pVDBandTaskPool.compareExchange(pool, NULL);
+			if (prevPool) {
+				delete pool;
+				pool = prevPool;
+			} else {
+				// The calling thread always runs a band itself.
+				pool->Start(VDGetLogicalProcessorCount() - 1);
+			}
+		}
+
+		return pool;
+	}
+}
+
+uint32 VDGetBandCount(uint64 work, uint64 minWorkPerBand, uint32 maxBands, uint32 units) {
+	if (work < 2*minWorkPerBand)
+		return 1;
+
+	uint32 bandCount = (uint32)std::min<uint64>(work / minWorkPerBand, maxBands);
+	bandCount = std::min<uint32>(bandCount, VDGetLogicalProcessorCount());
+	bandCount = std::min<uint32>(bandCount, units);
+
+	return bandCount ? bandCount : 1;
+}
+
+void VDRunBandTask(VDBandTask& task, uint32 bandCount) {
+	if (bandCount <= 1) {
+		task.RunBand(0, 1);
+		return;
+	}
+
+	VDGetBandTaskPool()->Run(task, bandCount);
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	class VDRowBandTask : public VDBandTask {
+	public:
+		VDRowBandTask(VDRowTask& task, uint32 rows) : mTask(task), mRows(rows) {}
+
+		void RunBand(uint32 band, uint32 bandCount) {
+			const uint32 y1 = (uint32)(((uint64)mRows * band) / bandCount);
+			const uint32 y2 = (uint32)(((uint64)mRows * (band + 1)) / bandCount);
+
+			if (y1 < y2)
+				mTask.RunRows(y1, y2);
+		}
+
+	protected:
+		VDRowTask& mTask;
+		const uint32 mRows;
+	};
+}
+
+void VDRunRowTask(VDRowTask& task, uint32 rows, uint32 rowBytes) {
+	enum {
+		kMaxBands = 8,
+		kMinBytesPerBand = 131072
+	};
+
+	if (!rows)
+		return;
+
+	VDRowBandTask rowTask(task, rows);
+
+	VDRunBandTask(rowTask, VDGetBandCount((uint64)rows * rowBytes, kMinBytesPerBand, kMaxBands, rows));
+}
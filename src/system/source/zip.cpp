@@ -24,10 +24,27 @@
 //		distribution.
 
 #include "stdafx.h"
+#include <algorithm>
+#include <numeric>
 #include <vd2/system/zip.h>
+#include <vd2/system/cpuaccel.h>
 #include <vd2/system/error.h>
 #include <vd2/system/binary.h>
 
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+	#include <emmintrin.h>
+#endif
+
+namespace {
+	// Flags for the literal/length decoding table. An entry either holds a
+	// single symbol, or two literals whose codes fit in the 15 bits looked up
+	// together, along with their combined length.
+	enum {
+		kInflatePairedLiterals		= 0x00020000,
+		kInflatePairedLengthShift	= 18
+	};
+}
+
 bool VDDeflateBitReader::refill() {
 	sint32 tc = mBytesLeft>kBufferSize?kBufferSize:(sint32)mBytesLeft;
 
@@ -45,10 +62,38 @@ bool VDDeflateBitReader::refill() {
 }
 
 void VDDeflateBitReader::readbytes(void *dst, unsigned len) {
-	// LAME: OPTIMIZE LATER
 	uint8 *dst2 = (uint8 *)dst;
-	while(len-->0)
-		*dst2++ = getbits(8);
+
+	if (bits & 7) {
+		while(len-->0)
+			*dst2++ = getbits(8);
+
+		return;
+	}
+
+	// Byte aligned, which is always the case for stored blocks. Drain the
+	// accumulator, then copy straight out of the buffer.
+	while(len) {
+		if (bits) {
+			*dst2++ = (uint8)accum;
+			accum >>= 8;
+			bits -= 8;
+			--len;
+			continue;
+		}
+
+		if (!mBufferPt && !refill())
+			break;
+
+		unsigned tc = std::min<unsigned>(len, (unsigned)-mBufferPt);
+
+		memcpy(dst2, mBuffer + kBufferSize + mBufferPt, tc);
+		mBufferPt += tc;
+		dst2 += tc;
+		len -= tc;
+	}
+
+	consume(0);
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -56,12 +101,27 @@ void VDDeflateBitReader::readbytes(void *dst, unsigned len) {
 void VDCRCChecker::Init(uint32 crc) {
 	mValue = 0xFFFFFFFF;
 
+	if (mPoly == crc)
+		return;
+
+	mPoly = crc;
+
 	for(int i=0; i<256; ++i) {
 		unsigned v = i;
 		for(int j=0; j<8; ++j)
 			v = (v>>1) ^ (crc & -(sint32)(v&1));
 
-		mTable[i] = v;
+		mTable[0][i] = v;
+	}
+
+	// mTable[k][i] is the CRC of byte i followed by k zero bytes.
+	for(int i=0; i<256; ++i) {
+		uint32 v = mTable[0][i];
+
+		for(int k=1; k<8; ++k) {
+			v = mTable[0][(uint8)v] ^ (v >> 8);
+			mTable[k][i] = v;
+		}
 	}
 }
 
@@ -70,10 +130,29 @@ void VDCRCChecker::Process(const void *src0, sint32 count) {
 
 	uint32 v = mValue;
 
+	// Slicing-by-8: fold in eight bytes per step with one lookup per byte
+	// from a separate table, instead of a chain of eight dependent lookups.
+	while(count >= 8) {
+		const uint32 a = v ^ VDReadUnalignedLEU32(src);
+		const uint32 b = VDReadUnalignedLEU32(src + 4);
+
+		v	= mTable[7][(uint8)a]
+			^ mTable[6][(uint8)(a >> 8)]
+			^ mTable[5][(uint8)(a >> 16)]
+			^ mTable[4][a >> 24]
+			^ mTable[3][(uint8)b]
+			^ mTable[2][(uint8)(b >> 8)]
+			^ mTable[1][(uint8)(b >> 16)]
+			^ mTable[0][b >> 24];
+
+		src += 8;
+		count -= 8;
+	}
+
 	// This code is from the PNG spec.
 	if (count > 0)
 		do {
-			v = mTable[(uint8)v ^ *src++] ^ (v >> 8);
+			v = mTable[0][(uint8)v ^ *src++] ^ (v >> 8);
 		} while(--count);
 
 	mValue = v;
@@ -87,6 +166,108 @@ uint32 VDCRCChecker::CRC(uint32 crc, const void *src, sint32 len) {
 
 ///////////////////////////////////////////////////////////////////////////
 
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+namespace {
+	uint32 VDAdler32HorizontalSum_SSE2(__m128i v) {
+		v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+		v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return (uint32)_mm_cvtsi128_si32(v);
+	}
+
+	// Processes 16-byte groups. Within a group, s2 picks up 16 times the
+	// incoming s1 plus each byte weighted by its distance from the end of
+	// the group, so the weighted sums are done with PMADDWD and the plain
+	// byte sums with PSADBW. Blocks are limited so that the 32-bit lanes
+	// can't overflow before the reduction.
+	const uint8 *VDAdler32Process_SSE2(const uint8 *s, uint32& s1, uint32& s2, uint32 groups) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i weightsLo = _mm_set_epi16(9, 10, 11, 12, 13, 14, 15, 16);
+		const __m128i weightsHi = _mm_set_epi16(1, 2, 3, 4, 5, 6, 7, 8);
+
+		while(groups) {
+			uint32 n = groups > 346 ? 346 : groups;
+			groups -= n;
+
+			__m128i vs1 = zero;
+			__m128i vs1prefix = zero;
+			__m128i vs2 = zero;
+
+			uint64 a2 = s2 + (uint64)s1 * 16 * n;
+
+			do {
+				const __m128i v = _mm_loadu_si128((const __m128i *)s);
+				s += 16;
+
+				vs1prefix = _mm_add_epi32(vs1prefix, vs1);
+				vs1 = _mm_add_epi32(vs1, _mm_sad_epu8(v, zero));
+				vs2 = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_unpacklo_epi8(v, zero), weightsLo));
+				vs2 = _mm_add_epi32(vs2, _mm_madd_epi16(_mm_unpackhi_epi8(v, zero), weightsHi));
+			} while(--n);
+
+			a2 += (uint64)VDAdler32HorizontalSum_SSE2(vs1prefix) * 16 + VDAdler32HorizontalSum_SSE2(vs2);
+
+			s1 = (s1 + VDAdler32HorizontalSum_SSE2(vs1)) % 65521;
+			s2 = (uint32)(a2 % 65521);
+		}
+
+		return s;
+	}
+}
+#endif
+
+void VDAdler32Checker::Process(const void *src, sint32 len) {
+	const uint8 *s = (const uint8 *)src;
+
+#if defined(VD_COMPILER_MSVC) && (defined(VD_CPU_X86) || defined(VD_CPU_AMD64))
+	if (SSE2_enabled && len >= 16) {
+		s = VDAdler32Process_SSE2(s, mS1, mS2, (uint32)len >> 4);
+		len &= 15;
+	}
+#endif
+
+	while(len > 0) {
+		uint32 tc = len;
+		if (tc > 0x1000)
+			tc = 0x1000;
+
+		len -= tc;
+		do {
+			mS1 += *s++;
+			mS2 += mS1;
+		} while(--tc);
+
+		mS1 %= 65521;
+		mS2 %= 65521;
+	}
+}
+
+uint32 VDAdler32Checker::Combine(uint32 adler1, uint32 adler2, uint64 len2) {
+	// From zlib's adler32_combine(): the second run's s1 picks up the
+	// first's s1, and its s2 picks up the first's s2 plus len2 times the
+	// first's s1, all mod 65521.
+	const uint32 kBase = 65521;
+	const uint32 rem = (uint32)(len2 % kBase);
+
+	uint32 sum1 = adler1 & 0xffff;
+	uint32 sum2 = (uint32)(((uint64)rem * sum1) % kBase);
+
+	sum1 += (adler2 & 0xffff) + kBase - 1;
+	sum2 += (adler1 >> 16) + (adler2 >> 16) + kBase - rem;
+
+	if (sum1 >= kBase)
+		sum1 -= kBase;
+	if (sum1 >= kBase)
+		sum1 -= kBase;
+	if (sum2 >= kBase * 2)
+		sum2 -= kBase * 2;
+	if (sum2 >= kBase)
+		sum2 -= kBase;
+
+	return sum1 | (sum2 << 16);
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 VDZipStream::VDZipStream()
 	: mPos(0)
 	, mbCRCEnabled(false)
@@ -217,7 +398,20 @@ bool VDZipStream::Inflate() {
 		while(mBufferLevel < 65024) {
 			unsigned code, bits;
 
-			code	= mCodeDecode[mBits.peek() & 0x7fff];
+			const uint32 entry = mCodeDecode[mBits.peek() & 0x7fff];
+
+			if (entry & kInflatePairedLiterals) {
+				if (!mBits.consume(entry >> kInflatePairedLengthShift))
+					return false;
+
+				mBuffer[mWritePt] = (uint8)entry;
+				mBuffer[(mWritePt + 1) & 65535] = (uint8)(entry >> 9);
+				mWritePt = (mWritePt + 2) & 65535;
+				mBufferLevel += 2;
+				continue;
+			}
+
+			code	= entry;
 			bits	= mCodeLengths[code];
 
 			if (!mBits.consume(bits))
@@ -251,11 +445,26 @@ bool VDZipStream::Inflate() {
 				// NOTE: This can be a self-replicating copy.  It must be ascending and it must
 				//		 be by bytes.
 //				printf("%08lx: distance %04x count %d\n", mWritePt, dist, len);
-				do {
-					mBuffer[mWritePt++] = mBuffer[copysrc++];
-					mWritePt &= 65535;
-					copysrc &= 65535;
-				} while(--len);
+				if (copysrc + len <= 65536 && mWritePt + len <= 65536) {
+					uint8 *dst = mBuffer + mWritePt;
+					const uint8 *src = mBuffer + copysrc;
+
+					mWritePt = (mWritePt + len) & 65535;
+
+					if (dist >= len)
+						memcpy(dst, src, len);
+					else {
+						do {
+							*dst++ = *src++;
+						} while(--len);
+					}
+				} else {
+					do {
+						mBuffer[mWritePt++] = mBuffer[copysrc++];
+						mWritePt &= 65535;
+						copysrc &= 65535;
+					} while(--len);
+				}
 			} else {
 //				printf("%08lx: literal %02x\n", mWritePt, code);
 				mBuffer[mWritePt++] = code;
@@ -303,7 +512,8 @@ namespace {
 		return !base;
 	}
 
-	static bool InflateExpandTable32K(unsigned short *dst, unsigned char *lens, unsigned codes) {
+	template<class T>
+	static bool InflateExpandTable32K(T *dst, unsigned char *lens, unsigned codes) {
 		unsigned	k;
 		unsigned	ki;
 		unsigned	base=0;
@@ -325,6 +535,28 @@ namespace {
 	}
 }
 
+// Pairs up literals whose codes fit together in the 15-bit lookup, so that
+// runs of literals decode two at a time. This relies on the table holding
+// the same entry for every index that shares a code's bits: the entry at
+// index >> bits then holds the following code, as long as that code fits in
+// the bits that remain.
+void VDZipStream::PairLiteralCodes() {
+	for(unsigned i=0; i<32768; ++i) {
+		const unsigned code = mCodeDecode[i] & 0x1ff;
+		if (code >= 256)
+			continue;
+
+		const unsigned bits = mCodeLengths[code];
+		const unsigned code2 = mCodeDecode[i >> bits] & 0x1ff;
+		if (code2 >= 256)
+			continue;
+
+		const unsigned totalBits = bits + mCodeLengths[code2];
+		if (totalBits <= 15)
+			mCodeDecode[i] = code + (code2 << 9) + kInflatePairedLiterals + (totalBits << kInflatePairedLengthShift);
+	}
+}
+
 bool VDZipStream::ParseBlockHeader() {
 	unsigned char ltbl_lengths[20];
 	unsigned char ltbl_decode[256];
@@ -373,6 +605,7 @@ bool VDZipStream::ParseBlockHeader() {
 				return false;
 			}
 
+			PairLiteralCodes();
 			mBlockType = kDeflatedBlock;
 		}
 		break;
@@ -459,6 +692,8 @@ bool VDZipStream::ParseBlockHeader() {
 				VDASSERT(false);	// data table bad
 				return false;
 			}
+
+			PairLiteralCodes();
 			mBlockType = kDeflatedBlock;
 		}
 		break;
@@ -469,6 +704,936 @@ bool VDZipStream::ParseBlockHeader() {
 	return true;
 }
 
+///////////////////////////////////////////////////////////////////////////
+//
+//	Deflate compressor
+//
+///////////////////////////////////////////////////////////////////////////
+
+namespace {
+	const unsigned len_tbl[32]={
+		3,4,5,6,7,8,9,10,
+		11,13,15,17,19,23,27,31,
+		35,43,51,59,67,83,99,115,
+		131,163,195,227,258,259
+	};
+
+	const unsigned char len_bits_tbl[32]={
+		0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0
+	};
+
+	const unsigned char dist_bits_tbl[]={
+		0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13
+	};
+
+	const unsigned dist_tbl[]={
+		1,2,3,4,5,7,9,13,
+		17,25,33,49,65,97,129,193,
+		257,385,513,769,1025,1537,2049,3073,
+		4097,6145,8193,12289,16385,24577,
+		32769
+	};
+
+	const unsigned char hclen_tbl[]={
+		16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15
+	};
+}
+
+struct VDHuffmanHistoSorterData {
+	VDHuffmanHistoSorterData(const int pHisto[288]) {
+		for(int i=0; i<288; ++i) {
+			mHisto[i] = (pHisto[i] << 9) + 287 - i;
+		}
+	}
+
+	int mHisto[288];
+};
+
+struct VDHuffmanHistoSorter {
+	VDHuffmanHistoSorter(const VDHuffmanHistoSorterData& data) : mpHisto(data.mHisto) {}
+
+	// We want to sort by descending probability first, then by ascending code point.
+	bool operator()(int f1, int f2) const {
+		return mpHisto[f1] > mpHisto[f2];
+	}
+
+	const int *mpHisto;
+};
+
+class VDDeflateHuffmanTable {
+public:
+	VDDeflateHuffmanTable();
+
+	void Init();
+
+	inline void Tally(int c) {
+		++mHistogram[c];
+	}
+
+	inline void Tally(int c, int count) {
+		mHistogram[c] += count;
+	}
+
+	void BuildCode(int depth_limit = 15);
+	void BuildEncodingTable(uint16 *p, int *l, int limit);
+	void BuildStaticLengthEncodingTable(uint16 *p, int *l);
+	void BuildStaticDistanceEncodingTable(uint16 *p, int *l);
+
+	uint32 GetCodeCount(int limit) const;
+	uint32 GetOutputSize() const;
+	uint32 GetStaticOutputSize() const;
+
+	const uint16 *GetDHTSegment() { return mDHT; }
+	int GetDHTSegmentLen() const { return mDHTLength; }
+
+private:
+	int mHistogram[288];
+	int mHistogram2[288];
+	uint16 mDHT[288+16];
+	int mDHTLength;
+};
+
+VDDeflateHuffmanTable::VDDeflateHuffmanTable() {
+	Init();
+}
+
+void VDDeflateHuffmanTable::Init() {
+	std::fill(mHistogram, mHistogram+288, 0);
+}
+
+void VDDeflateHuffmanTable::BuildCode(int depth_limit) {
+	int i;
+	int nonzero_codes = 0;
+
+	for(i=0; i<288; ++i) {
+		mDHT[i+16] = i;
+		if (mHistogram[i])
+			++nonzero_codes;
+		mHistogram2[i] = mHistogram[i];
+	}
+
+	// Codes are stored in the second half of the DHT segment in decreasing
+	// order of frequency.
+
+	std::sort(&mDHT[16], &mDHT[16+288], VDHuffmanHistoSorter(VDHuffmanHistoSorterData(mHistogram)));
+	mDHTLength = 16 + nonzero_codes;
+
+	// Sort histogram in increasing order.
+
+	std::sort(mHistogram, mHistogram+288);
+
+	int *A = mHistogram+288 - nonzero_codes;
+
+	// Begin merging process (from "In-place calculation of minimum redundancy codes" by A. Moffat and J. Katajainen)
+	//
+	// There are three merging possibilities:
+	//
+	// 1) Leaf node with leaf node.
+	// 2) Leaf node with internal node.
+	// 3) Internal node with internal node.
+
+	int leaf = 2;					// Next, smallest unattached leaf node.
+	int internal = 0;				// Next, smallest unattached internal node.
+
+	// Merging always creates one internal node and eliminates one node from
+	// the total, so we will always be doing N-1 merges.
+
+	A[0] += A[1];		// First merge is always two leaf nodes.
+	for(int next=1; next<nonzero_codes-1; ++next) {		// 'next' is the value that receives the next unattached internal node.
+		int a, b;
+
+		// Pick first node.
+		if (leaf < nonzero_codes && A[leaf] <= A[internal]) {
+			A[next] = a=A[leaf++];			// begin new internal node with P of smallest leaf node
+		} else {
+			A[next] = a=A[internal];		// begin new internal node with P of smallest internal node
+			A[internal++] = next;					// hook smallest internal node as child of new node
+		}
+
+		// Pick second node.
+		if (internal >= next || (leaf < nonzero_codes && A[leaf] <= A[internal])) {
+			A[next] += b=A[leaf++];			// complete new internal node with P of smallest leaf node
+		} else {
+			A[next] += b=A[internal];		// complete new internal node with P of smallest internal node
+			A[internal++] = next;					// hook smallest internal node as child of new node
+		}
+	}
+
+	// At this point, we have a binary tree composed entirely of pointers to
+	// parents, partially sorted such that children are always before their
+	// parents in the array.  Traverse the array backwards, replacing each
+	// node with its depth in the tree.
+
+	A[nonzero_codes-2] = 0;		// root has height 0 (0 bits)
+	for(i = nonzero_codes-3; i>=0; --i)
+		A[i] = A[A[i]]+1;		// child height is 1+height(parent).
+
+	// Compute canonical tree bit depths for first part of DHT segment.
+	// For each internal node at depth N, add two counts at depth N+1
+	// and subtract one count at depth N.  Essentially, we are splitting
+	// as we go.  We traverse backwards to ensure that no counts will drop
+	// below zero at any time.
+
+	std::fill(mDHT, mDHT+16, 0);
+
+	int overallocation = 0;
+
+	mDHT[0] = 2;		// 2 codes at depth 1 (1 bit)
+	for(i = nonzero_codes-3; i>=0; --i) {
+		int depth = A[i];
+
+		// The optimal Huffman tree for N nodes can have a depth of N-1,
+		// but we have to constrain ourselves at depth 15.  We simply
+		// pile up counts at depth 15.  This causes us to overallocate the
+		// codespace, but we will compensate for that later.
+
+		if (depth >= depth_limit) {
+			++mDHT[depth_limit-1];
+		} else {
+			--mDHT[depth-1];
+			++mDHT[depth];
+			++mDHT[depth];
+		}
+	}
+
+	// Remove the extra code point.
+	for(i=15; i>=0; --i) {
+		if (mDHT[i])
+			overallocation += mDHT[i] * (0x8000 >> i);
+	}
+	overallocation -= 0x10000;
+
+	// We may have overallocated the codespace if we were forced to shorten
+	// some codewords.
+
+	if (overallocation > 0) {
+		// Codespace is overallocated.  Begin lengthening codes from bit depth
+		// 15 down until we are under the limit.
+
+		i = depth_limit-2;
+		while(overallocation > 0) {
+			if (mDHT[i]) {
+				--mDHT[i];
+				++mDHT[i+1];
+				overallocation -= 0x4000 >> i;
+				if (i < depth_limit-2)
+					++i;
+			} else
+				--i;
+		}
+
+		// We may be undercommitted at this point.  Raise codes from bit depth
+		// 1 up until we are at the desired limit.
+
+		int underallocation = -overallocation;
+
+		i = 1;
+		while(underallocation > 0) {
+			if (mDHT[i] && (0x8000>>i) <= underallocation) {
+				underallocation -= (0x8000>>i);
+				--mDHT[i];
+				--i;
+				++mDHT[i];
+			} else {
+				++i;
+			}
+		}
+	}
+}
+
+uint32 VDDeflateHuffmanTable::GetOutputSize() const {
+	const uint16 *pCodes = mDHT+16;
+
+	uint32 size = 0;
+
+	for(int len=0; len<16; ++len) {
+		int count = mDHT[len];
+
+		uint32 points = 0;
+		while(count--) {
+			int code = *pCodes++;
+
+			points += mHistogram2[code];
+		}
+
+		size += points * (len + 1);
+	}
+
+	return size;
+}
+
+uint32 VDDeflateHuffmanTable::GetCodeCount(int limit) const {
+	return std::accumulate(mHistogram2, mHistogram2+limit, 0);
+}
+
+uint32 VDDeflateHuffmanTable::GetStaticOutputSize() const {
+	uint32 sum7 = 0;
+	uint32 sum8 = 0;
+	uint32 sum9 = 0;
+	sum8 = std::accumulate(mHistogram2+  0, mHistogram2+144, sum8);
+	sum9 = std::accumulate(mHistogram2+144, mHistogram2+256, sum9);
+	sum7 = std::accumulate(mHistogram2+256, mHistogram2+280, sum7);
+	sum8 = std::accumulate(mHistogram2+280, mHistogram2+288, sum8);
+
+	return 7*sum7 + 8*sum8 + 9*sum9;
+}
+
+void VDDeflateHuffmanTable::BuildEncodingTable(uint16 *p, int *l, int limit) {
+	const uint16 *pCodes = mDHT+16;
+
+	uint16 total = 0;
+	uint16 inc = 0x4000;
+
+	for(int len=0; len<16; ++len) {
+		int count = mDHT[len];
+
+		while(count--) {
+			int code = *pCodes++;
+
+			l[code] = len+1;
+		}
+
+		for(int k=0; k<limit; ++k) {
+			if (l[k] == len+1) {
+				p[k] = revword15(total) << (16 - (len+1));
+				total += inc;
+			}
+		}
+		inc >>= 1;
+	}
+}
+
+void VDDeflateHuffmanTable::BuildStaticLengthEncodingTable(uint16 *p, int *l) {
+	memset(mDHT, 0, sizeof(mDHT[0])*16);
+	mDHT[6] = 24;
+	mDHT[7] = 152;
+	mDHT[8] = 112;
+
+	uint16 *dst = mDHT + 16;
+	for(int i=256; i<280; ++i)
+		*dst++ = i;
+	for(int i=0; i<144; ++i)
+		*dst++ = i;
+	for(int i=280; i<288; ++i)
+		*dst++ = i;
+	for(int i=144; i<256; ++i)
+		*dst++ = i;
+
+	BuildEncodingTable(p, l, 288);
+}
+
+void VDDeflateHuffmanTable::BuildStaticDistanceEncodingTable(uint16 *p, int *l) {
+	memset(mDHT, 0, sizeof(mDHT[0])*16);
+	mDHT[4] = 32;
+
+	for(int i=0; i<32; ++i)
+		mDHT[i+16] = i;
+
+	BuildEncodingTable(p, l, 32);
+}
+
+VDDeflateEncoder::VDDeflateEncoder()
+	: mbZlibWrapper(true)
+{
+}
+
+VDDeflateEncoder::VDDeflateEncoder(const VDDeflateEncoder& src) {
+	*this = src;
+}
+
+VDDeflateEncoder::~VDDeflateEncoder() {
+}
+
+VDDeflateEncoder& VDDeflateEncoder::operator=(const VDDeflateEncoder& src) {
+	if (this != &src) {
+		mAccum			= src.mAccum;
+		mAccBits		= src.mAccBits;
+		mHistoryPos		= src.mHistoryPos;
+		mHistoryTail	= src.mHistoryTail;
+		mHistoryBase	= src.mHistoryBase;
+		mHistoryBlockStart = src.mHistoryBlockStart;
+		mLenExtraBits = src.mLenExtraBits;
+		mPendingLen		= src.mPendingLen;
+		mpLen			= mLenBuf + (src.mpLen - src.mLenBuf);
+		mpCode			= mCodeBuf + (src.mpCode - src.mCodeBuf);
+		mpDist			= mDistBuf + (src.mpDist - src.mDistBuf);
+		mWindowLimit	= src.mWindowLimit;
+		mbZlibWrapper	= src.mbZlibWrapper;
+		mOutput			= src.mOutput;
+		mAdler32		= src.mAdler32;
+
+		memcpy(mHistoryBuffer, src.mHistoryBuffer, mHistoryTail);
+		memcpy(mHashNext, src.mHashNext, sizeof mHashNext);
+		memcpy(mHashTable, src.mHashTable, sizeof mHashTable);
+		memcpy(mLenBuf, src.mLenBuf, sizeof(mLenBuf[0]) * (src.mpLen - src.mLenBuf));
+		memcpy(mCodeBuf, src.mCodeBuf, sizeof(mCodeBuf[0]) * (src.mpCode - src.mCodeBuf));
+		memcpy(mDistBuf, src.mDistBuf, sizeof(mDistBuf[0]) * (src.mpDist - src.mDistBuf));
+	}
+	return *this;
+}
+
+void VDDeflateEncoder::Init(bool quick, bool zlibWrapper) {
+	std::fill(mHashNext, mHashNext+32768, -0x20000);
+	std::fill(mHashTable, mHashTable+65536, -0x20000);
+
+	mWindowLimit = quick ? 1024 : 32768;
+
+	mpLen = mLenBuf;
+	mpCode = mCodeBuf;
+	mpDist = mDistBuf;
+	mHistoryPos = 0;
+	mHistoryTail = 0;
+	mHistoryBase = 0;
+	mHistoryBlockStart = 0;
+	mLenExtraBits = 0;
+	mPendingLen = 0;
+	mAccum = 0;
+	mAccBits = 0;
+	mbZlibWrapper = zlibWrapper;
+	mAdler32 = VDAdler32Checker();
+
+	if (zlibWrapper) {
+		mOutput.push_back(0x78);	// 32K window, Deflate
+		mOutput.push_back(0xDA);	// maximum compression, no dictionary, check offset = 0x1A
+	}
+}
+
+void VDDeflateEncoder::Write(const void *src, size_t len) {
+	while(len > 0) {
+		uint32 tc = sizeof mHistoryBuffer - mHistoryTail;
+
+		if (!tc) {
+			Compress(false);
+			continue;
+		}
+
+		if ((size_t)tc > len)
+			tc = (uint32)len;
+
+		if (mbZlibWrapper)
+			mAdler32.Process(src, tc);
+		memcpy(mHistoryBuffer + mHistoryTail, src, tc);
+
+		mHistoryTail += tc;
+		src = (const char *)src + tc;
+		len -= tc;
+	}
+}
+
+void VDDeflateEncoder::ForceNewBlock() {
+	Compress(false);
+	EndBlock(false);
+}
+
+#define HASH(pos) (((uint32)hist[(pos)] ^ ((uint32)hist[(pos)+1] << 2) ^ ((uint32)hist[(pos)+2] << 4) ^ ((uint32)hist[(pos)+3] << 6) ^ ((uint32)hist[(pos)+4] << 7) ^ ((uint32)hist[(pos)+5] << 8)) & 0xffff)
+
+void VDDeflateEncoder::EndBlock(bool term) {
+	if (mpCode > mCodeBuf) {
+		if (mPendingLen) {
+			const uint8 *hist = mHistoryBuffer - mHistoryBase;
+			int bestlen = mPendingLen - 1;
+			mPendingLen = 0;
+
+			while(bestlen-- > 0) {
+				int hval = HASH(mHistoryPos);
+				mHashNext[mHistoryPos & 0x7fff] = mHashTable[hval];
+				mHashTable[hval] = mHistoryPos;
+				++mHistoryPos;
+			}
+		}
+
+		*mpCode++ = 256;
+		Flush(mpCode - mCodeBuf, mpDist - mDistBuf, term, false);
+		mpCode = mCodeBuf;
+		mpDist = mDistBuf;
+		mpLen = mLenBuf;
+		mHistoryBlockStart = mHistoryPos;
+		mLenExtraBits = 0;
+	}
+}
+
+void VDDeflateEncoder::Compress(bool flush) {
+	uint8	*lenptr = mpLen;
+	uint16	*codeptr = mpCode;
+	uint16	*distptr = mpDist;
+
+	const uint8 *hist = mHistoryBuffer - mHistoryBase;
+
+	uint32 pos = mHistoryPos;
+	uint32 len = mHistoryBase + mHistoryTail;
+	uint32 maxpos = flush ? len : len > 258+6 ? len - (258+6) : 0;		// +6 is for the 6-byte hash.
+	while(pos < maxpos) {
+		if (codeptr >= mCodeBuf + 32768) {
+			mpCode = codeptr;
+			mpDist = distptr;
+			mpLen = lenptr;
+			mHistoryPos = pos;
+			EndBlock(false);
+			pos = mHistoryPos;
+			codeptr = mpCode;
+			distptr = mpDist;
+			lenptr = mpLen;
+
+			// Note that it's possible for the EndBlock() to have flushed out a pending
+			// run and pushed us all the way to maxpos.
+			VDASSERT(pos <= mHistoryBase + mHistoryTail);
+			continue;
+		}
+
+		uint8 c = hist[pos];
+		uint32 hcode = HASH(pos);
+
+		sint32 hpos = mHashTable[hcode];
+		uint32 limit = 258;
+		if (limit > len-pos)
+			limit = len-pos;
+
+		sint32 hlimit = pos - mWindowLimit;		// note that our initial hash table values are low enough to avoid colliding with this.
+		if (hlimit < 0)
+			hlimit = 0;
+
+		uint32 bestlen = 5;
+		uint32 bestoffset = 0;
+
+		if (hpos >= hlimit && limit >= 6) {
+			sint32 hstart = hpos;
+			const unsigned char *s2 = hist + pos;
+			uint32 matchWord1 = *(const uint32 *)s2;
+			uint16 matchWord2 = *(const uint16 *)(s2 + 4);
+			do {
+				const unsigned char *s1 = hist + hpos - bestlen + 5;
+				uint32 mlen = 0;
+
+				if (s1[bestlen] == s2[bestlen] && *(const uint32 *)s1 == matchWord1 && *(const uint16 *)(s1 + 4) == matchWord2) {
+					mlen = 6;
+					while(mlen < limit && s1[mlen] == s2[mlen])
+						++mlen;
+
+					if (mlen > bestlen) {
+						bestoffset = pos - hpos + bestlen - 5;
+						// hop hash chains!
+						hpos += mlen - bestlen;
+						if (hpos == pos)
+							hpos = hstart;
+						else
+							hpos = mHashNext[(hpos + mlen - bestlen) & 0x7fff];
+						hlimit += (mlen - bestlen);
+
+						bestlen = mlen;
+						continue;
+					}
+				}
+
+				hpos = mHashNext[hpos & 0x7fff];
+			} while(hpos >= hlimit);
+		}
+
+		// Normally, we'd accept any match of longer 3 or greater. However, the savings for this aren't
+		// enough to match the decrease in the effectiveness of the Huffman encoding, so it's usually
+		// better to keep only longer matches. We follow the lead of zlib's Z_FILTERED and only accept
+		// matches of length 6 or longer. It turns out that we can greatly speed up compression when
+		// this is the case since we can use a longer hash -- the PNG filtering often means a very
+		// skewed distribution which hinders the effectiveness of a 3-byte hash.
+		if (bestlen >= 6) {
+			// check for an illegal match
+			VDASSERT((uint32)(bestoffset-1) < 32768U);
+			VDASSERT(bestlen < 259);
+			VDASSERT(!memcmp(hist+pos, hist+pos-bestoffset, bestlen));
+			VDASSERT(pos >= bestoffset);
+			VDASSERT(pos+bestlen <= len);
+			VDASSERT(pos-bestoffset >= mHistoryBase);
+
+			unsigned lcode = 0;
+			while(bestlen >= len_tbl[lcode+1])
+				++lcode;
+			*codeptr++ = lcode + 257;
+			*distptr++ = bestoffset;
+			*lenptr++ = bestlen - 3;
+			mLenExtraBits += len_bits_tbl[lcode];
+		} else {
+			*codeptr++ = c;
+			bestlen = 1;
+		}
+
+		// Lazy matching.
+		//
+		//	prev	current		compare		action
+		//	======================================
+		//	lit		lit						append
+		//	lit		match					stash
+		//	match	lit						retire
+		//	match	match		shorter		retire
+		//	match	match		longer		obsolete
+		VDASSERT(pos+bestlen <= mHistoryBase + mHistoryTail);
+
+		if (!mPendingLen) {
+			if (bestlen > 1) {
+				mPendingLen = bestlen;
+				bestlen = 1;
+			}
+		} else {
+			if (bestlen > mPendingLen) {
+				codeptr[-2] = hist[pos - 1];
+				distptr[-2] = distptr[-1];
+				--distptr;
+				lenptr[-2] = lenptr[-1];
+				--lenptr;
+				mPendingLen = bestlen;
+				bestlen = 1;
+			} else {
+				--codeptr;
+				if (bestlen > 1) {
+					--distptr;
+					--lenptr;
+				}
+
+				bestlen = mPendingLen - 1;
+				mPendingLen = 0;
+			}
+		}
+
+		VDASSERT(pos+bestlen <= mHistoryBase + mHistoryTail);
+
+		if (bestlen > 0) {
+			mHashNext[pos & 0x7fff] = mHashTable[hcode];
+			mHashTable[hcode] = pos;
+			++pos;
+
+			while(--bestlen) {
+				uint32 hcode = HASH(pos);
+				mHashNext[pos & 0x7fff] = mHashTable[hcode];
+				mHashTable[hcode] = pos;
+				++pos;
+			}
+		}
+	}
+
+	// shift down by 32K
+	if (pos - mHistoryBase >= 49152) {
+		uint32 delta = (pos - 32768) - mHistoryBase;
+		memmove(mHistoryBuffer, mHistoryBuffer + delta, mHistoryTail - delta);
+		mHistoryBase += delta;
+		mHistoryTail -= delta;
+	}
+
+	mHistoryPos = pos;
+	mpLen = lenptr;
+	mpCode = codeptr;
+	mpDist = distptr;
+}
+
+void VDDeflateEncoder::Finish() {
+	while(mHistoryPos != mHistoryBase + mHistoryTail)
+		Compress(true);
+
+	VDASSERT(mpCode != mCodeBuf);
+	EndBlock(true);
+
+	FlushBits();
+
+	if (mbZlibWrapper) {
+		// write Adler32 checksum
+		uint8 crc[4];
+		VDWriteUnalignedBEU32(crc, mAdler32.Adler32());
+
+		mOutput.insert(mOutput.end(), crc, crc+4);
+	}
+}
+
+void VDDeflateEncoder::SyncFlush() {
+	while(mHistoryPos != mHistoryBase + mHistoryTail)
+		Compress(true);
+
+	EndBlock(false);
+
+	// empty non-final stored block, which also aligns to a byte boundary
+	uint32 alignBits = -(mAccBits+3) & 7;
+
+	PutBits(0, 3);
+	PutBits(0, alignBits);
+	PutBits(0, 16);
+	PutBits(0xffff0000, 16);
+	FlushBits();
+}
+
+uint32 VDDeflateEncoder::EstimateOutputSize() {
+	Compress(false);
+
+	return mOutput.size() * 8 + mAccBits + Flush(mpCode - mCodeBuf, mpDist - mDistBuf, false, true);
+}
+
+VDFORCEINLINE void VDDeflateEncoder::PutBits(uint32 encoding, int enclen) {
+	mAccum >>= enclen;
+	mAccum += encoding;
+	mAccBits += enclen;
+
+	if (mAccBits >= 16) {
+		mAccBits -= 16;
+//		uint8 c[2] = { mAccum >> (16-mAccBits), mAccum >> (24-mAccBits) };
+
+//		mOutput.insert(mOutput.end(), c, c+2);
+		mOutput.push_back(mAccum >> (16-mAccBits));
+		mOutput.push_back(mAccum >> (24-mAccBits));
+	}		
+}
+
+void VDDeflateEncoder::FlushBits() {
+	while(mAccBits > 0) {
+		mOutput.push_back(0xff & (mAccum >> (32-mAccBits)));
+		mAccBits -= 8;
+	}
+}
+
+uint32 VDDeflateEncoder::Flush(int n, int ndists, bool term, bool test) {
+	const uint16 *codes = mCodeBuf;
+	const uint8 *lens = mLenBuf;
+	const uint16 *dists = mDistBuf;
+
+	VDDeflateHuffmanTable htcodes, htdists, htlens;
+	int i;
+
+	memset(mCodeLen, 0, sizeof mCodeLen);
+	memset(mDistLen, 0, sizeof mDistLen);
+
+	for(i=0; i<n; ++i)
+		htcodes.Tally(codes[i]);
+
+	htcodes.BuildCode(15);
+
+	for(i=0; i<ndists; ++i) {
+		int c=0;
+		while(dists[i] >= dist_tbl[c+1])
+			++c;
+
+		htdists.Tally(c);
+	}
+
+	htdists.BuildCode(15);
+
+	int totalcodes = 286;
+	int totaldists = 30;
+	int totallens = totalcodes + totaldists;
+
+	htcodes.BuildEncodingTable(mCodeEnc, mCodeLen, 288);
+	htdists.BuildEncodingTable(mDistEnc, mDistLen, 32);
+
+	// RLE the length table
+	uint8 lenbuf[286+30+1];
+	uint8 *lendst = lenbuf;
+	uint8 rlebuf[286+30+1];
+	uint8 *rledst = rlebuf;
+
+	for(i=0; i<totalcodes; ++i)
+		*lendst++ = mCodeLen[i];
+
+	for(i=0; i<totaldists; ++i)
+		*lendst++ = mDistLen[i];
+
+	*lendst = 255;		// avoid match
+
+	int last = -1;
+	uint32 treeExtraBits = 0;
+	i=0;
+	while(i<totallens) {
+		if (!lenbuf[i] && !lenbuf[i+1] && !lenbuf[i+2]) {
+			int j;
+			for(j=3; j<138 && !lenbuf[i+j]; ++j)
+				;
+			if (j < 11) {
+				*rledst++ = 17;
+				*rledst++ = j-3;
+				treeExtraBits += 3;
+			} else {
+				*rledst++ = 18;
+				*rledst++ = j-11;
+				treeExtraBits += 7;
+			}
+			htlens.Tally(rledst[-2]);
+			i += j;
+			last = 0;
+		} else if (lenbuf[i] == last && lenbuf[i+1] == last && lenbuf[i+2] == last) {
+			int j;
+			for(j=3; j<6 && lenbuf[i+j] == last; ++j)
+				;
+			*rledst++ = 16;
+			htlens.Tally(16);
+			*rledst++ = j-3;
+			treeExtraBits += 2;
+			i += j;
+		} else {
+			htlens.Tally(*rledst++ = lenbuf[i++]);
+			last = lenbuf[i-1];
+		}
+	}
+
+	htlens.BuildCode(7);
+
+	// compute bits for dynamic encoding
+	uint32 blockSize = mHistoryPos - mHistoryBlockStart;
+	uint32 alignBits = -(mAccBits+3) & 7;
+	uint32 dynamicBlockBits = htcodes.GetOutputSize() + htdists.GetOutputSize() + mLenExtraBits + htlens.GetOutputSize() + 14 + 19*3 + treeExtraBits;
+	uint32 staticBlockBits = htcodes.GetStaticOutputSize() + htdists.GetCodeCount(32)*5 + mLenExtraBits;
+	uint32 storeBlockBits = blockSize*8 + 32 + alignBits;
+
+	if (storeBlockBits < dynamicBlockBits && storeBlockBits < staticBlockBits) {
+		if (test)
+			return storeBlockBits;
+
+		PutBits((term ? 0x20000000 : 0) + (0 << 30), 3);
+
+		// align to byte boundary
+		PutBits(0, alignBits);
+
+		// write block size
+		PutBits((blockSize << 16) & 0xffff0000, 16);
+		PutBits((~blockSize << 16) & 0xffff0000, 16);
+
+		// write the block.
+		FlushBits();
+
+		const uint8 *base = &mHistoryBuffer[mHistoryBlockStart - mHistoryBase];
+		mOutput.insert(mOutput.end(), base, base+blockSize);
+	} else {
+		if (dynamicBlockBits < staticBlockBits) {
+			if (test)
+				return dynamicBlockBits;
+
+			PutBits((term ? 0x20000000 : 0) + (2 << 30), 3);
+
+			PutBits((totalcodes - 257) << 27, 5);	// code count - 257
+			PutBits((totaldists - 1) << 27, 5);	// dist count - 1
+			PutBits(0xf0000000, 4);	// ltbl count - 4
+
+			uint16 hlenc[19];
+			int hllen[19]={0};
+			htlens.BuildEncodingTable(hlenc, hllen, 19);
+
+			for(i=0; i<19; ++i) {
+				int k = hclen_tbl[i];
+
+				PutBits(hllen[k] << 29, 3);
+			}
+
+			uint8 *rlesrc = rlebuf;
+			while(rlesrc < rledst) {
+				uint8 c = *rlesrc++;
+				PutBits((uint32)hlenc[c] << 16, hllen[c]);
+
+				if (c == 16)
+					PutBits((uint32)*rlesrc++ << 30, 2);
+				else if (c == 17)
+					PutBits((uint32)*rlesrc++ << 29, 3);
+				else if (c == 18)
+					PutBits((uint32)*rlesrc++ << 25, 7);
+			}
+		} else {
+			if (test)
+				return staticBlockBits;
+
+			PutBits((term ? 0x20000000 : 0) + (1 << 30), 3);
+
+			memset(mCodeLen, 0, sizeof(mCodeLen));
+			memset(mDistLen, 0, sizeof(mDistLen));
+			htcodes.BuildStaticLengthEncodingTable(mCodeEnc, mCodeLen);
+			htdists.BuildStaticDistanceEncodingTable(mDistEnc, mDistLen);
+		}
+
+		for(i=0; i<n; ++i) {
+			unsigned code = *codes++;
+			unsigned clen = mCodeLen[code];
+
+			PutBits((uint32)mCodeEnc[code] << 16, clen);
+
+			if (code >= 257) {
+				unsigned extralenbits = len_bits_tbl[code-257];
+				unsigned len = *lens++ + 3;
+
+				VDASSERT(len >= len_tbl[code-257]);
+				VDASSERT(len < len_tbl[code-256]);
+
+				if (extralenbits)
+					PutBits((len - len_tbl[code-257]) << (32 - extralenbits), extralenbits);
+
+				unsigned dist = *dists++;
+				int dcode=0;
+				while(dist >= dist_tbl[dcode+1])
+					++dcode;
+
+				PutBits((uint32)mDistEnc[dcode] << 16, mDistLen[dcode]);
+
+				unsigned extradistbits = dist_bits_tbl[dcode];
+
+				if (extradistbits)
+					PutBits((dist - dist_tbl[dcode]) << (32 - extradistbits), extradistbits);
+			}
+		}
+	}
+
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
+VDDeflateStream::VDDeflateStream(IVDStream *pDst, bool quick)
+	: mpDst(pDst)
+	, mPos(0)
+	, mbCRCEnabled(false)
+	, mbFinished(false)
+{
+	mEncoder.Init(quick, false);
+}
+
+VDDeflateStream::~VDDeflateStream() {
+}
+
+const wchar_t *VDDeflateStream::GetNameForError() {
+	return mpDst->GetNameForError();
+}
+
+sint64 VDDeflateStream::Pos() {
+	return mPos;
+}
+
+void VDDeflateStream::Read(void *buffer, sint32 bytes) {
+	throw MyError("Cannot read from a compression stream.");
+}
+
+sint32 VDDeflateStream::ReadData(void *buffer, sint32 bytes) {
+	throw MyError("Cannot read from a compression stream.");
+}
+
+void VDDeflateStream::Write(const void *buffer, sint32 bytes) {
+	VDASSERT(!mbFinished);
+
+	if (mbCRCEnabled)
+		mCRCChecker.Process(buffer, bytes);
+
+	mEncoder.Write(buffer, bytes);
+	mPos += bytes;
+
+	// The encoder only emits data when it compresses a block, so the output
+	// buffer drains in large pieces.
+	if (mEncoder.GetOutput().size() >= 65536)
+		FlushOutput();
+}
+
+void VDDeflateStream::Finish() {
+	if (!mbFinished) {
+		mbFinished = true;
+		mEncoder.Finish();
+		FlushOutput();
+	}
+}
+
+void VDDeflateStream::FlushOutput() {
+	vdfastvector<uint8>& output = mEncoder.GetOutput();
+
+	if (!output.empty()) {
+		mpDst->Write(output.data(), (sint32)output.size());
+		output.clear();
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////
 
 #pragma pack(push, 2)
@@ -0,0 +1,76 @@
+#include <string.h>
+#include <vd2/system/vdstl.h>
+#include <vd2/Kasumi/blitter.h>
+#include <vd2/Kasumi/pixel.h>
+#include <vd2/Kasumi/pixmap.h>
+#include <vd2/Kasumi/pixmaputils.h>
+#include "test.h"
+
+DEFINE_TEST(BlitterCache) {
+	using namespace nsVDPixmap;
+
+	VDPixmapBuffer src(16, 8, kPixFormat_XRGB8888);
+	VDPixmapBuffer dst(16, 8, kPixFormat_YUV420_Planar);
+	VDPixmapBuffer dst2(16, 8, kPixFormat_RGB565);
+
+	for(int y=0; y<8; ++y) {
+		uint32 *p = (uint32 *)((char *)src.data + src.pitch * y);
+
+		for(int x=0; x<16; ++x)
+			p[x] = 0x102030 * (x + y);
+	}
+
+	VDPixmapBlitterCache cache(1);
+	VDPixmapBlitterCacheStats stats;
+
+	// first request compiles a blitter, second identical request must be
+	// handed a separate one while the first is checked out
+	IVDPixmapBlitter *b1 = cache.Acquire(dst, src);
+	IVDPixmapBlitter *b2 = cache.Acquire(dst, src);
+	TEST_ASSERT(b1 && b2 && b1 != b2);
+
+	cache.GetStats(stats);
+	TEST_ASSERT(stats.mHits == 0 && stats.mMisses == 2 && stats.mActiveBlitters == 2 && stats.mIdleBlitters == 0);
+
+	b1->Blit(dst, src);
+	cache.Release(b1);
+	cache.Release(b2);
+
+	// only one idle blitter is allowed, so one of the two must be evicted
+	cache.GetStats(stats);
+	TEST_ASSERT(stats.mEvictions == 1 && stats.mIdleBlitters == 1 && stats.mActiveBlitters == 0);
+
+	// steady state: the same layout must be served from the cache and
+	// produce the same result; poison the destination so that a blit that
+	// writes nothing can't pass
+	VDPixmapBuffer ref(dst);
+	memset(dst.base(), 0xCD, dst.size());
+
+	IVDPixmapBlitter *b3 = cache.Acquire(dst, src);
+	TEST_ASSERT(b3 == b1 || b3 == b2);
+	b3->Blit(dst, src);
+	cache.Release(b3);
+
+	for(int y=0; y<8; ++y) {
+		for(int x=0; x<16; ++x)
+			TEST_ASSERT(VDPixmapSample(ref, x, y) == VDPixmapSample(dst, x, y));
+	}
+
+	cache.GetStats(stats);
+	TEST_ASSERT(stats.mHits == 1 && stats.mMisses == 2);
+
+	// a different destination format must not match
+	IVDPixmapBlitter *b4 = cache.Acquire(dst2, src);
+	TEST_ASSERT(b4 && b4 != b3);
+	cache.Release(b4);
+
+	cache.GetStats(stats);
+	TEST_ASSERT(stats.mMisses == 3 && stats.mEvictions == 2 && stats.mIdleBlitters == 1);
+
+	cache.ResetStats();
+	cache.Flush();
+	cache.GetStats(stats);
+	TEST_ASSERT(stats.mHits == 0 && stats.mMisses == 0 && stats.mIdleBlitters == 0);
+
+	return 0;
+}
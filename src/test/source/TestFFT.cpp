@@ -0,0 +1,176 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vd2/system/vdalloc.h>
+#include <vd2/system/vdstl.h>
+#include <vd2/system/time.h>
+#include <vd2/VDLib/fft.h>
+#include "test.h"
+
+namespace {
+	void ComputeDFT(float *out, const float *in, uint32 n) {
+		for(uint32 k=0; k<n; ++k) {
+			double sumr = 0;
+			double sumi = 0;
+
+			for(uint32 j=0; j<n; ++j) {
+				const double ang = -6.283185307179586476925286766559 * (double)(uint32)(((uint64)j * k) % n) / (double)n;
+				const double c = cos(ang);
+				const double s = sin(ang);
+
+				sumr += c*in[j*2] - s*in[j*2+1];
+				sumi += c*in[j*2+1] + s*in[j*2];
+			}
+
+			out[k*2] = (float)sumr;
+			out[k*2+1] = (float)sumi;
+		}
+	}
+
+	float MaxError(const float *x, const float *y, uint32 n) {
+		float err = 0;
+
+		for(uint32 i=0; i<n; ++i) {
+			float e = fabsf(x[i] - y[i]);
+
+			if (err < e)
+				err = e;
+		}
+
+		return err;
+	}
+}
+
+DEFINE_TEST(FFT) {
+	static const uint32 kSizes[]={ 1, 2, 3, 4, 5, 7, 8, 12, 16, 31, 32, 64, 100, 128, 256, 1000, 1024 };
+
+	for(int i=0; i<sizeof(kSizes)/sizeof(kSizes[0]); ++i) {
+		const uint32 n = kSizes[i];
+
+		vdfastvector<float> src(n*2);
+		vdfastvector<float> dst(n*2);
+		vdfastvector<float> ref(n*2);
+
+		for(uint32 j=0; j<n*2; ++j)
+			src[j] = (float)((rand() & 1023) - 512) / 512.0f;
+
+		ComputeDFT(ref.data(), src.data(), n);
+
+		VDComplexFFT fft(n);
+
+		dst = src;
+		fft.Transform(dst.data());
+
+		// allow for error growth as O(sqrt(N) * log N)
+		const float tol = 1e-5f * n;
+		TEST_ASSERT(MaxError(dst.data(), ref.data(), n*2) < tol);
+
+		fft.InverseTransform(dst.data());
+		for(uint32 j=0; j<n*2; ++j)
+			dst[j] /= (float)n;
+
+		TEST_ASSERT(MaxError(dst.data(), src.data(), n*2) < 1e-4f);
+	}
+
+	// batched transforms must match individual transforms
+	{
+		VDComplexFFT fft(48);
+		vdfastvector<float> batch(48*2*3);
+		vdfastvector<float> single(48*2);
+
+		for(uint32 j=0; j<48*2*3; ++j)
+			batch[j] = (float)((rand() & 1023) - 512) / 512.0f;
+
+		single.assign(batch.begin() + 48*2, batch.begin() + 48*4);
+		fft.Transform(single.data());
+		fft.TransformBatch(batch.data(), 3, 48*2);
+
+		TEST_ASSERT(!memcmp(single.data(), batch.data() + 48*2, sizeof(float)*48*2));
+	}
+
+	return 0;
+}
+
+DEFINE_TEST_NONAUTO(FFTPerf) {
+	for(unsigned bits = 6; bits <= 16; bits += 2) {
+		const uint32 n = 1 << bits;
+
+		vdfastvector<float> src(n*2);
+		vdfastvector<float> buf(n*2);
+		vdautoarrayptr<uint32> permute(new uint32[n]);
+
+		for(uint32 j=0; j<n*2; ++j)
+			src[j] = (float)((rand() & 1023) - 512) / 512.0f;
+
+		VDMakePermuteTable(permute.get(), bits);
+
+		VDComplexFFT fft(n);
+
+		uint64 bestOld = (uint64)(sint64)-1;
+		uint64 bestNew = (uint64)(sint64)-1;
+		uint64 bestRef = (uint64)(sint64)-1;
+
+		for(int i=0; i<10; ++i) {
+			buf = src;
+
+			uint64 t1 = VDGetPreciseTick();
+			VDPermuteRevBitsComplex(buf.data(), bits, permute.get());
+			VDComputeComplexFFT_DIT(buf.data(), bits);
+			t1 = VDGetPreciseTick() - t1;
+
+			if (bestOld > t1)
+				bestOld = t1;
+
+			buf = src;
+
+			t1 = VDGetPreciseTick();
+			fft.Transform(buf.data());
+			t1 = VDGetPreciseTick() - t1;
+
+			if (bestNew > t1)
+				bestNew = t1;
+		}
+
+		// the reference DFT is O(N^2), so only time it for small sizes
+		if (bits <= 10) {
+			for(int i=0; i<3; ++i) {
+				uint64 t1 = VDGetPreciseTick();
+				VDComputeComplexFFT_Reference(buf.data(), src.data(), bits);
+				t1 = VDGetPreciseTick() - t1;
+
+				if (bestRef > t1)
+					bestRef = t1;
+			}
+		}
+
+		const double scale = 1000000.0 / VDGetPreciseTicksPerSecond();
+
+		if (bits <= 10)
+			printf("%6u points: reference %10.1fus  DIT %8.1fus  planned %8.1fus\n", n, (double)bestRef * scale, (double)bestOld * scale, (double)bestNew * scale);
+		else
+			printf("%6u points: reference        n/a    DIT %8.1fus  planned %8.1fus\n", n, (double)bestOld * scale, (double)bestNew * scale);
+	}
+
+	static const uint32 kOddSizes[]={ 100, 1000, 1764, 4410 };
+
+	for(int k=0; k<sizeof(kOddSizes)/sizeof(kOddSizes[0]); ++k) {
+		const uint32 n = kOddSizes[k];
+
+		vdfastvector<float> buf(n*2, 0.0f);
+		VDComplexFFT fft(n);
+
+		uint64 best = (uint64)(sint64)-1;
+		for(int i=0; i<10; ++i) {
+			uint64 t1 = VDGetPreciseTick();
+			fft.Transform(buf.data());
+			t1 = VDGetPreciseTick() - t1;
+
+			if (best > t1)
+				best = t1;
+		}
+
+		printf("%6u points: planned (chirp-z) %8.1fus\n", n, (double)best * 1000000.0 / VDGetPreciseTicksPerSecond());
+	}
+
+	return 0;
+}
@@ -0,0 +1,196 @@
+#include <vd2/system/cpuaccel.h>
+#include <vd2/system/time.h>
+#include <vd2/system/vdalloc.h>
+#include <vd2/system/vdstl.h>
+#include <vd2/Meia/encode_jpeg.h>
+#include "test.h"
+
+namespace {
+	// Smooth gradients with noise and hard edges, so that blocks have both
+	// short and long runs of zero coefficients.
+	void FillJPEGTestImage(vdfastvector<char>& buf, ptrdiff_t& pitch, int format, int w, int h, uint32 seed) {
+		static const int kBytesPerPixel[]={ 2, 3, 4 };
+
+		pitch = (w * kBytesPerPixel[format] + 3) & ~3;
+		buf.resize(pitch * h);
+
+		for(int y=0; y<h; ++y) {
+			uint8 *p = (uint8 *)buf.data() + pitch * y;
+
+			for(int x=0; x<pitch; ++x) {
+				seed = seed * 214013 + 2531011;
+
+				p[x] = (uint8)(((x * y) >> 6) + ((seed >> 16) & 15) + ((x / 37 + y / 23) & 1 ? 100 : 0));
+			}
+		}
+	}
+
+	// Checks that the image is framed by SOI and EOI, walks the marker
+	// segments up to the scan, and counts the restart markers in the
+	// entropy-coded data. Any other FF byte there must be stuffed.
+	bool CheckJPEGStructure(const vdfastvector<char>& data, int& restartCount, int& restartInterval) {
+		const uint8 *p = (const uint8 *)data.data();
+		const size_t len = data.size();
+
+		if (len < 4 || p[0] != 0xFF || p[1] != 0xD8 || p[len-2] != 0xFF || p[len-1] != 0xD9)
+			return false;
+
+		restartInterval = 0;
+
+		size_t pos = 2;
+		for(;;) {
+			if (pos + 4 > len || p[pos] != 0xFF)
+				return false;
+
+			const uint8 marker = p[pos+1];
+
+			if (marker == 0xDD)
+				restartInterval = (p[pos+4] << 8) + p[pos+5];
+
+			pos += 2 + (p[pos+2] << 8) + p[pos+3];
+
+			if (marker == 0xDA)
+				break;
+		}
+
+		restartCount = 0;
+
+		for(; pos < len-2; ++pos) {
+			if (p[pos] == 0xFF) {
+				const uint8 c = p[pos+1];
+
+				if (c == 0xD0 + (restartCount & 7))
+					++restartCount;
+				else if (c)
+					return false;
+
+				++pos;
+			}
+		}
+
+		return pos == len-2;
+	}
+}
+
+DEFINE_TEST(JPEG) {
+	static const int kSizes[][2]={
+		{ 1, 1 },
+		{ 7, 3 },
+		{ 17, 33 },
+		{ 640, 480 },
+		{ 1001, 75 },
+	};
+
+	const long exts = CPUGetEnabledExtensions();
+
+	vdautoptr<IVDJPEGEncoder> enc(VDCreateJPEGEncoder());
+	vdfastvector<char> src;
+	vdfastvector<char> scalarOutput;
+	vdfastvector<char> output;
+
+	for(int i=0; i<sizeof(kSizes)/sizeof(kSizes[0]); ++i) {
+		const int w = kSizes[i][0];
+		const int h = kSizes[i][1];
+
+		for(int format=0; format<3; ++format) {
+			ptrdiff_t pitch;
+			FillJPEGTestImage(src, pitch, format, w, h, i);
+
+			// alternate between top-down and bottom-up images
+			const char *srcp = src.data();
+			if (i & 1) {
+				srcp += pitch * (h - 1);
+				pitch = -pitch;
+			}
+
+			for(int mode=0; mode<12; ++mode) {
+				const IVDJPEGEncoder::eChromaMode chromaMode = (IVDJPEGEncoder::eChromaMode)(mode % 3);
+				const bool optimize = ((mode / 3) & 1) != 0;
+				const bool parallel = mode >= 6;
+
+				enc->SetParallelMode(parallel);
+				enc->Init(75, optimize, chromaMode);
+
+				// The SSE2 routines must give exactly the same output as the
+				// scalar ones.
+				CPUEnableExtensions(exts & ~CPUF_SUPPORTS_SSE2);
+				scalarOutput.clear();
+				enc->Encode(scalarOutput, srcp, pitch, format, w, h);
+				CPUEnableExtensions(exts);
+
+				output.clear();
+				enc->Encode(output, srcp, pitch, format, w, h);
+				TEST_ASSERT(output.size() == scalarOutput.size() && !memcmp(output.data(), scalarOutput.data(), output.size()));
+
+				// In parallel mode, every MCU row after the first starts with
+				// a restart marker.
+				int restartCount;
+				int restartInterval;
+				TEST_ASSERT(CheckJPEGStructure(output, restartCount, restartInterval));
+
+				const int mcuWidth = chromaMode == IVDJPEGEncoder::kYCC444 ? 8 : 16;
+				const int mcuHeight = chromaMode == IVDJPEGEncoder::kYCC420 ? 16 : 8;
+				const int mcuRows = (h + mcuHeight - 1) / mcuHeight;
+
+				if (parallel && mcuRows > 1) {
+					TEST_ASSERT(restartCount == mcuRows - 1);
+					TEST_ASSERT(restartInterval == (w + mcuWidth - 1) / mcuWidth);
+				} else {
+					TEST_ASSERT(restartCount == 0 && restartInterval == 0);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+DEFINE_TEST_NONAUTO(JPEGPerf) {
+	static const char *const kModeNames[]={
+		"Scalar",
+		"SSE2",
+		"SSE2 banded",
+	};
+
+	const long exts = CPUGetEnabledExtensions();
+	const double tps = VDGetPreciseTicksPerSecond();
+	const int w = 1920;
+	const int h = 1080;
+
+	vdfastvector<char> src;
+	ptrdiff_t pitch;
+	FillJPEGTestImage(src, pitch, IVDJPEGEncoder::kFormatRGB32, w, h, 1);
+
+	vdautoptr<IVDJPEGEncoder> enc(VDCreateJPEGEncoder());
+	vdfastvector<char> output;
+
+	for(int mode=0; mode<3; ++mode) {
+		if (mode && !(exts & CPUF_SUPPORTS_SSE2))
+			continue;
+
+		CPUEnableExtensions(mode ? exts : exts & ~CPUF_SUPPORTS_SSE2);
+		enc->SetParallelMode(mode == 2);
+
+		for(int optimize=0; optimize<2; ++optimize) {
+			enc->Init(75, optimize != 0);
+
+			uint64 best = (uint64)(sint64)-1;
+			for(int j=0; j<5; ++j) {
+				output.clear();
+
+				uint64 t = VDGetPreciseTick();
+				enc->Encode(output, src.data(), pitch, IVDJPEGEncoder::kFormatRGB32, w, h);
+				t = VDGetPreciseTick() - t;
+
+				if (best > t)
+					best = t;
+			}
+
+			printf("%-12s %-10s %8.2fMP/sec %9u bytes\n", kModeNames[mode], optimize ? "optimized" : "stock", (double)(w*h) / 1000000.0 / (double)best * tps, (uint32)output.size());
+		}
+
+		CPUEnableExtensions(exts);
+	}
+
+	return 0;
+}
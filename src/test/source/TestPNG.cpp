@@ -0,0 +1,130 @@
+#include <vd2/system/cpuaccel.h>
+#include <vd2/system/time.h>
+#include <vd2/system/vdalloc.h>
+#include <vd2/system/vdstl.h>
+#include <vd2/Kasumi/pixmap.h>
+#include <vd2/Kasumi/pixmaputils.h>
+#include <vd2/Meia/decode_png.h>
+#include <vd2/Meia/encode_png.h>
+#include "test.h"
+
+namespace {
+	// Smooth gradients with noise and hard edges, so that every PNG filter
+	// type wins on some rows.
+	void FillPNGTestImage(VDPixmap& px, uint32 seed) {
+		for(int y=0; y<px.h; ++y) {
+			uint8 *p = (uint8 *)px.data + px.pitch * y;
+
+			for(int x=0; x<px.w*3; ++x) {
+				seed = seed * 214013 + 2531011;
+
+				p[x] = (uint8)(((x * y) >> 6) + ((seed >> 16) & 7) + ((x / 97 + y / 61) & 1 ? 120 : 0));
+			}
+		}
+	}
+
+	bool CheckPNGRoundTrip(const VDPixmap& src, const void *data, uint32 len) {
+		vdautoptr<IVDImageDecoderPNG> dec(VDCreateImageDecoderPNG());
+
+		if (dec->Decode(data, len) != kPNGDecodeOK)
+			return false;
+
+		const VDPixmap& dst = dec->GetFrameBuffer();
+		if (dst.w != src.w || dst.h != src.h || dst.format != nsVDPixmap::kPixFormat_RGB888)
+			return false;
+
+		for(int y=0; y<src.h; ++y) {
+			if (memcmp((const uint8 *)src.data + src.pitch * y, (const uint8 *)dst.data + dst.pitch * y, src.w * 3))
+				return false;
+		}
+
+		return true;
+	}
+}
+
+DEFINE_TEST(PNG) {
+	static const int kSizes[][2]={
+		{ 1, 1 },
+		{ 5, 300 },
+		{ 17, 2 },
+		{ 640, 480 },
+		{ 2000, 150 },
+	};
+
+	const long exts = CPUGetEnabledExtensions();
+
+	vdautoptr<IVDImageEncoderPNG> enc(VDCreateImageEncoderPNG());
+	vdfastvector<uint8> scalarOutput;
+
+	for(int i=0; i<sizeof(kSizes)/sizeof(kSizes[0]); ++i) {
+		VDPixmapBuffer px(kSizes[i][0], kSizes[i][1], nsVDPixmap::kPixFormat_RGB888);
+		FillPNGTestImage(px, i);
+
+		const void *p;
+		uint32 len;
+
+		// The SSE2 filters must pick the same filters as the scalar ones.
+		CPUEnableExtensions(exts & ~CPUF_SUPPORTS_SSE2);
+		enc->SetParallelMode(false);
+		enc->Encode(px, p, len, false);
+		CPUEnableExtensions(exts);
+
+		TEST_ASSERT(CheckPNGRoundTrip(px, p, len));
+		scalarOutput.assign((const uint8 *)p, (const uint8 *)p + len);
+
+		enc->Encode(px, p, len, false);
+		TEST_ASSERT(len == scalarOutput.size() && !memcmp(p, scalarOutput.data(), len));
+
+		// Banded output differs, but must decode to the same image.
+		for(int quick=0; quick<2; ++quick) {
+			enc->SetParallelMode(true);
+			enc->Encode(px, p, len, quick != 0);
+			TEST_ASSERT(CheckPNGRoundTrip(px, p, len));
+		}
+	}
+
+	return 0;
+}
+
+DEFINE_TEST_NONAUTO(PNGPerf) {
+	static const char *const kModeNames[]={
+		"Scalar",
+		"SSE2",
+		"SSE2 banded",
+	};
+
+	const long exts = CPUGetEnabledExtensions();
+	const double tps = VDGetPreciseTicksPerSecond();
+
+	VDPixmapBuffer px(1920, 1080, nsVDPixmap::kPixFormat_RGB888);
+	FillPNGTestImage(px, 1);
+
+	vdautoptr<IVDImageEncoderPNG> enc(VDCreateImageEncoderPNG());
+
+	for(int mode=0; mode<3; ++mode) {
+		if (mode && !(exts & CPUF_SUPPORTS_SSE2))
+			continue;
+
+		CPUEnableExtensions(mode ? exts : exts & ~CPUF_SUPPORTS_SSE2);
+		enc->SetParallelMode(mode == 2);
+
+		const void *p;
+		uint32 len = 0;
+
+		uint64 best = (uint64)(sint64)-1;
+		for(int j=0; j<5; ++j) {
+			uint64 t = VDGetPreciseTick();
+			enc->Encode(px, p, len, false);
+			t = VDGetPreciseTick() - t;
+
+			if (best > t)
+				best = t;
+		}
+
+		CPUEnableExtensions(exts);
+
+		printf("%-12s %8.2fMP/sec %9u bytes\n", kModeNames[mode], (double)(px.w*px.h) / 1000000.0 / (double)best * tps, len);
+	}
+
+	return 0;
+}
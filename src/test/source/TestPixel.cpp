@@ -1,4 +1,6 @@
 #include <vd2/Kasumi/pixel.h>
+#include <vd2/Kasumi/pixmap.h>
+#include <vd2/Kasumi/pixmaputils.h>
 #include "test.h"
 
 DEFINE_TEST(Pixel) {
@@ -47,3 +49,40 @@ DEFINE_TEST(Pixel) {
 	return 0;
 }
 
+DEFINE_TEST(PixelInterpolateEdges) {
+	using namespace nsVDPixmap;
+
+	// Samples past the right and bottom edges must be clamped to the last
+	// column and row instead of reading beyond them.
+	VDPixmapBuffer px(8, 8, kPixFormat_YUV420_P016);
+
+	for(int y=0; y<8; ++y) {
+		uint16 *p = (uint16 *)((char *)px.data + px.pitch * y);
+
+		for(int x=0; x<8; ++x)
+			p[x] = (uint16)(0x4000 + 0x400*x + 0x1000*y);
+	}
+
+	for(int y=0; y<4; ++y) {
+		uint16 *p = (uint16 *)((char *)px.data2 + px.pitch2 * y);
+
+		for(int x=0; x<4; ++x) {
+			p[x*2+0] = (uint16)(0x6000 + 0x1000*x);
+			p[x*2+1] = (uint16)(0x6000 + 0x1000*y);
+		}
+	}
+
+	const uint32 corner = VDPixmapInterpolateSampleRGB24(px, (7 << 8) + 128, (7 << 8) + 128);
+
+	for(int i=1; i<=4; ++i) {
+		for(int y=0; y<8; ++y)
+			TEST_ASSERT(VDPixmapInterpolateSampleRGB24(px, ((7 + i) << 8) + 128, (y << 8) + 128) == VDPixmapInterpolateSampleRGB24(px, (7 << 8) + 128, (y << 8) + 128));
+
+		for(int x=0; x<8; ++x)
+			TEST_ASSERT(VDPixmapInterpolateSampleRGB24(px, (x << 8) + 128, ((7 + i) << 8) + 128) == VDPixmapInterpolateSampleRGB24(px, (x << 8) + 128, (7 << 8) + 128));
+
+		TEST_ASSERT(VDPixmapInterpolateSampleRGB24(px, ((7 + i) << 8) + 128, ((7 + i) << 8) + 128) == corner);
+	}
+
+	return 0;
+}
@@ -223,6 +223,7 @@ DEFINE_TEST(Pixmap) {
 				case kPixFormat_RGB565:
 				case kPixFormat_RGB888:
 				case kPixFormat_XRGB8888:
+				case kPixFormat_XRGB64:
 					for(int i=0; i<8; ++i) {
 						VDPixmapBuffer& src = srcarray[i];
 						src.init(size, size, kPixFormat_XRGB8888);
@@ -245,6 +246,11 @@ DEFINE_TEST(Pixmap) {
 				case kPixFormat_YUV420_Planar_Centered:
 				case kPixFormat_YUV422_Planar_16F:
 				case kPixFormat_YUV422_V210:
+				case kPixFormat_YUV444_Planar16:
+				case kPixFormat_YUV422_Planar16:
+				case kPixFormat_YUV420_Planar16:
+				case kPixFormat_YUV420_P010:
+				case kPixFormat_YUV420_P016:
 				case kPixFormat_YUV420i_Planar:
 				case kPixFormat_YUV420it_Planar:
 				case kPixFormat_YUV420ib_Planar:
@@ -351,6 +357,7 @@ DEFINE_TEST(Pixmap) {
 					case kPixFormat_RGB565:
 					case kPixFormat_RGB888:
 					case kPixFormat_XRGB8888:
+					case kPixFormat_XRGB64:
 						checkformat = kPixFormat_XRGB8888;
 						dstcheckidx = 0;
 						break;
@@ -368,6 +375,11 @@ DEFINE_TEST(Pixmap) {
 					case kPixFormat_YUV420_Planar_Centered:
 					case kPixFormat_YUV422_Planar_16F:
 					case kPixFormat_YUV422_V210:
+					case kPixFormat_YUV444_Planar16:
+					case kPixFormat_YUV422_Planar16:
+					case kPixFormat_YUV420_Planar16:
+					case kPixFormat_YUV420_P010:
+					case kPixFormat_YUV420_P016:
 					case kPixFormat_YUV420i_Planar:
 					case kPixFormat_YUV420it_Planar:
 					case kPixFormat_YUV420ib_Planar:
@@ -1,9 +1,15 @@
+#include <stdlib.h>
+#include <string.h>
 #include <vd2/system/cpuaccel.h>
 #include <vd2/system/filesys.h>
 #include <vd2/system/memory.h>
+#include <vd2/system/vdalloc.h>
+#include <vd2/system/vdstl.h>
 #include <vd2/Kasumi/pixmap.h>
 #include <vd2/Kasumi/resample.h>
 #include "test.h"
+#include "../../Kasumi/h/uberblit.h"
+#include "../../Kasumi/h/uberblit_gen.h"
 
 DEFINE_TEST(Resampler) {
 	static const uint32 kCPUModes[]={
@@ -77,5 +83,141 @@ DEFINE_TEST(Resampler) {
 		}
 	}
 
+#ifdef _M_AMD64
+	// The AMD64 vector stages are required to match the generic stages
+	// exactly, including at the edges where taps are folded together.
+	if (availModes & CPUF_SUPPORTS_SSE2) {
+		static const IVDPixmapResampler::FilterMode kFilterModes[]={
+			IVDPixmapResampler::kFilterLinear,
+			IVDPixmapResampler::kFilterCubic,
+			IVDPixmapResampler::kFilterLanczos3,
+		};
+
+		static const int kSizes[]={ 1, 3, 7, 8, 15, 16, 17, 31, 64 };
+		const int kNumSizes = sizeof(kSizes)/sizeof(kSizes[0]);
+
+		uint8 src[64*64];
+		uint8 ref[64*64];
+		uint8 dst[64*64];
+
+		for(int i=0; i<sizeof src; ++i)
+			src[i] = (uint8)rand();
+
+		for(int fmodei = 0; fmodei < sizeof(kFilterModes)/sizeof(kFilterModes[0]); ++fmodei) {
+			for(int si = 0; si < kNumSizes; ++si) {
+				for(int di = 0; di < kNumSizes; ++di) {
+					VDPixmap pxsrc = {};
+					pxsrc.data = src;
+					pxsrc.pitch = 64;
+					pxsrc.w = kSizes[si];
+					pxsrc.h = kSizes[kNumSizes - 1 - si];
+					pxsrc.format = nsVDPixmap::kPixFormat_Y8;
+
+					VDPixmap pxdst = {};
+					pxdst.pitch = 64;
+					pxdst.w = kSizes[di];
+					pxdst.h = kSizes[(di + 3) % kNumSizes];
+					pxdst.format = nsVDPixmap::kPixFormat_Y8;
+
+					VDMemset8(ref, 0xCD, sizeof ref);
+					VDMemset8(dst, 0xCD, sizeof dst);
+
+					CPUEnableExtensions(CPUF_SUPPORTS_FPU);
+					pxdst.data = ref;
+					VDPixmapResample(pxdst, pxsrc, kFilterModes[fmodei]);
+
+					CPUEnableExtensions(availModes);
+					pxdst.data = dst;
+					VDPixmapResample(pxdst, pxsrc, kFilterModes[fmodei]);
+
+					TEST_ASSERT(!memcmp(ref, dst, sizeof dst));
+				}
+			}
+		}
+
+		// The float stages have no public resampler entry point, so they are
+		// driven directly through the uberblit generator. Single-channel rows
+		// are processed four pixels at a time, so the sizes include widths
+		// that leave a partial group.
+		static const uint32 kFloatTypes[][2]={
+			{ kVDPixType_32F_LE, 1 },
+			{ kVDPixType_32Fx4_LE, 4 },
+		};
+
+		vdfastvector<float> fsrc(64*64*4);
+		vdfastvector<float> fref(64*64*4);
+		vdfastvector<float> fdst(64*64*4);
+
+		for(int i=0; i<64*64*4; ++i)
+			fsrc[i] = (float)rand() / (float)RAND_MAX;
+
+		for(int typei = 0; typei < 2; ++typei) {
+			const uint32 type = kFloatTypes[typei][0];
+			const uint32 channels = kFloatTypes[typei][1];
+
+			for(int fmodei = 0; fmodei < sizeof(kFilterModes)/sizeof(kFilterModes[0]); ++fmodei) {
+				for(int si = 0; si < kNumSizes; ++si) {
+					for(int di = 0; di < kNumSizes; ++di) {
+						const uint32 sw = kSizes[si];
+						const uint32 sh = kSizes[kNumSizes - 1 - si];
+						const uint32 dw = kSizes[di];
+						const uint32 dh = kSizes[(di + 3) % kNumSizes];
+						const float xfactor = (float)sw / (float)dw;
+						const float yfactor = (float)sh / (float)dh;
+
+						VDPixmap pxsrc = {};
+						pxsrc.data = fsrc.data();
+						pxsrc.pitch = 64*4*sizeof(float);
+						pxsrc.w = sw;
+						pxsrc.h = sh;
+						pxsrc.format = nsVDPixmap::kPixFormat_XRGB8888;
+
+						// XRGB8888 has one float's worth of bytes per pixel.
+						VDPixmap pxdst = {};
+						pxdst.pitch = 64*4*sizeof(float);
+						pxdst.w = dw * channels;
+						pxdst.h = dh;
+						pxdst.format = nsVDPixmap::kPixFormat_XRGB8888;
+
+						for(int pass=0; pass<2; ++pass) {
+							CPUEnableExtensions(pass ? availModes : CPUF_SUPPORTS_FPU);
+
+							VDPixmapUberBlitterGenerator gen;
+							gen.ldsrc(0, 0, 0, 0, sw, sh, type, sw * channels * sizeof(float));
+
+							switch(kFilterModes[fmodei]) {
+								case IVDPixmapResampler::kFilterLinear:
+									gen.linearh(0.5f * xfactor, xfactor, dw, false);
+									gen.linearv(0.5f * yfactor, yfactor, dh, false);
+									break;
+
+								case IVDPixmapResampler::kFilterCubic:
+									gen.cubich(0.5f * xfactor, xfactor, dw, -0.6f, false);
+									gen.cubicv(0.5f * yfactor, yfactor, dh, -0.6f, false);
+									break;
+
+								case IVDPixmapResampler::kFilterLanczos3:
+									gen.lanczos3h(0.5f * xfactor, xfactor, dw);
+									gen.lanczos3v(0.5f * yfactor, yfactor, dh);
+									break;
+							}
+
+							vdautoptr<IVDPixmapBlitter> blitter(gen.create());
+
+							vdfastvector<float>& out = pass ? fdst : fref;
+							VDMemset32(out.data(), 0xCDCDCDCD, out.size());
+							pxdst.data = out.data();
+							blitter->Blit(pxdst, pxsrc);
+						}
+
+						TEST_ASSERT(!memcmp(fref.data(), fdst.data(), fref.size() * sizeof(float)));
+					}
+				}
+			}
+		}
+	}
+#endif
+
+	CPUEnableExtensions(availModes);
 	return 0;
 }
@@ -0,0 +1,176 @@
+#include <stdlib.h>
+#include <vd2/system/cpuaccel.h>
+#include <vd2/system/math.h>
+#include <vd2/system/time.h>
+#include <vd2/Kasumi/pixmap.h>
+#include <vd2/Kasumi/pixmaputils.h>
+#include <vd2/Kasumi/triblt.h>
+#include "test.h"
+
+namespace {
+	void FillTriBltTestSource(VDPixmap& px) {
+		for(int y=0; y<px.h; ++y) {
+			uint32 *p = (uint32 *)vdptroffset(px.data, px.pitch * y);
+
+			for(int x=0; x<px.w; ++x)
+				p[x] = ((x * 0x010305) ^ (y * 0x070301) ^ (((x >> 3) + (y >> 3)) & 1 ? 0xffffff : 0)) & 0xffffff;
+		}
+	}
+
+	// Draws the source over the destination rotated and with a perspective
+	// warp, so that the spans have varying texel steps and mip levels.
+	void RenderTriBltTestFrame(VDPixmap& dst, const VDPixmapTextureMipmapChain& mips, int srcw, int srch, VDTriBltFilterMode filterMode, float angle) {
+		VDTriBltVertex vx[4]={
+			{ -1, -1, 0, 0, 0 },
+			{ +1, -1, 0, (float)srcw, 0 },
+			{ +1, +1, 0, (float)srcw, (float)srch },
+			{ -1, +1, 0, 0, (float)srch },
+		};
+
+		static const int indices[6]={0,1,2,0,2,3};
+
+		const float c = cosf(angle);
+		const float s = sinf(angle);
+		const float xf[16]={
+			c*1.1f, -s*1.1f, 0, 0,
+			s*1.1f,  c*1.1f, 0, 0,
+			0,       0,      1, 0,
+			0.25f,   0.15f,  0, 1.2f,
+		};
+
+		VDMemset32Rect(dst.data, dst.pitch, 0, dst.w, dst.h);
+		VDPixmapTriBlt(dst, mips.Mips(), mips.Levels(), vx, 4, indices, 6, filterMode, -0.5f, xf);
+	}
+}
+
+DEFINE_TEST(TriBlt) {
+	using namespace nsVDPixmap;
+
+#ifdef _M_IX86
+	// The 32-bit assembly spans interpolate with 16-bit rather than 8-bit
+	// subtexel fractions, so they can only approximately match the C spans.
+	const int kTolerance = 4;
+#else
+	const int kTolerance = 0;
+#endif
+
+	const long exts = CPUGetEnabledExtensions();
+
+	if (!(exts & CPUF_SUPPORTS_SSE2))
+		return 0;
+
+	// large enough that the renderer splits the frame across threads
+	const int w = 1024;
+	const int h = 600;
+
+	VDPixmapBuffer src(640, 480, kPixFormat_XRGB8888);
+	FillTriBltTestSource(src);
+
+	VDPixmapBuffer dst1(w, h, kPixFormat_XRGB8888);
+	VDPixmapBuffer dst2(w, h, kPixFormat_XRGB8888);
+
+	int failures = 0;
+
+	for(int mode=0; mode<kTriBltFilterCount; ++mode) {
+		VDPixmapTextureMipmapChain mips(src, false, mode == kTriBltFilterBicubicMipLinear, mode ? 16 : 1);
+
+		for(int rot=0; rot<3; ++rot) {
+			const float angle = 0.35f * (float)rot;
+
+			// render the reference with no SIMD paths at all, so that MMX isn't
+			// compared against itself on x86
+			CPUEnableExtensions(exts & (CPUF_SUPPORTS_CPUID | CPUF_SUPPORTS_FPU));
+			RenderTriBltTestFrame(dst1, mips, src.w, src.h, (VDTriBltFilterMode)mode, angle);
+			CPUEnableExtensions(exts);
+			RenderTriBltTestFrame(dst2, mips, src.w, src.h, (VDTriBltFilterMode)mode, angle);
+
+			int drawn = 0;
+			int mismatches = 0;
+			for(int y=0; y<h; ++y) {
+				const uint32 *p1 = (const uint32 *)vdptroffset(dst1.data, dst1.pitch * y);
+				const uint32 *p2 = (const uint32 *)vdptroffset(dst2.data, dst2.pitch * y);
+
+				for(int x=0; x<w; ++x) {
+					if (p1[x])
+						++drawn;
+
+					const uint32 c1 = p1[x];
+					const uint32 c2 = p2[x];
+
+					if (abs((int)(c1 & 0xff) - (int)(c2 & 0xff)) <= kTolerance
+						&& abs((int)((c1 >> 8) & 0xff) - (int)((c2 >> 8) & 0xff)) <= kTolerance
+						&& abs((int)((c1 >> 16) & 0xff) - (int)((c2 >> 16) & 0xff)) <= kTolerance)
+						continue;
+
+					if (!mismatches++)
+						printf("    Mode %d, rotation %d: mismatch at (%d,%d): %06X != %06X\n", mode, rot, x, y, p1[x], p2[x]);
+				}
+			}
+
+			if (mismatches) {
+				printf("    Mode %d, rotation %d: %d pixels differ\n", mode, rot, mismatches);
+				++failures;
+			}
+
+			if (drawn < w*h/4) {
+				printf("    Mode %d, rotation %d: only %d pixels drawn\n", mode, rot, drawn);
+				++failures;
+			}
+		}
+	}
+
+	TEST_ASSERT(!failures);
+	return 0;
+}
+
+DEFINE_TEST_NONAUTO(TriBltPerf) {
+	using namespace nsVDPixmap;
+
+	static const char *const kModeNames[]={
+		"Point",
+		"Bilinear",
+		"Trilinear",
+		"Bicubic",
+	};
+
+	const long exts = CPUGetEnabledExtensions();
+	const double tps = VDGetPreciseTicksPerSecond();
+
+	VDPixmapBuffer src(1920, 1080, kPixFormat_XRGB8888);
+	FillTriBltTestSource(src);
+
+	VDPixmapBuffer dst(1920, 1080, kPixFormat_XRGB8888);
+
+	printf("%-10s %14s %14s\n", "Filter", "Scalar", "SSE2");
+
+	for(int mode=0; mode<kTriBltFilterCount; ++mode) {
+		VDPixmapTextureMipmapChain mips(src, false, mode == kTriBltFilterBicubicMipLinear, mode ? 16 : 1);
+
+		double speed[2] = {0, 0};
+
+		for(int simd=0; simd<2; ++simd) {
+			if (simd && !(exts & CPUF_SUPPORTS_SSE2))
+				continue;
+
+			CPUEnableExtensions(simd ? exts : exts & (CPUF_SUPPORTS_CPUID | CPUF_SUPPORTS_FPU));
+
+			uint64 best = (uint64)(sint64)-1;
+			for(int j=0; j<5; ++j) {
+				uint64 t = VDGetPreciseTick();
+				RenderTriBltTestFrame(dst, mips, src.w, src.h, (VDTriBltFilterMode)mode, 0.3f);
+				t = VDGetPreciseTick() - t;
+
+				if (best > t)
+					best = t;
+			}
+
+			CPUEnableExtensions(exts);
+
+			speed[simd] = (double)(dst.w*dst.h) / 1000000.0 / (double)best * tps;
+		}
+
+		printf("%-10s %8.2fMP/sec %8.2fMP/sec (%.2fx)\n", kModeNames[mode], speed[0], speed[1], speed[1] / speed[0]);
+	}
+
+	return 0;
+}
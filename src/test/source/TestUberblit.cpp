@@ -1,4 +1,6 @@
+#include <stdlib.h>
 #include "test.h"
+#include <vd2/system/cpuaccel.h>
 #include <vd2/system/vdalloc.h>
 #include <vd2/Kasumi/pixel.h>
 #include <vd2/Kasumi/pixmap.h>
@@ -168,3 +170,157 @@ failed2:;
 	}
 	return 0;
 }
+
+DEFINE_TEST(UberblitSSE2) {
+	using namespace nsVDPixmap;
+
+	// The SSE2 generators for the 32F pipeline must give the same results as
+	// the generic ones.
+	const long exts = CPUGetEnabledExtensions();
+	if (!(exts & CPUF_SUPPORTS_SSE2))
+		return 0;
+
+	static const int kPairs[][2]={
+		{ kPixFormat_XRGB8888,			kPixFormat_YUV422_Planar_16F },
+		{ kPixFormat_YUV422_Planar_16F,	kPixFormat_XRGB8888 },
+		{ kPixFormat_YUV422_V210,		kPixFormat_XRGB8888 },
+		{ kPixFormat_XRGB8888,			kPixFormat_YUV422_V210 },
+		{ kPixFormat_YUV422_V210,		kPixFormat_YUV420_Planar_709 },
+		{ kPixFormat_XRGB64,			kPixFormat_YUV444_Planar16 },
+		{ kPixFormat_YUV420_Planar16,	kPixFormat_XRGB64 },
+		{ kPixFormat_YUV444_Planar_FR,	kPixFormat_YUV444_Planar16 },
+	};
+
+	enum { kPairCount = sizeof(kPairs)/sizeof(kPairs[0]) };
+
+	// odd width to exercise the scalar tails
+	const int w = 37;
+	const int h = 7;
+
+	VDPixmapBuffer rgb(w, h, kPixFormat_XRGB8888);
+
+	srand(1);
+	for(int y=0; y<h; ++y) {
+		uint32 *p = (uint32 *)vdptroffset(rgb.data, rgb.pitch * y);
+
+		for(int x=0; x<w; ++x)
+			p[x] = ((rand() & 0xfff) << 12) + (rand() & 0xfff);
+	}
+
+	for(int i=0; i<kPairCount; ++i) {
+		const int srcformat = kPairs[i][0];
+		const int dstformat = kPairs[i][1];
+
+		VDPixmapBuffer src(w, h, srcformat);
+		VDPixmapBlt(src, rgb);
+
+		VDPixmapBuffer dst[2];
+		for(int simd=0; simd<2; ++simd) {
+			dst[simd].init(w, h, dstformat);
+
+			CPUEnableExtensions(simd ? exts : exts & ~CPUF_SUPPORTS_SSE2);
+			vdautoptr<IVDPixmapBlitter> blitter(VDPixmapCreateBlitter(dst[simd], src));
+			CPUEnableExtensions(exts);
+
+			blitter->Blit(dst[simd], src);
+		}
+
+		for(int y=0; y<h; ++y) {
+			for(int x=0; x<w; ++x) {
+				uint32 p1 = VDPixmapSample(dst[0], x, y) & 0xffffff;
+				uint32 p2 = VDPixmapSample(dst[1], x, y) & 0xffffff;
+
+				if (p1 != p2) {
+					printf("        Failed: %s -> %s\n", VDPixmapGetInfo(srcformat).name, VDPixmapGetInfo(dstformat).name);
+					printf("            (%d,%d) generic %06x != SSE2 %06x\n", x, y, p1, p2);
+					VDASSERT(false);
+					return 1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+DEFINE_TEST(UberblitFused) {
+	using namespace nsVDPixmap;
+
+	// The fused YCbCr <-> XRGB8888 blitters must agree with the uberblit
+	// pipeline, aside from rounding in the chroma filters.
+	static const int kFormats[]={
+		kPixFormat_YUV422_UYVY,
+		kPixFormat_YUV422_YUYV,
+		kPixFormat_YUV422_UYVY_709,
+		kPixFormat_YUV422_YUYV_709,
+		kPixFormat_YUV420_Planar,
+		kPixFormat_YUV420_Planar_709,
+		kPixFormat_YUV420_NV12,
+	};
+
+	enum { kFormatCount = sizeof(kFormats)/sizeof(kFormats[0]) };
+
+	srand(1);
+
+	for(int size=7; size<=8; ++size) {
+		const int w = size * 3;
+		const int h = size;
+
+		// smooth gradients with a little noise, to exercise the chroma filters
+		VDPixmapBuffer rgb(w, h, kPixFormat_XRGB8888);
+		for(int y=0; y<h; ++y) {
+			uint32 *p = (uint32 *)vdptroffset(rgb.data, rgb.pitch * y);
+
+			for(int x=0; x<w; ++x) {
+				const int r = (x * 255) / (w - 1);
+				const int g = (y * 255) / (h - 1);
+				const int b = (rand() & 255);
+
+				p[x] = 0xFF000000 + (r << 16) + (g << 8) + b;
+			}
+		}
+
+		for(int i=0; i<kFormatCount; ++i) {
+			const int format = kFormats[i];
+
+			for(int dir=0; dir<2; ++dir) {
+				VDPixmapBuffer src;
+
+				if (dir) {
+					src.init(w, h, format);
+					VDPixmapBlt(src, rgb);
+				} else
+					src.assign(rgb);
+
+				const int dstformat = dir ? kPixFormat_XRGB8888 : format;
+				VDPixmapBuffer dstFused(w, h, dstformat);
+				VDPixmapBuffer dstUber(w, h, dstformat);
+
+				VDPixmapBlt(dstFused, src);
+
+				vdautoptr<IVDPixmapBlitter> blitter(VDPixmapCreateBlitter(dstUber, src));
+				blitter->Blit(dstUber, src);
+
+				for(int y=0; y<h; ++y) {
+					for(int x=0; x<w; ++x) {
+						const uint32 p1 = VDPixmapSample(dstFused, x, y);
+						const uint32 p2 = VDPixmapSample(dstUber, x, y);
+
+						const int re = (int)((p1>>16)&0xff) - (int)((p2>>16)&0xff);
+						const int ge = (int)((p1>> 8)&0xff) - (int)((p2>> 8)&0xff);
+						const int be = (int)((p1    )&0xff) - (int)((p2    )&0xff);
+
+						if (abs(re) > 3 || abs(ge) > 3 || abs(be) > 3) {
+							printf("        Failed: %s -> %s\n", VDPixmapGetInfo(src.format).name, VDPixmapGetInfo(dstformat).name);
+							printf("            (%d,%d) fused %06x != uberblit %06x\n", x, y, p1 & 0xffffff, p2 & 0xffffff);
+							VDASSERT(false);
+							return 1;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	return 0;
+}
@@ -1,5 +1,6 @@
 #include "test.h"
 #include <intrin.h>
+#include <vd2/system/cpuaccel.h>
 #include <vd2/system/vdalloc.h>
 #include <vd2/system/time.h>
 #include <vd2/Kasumi/pixmap.h>
@@ -173,3 +174,82 @@ DEFINE_TEST_NONAUTO(UberblitPerf) {
 
 	return 0;
 }
+
+DEFINE_TEST_NONAUTO(UberblitPerf32F) {
+	using namespace nsVDPixmap;
+
+	// Conversions that go through the 32F pipeline, timed with the generic
+	// and SSE2 generators.
+	static const int kPairs[][2]={
+		{ kPixFormat_XRGB8888,			kPixFormat_YUV422_Planar_16F },
+		{ kPixFormat_YUV422_Planar_16F,	kPixFormat_XRGB8888 },
+		{ kPixFormat_YUV422_Planar_16F,	kPixFormat_YUV422_Planar },
+		{ kPixFormat_XRGB8888,			kPixFormat_YUV422_V210 },
+		{ kPixFormat_YUV422_V210,		kPixFormat_XRGB8888 },
+		{ kPixFormat_YUV422_V210,		kPixFormat_YUV422_Planar_16F },
+		{ kPixFormat_YUV422_V210,		kPixFormat_YUV420_Planar_709 },
+		{ kPixFormat_XRGB64,			kPixFormat_YUV444_Planar16 },
+		{ kPixFormat_XRGB64,			kPixFormat_YUV422_V210 },
+		{ kPixFormat_YUV420_Planar16,	kPixFormat_XRGB64 },
+		{ kPixFormat_YUV420_P010,		kPixFormat_YUV422_Planar_16F },
+	};
+
+	enum { kPairCount = sizeof(kPairs)/sizeof(kPairs[0]) };
+
+	static const int kWidth = 1920;
+	static const int kHeight = 1080;
+
+	const long exts = CPUGetEnabledExtensions();
+	const double tps = VDGetPreciseTicksPerSecond();
+
+	printf("%-20s %-20s %14s %14s\n", "Source", "Destination", "Generic", "SSE2");
+
+	for(int i=0; i<kPairCount; ++i) {
+		VDPixmapBuffer src(kWidth, kHeight, kPairs[i][0]);
+		VDPixmapBuffer dst(kWidth, kHeight, kPairs[i][1]);
+
+		// fill the source with something legal for float formats
+		VDPixmapBuffer rgb(kWidth, kHeight, kPixFormat_XRGB8888);
+		for(int y=0; y<kHeight; ++y) {
+			uint32 *p = (uint32 *)vdptroffset(rgb.data, rgb.pitch * y);
+
+			for(int x=0; x<kWidth; ++x)
+				p[x] = (x * 0x010203 + y * 0x030201) & 0xffffff;
+		}
+
+		VDPixmapBlt(src, rgb);
+
+		double speed[2] = {0, 0};
+
+		for(int simd=0; simd<2; ++simd) {
+			if (simd && !(exts & CPUF_SUPPORTS_SSE2))
+				continue;
+
+			// generators are picked when the blitter is compiled
+			CPUEnableExtensions(simd ? exts : exts & ~CPUF_SUPPORTS_SSE2);
+			vdautoptr<IVDPixmapBlitter> blitter(VDPixmapCreateBlitter(dst, src));
+			CPUEnableExtensions(exts);
+
+			uint64 best = (uint64)(sint64)-1;
+			for(int j=0; j<5; ++j) {
+				uint64 t = VDGetPreciseTick();
+				blitter->Blit(dst, src);
+				t = VDGetPreciseTick() - t;
+
+				if (best > t)
+					best = t;
+			}
+
+			speed[simd] = (double)(kWidth*kHeight) / 1000000.0 / (double)best * tps;
+		}
+
+		printf("%-20s %-20s %8.2fMP/sec %8.2fMP/sec (%.2fx)\n"
+			, VDPixmapGetInfo(kPairs[i][0]).name
+			, VDPixmapGetInfo(kPairs[i][1]).name
+			, speed[0]
+			, speed[1]
+			, speed[1] / speed[0]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,201 @@
+#include <vd2/system/file.h>
+#include <vd2/system/time.h>
+#include <vd2/system/vdstl.h>
+#include <vd2/system/zip.h>
+#include "test.h"
+
+namespace {
+	class VDTestZipSinkStream : public IVDStream {
+	public:
+		const wchar_t *GetNameForError() { return L"sink"; }
+		sint64	Pos() { return mData.size(); }
+		void	Read(void *buffer, sint32 bytes) { throw MyError("Cannot read from sink."); }
+		sint32	ReadData(void *buffer, sint32 bytes) { throw MyError("Cannot read from sink."); }
+		void	Write(const void *buffer, sint32 bytes) { mData.insert(mData.end(), (const uint8 *)buffer, (const uint8 *)buffer + bytes); }
+
+		vdfastvector<uint8> mData;
+	};
+
+	// Mixes runs of random literals, repeated phrases and long fills, so that
+	// the encoder emits stored, static and dynamic blocks and matches with
+	// both short and long distances.
+	void FillZipTestData(vdfastvector<uint8>& data, uint32 len, uint32 seed) {
+		data.resize(len);
+
+		uint32 pos = 0;
+		while(pos < len) {
+			seed = seed * 214013 + 2531011;
+
+			uint32 runlen = ((seed >> 16) & 1023) + 1;
+			if (runlen > len - pos)
+				runlen = len - pos;
+
+			switch((seed >> 8) & 3) {
+				case 0:
+					for(uint32 i=0; i<runlen; ++i) {
+						seed = seed * 214013 + 2531011;
+						data[pos + i] = (uint8)(seed >> 16);
+					}
+					break;
+
+				case 1:
+					memset(&data[pos], (uint8)(seed >> 24), runlen);
+					break;
+
+				default:
+					if (pos) {
+						uint32 dist = ((seed >> 12) % (pos < 32768 ? pos : 32768)) + 1;
+
+						for(uint32 i=0; i<runlen; ++i)
+							data[pos + i] = data[pos + i - dist];
+					} else {
+						for(uint32 i=0; i<runlen; ++i)
+							data[pos + i] = (uint8)("VirtualDub"[i % 10]);
+					}
+					break;
+			}
+
+			pos += runlen;
+		}
+	}
+
+	uint32 ComputeReferenceCRC32(const uint8 *src, uint32 len) {
+		uint32 crc = 0xFFFFFFFF;
+
+		for(uint32 i=0; i<len; ++i) {
+			crc ^= src[i];
+
+			for(int j=0; j<8; ++j)
+				crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320 : 0);
+		}
+
+		return ~crc;
+	}
+
+	uint32 ComputeReferenceAdler32(const uint8 *src, uint32 len) {
+		uint32 s1 = 1;
+		uint32 s2 = 0;
+
+		for(uint32 i=0; i<len; ++i) {
+			s1 = (s1 + src[i]) % 65521;
+			s2 = (s2 + s1) % 65521;
+		}
+
+		return s1 + (s2 << 16);
+	}
+
+	void DeflateZipTestData(vdfastvector<uint8>& dst, const vdfastvector<uint8>& src, bool quick) {
+		VDTestZipSinkStream sink;
+		vdautoptr<VDDeflateStream> ds(new VDDeflateStream(&sink, quick));		// too big for the stack
+
+		// write in odd-sized pieces to exercise the history window management
+		uint32 pos = 0;
+		uint32 len = (uint32)src.size();
+		while(pos < len) {
+			uint32 tc = len - pos;
+			if (tc > 7919)
+				tc = 7919;
+
+			ds->Write(&src[pos], tc);
+			pos += tc;
+		}
+
+		ds->Finish();
+		dst.swap(sink.mData);
+	}
+}
+
+DEFINE_TEST(Zip) {
+	static const uint32 kSizes[]={ 1, 100, 65536, 1000000 };
+
+	vdfastvector<uint8> data;
+	vdfastvector<uint8> packed;
+	vdfastvector<uint8> unpacked;
+
+	for(int i=0; i<sizeof(kSizes)/sizeof(kSizes[0]); ++i) {
+		const uint32 len = kSizes[i];
+
+		FillZipTestData(data, len, i);
+
+		// checksums against the bytewise definitions, at odd alignments
+		for(uint32 offset=0; offset<4 && offset<len; ++offset) {
+			VDCRCChecker crc(VDCRCChecker::kCRC32);
+			crc.Process(&data[offset], len - offset);
+			TEST_ASSERT(crc.CRC() == ComputeReferenceCRC32(&data[offset], len - offset));
+
+			VDAdler32Checker adler;
+			adler.Process(&data[offset], len - offset);
+			TEST_ASSERT(adler.Adler32() == ComputeReferenceAdler32(&data[offset], len - offset));
+		}
+
+		for(int quick=0; quick<2; ++quick) {
+			DeflateZipTestData(packed, data, quick != 0);
+
+			VDMemoryStream ms(packed.data(), (uint32)packed.size());
+			vdautoptr<VDZipStream> zs(new VDZipStream);
+			zs->Init(&ms, packed.size(), false);
+			zs->EnableCRC();
+
+			unpacked.resize(len);
+			zs->Read(unpacked.data(), len);
+
+			TEST_ASSERT(!memcmp(unpacked.data(), data.data(), len));
+			TEST_ASSERT(zs->CRC() == ComputeReferenceCRC32(data.data(), len));
+		}
+	}
+
+	return 0;
+}
+
+DEFINE_TEST_NONAUTO(ZipPerf) {
+	const double tps = VDGetPreciseTicksPerSecond();
+	const uint32 len = 16 << 20;
+
+	vdfastvector<uint8> data;
+	vdfastvector<uint8> packed;
+	vdfastvector<uint8> unpacked(len);
+
+	FillZipTestData(data, len, 1);
+
+	uint64 best[4] = { (uint64)(sint64)-1, (uint64)(sint64)-1, (uint64)(sint64)-1, (uint64)(sint64)-1 };
+
+	for(int j=0; j<5; ++j) {
+		uint64 t0 = VDGetPreciseTick();
+		DeflateZipTestData(packed, data, false);
+		uint64 t1 = VDGetPreciseTick();
+
+		VDMemoryStream ms(packed.data(), (uint32)packed.size());
+		vdautoptr<VDZipStream> zs(new VDZipStream);
+		zs->Init(&ms, packed.size(), false);
+		zs->Read(unpacked.data(), len);
+		uint64 t2 = VDGetPreciseTick();
+
+		VDCRCChecker crc(VDCRCChecker::kCRC32);
+		crc.Process(data.data(), len);
+		uint64 t3 = VDGetPreciseTick();
+
+		VDAdler32Checker adler;
+		adler.Process(data.data(), len);
+		uint64 t4 = VDGetPreciseTick();
+
+		const uint64 t[4] = { t1 - t0, t2 - t1, t3 - t2, t4 - t3 };
+		for(int k=0; k<4; ++k) {
+			if (best[k] > t[k])
+				best[k] = t[k];
+		}
+	}
+
+	static const char *const kNames[]={
+		"Deflate",
+		"Inflate",
+		"CRC-32",
+		"Adler-32",
+	};
+
+	printf("Compressed %u bytes to %u bytes\n", len, (uint32)packed.size());
+
+	for(int k=0; k<4; ++k)
+		printf("%-10s %8.2fMB/sec\n", kNames[k], (double)len / 1048576.0 / (double)best[k] * tps);
+
+	return 0;
+}